@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include <memory>
+#include "runner.h"
+
+
+class App
+{
+public:
+    /* Public functions */
+     App();
+    ~App();
+
+    /** Parses command line arguments & creates all objects the benchmarks need.
+     *
+     *  @return true if successful, false otherwise.
+     */
+    bool init(int    in_argc,
+              char** in_argv);
+
+    /** Executes the benchmarks and writes the JSON report, if one has been requested.
+     *
+     *  @return Process exit code.
+     */
+    int run();
+
+private:
+    /* Private functions */
+    App           (const App&);
+    App& operator=(const App&);
+
+    void deinit                 ();
+    void init_benchmarks        ();
+    bool init_buffers           ();
+    void init_command_buffers   ();
+    bool init_compute_primitives();
+    void init_dsgs              ();
+    bool init_gfx_pipelines     ();
+    void init_shaders           ();
+    void init_vulkan            ();
+    bool parse_args          (int    in_argc,
+                              char** in_argv);
+
+    bool bench_compute_primitive             (uint32_t in_n_primitive,
+                                              uint64_t in_n_iterations);
+    bool bench_descriptor_set_update         (uint64_t in_n_iterations);
+    bool bench_fp16_to_fp32_fast             (uint64_t in_n_iterations);
+    bool bench_fp16_to_fp32_full             (uint64_t in_n_iterations);
+    bool bench_fp32_to_fp16_fast3_rtne       (uint64_t in_n_iterations);
+    bool bench_fp32_to_fp16_full             (uint64_t in_n_iterations);
+    bool bench_graphics_pipeline_manager_bake(uint64_t in_n_iterations);
+    bool bench_memory_allocator_bake         (uint64_t in_n_iterations);
+    bool bench_queue_submit                  (uint64_t in_n_iterations);
+    bool bench_record_bind_descriptor_sets   (uint64_t in_n_iterations);
+    bool bench_record_bind_pipeline          (uint64_t in_n_iterations);
+    bool bench_record_pipeline_barrier       (uint64_t in_n_iterations);
+    bool bench_record_push_constants         (uint64_t in_n_iterations);
+    bool bench_record_set_scissor            (uint64_t in_n_iterations);
+    bool bench_record_set_viewport           (uint64_t in_n_iterations);
+
+    Anvil::GraphicsPipelineCreateInfoUniquePtr create_gfx_pipeline_create_info() const;
+    bool                                       record_in_batches              (uint64_t                     in_n_iterations,
+                                                                               const std::function<bool()>& in_record_func);
+    bool                                       verify_compute_primitive       (uint32_t                     in_n_primitive);
+
+    /* Private type definitions */
+    typedef struct
+    {
+        std::string                     name;
+        Anvil::ComputePrimitiveUniquePtr primitive_ptr;
+        bool                            is_verified;
+    } ComputePrimitiveBenchmark;
+
+    /* Private variables */
+    Anvil::BaseDeviceUniquePtr   m_device_ptr;
+    Anvil::InstanceUniquePtr     m_instance_ptr;
+    const Anvil::PhysicalDevice* m_physical_device_ptr;
+
+    Anvil::BufferUniquePtr                              m_compute_primitive_count_buffer_ptr;
+    Anvil::BufferUniquePtr                              m_compute_primitive_input_buffer_ptr;
+    std::vector<uint32_t>                               m_compute_primitive_input_data;
+    Anvil::BufferUniquePtr                              m_compute_primitive_key_buffer_ptr;
+    Anvil::BufferUniquePtr                              m_compute_primitive_output_buffer_ptr;
+    Anvil::BufferUniquePtr                              m_compute_primitive_predicate_buffer_ptr;
+    std::vector<uint32_t>                               m_compute_primitive_predicate_data;
+    Anvil::BufferUniquePtr                              m_compute_primitive_value_buffer_ptr;
+    std::vector<ComputePrimitiveBenchmark>              m_compute_primitives;
+    Anvil::DescriptorSetGroupUniquePtr                  m_dsg_ptr;
+    Anvil::PrimaryCommandBufferUniquePtr                m_empty_command_buffer_ptr;
+    std::unique_ptr<Anvil::float16_t[]>                 m_fp16_data_ptr;
+    std::unique_ptr<Anvil::float32_t[]>                 m_fp32_data_ptr;
+    std::unique_ptr<Anvil::ShaderModuleStageEntryPoint> m_fs_ptr;
+    Anvil::PipelineID                                   m_pipeline_id;
+    Anvil::PrimaryCommandBufferUniquePtr                m_recording_command_buffer_ptr;
+    Anvil::RenderPassUniquePtr                          m_renderpass_ptr;
+    Anvil::SubPassID                                    m_subpass_id;
+    Anvil::BufferUniquePtr                              m_ub_ptrs[2];
+    std::unique_ptr<Anvil::ShaderModuleStageEntryPoint> m_vs_ptr;
+
+    std::string             m_filter;
+    std::string             m_json_filename;
+    uint32_t                m_min_run_time_ms;
+    uint32_t                m_n_physical_device;
+    uint32_t                m_n_repetitions;
+    uint32_t                m_n_ub_to_bind;
+    std::unique_ptr<Runner> m_runner_ptr;
+};
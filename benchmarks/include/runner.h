@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/* Minimal benchmark harness used by anvil_benchmarks.
+ *
+ * Each benchmark is a function which executes the measured operation a requested number of times.
+ * The runner calibrates the iteration count until a single run takes at least the configured minimum
+ * amount of time, then repeats the measurement a number of times and reports:
+ *
+ * - median & minimum wall-clock time per operation, in nanoseconds.
+ * - number of heap allocations & number of bytes allocated per operation. These are counted by replacement
+ *   global operator new / delete implementations (see runner.cpp). Allocations made by the ICD with malloc()
+ *   are not included.
+ *
+ * Results are printed to stdout as a table and can optionally be written to a JSON file, which is suitable
+ * for tracking regressions across revisions.
+ */
+#ifndef BENCHMARKS_RUNNER_H
+#define BENCHMARKS_RUNNER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+/** Benchmark function prototype.
+ *
+ *  @param in_n_iterations Number of times the measured operation should be executed.
+ *
+ *  @return true if successful, false otherwise. A failed benchmark is reported as such and excluded from the results.
+ */
+typedef std::function<bool(uint64_t in_n_iterations)> BenchmarkFunction;
+
+typedef struct BenchmarkResult
+{
+    double      allocated_bytes_per_op;
+    double      allocations_per_op;
+    bool        failed;
+    uint64_t    n_iterations;
+    double      ns_per_op_median;
+    double      ns_per_op_min;
+    std::string name;
+
+    BenchmarkResult()
+    {
+        allocated_bytes_per_op = 0.0;
+        allocations_per_op     = 0.0;
+        failed                 = false;
+        n_iterations           = 0;
+        ns_per_op_median       = 0.0;
+        ns_per_op_min          = 0.0;
+    }
+} BenchmarkResult;
+
+class Runner
+{
+public:
+    /* Public functions */
+
+    /** Constructor.
+     *
+     *  @param in_min_run_time_ms Minimum duration of a single measured run. Iteration count is scaled up until
+     *                            a run takes at least this long.
+     *  @param in_n_repetitions   Number of measured runs to execute per benchmark, after calibration.
+     *  @param in_opt_filter      If not empty, only benchmarks whose name contains this string are executed.
+     */
+    Runner(uint32_t           in_min_run_time_ms,
+           uint32_t           in_n_repetitions,
+           const std::string& in_opt_filter);
+
+    /** Registers a new benchmark. Benchmarks are executed in registration order. */
+    void add_benchmark(const std::string& in_name,
+                       BenchmarkFunction  in_function);
+
+    /** Adds a key-value pair to the "context" object of the JSON output. */
+    void add_context(const std::string& in_key,
+                     const std::string& in_value);
+
+    const std::vector<BenchmarkResult>& get_results() const
+    {
+        return m_results;
+    }
+
+    /** Executes all registered benchmarks, which pass the filter. Results are printed to stdout as they become available.
+     *
+     *  @return true if all executed benchmarks succeeded, false otherwise.
+     */
+    bool run();
+
+    /** Writes results of the last run() call to a JSON file.
+     *
+     *  @return true if successful, false otherwise.
+     */
+    bool write_json(const std::string& in_filename) const;
+
+private:
+    /* Private type definitions */
+    typedef struct
+    {
+        BenchmarkFunction function;
+        std::string       name;
+    } Benchmark;
+
+    /* Private functions */
+    Runner           (const Runner&);
+    Runner& operator=(const Runner&);
+
+    bool run_benchmark(const Benchmark& in_benchmark,
+                       BenchmarkResult* out_result_ptr) const;
+
+    /* Private variables */
+    std::vector<Benchmark>                            m_benchmarks;
+    std::vector<std::pair<std::string, std::string> > m_context;
+    std::string                                       m_filter;
+    uint32_t                                          m_min_run_time_ms;
+    uint32_t                                          m_n_repetitions;
+    std::vector<BenchmarkResult>                      m_results;
+};
+
+#endif /* BENCHMARKS_RUNNER_H */
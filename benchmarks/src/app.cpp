@@ -0,0 +1,1392 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/* anvil_benchmarks measures the CPU cost of Anvil's hot paths.
+ *
+ * The suite runs headless, so it can be pointed at a software ICD (lavapipe, SwiftShader) in order to
+ * obtain numbers which are not affected by the GPU. Use the VK_ICD_FILENAMES environment variable to
+ * select the ICD and --device to select the physical device, if more than one is exposed.
+ *
+ * Command line arguments:
+ *
+ * --device <index>         Index of the physical device to use. Defaults to 0.
+ * --filter <substring>     Only run benchmarks whose name contains the substring.
+ * --json <filename>        Write results to the specified file in JSON format.
+ * --min-time-ms <time>     Minimum duration of a single measured run. Defaults to 200.
+ * --repetitions <count>    Number of measured runs per benchmark. Defaults to 5.
+ *
+ * NOTE: Numbers reported by the record_* benchmarks include vkCmd*() cost of the ICD. Compare results
+ *       obtained with the same ICD only.
+ *
+ * NOTE: compute_primitives benchmarks measure GPU throughput of the compute primitives, including the cost of
+ *       a blocking submission. The first run of each benchmark also validates results against a CPU reference
+ *       and fails the benchmark if they do not match.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "config.h"
+#include "misc/buffer_create_info.h"
+#include "misc/compute_primitives.h"
+#include "misc/fp16.h"
+#include "misc/glsl_to_spirv.h"
+#include "misc/graphics_pipeline_create_info.h"
+#include "misc/instance_create_info.h"
+#include "misc/memory_allocator.h"
+#include "misc/object_tracker.h"
+#include "misc/render_pass_create_info.h"
+#include "wrappers/buffer.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
+#include "wrappers/descriptor_set.h"
+#include "wrappers/descriptor_set_group.h"
+#include "wrappers/device.h"
+#include "wrappers/graphics_pipeline_manager.h"
+#include "wrappers/instance.h"
+#include "wrappers/physical_device.h"
+#include "wrappers/queue.h"
+#include "wrappers/render_pass.h"
+#include "wrappers/shader_module.h"
+#include "app.h"
+
+
+#define APP_NAME                     "Anvil CPU overhead benchmarks"
+#define N_COMPUTE_PRIMITIVE_ELEMENTS (1024 * 1024)
+#define N_BUFFERS_PER_ALLOCATOR_BAKE (16)
+#define N_FP16_VALUES                (4096)
+#define N_MAX_COMMANDS_PER_RECORDING (1024)
+#define RENDER_TARGET_HEIGHT         (64)
+#define RENDER_TARGET_WIDTH          (64)
+#define UB_SIZE                      (256)
+
+
+static const char* g_glsl_frag =
+    "#version 430\n"
+    "\n"
+    "layout (location = 0) out vec4 result;\n"
+    "\n"
+    "layout (push_constant) uniform PC\n"
+    "{\n"
+    "    vec4 color;\n"
+    "} pc;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    result = pc.color;\n"
+    "}\n";
+
+static const char* g_glsl_vert =
+    "#version 430\n"
+    "\n"
+    "layout (set = 0, binding = 0) uniform UB\n"
+    "{\n"
+    "    vec4 positions[3];\n"
+    "} ub;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = ub.positions[gl_VertexIndex];\n"
+    "}\n";
+
+/* Results of the conversion benchmarks are written here, so that the compiler cannot discard the conversions. */
+static volatile uint32_t g_sink = 0;
+
+
+App::App()
+    :m_physical_device_ptr(nullptr),
+     m_pipeline_id        (UINT32_MAX),
+     m_subpass_id         (UINT32_MAX),
+     m_min_run_time_ms    (200),
+     m_n_physical_device  (0),
+     m_n_repetitions      (5),
+     m_n_ub_to_bind       (0)
+{
+    /* Stub */
+}
+
+App::~App()
+{
+    deinit();
+}
+
+bool App::bench_compute_primitive(uint32_t in_n_primitive,
+                                  uint64_t in_n_iterations)
+{
+    auto& benchmark = m_compute_primitives.at(in_n_primitive);
+    auto  queue_ptr = m_device_ptr->get_universal_queue(0);
+
+    if (!benchmark.is_verified)
+    {
+        if (!verify_compute_primitive(in_n_primitive) )
+        {
+            fprintf(stderr,
+                    "[!] [%s] produced incorrect results.\n",
+                    benchmark.name.c_str() );
+
+            return false;
+        }
+
+        benchmark.is_verified = true;
+    }
+
+    if (!m_recording_command_buffer_ptr->reset          (false) || /* in_should_release_resources */
+        !m_recording_command_buffer_ptr->start_recording(false,   /* one_time_submit          */
+                                                         false) ) /* simultaneous_use_allowed */
+    {
+        return false;
+    }
+
+    if (!benchmark.primitive_ptr->record(m_recording_command_buffer_ptr.get(),
+                                         N_COMPUTE_PRIMITIVE_ELEMENTS) )
+    {
+        m_recording_command_buffer_ptr->stop_recording();
+
+        return false;
+    }
+
+    if (!m_recording_command_buffer_ptr->stop_recording() )
+    {
+        return false;
+    }
+
+    for (uint64_t n_iteration = 0;
+                  n_iteration < in_n_iterations;
+                ++n_iteration)
+    {
+        if (!queue_ptr->submit(
+                Anvil::SubmitInfo::create(m_recording_command_buffer_ptr.get(),
+                                          0,       /* in_n_semaphores_to_signal              */
+                                          nullptr, /* in_opt_semaphore_to_signal_ptrs_ptr    */
+                                          0,       /* in_n_semaphores_to_wait_on             */
+                                          nullptr, /* in_opt_semaphore_to_wait_on_ptrs_ptr   */
+                                          nullptr, /* in_opt_dst_stage_masks_to_wait_on_ptrs */
+                                          true)    /* in_should_block                        */
+            ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool App::bench_descriptor_set_update(uint64_t in_n_iterations)
+{
+    auto ds_ptr = m_dsg_ptr->get_descriptor_set(0);
+
+    for (uint64_t n_iteration = 0;
+                  n_iteration < in_n_iterations;
+                ++n_iteration)
+    {
+        /* Alternate between two buffers, so that each iteration actually needs to update the set */
+        m_n_ub_to_bind = (m_n_ub_to_bind + 1) % 2;
+
+        if (!ds_ptr->set_binding_item(0, /* in_binding_index */
+                                      Anvil::DescriptorSet::UniformBufferBindingElement(m_ub_ptrs[m_n_ub_to_bind].get() )) ||
+            !ds_ptr->update() )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool App::bench_fp16_to_fp32_fast(uint64_t in_n_iterations)
+{
+    uint32_t result = 0;
+
+    for (uint64_t n_iteration = 0;
+                  n_iteration < in_n_iterations;
+                ++n_iteration)
+    {
+        result ^= Anvil::Utils::fp16_to_fp32_fast(m_fp16_data_ptr[n_iteration % N_FP16_VALUES]).u;
+    }
+
+    g_sink = result;
+
+    return true;
+}
+
+bool App::bench_fp16_to_fp32_full(uint64_t in_n_iterations)
+{
+    uint32_t result = 0;
+
+    for (uint64_t n_iteration = 0;
+                  n_iteration < in_n_iterations;
+                ++n_iteration)
+    {
+        result ^= Anvil::Utils::fp16_to_fp32_full(m_fp16_data_ptr[n_iteration % N_FP16_VALUES]).u;
+    }
+
+    g_sink = result;
+
+    return true;
+}
+
+bool App::bench_fp32_to_fp16_fast3_rtne(uint64_t in_n_iterations)
+{
+    uint32_t result = 0;
+
+    for (uint64_t n_iteration = 0;
+                  n_iteration < in_n_iterations;
+                ++n_iteration)
+    {
+        result ^= Anvil::Utils::fp32_to_fp16_fast3_rtne(m_fp32_data_ptr[n_iteration % N_FP16_VALUES]).u;
+    }
+
+    g_sink = result;
+
+    return true;
+}
+
+bool App::bench_fp32_to_fp16_full(uint64_t in_n_iterations)
+{
+    uint32_t result = 0;
+
+    for (uint64_t n_iteration = 0;
+                  n_iteration < in_n_iterations;
+                ++n_iteration)
+    {
+        result ^= Anvil::Utils::fp32_to_fp16_full(m_fp32_data_ptr[n_iteration % N_FP16_VALUES]).u;
+    }
+
+    g_sink = result;
+
+    return true;
+}
+
+bool App::bench_graphics_pipeline_manager_bake(uint64_t in_n_iterations)
+{
+    auto gfx_pipeline_manager_ptr = m_device_ptr->get_graphics_pipeline_manager();
+
+    for (uint64_t n_iteration = 0;
+                  n_iteration < in_n_iterations;
+                ++n_iteration)
+    {
+        Anvil::PipelineID pipeline_id = UINT32_MAX;
+
+        if (!gfx_pipeline_manager_ptr->add_pipeline(create_gfx_pipeline_create_info(),
+                                                   &pipeline_id) )
+        {
+            return false;
+        }
+
+        if (!gfx_pipeline_manager_ptr->bake() )
+        {
+            return false;
+        }
+
+        if (!gfx_pipeline_manager_ptr->delete_pipeline(pipeline_id) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* NOTE: Each iteration also creates the buffers, since Vulkan does not allow rebinding memory to an object. */
+bool App::bench_memory_allocator_bake(uint64_t in_n_iterations)
+{
+    for (uint64_t n_iteration = 0;
+                  n_iteration < in_n_iterations;
+                ++n_iteration)
+    {
+        Anvil::BufferUniquePtr          buffer_ptrs[N_BUFFERS_PER_ALLOCATOR_BAKE];
+        Anvil::MemoryAllocatorUniquePtr memory_allocator_ptr = Anvil::MemoryAllocator::create_oneshot(m_device_ptr.get() );
+
+        for (uint32_t n_buffer = 0;
+                      n_buffer < N_BUFFERS_PER_ALLOCATOR_BAKE;
+                    ++n_buffer)
+        {
+            auto create_info_ptr = Anvil::BufferCreateInfo::create_no_alloc(m_device_ptr.get(),
+                                                                            UB_SIZE * (n_buffer + 1),
+                                                                            Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
+                                                                            Anvil::SharingMode::EXCLUSIVE,
+                                                                            Anvil::BufferCreateFlagBits::NONE,
+                                                                            Anvil::BufferUsageFlagBits::UNIFORM_BUFFER_BIT);
+
+            buffer_ptrs[n_buffer] = Anvil::Buffer::create(std::move(create_info_ptr) );
+
+            if (buffer_ptrs[n_buffer] == nullptr)
+            {
+                return false;
+            }
+
+            if (!memory_allocator_ptr->add_buffer(buffer_ptrs[n_buffer].get(),
+                                                  Anvil::MemoryFeatureFlagBits::NONE) )
+            {
+                return false;
+            }
+        }
+
+        if (!memory_allocator_ptr->bake() )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool App::bench_queue_submit(uint64_t in_n_iterations)
+{
+    auto queue_ptr = m_device_ptr->get_universal_queue(0);
+
+    for (uint64_t n_iteration = 0;
+                  n_iteration < in_n_iterations;
+                ++n_iteration)
+    {
+        if (!queue_ptr->submit(
+                Anvil::SubmitInfo::create(m_empty_command_buffer_ptr.get(),
+                                          0,       /* in_n_semaphores_to_signal              */
+                                          nullptr, /* in_opt_semaphore_to_signal_ptrs_ptr    */
+                                          0,       /* in_n_semaphores_to_wait_on             */
+                                          nullptr, /* in_opt_semaphore_to_wait_on_ptrs_ptr   */
+                                          nullptr, /* in_opt_dst_stage_masks_to_wait_on_ptrs */
+                                          true)    /* in_should_block                        */
+            ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool App::bench_record_bind_descriptor_sets(uint64_t in_n_iterations)
+{
+    Anvil::DescriptorSet* ds_ptr              = m_dsg_ptr->get_descriptor_set(0);
+    auto                  pipeline_layout_ptr = m_device_ptr->get_graphics_pipeline_manager()->get_pipeline_layout(m_pipeline_id);
+
+    return record_in_batches(in_n_iterations,
+                             [&]()
+                             {
+                                 return m_recording_command_buffer_ptr->record_bind_descriptor_sets(Anvil::PipelineBindPoint::GRAPHICS,
+                                                                                                    pipeline_layout_ptr,
+                                                                                                    0,        /* in_first_set            */
+                                                                                                    1,        /* in_set_count            */
+                                                                                                   &ds_ptr,
+                                                                                                    0,        /* in_dynamic_offset_count */
+                                                                                                    nullptr); /* in_dynamic_offset_ptrs  */
+                             });
+}
+
+bool App::bench_record_bind_pipeline(uint64_t in_n_iterations)
+{
+    return record_in_batches(in_n_iterations,
+                             [&]()
+                             {
+                                 return m_recording_command_buffer_ptr->record_bind_pipeline(Anvil::PipelineBindPoint::GRAPHICS,
+                                                                                             m_pipeline_id);
+                             });
+}
+
+bool App::bench_record_pipeline_barrier(uint64_t in_n_iterations)
+{
+    const Anvil::MemoryBarrier barrier(Anvil::AccessFlagBits::MEMORY_READ_BIT,   /* in_destination_access_mask */
+                                       Anvil::AccessFlagBits::MEMORY_WRITE_BIT); /* in_source_access_mask      */
+
+    return record_in_batches(in_n_iterations,
+                             [&]()
+                             {
+                                 return m_recording_command_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT,
+                                                                                                Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT,
+                                                                                                Anvil::DependencyFlagBits::NONE,
+                                                                                                1,        /* in_memory_barrier_count        */
+                                                                                               &barrier,
+                                                                                                0,        /* in_buffer_memory_barrier_count */
+                                                                                                nullptr,  /* in_buffer_memory_barriers_ptr  */
+                                                                                                0,        /* in_image_memory_barrier_count  */
+                                                                                                nullptr); /* in_image_memory_barriers_ptr   */
+                             });
+}
+
+bool App::bench_record_push_constants(uint64_t in_n_iterations)
+{
+    const float color[4]            = {1.0f, 0.5f, 0.25f, 1.0f};
+    auto        pipeline_layout_ptr = m_device_ptr->get_graphics_pipeline_manager()->get_pipeline_layout(m_pipeline_id);
+
+    return record_in_batches(in_n_iterations,
+                             [&]()
+                             {
+                                 return m_recording_command_buffer_ptr->record_push_constants(pipeline_layout_ptr,
+                                                                                              Anvil::ShaderStageFlagBits::FRAGMENT_BIT,
+                                                                                              0, /* in_offset */
+                                                                                              sizeof(color),
+                                                                                              color);
+                             });
+}
+
+bool App::bench_record_set_scissor(uint64_t in_n_iterations)
+{
+    VkRect2D scissor;
+
+    scissor.extent.height = RENDER_TARGET_HEIGHT;
+    scissor.extent.width  = RENDER_TARGET_WIDTH;
+    scissor.offset.x      = 0;
+    scissor.offset.y      = 0;
+
+    return record_in_batches(in_n_iterations,
+                             [&]()
+                             {
+                                 return m_recording_command_buffer_ptr->record_set_scissor(0, /* in_first_scissor */
+                                                                                           1, /* in_scissor_count */
+                                                                                          &scissor);
+                             });
+}
+
+bool App::bench_record_set_viewport(uint64_t in_n_iterations)
+{
+    VkViewport viewport;
+
+    viewport.height   = static_cast<float>(RENDER_TARGET_HEIGHT);
+    viewport.maxDepth = 1.0f;
+    viewport.minDepth = 0.0f;
+    viewport.width    = static_cast<float>(RENDER_TARGET_WIDTH);
+    viewport.x        = 0.0f;
+    viewport.y        = 0.0f;
+
+    return record_in_batches(in_n_iterations,
+                             [&]()
+                             {
+                                 return m_recording_command_buffer_ptr->record_set_viewport(0, /* in_first_viewport */
+                                                                                            1, /* in_viewport_count */
+                                                                                           &viewport);
+                             });
+}
+
+/** Creates a create info structure for a simple graphics pipeline. The pipeline uses both the descriptor set
+ *  and the push constant range, so that it can also serve as a source of a pipeline layout for the
+ *  record_bind_descriptor_sets() and record_push_constants() benchmarks.
+ **/
+Anvil::GraphicsPipelineCreateInfoUniquePtr App::create_gfx_pipeline_create_info() const
+{
+    Anvil::GraphicsPipelineCreateInfoUniquePtr result_ptr;
+
+    result_ptr = Anvil::GraphicsPipelineCreateInfo::create(Anvil::PipelineCreateFlagBits::NONE,
+                                                           m_renderpass_ptr.get(),
+                                                           m_subpass_id,
+                                                           *m_fs_ptr,
+                                                           Anvil::ShaderModuleStageEntryPoint(), /* in_geometry_shader        */
+                                                           Anvil::ShaderModuleStageEntryPoint(), /* in_tess_control_shader    */
+                                                           Anvil::ShaderModuleStageEntryPoint(), /* in_tess_evaluation_shader */
+                                                           *m_vs_ptr);
+
+    result_ptr->set_descriptor_set_create_info(m_dsg_ptr->get_descriptor_set_create_info() );
+    result_ptr->attach_push_constant_range    (0, /* in_offset */
+                                               sizeof(float) * 4,
+                                               Anvil::ShaderStageFlagBits::FRAGMENT_BIT);
+    result_ptr->set_rasterization_properties  (Anvil::PolygonMode::FILL,
+                                               Anvil::CullModeFlagBits::NONE,
+                                               Anvil::FrontFace::COUNTER_CLOCKWISE,
+                                               1.0f); /* in_line_width */
+
+    /* The render pass is not associated with a swapchain, so viewport & scissor state need to be specified explicitly */
+    result_ptr->set_scissor_box_properties(0, /* in_n_scissor_box */
+                                           0, /* in_x             */
+                                           0, /* in_y             */
+                                           RENDER_TARGET_WIDTH,
+                                           RENDER_TARGET_HEIGHT);
+    result_ptr->set_viewport_properties   (0,    /* in_n_viewport */
+                                           0.0f, /* in_origin_x   */
+                                           0.0f, /* in_origin_y   */
+                                           static_cast<float>(RENDER_TARGET_WIDTH),
+                                           static_cast<float>(RENDER_TARGET_HEIGHT),
+                                           0.0f,  /* in_min_depth */
+                                           1.0f); /* in_max_depth */
+
+    return result_ptr;
+}
+
+void App::deinit()
+{
+    if (m_device_ptr != nullptr)
+    {
+        m_device_ptr->wait_idle();
+    }
+
+    m_compute_primitives.clear();
+
+    m_compute_primitive_count_buffer_ptr.reset    ();
+    m_compute_primitive_input_buffer_ptr.reset    ();
+    m_compute_primitive_key_buffer_ptr.reset      ();
+    m_compute_primitive_output_buffer_ptr.reset   ();
+    m_compute_primitive_predicate_buffer_ptr.reset();
+    m_compute_primitive_value_buffer_ptr.reset    ();
+
+    if (m_pipeline_id != UINT32_MAX)
+    {
+        m_device_ptr->get_graphics_pipeline_manager()->delete_pipeline(m_pipeline_id);
+
+        m_pipeline_id = UINT32_MAX;
+    }
+
+    m_empty_command_buffer_ptr.reset    ();
+    m_recording_command_buffer_ptr.reset();
+
+    m_dsg_ptr.reset       ();
+    m_fs_ptr.reset        ();
+    m_renderpass_ptr.reset();
+    m_ub_ptrs[0].reset    ();
+    m_ub_ptrs[1].reset    ();
+    m_vs_ptr.reset        ();
+
+    m_device_ptr.reset  ();
+    m_instance_ptr.reset();
+}
+
+bool App::init(int    in_argc,
+               char** in_argv)
+{
+    bool result = false;
+
+    if (!parse_args(in_argc,
+                    in_argv) )
+    {
+        goto end;
+    }
+
+    init_vulkan();
+
+    if (m_device_ptr == nullptr)
+    {
+        fprintf(stderr,
+                "[!] Could not create a Vulkan device.\n");
+
+        goto end;
+    }
+
+    if (!init_buffers() )
+    {
+        goto end;
+    }
+
+    init_dsgs           ();
+    init_shaders        ();
+    init_command_buffers();
+
+    if (!init_gfx_pipelines() )
+    {
+        goto end;
+    }
+
+    if (!init_compute_primitives() )
+    {
+        goto end;
+    }
+
+    init_benchmarks();
+
+    result = true;
+end:
+    return result;
+}
+
+void App::init_benchmarks()
+{
+    const auto& device_properties = *m_physical_device_ptr->get_device_properties().core_vk1_0_properties_ptr;
+    char        temp[64];
+
+    m_runner_ptr.reset(
+        new Runner(m_min_run_time_ms,
+                   m_n_repetitions,
+                   m_filter)
+    );
+
+    snprintf(temp,
+             sizeof(temp),
+             "%u",
+             device_properties.driver_version);
+
+    m_runner_ptr->add_context("device_name",
+                              device_properties.device_name);
+    m_runner_ptr->add_context("driver_version",
+                              temp);
+    #ifdef _DEBUG
+    {
+        m_runner_ptr->add_context("build_type",
+                                  "debug");
+    }
+    #else
+    {
+        m_runner_ptr->add_context("build_type",
+                                  "release");
+    }
+    #endif
+
+    m_runner_ptr->add_benchmark("command_buffer/record_bind_descriptor_sets",
+                                std::bind(&App::bench_record_bind_descriptor_sets,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("command_buffer/record_bind_pipeline",
+                                std::bind(&App::bench_record_bind_pipeline,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("command_buffer/record_pipeline_barrier",
+                                std::bind(&App::bench_record_pipeline_barrier,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("command_buffer/record_push_constants",
+                                std::bind(&App::bench_record_push_constants,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("command_buffer/record_set_scissor",
+                                std::bind(&App::bench_record_set_scissor,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("command_buffer/record_set_viewport",
+                                std::bind(&App::bench_record_set_viewport,
+                                          this,
+                                          std::placeholders::_1) );
+    for (uint32_t n_primitive = 0;
+                  n_primitive < static_cast<uint32_t>(m_compute_primitives.size() );
+                ++n_primitive)
+    {
+        m_runner_ptr->add_benchmark(m_compute_primitives[n_primitive].name,
+                                    std::bind(&App::bench_compute_primitive,
+                                              this,
+                                              n_primitive,
+                                              std::placeholders::_1) );
+    }
+
+    m_runner_ptr->add_benchmark("descriptor_set/update",
+                                std::bind(&App::bench_descriptor_set_update,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("graphics_pipeline_manager/bake",
+                                std::bind(&App::bench_graphics_pipeline_manager_bake,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("memory_allocator/bake_oneshot_16_buffers",
+                                std::bind(&App::bench_memory_allocator_bake,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("queue/submit_blocking",
+                                std::bind(&App::bench_queue_submit,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("utils/fp16_to_fp32_fast",
+                                std::bind(&App::bench_fp16_to_fp32_fast,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("utils/fp16_to_fp32_full",
+                                std::bind(&App::bench_fp16_to_fp32_full,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("utils/fp32_to_fp16_fast3_rtne",
+                                std::bind(&App::bench_fp32_to_fp16_fast3_rtne,
+                                          this,
+                                          std::placeholders::_1) );
+    m_runner_ptr->add_benchmark("utils/fp32_to_fp16_full",
+                                std::bind(&App::bench_fp32_to_fp16_full,
+                                          this,
+                                          std::placeholders::_1) );
+}
+
+bool App::init_buffers()
+{
+    for (uint32_t n_ub = 0;
+                  n_ub < sizeof(m_ub_ptrs) / sizeof(m_ub_ptrs[0]);
+                ++n_ub)
+    {
+        auto create_info_ptr = Anvil::BufferCreateInfo::create_alloc(m_device_ptr.get(),
+                                                                     UB_SIZE,
+                                                                     Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
+                                                                     Anvil::SharingMode::EXCLUSIVE,
+                                                                     Anvil::BufferCreateFlagBits::NONE,
+                                                                     Anvil::BufferUsageFlagBits::UNIFORM_BUFFER_BIT,
+                                                                     Anvil::MemoryFeatureFlagBits::NONE);
+
+        m_ub_ptrs[n_ub] = Anvil::Buffer::create(std::move(create_info_ptr) );
+
+        if (m_ub_ptrs[n_ub] == nullptr)
+        {
+            return false;
+        }
+
+        m_ub_ptrs[n_ub]->set_name_formatted("Uniform buffer [%d]",
+                                            n_ub);
+    }
+
+    /* Input data for the FP16 <-> FP32 conversion benchmarks. Spans normals, denormals and a few special values */
+    m_fp16_data_ptr.reset(new Anvil::float16_t[N_FP16_VALUES]);
+    m_fp32_data_ptr.reset(new Anvil::float32_t[N_FP16_VALUES]);
+
+    for (uint32_t n_value = 0;
+                  n_value < N_FP16_VALUES;
+                ++n_value)
+    {
+        m_fp32_data_ptr[n_value].u = n_value * 0x9E3779B1u;
+        m_fp16_data_ptr[n_value]   = Anvil::Utils::fp32_to_fp16_full(m_fp32_data_ptr[n_value]);
+    }
+
+    return true;
+}
+
+void App::init_command_buffers()
+{
+    auto universal_queue_ptr = m_device_ptr->get_universal_queue(0);
+    auto command_pool_ptr    = m_device_ptr->get_command_pool_for_queue_family_index(universal_queue_ptr->get_queue_family_index() );
+
+    m_empty_command_buffer_ptr     = command_pool_ptr->alloc_primary_level_command_buffer();
+    m_recording_command_buffer_ptr = command_pool_ptr->alloc_primary_level_command_buffer();
+
+    m_empty_command_buffer_ptr->start_recording(false, /* one_time_submit          */
+                                                false); /* simultaneous_use_allowed */
+    m_empty_command_buffer_ptr->stop_recording ();
+
+    m_empty_command_buffer_ptr->set_name    ("Empty command buffer");
+    m_recording_command_buffer_ptr->set_name("Recording benchmark command buffer");
+}
+
+bool App::init_compute_primitives()
+{
+    /* Buffers are shared by all primitives. Keys are sorted in place, so they are re-uploaded before verification. */
+    Anvil::BufferUniquePtr* buffer_ptrs[] =
+    {
+        &m_compute_primitive_count_buffer_ptr,
+        &m_compute_primitive_input_buffer_ptr,
+        &m_compute_primitive_key_buffer_ptr,
+        &m_compute_primitive_output_buffer_ptr,
+        &m_compute_primitive_predicate_buffer_ptr,
+        &m_compute_primitive_value_buffer_ptr,
+    };
+
+    for (auto current_buffer_ptr_ptr : buffer_ptrs)
+    {
+        auto create_info_ptr = Anvil::BufferCreateInfo::create_alloc(m_device_ptr.get(),
+                                                                     sizeof(uint32_t) * N_COMPUTE_PRIMITIVE_ELEMENTS,
+                                                                     Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
+                                                                     Anvil::SharingMode::EXCLUSIVE,
+                                                                     Anvil::BufferCreateFlagBits::NONE,
+                                                                     Anvil::BufferUsageFlagBits::STORAGE_BUFFER_BIT |
+                                                                     Anvil::BufferUsageFlagBits::TRANSFER_DST_BIT   |
+                                                                     Anvil::BufferUsageFlagBits::TRANSFER_SRC_BIT,
+                                                                     Anvil::MemoryFeatureFlagBits::NONE);
+
+        *current_buffer_ptr_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
+
+        if (*current_buffer_ptr_ptr == nullptr)
+        {
+            return false;
+        }
+    }
+
+    m_compute_primitive_input_data.resize    (N_COMPUTE_PRIMITIVE_ELEMENTS);
+    m_compute_primitive_predicate_data.resize(N_COMPUTE_PRIMITIVE_ELEMENTS);
+
+    for (uint32_t n_element = 0;
+                  n_element < N_COMPUTE_PRIMITIVE_ELEMENTS;
+                ++n_element)
+    {
+        m_compute_primitive_input_data    [n_element] = n_element * 0x9E3779B1u;
+        m_compute_primitive_predicate_data[n_element] = ((m_compute_primitive_input_data[n_element] >> 16) % 3 == 0) ? 1 : 0;
+    }
+
+    if (!m_compute_primitive_input_buffer_ptr->write    (0, /* in_start_offset */
+                                                         sizeof(uint32_t) * N_COMPUTE_PRIMITIVE_ELEMENTS,
+                                                         m_compute_primitive_input_data.data() )    ||
+        !m_compute_primitive_predicate_buffer_ptr->write(0, /* in_start_offset */
+                                                         sizeof(uint32_t) * N_COMPUTE_PRIMITIVE_ELEMENTS,
+                                                         m_compute_primitive_predicate_data.data() ) )
+    {
+        return false;
+    }
+
+    /* Register a regular and, if the device supports it, a subgroup variant of each primitive */
+    for (uint32_t n_variant = 0;
+                  n_variant < 2;
+                ++n_variant)
+    {
+        const bool                use_subgroup_ops = (n_variant == 1);
+        const std::string         suffix           = (use_subgroup_ops) ? "_subgroups" : "";
+        ComputePrimitiveBenchmark new_benchmarks[5];
+
+        new_benchmarks[0].name          = "compute_primitives/compaction"             + suffix;
+        new_benchmarks[0].primitive_ptr = Anvil::ComputePrimitive::create_compaction(m_device_ptr.get(),
+                                                                                    m_compute_primitive_input_buffer_ptr.get    (),
+                                                                                    m_compute_primitive_predicate_buffer_ptr.get(),
+                                                                                    m_compute_primitive_output_buffer_ptr.get   (),
+                                                                                    m_compute_primitive_count_buffer_ptr.get    (),
+                                                                                    N_COMPUTE_PRIMITIVE_ELEMENTS,
+                                                                                    use_subgroup_ops);
+        new_benchmarks[1].name          = "compute_primitives/exclusive_scan_add"     + suffix;
+        new_benchmarks[1].primitive_ptr = Anvil::ComputePrimitive::create_scan      (m_device_ptr.get(),
+                                                                                    false, /* in_inclusive */
+                                                                                    Anvil::ComputePrimitiveOperation::ADD,
+                                                                                    m_compute_primitive_input_buffer_ptr.get (),
+                                                                                    m_compute_primitive_output_buffer_ptr.get(),
+                                                                                    N_COMPUTE_PRIMITIVE_ELEMENTS,
+                                                                                    use_subgroup_ops);
+        new_benchmarks[2].name          = "compute_primitives/inclusive_scan_max"     + suffix;
+        new_benchmarks[2].primitive_ptr = Anvil::ComputePrimitive::create_scan      (m_device_ptr.get(),
+                                                                                    true, /* in_inclusive */
+                                                                                    Anvil::ComputePrimitiveOperation::MAX,
+                                                                                    m_compute_primitive_input_buffer_ptr.get (),
+                                                                                    m_compute_primitive_output_buffer_ptr.get(),
+                                                                                    N_COMPUTE_PRIMITIVE_ELEMENTS,
+                                                                                    use_subgroup_ops);
+        new_benchmarks[3].name          = "compute_primitives/radix_sort_key_value"   + suffix;
+        new_benchmarks[3].primitive_ptr = Anvil::ComputePrimitive::create_radix_sort(m_device_ptr.get(),
+                                                                                    m_compute_primitive_key_buffer_ptr.get  (),
+                                                                                    m_compute_primitive_value_buffer_ptr.get(),
+                                                                                    N_COMPUTE_PRIMITIVE_ELEMENTS,
+                                                                                    use_subgroup_ops);
+        new_benchmarks[4].name          = "compute_primitives/reduction_min"          + suffix;
+        new_benchmarks[4].primitive_ptr = Anvil::ComputePrimitive::create_reduction (m_device_ptr.get(),
+                                                                                    Anvil::ComputePrimitiveOperation::MIN,
+                                                                                    m_compute_primitive_input_buffer_ptr.get(),
+                                                                                    m_compute_primitive_count_buffer_ptr.get(),
+                                                                                    N_COMPUTE_PRIMITIVE_ELEMENTS,
+                                                                                    use_subgroup_ops);
+
+        for (auto& current_benchmark : new_benchmarks)
+        {
+            if (current_benchmark.primitive_ptr == nullptr)
+            {
+                fprintf(stderr,
+                        "[!] Could not create compute primitive for [%s].\n",
+                        current_benchmark.name.c_str() );
+
+                return false;
+            }
+
+            /* Skip subgroup variants which would fall back to the regular code path. */
+            if (current_benchmark.primitive_ptr->uses_subgroup_ops() != use_subgroup_ops)
+            {
+                continue;
+            }
+
+            current_benchmark.is_verified = false;
+
+            m_compute_primitives.push_back(std::move(current_benchmark) );
+        }
+    }
+
+    return true;
+}
+
+void App::init_dsgs()
+{
+    auto dsg_create_info_ptrs = std::vector<Anvil::DescriptorSetCreateInfoUniquePtr>(1);
+
+    dsg_create_info_ptrs[0] = Anvil::DescriptorSetCreateInfo::create();
+
+    dsg_create_info_ptrs[0]->add_binding(0, /* n_binding */
+                                         Anvil::DescriptorType::UNIFORM_BUFFER,
+                                         1, /* n_elements */
+                                         Anvil::ShaderStageFlagBits::VERTEX_BIT);
+
+    m_dsg_ptr = Anvil::DescriptorSetGroup::create(m_device_ptr.get(),
+                                                  dsg_create_info_ptrs,
+                                                  false); /* releaseable_sets */
+
+    m_dsg_ptr->set_binding_item(0, /* n_set     */
+                                0, /* n_binding */
+                                Anvil::DescriptorSet::UniformBufferBindingElement(m_ub_ptrs[0].get() ));
+}
+
+bool App::init_gfx_pipelines()
+{
+    Anvil::RenderPassAttachmentID render_pass_color_attachment_id;
+
+    {
+        Anvil::RenderPassCreateInfoUniquePtr render_pass_create_info_ptr(new Anvil::RenderPassCreateInfo(m_device_ptr.get() ) );
+
+        render_pass_create_info_ptr->add_color_attachment(Anvil::Format::R8G8B8A8_UNORM,
+                                                          Anvil::SampleCountFlagBits::_1_BIT,
+                                                          Anvil::AttachmentLoadOp::CLEAR,
+                                                          Anvil::AttachmentStoreOp::STORE,
+                                                          Anvil::ImageLayout::COLOR_ATTACHMENT_OPTIMAL,
+                                                          Anvil::ImageLayout::GENERAL,
+                                                          false, /* may_alias */
+                                                         &render_pass_color_attachment_id);
+
+        render_pass_create_info_ptr->add_subpass                 (&m_subpass_id);
+        render_pass_create_info_ptr->add_subpass_color_attachment(m_subpass_id,
+                                                                  Anvil::ImageLayout::COLOR_ATTACHMENT_OPTIMAL,
+                                                                  render_pass_color_attachment_id,
+                                                                  0,        /* location                      */
+                                                                  nullptr); /* opt_attachment_resolve_id_ptr */
+
+        m_renderpass_ptr = Anvil::RenderPass::create(std::move(render_pass_create_info_ptr),
+                                                     nullptr); /* in_opt_swapchain_ptr */
+    }
+
+    m_renderpass_ptr->set_name("Benchmark renderpass");
+
+    /* This pipeline stays alive for the whole run and is used by the command buffer recording benchmarks */
+    {
+        auto gfx_pipeline_manager_ptr = m_device_ptr->get_graphics_pipeline_manager();
+
+        if (!gfx_pipeline_manager_ptr->add_pipeline(create_gfx_pipeline_create_info(),
+                                                   &m_pipeline_id) ||
+            !gfx_pipeline_manager_ptr->bake() )
+        {
+            fprintf(stderr,
+                    "[!] Could not bake the benchmark graphics pipeline.\n");
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void App::init_shaders()
+{
+    Anvil::GLSLShaderToSPIRVGeneratorUniquePtr fragment_shader_ptr;
+    Anvil::ShaderModuleUniquePtr               fragment_shader_module_ptr;
+    Anvil::GLSLShaderToSPIRVGeneratorUniquePtr vertex_shader_ptr;
+    Anvil::ShaderModuleUniquePtr               vertex_shader_module_ptr;
+
+    fragment_shader_ptr = Anvil::GLSLShaderToSPIRVGenerator::create(m_device_ptr.get(),
+                                                                    Anvil::GLSLShaderToSPIRVGenerator::MODE_USE_SPECIFIED_SOURCE,
+                                                                    g_glsl_frag,
+                                                                    Anvil::ShaderStage::FRAGMENT);
+    vertex_shader_ptr   = Anvil::GLSLShaderToSPIRVGenerator::create(m_device_ptr.get(),
+                                                                    Anvil::GLSLShaderToSPIRVGenerator::MODE_USE_SPECIFIED_SOURCE,
+                                                                    g_glsl_vert,
+                                                                    Anvil::ShaderStage::VERTEX);
+
+    fragment_shader_module_ptr = Anvil::ShaderModule::create_from_spirv_generator(m_device_ptr.get       (),
+                                                                                  fragment_shader_ptr.get() );
+    vertex_shader_module_ptr   = Anvil::ShaderModule::create_from_spirv_generator(m_device_ptr.get       (),
+                                                                                  vertex_shader_ptr.get  () );
+
+    fragment_shader_module_ptr->set_name("Fragment shader module");
+    vertex_shader_module_ptr->set_name  ("Vertex shader module");
+
+    m_fs_ptr.reset(
+        new Anvil::ShaderModuleStageEntryPoint("main",
+                                               std::move(fragment_shader_module_ptr),
+                                               Anvil::ShaderStage::FRAGMENT)
+    );
+    m_vs_ptr.reset(
+        new Anvil::ShaderModuleStageEntryPoint("main",
+                                               std::move(vertex_shader_module_ptr),
+                                               Anvil::ShaderStage::VERTEX)
+    );
+}
+
+void App::init_vulkan()
+{
+    /* Create a Vulkan instance */
+    {
+        auto create_info_ptr = Anvil::InstanceCreateInfo::create(APP_NAME,  /* in_app_name    */
+                                                                 APP_NAME,  /* in_engine_name */
+                                                                 Anvil::DebugCallbackFunction(),
+                                                                 false); /* in_mt_safe */
+
+        m_instance_ptr = Anvil::Instance::create(std::move(create_info_ptr) );
+    }
+
+    if (m_instance_ptr                           == nullptr ||
+        m_instance_ptr->get_n_physical_devices() <= m_n_physical_device)
+    {
+        return;
+    }
+
+    m_physical_device_ptr = m_instance_ptr->get_physical_device(m_n_physical_device);
+
+    /* Create a Vulkan device. Recording benchmarks reset their command buffer between batches, hence the pool flag. */
+    {
+        auto create_info_ptr = Anvil::DeviceCreateInfo::create_sgpu(m_physical_device_ptr,
+                                                                    false,                      /* in_enable_shader_module_cache */
+                                                                    Anvil::DeviceExtensionConfiguration(),
+                                                                    std::vector<std::string>(), /* in_layers */
+                                                                    Anvil::CommandPoolCreateFlagBits::CREATE_RESET_COMMAND_BUFFER_BIT,
+                                                                    false);                     /* in_mt_safe */
+
+        m_device_ptr = Anvil::SGPUDevice::create(std::move(create_info_ptr) );
+    }
+}
+
+bool App::parse_args(int    in_argc,
+                     char** in_argv)
+{
+    for (int n_arg = 1;
+             n_arg < in_argc;
+           ++n_arg)
+    {
+        const char* current_arg_ptr = in_argv[n_arg];
+        const char* value_ptr       = (n_arg + 1 < in_argc) ? in_argv[n_arg + 1] : nullptr;
+
+        if (strcmp(current_arg_ptr, "--help") == 0)
+        {
+            printf("Usage: %s [--device <index>] [--filter <substring>] [--json <filename>] [--min-time-ms <time>] [--repetitions <count>]\n",
+                   in_argv[0]);
+
+            return false;
+        }
+
+        if (value_ptr == nullptr)
+        {
+            fprintf(stderr,
+                    "[!] Missing value for argument [%s].\n",
+                    current_arg_ptr);
+
+            return false;
+        }
+
+        if (strcmp(current_arg_ptr, "--device") == 0)
+        {
+            m_n_physical_device = static_cast<uint32_t>(atoi(value_ptr) );
+        }
+        else
+        if (strcmp(current_arg_ptr, "--filter") == 0)
+        {
+            m_filter = value_ptr;
+        }
+        else
+        if (strcmp(current_arg_ptr, "--json") == 0)
+        {
+            m_json_filename = value_ptr;
+        }
+        else
+        if (strcmp(current_arg_ptr, "--min-time-ms") == 0)
+        {
+            m_min_run_time_ms = static_cast<uint32_t>(atoi(value_ptr) );
+        }
+        else
+        if (strcmp(current_arg_ptr, "--repetitions") == 0)
+        {
+            m_n_repetitions = static_cast<uint32_t>(atoi(value_ptr) );
+        }
+        else
+        {
+            fprintf(stderr,
+                    "[!] Unrecognized argument [%s].\n",
+                    current_arg_ptr);
+
+            return false;
+        }
+
+        ++n_arg;
+    }
+
+    return true;
+}
+
+/** Records @param in_n_iterations commands into the benchmark command buffer by calling @param in_record_func.
+ *
+ *  The command buffer is reset & re-recorded every N_MAX_COMMANDS_PER_RECORDING commands, so that neither Anvil nor
+ *  the ICD accumulate an unbounded amount of command data during long runs.
+ *
+ *  @return true if all calls succeeded, false otherwise.
+ **/
+bool App::record_in_batches(uint64_t                     in_n_iterations,
+                            const std::function<bool()>& in_record_func)
+{
+    uint64_t n_iterations_left = in_n_iterations;
+
+    while (n_iterations_left > 0)
+    {
+        const uint64_t n_iterations_in_batch = (n_iterations_left < N_MAX_COMMANDS_PER_RECORDING) ? n_iterations_left
+                                                                                                   : N_MAX_COMMANDS_PER_RECORDING;
+
+        if (!m_recording_command_buffer_ptr->reset          (false) || /* in_should_release_resources */
+            !m_recording_command_buffer_ptr->start_recording(true,    /* one_time_submit          */
+                                                             false) ) /* simultaneous_use_allowed */
+        {
+            return false;
+        }
+
+        for (uint64_t n_iteration = 0;
+                      n_iteration < n_iterations_in_batch;
+                    ++n_iteration)
+        {
+            if (!in_record_func() )
+            {
+                m_recording_command_buffer_ptr->stop_recording();
+
+                return false;
+            }
+        }
+
+        if (!m_recording_command_buffer_ptr->stop_recording() )
+        {
+            return false;
+        }
+
+        n_iterations_left -= n_iterations_in_batch;
+    }
+
+    return true;
+}
+
+int App::run()
+{
+    bool result = m_runner_ptr->run();
+
+    if (!m_json_filename.empty() )
+    {
+        if (!m_runner_ptr->write_json(m_json_filename) )
+        {
+            result = false;
+        }
+    }
+
+    return (result) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/** Executes the specified compute primitive once and compares its results against a CPU implementation.
+ *
+ *  @return true if the results match, false otherwise.
+ **/
+bool App::verify_compute_primitive(uint32_t in_n_primitive)
+{
+    auto&                 benchmark            = m_compute_primitives.at(in_n_primitive);
+    const auto            primitive_type       = benchmark.primitive_ptr->get_type();
+    auto                  queue_ptr            = m_device_ptr->get_universal_queue(0);
+    std::vector<uint32_t> reference_data;
+    std::vector<uint32_t> result_data          (N_COMPUTE_PRIMITIVE_ELEMENTS);
+    std::vector<uint32_t> value_data           (N_COMPUTE_PRIMITIVE_ELEMENTS);
+    const uint32_t        data_size            = sizeof(uint32_t) * N_COMPUTE_PRIMITIVE_ELEMENTS;
+
+    if (primitive_type == Anvil::ComputePrimitiveType::RADIX_SORT)
+    {
+        for (uint32_t n_element = 0;
+                      n_element < N_COMPUTE_PRIMITIVE_ELEMENTS;
+                    ++n_element)
+        {
+            value_data[n_element] = n_element;
+        }
+
+        if (!m_compute_primitive_key_buffer_ptr->write  (0, /* in_start_offset */
+                                                         data_size,
+                                                         m_compute_primitive_input_data.data() ) ||
+            !m_compute_primitive_value_buffer_ptr->write(0, /* in_start_offset */
+                                                         data_size,
+                                                         value_data.data() ) )
+        {
+            return false;
+        }
+    }
+
+    if (!m_recording_command_buffer_ptr->reset          (false) || /* in_should_release_resources */
+        !m_recording_command_buffer_ptr->start_recording(true,    /* one_time_submit          */
+                                                         false) ) /* simultaneous_use_allowed */
+    {
+        return false;
+    }
+
+    if (!benchmark.primitive_ptr->record(m_recording_command_buffer_ptr.get(),
+                                         N_COMPUTE_PRIMITIVE_ELEMENTS) )
+    {
+        m_recording_command_buffer_ptr->stop_recording();
+
+        return false;
+    }
+
+    if (!m_recording_command_buffer_ptr->stop_recording() )
+    {
+        return false;
+    }
+
+    if (!queue_ptr->submit(
+            Anvil::SubmitInfo::create(m_recording_command_buffer_ptr.get(),
+                                      0,       /* in_n_semaphores_to_signal              */
+                                      nullptr, /* in_opt_semaphore_to_signal_ptrs_ptr    */
+                                      0,       /* in_n_semaphores_to_wait_on             */
+                                      nullptr, /* in_opt_semaphore_to_wait_on_ptrs_ptr   */
+                                      nullptr, /* in_opt_dst_stage_masks_to_wait_on_ptrs */
+                                      true)    /* in_should_block                        */
+        ) )
+    {
+        return false;
+    }
+
+    #if defined(ANVIL_USE_NULL_DRIVER)
+    {
+        /* The null driver does not execute any commands, so there is nothing to compare against. */
+        return true;
+    }
+    #endif
+
+    switch (primitive_type)
+    {
+        case Anvil::ComputePrimitiveType::COMPACTION:
+        {
+            uint32_t n_selected_elements = 0;
+
+            for (uint32_t n_element = 0;
+                          n_element < N_COMPUTE_PRIMITIVE_ELEMENTS;
+                        ++n_element)
+            {
+                if (m_compute_primitive_predicate_data[n_element] != 0)
+                {
+                    reference_data.push_back(m_compute_primitive_input_data[n_element]);
+                }
+            }
+
+            if (!m_compute_primitive_count_buffer_ptr->read(0, /* in_start_offset */
+                                                            sizeof(uint32_t),
+                                                           &n_selected_elements)        ||
+                n_selected_elements != static_cast<uint32_t>(reference_data.size() ) ||
+                !m_compute_primitive_output_buffer_ptr->read(0, /* in_start_offset */
+                                                             data_size,
+                                                             result_data.data() ) )
+            {
+                return false;
+            }
+
+            result_data.resize(n_selected_elements);
+
+            break;
+        }
+
+        case Anvil::ComputePrimitiveType::EXCLUSIVE_SCAN:
+        case Anvil::ComputePrimitiveType::INCLUSIVE_SCAN:
+        {
+            /* Exclusive scans are set up with ADD, inclusive ones with MAX. See init_compute_primitives(). */
+            const bool is_inclusive = (primitive_type == Anvil::ComputePrimitiveType::INCLUSIVE_SCAN);
+            uint32_t   prefix       = 0;
+
+            for (uint32_t n_element = 0;
+                          n_element < N_COMPUTE_PRIMITIVE_ELEMENTS;
+                        ++n_element)
+            {
+                const uint32_t value = m_compute_primitive_input_data[n_element];
+
+                if (is_inclusive)
+                {
+                    prefix = std::max(prefix,
+                                      value);
+
+                    reference_data.push_back(prefix);
+                }
+                else
+                {
+                    reference_data.push_back(prefix);
+
+                    prefix += value;
+                }
+            }
+
+            if (!m_compute_primitive_output_buffer_ptr->read(0, /* in_start_offset */
+                                                             data_size,
+                                                             result_data.data() ) )
+            {
+                return false;
+            }
+
+            break;
+        }
+
+        case Anvil::ComputePrimitiveType::RADIX_SORT:
+        {
+            /* Values hold original indices, so comparing (key, value) pairs also verifies the sort is stable. */
+            std::vector<std::pair<uint32_t, uint32_t> > pairs;
+
+            for (uint32_t n_element = 0;
+                          n_element < N_COMPUTE_PRIMITIVE_ELEMENTS;
+                        ++n_element)
+            {
+                pairs.push_back(std::make_pair(m_compute_primitive_input_data[n_element],
+                                               n_element) );
+            }
+
+            std::sort(pairs.begin(),
+                      pairs.end  () );
+
+            for (const auto& current_pair : pairs)
+            {
+                reference_data.push_back(current_pair.first);
+                reference_data.push_back(current_pair.second);
+            }
+
+            if (!m_compute_primitive_key_buffer_ptr->read  (0, /* in_start_offset */
+                                                            data_size,
+                                                            result_data.data() ) ||
+                !m_compute_primitive_value_buffer_ptr->read(0, /* in_start_offset */
+                                                            data_size,
+                                                            value_data.data() ) )
+            {
+                return false;
+            }
+
+            /* Interleave keys & values, so that the layout matches the reference data */
+            result_data.resize(N_COMPUTE_PRIMITIVE_ELEMENTS * 2);
+
+            for (uint32_t n_element = N_COMPUTE_PRIMITIVE_ELEMENTS;
+                          n_element > 0;
+                        --n_element)
+            {
+                result_data[(n_element - 1) * 2 + 1] = value_data [n_element - 1];
+                result_data[(n_element - 1) * 2 + 0] = result_data[n_element - 1];
+            }
+
+            break;
+        }
+
+        case Anvil::ComputePrimitiveType::REDUCTION:
+        {
+            /* Reductions are set up with MIN. See init_compute_primitives(). */
+            reference_data.push_back(*std::min_element(m_compute_primitive_input_data.begin(),
+                                                       m_compute_primitive_input_data.end  () ));
+
+            result_data.resize(1);
+
+            if (!m_compute_primitive_count_buffer_ptr->read(0, /* in_start_offset */
+                                                            sizeof(uint32_t),
+                                                            result_data.data() ) )
+            {
+                return false;
+            }
+
+            break;
+        }
+
+        default:
+        {
+            return false;
+        }
+    }
+
+    return (result_data == reference_data);
+}
+
+int main(int argc, char *argv[])
+{
+    int                  result  = EXIT_FAILURE;
+    std::unique_ptr<App> app_ptr(new App() );
+
+    if (app_ptr->init(argc,
+                      argv) )
+    {
+        result = app_ptr->run();
+    }
+
+    #ifdef _DEBUG
+    {
+        app_ptr.reset();
+
+        Anvil::ObjectTracker::get()->check_for_leaks();
+    }
+    #endif
+
+    return result;
+}
@@ -0,0 +1,393 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "runner.h"
+
+
+/* Heap allocation counters, updated by the replacement global operator new implementations below. */
+static std::atomic<uint64_t> g_n_allocated_bytes(0);
+static std::atomic<uint64_t> g_n_allocations    (0);
+
+
+/** Allocates @param in_size bytes and updates the allocation counters.
+ *
+ *  @return Allocated memory block or nullptr if the allocation failed.
+ **/
+static void* allocate_counted(std::size_t in_size)
+{
+    g_n_allocated_bytes.fetch_add(in_size,
+                                  std::memory_order_relaxed);
+    g_n_allocations.fetch_add    (1,
+                                  std::memory_order_relaxed);
+
+    return malloc( (in_size != 0) ? in_size : 1);
+}
+
+void* operator new(std::size_t in_size)
+{
+    void* result_ptr = allocate_counted(in_size);
+
+    if (result_ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return result_ptr;
+}
+
+void* operator new[](std::size_t in_size)
+{
+    void* result_ptr = allocate_counted(in_size);
+
+    if (result_ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return result_ptr;
+}
+
+void* operator new(std::size_t in_size,
+                   const std::nothrow_t&) noexcept
+{
+    return allocate_counted(in_size);
+}
+
+void* operator new[](std::size_t in_size,
+                     const std::nothrow_t&) noexcept
+{
+    return allocate_counted(in_size);
+}
+
+void operator delete(void* in_ptr) noexcept
+{
+    free(in_ptr);
+}
+
+void operator delete[](void* in_ptr) noexcept
+{
+    free(in_ptr);
+}
+
+void operator delete(void*                 in_ptr,
+                     const std::nothrow_t&) noexcept
+{
+    free(in_ptr);
+}
+
+void operator delete[](void*                 in_ptr,
+                       const std::nothrow_t&) noexcept
+{
+    free(in_ptr);
+}
+
+
+/** Escapes @param in_string, so that it can be embedded in a JSON string literal. */
+static std::string escape_json_string(const std::string& in_string)
+{
+    std::string result;
+
+    result.reserve(in_string.size() );
+
+    for (const auto& current_char : in_string)
+    {
+        switch (current_char)
+        {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n";  break;
+            case '\r': result += "\\r";  break;
+            case '\t': result += "\\t";  break;
+
+            default:
+            {
+                if (static_cast<unsigned char>(current_char) < 0x20)
+                {
+                    char temp[8];
+
+                    snprintf(temp,
+                             sizeof(temp),
+                             "\\u%04x",
+                             static_cast<unsigned int>(current_char) );
+
+                    result += temp;
+                }
+                else
+                {
+                    result += current_char;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+
+Runner::Runner(uint32_t           in_min_run_time_ms,
+               uint32_t           in_n_repetitions,
+               const std::string& in_opt_filter)
+    :m_filter         (in_opt_filter),
+     m_min_run_time_ms(in_min_run_time_ms),
+     m_n_repetitions  ( (in_n_repetitions != 0) ? in_n_repetitions : 1)
+{
+    /* Stub */
+}
+
+void Runner::add_benchmark(const std::string& in_name,
+                           BenchmarkFunction  in_function)
+{
+    Benchmark new_benchmark;
+
+    new_benchmark.function = in_function;
+    new_benchmark.name     = in_name;
+
+    m_benchmarks.push_back(new_benchmark);
+}
+
+void Runner::add_context(const std::string& in_key,
+                         const std::string& in_value)
+{
+    m_context.push_back(
+        std::make_pair(in_key,
+                       in_value)
+    );
+}
+
+bool Runner::run()
+{
+    bool result = true;
+
+    m_results.clear();
+
+    printf("%-52s %12s %14s %14s %12s %14s\n",
+           "Benchmark",
+           "Iterations",
+           "ns/op (med)",
+           "ns/op (min)",
+           "allocs/op",
+           "bytes/op");
+
+    for (const auto& current_benchmark : m_benchmarks)
+    {
+        BenchmarkResult current_result;
+
+        if (!m_filter.empty()                                   &&
+             current_benchmark.name.find(m_filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        if (!run_benchmark(current_benchmark,
+                          &current_result) )
+        {
+            printf("%-52s %12s\n",
+                   current_benchmark.name.c_str(),
+                   "FAILED");
+
+            result = false;
+        }
+        else
+        {
+            printf("%-52s %12llu %14.1f %14.1f %12.2f %14.1f\n",
+                   current_result.name.c_str(),
+                   static_cast<unsigned long long>(current_result.n_iterations),
+                   current_result.ns_per_op_median,
+                   current_result.ns_per_op_min,
+                   current_result.allocations_per_op,
+                   current_result.allocated_bytes_per_op);
+        }
+
+        fflush(stdout);
+
+        m_results.push_back(current_result);
+    }
+
+    return result;
+}
+
+/** Calibrates the iteration count for @param in_benchmark and executes the measured runs.
+ *
+ *  @param in_benchmark   Benchmark to execute.
+ *  @param out_result_ptr Deref will be set to the results. Must not be nullptr.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Runner::run_benchmark(const Benchmark& in_benchmark,
+                           BenchmarkResult* out_result_ptr) const
+{
+    const uint64_t      max_n_iterations       = 1ull << 32;
+    const double        min_run_time_ns        = static_cast<double>(m_min_run_time_ms) * 1000000.0;
+    uint64_t            n_allocated_bytes      = 0;
+    uint64_t            n_allocations          = 0;
+    uint64_t            n_iterations           = 1;
+    std::vector<double> ns_per_op_measurements;
+    bool                result                 = false;
+
+    out_result_ptr->failed = true;
+    out_result_ptr->name   = in_benchmark.name;
+
+    /* Warm up caches, lazily created objects etc. */
+    if (!in_benchmark.function(1) )
+    {
+        goto end;
+    }
+
+    /* Scale the iteration count up until a single run takes long enough to be measured reliably */
+    while (true)
+    {
+        const auto start_time = std::chrono::steady_clock::now();
+
+        if (!in_benchmark.function(n_iterations) )
+        {
+            goto end;
+        }
+
+        const double elapsed_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count() );
+
+        if (elapsed_ns   >= min_run_time_ns  ||
+            n_iterations >= max_n_iterations)
+        {
+            break;
+        }
+
+        /* Aim slightly above the minimum run time, but never grow by more than 100x at a time */
+        {
+            const double   estimated_n_iterations = min_run_time_ns * 1.2 / std::max(elapsed_ns, 1.0) * static_cast<double>(n_iterations);
+            const uint64_t new_n_iterations       = static_cast<uint64_t>(std::min(estimated_n_iterations,
+                                                                                   static_cast<double>(n_iterations) * 100.0) );
+
+            n_iterations = std::min(std::max(new_n_iterations,
+                                             n_iterations * 2),
+                                    max_n_iterations);
+        }
+    }
+
+    /* Execute the measured runs */
+    for (uint32_t n_repetition = 0;
+                  n_repetition < m_n_repetitions;
+                ++n_repetition)
+    {
+        const uint64_t n_allocated_bytes_before = g_n_allocated_bytes.load(std::memory_order_relaxed);
+        const uint64_t n_allocations_before     = g_n_allocations.load    (std::memory_order_relaxed);
+        const auto     start_time               = std::chrono::steady_clock::now();
+
+        if (!in_benchmark.function(n_iterations) )
+        {
+            goto end;
+        }
+
+        ns_per_op_measurements.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count() ) /
+                                         static_cast<double>(n_iterations) );
+
+        n_allocated_bytes += g_n_allocated_bytes.load(std::memory_order_relaxed) - n_allocated_bytes_before;
+        n_allocations     += g_n_allocations.load    (std::memory_order_relaxed) - n_allocations_before;
+    }
+
+    std::sort(ns_per_op_measurements.begin(),
+              ns_per_op_measurements.end  () );
+
+    out_result_ptr->allocated_bytes_per_op = static_cast<double>(n_allocated_bytes) / static_cast<double>(n_iterations * m_n_repetitions);
+    out_result_ptr->allocations_per_op     = static_cast<double>(n_allocations)     / static_cast<double>(n_iterations * m_n_repetitions);
+    out_result_ptr->failed                 = false;
+    out_result_ptr->n_iterations           = n_iterations;
+    out_result_ptr->ns_per_op_median       = ns_per_op_measurements.at(ns_per_op_measurements.size() / 2);
+    out_result_ptr->ns_per_op_min          = ns_per_op_measurements.front();
+
+    result = true;
+end:
+    return result;
+}
+
+bool Runner::write_json(const std::string& in_filename) const
+{
+    FILE* file_ptr = fopen(in_filename.c_str(),
+                           "wt");
+    bool  result   = false;
+
+    if (file_ptr == nullptr)
+    {
+        fprintf(stderr,
+                "[!] Could not open [%s] for writing.\n",
+                in_filename.c_str() );
+
+        goto end;
+    }
+
+    fprintf(file_ptr,
+            "{\n"
+            "  \"context\": {\n");
+
+    for (size_t n_context_item = 0;
+                n_context_item < m_context.size();
+              ++n_context_item)
+    {
+        fprintf(file_ptr,
+                "    \"%s\": \"%s\"%s\n",
+                escape_json_string(m_context.at(n_context_item).first).c_str(),
+                escape_json_string(m_context.at(n_context_item).second).c_str(),
+                (n_context_item + 1 < m_context.size() ) ? "," : "");
+    }
+
+    fprintf(file_ptr,
+            "  },\n"
+            "  \"benchmarks\": [\n");
+
+    for (size_t n_result = 0;
+                n_result < m_results.size();
+              ++n_result)
+    {
+        const auto& current_result = m_results.at(n_result);
+
+        fprintf(file_ptr,
+                "    {\n"
+                "      \"name\": \"%s\",\n"
+                "      \"failed\": %s,\n"
+                "      \"iterations\": %llu,\n"
+                "      \"ns_per_op_median\": %.3f,\n"
+                "      \"ns_per_op_min\": %.3f,\n"
+                "      \"allocations_per_op\": %.4f,\n"
+                "      \"allocated_bytes_per_op\": %.2f\n"
+                "    }%s\n",
+                escape_json_string(current_result.name).c_str(),
+                (current_result.failed) ? "true" : "false",
+                static_cast<unsigned long long>(current_result.n_iterations),
+                current_result.ns_per_op_median,
+                current_result.ns_per_op_min,
+                current_result.allocations_per_op,
+                current_result.allocated_bytes_per_op,
+                (n_result + 1 < m_results.size() ) ? "," : "");
+    }
+
+    fprintf(file_ptr,
+            "  ]\n"
+            "}\n");
+
+    result = (fclose(file_ptr) == 0);
+end:
+    return result;
+}
@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a small pool of I/O threads which load files in the background.
+ *
+ *  Each load() request is picked up by one of the I/O threads, which maps the file with MappedFile::create()
+ *  and, optionally, faults all of its pages in. Once done, the completion call-back is invoked from the I/O
+ *  thread and takes over ownership of the mapped file. The call-back can then, for instance, hand the mapped
+ *  region directly to the upload path with MappedFile::write_to_buffer(), or pass the MappedFile instance on
+ *  to another thread.
+ *
+ *  Requests are started in submission order, but may complete out of order if more than one I/O thread is used.
+ *
+ *  load() and get_n_pending_requests() may be called from any thread, including from within completion
+ *  call-backs. wait_idle() and the destructor must not be called from within a completion call-back.
+ */
+#ifndef MISC_ASYNC_FILE_LOADER_H
+#define MISC_ASYNC_FILE_LOADER_H
+
+#include "misc/mapped_file.h"
+#include "misc/types.h"
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+
+namespace Anvil
+{
+    /** Call-back function prototype used by AsyncFileLoader.
+     *
+     *  @param in_filename        Name of the file, as specified at load() call time.
+     *  @param in_mapped_file_ptr Mapped file contents. Ownership is transferred to the call-back. Null if the file
+     *                            could not be mapped.
+     **/
+    typedef std::function<void(const std::string&         in_filename,
+                               Anvil::MappedFileUniquePtr in_mapped_file_ptr)> AsyncFileLoadCallbackFunction;
+
+    class AsyncFileLoader
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new AsyncFileLoader instance.
+         *
+         *  @param in_n_threads Number of I/O threads to spawn. Must not be 0.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static AsyncFileLoaderUniquePtr create(uint32_t in_n_threads = 2);
+
+        /** Destructor.
+         *
+         *  Waits until all requests which have already been submitted complete, and then terminates
+         *  the I/O threads.
+         **/
+        ~AsyncFileLoader();
+
+        /** Returns the number of requests which have been submitted, but whose completion call-backs
+         *  have not returned yet.
+         **/
+        uint32_t get_n_pending_requests() const;
+
+        /** Returns the number of I/O threads used by the loader. */
+        uint32_t get_n_threads() const
+        {
+            return static_cast<uint32_t>(m_threads.size() );
+        }
+
+        /** Schedules a file for loading. The function does not block.
+         *
+         *  @param in_filename Name of the file to load.
+         *  @param in_callback Call-back to invoke from an I/O thread once the file has been mapped, or once
+         *                     the operation has failed. Must not be nullptr.
+         *  @param in_prefetch True to fault all pages of the file in on the I/O thread, before the call-back is
+         *                     invoked. See MappedFile::prefetch() for more details.
+         *
+         *  @return true if the request has been scheduled, false otherwise.
+         **/
+        bool load(const std::string&                   in_filename,
+                  const AsyncFileLoadCallbackFunction& in_callback,
+                  bool                                 in_prefetch = true);
+
+        /** Blocks until all requests which have been submitted so far complete. */
+        void wait_idle();
+
+    private:
+        /* Private type definitions */
+        typedef struct Request
+        {
+            AsyncFileLoadCallbackFunction callback;
+            std::string                   filename;
+            bool                          prefetch;
+
+            Request(const std::string&                   in_filename,
+                    const AsyncFileLoadCallbackFunction& in_callback,
+                    bool                                 in_prefetch)
+                :callback(in_callback),
+                 filename(in_filename),
+                 prefetch(in_prefetch)
+            {
+                /* Stub */
+            }
+        } Request;
+
+        /* Private functions */
+        AsyncFileLoader();
+
+        bool init       (uint32_t in_n_threads);
+        void thread_main();
+
+        /* Private variables */
+        std::condition_variable m_idle_cv;
+        mutable std::mutex      m_mutex;
+        uint32_t                m_n_pending_requests;
+        std::condition_variable m_request_submitted_cv;
+        std::deque<Request>     m_requests;
+        bool                    m_terminating;
+
+        std::vector<std::thread> m_threads;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(AsyncFileLoader);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(AsyncFileLoader);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_ASYNC_FILE_LOADER_H */
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a sub-allocator, which carves many small Anvil::Buffer views out of a single, larger parent buffer.
+ *
+ *  Each allocation is returned as a no-alloc child buffer. Child buffers do not own a VkBuffer or a memory allocation
+ *  of their own - they refer to a range of the parent's VkBuffer and can be used wherever a regular Anvil::Buffer
+ *  is accepted (vertex & index buffer bindings, descriptor sets, buffer views, Buffer::read() / Buffer::write() calls).
+ *  Releasing a child buffer returns its range to the sub-allocator.
+ *
+ *  Ranges are allocated in power-of-two multiples of a block size, which is by default large enough to satisfy all
+ *  buffer offset alignment requirements reported by the device. Each size class maintains its own free list, so both
+ *  allocation and release take constant time. Freed ranges are not coalesced with their neighbours: a range split to
+ *  serve a smaller request stays split for the remainder of the sub-allocator's lifetime.
+ *
+ *  The parent buffer must outlive the sub-allocator, and all child buffers must be released before the sub-allocator
+ *  is destroyed.
+ *
+ *  This class is thread-safe.
+ */
+#ifndef MISC_BUFFER_SUBALLOCATOR_H
+#define MISC_BUFFER_SUBALLOCATOR_H
+
+#include "misc/types.h"
+
+
+namespace Anvil
+{
+    class BufferSubAllocator
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new BufferSubAllocator instance.
+         *
+         *  @param in_parent_buffer_ptr Non-sparse buffer to carve allocations out of. Memory must already be bound to
+         *                              the buffer. Must not be nullptr.
+         *  @param in_min_block_size    Granularity of allocations. Must be a power-of-two. If 0 is specified, the block size
+         *                              is set to the largest of the uniform, storage and texel buffer offset alignments
+         *                              reported by the device.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static BufferSubAllocatorUniquePtr create(Anvil::Buffer* in_parent_buffer_ptr,
+                                                  VkDeviceSize   in_min_block_size = 0);
+
+        /** Destructor.
+         *
+         *  All child buffers returned by allocate() must have been released by the time this destructor is called.
+         **/
+        ~BufferSubAllocator();
+
+        /** Allocates a new child buffer out of the parent buffer's storage.
+         *
+         *  @param in_size      Size of the child buffer. Must not be 0.
+         *  @param in_alignment Required alignment of the child buffer's start offset, relative to the start of the parent
+         *                      buffer. Must be a power-of-two, not larger than the block size.
+         *
+         *  @return New child buffer if successful, or null if the parent buffer has run out of space.
+         **/
+        Anvil::BufferUniquePtr allocate(VkDeviceSize in_size,
+                                        VkDeviceSize in_alignment = 1);
+
+        /** Returns block size used by the sub-allocator. All allocations are rounded up to a power-of-two multiple of
+         *  this value.
+         **/
+        VkDeviceSize get_block_size() const
+        {
+            return m_block_size;
+        }
+
+        /** Returns the number of child buffers which are currently alive. */
+        uint32_t get_n_allocations() const;
+
+        /** Returns the parent buffer, as specified at creation time. */
+        Anvil::Buffer* get_parent_buffer() const
+        {
+            return m_parent_buffer_ptr;
+        }
+
+        /** Returns the number of bytes of parent buffer storage currently occupied by child buffers, including
+         *  the padding introduced by rounding allocations up to their size class.
+         **/
+        VkDeviceSize get_used_size() const;
+
+    private:
+        /* Private type definitions */
+        enum
+        {
+            /* Size classes are indexed by a power-of-two exponent, tracked in a 64-bit mask */
+            N_MAX_SIZE_CLASSES = 64
+        };
+
+        /* Private functions */
+        BufferSubAllocator(Anvil::Buffer* in_parent_buffer_ptr,
+                           VkDeviceSize   in_block_size);
+
+        uint32_t get_size_class   (VkDeviceSize in_size) const;
+        void     on_child_released(Anvil::Buffer* in_child_buffer_ptr,
+                                   VkDeviceSize   in_start_offset,
+                                   uint32_t       in_size_class);
+
+        /* Private variables */
+        VkDeviceSize                   m_block_size;
+        VkDeviceSize                   m_bump_offset;
+        std::vector<VkDeviceSize>      m_free_offsets[N_MAX_SIZE_CLASSES];
+        mutable std::mutex             m_mutex;
+        uint32_t                       m_n_allocations;
+        uint64_t                       m_non_empty_size_class_mask;
+        Anvil::Buffer*                 m_parent_buffer_ptr;
+        VkDeviceSize                   m_parent_buffer_size;
+        VkDeviceSize                   m_used_size;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(BufferSubAllocator);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(BufferSubAllocator);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_BUFFER_SUBALLOCATOR_H */
@@ -0,0 +1,283 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements reusable data-parallel GPU algorithms on top of compute pipelines:
+ *
+ *  - exclusive & inclusive scan (prefix sum, min or max).
+ *  - reduction (sum, min or max).
+ *  - key & key/value radix sort.
+ *  - stream compaction, driven by a per-element predicate buffer.
+ *
+ *  All primitives operate on tightly packed arrays of 32-bit unsigned integers, stored in storage buffers.
+ *
+ *  A ComputePrimitive instance is created for a specific primitive, a specific set of buffers and a maximum
+ *  element count. At creation time, the instance compiles & bakes the compute pipelines it needs, allocates
+ *  scratch storage and prepares descriptor sets, so that record() only binds state and dispatches work. The number of
+ *  elements to process can be changed with each record() call, up to the maximum specified at creation time.
+ *
+ *  Scans and reductions use a work-efficient, multi-level reduce-then-scan scheme. Each workgroup processes a block of
+ *  1024 elements. Block totals are scanned recursively and then added back to the blocks. Radix sort is a stable LSD
+ *  sort, processing 4 key bits per pass and reusing the scan to compute scatter offsets. Compaction scans the predicate
+ *  and scatters the selected elements, preserving their order.
+ *
+ *  If the device supports subgroup arithmetic operations in compute shaders, workgroup-wide scans are implemented with
+ *  subgroup operations, which considerably reduces the number of barriers. This can be disabled at creation time.
+ *
+ *  Shaders are compiled from GLSL at creation time, using GLSLShaderToSPIRVGenerator.
+ *
+ *  Synchronization between the internal passes is handled by record(). Apps are responsible for synchronizing
+ *  accesses made to the input buffers before, and to the output buffers after, the recorded commands.
+ */
+#ifndef MISC_COMPUTE_PRIMITIVES_H
+#define MISC_COMPUTE_PRIMITIVES_H
+
+#include "misc/types.h"
+
+
+namespace Anvil
+{
+    enum class ComputePrimitiveOperation
+    {
+        ADD,
+        MAX,
+        MIN,
+    };
+
+    enum class ComputePrimitiveType
+    {
+        COMPACTION,
+        EXCLUSIVE_SCAN,
+        INCLUSIVE_SCAN,
+        RADIX_SORT,
+        REDUCTION,
+    };
+
+    class ComputePrimitive
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new instance which copies elements whose predicate value is non-zero from the input buffer to
+         *  the output buffer, preserving their relative order. The number of copied elements is written to
+         *  @param in_output_count_buffer_ptr.
+         *
+         *  @param in_device_ptr              Device to use. Must not be nullptr.
+         *  @param in_input_buffer_ptr        Buffer holding the input elements. Must not be nullptr.
+         *  @param in_predicate_buffer_ptr    Buffer holding one predicate value per input element. Must not be nullptr.
+         *  @param in_output_buffer_ptr       Buffer to write the selected elements to. Must be large enough to hold all
+         *                                    input elements. Must not be nullptr.
+         *  @param in_output_count_buffer_ptr Buffer to write the number of selected elements to, as a single uint32.
+         *                                    Must not be nullptr.
+         *  @param in_max_n_elements          Maximum number of elements record() will be called for. Must not be 0.
+         *  @param in_use_subgroup_ops        Use subgroup operations, if supported by the device.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static ComputePrimitiveUniquePtr create_compaction(const Anvil::BaseDevice* in_device_ptr,
+                                                           Anvil::Buffer*           in_input_buffer_ptr,
+                                                           Anvil::Buffer*           in_predicate_buffer_ptr,
+                                                           Anvil::Buffer*           in_output_buffer_ptr,
+                                                           Anvil::Buffer*           in_output_count_buffer_ptr,
+                                                           uint32_t                 in_max_n_elements,
+                                                           bool                     in_use_subgroup_ops = true);
+
+        /** Creates a new instance which sorts keys, and optionally values associated with them, in ascending key order.
+         *  The sort is stable and happens in place.
+         *
+         *  @param in_device_ptr           Device to use. Must not be nullptr.
+         *  @param in_key_buffer_ptr       Buffer holding keys to sort. Must not be nullptr.
+         *  @param in_opt_value_buffer_ptr Buffer holding values to reorder along with the keys. May be nullptr.
+         *  @param in_max_n_elements       Maximum number of elements record() will be called for. Must not be 0.
+         *  @param in_use_subgroup_ops     Use subgroup operations, if supported by the device.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static ComputePrimitiveUniquePtr create_radix_sort(const Anvil::BaseDevice* in_device_ptr,
+                                                           Anvil::Buffer*           in_key_buffer_ptr,
+                                                           Anvil::Buffer*           in_opt_value_buffer_ptr,
+                                                           uint32_t                 in_max_n_elements,
+                                                           bool                     in_use_subgroup_ops = true);
+
+        /** Creates a new instance which reduces the input elements to a single value, written to
+         *  @param in_output_buffer_ptr as a single uint32.
+         *
+         *  @param in_device_ptr        Device to use. Must not be nullptr.
+         *  @param in_operation         Reduction operation.
+         *  @param in_input_buffer_ptr  Buffer holding the input elements. Must not be nullptr.
+         *  @param in_output_buffer_ptr Buffer to write the result to. Must not be nullptr.
+         *  @param in_max_n_elements    Maximum number of elements record() will be called for. Must not be 0.
+         *  @param in_use_subgroup_ops  Use subgroup operations, if supported by the device.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static ComputePrimitiveUniquePtr create_reduction(const Anvil::BaseDevice*         in_device_ptr,
+                                                          Anvil::ComputePrimitiveOperation in_operation,
+                                                          Anvil::Buffer*                   in_input_buffer_ptr,
+                                                          Anvil::Buffer*                   in_output_buffer_ptr,
+                                                          uint32_t                         in_max_n_elements,
+                                                          bool                             in_use_subgroup_ops = true);
+
+        /** Creates a new instance which computes an exclusive or inclusive scan of the input elements.
+         *
+         *  @param in_device_ptr        Device to use. Must not be nullptr.
+         *  @param in_inclusive         true to compute an inclusive scan, false to compute an exclusive one.
+         *  @param in_operation         Scan operation.
+         *  @param in_input_buffer_ptr  Buffer holding the input elements. Must not be nullptr.
+         *  @param in_output_buffer_ptr Buffer to write the results to. May be the same as @param in_input_buffer_ptr,
+         *                              in which case the scan happens in place. Must not be nullptr.
+         *  @param in_max_n_elements    Maximum number of elements record() will be called for. Must not be 0.
+         *  @param in_use_subgroup_ops  Use subgroup operations, if supported by the device.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static ComputePrimitiveUniquePtr create_scan(const Anvil::BaseDevice*         in_device_ptr,
+                                                     bool                             in_inclusive,
+                                                     Anvil::ComputePrimitiveOperation in_operation,
+                                                     Anvil::Buffer*                   in_input_buffer_ptr,
+                                                     Anvil::Buffer*                   in_output_buffer_ptr,
+                                                     uint32_t                         in_max_n_elements,
+                                                     bool                             in_use_subgroup_ops = true);
+
+        /** Destructor. Releases all pipelines, descriptor sets and scratch buffers created for the instance.
+         *
+         *  Command buffers the instance has been recorded into must no longer be executing at the time of the call.
+         **/
+        ~ComputePrimitive();
+
+        /** Returns the maximum number of elements record() can be called for. */
+        uint32_t get_max_n_elements() const
+        {
+            return m_max_n_elements;
+        }
+
+        /** Returns the type of the primitive. */
+        Anvil::ComputePrimitiveType get_type() const
+        {
+            return m_type;
+        }
+
+        /** Records commands which execute the primitive for the first @param in_n_elements elements.
+         *
+         *  Must be called outside of a render pass. Leaves a compute pipeline bound.
+         *
+         *  @param in_cmd_buffer_ptr Command buffer to record the commands into. The command buffer must have been
+         *                           allocated from a pool of a queue family with compute capabilities. Must not be nullptr.
+         *  @param in_n_elements     Number of elements to process. Must not be 0 and must not exceed the maximum
+         *                           specified at creation time.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool record(Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                    uint32_t                  in_n_elements);
+
+        /** Tells whether workgroup-wide scans are implemented with subgroup operations. */
+        bool uses_subgroup_ops() const
+        {
+            return m_use_subgroup_ops;
+        }
+
+    private:
+        /* Private type definitions */
+        enum class Kernel
+        {
+            ADD_BLOCK_TOTALS,
+            COMPACT_SCATTER,
+            RADIX_COUNT,
+            RADIX_SCATTER,
+            SCAN_BLOCK,
+            SCAN_BLOCK_PREDICATE,
+
+            COUNT
+        };
+
+        typedef struct ScanLevel
+        {
+            /* Null for the last level, which always fits in a single block */
+            Anvil::BufferUniquePtr             block_totals_buffer_ptr;
+
+            Anvil::DescriptorSetGroupUniquePtr dsg_ptr;
+
+            /* Only used by reductions. Used if the level turns out to be the last one, in which case its block total
+             * is written straight to the output buffer. */
+            Anvil::DescriptorSetGroupUniquePtr final_dsg_ptr;
+        } ScanLevel;
+
+        /* Private functions */
+        ComputePrimitive(const Anvil::BaseDevice*         in_device_ptr,
+                         Anvil::ComputePrimitiveType      in_type,
+                         Anvil::ComputePrimitiveOperation in_operation,
+                         uint32_t                         in_max_n_elements,
+                         bool                             in_use_subgroup_ops);
+
+        Anvil::DescriptorSetGroupUniquePtr create_dsg           (Anvil::Buffer* const*      in_buffer_ptrs,
+                                                                 uint32_t                   in_n_buffers) const;
+        Anvil::BufferUniquePtr             create_scratch_buffer(VkDeviceSize               in_size) const;
+        bool                               init_pipelines       (const Kernel*              in_kernels,
+                                                                 uint32_t                   in_n_kernels);
+        bool                               init_scan_levels     (Anvil::Buffer*             in_input_buffer_ptr,
+                                                                 Anvil::Buffer*             in_output_buffer_ptr,
+                                                                 Anvil::Buffer*             in_opt_reduction_output_buffer_ptr,
+                                                                 uint32_t                   in_max_n_elements);
+        bool                               record_barrier       (Anvil::CommandBufferBase*  in_cmd_buffer_ptr) const;
+        bool                               record_dispatch      (Anvil::CommandBufferBase*  in_cmd_buffer_ptr,
+                                                                 Kernel                     in_kernel,
+                                                                 Anvil::DescriptorSetGroup* in_dsg_ptr,
+                                                                 uint32_t                   in_n_elements,
+                                                                 uint32_t                   in_flags,
+                                                                 uint32_t                   in_shift,
+                                                                 uint32_t                   in_n_workgroups);
+        bool                               record_scan_levels   (Anvil::CommandBufferBase*  in_cmd_buffer_ptr,
+                                                                 uint32_t                   in_n_elements,
+                                                                 Kernel                     in_first_level_kernel,
+                                                                 bool                       in_inclusive,
+                                                                 bool                       in_reduction);
+
+        /* Private variables */
+        const Anvil::BaseDevice*               m_device_ptr;
+        Anvil::DescriptorSetGroupUniquePtr     m_layout_dsg_ptr;
+        const uint32_t                         m_max_n_elements;
+        const Anvil::ComputePrimitiveOperation m_operation;
+        Anvil::PipelineID                      m_pipeline_ids[static_cast<uint32_t>(Kernel::COUNT)];
+        std::vector<Anvil::PipelineID>         m_pipeline_ids_to_release;
+        std::vector<std::unique_ptr<Anvil::ShaderModuleStageEntryPoint> > m_shader_entrypoint_ptrs;
+        std::vector<ScanLevel>                 m_scan_levels;
+        const Anvil::ComputePrimitiveType      m_type;
+        bool                                   m_use_subgroup_ops;
+
+        /* Compaction only */
+        Anvil::DescriptorSetGroupUniquePtr     m_compact_scatter_dsg_ptr;
+        Anvil::BufferUniquePtr                 m_compact_index_buffer_ptr;
+
+        /* Radix sort only. One item per pass parity. */
+        Anvil::DescriptorSetGroupUniquePtr     m_radix_count_dsg_ptrs  [2];
+        Anvil::BufferUniquePtr                 m_radix_histogram_buffer_ptr;
+        Anvil::DescriptorSetGroupUniquePtr     m_radix_scatter_dsg_ptrs[2];
+        Anvil::BufferUniquePtr                 m_radix_scratch_key_buffer_ptr;
+        Anvil::BufferUniquePtr                 m_radix_scratch_value_buffer_ptr;
+        bool                                   m_radix_sort_values;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(ComputePrimitive);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(ComputePrimitive);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_COMPUTE_PRIMITIVES_H */
@@ -164,12 +164,24 @@ namespace Anvil
                                                     bool*                          out_opt_immutable_samplers_enabled_ptr = nullptr,
                                                     Anvil::DescriptorBindingFlags* out_opt_flags_ptr                      = nullptr) const;
 
+        /** Returns layout create flags, as specified with an earlier set_create_flags() call. */
+        const Anvil::DescriptorSetLayoutCreateFlags& get_create_flags() const
+        {
+            return m_create_flags;
+        }
+
         /** Returns the number of bindings defined for the layout. */
         uint32_t get_n_bindings() const
         {
             return static_cast<uint32_t>(m_bindings.size() );
         }
 
+        /** Tells if the layout is meant to be used for push descriptors. */
+        bool is_push_descriptor_layout() const
+        {
+            return (m_create_flags & Anvil::DescriptorSetLayoutCreateFlagBits::PUSH_DESCRIPTOR_BIT_KHR) != 0;
+        }
+
         /* Sets the number of descriptors to be used for a variable descriptor count binding.
          *
          * A variable descriptor count binding must have been added to this DS info instance before this function
@@ -177,6 +189,19 @@ namespace Anvil
          */
         bool set_binding_variable_descriptor_count(const uint32_t& in_count);
 
+        /** Sets layout create flags to use at descriptor set layout creation time. By default, no flags are set.
+         *
+         *  If PUSH_DESCRIPTOR_BIT_KHR is specified, no descriptor set may be allocated using the layout. Descriptors
+         *  need to be pushed directly into command buffers instead. Push descriptor layouts cannot include dynamic
+         *  buffer bindings, nor can they include variable descriptor count bindings.
+         *
+         *  Requires VK_KHR_push_descriptor if PUSH_DESCRIPTOR_BIT_KHR is specified.
+         */
+        void set_create_flags(const Anvil::DescriptorSetLayoutCreateFlags& in_create_flags)
+        {
+            m_create_flags = in_create_flags;
+        }
+
         bool operator==(const Anvil::DescriptorSetCreateInfo& in_ds) const;
 
     private:
@@ -243,10 +268,11 @@ namespace Anvil
         DescriptorSetCreateInfo();
 
         /* Private variables */
-        BindingIndexToBindingMap m_bindings;
+        BindingIndexToBindingMap              m_bindings;
+        Anvil::DescriptorSetLayoutCreateFlags m_create_flags;
 
-        uint32_t                 m_n_variable_descriptor_count_binding;
-        uint32_t                 m_variable_descriptor_count_binding_size;
+        uint32_t                              m_n_variable_descriptor_count_binding;
+        uint32_t                              m_variable_descriptor_count_binding_size;
 
         ANVIL_DISABLE_ASSIGNMENT_OPERATOR(DescriptorSetCreateInfo);
     };
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a device-level cache of descriptor update templates.
+ *
+ *  Descriptor sets which use the same layout and update the same set of descriptors share a single
+ *  VkDescriptorUpdateTemplate instance, instead of creating one per descriptor set. Templates are looked up by
+ *  descriptor set layout and a hash of the update entries, and are kept alive until the layout they have been
+ *  created for is released, or until the device is destroyed.
+ *
+ *  This object should ONLY be instantiated by Anvil::BaseDevice. Apps should use
+ *  BaseDevice::get_descriptor_update_template_cache() instead.
+ *
+ *  This class is thread-safe.
+ */
+#ifndef MISC_DESCRIPTOR_UPDATE_TEMPLATE_CACHE_H
+#define MISC_DESCRIPTOR_UPDATE_TEMPLATE_CACHE_H
+
+#include "misc/mt_safety.h"
+#include "misc/types.h"
+#include <unordered_map>
+
+
+namespace Anvil
+{
+    class DescriptorUpdateTemplateCache : public MTSafetySupportProvider
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new DescriptorUpdateTemplateCache instance.
+         *
+         *  @param in_device_ptr Device to create templates for. Must not be nullptr.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static DescriptorUpdateTemplateCacheUniquePtr create(const Anvil::BaseDevice* in_device_ptr);
+
+        /** Destructor.
+         *
+         *  Releases all cached templates.
+         **/
+        ~DescriptorUpdateTemplateCache();
+
+        /** Returns a descriptor update template, which can be used to update descriptor sets created with
+         *  @param in_layout_ptr, using the specified update entries. The template is created if it has not been
+         *  cached yet.
+         *
+         *  @param in_layout_ptr     Descriptor set layout to use. Must not be nullptr.
+         *  @param in_entries_ptr    Array of @param in_n_entries update entries. Must not be nullptr.
+         *  @param in_n_entries      Number of update entries. Must not be 0.
+         *
+         *  @return Requested template, or nullptr if the template could not be created. The template is owned by
+         *          the cache and stays valid until @param in_layout_ptr is released.
+         **/
+        const Anvil::DescriptorUpdateTemplate* get_template(const Anvil::DescriptorSetLayout*           in_layout_ptr,
+                                                            const Anvil::DescriptorUpdateTemplateEntry* in_entries_ptr,
+                                                            uint32_t                                    in_n_entries);
+
+        /** Returns the number of templates currently held by the cache. */
+        uint32_t get_n_cached_templates() const;
+
+    private:
+        /* Private type definitions */
+        typedef struct Item
+        {
+            std::vector<Anvil::DescriptorUpdateTemplateEntry> entries;
+            Anvil::DescriptorUpdateTemplateUniquePtr          template_ptr;
+        } Item;
+
+        /* Maps hashes of entry lists to all items sharing the hash */
+        typedef std::unordered_map<size_t, std::vector<std::unique_ptr<Item> > > ItemsPerHash;
+
+        /* Private functions */
+        explicit DescriptorUpdateTemplateCache(const Anvil::BaseDevice* in_device_ptr);
+
+        static size_t get_hash(const Anvil::DescriptorUpdateTemplateEntry* in_entries_ptr,
+                               uint32_t                                    in_n_entries);
+
+        void on_descriptor_set_layout_object_about_to_be_released(CallbackArgument* in_callback_arg_ptr);
+        void update_subscriptions                                 (bool              in_should_init);
+
+        /* Private variables */
+        const Anvil::BaseDevice*                                            m_device_ptr;
+        std::unordered_map<const Anvil::DescriptorSetLayout*, ItemsPerHash> m_items_per_layout;
+        uint32_t                                                            m_n_cached_templates;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(DescriptorUpdateTemplateCache);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(DescriptorUpdateTemplateCache);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_DESCRIPTOR_UPDATE_TEMPLATE_CACHE_H */
@@ -23,11 +23,19 @@
 /** Implements dummy window wrappers.
  *
  *  Useful for off-screen rendering purposes, with optional support for PNG snapshot dumping.
+ *
+ *  PNG snapshots are captured asynchronously. Each presented frame is copied to one of a fixed number of
+ *  readback buffers without blocking the rendering thread. Completed readbacks are detected with fences and
+ *  handed over to a pool of worker threads, which convert the data to R8G8B8A8, compress it and write it to
+ *  disk.
  */
 #ifndef DUMMY_WINDOW_H
 #define DUMMY_WINDOW_H
 
 #include "misc/window.h"
+#include <condition_variable>
+#include <deque>
+#include <thread>
 
 namespace Anvil
 {
@@ -85,11 +93,11 @@ namespace Anvil
                                              unsigned int            in_height,
                                              PresentCallbackFunction in_present_callback_func);
 
-        /** Destructor */
-        virtual ~DummyWindowWithPNGSnapshots()
-        {
-            /* Stub */
-        }
+        /** Destructor.
+         *
+         *  Waits until all pending snapshots are written to disk and terminates the worker threads.
+         **/
+        virtual ~DummyWindowWithPNGSnapshots();
 
         /* Returns window's platform */
         WindowPlatform get_platform() const
@@ -108,34 +116,108 @@ namespace Anvil
         void set_swapchain(Anvil::Swapchain* in_swapchain_ptr);
 
     private:
+        /* Private type definitions */
+
+        /* Number of swapchain image copies which can be in flight at the same time */
+        static const uint32_t N_READBACK_SLOTS = 3;
+
+        /* Maximum number of snapshots awaiting compression per worker thread. If exceeded, the rendering thread
+         * is stalled until worker threads catch up. */
+        static const uint32_t N_MAX_PENDING_JOBS_PER_WORKER = 2;
+
+        /* Maximum number of worker threads to use for PNG compression */
+        static const uint32_t N_MAX_WORKERS = 4;
+
+        typedef struct ReadbackSlot
+        {
+            Anvil::BufferUniquePtr               buffer_ptr;
+            VkDeviceSize                         buffer_size;
+            Anvil::PrimaryCommandBufferUniquePtr cmd_buffer_ptr;
+            Anvil::FenceUniquePtr                fence_ptr;
+            std::string                          file_name;
+            Anvil::Format                        format;
+            uint32_t                             height;
+            bool                                 is_in_flight;
+            uint32_t                             width;
+
+            ReadbackSlot()
+                :buffer_size (0),
+                 format      (Anvil::Format::UNKNOWN),
+                 height      (0),
+                 is_in_flight(false),
+                 width       (0)
+            {
+                /* Stub */
+            }
+        } ReadbackSlot;
+
+        typedef struct SnapshotJob
+        {
+            std::unique_ptr<uint8_t[]> data_ptr;
+            std::string                file_name;
+            Anvil::Format              format;
+            uint32_t                   height;
+            uint32_t                   width;
+        } SnapshotJob;
+
         /* Private functions */
         DummyWindowWithPNGSnapshots(const std::string&      in_title,
                                     unsigned int            in_width,
                                     unsigned int            in_height,
                                     PresentCallbackFunction in_present_callback_func);
 
-        /** Grabs contents of the specified swapchain image and returns them in a raw R8G8B8A8_UNORM
-         *  format.
+        /** Waits for all in-flight readbacks to complete, hands them over to the worker threads and blocks until
+         *  all snapshots are written to disk. Releases all Vulkan objects owned by the window.
+         **/
+        void flush_snapshots();
+
+        /** Moves the contents of a readback buffer to a new snapshot job, once the GPU has finished filling it.
+         *
+         *  @param in_slot_ptr     Readback slot to use. Must be in flight.
+         *  @param in_should_block true to wait for the readback to finish. false to only harvest the slot if the
+         *                         readback has already completed.
          *
-         *  NOTE: This solution is temporary. At some point, this function is going to be exposed 
-         *        in Image interface.
+         *  @return true if the slot has been harvested and can be reused, false otherwise.
+         **/
+        bool harvest_readback_slot(ReadbackSlot* in_slot_ptr,
+                                   bool          in_should_block);
+
+        /** Records & submits a command buffer which copies contents of the specified swapchain image to
+         *  the readback buffer of @param in_slot_ptr. Does not wait for the copy to finish.
          *
+         *  @param in_slot_ptr            Readback slot to use. Must not be in flight.
          *  @param in_swapchain_image_ptr Swapchain image, whose contents should be extracted.
+         *  @param in_file_name           Name of the file the snapshot should be stored in.
          *
-         *  @return As per summary.
+         *  @return true if successful, false otherwise.
          */
-        std::unique_ptr<uint8_t[]> get_swapchain_image_raw_r8g8b8a8_unorm_data(Anvil::Image* in_swapchain_image_ptr);
+        bool schedule_readback(ReadbackSlot*      in_slot_ptr,
+                               Anvil::Image*      in_swapchain_image_ptr,
+                               const std::string& in_file_name);
 
-        /** Grabs fake swapchain image contents and stores it in a PNG file. */
+        /** Schedules a copy of the fake swapchain image contents to a PNG file. */
         void store_swapchain_frame();
 
+        /** Entry-point for snapshot worker threads. Converts, compresses and writes queued snapshots to disk. */
+        void worker_thread_main();
+
         /* Private members */
         uint32_t    m_height;
         uint32_t    m_n_frames_presented;
         std::string m_title;
         uint32_t    m_width;
 
-        Anvil::Swapchain* m_swapchain_ptr;
+        Anvil::CommandPoolUniquePtr                 m_command_pool_ptr;
+        uint32_t                                    m_n_next_readback_slot;
+        std::vector<std::unique_ptr<ReadbackSlot> > m_readback_slots;
+        Anvil::Swapchain*                           m_swapchain_ptr;
+
+        std::condition_variable  m_job_queue_changed_cv;
+        std::deque<SnapshotJob>  m_job_queue;
+        std::mutex               m_job_queue_mutex;
+        uint32_t                 m_n_jobs_in_progress;
+        bool                     m_workers_terminating;
+        std::vector<std::thread> m_worker_threads;
     };
 }; /* namespace Anvil */
 
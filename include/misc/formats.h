@@ -32,6 +32,73 @@ namespace Anvil
     class Formats
     {
     public:
+        /** Converts pixel data stored in one format to another format on the CPU.
+         *
+         *  Both formats must be non-compressed, non-YUV color formats using one of the following format types:
+         *  UNORM, SNORM, USCALED, SSCALED, UINT, SINT, SRGB or SFLOAT. Packed formats (eg. A2B10G10R10_UNORM_PACK32,
+         *  R5G6B5_UNORM_PACK16) are supported. 64-bit components are only supported for SFLOAT formats.
+         *
+         *  Components not present in the source format are set to 0 (red, green, blue) or 1 (alpha). Values which cannot
+         *  be represented by the destination format are clamped. SRGB formats are linearized prior to conversion, so
+         *  converting between SRGB and UNORM formats changes the stored color values.
+         *
+         *  The following conversions use vectorized code paths (SSSE3), other ones fall back to a per-component path:
+         *
+         *  - Any conversion between formats whose components are all 8-bit wide and share the same format type
+         *    (eg. B8G8R8A8_UNORM <-> R8G8B8A8_UNORM, R8G8B8_UNORM -> R8G8B8A8_UNORM).
+         *  - 32-bit UNORM formats (eg. A2R10G10B10_UNORM_PACK32, A2B10G10R10_UNORM_PACK32) -> R32G32B32A32_SFLOAT
+         *    or 4-component 8-bit UNORM formats.
+         *  - FP16 <-> FP32 formats which use the same component ordering (eg. R16G16B16A16_SFLOAT <-> R32G32B32A32_SFLOAT).
+         *    FP32 values are rounded to nearest even.
+         *
+         *  @param in_src_format    Format of the source data.
+         *  @param in_src_data_ptr  Source data. Must hold at least @param in_n_pixels tightly packed pixels.
+         *  @param in_dst_format    Format to convert the data to.
+         *  @param out_dst_data_ptr Buffer to store the converted data in. Must be large enough to hold @param in_n_pixels
+         *                          tightly packed pixels. Must not overlap with the source data.
+         *  @param in_n_pixels      Number of pixels to convert.
+         *
+         *  @return true if successful, false if either of the formats is not supported.
+         **/
+        static bool convert_pixels(Anvil::Format in_src_format,
+                                   const void*   in_src_data_ptr,
+                                   Anvil::Format in_dst_format,
+                                   void*         out_dst_data_ptr,
+                                   uint32_t      in_n_pixels);
+
+        /** Converts YUV image data to R8G8B8A8_UNORM on the CPU.
+         *
+         *  Supports the following 8-bit formats: G8B8G8R8_422_UNORM, B8G8R8G8_422_UNORM, G8_B8R8_2PLANE_420_UNORM,
+         *  G8_B8R8_2PLANE_422_UNORM, G8_B8_R8_3PLANE_420_UNORM, G8_B8_R8_3PLANE_422_UNORM and G8_B8_R8_3PLANE_444_UNORM.
+         *
+         *  Chroma samples are replicated across all pixels they cover (no filtering is applied). The alpha channel
+         *  of the result data is always set to 255.
+         *
+         *  @param in_src_format            YUV format of the source data.
+         *  @param in_width                 Image width. Must be divisible by 2 for single-plane 4:2:2 formats.
+         *  @param in_height                Image height.
+         *  @param in_src_plane_data_ptrs   Array of get_format_n_planes(@param in_src_format) pointers to each plane's
+         *                                  data. Must not be nullptr.
+         *  @param in_src_plane_row_pitches Array of get_format_n_planes(@param in_src_format) row pitches, one for each
+         *                                  plane. Must not be nullptr.
+         *  @param in_model_conversion      Color model conversion to apply.
+         *  @param in_narrow_range          true if the source data uses ITU narrow range encoding, false if full range
+         *                                  encoding is used. Ignored for Anvil::SamplerYCbCrModelConversion::RGB_IDENTITY_KHR.
+         *  @param out_dst_data_ptr         Buffer to store the R8G8B8A8_UNORM result data in. Must not be nullptr.
+         *  @param in_dst_row_pitch         Row pitch to use for the result data.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        static bool convert_yuv_to_r8g8b8a8_unorm(Anvil::Format                      in_src_format,
+                                                  uint32_t                           in_width,
+                                                  uint32_t                           in_height,
+                                                  const void* const*                 in_src_plane_data_ptrs,
+                                                  const VkDeviceSize*                in_src_plane_row_pitches,
+                                                  Anvil::SamplerYCbCrModelConversion in_model_conversion,
+                                                  bool                               in_narrow_range,
+                                                  void*                              out_dst_data_ptr,
+                                                  VkDeviceSize                       in_dst_row_pitch);
+
         /* Returns a list of formats compatible with @param in_format.
          *
          * The returned array includes @param in_format.
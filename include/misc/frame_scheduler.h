@@ -0,0 +1,286 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements frame pacing for apps which keep more than one frame in flight.
+ *
+ *  The scheduler owns N frame contexts. Each context holds:
+ *
+ *  - a transient command pool, and a primary command buffer allocated from it.
+ *  - a fence, which is signalled once the GPU finishes executing the frame's submission.
+ *  - "image available" and "render finished" semaphores, used to synchronize with the swapchain.
+ *  - optionally, a pair of timestamp queries, used to measure GPU execution time of the frame.
+ *
+ *  Optionally, the scheduler also owns a UniformRingAllocator with one frame slot per context, which can be used
+ *  for transient, per-frame buffer data.
+ *
+ *  Each frame, apps:
+ *
+ *  1. call begin_frame(). The call picks the next frame context, and blocks until the GPU finishes executing the
+ *     frame which last used it. The context's command pool is then reset, and, if a swapchain has been specified,
+ *     the next swapchain image is acquired without blocking the CPU.
+ *  2. record commands into the context's command buffer. If GPU timing has been enabled, record_gpu_timer_start()
+ *     and record_gpu_timer_end() should be called at the beginning and at the end of the command buffer.
+ *  3. call end_frame(), which submits the command buffer and, if a swapchain has been specified, presents the
+ *     acquired image.
+ *
+ *  Since the CPU only ever waits for the frame N frames back, recording of frame N+1 overlaps with GPU execution
+ *  of the N preceding frames.
+ *
+ *  Submissions the app makes to the same queue before end_frame() is called are also covered by the frame's fence,
+ *  so resources they use can be recycled on the same basis as the frame context.
+ *
+ *  Only single-GPU devices are supported. This class is NOT thread-safe.
+ */
+#ifndef MISC_FRAME_SCHEDULER_H
+#define MISC_FRAME_SCHEDULER_H
+
+#include "misc/types.h"
+#include <chrono>
+
+
+namespace Anvil
+{
+    typedef struct FrameMetrics
+    {
+        /* Index of the frame the metrics refer to. */
+        uint64_t n_frame;
+
+        /* Time elapsed between begin_frame() and end_frame() calls. */
+        uint64_t cpu_frame_time_ns;
+
+        /* Time begin_frame() spent blocked, waiting for the GPU to release the frame context. */
+        uint64_t cpu_wait_time_ns;
+
+        /* Time elapsed between the timestamps written by record_gpu_timer_start() and record_gpu_timer_end().
+         * 0 if GPU timing is disabled, or if the timestamps have not been written for the frame. */
+        uint64_t gpu_time_ns;
+
+        /* Time elapsed between the frame's submission and the moment the CPU found out the GPU had finished
+         * executing it. Since completion is only checked when the frame context is about to be reused, this is
+         * an upper bound of the frame's submission-to-completion latency. */
+        uint64_t submit_to_retire_time_ns;
+
+        FrameMetrics()
+            :n_frame                 (UINT64_MAX),
+             cpu_frame_time_ns       (0),
+             cpu_wait_time_ns        (0),
+             gpu_time_ns             (0),
+             submit_to_retire_time_ns(0)
+        {
+            /* Stub */
+        }
+    } FrameMetrics;
+
+    class FrameScheduler
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new FrameScheduler instance.
+         *
+         *  @param in_device_ptr              Device to use. Must not be nullptr. Must be a single-GPU device.
+         *  @param in_queue_ptr               Queue to submit frames to, and present swapchain images with. Must not
+         *                                    be nullptr.
+         *  @param in_opt_swapchain_ptr       Swapchain to acquire & present images from. May be nullptr, in which
+         *                                    case frames are paced, but no images are acquired or presented.
+         *  @param in_n_frames_in_flight      Number of frame contexts to create. Must not be 0.
+         *  @param in_transient_data_size     Number of bytes available for transient buffer allocations in a single
+         *                                    frame. If 0, no UniformRingAllocator is created.
+         *  @param in_enable_gpu_timing       True if frame contexts should be assigned timestamp queries, false
+         *                                    otherwise. Ignored if the queue family does not support timestamps.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static FrameSchedulerUniquePtr create(Anvil::BaseDevice* in_device_ptr,
+                                              Anvil::Queue*      in_queue_ptr,
+                                              Anvil::Swapchain*  in_opt_swapchain_ptr,
+                                              uint32_t           in_n_frames_in_flight,
+                                              VkDeviceSize       in_transient_data_size = 0,
+                                              bool               in_enable_gpu_timing   = false);
+
+        /** Destructor.
+         *
+         *  Blocks until the GPU finishes executing all frames submitted by the scheduler.
+         **/
+        ~FrameScheduler();
+
+        /** Starts a new frame. Blocks until the GPU finishes executing the frame which last used the next frame
+         *  context, then acquires the next swapchain image, if a swapchain has been specified.
+         *
+         *  @param in_timeout                   Timeout for the wait, expressed in nanoseconds.
+         *  @param out_opt_acquire_result_ptr   If not nullptr, deref will be set to the result of the swapchain image
+         *                                      acquisition. Set to SUCCESS if no swapchain has been specified.
+         *
+         *  @return true if successful, false if the timeout expired, the swapchain image could not be acquired or
+         *          the transient allocator could not start a new frame. In the latter cases, the frame is not started.
+         *          If the swapchain is out of date, re-create it and pass the new one to set_swapchain() before calling
+         *          begin_frame() again.
+         **/
+        bool begin_frame(uint64_t                            in_timeout                 = UINT64_MAX,
+                         Anvil::SwapchainOperationErrorCode* out_opt_acquire_result_ptr = nullptr);
+
+        /** Closes the frame started with a preceding begin_frame() call. Submits the frame context's command buffer
+         *  and, if a swapchain has been specified, presents the image acquired by begin_frame().
+         *
+         *  The command buffer must have been recorded by the time of the call.
+         *
+         *  @param out_opt_present_result_ptr If not nullptr, deref will be set to the result of the present operation.
+         *                                    Set to SUCCESS if no swapchain has been specified.
+         *
+         *  @return true if successful, false if the submission or the present operation failed. The frame is closed
+         *          either way. If the submission failed, the frame context is not waited on when it is reused.
+         **/
+        bool end_frame(Anvil::SwapchainOperationErrorCode* out_opt_present_result_ptr = nullptr);
+
+        /** Returns the command buffer of the current frame context. Only valid between begin_frame() and end_frame()
+         *  calls.
+         *
+         *  The command buffer is reset together with its command pool in begin_frame(), so it must be recorded
+         *  from scratch each frame.
+         **/
+        Anvil::PrimaryCommandBuffer* get_command_buffer() const;
+
+        /** Returns the command pool of the current frame context. Command buffers allocated from the pool are reset
+         *  each time the context is reused.
+         **/
+        Anvil::CommandPool* get_command_pool() const;
+
+        /** Returns index of the current frame context. */
+        uint32_t get_frame_context_index() const
+        {
+            return m_n_current_frame_context;
+        }
+
+        /** Returns metrics of the most recently retired frame, ie. the latest frame which the GPU has been found to have
+         *  finished executing. n_frame is set to UINT64_MAX if no frame has been retired yet.
+         **/
+        const FrameMetrics& get_last_retired_frame_metrics() const
+        {
+            return m_last_retired_frame_metrics;
+        }
+
+        /** Returns the number of frames started with begin_frame() so far. */
+        uint64_t get_n_frames() const
+        {
+            return m_n_frames;
+        }
+
+        /** Returns the number of frame contexts. */
+        uint32_t get_n_frames_in_flight() const
+        {
+            return static_cast<uint32_t>(m_frame_contexts.size() );
+        }
+
+        /** Returns the index of the swapchain image acquired for the current frame, or UINT32_MAX if no swapchain has
+         *  been specified.
+         **/
+        uint32_t get_swapchain_image_index() const
+        {
+            return m_n_swapchain_image;
+        }
+
+        /** Returns the transient data allocator, or nullptr if it has not been requested at creation time.
+         *
+         *  begin_frame() and end_frame() of the allocator are called by the scheduler.
+         **/
+        Anvil::UniformRingAllocator* get_transient_allocator() const
+        {
+            return m_transient_allocator_ptr.get();
+        }
+
+        /** Records the timestamp which closes the GPU timer of the current frame. Should be the last command recorded
+         *  into the frame's command buffer. Nop if GPU timing is disabled.
+         **/
+        void record_gpu_timer_end(Anvil::CommandBufferBase* in_cmd_buffer_ptr);
+
+        /** Records the timestamp which opens the GPU timer of the current frame. Should be the first command recorded
+         *  into the frame's command buffer. Nop if GPU timing is disabled.
+         **/
+        void record_gpu_timer_start(Anvil::CommandBufferBase* in_cmd_buffer_ptr);
+
+        /** Changes the swapchain images are acquired from and presented to, eg. after the previous one has been
+         *  re-created. Must not be called between begin_frame() and end_frame() calls.
+         *
+         *  @param in_opt_swapchain_ptr New swapchain to use. May be nullptr.
+         **/
+        void set_swapchain(Anvil::Swapchain* in_opt_swapchain_ptr);
+
+    private:
+        /* Private type definitions */
+        typedef std::chrono::steady_clock Clock;
+
+        typedef struct FrameContext
+        {
+            Anvil::PrimaryCommandBufferUniquePtr command_buffer_ptr;
+            Anvil::CommandPoolUniquePtr          command_pool_ptr;
+            Anvil::FenceUniquePtr                fence_ptr;
+            Anvil::SemaphoreUniquePtr            image_available_semaphore_ptr;
+            Anvil::QueryPoolUniquePtr            timestamp_query_pool_ptr;
+
+            bool                                 has_been_submitted;
+            bool                                 have_timestamps_been_written;
+            FrameMetrics                         metrics;
+            Clock::time_point                    submit_time;
+
+            FrameContext()
+                :has_been_submitted          (false),
+                 have_timestamps_been_written(false)
+            {
+                /* Stub */
+            }
+        } FrameContext;
+
+        /* Private functions */
+        FrameScheduler(Anvil::BaseDevice* in_device_ptr,
+                       Anvil::Queue*      in_queue_ptr,
+                       Anvil::Swapchain*  in_opt_swapchain_ptr,
+                       uint32_t           in_n_frames_in_flight);
+
+        bool init_frame_context             (FrameContext*       in_frame_context_ptr,
+                                             bool                in_enable_gpu_timing);
+        bool init_render_finished_semaphores();
+        void retire_frame_context           (FrameContext*       in_frame_context_ptr);
+        bool wait_for_frame_context         (const FrameContext* in_frame_context_ptr,
+                                             uint64_t            in_timeout) const;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(FrameScheduler);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(FrameScheduler);
+
+        /* Private variables */
+        Anvil::BaseDevice*                     m_device_ptr;
+        Clock::time_point                      m_frame_start_time;
+        std::vector<FrameContext>              m_frame_contexts;
+        bool                                   m_is_frame_active;
+        FrameMetrics                           m_last_retired_frame_metrics;
+        uint32_t                               m_n_current_frame_context;
+        uint64_t                               m_n_frames;
+        uint32_t                               m_n_swapchain_image;
+        Anvil::Queue*                          m_queue_ptr;
+        std::vector<Anvil::SemaphoreUniquePtr> m_render_finished_semaphores;
+        Anvil::Swapchain*                      m_swapchain_ptr;
+        uint64_t                               m_timestamp_mask;
+        double                                 m_timestamp_period;
+        Anvil::UniformRingAllocatorUniquePtr   m_transient_allocator_ptr;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_FRAME_SCHEDULER_H */
@@ -0,0 +1,241 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a batching builder, which turns many CPU-side indexed draw descriptions into a handful of
+ *  multi-draw indirect calls.
+ *
+ *  Apps first register render states with add_state(). A render state is a graphics pipeline, together with
+ *  a set of descriptor sets (and dynamic offsets) to bind for it. Each frame, apps then:
+ *
+ *  1. call begin_frame().
+ *  2. call add_draw() once per draw, specifying the render state the draw should be executed with, draw arguments
+ *     and, optionally, per-instance data.
+ *  3. bind index & vertex buffers shared by all draws, and call record() from within a render pass. The draws are
+ *     sorted by pipeline and render state, packed into indirect argument & instance data storage, and emitted as
+ *     one multi-draw indirect call per render state. If VK_KHR_draw_indirect_count or VK_AMD_draw_indirect_count
+ *     is enabled, draw counts are sourced from the buffer, so that GPU culling passes can modify them in place.
+ *  4. call end_frame() after submitting the command buffer(s) record() has been called for.
+ *
+ *  Indirect arguments, draw counts and per-instance data are all stored in a single persistently mapped buffer,
+ *  managed by a UniformRingAllocator, so packing boils down to a memcpy() and no staging copies are needed.
+ *  Per-instance data is exposed to shaders via an instance-rate vertex binding. Each draw's firstInstance is set
+ *  so that it points at the draw's own instance data, which requires drawIndirectFirstInstance support.
+ *
+ *  If multiDrawIndirect is not supported, record() falls back to one indirect call per draw. The number of
+ *  API calls is then not reduced, but the argument packing still happens.
+ *
+ *  This class is NOT thread-safe.
+ */
+#ifndef MISC_INDIRECT_DRAW_BATCH_H
+#define MISC_INDIRECT_DRAW_BATCH_H
+
+#include "misc/types.h"
+
+
+namespace Anvil
+{
+    class IndirectDrawBatch
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new IndirectDrawBatch instance.
+         *
+         *  @param in_device_ptr                Device to use. Must not be nullptr.
+         *  @param in_queue_ptrs                Queues, which command buffers recorded with record() are going to be
+         *                                      submitted to. At least one queue must be specified.
+         *  @param in_max_draws_per_frame       Maximum number of add_draw() calls between begin_frame() and end_frame().
+         *                                      Must not be 0.
+         *  @param in_max_instances_per_frame   Maximum total number of instances of all draws added in a single frame.
+         *                                      Ignored if @param in_instance_data_stride is 0.
+         *  @param in_instance_data_stride      Size of per-instance data, in bytes. May be 0, in which case draws do not
+         *                                      carry per-instance data.
+         *  @param in_n_frames_in_flight        Number of frames which can be in flight at the same time. Must not be 0.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static IndirectDrawBatchUniquePtr create(const Anvil::BaseDevice*          in_device_ptr,
+                                                 const std::vector<Anvil::Queue*>& in_queue_ptrs,
+                                                 uint32_t                          in_max_draws_per_frame,
+                                                 uint32_t                          in_max_instances_per_frame,
+                                                 uint32_t                          in_instance_data_stride,
+                                                 uint32_t                          in_n_frames_in_flight);
+
+        /** Destructor.
+         *
+         *  The underlying buffer must no longer be in use by the GPU at the time of the call.
+         **/
+        ~IndirectDrawBatch();
+
+        /** Adds a new indexed draw to the current frame.
+         *
+         *  Must only be called between begin_frame() and end_frame() calls.
+         *
+         *  @param in_state_id                  ID of the render state, as returned by add_state(), to execute the draw with.
+         *  @param in_index_count               As per VkDrawIndexedIndirectCommand::indexCount.
+         *  @param in_instance_count            As per VkDrawIndexedIndirectCommand::instanceCount. Must not be 0.
+         *  @param in_first_index               As per VkDrawIndexedIndirectCommand::firstIndex.
+         *  @param in_vertex_offset             As per VkDrawIndexedIndirectCommand::vertexOffset.
+         *  @param in_opt_instance_data_ptr     Per-instance data for all @param in_instance_count instances, tightly
+         *                                      packed, with the stride specified at creation time. Must not be nullptr,
+         *                                      unless the instance data stride is 0.
+         *
+         *  @return true if successful, false if the per-frame draw or instance limit has been reached.
+         **/
+        bool add_draw(uint32_t    in_state_id,
+                      uint32_t    in_index_count,
+                      uint32_t    in_instance_count,
+                      uint32_t    in_first_index,
+                      int32_t     in_vertex_offset,
+                      const void* in_opt_instance_data_ptr = nullptr);
+
+        /** Registers a new render state. Render states persist across frames.
+         *
+         *  @param in_pipeline_id               ID of the graphics pipeline to use.
+         *  @param in_pipeline_layout_ptr       Layout of the pipeline. May be nullptr, if @param in_n_descriptor_sets is 0.
+         *  @param in_first_set                 Index of the first descriptor set to bind.
+         *  @param in_n_descriptor_sets         Number of descriptor sets to bind. May be 0.
+         *  @param in_descriptor_set_ptrs       Descriptor sets to bind. Must hold @param in_n_descriptor_sets items.
+         *  @param in_n_dynamic_offsets         Number of dynamic offsets. May be 0.
+         *  @param in_dynamic_offset_ptrs       Dynamic offsets to use. Must hold @param in_n_dynamic_offsets items.
+         *
+         *  @return ID of the new render state.
+         **/
+        uint32_t add_state(Anvil::PipelineID                  in_pipeline_id,
+                           Anvil::PipelineLayout*             in_pipeline_layout_ptr,
+                           uint32_t                           in_first_set,
+                           uint32_t                           in_n_descriptor_sets,
+                           const Anvil::DescriptorSet* const* in_descriptor_set_ptrs,
+                           uint32_t                           in_n_dynamic_offsets,
+                           const uint32_t*                    in_dynamic_offset_ptrs);
+
+        /** Starts a new frame. Blocks until the GPU finishes consuming data packed for the frame, which used the same
+         *  storage n_frames_in_flight frames ago.
+         *
+         *  @param in_timeout Timeout for the wait, expressed in nanoseconds.
+         *
+         *  @return true if successful, false if the timeout expired. In the latter case, the frame is not started.
+         **/
+        bool begin_frame(uint64_t in_timeout = UINT64_MAX);
+
+        /** Closes the frame started with a preceding begin_frame() call. Must be called after all command buffers
+         *  record() has been called for in this frame have been submitted.
+         *
+         *  Draws which have been added but not recorded are discarded.
+         **/
+        void end_frame();
+
+        /** Returns the buffer which holds indirect arguments, draw counts and per-instance data. */
+        Anvil::Buffer* get_buffer() const;
+
+        /** Returns the number of draws added since the last record() call. */
+        uint32_t get_n_pending_draws() const
+        {
+            return static_cast<uint32_t>(m_pending_draws.size() );
+        }
+
+        /** Returns the number of indirect draw calls emitted by the last record() call. */
+        uint32_t get_n_recorded_indirect_calls() const
+        {
+            return m_n_recorded_indirect_calls;
+        }
+
+        /** Sorts all draws added since the last record() call, packs them into the underlying buffer and records
+         *  the bind & indirect draw commands for them into @param in_cmd_buffer_ptr.
+         *
+         *  Index buffer and vertex buffers other than the instance data binding must be bound by the caller
+         *  beforehand. The command buffer must be recording render pass commands. Once the call returns,
+         *  the pipeline and descriptor sets of the last render state remain bound.
+         *
+         *  May be called more than once per frame, eg. once per render pass.
+         *
+         *  @param in_cmd_buffer_ptr            Command buffer to record commands into. Must not be nullptr.
+         *  @param in_instance_data_binding     Vertex input binding to bind per-instance data to. Ignored if the
+         *                                      instance data stride is 0.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool record(Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                    uint32_t                  in_instance_data_binding);
+
+    private:
+        /* Private type definitions */
+        typedef struct Draw
+        {
+            VkDrawIndexedIndirectCommand command;
+            uint32_t                     n_draw;
+            uint64_t                     sort_key;
+
+            bool operator<(const Draw& in_draw) const
+            {
+                /* Draws which share the render state retain the order they were added in */
+                return (sort_key <  in_draw.sort_key) ||
+                       (sort_key == in_draw.sort_key && n_draw < in_draw.n_draw);
+            }
+        } Draw;
+
+        typedef struct State
+        {
+            std::vector<const Anvil::DescriptorSet*> descriptor_set_ptrs;
+            std::vector<uint32_t>                    dynamic_offsets;
+            uint32_t                                 first_set;
+            Anvil::PipelineID                        pipeline_id;
+            Anvil::PipelineLayout*                   pipeline_layout_ptr;
+        } State;
+
+        /* Private functions */
+        IndirectDrawBatch(uint32_t in_max_draws_per_frame,
+                          uint32_t in_max_instances_per_frame,
+                          uint32_t in_instance_data_stride);
+
+        bool record_draws(Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                          uint32_t                  in_n_first_command,
+                          uint32_t                  in_n_commands);
+
+        /* Private variables */
+        uint32_t                              m_command_buffer_offset;
+        char*                                 m_command_data_ptr;
+        uint32_t                              m_count_buffer_offset;
+        uint32_t*                             m_count_data_ptr;
+        bool                                  m_has_draw_indirect_count_amd;
+        bool                                  m_has_draw_indirect_count_khr;
+        uint32_t                              m_instance_buffer_offset;
+        char*                                 m_instance_data_ptr;
+        const uint32_t                        m_instance_data_stride;
+        bool                                  m_is_frame_active;
+        const uint32_t                        m_max_draws_per_frame;
+        uint32_t                              m_max_indirect_draw_count;
+        const uint32_t                        m_max_instances_per_frame;
+        uint32_t                              m_n_counts_used;
+        uint32_t                              m_n_commands_used;
+        uint32_t                              m_n_instances_used;
+        uint32_t                              m_n_recorded_indirect_calls;
+        std::vector<Draw>                     m_pending_draws;
+        Anvil::UniformRingAllocatorUniquePtr  m_ring_allocator_ptr;
+        std::vector<State>                    m_states;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(IndirectDrawBatch);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(IndirectDrawBatch);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_INDIRECT_DRAW_BATCH_H */
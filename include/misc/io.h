@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "config.h"
+#include "misc/types.h"
 
 #ifdef _WIN32
     #include <windows.h>
@@ -137,6 +138,26 @@ namespace Anvil
                               size_t      in_size,
                               char**      out_result_ptr);
 
+        /** Maps file contents into the process' address space, instead of reading them into a heap-allocated
+         *  buffer. Prefer this function over read_file() for large binary files (SPIR-V blobs, textures, meshes),
+         *  especially if the data is going to be uploaded to a buffer with MappedFile::write_to_buffer().
+         *
+         *  Use Anvil::AsyncFileLoader to map files on background threads.
+         *
+         *  Upon failure, the function generates an assertion failure.
+         *
+         *
+         *  @param in_filename    Name of the file to map.
+         *  @param in_prefetch    True to fault all pages of the file in before the function returns.
+         *  @param out_result_ptr Deref will be set to the MappedFile instance owning the mapping. The view remains
+         *                        valid for as long as the instance is alive. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        static bool read_file_mapped(const std::string&          in_filename,
+                                     bool                        in_prefetch,
+                                     Anvil::MappedFileUniquePtr* out_result_ptr);
+
         /** Writes specified data to a file under specified location. If a file exists under
          *  given location, its contents is discarded.
          *
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a read-only, memory-mapped view of a file's contents.
+ *
+ *  Unlike IO::read_file(), which copies the whole file into a heap-allocated buffer, a MappedFile instance maps
+ *  the file into the process' address space. Pages are brought in by the OS on first access (or in advance,
+ *  if prefetch() is called), and no additional copy of the data is made. The view stays valid for as long as
+ *  the MappedFile instance is alive.
+ *
+ *  The mapped region can be handed directly to the upload path with write_to_buffer(). The data is then copied
+ *  from the mapped pages straight into the buffer's memory (or the staging buffer, if the buffer's memory is not
+ *  mappable), instead of being read into an intermediate heap allocation first.
+ *
+ *  MappedFile instances are immutable and can be accessed from multiple threads at the same time.
+ */
+#ifndef MISC_MAPPED_FILE_H
+#define MISC_MAPPED_FILE_H
+
+#include "misc/types.h"
+
+
+namespace Anvil
+{
+    class MappedFile
+    {
+    public:
+        /* Public functions */
+
+        /** Maps contents of the specified file into the process' address space.
+         *
+         *  @param in_filename Name of the file to map. The file must exist and must not be empty.
+         *  @param in_prefetch True to fault all pages of the file in before the function returns. See prefetch()
+         *                     for more details.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static MappedFileUniquePtr create(const std::string& in_filename,
+                                          bool               in_prefetch = false);
+
+        /** Destructor.
+         *
+         *  Unmaps the file. Any pointers returned by get_data() are invalid after this call.
+         **/
+        ~MappedFile();
+
+        /** Returns a pointer to the beginning of the mapped file contents. */
+        const void* get_data() const
+        {
+            return m_data_ptr;
+        }
+
+        /** Returns name of the file which has been mapped. */
+        const std::string& get_filename() const
+        {
+            return m_filename;
+        }
+
+        /** Returns the number of bytes exposed under get_data(). */
+        size_t get_size() const
+        {
+            return m_size;
+        }
+
+        /** Brings all pages of the mapped file into memory, so that accessing the data later on does not stall on
+         *  page faults. This is useful when the file is mapped on a background thread, but consumed on a thread
+         *  which should not block on disk I/O.
+         **/
+        void prefetch() const;
+
+        /** Copies a region of the mapped file directly into @param in_buffer_ptr's memory, using Buffer::write().
+         *
+         *  @param in_buffer_ptr          Buffer to write to. Must not be nullptr. Must have memory bound.
+         *  @param in_buffer_start_offset Offset, relative to the start of the buffer, to write the data at.
+         *  @param in_file_start_offset   Offset, relative to the start of the file, to start reading from.
+         *  @param in_size                Number of bytes to copy. @param in_file_start_offset + @param in_size must
+         *                                not be larger than get_size().
+         *  @param in_opt_queue_ptr       As per Buffer::write().
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool write_to_buffer(Anvil::Buffer* in_buffer_ptr,
+                             VkDeviceSize   in_buffer_start_offset,
+                             size_t         in_file_start_offset,
+                             size_t         in_size,
+                             Anvil::Queue*  in_opt_queue_ptr = nullptr) const;
+
+        /** Copies the whole mapped file directly into @param in_buffer_ptr's memory.
+         *
+         *  See the other write_to_buffer() overload for more details.
+         **/
+        bool write_to_buffer(Anvil::Buffer* in_buffer_ptr,
+                             VkDeviceSize   in_buffer_start_offset,
+                             Anvil::Queue*  in_opt_queue_ptr = nullptr) const
+        {
+            return write_to_buffer(in_buffer_ptr,
+                                   in_buffer_start_offset,
+                                   0, /* in_file_start_offset */
+                                   m_size,
+                                   in_opt_queue_ptr);
+        }
+
+    private:
+        /* Private functions */
+        MappedFile(const std::string& in_filename);
+
+        bool init(bool in_prefetch);
+
+        /* Private variables */
+        void*       m_data_ptr;
+        std::string m_filename;
+        size_t      m_size;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(MappedFile);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(MappedFile);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_MAPPED_FILE_H */
@@ -0,0 +1,266 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/* Implements a memory allocator backend which sub-allocates memory for registered objects from a set
+ * of large memory pages. Pages are grouped into pools by memory type, device mask, memory priority and
+ * resource tiling. Free space within each page is tracked with a two-level segregated fit (TLSF) free-list,
+ * so that both allocation and release of a region take constant time, regardless of how many regions have
+ * already been handed out.
+ *
+ * Unlike the one-shot backend, the backend can handle an arbitrary number of bake requests. Each bake
+ * request only touches items it has been handed over. Regions of memory are returned to the free-list as soon
+ * as the memory blocks, which have been created for the items, go out of scope.
+ *
+ * Dedicated allocations and allocations which can be exported via external handles are assigned separate
+ * memory blocks, as with the one-shot backend.
+ *
+ * This class should only be used internally by MemoryAllocator.
+ **/
+#ifndef MISC_MEMORY_ALLOCATOR_BACKEND_INCREMENTAL_H
+#define MISC_MEMORY_ALLOCATOR_BACKEND_INCREMENTAL_H
+
+#include "misc/types.h"
+#include "misc/memory_allocator.h"
+#include <array>
+#include <map>
+#include <mutex>
+#include <set>
+
+namespace Anvil
+{
+    namespace MemoryAllocatorBackends
+    {
+        /* Incremental memory allocator backend implementation.
+         *
+         * Should only be used by Anvil::MemoryAllocator
+         */
+        class Incremental : public Anvil::MemoryAllocator::IMemoryAllocatorBackend,
+                            public std::enable_shared_from_this<Incremental>
+        {
+        public:
+            /* Public functions */
+
+            /** Creates a new incremental memory allocator backend instance.
+             *
+             *  Should only be used internally by MemoryAllocator.
+             *
+             *  @param in_device_ptr Vulkan device the memory allocations are going to be made for.
+             *  @param in_page_size  Size of memory blocks to sub-allocate regions from. Items which do not fit
+             *                       in a page of this size are assigned a page of their own. Must not be 0.
+             **/
+            Incremental(const Anvil::BaseDevice* in_device_ptr,
+                        VkDeviceSize             in_page_size);
+
+            /** Destructor. */
+            virtual ~Incremental();
+
+        private:
+            /* Private type definitions */
+
+            /** Two-level segregated fit allocator which manages regions of a single memory page.
+             *
+             *  Free regions are stored in buckets. First-level buckets group regions by the most significant bit
+             *  of their size. Each first-level bucket is then linearly subdivided into 2^N_SECOND_LEVEL_BITS
+             *  second-level buckets. Bitmaps are used to find a non-empty bucket, holding regions which are guaranteed
+             *  to be large enough for the request, without walking the free-lists.
+             *
+             *  Neighbouring free regions are merged at release time.
+             */
+            class TLSFAllocator
+            {
+            public:
+                /* Public functions */
+
+                explicit TLSFAllocator(VkDeviceSize in_size);
+
+                /** Tries to carve a region of the requested size out of the managed range.
+                 *
+                 *  @param in_size        Size of the region. Must not be 0.
+                 *  @param in_alignment   Required alignment of the region's start offset. Must not be 0.
+                 *  @param out_offset_ptr Deref will be set to the region's start offset, if the function succeeds.
+                 *                        Must not be nullptr.
+                 *
+                 *  @return true if successful, false if no free region large enough was found.
+                 **/
+                bool allocate(VkDeviceSize  in_size,
+                              VkDeviceSize  in_alignment,
+                              VkDeviceSize* out_offset_ptr);
+
+                /** Returns a region, earlier handed out by allocate(), back to the free-list.
+                 *
+                 *  @param in_offset Start offset of the region, as returned by allocate().
+                 **/
+                void free(VkDeviceSize in_offset);
+
+                /** Tells whether all regions handed out by the allocator have been released. */
+                bool is_empty() const
+                {
+                    return (m_n_allocations == 0);
+                }
+
+            private:
+                /* Private type definitions */
+                enum
+                {
+                    N_FIRST_LEVEL_BUCKETS  = 64,
+                    N_SECOND_LEVEL_BITS    = 4,
+                    N_SECOND_LEVEL_BUCKETS = (1 << N_SECOND_LEVEL_BITS)
+                };
+
+                typedef struct Region
+                {
+                    bool         is_free;
+                    VkDeviceSize size;
+
+                    Region()
+                        :is_free(true),
+                         size   (0)
+                    {
+                        /* Stub */
+                    }
+
+                    Region(const VkDeviceSize& in_size,
+                           const bool&         in_is_free)
+                        :is_free(in_is_free),
+                         size   (in_size)
+                    {
+                        /* Stub */
+                    }
+                } Region;
+
+                /* Private functions */
+                bool find_free_region     (VkDeviceSize  in_size,
+                                           VkDeviceSize* out_offset_ptr) const;
+                void get_bucket_indices   (VkDeviceSize  in_size,
+                                           uint32_t*     out_n_first_level_bucket_ptr,
+                                           uint32_t*     out_n_second_level_bucket_ptr) const;
+                void insert_free_region   (VkDeviceSize  in_offset,
+                                           VkDeviceSize  in_size);
+                void remove_free_region   (VkDeviceSize  in_offset,
+                                           VkDeviceSize  in_size);
+
+                /* Private variables */
+                uint64_t                                                                           m_first_level_bitmap;
+                std::array<std::set<VkDeviceSize>, N_FIRST_LEVEL_BUCKETS * N_SECOND_LEVEL_BUCKETS> m_free_regions;
+                uint32_t                                                                           m_n_allocations;
+                std::map<VkDeviceSize, Region>                                                     m_regions;
+                std::array<uint32_t, N_FIRST_LEVEL_BUCKETS>                                        m_second_level_bitmaps;
+            };
+
+            typedef struct Page
+            {
+                std::unique_ptr<TLSFAllocator> allocator_ptr;
+                MemoryBlockUniquePtr           memory_block_ptr;
+
+                Page()
+                    :memory_block_ptr(nullptr,
+                                      std::default_delete<Anvil::MemoryBlock>() )
+                {
+                    /* Stub */
+                }
+            } Page;
+
+            typedef struct PoolKey
+            {
+                uint32_t device_mask;
+                bool     is_linear;
+                float    memory_priority;
+                uint32_t n_memory_type;
+
+                PoolKey(const uint32_t& in_device_mask,
+                        const bool&     in_is_linear,
+                        const float&    in_memory_priority,
+                        const uint32_t& in_n_memory_type)
+                    :device_mask    (in_device_mask),
+                     is_linear      (in_is_linear),
+                     memory_priority(in_memory_priority),
+                     n_memory_type  (in_n_memory_type)
+                {
+                    /* Stub */
+                }
+
+                bool operator<(const PoolKey& in_key) const
+                {
+                    if (device_mask != in_key.device_mask)
+                    {
+                        return device_mask < in_key.device_mask;
+                    }
+
+                    if (is_linear != in_key.is_linear)
+                    {
+                        return !is_linear;
+                    }
+
+                    if (memory_priority != in_key.memory_priority)
+                    {
+                        return memory_priority < in_key.memory_priority;
+                    }
+
+                    return n_memory_type < in_key.n_memory_type;
+                }
+            } PoolKey;
+
+            typedef std::vector<std::unique_ptr<Page> > Pages;
+
+            /* IMemoryAllocatorBackend functions */
+
+            bool     bake                            (Anvil::MemoryAllocator::Items&              in_items) final;
+            VkResult map                             (void*                                       in_memory_object,
+                                                      VkDeviceSize                                in_start_offset,
+                                                      VkDeviceSize                                in_memory_block_start_offset,
+                                                      VkDeviceSize                                in_size,
+                                                      void**                                      out_result_ptr) final;
+            bool     get_memory_type_index           (uint32_t                                    in_memory_types,
+                                                      const Anvil::MemoryFeatureFlags&            in_required_memory_features,
+                                                      uint32_t*                                   out_n_memory_type_ptr) const final;
+            bool     supports_baking                 () const final;
+            bool     supports_external_memory_handles(const Anvil::ExternalMemoryHandleTypeFlags& in_external_memory_handle_types) const final;
+            bool     supports_device_masks           ()                                                                            const final;
+            bool     supports_partial_baking         ()                                                                            const final;
+            bool     supports_protected_memory       ()                                                                            const final;
+            bool     supports_subset_baking          ()                                                                            const final;
+            void     unmap                           (void*                                       in_memory_object) final;
+
+            /* Private functions */
+            bool bake_dedicated_item       (Anvil::MemoryAllocator::Item* in_item_ptr,
+                                            uint32_t                      in_n_memory_type);
+            bool bake_pooled_item          (Anvil::MemoryAllocator::Item* in_item_ptr,
+                                            uint32_t                      in_n_memory_type);
+            bool get_memory_type_for_item  (Anvil::MemoryAllocator::Item* in_item_ptr,
+                                            uint32_t*                     out_n_memory_type_ptr) const;
+            void on_region_released        (Page*                         in_page_ptr,
+                                            VkDeviceSize                  in_offset);
+            void release_empty_pages       ();
+
+            /* Private variables */
+            const Anvil::BaseDevice*  m_device_ptr;
+            std::mutex                m_mutex;
+            const VkDeviceSize        m_page_size;
+            std::map<PoolKey, Pages>  m_pools;
+
+            ANVIL_DISABLE_ASSIGNMENT_OPERATOR(Incremental);
+            ANVIL_DISABLE_COPY_CONSTRUCTOR(Incremental);
+        };
+    };
+};
+
+#endif /* MISC_MEMORY_ALLOCATOR_BACKEND_INCREMENTAL_H */
@@ -67,10 +67,15 @@ namespace Anvil
                                                       VkDeviceSize                                in_memory_block_start_offset,
                                                       VkDeviceSize                                in_size,
                                                       void**                                      out_result_ptr) final;
+            bool     get_memory_type_index           (uint32_t                                    in_memory_types,
+                                                      const Anvil::MemoryFeatureFlags&            in_required_memory_features,
+                                                      uint32_t*                                   out_n_memory_type_ptr) const final;
             bool     supports_baking                 () const final;
             bool     supports_external_memory_handles(const Anvil::ExternalMemoryHandleTypeFlags& in_external_memory_handle_types) const final;
             bool     supports_device_masks           ()                                                                            const final;
+            bool     supports_partial_baking         ()                                                                            const final;
             bool     supports_protected_memory       ()                                                                            const final;
+            bool     supports_subset_baking          ()                                                                            const final;
             void     unmap                           (void*                                       in_memory_object) final;
 
             /* Private functions */
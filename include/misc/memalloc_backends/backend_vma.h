@@ -125,6 +125,9 @@ namespace Anvil
             /* IMemoryAllocatorBackend functions */
 
             bool     bake                            (Anvil::MemoryAllocator::Items&              in_items) final;
+            bool     get_memory_type_index           (uint32_t                                    in_memory_types,
+                                                      const Anvil::MemoryFeatureFlags&            in_required_memory_features,
+                                                      uint32_t*                                   out_n_memory_type_ptr) const final;
             VkResult map                             (void*                                       in_memory_object,
                                                       VkDeviceSize                                in_start_offset,
                                                       VkDeviceSize                                in_memory_block_start_offset,
@@ -132,8 +135,10 @@ namespace Anvil
                                                       void**                                      out_result_ptr);
             bool     supports_baking                 () const final;
             bool     supports_device_masks           ()                                                                            const final;
+            bool     supports_partial_baking         ()                                                                            const final;
             bool     supports_external_memory_handles(const Anvil::ExternalMemoryHandleTypeFlags& in_external_memory_handle_types) const final;
             bool     supports_protected_memory       ()                                                                            const final;
+            bool     supports_subset_baking          ()                                                                            const final;
             void     unmap                           (void*                                       in_memory_object);
 
             /* Private variables */
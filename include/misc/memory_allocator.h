@@ -65,6 +65,7 @@ namespace Anvil
             Anvil::Buffer*                                                                        buffer_ptr;
             std::unique_ptr<float[]>                                                              buffer_ref_float_data_ptr;
             std::unique_ptr<std::vector<float>, std::function<void (std::vector<float>*)> >       buffer_ref_float_vector_data_ptr;
+            MemoryWriteProducerFunction                                                           buffer_ref_producer_function;
             std::unique_ptr<uint8_t[]>                                                            buffer_ref_uchar8_data_ptr;
             std::unique_ptr<std::vector<unsigned char> >                                          buffer_ref_uchar8_vector_data_ptr;
             std::unique_ptr<uint32_t[]>                                                           buffer_ref_uint32_data_ptr;
@@ -213,6 +214,134 @@ namespace Anvil
 
         typedef std::vector<std::unique_ptr<Item> > Items;
 
+        typedef enum
+        {
+            /* Item's memory requirements have been relaxed, so that it can be assigned host-visible memory
+             * coming from a different heap than the one which has run out of budget. */
+            BUDGET_ACTION_DEMOTE,
+
+            /* Item has been excluded from the bake operation. It will be re-considered at next bake() call time. */
+            BUDGET_ACTION_EVICT,
+        } BudgetActionType;
+
+        /** Describes how the allocator should react if memory required by pending items would exceed
+         *  budget reported for any of the heaps by the implementation.
+         **/
+        typedef struct BudgetPolicy
+        {
+            /* Items whose memory priority is lower than or equal to this value may be demoted to memory coming from
+             * other heaps. Items which have not been assigned a memory priority are treated as if they used 0.5. */
+            float max_demotable_priority;
+
+            /* Items whose memory priority is lower than or equal to this value, and which could not be demoted,
+             * may be evicted. */
+            float max_evictable_priority;
+
+            /* Fraction of per-heap budget the allocator is allowed to use, before it starts demoting and evicting items.
+             * Must be larger than 0.0. */
+            float usage_limit;
+
+            BudgetPolicy(const float& in_max_demotable_priority = 0.5f,
+                         const float& in_max_evictable_priority = 0.25f,
+                         const float& in_usage_limit            = 0.9f)
+                :max_demotable_priority(in_max_demotable_priority),
+                 max_evictable_priority(in_max_evictable_priority),
+                 usage_limit           (in_usage_limit)
+            {
+                /* Stub */
+            }
+        } BudgetPolicy;
+
+        /** Call-back function prototype used to notify apps that pending allocations are going to exceed budget of a memory heap.
+         *
+         *  The call-back is invoked at bake() time, before any of the items is demoted or evicted. Apps can use it to release
+         *  memory they no longer need (eg. by evicting streamed resources), after which the allocator re-queries the budget.
+         *
+         *  @param in_memory_allocator_ptr Memory allocator which is about to exceed the budget.
+         *  @param in_n_heap               Index of the memory heap.
+         *  @param in_budget_limit         Number of bytes the allocator is allowed to use, as determined by the budget policy.
+         *  @param in_projected_usage      Number of bytes which would have been in use, had all pending items been allocated.
+         **/
+        typedef std::function<void (Anvil::MemoryAllocator* in_memory_allocator_ptr,
+                                    uint32_t                in_n_heap,
+                                    VkDeviceSize            in_budget_limit,
+                                    VkDeviceSize            in_projected_usage)> BudgetExceededCallbackFunction;
+
+        /** Call-back function prototype used to notify apps that a pending item has been demoted or evicted. */
+        typedef std::function<void (Anvil::MemoryAllocator* in_memory_allocator_ptr,
+                                    const Item*             in_item_ptr,
+                                    BudgetActionType        in_action)> BudgetActionCallbackFunction;
+
+        /** Describes a non-sparse image which should be considered for relocation by defragment(). */
+        typedef struct DefragmentationImage
+        {
+            /* Image to consider for relocation. */
+            Anvil::Image* image_ptr;
+
+            /* Layout all subresources of the image are in at defragment() call time. The relocated image is going to
+             * be transitioned to the same layout. Must not be UNDEFINED or PREINITIALIZED. */
+            Anvil::ImageLayout image_layout;
+
+            DefragmentationImage(Anvil::Image*      in_image_ptr,
+                                 Anvil::ImageLayout in_image_layout)
+                :image_ptr   (in_image_ptr),
+                 image_layout(in_image_layout)
+            {
+                /* Stub */
+            }
+        } DefragmentationImage;
+
+        /** Limits the amount of work a single defragment() call is allowed to perform. */
+        typedef struct DefragmentationInfo
+        {
+            /* Maximum number of bytes to relocate, counted as sizes of the memory regions assigned to the objects. */
+            VkDeviceSize max_bytes_to_move;
+
+            /* Maximum number of buffers & images to relocate. */
+            uint32_t max_allocations_to_move;
+
+            DefragmentationInfo(const VkDeviceSize& in_max_bytes_to_move       = VK_WHOLE_SIZE,
+                                const uint32_t&     in_max_allocations_to_move = UINT32_MAX)
+                :max_bytes_to_move      (in_max_bytes_to_move),
+                 max_allocations_to_move(in_max_allocations_to_move)
+            {
+                /* Stub */
+            }
+        } DefragmentationInfo;
+
+        /** Describes the work performed by a defragment() call. */
+        typedef struct DefragmentationStats
+        {
+            /* Number of bytes relocated, counted as sizes of the memory regions assigned to the original objects. */
+            VkDeviceSize bytes_moved;
+
+            /* Number of buffers & images which have been relocated. */
+            uint32_t n_allocations_moved;
+
+            /* Number of memory allocations all specified objects have been moved out of. */
+            uint32_t n_memory_blocks_evacuated;
+
+            DefragmentationStats()
+                :bytes_moved              (0),
+                 n_allocations_moved      (0),
+                 n_memory_blocks_evacuated(0)
+            {
+                /* Stub */
+            }
+        } DefragmentationStats;
+
+        /** Call-back function prototypes used by defragment() to hand relocated objects over to the application.
+         *
+         *  @param in_old_buffer_ptr / in_old_image_ptr Object which has been relocated. Its contents are still valid, but it should
+         *                                              no longer be used once the app has switched over to the new object.
+         *  @param in_new_buffer_ptr / in_new_image_ptr Object which holds a copy of the original object's contents. Ownership is
+         *                                              transferred to the application.
+         **/
+        typedef std::function<void (Anvil::Buffer*         in_old_buffer_ptr,
+                                    Anvil::BufferUniquePtr in_new_buffer_ptr)> DefragmentationBufferMovedCallbackFunction;
+        typedef std::function<void (Anvil::Image*          in_old_image_ptr,
+                                    Anvil::ImageUniquePtr  in_new_image_ptr)>  DefragmentationImageMovedCallbackFunction;
+
         class IMemoryAllocatorBackend : public IMemoryAllocatorBackendBase
         {
         public:
@@ -222,9 +351,32 @@ namespace Anvil
             }
 
             virtual bool bake                            (Items&                                      in_items)                              = 0;
+
+            /** Returns index of the memory type the backend is going to allocate memory from first for an item which can use
+             *  @param in_memory_types memory types and requires @param in_required_memory_features. Backends may still fall back
+             *  to other memory types if that allocation fails.
+             *
+             *  @return true if a compatible memory type exists, false otherwise.
+             **/
+            virtual bool get_memory_type_index           (uint32_t                                    in_memory_types,
+                                                          const Anvil::MemoryFeatureFlags&            in_required_memory_features,
+                                                          uint32_t*                                   out_n_memory_type_ptr) const = 0;
+
             virtual bool supports_device_masks           ()                                                                            const = 0;
             virtual bool supports_external_memory_handles(const Anvil::ExternalMemoryHandleTypeFlags& in_external_memory_handle_types) const = 0;
+
+            /** Tells whether implicit bakes should only assign memory to the object which needs it. Backends which return false
+             *  assign memory to all pending items whenever any object needs memory.
+             **/
+            virtual bool supports_partial_baking         ()                                                                            const = 0;
+
             virtual bool supports_protected_memory       ()                                                                            const = 0;
+
+            /** Tells whether bake() can be called for any subset of pending items, leaving remaining items pending. This is
+             *  used internally by the allocator, eg. to assign memory to objects created by defragment(), regardless of how
+             *  the backend handles implicit bakes.
+             **/
+            virtual bool supports_subset_baking          ()                                                                            const = 0;
         };
 
         /* Public functions */
@@ -240,6 +392,12 @@ namespace Anvil
          *  @param in_data_vector_ptr                         The buffer will be filled with data extracted from the specified
          *                                                    vector. Total number of bytes defined in the vector must match
          *                                                    buffer size.
+         *  @param in_producer_function                       At bake time, the function will be called to write buffer contents directly
+         *                                                    into mapped memory backing the buffer or, for non-mappable memory, into the
+         *                                                    staging buffer. The number of bytes to write is defined by buffer size.
+         *  @param in_unowned_data_ptr                        Like @param in_data_ptr, except that the allocator does not take ownership of,
+         *                                                    nor copies, the data. The pointer must remain valid till baking time. Useful
+         *                                                    for uploading data directly from a memory-mapped file region.
          *  @param in_required_memory_features                Memory features the assigned memory must support.
          *                                                    See MemoryFeatureFlagBits for more details.
          *  @param in_opt_external_nt_handle_info_ptr         TODO. Pointer must remain valid till baking time.
@@ -299,6 +457,28 @@ namespace Anvil
                                                                     const MGPUPeerMemoryRequirements*            in_opt_mgpu_peer_memory_reqs_ptr           = nullptr,
                                                                     const MGPUBindSparseDeviceIndices*           in_opt_mgpu_bind_sparse_device_indices_ptr = nullptr,
                                                                     const float&                                 in_opt_memory_priority                     = FLT_MAX);
+        bool add_buffer_with_producer_based_post_fill              (Anvil::Buffer*                               in_buffer_ptr,
+                                                                    MemoryWriteProducerFunction                  in_producer_function,
+                                                                    MemoryFeatureFlags                           in_required_memory_features,
+                                                                    const Anvil::ExternalMemoryHandleTypeFlags&  in_opt_exportable_external_handle_types    = Anvil::ExternalMemoryHandleTypeFlagBits::NONE,
+        #if defined(_WIN32)
+                                                                    const Anvil::ExternalNTHandleInfo*           in_opt_external_nt_handle_info_ptr         = nullptr,
+        #endif
+                                                                    const uint32_t*                              in_opt_device_mask_ptr                     = nullptr,
+                                                                    const MGPUPeerMemoryRequirements*            in_opt_mgpu_peer_memory_reqs_ptr           = nullptr,
+                                                                    const MGPUBindSparseDeviceIndices*           in_opt_mgpu_bind_sparse_device_indices_ptr = nullptr,
+                                                                    const float&                                 in_opt_memory_priority                     = FLT_MAX);
+        bool add_buffer_with_unowned_data_ptr_based_post_fill      (Anvil::Buffer*                               in_buffer_ptr,
+                                                                    const void*                                  in_unowned_data_ptr,
+                                                                    MemoryFeatureFlags                           in_required_memory_features,
+                                                                    const Anvil::ExternalMemoryHandleTypeFlags&  in_opt_exportable_external_handle_types    = Anvil::ExternalMemoryHandleTypeFlagBits::NONE,
+        #if defined(_WIN32)
+                                                                    const Anvil::ExternalNTHandleInfo*           in_opt_external_nt_handle_info_ptr         = nullptr,
+        #endif
+                                                                    const uint32_t*                              in_opt_device_mask_ptr                     = nullptr,
+                                                                    const MGPUPeerMemoryRequirements*            in_opt_mgpu_peer_memory_reqs_ptr           = nullptr,
+                                                                    const MGPUBindSparseDeviceIndices*           in_opt_mgpu_bind_sparse_device_indices_ptr = nullptr,
+                                                                    const float&                                 in_opt_memory_priority                     = FLT_MAX);
         bool add_buffer_with_uchar8_data_ptr_based_post_fill       (Anvil::Buffer*                               in_buffer_ptr,
                                                                     std::unique_ptr<uint8_t[]>                   in_data_ptr,
                                                                     MemoryFeatureFlags                           in_required_memory_features,
@@ -501,6 +681,26 @@ namespace Anvil
         /** TODO */
         bool bake();
 
+        /** Creates a new incremental memory allocator instance.
+         *
+         *  This type of allocator supports an arbitrary number of implicit or explicit bake invocations, and is meant
+         *  for streaming workloads where objects are created and released throughout the application's lifetime.
+         *
+         *  Memory is allocated in pages, each of which is shared by multiple objects. Regions of a page are handed
+         *  out with a TLSF (two-level segregated fit) free-list, so assigning memory to an object does not depend on
+         *  how many objects have been baked before. A region is returned to the page's free-list as soon as the memory
+         *  block it has been assigned to goes out of scope.
+         *
+         *  Implicit bakes, triggered when an object needs its memory right away, only assign memory to that object.
+         *  Other pending items are left intact.
+         *
+         *  @param in_device_ptr Device to use.
+         *  @param in_page_size  Size of a single page. Objects larger than this value are assigned a page of their own.
+         **/
+        static Anvil::MemoryAllocatorUniquePtr create_incremental(const Anvil::BaseDevice* in_device_ptr,
+                                                                  VkDeviceSize             in_page_size = 64 * 1024 * 1024,
+                                                                  MTSafety                 in_mt_safety = Anvil::MTSafety::INHERIT_FROM_PARENT_DEVICE);
+
         /** Creates a new one-shot memory allocator instance.
          *
          *  This type of allocator only supports a single explicit (or implicit) bake invocation.
@@ -521,6 +721,62 @@ namespace Anvil
         static Anvil::MemoryAllocatorUniquePtr create_vma(const Anvil::BaseDevice* in_device_ptr,
                                                           MTSafety                 in_mt_safety = Anvil::MTSafety::INHERIT_FROM_PARENT_DEVICE);
 
+        /** Relocates buffers and images out of sparsely used memory allocations, so that the memory can be released
+         *  by the backend once the original objects go out of scope.
+         *
+         *  Vulkan does not permit re-binding memory to an object, so each relocated object is replaced with a new one,
+         *  created with the same properties and assigned memory by this allocator. Contents of the original object are copied
+         *  to the new object on @param in_queue_ptr. The function blocks until the copies finish executing, after which
+         *  the new objects are handed over to the application via the call-backs.
+         *
+         *  The allocator's lock is released while the function waits for the copies, so other threads can keep using
+         *  the allocator. This does not hold if the calling thread already owns the lock, eg. when the function is called
+         *  from one of the allocator's call-backs. In that case, other threads stall until the copies finish.
+         *
+         *  Memory allocations are processed in ascending order of how many bytes of the specified objects they hold.
+         *  Processing of an allocation stops as soon as the allocator assigns a new object a region coming from that very
+         *  allocation.
+         *
+         *  An object is only considered for relocation if:
+         *
+         *  - it is non-sparse and has been created with the NO_ALLOC type, and has been assigned memory by this allocator.
+         *  - it has been created with both TRANSFER_SRC and TRANSFER_DST usage.
+         *  - it does not use a dedicated allocation and is not exportable.
+         *  - (images only) it does not use a multi-planar format.
+         *
+         *  Other objects are silently skipped.
+         *
+         *  The application must make sure that:
+         *
+         *  - none of the objects is accessed by the device while the function executes.
+         *  - @param in_queue_ptr belongs to a queue family which can access the objects without an ownership transfer.
+         *
+         *  Once a call-back is invoked, the application should rewrite descriptor sets which refer to the original object,
+         *  and retire the original object, eg. by passing it to the device's resource release queue. The memory occupied by
+         *  the original object is only released when the object goes out of scope.
+         *
+         *  Only supported for backends which can bake a subset of pending items (incremental and VMA). Does not support device
+         *  groups.
+         *  Post-bake per-item memory assignment call-backs must not be set.
+         *
+         *  @param in_queue_ptr                      Queue to perform the copies on. Must not be nullptr.
+         *  @param in_buffers                        Buffers to consider for relocation.
+         *  @param in_images                         Images to consider for relocation.
+         *  @param in_buffer_moved_callback_function Call-back to invoke for each relocated buffer. Must not be nullptr.
+         *  @param in_image_moved_callback_function  Call-back to invoke for each relocated image. Must not be nullptr.
+         *  @param in_info                           Limits to apply.
+         *  @param out_opt_stats_ptr                 If not nullptr, deref will be set to statistics of the pass.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool defragment(Anvil::Queue*                              in_queue_ptr,
+                        const std::vector<Anvil::Buffer*>&         in_buffers,
+                        const std::vector<DefragmentationImage>&   in_images,
+                        DefragmentationBufferMovedCallbackFunction in_buffer_moved_callback_function,
+                        DefragmentationImageMovedCallbackFunction  in_image_moved_callback_function,
+                        const DefragmentationInfo&                 in_info           = DefragmentationInfo(),
+                        DefragmentationStats*                      out_opt_stats_ptr = nullptr);
+
         static bool get_mem_types_supporting_mem_features(const Anvil::BaseDevice*         in_device_ptr,
                                                           uint32_t                         in_memory_types,
                                                           const Anvil::MemoryFeatureFlags& in_memory_features,
@@ -565,6 +821,45 @@ namespace Anvil
          */
         void set_post_bake_callback(MemoryAllocatorBakeCallbackFunction in_post_bake_callback_function);
 
+        /** Assigns a func pointer which will be called by the allocator whenever a pending item is demoted or evicted
+         *  at bake() time as a result of the budget policy. Pass nullptr to remove a previously assigned call-back.
+         *
+         *  @param in_callback_function Function pointer to assign.
+         */
+        void set_budget_action_callback(BudgetActionCallbackFunction in_callback_function);
+
+        /** Assigns a func pointer which will be called by the allocator at bake() time, if pending items are going
+         *  to exceed the budget of any of the memory heaps. Pass nullptr to remove a previously assigned call-back.
+         *
+         *  @param in_callback_function Function pointer to assign.
+         */
+        void set_budget_exceeded_callback(BudgetExceededCallbackFunction in_callback_function);
+
+        /** Enables or disables memory budget tracking.
+         *
+         *  When enabled, the allocator queries per-heap budgets reported by VK_EXT_memory_budget at bake() time and compares
+         *  them against memory required by pending items. If any of the heaps were to go over the limit defined by the policy,
+         *  the budget exceeded call-back is invoked first. If the heap is still over budget afterward, pending items which
+         *  use that heap are processed in ascending memory priority order:
+         *
+         *  - items whose priority does not exceed BudgetPolicy::max_demotable_priority are moved to host-visible memory types
+         *    coming from a different heap, if such are available and have enough budget left.
+         *  - remaining items whose priority does not exceed BudgetPolicy::max_evictable_priority are withheld from the bake
+         *    operation and stay pending until the next bake() call. Evictions are only performed for explicit bake() calls,
+         *    since implicit bakes are triggered by objects which need their memory to be assigned right away.
+         *
+         *  Items are processed until the projected usage fits within the limit.
+         *
+         *  Requires VK_KHR_get_physical_device_properties2 instance extension and VK_EXT_memory_budget device extension.
+         *
+         *  @param in_enable True to enable budget tracking, false to disable it.
+         *  @param in_policy Policy to use. Ignored if @param in_enable is false.
+         *
+         *  @return true if successful, false if budget tracking was requested but is not supported by the device.
+         */
+        bool set_budget_tracking_policy(bool                in_enable,
+                                        const BudgetPolicy& in_policy = BudgetPolicy() );
+
          /** Destructor.
           *
           *  Releases the underlying MemoryBlock instance
@@ -572,6 +867,29 @@ namespace Anvil
         ~MemoryAllocator();
 
     private:
+        /* Private type definitions */
+        typedef struct DefragmentationMove
+        {
+            Anvil::MemoryFeatureFlags memory_features;
+            Anvil::BufferUniquePtr    new_buffer_ptr;
+            Anvil::ImageUniquePtr     new_image_ptr;
+            Anvil::Buffer*            old_buffer_ptr;
+            Anvil::Image*             old_image_ptr;
+            Anvil::ImageLayout        old_image_layout;
+            VkDeviceSize              size;
+
+            DefragmentationMove()
+                :old_buffer_ptr  (nullptr),
+                 old_image_ptr   (nullptr),
+                 old_image_layout(Anvil::ImageLayout::UNDEFINED),
+                 size            (0)
+            {
+                /* Stub */
+            }
+        } DefragmentationMove;
+
+        typedef std::vector<std::unique_ptr<DefragmentationMove> > DefragmentationMoves;
+
         /* Private functions */
         bool add_buffer_internal(Anvil::Buffer*                              in_buffer_ptr,
                                  MemoryFeatureFlags                          in_required_memory_features,
@@ -584,12 +902,27 @@ namespace Anvil
                                  const MGPUBindSparseDeviceIndices*          in_opt_mgpu_bind_sparse_device_indices_ptr,
                                  const float&                                in_opt_memory_priority);
 
+        void apply_budget_policy(bool        in_allow_evictions,
+                                 Items*      out_evicted_items_ptr);
+        bool bake_internal      (bool        in_allow_evictions,
+                                 const void* in_opt_object_ptr);
+
+        bool create_defragmentation_object          (DefragmentationMove*                  in_move_ptr);
+        bool record_and_submit_defragmentation_moves(Anvil::Queue*                         in_queue_ptr,
+                                                     const DefragmentationMoves&           in_moves,
+                                                     Anvil::Fence*                         in_fence_ptr,
+                                                     Anvil::PrimaryCommandBufferUniquePtr* out_cmd_buffer_ptr);
+
         bool do_bind_sparse_device_indices_sanity_check  (const MGPUBindSparseDeviceIndices*          in_opt_mgpu_bind_sparse_device_indices_ptr) const;
         bool do_external_memory_handle_type_sanity_checks(const Anvil::ExternalMemoryHandleTypeFlags& in_external_memory_handle_types) const;
 
+        uint32_t get_heap_index_for_memory_types(uint32_t                         in_memory_types,
+                                                 const Anvil::MemoryFeatureFlags& in_required_memory_features) const;
+        bool     is_budget_tracking_supported   () const;
+
         void on_is_alloc_pending_for_buffer_query(CallbackArgument* in_callback_arg_ptr);
         void on_is_alloc_pending_for_image_query (CallbackArgument* in_callback_arg_ptr);
-        void on_implicit_bake_needed             ();
+        void on_implicit_bake_needed             (CallbackArgument* in_callback_arg_ptr);
 
         /** Constructor.
          *
@@ -607,6 +940,11 @@ namespace Anvil
         Items                                    m_items;
         std::map<const void*, bool>              m_per_object_pending_alloc_status;
 
+        BudgetActionCallbackFunction   m_budget_action_callback_function;
+        BudgetExceededCallbackFunction m_budget_exceeded_callback_function;
+        BudgetPolicy                   m_budget_policy;
+        bool                           m_is_budget_tracking_enabled;
+
         MemoryAllocatorBakeCallbackFunction                                m_post_bake_callback_function;
         MemoryAllocatorPostBakePerNonSparseBufferItemMemAssignmentCallback m_post_bake_per_buffer_item_mem_assignment_callback_function;
         MemoryAllocatorPostBakePerNonSparseImageItemMemAssignmentCallback  m_post_bake_per_image_item_mem_assignment_callback_function;
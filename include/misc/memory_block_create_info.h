@@ -368,6 +368,16 @@ namespace Anvil
             m_mt_safety = in_mt_safety;
         }
 
+        /* Assigns a call-back function which is going to be invoked right before the memory block is released.
+         *
+         * For derived memory blocks, this can be used to find out when a sub-region of the parent memory block
+         * is no longer in use.
+         */
+        void set_on_release_callback_function(const Anvil::OnMemoryBlockReleaseCallbackFunction& in_on_release_callback_function)
+        {
+            m_on_release_callback_function = in_on_release_callback_function;
+        }
+
         /* Call to request a dedicated allocation for the memory block. Requirements are:
          *
          * 1) Device must support VK_KHR_dedicated_allocation.
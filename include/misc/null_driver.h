@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Null Vulkan driver.
+ *
+ *  Built-in mock implementation of core Vulkan 1.0 entrypoints, which Anvil resolves Anvil::Vulkan
+ *  function pointers from instead of a Vulkan library, if Anvil has been built with the ANVIL_USE_NULL_DRIVER
+ *  CMake option enabled.
+ *
+ *  The driver does not execute any work. It exposes a single physical device with a single universal queue
+ *  family, hands out unique handles for all created objects and keeps just enough state for Anvil to operate:
+ *
+ *  - memory objects are backed by host memory, which is allocated the first time the object is mapped.
+ *  - fences become signalled as soon as they are passed to vkQueueSubmit() or vkQueueBindSparse().
+ *  - event status is tracked for host-side vkSetEvent() and vkResetEvent() calls.
+ *  - query pool results are always zero.
+ *
+ *  vkCmd*() entrypoints only increment a per-command buffer counter, so that the cost of recording is as close
+ *  to zero as possible. This lets benchmarks and CI measure the CPU overhead of Anvil alone, deterministically,
+ *  and without a GPU or an ICD.
+ *
+ *  Extension entrypoints are not implemented and no instance- or device-level extensions are reported as supported.
+ **/
+#ifndef MISC_NULL_DRIVER_H
+#define MISC_NULL_DRIVER_H
+
+#include "misc/vulkan.h"
+
+#if defined(ANVIL_USE_NULL_DRIVER)
+
+namespace Anvil
+{
+    namespace NullDriver
+    {
+        typedef struct Statistics
+        {
+            /* Number of vkCmd*() calls made for command buffers, which have since been ended */
+            uint64_t n_commands_recorded;
+
+            /* Number of vkCmd*() calls recorded in command buffers, which have been submitted */
+            uint64_t n_commands_submitted;
+
+            /* Number of command buffers submitted */
+            uint64_t n_command_buffers_submitted;
+
+            /* Number of objects created with vkCreate*() or vkAllocate*() which have not been destroyed or freed yet */
+            uint64_t n_live_objects;
+
+            /* Number of vkQueueSubmit() and vkQueueBindSparse() calls */
+            uint64_t n_queue_submissions;
+
+            Statistics()
+            {
+                n_commands_recorded         = 0;
+                n_commands_submitted        = 0;
+                n_command_buffers_submitted = 0;
+                n_live_objects              = 0;
+                n_queue_submissions         = 0;
+            }
+        } Statistics;
+
+        /** Returns a func pointer to the null driver's implementation of the specified Vulkan entrypoint.
+         *
+         *  @param in_name Name of the entrypoint, eg. "vkCreateInstance". Must not be nullptr.
+         *
+         *  @return Requested func pointer or nullptr if the entrypoint is not implemented by the null driver.
+         **/
+        PFN_vkVoidFunction get_proc_address(const char* in_name);
+
+        /** Returns counters gathered by the null driver since startup or the last reset_statistics() call. */
+        Statistics get_statistics();
+
+        /** Zeroes all counters, except for the number of live objects. */
+        void reset_statistics();
+    };
+};
+
+#endif /* ANVIL_USE_NULL_DRIVER */
+
+#endif /* MISC_NULL_DRIVER_H */
@@ -58,6 +58,17 @@ namespace Anvil
          */
         OBJECT_TRACKER_CALLBACK_ID_ON_SHADER_MODULE_OBJECT_REGISTERED,
 
+        /* Callback issued when an existing DescriptorSetLayout object instance is about to go out of scope.
+         *
+         * This callback IS issued BEFORE a corresponding Vulkan handle is destroyed.
+         *
+         * This callback MAY be issued FROM WITHIN the object's destructor, implying all WEAK POINTERS pointing
+         * to the wrapper instance will have been expired at the time of the callback.
+         *
+         * @param callback_arg OnObjectAboutToBeUnregisteredCallbackArgument structure instance
+         **/
+        OBJECT_TRACKER_CALLBACK_ID_ON_DESCRIPTOR_SET_LAYOUT_OBJECT_ABOUT_TO_BE_UNREGISTERED,
+
         /* Callback issued when an existing Device object instance is about to go out of scope.
          *
          * This callback IS issued BEFORE a corresponding Vulkan handle is destroyed.
@@ -28,7 +28,12 @@
 
 namespace Anvil
 {
-    /** Tracks memory page bindings for sparse images & sparse buffers */
+    /** Tracks memory page bindings for sparse images & sparse buffers.
+     *
+     *  Bindings are kept in a vector of disjoint ranges, sorted by start offset, so that lookups take O(log n) time.
+     *  Adjacent ranges which map to contiguous regions of the same memory block are coalesced into a single range.
+     *  Ranges with no memory backing are not stored.
+     **/
     class PageTracker
     {
     public:
@@ -141,9 +146,13 @@ namespace Anvil
         } MemoryBlockBinding;
 
         /* Private functions */
+        static bool can_coalesce(const MemoryBlockBinding& in_binding,
+                                 const MemoryBlockBinding& in_next_binding);
+
+        std::vector<MemoryBlockBinding>::const_iterator find_first_binding_ending_after(VkDeviceSize in_offset) const;
 
         /* Private variables */
-        std::vector<MemoryBlockBinding>  m_memory_blocks;
+        std::vector<MemoryBlockBinding>  m_memory_blocks; /* sorted by start_offset, disjoint */
         uint32_t                         m_n_memory_blocks_with_memory_backing;
         uint32_t                         m_n_pages_with_memory_backing;
         uint32_t                         m_n_total_pages;
@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a helper which splits recording of a single subpass' contents across multiple threads.
+ *
+ *  Each worker owns a dedicated command pool and a secondary-level command buffer, so no locking is
+ *  required while commands are being recorded. The calling thread acts as the first worker. Once all
+ *  workers finish, the secondary command buffers are executed from within the primary command buffer
+ *  in work item order.
+ *
+ *  Typical usage:
+ *
+ *  1. Start recording the primary command buffer and begin the render pass with
+ *     Anvil::SubpassContents::SECONDARY_COMMAND_BUFFERS contents.
+ *  2. Call record() with the number of work items to record and a callback which records a range of
+ *     work items into the provided secondary command buffer.
+ *  3. End the render pass and submit the primary command buffer as usual.
+ *
+ *  Secondary command buffers are reused across record() calls. The application must therefore make sure
+ *  that the GPU is no longer executing the primary command buffer the previous record() call recorded to
+ *  before record() is called again. Apps which keep more than one frame in flight should instantiate one
+ *  recorder per frame in flight.
+ *
+ *  record() must not be called from more than one thread at a time.
+ */
+#ifndef MISC_PARALLEL_RENDER_PASS_RECORDER_H
+#define MISC_PARALLEL_RENDER_PASS_RECORDER_H
+
+#include "misc/types.h"
+#include <condition_variable>
+#include <thread>
+
+
+namespace Anvil
+{
+    /** Call-back function prototype used by ParallelRenderPassRecorder.
+     *
+     *  @param in_cmd_buffer_ptr   Secondary command buffer to record commands to. The command buffer has already
+     *                             been put into recording mode and will be closed once the call-back returns.
+     *  @param in_n_worker         Index of the worker the call-back is being invoked from.
+     *  @param in_n_first_item     Index of the first work item to record.
+     *  @param in_n_items          Number of work items to record, starting from @param in_n_first_item.
+     **/
+    typedef std::function<void(Anvil::SecondaryCommandBuffer* in_cmd_buffer_ptr,
+                               uint32_t                       in_n_worker,
+                               uint32_t                       in_n_first_item,
+                               uint32_t                       in_n_items)> ParallelRecordingCallbackFunction;
+
+    class ParallelRenderPassRecorder
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new ParallelRenderPassRecorder instance.
+         *
+         *  @param in_device_ptr         Device to use. Must not be nullptr.
+         *  @param in_queue_family_index Index of the queue family the primary command buffers, whose subpass contents
+         *                               are going to be recorded in parallel, will be submitted to.
+         *  @param in_n_workers          Number of workers to use, including the calling thread.
+         *                               Pass 0 to use as many workers as there are hardware threads available.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static ParallelRenderPassRecorderUniquePtr create(Anvil::BaseDevice* in_device_ptr,
+                                                          uint32_t           in_queue_family_index,
+                                                          uint32_t           in_n_workers = 0);
+
+        /** Destructor.
+         *
+         *  Terminates all worker threads and releases all command buffers & pools owned by the recorder.
+         **/
+        ~ParallelRenderPassRecorder();
+
+        /** Returns the number of workers (including the calling thread) used by the recorder. */
+        uint32_t get_n_workers() const
+        {
+            return static_cast<uint32_t>(m_workers.size() );
+        }
+
+        /** Records @param in_n_work_items work items into per-worker secondary command buffers in parallel and then
+         *  executes the command buffers from within @param in_primary_cmd_buffer_ptr, in work item order.
+         *
+         *  Work items are split into contiguous ranges, one per worker. A worker is only used if it is going to be
+         *  assigned at least @param in_n_min_items_per_worker work items.
+         *
+         *  @param in_primary_cmd_buffer_ptr Primary command buffer to record a vkCmdExecuteCommands() call to. Must
+         *                                   be in recording mode, and within a subpass whose contents have been
+         *                                   declared as Anvil::SubpassContents::SECONDARY_COMMAND_BUFFERS.
+         *  @param in_render_pass_ptr        Render pass the subpass belongs to. Must not be nullptr.
+         *  @param in_subpass_id             ID of the subpass the commands are going to be executed in.
+         *  @param in_opt_framebuffer_ptr    Framebuffer the render pass has been started for. May be nullptr, but
+         *                                   specifying it may result in better performance on some implementations.
+         *  @param in_n_work_items           Number of work items to record. If 0, the function is a nop.
+         *  @param in_callback               Call-back to invoke for each worker's work item range. Will be invoked
+         *                                   from multiple threads at the same time.
+         *  @param in_n_min_items_per_worker Minimum number of work items to assign to a single worker. Must not be 0.
+         *  @param in_opt_device_mask        Device mask to use for the secondary command buffers. Only used for mGPU
+         *                                   devices.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool record(Anvil::PrimaryCommandBuffer*             in_primary_cmd_buffer_ptr,
+                    Anvil::RenderPass*                       in_render_pass_ptr,
+                    Anvil::SubPassID                         in_subpass_id,
+                    Anvil::Framebuffer*                      in_opt_framebuffer_ptr,
+                    uint32_t                                 in_n_work_items,
+                    const ParallelRecordingCallbackFunction& in_callback,
+                    uint32_t                                 in_n_min_items_per_worker = 1,
+                    uint32_t                                 in_opt_device_mask        = UINT32_MAX);
+
+    private:
+        /* Private type definitions */
+        typedef struct Worker
+        {
+            Anvil::SecondaryCommandBufferUniquePtr cmd_buffer_ptr;
+            Anvil::CommandPoolUniquePtr            command_pool_ptr;
+            uint32_t                               n_first_item;
+            uint32_t                               n_items;
+            bool                                   result;
+            std::thread                            thread;
+
+            Worker()
+                :n_first_item(0),
+                 n_items     (0),
+                 result      (false)
+            {
+                /* Stub */
+            }
+        } Worker;
+
+        /* Private functions */
+        ParallelRenderPassRecorder(Anvil::BaseDevice* in_device_ptr,
+                                   uint32_t           in_queue_family_index);
+
+        bool init         (uint32_t in_n_workers);
+        void record_worker(uint32_t in_n_worker);
+        void thread_main  (uint32_t in_n_worker);
+
+        /* Private variables */
+        Anvil::BaseDevice* m_device_ptr;
+        uint32_t           m_queue_family_index;
+
+        std::condition_variable m_job_done_cv;
+        std::condition_variable m_job_submitted_cv;
+        uint64_t                m_job_generation;
+        std::mutex              m_mutex;
+        uint32_t                m_n_pending_workers;
+        bool                    m_terminating;
+
+        const ParallelRecordingCallbackFunction* m_current_callback_ptr;
+        uint32_t                                 m_current_device_mask;
+        Anvil::Framebuffer*                      m_current_framebuffer_ptr;
+        uint32_t                                 m_current_n_active_workers;
+        Anvil::RenderPass*                       m_current_render_pass_ptr;
+        Anvil::SubPassID                         m_current_subpass_id;
+
+        std::vector<std::unique_ptr<Worker> > m_workers;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(ParallelRenderPassRecorder);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(ParallelRenderPassRecorder);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_PARALLEL_RENDER_PASS_RECORDER_H */
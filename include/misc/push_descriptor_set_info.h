@@ -0,0 +1,199 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Describes a set of descriptor writes, which can be pushed directly into a command buffer with
+ *  CommandBufferBase::record_push_descriptor_set() (VK_KHR_push_descriptor).
+ *
+ *  Bindings are specified with the same binding element structures Anvil::DescriptorSet uses. Unlike descriptor sets,
+ *  push descriptors do not require a descriptor pool, nor are they updated with vkUpdateDescriptorSets(). This makes
+ *  them a good fit for transient, per-draw bindings.
+ *
+ *  Instances are meant to be reused: clear() drops all writes but retains internal storage, so that no allocations
+ *  are needed once the object has warmed up.
+ *
+ *  This class is NOT thread-safe.
+ */
+#ifndef MISC_PUSH_DESCRIPTOR_SET_INFO_H
+#define MISC_PUSH_DESCRIPTOR_SET_INFO_H
+
+#include "misc/types.h"
+#include "wrappers/descriptor_set.h"
+
+
+namespace Anvil
+{
+    class PushDescriptorSetInfo
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new PushDescriptorSetInfo instance, holding no writes. */
+        static PushDescriptorSetInfoUniquePtr create();
+
+        /** Destructor. */
+        ~PushDescriptorSetInfo();
+
+        /** Drops all writes specified so far. Internal storage is retained. */
+        void clear();
+
+        /** Returns the number of VkWriteDescriptorSet structures get_write_descriptor_sets_vk() is going to return. */
+        uint32_t get_n_writes() const
+        {
+            return static_cast<uint32_t>(m_writes.size() );
+        }
+
+        /** Returns an array of get_n_writes() VkWriteDescriptorSet structures, describing all writes specified so far.
+         *
+         *  The returned pointer, as well as pointers embedded in the structures, stay valid until the next non-const
+         *  call is made against this instance.
+         *
+         *  @return As per description, or nullptr if no writes have been specified.
+         **/
+        const VkWriteDescriptorSet* get_write_descriptor_sets_vk() const;
+
+        /** Adds a write, which updates a range of array items of the specified binding.
+         *
+         *  Accepts the same binding element structures as DescriptorSet::set_binding_array_items(), except for
+         *  DynamicStorageBufferBindingElement and DynamicUniformBufferBindingElement. Dynamic buffer bindings cannot
+         *  be used with push descriptors.
+         *
+         *  This function CANNOT be used for inline uniform block bindings.
+         *
+         *  @param in_binding_index Index of the binding to update. Must correspond to a binding defined for the push
+         *                          descriptor set layout, which the writes are going to be pushed for.
+         *  @param in_element_range Range of array items to update. Number of elements must not be 0.
+         *  @param in_elements_ptr  Array of in_element_range.second elements to use for the update. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        template<typename BindingElementType>
+        bool set_binding_array_items(BindingIndex              in_binding_index,
+                                     BindingElementArrayRange  in_element_range,
+                                     const BindingElementType* in_elements_ptr)
+        {
+            Write    new_write;
+            uint32_t n_first_info = UINT32_MAX;
+            bool     result       = false;
+
+            if (in_elements_ptr         == nullptr ||
+                in_element_range.second == 0)
+            {
+                anvil_assert(in_elements_ptr         != nullptr);
+                anvil_assert(in_element_range.second != 0);
+
+                goto end;
+            }
+
+            if (in_elements_ptr[0].get_type() == Anvil::DescriptorType::STORAGE_BUFFER_DYNAMIC ||
+                in_elements_ptr[0].get_type() == Anvil::DescriptorType::UNIFORM_BUFFER_DYNAMIC)
+            {
+                /* Dynamic buffer descriptors cannot be pushed */
+                anvil_assert_fail();
+
+                goto end;
+            }
+
+            for (uint32_t n_element = 0;
+                          n_element < in_element_range.second;
+                        ++n_element)
+            {
+                const uint32_t n_info = append_info(in_elements_ptr[n_element]);
+
+                if (n_element == 0)
+                {
+                    n_first_info = n_info;
+                }
+            }
+
+            new_write.descriptor_type = in_elements_ptr[0].get_type();
+            new_write.n_binding       = in_binding_index;
+            new_write.n_elements      = in_element_range.second;
+            new_write.n_first_element = in_element_range.first;
+            new_write.n_first_info    = n_first_info;
+
+            m_writes.push_back(new_write);
+
+            result = true;
+        end:
+            return result;
+        }
+
+        /** This function works exactly like set_binding_array_items(), except that it always updates the zeroth element
+         *  of the specified binding.
+         */
+        template<typename BindingElementType>
+        bool set_binding_item(BindingIndex              in_binding_index,
+                              const BindingElementType& in_element)
+        {
+            return set_binding_array_items(in_binding_index,
+                                           BindingElementArrayRange(0,  /* StartBindingElementIndex */
+                                                                    1), /* NumberOfBindingElements  */
+                                          &in_element);
+        }
+
+    private:
+        /* Private type definitions */
+
+        /* Describes a single write. Descriptor infos are stored in type-specific vectors, so only indices are
+         * cached at this point. Vulkan structures are only baked when requested.
+         */
+        typedef struct Write
+        {
+            Anvil::DescriptorType descriptor_type;
+            BindingIndex          n_binding;
+            uint32_t              n_elements;
+            uint32_t              n_first_element;
+            uint32_t              n_first_info;
+
+            Write()
+            {
+                descriptor_type = Anvil::DescriptorType::UNKNOWN;
+                n_binding       = UINT32_MAX;
+                n_elements      = 0;
+                n_first_element = 0;
+                n_first_info    = UINT32_MAX;
+            }
+        } Write;
+
+        /* Private functions */
+        PushDescriptorSetInfo();
+
+        uint32_t append_info(const Anvil::DescriptorSet::BufferBindingElement&               in_element);
+        uint32_t append_info(const Anvil::DescriptorSet::CombinedImageSamplerBindingElement& in_element);
+        uint32_t append_info(const Anvil::DescriptorSet::ImageBindingElement&                in_element);
+        uint32_t append_info(const Anvil::DescriptorSet::SamplerBindingElement&              in_element);
+        uint32_t append_info(const Anvil::DescriptorSet::TexelBufferBindingElement&          in_element);
+
+        /* Private variables */
+        std::vector<VkDescriptorBufferInfo> m_buffer_infos_vk;
+        std::vector<VkBufferView>           m_buffer_views_vk;
+        std::vector<VkDescriptorImageInfo>  m_image_infos_vk;
+        std::vector<Write>                  m_writes;
+
+        mutable std::vector<VkWriteDescriptorSet> m_writes_vk;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(PushDescriptorSetInfo);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(PushDescriptorSetInfo);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_PUSH_DESCRIPTOR_SET_INFO_H */
@@ -0,0 +1,257 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a ring of per-frame query ranges, whose results are harvested asynchronously.
+ *
+ *  The ring owns a single query pool and a persistently mapped, host-coherent readback buffer, both divided into a
+ *  fixed number of frame slots. Each frame:
+ *
+ *  - begin_frame() moves on to the next frame slot, delivers results still pending for the slot, and records a single
+ *    reset command covering all queries of the slot.
+ *  - allocate() hands out consecutive query indices from the slot. Each allocation is associated with a callback,
+ *    which is going to receive results of the allocated queries.
+ *  - end_frame() records a single copy of the results of all queries allocated in the frame to the readback buffer.
+ *
+ *  Results are delivered once the GPU finishes executing the submission which the frame's commands have been recorded
+ *  into. No vkGetQueryPoolResults() calls are made, and the CPU only blocks if the GPU falls more than
+ *  get_n_frame_slots() - 1 frames behind. Callbacks are invoked from begin_frame() and harvest(), in frame order.
+ *
+ *  Results are delivered as 64-bit values, tightly packed. Pipeline statistics queries return one value per enabled
+ *  statistic. Timestamps are delivered as is, ie. the app needs to mask out bits beyond the queue's timestamp valid
+ *  bits, and to scale them by the device's timestamp period.
+ *
+ *  Usage requirements:
+ *
+ *  - the command buffer passed to begin_frame() must be submitted before any command buffer which uses queries
+ *    allocated in the frame, and must not record commands within a render pass at the time of the call.
+ *  - the command buffer passed to end_frame() must be submitted after all command buffers which use queries allocated
+ *    in the frame. Each allocated query must have been written to by the time the copy executes.
+ *  - all command buffers recorded for a frame must have been submitted to the queue specified at creation time by the
+ *    time the next begin_frame() or harvest() call is made.
+ *
+ *  This class is NOT thread-safe.
+ */
+#ifndef MISC_QUERY_RING_H
+#define MISC_QUERY_RING_H
+
+#include "misc/types.h"
+
+
+namespace Anvil
+{
+    /** Receives results of queries allocated with a single QueryRing::allocate() call.
+     *
+     *  @param in_results_ptr        @param in_n_queries * @param in_n_values_per_query tightly packed results. Only
+     *                               valid for the duration of the call.
+     *  @param in_n_queries          Number of queries allocated.
+     *  @param in_n_values_per_query Number of values returned per query.
+     **/
+    typedef std::function<void(const uint64_t* in_results_ptr,
+                               uint32_t        in_n_queries,
+                               uint32_t        in_n_values_per_query)> QueryRingCallbackFunction;
+
+    class QueryRing
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new QueryRing instance for occlusion or timestamp queries.
+         *
+         *  @param in_device_ptr          Device to use. Must not be nullptr.
+         *  @param in_queue_ptr           Queue, which command buffers using the queries are going to be submitted to.
+         *                                Must not be nullptr.
+         *  @param in_query_type          Query type. Must be VK_QUERY_TYPE_OCCLUSION or VK_QUERY_TYPE_TIMESTAMP.
+         *  @param in_n_queries_per_frame Maximum number of queries which can be allocated in a single frame. Must not
+         *                                be 0.
+         *  @param in_n_frame_slots       Number of frame slots, usually equal to the number of frames in flight plus
+         *                                one. Must not be 0.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static QueryRingUniquePtr create_non_ps_query_ring(Anvil::BaseDevice* in_device_ptr,
+                                                           Anvil::Queue*      in_queue_ptr,
+                                                           VkQueryType        in_query_type,
+                                                           uint32_t           in_n_queries_per_frame,
+                                                           uint32_t           in_n_frame_slots);
+
+        /** Creates a new QueryRing instance for pipeline statistics queries.
+         *
+         *  @param in_pipeline_statistics Pipeline statistics to query. Must not be 0.
+         *
+         *  For other arguments, please see create_non_ps_query_ring().
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static QueryRingUniquePtr create_ps_query_ring(Anvil::BaseDevice*                 in_device_ptr,
+                                                       Anvil::Queue*                      in_queue_ptr,
+                                                       Anvil::QueryPipelineStatisticFlags in_pipeline_statistics,
+                                                       uint32_t                           in_n_queries_per_frame,
+                                                       uint32_t                           in_n_frame_slots);
+
+        /** Destructor.
+         *
+         *  Results which have not been delivered yet are discarded. The query pool and the readback buffer must no
+         *  longer be in use by the GPU at the time of the call.
+         **/
+        ~QueryRing();
+
+        /** Allocates @param in_n_queries consecutive queries from the current frame slot.
+         *
+         *  Must only be called between begin_frame() and end_frame() calls.
+         *
+         *  @param in_n_queries              Number of queries to allocate. Must not be 0.
+         *  @param in_callback_function      Function to call with the results, once they become available. May be
+         *                                   empty, in which case the results are discarded.
+         *  @param out_first_query_index_ptr Deref will be set to the index of the first allocated query in
+         *                                   get_query_pool(). Must not be nullptr.
+         *
+         *  @return true if successful, false if the frame slot has run out of queries.
+         **/
+        bool allocate(uint32_t                  in_n_queries,
+                      QueryRingCallbackFunction in_callback_function,
+                      Anvil::QueryIndex*        out_first_query_index_ptr);
+
+        /** Moves on to the next frame slot and records a reset of all its queries into @param in_cmd_buffer_ptr.
+         *
+         *  If results of the frame which last used the slot have not been delivered yet, blocks until the GPU
+         *  finishes executing it, and delivers them.
+         *
+         *  @param in_cmd_buffer_ptr Command buffer to record the reset into. Must be in the recording state. Must
+         *                           not be nullptr.
+         *  @param in_timeout        Timeout for the wait, expressed in nanoseconds.
+         *
+         *  @return true if successful, false if the timeout expired or the reset could not be recorded. In the
+         *          former case, the frame is not started.
+         **/
+        bool begin_frame(Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                         uint64_t                  in_timeout = UINT64_MAX);
+
+        /** Closes the frame started with a preceding begin_frame() call, and records a copy of the results of all
+         *  queries allocated in the frame into @param in_cmd_buffer_ptr. Records nothing if no queries have been
+         *  allocated.
+         *
+         *  @param in_cmd_buffer_ptr Command buffer to record the copy into. Must be in the recording state. Must not be
+         *                           nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool end_frame(Anvil::CommandBufferBase* in_cmd_buffer_ptr);
+
+        /** Returns the number of frame slots. */
+        uint32_t get_n_frame_slots() const
+        {
+            return static_cast<uint32_t>(m_frame_slots.size() );
+        }
+
+        /** Returns the maximum number of queries which can be allocated in a single frame. */
+        uint32_t get_n_queries_per_frame() const
+        {
+            return m_n_queries_per_frame;
+        }
+
+        /** Returns the number of values returned per query. */
+        uint32_t get_n_values_per_query() const
+        {
+            return m_n_values_per_query;
+        }
+
+        /** Returns the query pool, which all queries are allocated from. */
+        Anvil::QueryPool* get_query_pool() const
+        {
+            return m_query_pool_ptr.get();
+        }
+
+        /** Delivers results of all frames, which the GPU has finished executing. Never blocks.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool harvest();
+
+    private:
+        /* Private type definitions */
+        typedef struct Allocation
+        {
+            QueryRingCallbackFunction callback_function;
+            uint32_t                  n_first_query; /* relative to the start of the frame slot */
+            uint32_t                  n_queries;
+        } Allocation;
+
+        enum class FrameSlotState
+        {
+            /* No results are pending */
+            IDLE,
+
+            /* Commands of the frame are being recorded */
+            RECORDING,
+
+            /* Commands of the frame have been recorded, but the slot has not been tagged yet */
+            RECORDED,
+
+            /* The slot has been tagged with a submission tracking value */
+            SUBMITTED
+        };
+
+        typedef struct FrameSlot
+        {
+            std::vector<Allocation> allocations;
+            uint32_t                n_allocated_queries;
+            FrameSlotState          state;
+            uint64_t                submission_tracking_value;
+
+            FrameSlot()
+                :n_allocated_queries      (0),
+                 state                    (FrameSlotState::IDLE),
+                 submission_tracking_value(0)
+            {
+                /* Stub */
+            }
+        } FrameSlot;
+
+        /* Private functions */
+        QueryRing(Anvil::BaseDevice* in_device_ptr,
+                  Anvil::Queue*      in_queue_ptr,
+                  uint32_t           in_n_queries_per_frame,
+                  uint32_t           in_n_frame_slots,
+                  uint32_t           in_n_values_per_query);
+
+        void deliver_frame_slot_results(uint32_t                   in_n_frame_slot);
+        bool init                      (Anvil::QueryPoolUniquePtr  in_query_pool_ptr);
+        void tag_recorded_frame_slots  ();
+
+        /* Private variables */
+        Anvil::BufferUniquePtr    m_buffer_ptr;
+        Anvil::BaseDevice*        m_device_ptr;
+        std::vector<FrameSlot>    m_frame_slots;
+        bool                      m_is_frame_active;
+        const char*               m_mapped_data_ptr;
+        uint32_t                  m_n_current_frame_slot;
+        const uint32_t            m_n_queries_per_frame;
+        const uint32_t            m_n_values_per_query;
+        Anvil::QueryPoolUniquePtr m_query_pool_ptr;
+        Anvil::Queue*             m_queue_ptr;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(QueryRing);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(QueryRing);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_QUERY_RING_H */
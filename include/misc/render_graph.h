@@ -0,0 +1,544 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a render graph, which derives pass scheduling, synchronization and transient resource allocation
+ *  from declared resource accesses.
+ *
+ *  Apps describe a frame as a sequence of passes. Each pass:
+ *
+ *  - is assigned to the graphics or the async compute queue.
+ *  - declares which resources it accesses, and how (eg. as a color attachment, as a sampled image or as a
+ *    storage buffer). At most one access can be declared per resource per pass.
+ *  - provides a function, which records the pass' commands.
+ *
+ *  Resources are either transient, in which case they are created, and assigned memory, by the graph, or imported,
+ *  in which case they are owned by the app and persist across executions (eg. swapchain images).
+ *
+ *  At bake() time, the graph:
+ *
+ *  1. culls passes whose results are never consumed. A pass is kept if it has been marked as having side effects,
+ *     or if it writes contents which are either read by a kept pass, or left in an imported resource at the end of
+ *     the execution. Writes are assumed to overwrite the previous contents of a resource, unless the access also
+ *     reads (eg. STORAGE_READ_WRITE).
+ *  2. splits the remaining passes, in declaration order, into batches of consecutive passes which use the same
+ *     queue. Each batch is recorded into a single command buffer and submitted with a single vkQueueSubmit() call.
+ *     Batches which depend on batches executed on the other queue wait on a semaphore, at most once per queue.
+ *  3. tracks the state of each resource across passes, and computes the minimal set of pipeline barriers, ie.
+ *     barriers are only inserted for layout transitions, read-after-write, write-after-read and write-after-write
+ *     hazards. All barriers which need to be executed before a pass are merged into a single vkCmdPipelineBarrier()
+ *     call.
+ *  4. creates transient resources, with usage flags inferred from the declared accesses, and binds them to shared
+ *     memory heaps. Resources whose lifetimes do not overlap are aliased, ie. they are placed in the same memory
+ *     region. Hazards between aliased resources are synchronized just like any other hazard.
+ *
+ *  execute() then records all batches, invoking the pass record functions in order, and submits them.
+ *
+ *  Up to N executions can be in flight at the same time, where N is specified at creation time. Each execution
+ *  uses its own set of command buffers and semaphores. execute() only blocks if the GPU is still executing the
+ *  execution made N calls earlier, whose set it is about to reuse. Transient resources are shared by all
+ *  executions, so if N is larger than 1, executions are ordered against each other on the GPU: first accesses to
+ *  transient resources synchronize against all prior work, and if the first and the last batch use different
+ *  queues, the first batch waits for the last batch of the preceding execution. Pass the number of frames in
+ *  flight used by FrameScheduler as N, so that the graph never stalls the frame loop.
+ *
+ *  Images used as attachments are transitioned to the attachment layout before the pass executes. Render passes
+ *  used by passes should thus use the layouts returned by get_image_layout() as both initial and final layouts.
+ *
+ *  If async compute is used, transient resources are created with concurrent sharing mode. Imported resources
+ *  accessed from both queues must have been created with concurrent sharing mode, too.
+ *
+ *  This class is NOT thread-safe.
+ */
+#ifndef MISC_RENDER_GRAPH_H
+#define MISC_RENDER_GRAPH_H
+
+#include "misc/types.h"
+
+
+namespace Anvil
+{
+    typedef uint32_t RenderGraphPassID;
+    typedef uint32_t RenderGraphResourceID;
+
+    /* Determines pipeline stages, access masks and, for images, the layout a resource is accessed with. Stages of
+     * shader accesses depend on the pass' queue: vertex, fragment & compute shader stages are used for graphics
+     * passes, and the compute shader stage alone for async compute passes.
+     *
+     * Depth/stencil images accessed with INPUT_ATTACHMENT_READ or SAMPLED_READ use the read-only depth/stencil
+     * layout. */
+    enum class RenderGraphAccess
+    {
+        /* Images only. Not available to async compute passes. */
+        COLOR_ATTACHMENT_READ_WRITE,
+        COLOR_ATTACHMENT_WRITE,
+        DEPTH_STENCIL_ATTACHMENT_READ,
+        DEPTH_STENCIL_ATTACHMENT_READ_WRITE,
+        DEPTH_STENCIL_ATTACHMENT_WRITE,
+        INPUT_ATTACHMENT_READ,
+
+        /* Images only */
+        SAMPLED_READ,
+
+        /* Buffers only. Not available to async compute passes, except for UNIFORM_READ & INDIRECT_READ. */
+        INDEX_READ,
+        INDIRECT_READ,
+        UNIFORM_READ,
+        VERTEX_READ,
+
+        /* Images & buffers */
+        STORAGE_READ,
+        STORAGE_READ_WRITE,
+        STORAGE_WRITE,
+        TRANSFER_READ,
+        TRANSFER_WRITE,
+
+        UNKNOWN
+    };
+
+    enum class RenderGraphQueue
+    {
+        /* Executed on the first compute queue. Falls back to the graphics queue if the device exposes no compute
+         * queues, or if async compute has been disabled at creation time. */
+        ASYNC_COMPUTE,
+
+        /* Executed on the first universal queue. */
+        GRAPHICS,
+
+        COUNT
+    };
+
+    /* Records commands of a single pass. Barriers required by the pass have already been recorded into the command
+     * buffer by the time the function is called. */
+    typedef std::function<void(Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr)> RenderGraphRecordFunction;
+
+    class RenderGraph
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new RenderGraph instance.
+         *
+         *  @param in_device_ptr              Device to use. Must not be nullptr. Must be a single-GPU device.
+         *  @param in_enable_async_compute    True if ASYNC_COMPUTE passes should be executed on a compute queue,
+         *                                    false if they should be executed on the graphics queue.
+         *  @param in_enable_aliasing         True if transient resources with disjoint lifetimes should share memory,
+         *                                    false if each transient resource should be assigned memory of its own.
+         *  @param in_n_executions_in_flight  Number of executions which can be in flight at the same time. Must not
+         *                                    be 0.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static RenderGraphUniquePtr create(Anvil::BaseDevice* in_device_ptr,
+                                           bool               in_enable_async_compute   = true,
+                                           bool               in_enable_aliasing        = true,
+                                           uint32_t           in_n_executions_in_flight = 2);
+
+        /** Destructor.
+         *
+         *  Blocks until the GPU finishes executing all submissions made by execute().
+         **/
+        ~RenderGraph();
+
+        /** Adds a new pass. Passes are executed in the order they are added in.
+         *
+         *  Must not be called after bake().
+         *
+         *  @param in_name              Name of the pass. Used for debugging purposes only.
+         *  @param in_queue             Queue the pass should be executed on.
+         *  @param in_record_function   Function recording the pass' commands. Must not be empty.
+         *  @param in_has_side_effects  True if the pass must never be culled, eg. because it writes to resources
+         *                              not tracked by the graph.
+         *
+         *  @return ID of the new pass.
+         **/
+        RenderGraphPassID add_pass(const std::string&        in_name,
+                                   RenderGraphQueue          in_queue,
+                                   RenderGraphRecordFunction in_record_function,
+                                   bool                      in_has_side_effects = false);
+
+        /** Declares an access of @param in_pass_id to resource @param in_resource_id.
+         *
+         *  Must not be called after bake().
+         *
+         *  @param in_pass_id     ID of the pass, as returned by add_pass().
+         *  @param in_resource_id ID of the resource, as returned by add_transient_*() or import_*().
+         *  @param in_access      Access type. Must be applicable to the resource type and to the pass' queue.
+         **/
+        void add_resource_access(RenderGraphPassID     in_pass_id,
+                                 RenderGraphResourceID in_resource_id,
+                                 RenderGraphAccess     in_access);
+
+        /** Declares a transient buffer. Usage flags are inferred from the accesses declared for the buffer.
+         *
+         *  Must not be called after bake().
+         *
+         *  @param in_size Size of the buffer, in bytes. Must not be 0.
+         *
+         *  @return ID of the new resource.
+         **/
+        RenderGraphResourceID add_transient_buffer(VkDeviceSize in_size);
+
+        /** Declares a transient image. Usage flags are inferred from the accesses declared for the image. Contents
+         *  of transient images are undefined at the beginning of each execution.
+         *
+         *  Must not be called after bake().
+         *
+         *  @param in_type                 Image type.
+         *  @param in_format               Image format.
+         *  @param in_width                Width of the base mip.
+         *  @param in_height               Height of the base mip.
+         *  @param in_depth                Depth of the base mip.
+         *  @param in_n_layers             Number of array layers.
+         *  @param in_sample_count         Number of samples.
+         *  @param in_use_full_mipmap_chain True if the image should hold a full mip chain, false if it should only
+         *                                 hold the base mip.
+         *
+         *  @return ID of the new resource.
+         **/
+        RenderGraphResourceID add_transient_image(Anvil::ImageType           in_type,
+                                                  Anvil::Format              in_format,
+                                                  uint32_t                   in_width,
+                                                  uint32_t                   in_height,
+                                                  uint32_t                   in_depth                 = 1,
+                                                  uint32_t                   in_n_layers              = 1,
+                                                  Anvil::SampleCountFlagBits in_sample_count          = Anvil::SampleCountFlagBits::_1_BIT,
+                                                  bool                       in_use_full_mipmap_chain = false);
+
+        /** Bakes the graph. Culls unused passes, splits the remaining ones into batches, computes barriers &
+         *  semaphores, and creates transient resources.
+         *
+         *  Once baked, passes and resources can no longer be added, but imported resources can be replaced with
+         *  set_imported_buffer() and set_imported_image().
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool bake();
+
+        /** Records and submits all batches.
+         *
+         *  Wait semaphores are waited on by the first batch. Batches executed on the other queue are ordered after
+         *  the first batch before they access any imported resource. Signal semaphores and the fence are signalled
+         *  by the last batch, which waits for all batches executed on the other queue.
+         *
+         *  Command buffers and semaphores are reused every N executions, where N is the number of executions in
+         *  flight specified at creation time. If batches submitted by the execution made N calls earlier are still
+         *  executing, the call blocks until they complete.
+         *
+         *  Must only be called after bake().
+         *
+         *  @param in_n_wait_semaphores         Number of semaphores the first batch should wait on.
+         *  @param in_opt_wait_semaphore_ptrs   Semaphores the first batch should wait on. Must hold
+         *                                      @param in_n_wait_semaphores items.
+         *  @param in_opt_wait_stage_masks_ptr  Stages at which the waits should occur. Must hold
+         *                                      @param in_n_wait_semaphores items.
+         *  @param in_n_signal_semaphores       Number of semaphores to signal once the last batch completes.
+         *  @param in_opt_signal_semaphore_ptrs Semaphores to signal. Must hold @param in_n_signal_semaphores items.
+         *  @param in_opt_fence_ptr             Fence to signal once the last batch completes. May be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool execute(uint32_t                         in_n_wait_semaphores         = 0,
+                     Anvil::Semaphore* const*         in_opt_wait_semaphore_ptrs   = nullptr,
+                     const Anvil::PipelineStageFlags* in_opt_wait_stage_masks_ptr  = nullptr,
+                     uint32_t                         in_n_signal_semaphores       = 0,
+                     Anvil::Semaphore* const*         in_opt_signal_semaphore_ptrs = nullptr,
+                     Anvil::Fence*                    in_opt_fence_ptr             = nullptr);
+
+        /** Returns the buffer backing resource @param in_resource_id, or nullptr if the resource is a transient
+         *  buffer which has been culled. Transient buffers are only available after bake().
+         **/
+        Anvil::Buffer* get_buffer(RenderGraphResourceID in_resource_id) const;
+
+        /** Returns the image backing resource @param in_resource_id, or nullptr if the resource is a transient
+         *  image which has been culled. Transient images are only available after bake().
+         **/
+        Anvil::Image* get_image(RenderGraphResourceID in_resource_id) const;
+
+        /** Returns the layout image @param in_resource_id is in while pass @param in_pass_id executes, or
+         *  ImageLayout::UNKNOWN if the pass does not access the image. Must only be called after bake().
+         **/
+        Anvil::ImageLayout get_image_layout(RenderGraphPassID     in_pass_id,
+                                            RenderGraphResourceID in_resource_id) const;
+
+        /** Returns the number of batches, ie. vkQueueSubmit() calls made by a single execute() call. */
+        uint32_t get_n_batches() const
+        {
+            return static_cast<uint32_t>(m_batches.size() );
+        }
+
+        /** Returns the number of passes culled at bake() time. */
+        uint32_t get_n_culled_passes() const
+        {
+            return m_n_culled_passes;
+        }
+
+        /** Returns the number of vkCmdPipelineBarrier() calls recorded by a single execute() call. */
+        uint32_t get_n_pipeline_barriers() const
+        {
+            return m_n_pipeline_barriers;
+        }
+
+        /** Returns the number of semaphores used by a single execution to synchronize batches executed on
+         *  different queues.
+         **/
+        uint32_t get_n_semaphores() const
+        {
+            return static_cast<uint32_t>(m_semaphores.size() / m_execution_contexts.size() );
+        }
+
+        /** Returns the total size of memory assigned to transient resources. */
+        VkDeviceSize get_transient_memory_size() const
+        {
+            return m_transient_memory_size;
+        }
+
+        /** Returns the total size of memory transient resources would have been assigned, had they not been
+         *  aliased.
+         **/
+        VkDeviceSize get_transient_memory_size_without_aliasing() const
+        {
+            return m_transient_memory_size_without_aliasing;
+        }
+
+        /** Declares an imported buffer. The app retains ownership of the buffer.
+         *
+         *  Must not be called after bake().
+         *
+         *  @param in_buffer_ptr Buffer to use. Must not be nullptr.
+         *
+         *  @return ID of the new resource.
+         **/
+        RenderGraphResourceID import_buffer(Anvil::Buffer* in_buffer_ptr);
+
+        /** Declares an imported image. The app retains ownership of the image.
+         *
+         *  Must not be called after bake().
+         *
+         *  @param in_image_ptr     Image to use. Must not be nullptr.
+         *  @param in_initial_layout Layout the image is in at the time execute() is called. May be UNDEFINED, in
+         *                           which case the contents are discarded.
+         *  @param in_final_layout   Layout the image should be transitioned to once the last pass accessing it
+         *                           completes, eg. PRESENT_SRC_KHR for swapchain images. If UNKNOWN, the image is
+         *                           left in the layout of the last access.
+         *
+         *  @return ID of the new resource.
+         **/
+        RenderGraphResourceID import_image(Anvil::Image*      in_image_ptr,
+                                           Anvil::ImageLayout in_initial_layout,
+                                           Anvil::ImageLayout in_final_layout = Anvil::ImageLayout::UNKNOWN);
+
+        /** Replaces the buffer backing imported resource @param in_resource_id, eg. with a per-frame copy. */
+        void set_imported_buffer(RenderGraphResourceID in_resource_id,
+                                 Anvil::Buffer*        in_buffer_ptr);
+
+        /** Replaces the image backing imported resource @param in_resource_id, eg. with the swapchain image acquired
+         *  for the frame. The new image must use the same format, and hold the same number of mips & layers.
+         **/
+        void set_imported_image(RenderGraphResourceID in_resource_id,
+                                Anvil::Image*         in_image_ptr);
+
+    private:
+        /* Private type definitions */
+        typedef struct AccessProperties
+        {
+            Anvil::AccessFlags        access_mask;
+            Anvil::BufferUsageFlags   buffer_usage;
+            Anvil::ImageUsageFlags    image_usage;
+            bool                      is_read;
+            bool                      is_write;
+            Anvil::ImageLayout        layout;
+            Anvil::PipelineStageFlags stage_mask;
+        } AccessProperties;
+
+        /* Describes a single buffer or image barrier. Resolved at execute() time, so that imported resources can be
+         * replaced after the graph has been baked. */
+        typedef struct BarrierInfo
+        {
+            Anvil::AccessFlags    dst_access_mask;
+            Anvil::ImageLayout    new_layout;
+            Anvil::ImageLayout    old_layout;
+            RenderGraphResourceID resource_id;
+            Anvil::AccessFlags    src_access_mask;
+        } BarrierInfo;
+
+        /* Barriers recorded with a single vkCmdPipelineBarrier() call. Not recorded at all if dst_stage_mask is 0. */
+        typedef struct BarrierBatch
+        {
+            std::vector<BarrierInfo>  barriers;
+            Anvil::PipelineStageFlags dst_stage_mask;
+            Anvil::PipelineStageFlags src_stage_mask;
+        } BarrierBatch;
+
+        typedef struct Batch
+        {
+            std::vector<RenderGraphPassID>         pass_ids;
+            BarrierBatch                           post_barriers;
+            RenderGraphQueue                       queue;
+            uint32_t                               wait_producer_batches[static_cast<uint32_t>(RenderGraphQueue::COUNT)];
+            Anvil::PipelineStageFlags              wait_producer_stage_masks[static_cast<uint32_t>(RenderGraphQueue::COUNT)];
+            std::vector<Anvil::PipelineStageFlags> wait_stage_masks; /* one per semaphore waited on, in creation order */
+
+            Batch();
+        } Batch;
+
+        /* Objects used by a single in-flight execution. Per-batch vectors are indexed by batch index. */
+        typedef struct ExecutionContext
+        {
+            std::vector<Anvil::PrimaryCommandBufferUniquePtr> command_buffer_ptrs;
+            Anvil::CommandPool*                               command_pool_ptrs[static_cast<uint32_t>(RenderGraphQueue::COUNT)];
+            std::vector<Anvil::CommandPoolUniquePtr>          command_pools;
+            Anvil::SemaphoreUniquePtr                         execution_semaphore_ptr; /* signalled by the last batch. May be nullptr */
+            std::vector<std::vector<Anvil::Semaphore*> >      signal_semaphore_ptrs;
+            uint64_t                                          submission_tracking_values[static_cast<uint32_t>(RenderGraphQueue::COUNT)];
+            std::vector<std::vector<Anvil::Semaphore*> >      wait_semaphore_ptrs;
+
+            ExecutionContext();
+        } ExecutionContext;
+
+        typedef struct PassAccess
+        {
+            RenderGraphAccess     access;
+            Anvil::ImageLayout    layout;
+            RenderGraphResourceID resource_id;
+        } PassAccess;
+
+        typedef struct Pass
+        {
+            std::vector<PassAccess>   accesses;
+            bool                      has_side_effects;
+            bool                      is_live;
+            uint32_t                  n_batch;
+            std::string               name;
+            BarrierBatch              pre_barriers;
+            RenderGraphQueue          queue;
+            RenderGraphRecordFunction record_function;
+        } Pass;
+
+        enum class ResourceType
+        {
+            BUFFER,
+            IMAGE
+        };
+
+        typedef struct Resource
+        {
+            /* Common */
+            std::vector<RenderGraphResourceID> alias_predecessor_ids; /* transient resources placed in overlapping memory, used earlier */
+            RenderGraphPassID                  first_live_pass;       /* UINT32_MAX if not accessed by any live pass */
+            bool                               is_imported;
+            RenderGraphPassID                  last_live_pass;
+            VkDeviceSize                       memory_alignment;
+            uint32_t                           memory_heap_index;
+            VkDeviceSize                       memory_offset;
+            VkDeviceSize                       memory_size;
+            uint32_t                           memory_type_bits;
+            ResourceType                       type;
+
+            /* Buffers */
+            Anvil::Buffer*                     buffer_ptr;
+            Anvil::BufferUsageFlags            buffer_usage;
+            Anvil::BufferUniquePtr             owned_buffer_ptr;
+            VkDeviceSize                       size;
+
+            /* Images */
+            VkExtent3D                         extent;
+            Anvil::ImageLayout                 final_layout;
+            Anvil::Format                      format;
+            Anvil::Image*                      image_ptr;
+            Anvil::ImageType                   image_type;
+            Anvil::ImageUsageFlags             image_usage;
+            Anvil::ImageLayout                 initial_layout;
+            uint32_t                           n_layers;
+            Anvil::ImageUniquePtr              owned_image_ptr;
+            Anvil::SampleCountFlagBits         sample_count;
+            bool                               use_full_mipmap_chain;
+
+            Resource();
+        } Resource;
+
+        /* Tracks synchronization state of a resource while barriers are computed. Accesses are tracked since, and
+         * including, the last write. Layout transitions are treated as writes. */
+        typedef struct ResourceState
+        {
+            bool                      has_been_accessed;
+            uint32_t                  last_access_batches    [static_cast<uint32_t>(RenderGraphQueue::COUNT)]; /* UINT32_MAX if none */
+            Anvil::PipelineStageFlags last_access_stage_masks[static_cast<uint32_t>(RenderGraphQueue::COUNT)];
+            Anvil::AccessFlags        last_write_access_mask;
+            RenderGraphQueue          last_write_queue;
+            Anvil::PipelineStageFlags last_write_stage_mask;
+            Anvil::ImageLayout        layout;
+            Anvil::AccessFlags        visible_access_mask; /* same-queue accesses the last write has been made visible to */
+            Anvil::PipelineStageFlags visible_stage_mask;
+
+            ResourceState();
+        } ResourceState;
+
+        /* Private functions */
+        RenderGraph(Anvil::BaseDevice* in_device_ptr,
+                    bool               in_enable_async_compute,
+                    bool               in_enable_aliasing,
+                    uint32_t           in_n_executions_in_flight);
+
+        void                         add_batch_dependency      (uint32_t                     in_producer_n_batch,
+                                                                uint32_t                     in_consumer_n_batch,
+                                                                Anvil::PipelineStageFlags    in_wait_stage_mask);
+        void                         compute_barriers          ();
+        bool                         create_semaphores         ();
+        bool                         create_transient_resources();
+        void                         cull_passes               ();
+        void                         form_batches              ();
+        AccessProperties             get_access_properties     (RenderGraphAccess            in_access,
+                                                                RenderGraphQueue             in_queue) const;
+        RenderGraphQueue             get_effective_queue       (RenderGraphQueue             in_queue) const;
+        Anvil::ImageSubresourceRange get_subresource_range     (const Resource&              in_resource) const;
+        bool                         record_barrier_batch      (const BarrierBatch&          in_barrier_batch,
+                                                                Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr);
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(RenderGraph);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(RenderGraph);
+
+        /* Private variables */
+        std::vector<Batch>                       m_batches;
+        std::vector<Anvil::BufferBarrier>        m_buffer_barriers_scratch;
+        Anvil::BaseDevice*                       m_device_ptr;
+        bool                                     m_enable_aliasing;
+        std::vector<ExecutionContext>            m_execution_contexts;
+        std::vector<Anvil::ImageBarrier>         m_image_barriers_scratch;
+        bool                                     m_is_baked;
+        std::vector<Anvil::MemoryBlockUniquePtr> m_memory_heaps;
+        uint32_t                                 m_n_culled_passes;
+        uint32_t                                 m_n_next_execution_context;
+        uint32_t                                 m_n_pipeline_barriers;
+        uint32_t                                 m_n_previous_execution_context; /* UINT32_MAX if there is nothing to wait for */
+        std::vector<Pass>                        m_passes;
+        Anvil::Queue*                            m_queue_ptrs[static_cast<uint32_t>(RenderGraphQueue::COUNT)];
+        std::vector<Resource>                    m_resources;
+        std::vector<Anvil::SemaphoreUniquePtr>   m_semaphores;
+        std::vector<Anvil::Semaphore*>           m_signal_semaphores_scratch;
+        VkDeviceSize                             m_transient_memory_size;
+        VkDeviceSize                             m_transient_memory_size_without_aliasing;
+        std::vector<Anvil::Semaphore*>           m_wait_semaphores_scratch;
+        std::vector<Anvil::PipelineStageFlags>   m_wait_stage_masks_scratch;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_RENDER_GRAPH_H */
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a device-level queue of resources, whose release has been requested by the application, but which may still
+ *  be in use by the GPU.
+ *
+ *  Each release is tagged with the latest submission made to each of the device's queues at the time of the request.
+ *  Resources are destroyed in bulk by retire(), once all the submissions they have been tagged with finish executing.
+ *  This removes the need to call BaseDevice::wait_idle() before releasing resources which may have been used by
+ *  in-flight command buffers.
+ *
+ *  Releases requested one after another, with no submissions made in-between, share the same batch. Tagging reads
+ *  each queue's submission tracking value (see Queue::get_submission_tracking_value()). The first release() call
+ *  enables submission tracking for all device queues, which costs a single signal operation per queue. Later calls
+ *  never submit any work to the queues.
+ *
+ *  The release queue is owned by the device. Any resources still queued at device destruction time are destroyed
+ *  after the device goes idle.
+ *
+ *  This class is thread-safe.
+ */
+#ifndef MISC_RESOURCE_RELEASE_QUEUE_H
+#define MISC_RESOURCE_RELEASE_QUEUE_H
+
+#include "misc/types.h"
+#include <deque>
+
+
+namespace Anvil
+{
+    class ResourceReleaseQueue
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new ResourceReleaseQueue instance.
+         *
+         *  NOTE: This function must only be used by Anvil::BaseDevice! Apps should use BaseDevice::get_resource_release_queue()
+         *        instead.
+         *
+         *  @param in_device_ptr Device to use. Must not be nullptr.
+         *  @param in_queue_ptrs All queues exposed by @param in_device_ptr.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static ResourceReleaseQueueUniquePtr create(const Anvil::BaseDevice*          in_device_ptr,
+                                                    const std::vector<Anvil::Queue*>& in_queue_ptrs);
+
+        /** Destructor.
+         *
+         *  Destroys all resources which are still queued for release. The parent device must be idle at the time of the call.
+         **/
+        ~ResourceReleaseQueue();
+
+        /** Returns the number of resources which have been queued for release, but are yet to be destroyed. */
+        uint32_t get_n_pending_releases() const;
+
+        /** Queues the specified object for release. The object will be destroyed by a retire() call, after all work
+         *  submitted to any of the device queues prior to this call finishes executing.
+         *
+         *  @param in_buffer_ptr Object to release. Null objects are ignored.
+         **/
+        void release(Anvil::BufferUniquePtr in_buffer_ptr);
+
+        /** See release(Anvil::BufferUniquePtr) for specification. */
+        void release(Anvil::DescriptorSetGroupUniquePtr in_dsg_ptr);
+
+        /** See release(Anvil::BufferUniquePtr) for specification. */
+        void release(Anvil::ImageUniquePtr in_image_ptr);
+
+        /** See release(Anvil::BufferUniquePtr) for specification. */
+        void release(Anvil::MemoryBlockUniquePtr in_memory_block_ptr);
+
+        /** Destroys all queued objects which are no longer in use by the GPU.
+         *
+         *  Within a single batch, descriptor set groups are destroyed first, followed by buffers, images and,
+         *  finally, memory blocks.
+         *
+         *  @param in_should_block true to wait until all objects queued so far can be destroyed, false to only destroy
+         *                         objects which are already safe to release.
+         *
+         *  @return Number of objects destroyed.
+         **/
+        uint32_t retire(bool in_should_block = false);
+
+    private:
+        /* Private type definitions */
+        typedef struct Batch
+        {
+            std::vector<Anvil::BufferUniquePtr>             buffer_ptrs;
+            std::vector<Anvil::DescriptorSetGroupUniquePtr> dsg_ptrs;
+            std::vector<Anvil::ImageUniquePtr>              image_ptrs;
+            std::vector<Anvil::MemoryBlockUniquePtr>        memory_block_ptrs;
+
+            /* One item per queue. */
+            std::vector<uint64_t> submission_tracking_values;
+
+            uint32_t get_n_objects() const
+            {
+                return static_cast<uint32_t>(buffer_ptrs.size      () +
+                                             dsg_ptrs.size         () +
+                                             image_ptrs.size       () +
+                                             memory_block_ptrs.size() );
+            }
+        } Batch;
+
+        /* Private functions */
+        explicit ResourceReleaseQueue(const std::vector<Anvil::Queue*>& in_queue_ptrs);
+
+        static void destroy_batch  (std::unique_ptr<Batch> in_batch_ptr);
+        Batch*      get_open_batch ();
+
+        /* Private variables */
+        std::deque<std::unique_ptr<Batch> > m_batches;
+        mutable std::mutex                  m_mutex;
+        uint32_t                            m_n_pending_releases;
+        std::vector<Anvil::Queue*>          m_queue_ptrs;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(ResourceReleaseQueue);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(ResourceReleaseQueue);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_RESOURCE_RELEASE_QUEUE_H */
@@ -0,0 +1,245 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a streaming manager for sparse residency images.
+ *
+ *  Apps request individual tiles of a sparse residency image with request_tile(), usually as a result of
+ *  feedback (eg. a residency miss readback) gathered for the previous frame. Each frame, apps then call flush(),
+ *  which:
+ *
+ *  1. picks memory for all tiles requested since the last flush() call, which are not resident yet. Memory is
+ *     sub-allocated from a pool of large heap memory blocks, each of which holds a fixed number of tiles,
+ *     so that no device memory allocation is needed per tile.
+ *  2. if the residency budget has been exhausted, evicts tiles which were least recently requested. Tiles
+ *     requested in the current frame are never evicted. Requests which cannot be satisfied stay pending until
+ *     a later flush() call.
+ *  3. submits all unbinds & binds in one vkQueueBindSparse() call.
+ *
+ *  The manager only handles tiles outside the mip tail. The mip tail must be bound by the app, for instance
+ *  with MemoryAllocator::add_sparse_image_miptail().
+ *
+ *  Evicted tiles have their memory re-used straight away. It is the app's responsibility to ensure the GPU no
+ *  longer accesses tiles at the time they are evicted, eg. by passing a semaphore signalled by the last
+ *  submission which used the image to flush().
+ *
+ *  This class is NOT thread-safe.
+ */
+#ifndef MISC_SPARSE_RESIDENCY_MANAGER_H
+#define MISC_SPARSE_RESIDENCY_MANAGER_H
+
+#include "misc/types.h"
+#include <list>
+#include <map>
+#include <set>
+
+
+namespace Anvil
+{
+    class SparseResidencyManager
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new SparseResidencyManager instance.
+         *
+         *  @param in_image_ptr                 Sparse residency image to manage. Must not be nullptr. The image must
+         *                                      have been created with SPARSE_BINDING and SPARSE_RESIDENCY bits set,
+         *                                      and must outlive the manager.
+         *  @param in_n_max_resident_tiles      Maximum number of tiles which can be resident at the same time.
+         *                                      Must not be 0.
+         *  @param in_n_tiles_per_heap_block    Number of tiles each heap memory block should hold. Must not be 0.
+         *  @param in_memory_features           Memory features the heap memory blocks should support.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static SparseResidencyManagerUniquePtr create(Anvil::Image*             in_image_ptr,
+                                                      uint32_t                  in_n_max_resident_tiles,
+                                                      uint32_t                  in_n_tiles_per_heap_block = 64,
+                                                      Anvil::MemoryFeatureFlags in_memory_features        = Anvil::MemoryFeatureFlagBits::NONE);
+
+        /** Destructor.
+         *
+         *  Releases all heap memory blocks. The image must no longer be in use by the GPU at the time of the call.
+         **/
+        ~SparseResidencyManager();
+
+        /** Binds memory to all tiles requested since the last flush() call, evicting least recently requested tiles
+         *  if necessary, and closes the current frame.
+         *
+         *  All binds & unbinds are submitted in a single vkQueueBindSparse() call. If there is nothing to bind,
+         *  no call is made, and the semaphores & fence are not used.
+         *
+         *  Residency state is only updated once the bind operation has been submitted successfully. If the submission
+         *  fails, resident tiles are left intact and the requests stay pending until the next flush() call.
+         *
+         *  @param in_opt_queue_ptr             Queue to submit the bind operation to. If nullptr, the first sparse
+         *                                      binding queue of the image's device is used.
+         *  @param in_n_wait_semaphores         Number of semaphores to wait on before the bind operation starts.
+         *  @param in_opt_wait_semaphore_ptrs   Semaphores to wait on. Must hold @param in_n_wait_semaphores items.
+         *  @param in_n_signal_semaphores       Number of semaphores to signal once the bind operation completes.
+         *  @param in_opt_signal_semaphore_ptrs Semaphores to signal. Must hold @param in_n_signal_semaphores items.
+         *  @param in_opt_fence_ptr             Fence to signal once the bind operation completes. May be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool flush(Anvil::Queue*            in_opt_queue_ptr             = nullptr,
+                   uint32_t                 in_n_wait_semaphores         = 0,
+                   Anvil::Semaphore* const* in_opt_wait_semaphore_ptrs   = nullptr,
+                   uint32_t                 in_n_signal_semaphores       = 0,
+                   Anvil::Semaphore* const* in_opt_signal_semaphore_ptrs = nullptr,
+                   Anvil::Fence*            in_opt_fence_ptr             = nullptr);
+
+        /** Returns the total number of tiles evicted since the manager was created. */
+        uint64_t get_n_evictions() const
+        {
+            return m_n_evictions;
+        }
+
+        /** Returns the number of tiles requested, which have not been made resident yet. */
+        uint32_t get_n_pending_tiles() const
+        {
+            return static_cast<uint32_t>(m_pending_tiles.size() );
+        }
+
+        /** Returns the number of tiles which are currently resident. */
+        uint32_t get_n_resident_tiles() const
+        {
+            return static_cast<uint32_t>(m_resident_tiles.size() );
+        }
+
+        /** Tells whether the specified tile has memory bound to it by this manager.
+         *
+         *  Tile coordinates are expressed in units of the aspect's sparse image granularity.
+         **/
+        bool is_tile_resident(Anvil::ImageAspectFlagBits in_aspect,
+                              uint32_t                   in_n_layer,
+                              uint32_t                   in_n_mip,
+                              uint32_t                   in_tile_x,
+                              uint32_t                   in_tile_y,
+                              uint32_t                   in_tile_z) const;
+
+        /** Requests the specified tile to be made resident during the next flush() call. If the tile is already
+         *  resident, it is marked as recently used, so that it is not evicted in favor of other tiles.
+         *
+         *  Requesting the same tile more than once per frame has no further effect.
+         *
+         *  @param in_aspect  Aspect of the tile. The image must hold the aspect.
+         *  @param in_n_layer Array layer of the tile.
+         *  @param in_n_mip   Mip level of the tile. Must be smaller than the first mip tail level.
+         *  @param in_tile_x  Tile X coordinate, expressed in units of the aspect's sparse image granularity.
+         *  @param in_tile_y  Tile Y coordinate, as above.
+         *  @param in_tile_z  Tile Z coordinate, as above.
+         *
+         *  @return true if successful, false if the tile location is invalid.
+         **/
+        bool request_tile(Anvil::ImageAspectFlagBits in_aspect,
+                          uint32_t                   in_n_layer,
+                          uint32_t                   in_n_mip,
+                          uint32_t                   in_tile_x,
+                          uint32_t                   in_tile_y,
+                          uint32_t                   in_tile_z);
+
+    private:
+        /* Private type definitions */
+        typedef struct TileLocation
+        {
+            Anvil::ImageAspectFlagBits aspect;
+            uint32_t                   n_layer;
+            uint32_t                   n_mip;
+            uint32_t                   tile_x;
+            uint32_t                   tile_y;
+            uint32_t                   tile_z;
+
+            TileLocation(Anvil::ImageAspectFlagBits in_aspect,
+                         uint32_t                   in_n_layer,
+                         uint32_t                   in_n_mip,
+                         uint32_t                   in_tile_x,
+                         uint32_t                   in_tile_y,
+                         uint32_t                   in_tile_z)
+                :aspect (in_aspect),
+                 n_layer(in_n_layer),
+                 n_mip  (in_n_mip),
+                 tile_x (in_tile_x),
+                 tile_y (in_tile_y),
+                 tile_z (in_tile_z)
+            {
+                /* Stub */
+            }
+
+            bool operator<(const TileLocation& in_location) const
+            {
+                if (aspect  != in_location.aspect)  return static_cast<uint32_t>(aspect) < static_cast<uint32_t>(in_location.aspect);
+                if (n_layer != in_location.n_layer) return n_layer < in_location.n_layer;
+                if (n_mip   != in_location.n_mip)   return n_mip   < in_location.n_mip;
+                if (tile_z  != in_location.tile_z)  return tile_z  < in_location.tile_z;
+                if (tile_y  != in_location.tile_y)  return tile_y  < in_location.tile_y;
+
+                return tile_x < in_location.tile_x;
+            }
+        } TileLocation;
+
+        typedef std::list<TileLocation> LRUList;
+
+        typedef struct ResidentTile
+        {
+            uint64_t          last_request_frame;
+            LRUList::iterator lru_iterator;
+            uint32_t          n_slot;
+        } ResidentTile;
+
+        /* Private functions */
+        SparseResidencyManager(Anvil::Image*             in_image_ptr,
+                               uint32_t                  in_n_max_resident_tiles,
+                               uint32_t                  in_n_tiles_per_heap_block,
+                               Anvil::MemoryFeatureFlags in_memory_features);
+
+        bool acquire_slot      (uint32_t*                             out_n_slot_ptr);
+        void append_tile_update(Anvil::SparseMemoryBindingUpdateInfo* in_update_ptr,
+                                SparseMemoryBindInfoID                in_bind_info_id,
+                                const TileLocation&                   in_location,
+                                const uint32_t*                       in_opt_n_slot_ptr);
+        void get_tile_region   (const TileLocation&                   in_location,
+                                VkOffset3D*                           out_offset_ptr,
+                                VkExtent3D*                           out_extent_ptr) const;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(SparseResidencyManager);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(SparseResidencyManager);
+
+        /* Private variables */
+        uint64_t                                 m_current_frame;
+        std::vector<uint32_t>                    m_free_slots;
+        std::vector<Anvil::MemoryBlockUniquePtr> m_heap_memory_blocks;
+        Anvil::Image*                            m_image_ptr;
+        LRUList                                  m_lru_tiles;               /* least recently requested tiles come first */
+        Anvil::MemoryFeatureFlags                m_memory_features;
+        uint32_t                                 m_n_allocated_slots;
+        uint64_t                                 m_n_evictions;
+        const uint32_t                           m_n_max_resident_tiles;
+        const uint32_t                           m_n_tiles_per_heap_block;
+        std::vector<TileLocation>                m_pending_tiles;           /* in request order */
+        std::set<TileLocation>                   m_pending_tiles_set;
+        std::map<TileLocation, ResidentTile>     m_resident_tiles;
+        VkDeviceSize                             m_tile_size;
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_SPARSE_RESIDENCY_MANAGER_H */
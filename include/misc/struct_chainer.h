@@ -328,6 +328,160 @@ namespace Anvil
         std::vector<std::vector<uint8_t> > m_structs;
         uint32_t                           m_structs_size;
     };
+
+    /** Fixed-capacity counterpart of StructChainer, intended for hot paths (eg. queue submissions or command buffer
+     *  recording), which are executed many times per frame.
+     *
+     *  Appended structs are copied into storage embedded in the chainer instance, and their pNext pointers are
+     *  patched as they are appended. The chain is thus ready to be passed to Vulkan at any time via get_root_struct(),
+     *  and no heap allocations are ever made. Helper structures are not supported.
+     *
+     *  Since the chain points into the instance itself, the chainer can be neither copied nor moved.
+     *
+     *  Accessors (get_last_struct(), get_n_structs(), get_root_struct() and get_struct_at_index()) have the same
+     *  signatures as StructChainer's, so code which inspects a chain works with either chainer.
+     *
+     *  @tparam StructType Type of the root struct.
+     *  @tparam Capacity   Maximum total size of all appended structs, in bytes.
+     **/
+    template<typename StructType,
+             uint32_t Capacity = 512>
+    class FixedStructChainer
+    {
+    public:
+        /* Public functions */
+        FixedStructChainer()
+            :m_last_struct_offset(0),
+             m_n_structs         (0),
+             m_structs_size      (0)
+        {
+            /* Stub */
+        }
+
+        ~FixedStructChainer()
+        {
+            /* Stub */
+        }
+
+        /** Appends a copy of @param in_struct to the chain and links the previously appended struct to it.
+         *
+         *  @return ID of the struct, which can be passed to get_struct_with_id(), or UINT32_MAX if the struct
+         *          does not fit in the remaining capacity.
+         **/
+        template<typename ChainedStructType>
+        StructID append_struct(const ChainedStructType& in_struct)
+        {
+            static_assert(sizeof(ChainedStructType) <= Capacity,
+                          "Struct does not fit in the chainer's storage");
+
+            const uint32_t new_struct_offset = Anvil::Utils::round_up(m_structs_size,
+                                                                      static_cast<uint32_t>(alignof(ChainedStructType) ) );
+
+            anvil_assert(in_struct.pNext == nullptr);
+
+            /* Zeroth item appended to the chain must be of StructType type! */
+            if (m_n_structs       == 0                  &&
+                sizeof(in_struct) != sizeof(StructType) )
+            {
+                anvil_assert_fail();
+            }
+
+            if (new_struct_offset + sizeof(in_struct) > Capacity)
+            {
+                anvil_assert_fail();
+
+                return UINT32_MAX;
+            }
+
+            memcpy(m_raw_data + new_struct_offset,
+                  &in_struct,
+                   sizeof(in_struct) );
+
+            if (m_n_structs > 0)
+            {
+                reinterpret_cast<VkStructHeader*>(m_raw_data + m_last_struct_offset)->next_ptr = m_raw_data + new_struct_offset;
+            }
+
+            m_last_struct_offset = new_struct_offset;
+            m_structs_size       = new_struct_offset + static_cast<uint32_t>(sizeof(in_struct) );
+
+            ++m_n_structs;
+
+            return new_struct_offset;
+        }
+
+        StructType* get_last_struct()
+        {
+            anvil_assert(m_n_structs > 0);
+
+            return reinterpret_cast<StructType*>(m_raw_data + m_last_struct_offset);
+        }
+
+        const StructType* get_last_struct() const
+        {
+            anvil_assert(m_n_structs > 0);
+
+            return reinterpret_cast<const StructType*>(m_raw_data + m_last_struct_offset);
+        }
+
+        uint32_t get_n_structs() const
+        {
+            return m_n_structs;
+        }
+
+        StructType* get_root_struct()
+        {
+            anvil_assert(m_n_structs > 0);
+
+            return reinterpret_cast<StructType*>(m_raw_data);
+        }
+
+        const StructType* get_root_struct() const
+        {
+            anvil_assert(m_n_structs > 0);
+
+            return reinterpret_cast<const StructType*>(m_raw_data);
+        }
+
+        VkStructHeader* get_struct_at_index(const uint32_t& in_index)
+        {
+            VkStructHeader* result_ptr = nullptr;
+
+            if (m_n_structs > in_index)
+            {
+                result_ptr = reinterpret_cast<VkStructHeader*>(m_raw_data);
+
+                for (uint32_t n_struct = 0;
+                              n_struct < in_index;
+                            ++n_struct)
+                {
+                    result_ptr = reinterpret_cast<VkStructHeader*>(const_cast<void*>(result_ptr->next_ptr) );
+                }
+            }
+
+            return result_ptr;
+        }
+
+        template<typename StructType2>
+        StructType2* get_struct_with_id(const StructID& in_id)
+        {
+            anvil_assert(in_id < m_structs_size);
+
+            return reinterpret_cast<StructType2*>(m_raw_data + in_id);
+        }
+
+    private:
+        /* Private functions */
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(FixedStructChainer);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(FixedStructChainer);
+
+        /* Private variables */
+        alignas(16) uint8_t m_raw_data[Capacity]; /* exceeds the alignment requirements of all Vulkan structs */
+
+        uint32_t m_last_struct_offset;
+        uint32_t m_n_structs;
+        uint32_t m_structs_size;
+    };
 };
 
 #endif /* MISC_STRUCT_CHAINER_H */
@@ -107,16 +107,19 @@
 /* Forward declarations */
 namespace Anvil
 {
+    class  AsyncFileLoader;
     class  BaseDevice;
     class  BasePipelineCreateInfo;
     class  Buffer;
     class  BufferCreateInfo;
+    class  BufferSubAllocator;
     class  BufferView;
     class  BufferViewCreateInfo;
     struct CallbackArgument;
     class  CommandBufferBase;
     class  CommandPool;
     class  ComputePipelineCreateInfo;
+    class  ComputePrimitive;
     class  ComputePipelineManager;
     class  DebugMessenger;
     class  DebugMessengerCreateInfo;
@@ -128,12 +131,15 @@ namespace Anvil
     class  DescriptorSetLayout;
     class  DescriptorSetLayoutManager;
     class  DescriptorUpdateTemplate;
+    class  DescriptorUpdateTemplateCache;
     class  DeviceCreateInfo;
     class  ExternalHandle;
     class  Event;
     class  EventCreateInfo;
     class  Fence;
     class  FenceCreateInfo;
+    class  FrameScheduler;
+    class  FrameScheduler;
     class  Framebuffer;
     class  FramebufferCreateInfo;
     class  GLSLShaderToSPIRVGenerator;
@@ -143,8 +149,10 @@ namespace Anvil
     class  ImageCreateInfo;
     class  ImageView;
     class  ImageViewCreateInfo;
+    class  IndirectDrawBatch;
     class  Instance;
     class  InstanceCreateInfo;
+    class  MappedFile;
     class  MemoryAllocator;
     class  MemoryBlock;
     class  MemoryBlockCreateInfo;
@@ -152,17 +160,22 @@ namespace Anvil
     struct MemoryProperties;
     struct MemoryType;
     class  MGPUDevice;
+    class  ParallelRenderPassRecorder;
     class  PhysicalDevice;
     class  PipelineCache;
     class  PipelineLayout;
     class  PipelineLayoutManager;
     class  PrimaryCommandBuffer;
+    class  PushDescriptorSetInfo;
     class  QueryPool;
+    class  QueryRing;
     class  Queue;
+    class  RenderGraph;
     class  RenderingSurface;
     class  RenderingSurfaceCreateInfo;
     class  RenderPass;
     class  RenderPassCreateInfo;
+    class  ResourceReleaseQueue;
     class  Sampler;
     class  SamplerCreateInfo;
     class  SamplerYCbCrConversion;
@@ -173,19 +186,25 @@ namespace Anvil
     class  SGPUDevice;
     class  ShaderModule;
     class  ShaderModuleCache;
+    class  SparseResidencyManager;
     class  Swapchain;
     class  SwapchainCreateInfo;
+    class  TimelineSemaphore;
+    class  UniformRingAllocator;
     class  Window;
 
+    typedef std::unique_ptr<AsyncFileLoader,                       std::function<void(AsyncFileLoader*)> >             AsyncFileLoaderUniquePtr;
     typedef std::unique_ptr<BaseDevice,                            std::function<void(BaseDevice*)> >                  BaseDeviceUniquePtr;
     typedef std::unique_ptr<BasePipelineCreateInfo>                                                                    BasePipelineCreateInfoUniquePtr;
     typedef std::unique_ptr<BufferCreateInfo>                                                                          BufferCreateInfoUniquePtr;
+    typedef std::unique_ptr<BufferSubAllocator,                    std::function<void(BufferSubAllocator*)> >          BufferSubAllocatorUniquePtr;
     typedef std::unique_ptr<Buffer,                                std::function<void(Buffer*)> >                      BufferUniquePtr;
     typedef std::unique_ptr<BufferViewCreateInfo>                                                                      BufferViewCreateInfoUniquePtr;
     typedef std::unique_ptr<BufferView,                            std::function<void(BufferView*)> >                  BufferViewUniquePtr;
     typedef std::unique_ptr<CommandBufferBase,                     std::function<void(CommandBufferBase*)> >           CommandBufferBaseUniquePtr;
     typedef std::unique_ptr<CommandPool,                           std::function<void(CommandPool*)> >                 CommandPoolUniquePtr;
     typedef std::unique_ptr<ComputePipelineCreateInfo>                                                                 ComputePipelineCreateInfoUniquePtr;
+    typedef std::unique_ptr<ComputePrimitive,                      std::function<void(ComputePrimitive*)> >            ComputePrimitiveUniquePtr;
     typedef std::unique_ptr<DebugMessengerCreateInfo>                                                                  DebugMessengerCreateInfoUniquePtr;
     typedef std::unique_ptr<DebugMessenger,                        std::function<void(DebugMessenger*)> >              DebugMessengerUniquePtr;
     typedef std::unique_ptr<DescriptorPoolCreateInfo>                                                                  DescriptorPoolCreateInfoUniquePtr;
@@ -196,12 +215,14 @@ namespace Anvil
     typedef std::unique_ptr<DescriptorSetLayoutManager,            std::function<void(DescriptorSetLayoutManager*)> >  DescriptorSetLayoutManagerUniquePtr;
     typedef std::unique_ptr<DescriptorSet,                         std::function<void(DescriptorSet*)> >               DescriptorSetUniquePtr;
     typedef std::unique_ptr<DescriptorUpdateTemplate,              std::function<void(DescriptorUpdateTemplate*)> >    DescriptorUpdateTemplateUniquePtr;
+    typedef std::unique_ptr<DescriptorUpdateTemplateCache,         std::function<void(DescriptorUpdateTemplateCache*)> > DescriptorUpdateTemplateCacheUniquePtr;
     typedef std::unique_ptr<DeviceCreateInfo>                                                                          DeviceCreateInfoUniquePtr;
     typedef std::unique_ptr<ExternalHandle,                        std::function<void(ExternalHandle*)> >              ExternalHandleUniquePtr;
     typedef std::unique_ptr<EventCreateInfo>                                                                           EventCreateInfoUniquePtr;
     typedef std::unique_ptr<Event,                                 std::function<void(Event*)> >                       EventUniquePtr;
     typedef std::unique_ptr<FenceCreateInfo>                                                                           FenceCreateInfoUniquePtr;
     typedef std::unique_ptr<Fence,                                 std::function<void(Fence*)> >                       FenceUniquePtr;
+    typedef std::unique_ptr<FrameScheduler,                        std::function<void(FrameScheduler*)> >              FrameSchedulerUniquePtr;
     typedef std::unique_ptr<FramebufferCreateInfo>                                                                     FramebufferCreateInfoUniquePtr;
     typedef std::unique_ptr<Framebuffer,                           std::function<void(Framebuffer*)> >                 FramebufferUniquePtr;
     typedef std::unique_ptr<GLSLShaderToSPIRVGenerator,            std::function<void(GLSLShaderToSPIRVGenerator*)> >  GLSLShaderToSPIRVGeneratorUniquePtr;
@@ -211,21 +232,28 @@ namespace Anvil
     typedef std::unique_ptr<Image,                                 std::function<void(Image*)> >                       ImageUniquePtr;
     typedef std::unique_ptr<ImageViewCreateInfo>                                                                       ImageViewCreateInfoUniquePtr;
     typedef std::unique_ptr<ImageView,                             std::function<void(ImageView*)> >                   ImageViewUniquePtr;
+    typedef std::unique_ptr<IndirectDrawBatch,                     std::function<void(IndirectDrawBatch*)> >           IndirectDrawBatchUniquePtr;
     typedef std::unique_ptr<InstanceCreateInfo>                                                                        InstanceCreateInfoUniquePtr;
     typedef std::unique_ptr<Instance,                              std::function<void(Instance*)> >                    InstanceUniquePtr;
+    typedef std::unique_ptr<MappedFile,                            std::function<void(MappedFile*)> >                  MappedFileUniquePtr;
     typedef std::unique_ptr<MemoryAllocator,                       std::function<void(MemoryAllocator*)> >             MemoryAllocatorUniquePtr;
     typedef std::unique_ptr<MemoryBlockCreateInfo>                                                                     MemoryBlockCreateInfoUniquePtr;
     typedef std::unique_ptr<MemoryBlock,                           std::function<void(MemoryBlock*)> >                 MemoryBlockUniquePtr;
     typedef std::unique_ptr<MGPUDevice,                            std::function<void(MGPUDevice*)> >                  MGPUDeviceUniquePtr;
+    typedef std::unique_ptr<ParallelRenderPassRecorder,            std::function<void(ParallelRenderPassRecorder*)> >  ParallelRenderPassRecorderUniquePtr;
     typedef std::unique_ptr<PipelineCache,                         std::function<void(PipelineCache*)> >               PipelineCacheUniquePtr;
     typedef std::unique_ptr<PipelineLayoutManager,                 std::function<void(PipelineLayoutManager*)> >       PipelineLayoutManagerUniquePtr;
     typedef std::unique_ptr<PipelineLayout,                        std::function<void(PipelineLayout*)> >              PipelineLayoutUniquePtr;
     typedef std::unique_ptr<PrimaryCommandBuffer,                  std::function<void(PrimaryCommandBuffer*)> >        PrimaryCommandBufferUniquePtr;
+    typedef std::unique_ptr<PushDescriptorSetInfo,                 std::function<void(PushDescriptorSetInfo*)> >       PushDescriptorSetInfoUniquePtr;
     typedef std::unique_ptr<QueryPool,                             std::function<void(QueryPool*)> >                   QueryPoolUniquePtr;
+    typedef std::unique_ptr<QueryRing,                             std::function<void(QueryRing*)> >                   QueryRingUniquePtr;
+    typedef std::unique_ptr<RenderGraph,                           std::function<void(RenderGraph*)> >                 RenderGraphUniquePtr;
     typedef std::unique_ptr<RenderingSurface,                      std::function<void(RenderingSurface*)> >            RenderingSurfaceUniquePtr;
     typedef std::unique_ptr<RenderingSurfaceCreateInfo>                                                                RenderingSurfaceCreateInfoUniquePtr;
     typedef std::unique_ptr<RenderPassCreateInfo>                                                                      RenderPassCreateInfoUniquePtr;
     typedef std::unique_ptr<RenderPass,                            std::function<void(RenderPass*)> >                  RenderPassUniquePtr;
+    typedef std::unique_ptr<ResourceReleaseQueue,                  std::function<void(ResourceReleaseQueue*)> >        ResourceReleaseQueueUniquePtr;
     typedef std::unique_ptr<SamplerCreateInfo>                                                                         SamplerCreateInfoUniquePtr;
     typedef std::unique_ptr<Sampler,                               std::function<void(Sampler*)> >                     SamplerUniquePtr;
     typedef std::unique_ptr<SamplerYCbCrConversionCreateInfo>                                                          SamplerYCbCrConversionCreateInfoUniquePtr;
@@ -236,8 +264,11 @@ namespace Anvil
     typedef std::unique_ptr<SGPUDevice,                            std::function<void(SGPUDevice*)> >                  SGPUDeviceUniquePtr;
     typedef std::unique_ptr<ShaderModuleCache,                     std::function<void(ShaderModuleCache*)> >           ShaderModuleCacheUniquePtr;
     typedef std::unique_ptr<ShaderModule,                          std::function<void(ShaderModule*)> >                ShaderModuleUniquePtr;
+    typedef std::unique_ptr<SparseResidencyManager,                std::function<void(SparseResidencyManager*)> >      SparseResidencyManagerUniquePtr;
     typedef std::unique_ptr<SwapchainCreateInfo>                                                                       SwapchainCreateInfoUniquePtr;
     typedef std::unique_ptr<Swapchain,                             std::function<void(Swapchain*)> >                   SwapchainUniquePtr;
+    typedef std::unique_ptr<TimelineSemaphore,                     std::function<void(TimelineSemaphore*)> >           TimelineSemaphoreUniquePtr;
+    typedef std::unique_ptr<UniformRingAllocator,                  std::function<void(UniformRingAllocator*)> >        UniformRingAllocatorUniquePtr;
     typedef std::unique_ptr<Window,                                std::function<void(Window*)> >                      WindowUniquePtr;
 };
 
@@ -263,6 +294,15 @@ namespace Anvil
     /** "About to be deleted" call-back function prototype. */
     typedef std::function<void (Anvil::MemoryBlock* in_memory_block_ptr)> OnMemoryBlockReleaseCallbackFunction;
 
+    /** Call-back function prototype used to fill mapped or staging memory with data, without requiring the data
+     *  to be stored in an intermediate host buffer first.
+     *
+     *  @param out_data_ptr Location the call-back should write @param in_size bytes of data to. The location
+     *                      is only valid for the duration of the call.
+     *  @param in_size      Number of bytes to write.
+     */
+    typedef std::function<void (void* out_data_ptr, VkDeviceSize in_size)> MemoryWriteProducerFunction;
+
     /** Base pipeline ID. Internal type, used to represent compute / graphics pipeline IDs */
     typedef uint32_t PipelineID;
 
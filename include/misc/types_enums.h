@@ -836,13 +836,30 @@ namespace Anvil
 
     INJECT_BITFIELD_HELPER_FUNC_PROTOTYPES(DescriptorPoolCreateFlags, VkDescriptorPoolCreateFlags, DescriptorPoolCreateFlagBits)
 
+    /* NOTE: Maps 1:1 to VK equivalents */
+    enum class DescriptorSetLayoutCreateFlagBits
+    {
+        /* When set, descriptor sets must not be allocated using the layout. Instead, descriptors are pushed directly
+         * into command buffers with CommandBufferBase::record_push_descriptor_set() or
+         * CommandBufferBase::record_push_descriptor_set_with_template().
+         *
+         * Requires VK_KHR_push_descriptor.
+         **/
+        PUSH_DESCRIPTOR_BIT_KHR = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
+
+        NONE = 0
+    };
+    typedef Anvil::Bitfield<Anvil::DescriptorSetLayoutCreateFlagBits, VkDescriptorSetLayoutCreateFlags> DescriptorSetLayoutCreateFlags;
+
+    INJECT_BITFIELD_HELPER_FUNC_PROTOTYPES(DescriptorSetLayoutCreateFlags, VkDescriptorSetLayoutCreateFlags, DescriptorSetLayoutCreateFlagBits)
+
     enum class DescriptorSetUpdateMethod
     {
         /* Updates dirty DS bindings using vkUpdateDescriptorSet() which is available on all Vulkan implementations. */
         CORE,
 
-        /* Updates dirty DS bindings using vkUpdateDescriptorSetWithTemplateKHR(). Templates are cached across update operations,
-         * and are release at DescriptorSet release time.
+        /* Updates dirty DS bindings using vkUpdateDescriptorSetWithTemplateKHR(). Templates are cached device-wide by
+         * DescriptorUpdateTemplateCache, and are released together with the descriptor set layout they were created for.
          *
          * This setting is recommended if you are going to be updating the same set of descriptor set bindings more than once.
          *
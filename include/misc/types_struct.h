@@ -1132,6 +1132,14 @@ namespace Anvil
         ExtensionKHRMaintenance3Entrypoints();
     } ExtensionKHRMaintenance3Entrypoints;
 
+    typedef struct ExtensionKHRPushDescriptorEntrypoints
+    {
+        PFN_vkCmdPushDescriptorSetKHR             vkCmdPushDescriptorSetKHR;
+        PFN_vkCmdPushDescriptorSetWithTemplateKHR vkCmdPushDescriptorSetWithTemplateKHR;
+
+        ExtensionKHRPushDescriptorEntrypoints();
+    } ExtensionKHRPushDescriptorEntrypoints;
+
     typedef struct ExtensionKHRSamplerYCbCrConversionEntrypoints
     {
         PFN_vkCreateSamplerYcbcrConversionKHR  vkCreateSamplerYcbcrConversionKHR;
@@ -1162,6 +1170,15 @@ namespace Anvil
         ExtensionKHRSwapchainEntrypoints();
     } ExtensionKHRSwapchainEntrypoints;
 
+    typedef struct ExtensionKHRTimelineSemaphoreEntrypoints
+    {
+        PFN_vkGetSemaphoreCounterValueKHR vkGetSemaphoreCounterValueKHR;
+        PFN_vkSignalSemaphoreKHR          vkSignalSemaphoreKHR;
+        PFN_vkWaitSemaphoresKHR           vkWaitSemaphoresKHR;
+
+        ExtensionKHRTimelineSemaphoreEntrypoints();
+    } ExtensionKHRTimelineSemaphoreEntrypoints;
+
     #ifdef _WIN32
         #if defined(ANVIL_INCLUDE_WIN3264_WINDOW_SYSTEM_SUPPORT)
             typedef struct ExtensionKHRWin32SurfaceEntrypoints
@@ -1771,6 +1788,18 @@ namespace Anvil
         bool operator==(const KHRShaderFloatControlsProperties& in_properties) const;
     } KHRShaderFloatControlsProperties;
 
+    typedef struct KHRTimelineSemaphoreFeatures
+    {
+        bool timeline_semaphore;
+
+        KHRTimelineSemaphoreFeatures();
+        KHRTimelineSemaphoreFeatures(const VkPhysicalDeviceTimelineSemaphoreFeaturesKHR& in_features);
+
+        VkPhysicalDeviceTimelineSemaphoreFeaturesKHR get_vk_physical_device_timeline_semaphore_features() const;
+
+        bool operator==(const KHRTimelineSemaphoreFeatures& in_features) const;
+    } KHRTimelineSemaphoreFeatures;
+
         typedef struct KHRVariablePointerFeatures
     {
         bool variable_pointers;
@@ -2405,6 +2434,7 @@ namespace Anvil
         const KHRMultiviewFeatures*              khr_multiview_features_ptr;
         const KHRSamplerYCbCrConversionFeatures* khr_sampler_ycbcr_conversion_features_ptr;
         const KHRShaderAtomicInt64Features*      khr_shader_atomic_int64_features_ptr;
+        const KHRTimelineSemaphoreFeatures*      khr_timeline_semaphore_features_ptr;
         const KHRVariablePointerFeatures*        khr_variable_pointer_features_ptr;
         const KHRVulkanMemoryModelFeatures*      khr_vulkan_memory_model_features_ptr;
 
@@ -2423,6 +2453,7 @@ namespace Anvil
                                const KHRMultiviewFeatures*              in_khr_multiview_features_ptr,
                                const KHRSamplerYCbCrConversionFeatures* in_khr_sampler_ycbcr_conversion_features_ptr,
                                const KHRShaderAtomicInt64Features*      in_khr_shader_atomic_int64_features_ptr,
+                               const KHRTimelineSemaphoreFeatures*      in_khr_timeline_semaphore_features_ptr,
                                const KHRVariablePointerFeatures*        in_khr_variable_pointer_features_ptr,
                                const KHRVulkanMemoryModelFeatures*      in_khr_vulkan_memory_model_features_ptr);
 
@@ -3155,6 +3186,16 @@ namespace Anvil
             return n_signal_semaphores;
         }
 
+        const uint32_t& get_n_timeline_signal_semaphores() const
+        {
+            return n_timeline_signal_semaphores;
+        }
+
+        const uint32_t& get_n_timeline_wait_semaphores() const
+        {
+            return n_timeline_wait_semaphores;
+        }
+
         const uint32_t& get_n_wait_semaphores() const
         {
             return n_wait_semaphores;
@@ -3175,6 +3216,31 @@ namespace Anvil
             return should_block;
         }
 
+        Anvil::TimelineSemaphore* const* get_timeline_signal_semaphores() const
+        {
+            return timeline_signal_semaphore_ptrs_ptr;
+        }
+
+        const uint64_t* get_timeline_signal_semaphore_values() const
+        {
+            return timeline_signal_semaphore_values_ptr;
+        }
+
+        const Anvil::PipelineStageFlags* get_timeline_wait_semaphore_destination_stage_wait_masks() const
+        {
+            return timeline_wait_semaphore_dst_stage_masks_ptr;
+        }
+
+        Anvil::TimelineSemaphore* const* get_timeline_wait_semaphores() const
+        {
+            return timeline_wait_semaphore_ptrs_ptr;
+        }
+
+        const uint64_t* get_timeline_wait_semaphore_values() const
+        {
+            return timeline_wait_semaphore_values_ptr;
+        }
+
         const uint64_t& get_timeout() const
         {
             return timeout;
@@ -3303,6 +3369,54 @@ namespace Anvil
             is_protected = in_should_enable;
         }
 
+        /* Calling this function will make Anvil include timeline semaphore signal & wait operations in the submission.
+         *
+         * If VK_KHR_timeline_semaphore is enabled, the timeline semaphores are appended to the batch's signal & wait semaphore arrays,
+         * and a VkTimelineSemaphoreSubmitInfoKHR struct is chained at queue submission time. Otherwise, wait operations are performed
+         * on the host before the batch is submitted, and signal operations are emulated with fences. Please see TimelineSemaphore for details.
+         *
+         * NOTE: Wait-before-signal is not supported for emulated timeline semaphores. If a signal operation for a value the batch waits on
+         *       has not been submitted (or performed from the host) by the time Queue::submit() is called, Queue::submit() returns false
+         *       and nothing is submitted.
+         *
+         * NOTE: The structure caches the provided pointers, not the contents available under derefs! Make sure the pointers remain valid
+         *       for the time of the Queue::submit() call.
+         *
+         * @param in_n_semaphores_to_signal              Number of timeline semaphores to signal after command buffers finish executing. May be 0.
+         * @param in_opt_semaphore_to_signal_ptrs_ptr    Array of @param in_n_semaphores_to_signal timeline semaphores to signal. May be nullptr
+         *                                               if @param in_n_semaphores_to_signal is 0.
+         * @param in_opt_signal_values_ptr               Array of @param in_n_semaphores_to_signal values to set the semaphores to. May be nullptr
+         *                                               if @param in_n_semaphores_to_signal is 0.
+         * @param in_n_semaphores_to_wait_on             Number of timeline semaphores to wait on before executing command buffers. May be 0.
+         * @param in_opt_semaphore_to_wait_on_ptrs_ptr   Array of @param in_n_semaphores_to_wait_on timeline semaphores to wait on. May be nullptr
+         *                                               if @param in_n_semaphores_to_wait_on is 0.
+         * @param in_opt_wait_values_ptr                 Array of @param in_n_semaphores_to_wait_on values to wait for. May be nullptr
+         *                                               if @param in_n_semaphores_to_wait_on is 0.
+         * @param in_opt_dst_stage_masks_to_wait_on_ptrs Array of @param in_n_semaphores_to_wait_on stage masks, at which the wait ops should
+         *                                               be performed. May be nullptr if @param in_n_semaphores_to_wait_on is 0.
+         **/
+        void set_timeline_semaphores(uint32_t                         in_n_semaphores_to_signal,
+                                     Anvil::TimelineSemaphore* const* in_opt_semaphore_to_signal_ptrs_ptr,
+                                     const uint64_t*                  in_opt_signal_values_ptr,
+                                     uint32_t                         in_n_semaphores_to_wait_on,
+                                     Anvil::TimelineSemaphore* const* in_opt_semaphore_to_wait_on_ptrs_ptr,
+                                     const uint64_t*                  in_opt_wait_values_ptr,
+                                     const Anvil::PipelineStageFlags* in_opt_dst_stage_masks_to_wait_on_ptrs)
+        {
+            anvil_assert((in_n_semaphores_to_signal == 0)                                                                                ||
+                         (in_opt_semaphore_to_signal_ptrs_ptr != nullptr && in_opt_signal_values_ptr != nullptr) );
+            anvil_assert((in_n_semaphores_to_wait_on == 0)                                                                               ||
+                         (in_opt_semaphore_to_wait_on_ptrs_ptr != nullptr && in_opt_wait_values_ptr != nullptr && in_opt_dst_stage_masks_to_wait_on_ptrs != nullptr) );
+
+            n_timeline_signal_semaphores                = in_n_semaphores_to_signal;
+            n_timeline_wait_semaphores                  = in_n_semaphores_to_wait_on;
+            timeline_signal_semaphore_ptrs_ptr          = in_opt_semaphore_to_signal_ptrs_ptr;
+            timeline_signal_semaphore_values_ptr        = in_opt_signal_values_ptr;
+            timeline_wait_semaphore_dst_stage_masks_ptr = in_opt_dst_stage_masks_to_wait_on_ptrs;
+            timeline_wait_semaphore_ptrs_ptr            = in_opt_semaphore_to_wait_on_ptrs_ptr;
+            timeline_wait_semaphore_values_ptr          = in_opt_wait_values_ptr;
+        }
+
         /* Sets a timeout which is used when waiting on a fence that the submission is associated with.
          *
          * If your submission times out, you're likely about to experience a TDR and lose the device.
@@ -3353,6 +3467,15 @@ namespace Anvil
 
         Anvil::Fence* fence_ptr;
 
+        uint32_t                         n_timeline_signal_semaphores;
+        Anvil::TimelineSemaphore* const* timeline_signal_semaphore_ptrs_ptr;
+        const uint64_t*                  timeline_signal_semaphore_values_ptr;
+
+        uint32_t                         n_timeline_wait_semaphores;
+        const Anvil::PipelineStageFlags* timeline_wait_semaphore_dst_stage_masks_ptr;
+        Anvil::TimelineSemaphore* const* timeline_wait_semaphore_ptrs_ptr;
+        const uint64_t*                  timeline_wait_semaphore_values_ptr;
+
         #if defined(_WIN32)
             const uint64_t* d3d12_fence_signal_semaphore_values_ptr;
             const uint64_t* d3d12_fence_wait_semaphore_values_ptr;
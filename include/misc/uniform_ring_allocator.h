@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a ring allocator for per-frame, short-lived buffer data such as per-draw uniforms.
+ *
+ *  The allocator owns a single, persistently mapped, host-coherent buffer, divided into a fixed number of frame slots.
+ *  Each frame, allocations are bump-allocated from the current frame slot. Every allocation starts at an offset
+ *  aligned to the device's minimum uniform (and, if requested, storage) buffer offset alignment, so the returned offset
+ *  can be passed directly as a dynamic offset to CommandBufferBase::record_bind_descriptor_sets(). To make that
+ *  possible, bind get_buffer() to a dynamic uniform (or storage) buffer descriptor, using a start offset of 0.
+ *
+ *  Frames are delimited with begin_frame() and end_frame() calls:
+ *
+ *  - end_frame() must be called after the last submission which consumes data allocated in the frame has been
+ *    made. The frame slot is tagged with the submission tracking values of the queues specified at creation time.
+ *  - begin_frame() moves on to the next frame slot. If the GPU may still be reading from the slot, the call blocks
+ *    until the submissions the slot has been tagged with finish executing.
+ *
+ *  allocate() and allocate_and_write() may be called from multiple threads at the same time, as long as no
+ *  begin_frame() or end_frame() calls are made in parallel. An allocation only takes a single atomic increment.
+ */
+#ifndef MISC_UNIFORM_RING_ALLOCATOR_H
+#define MISC_UNIFORM_RING_ALLOCATOR_H
+
+#include "misc/types.h"
+#include <atomic>
+
+
+namespace Anvil
+{
+    class UniformRingAllocator
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a new UniformRingAllocator instance.
+         *
+         *  @param in_device_ptr       Device to use. Must not be nullptr.
+         *  @param in_queue_ptrs       Queues, which are going to consume data allocated from the ring. At least
+         *                             one queue must be specified.
+         *  @param in_frame_slot_size  Number of bytes available for allocations in a single frame. Rounded up to
+         *                             the allocation alignment.
+         *  @param in_n_frame_slots    Number of frame slots, usually equal to the number of frames in flight. Must
+         *                             not be 0.
+         *  @param in_usage_flags      Usage flags to create the buffer with. Must include UNIFORM_BUFFER_BIT and/or
+         *                             STORAGE_BUFFER_BIT.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static UniformRingAllocatorUniquePtr create(const Anvil::BaseDevice*          in_device_ptr,
+                                                    const std::vector<Anvil::Queue*>& in_queue_ptrs,
+                                                    VkDeviceSize                      in_frame_slot_size,
+                                                    uint32_t                          in_n_frame_slots,
+                                                    Anvil::BufferUsageFlags           in_usage_flags = Anvil::BufferUsageFlagBits::UNIFORM_BUFFER_BIT);
+
+        /** Destructor.
+         *
+         *  The buffer must no longer be in use by the GPU at the time of the call.
+         **/
+        ~UniformRingAllocator();
+
+        /** Allocates @param in_size bytes from the current frame slot.
+         *
+         *  Must only be called between begin_frame() and end_frame() calls.
+         *
+         *  @param in_size                Number of bytes to allocate. Must not be 0.
+         *  @param out_data_ptr           Deref will be set to a pointer to the mapped storage, which the data should be
+         *                                written to. The pointer is valid until the next begin_frame() call. Must not be
+         *                                nullptr.
+         *  @param out_dynamic_offset_ptr Deref will be set to the offset of the allocation, relative to the start of
+         *                                get_buffer(). Must not be nullptr.
+         *
+         *  @return true if successful, false if the frame slot has run out of space.
+         **/
+        bool allocate(VkDeviceSize in_size,
+                      void**       out_data_ptr,
+                      uint32_t*    out_dynamic_offset_ptr);
+
+        /** Works like allocate(), but also copies @param in_size bytes from @param in_data_ptr to the new allocation.
+         *
+         *  @param in_data_ptr            Data to copy. Must not be nullptr.
+         *  @param in_size                Number of bytes to allocate and copy. Must not be 0.
+         *  @param out_dynamic_offset_ptr Deref will be set to the offset of the allocation, relative to the start of
+         *                                get_buffer(). Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool allocate_and_write(const void*  in_data_ptr,
+                                VkDeviceSize in_size,
+                                uint32_t*    out_dynamic_offset_ptr);
+
+        /** Moves on to the next frame slot and discards all allocations made in that slot in the past. Blocks until
+         *  the GPU finishes executing all submissions the slot has been tagged with by end_frame().
+         *
+         *  @param in_timeout Timeout for the wait, expressed in nanoseconds.
+         *
+         *  @return true if successful, false if the timeout expired. In the latter case, the frame is not started.
+         **/
+        bool begin_frame(uint64_t in_timeout = UINT64_MAX);
+
+        /** Closes the frame started with a preceding begin_frame() call. Must be called after all submissions which
+         *  consume data allocated in the frame have been made.
+         **/
+        void end_frame();
+
+        /** Returns alignment of all offsets returned by allocate(). */
+        VkDeviceSize get_alignment() const
+        {
+            return m_alignment;
+        }
+
+        /** Returns the buffer, which all allocations are made from. Bind it to dynamic buffer descriptors, using a
+         *  start offset of 0 and a range large enough to hold the largest allocation accessed by a single draw or
+         *  dispatch.
+         **/
+        Anvil::Buffer* get_buffer() const
+        {
+            return m_buffer_ptr.get();
+        }
+
+        /** Returns the number of bytes available for allocations in a single frame. */
+        VkDeviceSize get_frame_slot_size() const
+        {
+            return m_frame_slot_size;
+        }
+
+        /** Returns index of the frame slot which is currently being allocated from. */
+        uint32_t get_n_current_frame_slot() const
+        {
+            return m_n_current_frame_slot;
+        }
+
+        /** Returns the number of frame slots. */
+        uint32_t get_n_frame_slots() const
+        {
+            return static_cast<uint32_t>(m_frame_slots.size() );
+        }
+
+        /** Returns the number of bytes allocated in the current frame slot so far. */
+        VkDeviceSize get_used_size() const;
+
+    private:
+        /* Private type definitions */
+        typedef struct FrameSlot
+        {
+            /* One item per queue. Empty if the slot has not been tagged yet. */
+            std::vector<uint64_t> submission_tracking_values;
+        } FrameSlot;
+
+        /* Private functions */
+        UniformRingAllocator(const std::vector<Anvil::Queue*>& in_queue_ptrs,
+                             VkDeviceSize                      in_alignment,
+                             VkDeviceSize                      in_frame_slot_size,
+                             uint32_t                          in_n_frame_slots);
+
+        bool init(const Anvil::BaseDevice* in_device_ptr,
+                  Anvil::BufferUsageFlags  in_usage_flags);
+
+        /* Private variables */
+        VkDeviceSize               m_alignment;
+        Anvil::BufferUniquePtr     m_buffer_ptr;
+        std::atomic<VkDeviceSize>  m_current_frame_slot_used_size;
+        VkDeviceSize               m_frame_slot_size;
+        std::vector<FrameSlot>     m_frame_slots;
+        bool                       m_is_frame_active;
+        char*                      m_mapped_data_ptr;
+        uint32_t                   m_n_current_frame_slot;
+        std::vector<Anvil::Queue*> m_queue_ptrs;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(UniformRingAllocator);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(UniformRingAllocator);
+    };
+}; /* namespace Anvil */
+
+#endif /* MISC_UNIFORM_RING_ALLOCATOR_H */
@@ -98,6 +98,39 @@ namespace Anvil
          */
         VkBuffer get_buffer(const bool& in_bake_memory_if_necessary = true);
 
+        /** Returns the offset, relative to the start of the raw Vulkan buffer returned by get_buffer(), at which
+         *  storage exposed by this Buffer instance starts.
+         *
+         *  Always 0, unless the buffer has been created with the NO_ALLOC_CHILD type, in which case the raw Vulkan
+         *  buffer handle is shared with the parent buffer.
+         **/
+        VkDeviceSize get_buffer_start_offset() const
+        {
+            return m_buffer_start_offset;
+        }
+
+        /** Converts @param in_offset, expressed relative to the start of storage exposed by this Buffer instance,
+         *  to an offset relative to the start of the raw Vulkan buffer returned by get_buffer().
+         *
+         *  All Anvil functions which pass a buffer to Vulkan (command buffer commands, barriers, descriptors and
+         *  buffer views) resolve offsets with this function. Offsets passed to Anvil are therefore always relative
+         *  to the buffer they are specified for, including for NO_ALLOC_CHILD buffers.
+         **/
+        VkDeviceSize get_buffer_offset_vk(VkDeviceSize in_offset) const
+        {
+            return m_buffer_start_offset + in_offset;
+        }
+
+        /** Converts size of a region starting at @param in_offset, expressed relative to the start of storage exposed
+         *  by this Buffer instance, to a size which can be passed to Vulkan together with get_buffer_offset_vk().
+         *
+         *  Only differs from @param in_size for NO_ALLOC_CHILD buffers, if @param in_size is VK_WHOLE_SIZE. In that case,
+         *  the number of bytes between @param in_offset and the end of this buffer's storage is returned, so that the
+         *  region does not extend over parent buffer's storage.
+         **/
+        VkDeviceSize get_buffer_size_vk(VkDeviceSize in_offset,
+                                        VkDeviceSize in_size) const;
+
         /** Returns a pointer to the encapsulated raw Vulkan buffer handle */
         const VkBuffer* get_buffer_ptr() const
         {
@@ -257,6 +290,27 @@ namespace Anvil
                    uint32_t                             in_device_mask,
                    Anvil::Queue*                        in_opt_queue_ptr = nullptr);
 
+        /** Works like write(), except that data is produced by @param in_producer_function directly in mapped memory
+         *  backing the buffer or, if the memory is not mappable, in the staging buffer. No intermediate copy of the data
+         *  is made.
+         *
+         *  @param in_start_offset      As per write().
+         *  @param in_size              As per write().
+         *  @param in_producer_function Function to call with a pointer to the mapped region @param in_size bytes
+         *                              should be written to. Must not be nullptr.
+         *
+         *  @return true if the operation was successful, false otherwise.
+         **/
+        bool write_with_producer(VkDeviceSize                       in_start_offset,
+                                 VkDeviceSize                       in_size,
+                                 const MemoryWriteProducerFunction& in_producer_function,
+                                 Anvil::Queue*                      in_opt_queue_ptr = nullptr);
+        bool write_with_producer(VkDeviceSize                       in_start_offset,
+                                 VkDeviceSize                       in_size,
+                                 const MemoryWriteProducerFunction& in_producer_function,
+                                 uint32_t                           in_device_mask,
+                                 Anvil::Queue*                      in_opt_queue_ptr = nullptr);
+
     private:
         /* Private functions */
 
@@ -280,6 +334,7 @@ namespace Anvil
         /* Private members */
         VkBuffer                                 m_buffer;
         VkMemoryRequirements                     m_buffer_memory_reqs;
+        VkDeviceSize                             m_buffer_start_offset;
         std::unique_ptr<Anvil::BufferCreateInfo> m_create_info_ptr;
 
         Anvil::MemoryBlock*                  m_memory_block_ptr; // only used by non-sparse buffers
@@ -107,6 +107,8 @@ namespace Anvil
         COMMAND_TYPE_NEXT_SUBPASS_2_KHR,
         COMMAND_TYPE_PIPELINE_BARRIER,
         COMMAND_TYPE_PUSH_CONSTANTS,
+        COMMAND_TYPE_PUSH_DESCRIPTOR_SET_KHR,
+        COMMAND_TYPE_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE_KHR,
         COMMAND_TYPE_RESET_EVENT,
         COMMAND_TYPE_RESET_QUERY_POOL,
         COMMAND_TYPE_RESOLVE_IMAGE,
@@ -415,12 +417,42 @@ namespace Anvil
      *  command buffer instance right after recording finishes without any additional performance cost.
      *
      *  Provides core functionality for the PrimaryCommandBuffer and SecondaryCommandBuffer classes.
+     *
+     *  Buffer offsets passed to the record_*() functions, and to buffer barriers, are relative to the start of storage
+     *  exposed by the Buffer instance they are specified for. For NO_ALLOC_CHILD buffers, which share the raw Vulkan
+     *  buffer handle with their parent, they are converted with Buffer::get_buffer_offset_vk() before being passed
+     *  to Vulkan. VK_WHOLE_SIZE ranges end where the child buffer's storage ends.
      */
     class CommandBufferBase : public MTSafetySupportProvider,
                               public DebugMarkerSupportProvider<CommandBufferBase>,
                               public CallbacksSupportProvider
     {
     public:
+        /* Public type definitions */
+
+        /** Holds the number of calls elided by the redundant state filter since recording started.
+         *  See set_redundant_state_filtering_enabled() for more details.
+         **/
+        typedef struct ElidedCallCounters
+        {
+            uint32_t n_bind_descriptor_sets_calls;
+            uint32_t n_bind_index_buffer_calls;
+            uint32_t n_bind_pipeline_calls;
+            uint32_t n_bind_vertex_buffers_calls;
+
+            /* Covers blend constants, depth bias, depth bounds, line width, scissor, stencil and viewport state. */
+            uint32_t n_set_dynamic_state_calls;
+
+            ElidedCallCounters()
+            {
+                n_bind_descriptor_sets_calls = 0;
+                n_bind_index_buffer_calls    = 0;
+                n_bind_pipeline_calls        = 0;
+                n_bind_vertex_buffers_calls  = 0;
+                n_set_dynamic_state_calls    = 0;
+            }
+        } ElidedCallCounters;
+
         /* Public functions */
 
         virtual ~CommandBufferBase();
@@ -473,6 +505,12 @@ namespace Anvil
             return m_type;
         }
 
+        /** Returns the number of calls elided by the redundant state filter since recording started. */
+        const ElidedCallCounters& get_elided_call_counters() const
+        {
+            return m_elided_call_counters;
+        }
+
         /** Returns the parent command pool */
         Anvil::CommandPool* get_parent_command_pool() const
         {
@@ -489,6 +527,12 @@ namespace Anvil
         void insert_debug_utils_label(const char*  in_label_name_ptr,
                                       const float* in_color_vec4_ptr);
 
+        /** Tells whether redundant state filtering has been enabled for the command buffer. */
+        bool is_redundant_state_filtering_enabled() const
+        {
+            return m_is_redundant_state_filtering_enabled;
+        }
+
         /** Issues a vkCmdBeginQuery() call and appends it to the internal vector of commands
          *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
          *  #define enabled).
@@ -724,6 +768,9 @@ namespace Anvil
          *
          *  Argument meaning is as per Vulkan API specification.
          *
+         *  Fails with an assertion failure if an accessed region does not fit in the buffer's storage. For NO_ALLOC_CHILD
+         *  buffers, this keeps the command from touching storage outside the sub-allocation.
+         *
          *  @return true if successful, false otherwise.
          **/
         bool record_copy_buffer(Anvil::Buffer*           in_src_buffer_ptr,
@@ -1173,6 +1220,9 @@ namespace Anvil
          *
          *  Argument meaning is as per Vulkan API specification.
          *
+         *  Fails with an assertion failure if an accessed region does not fit in the buffer's storage. For NO_ALLOC_CHILD
+         *  buffers, this keeps the command from touching storage outside the sub-allocation.
+         *
          *  @return true if successful, false otherwise.
          **/
         bool record_fill_buffer(Anvil::Buffer* in_dst_buffer_ptr,
@@ -1218,6 +1268,54 @@ namespace Anvil
                                    uint32_t                in_size,
                                    const void*             in_values);
 
+        /** Issues a vkCmdPushDescriptorSetKHR() call and appends it to the internal vector of commands
+         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
+         *  #define enabled).
+         *
+         *  Pushed descriptors do not need to be allocated from a descriptor pool, nor do they need to be updated
+         *  with vkUpdateDescriptorSets(). Contents of @param in_info_ptr are consumed at call time, so the object
+         *  may be cleared and reused right after this function leaves.
+         *
+         *  Calling this function for a command buffer which has not been put into a recording mode
+         *  (by issuing a start_recording() call earlier) will result in an assertion failure.
+         *
+         *  Requires VK_KHR_push_descriptor.
+         *
+         *  @param in_pipeline_bind_point Pipeline bind point to push the descriptors for.
+         *  @param in_layout_ptr          Pipeline layout to use. Must not be nullptr.
+         *  @param in_n_set               Index of the descriptor set to push descriptors for. The set must have been created
+         *                                with PUSH_DESCRIPTOR_BIT_KHR layout create flag.
+         *  @param in_info_ptr            Writes to push. Must not be nullptr, and must hold at least one write.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool record_push_descriptor_set(Anvil::PipelineBindPoint            in_pipeline_bind_point,
+                                        Anvil::PipelineLayout*              in_layout_ptr,
+                                        uint32_t                            in_n_set,
+                                        const Anvil::PushDescriptorSetInfo* in_info_ptr);
+
+        /** Issues a vkCmdPushDescriptorSetWithTemplateKHR() call and appends it to the internal vector of commands
+         *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
+         *  #define enabled).
+         *
+         *  Pipeline layout and set index the descriptors are pushed for are taken from @param in_template_ptr.
+         *  Data under @param in_data_ptr is consumed at call time.
+         *
+         *  Calling this function for a command buffer which has not been put into a recording mode
+         *  (by issuing a start_recording() call earlier) will result in an assertion failure.
+         *
+         *  Requires VK_KHR_push_descriptor and VK_KHR_descriptor_update_template.
+         *
+         *  @param in_template_ptr Template to use. Must have been created with
+         *                         DescriptorUpdateTemplate::create_for_push_descriptor_set_updates(). Must not be nullptr.
+         *  @param in_data_ptr     Raw descriptor data, laid out as described by the template's update entries.
+         *                         Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool record_push_descriptor_set_with_template(const Anvil::DescriptorUpdateTemplate* in_template_ptr,
+                                                      const void*                            in_data_ptr);
+
         /** Issues a vkCmdResetEvent() call and appends it to the internal vector of commands
          *  recorded for the specified command buffer (for builds with STORE_COMMAND_BUFFER_COMMANDS
          *  #define enabled).
@@ -1460,6 +1558,9 @@ namespace Anvil
          *
          *  Argument meaning is as per Vulkan API specification.
          *
+         *  Fails with an assertion failure if an accessed region does not fit in the buffer's storage. For NO_ALLOC_CHILD
+         *  buffers, this keeps the command from touching storage outside the sub-allocation.
+         *
          *  @return true if successful, false otherwise.
          **/
         bool record_update_buffer(Anvil::Buffer* in_dst_buffer_ptr,
@@ -1533,6 +1634,32 @@ namespace Anvil
          **/
         bool reset(bool in_should_release_resources);
 
+        /** Enables or disables redundant state filtering for the command buffer. Disabled by default.
+         *
+         *  When enabled, the command buffer keeps a shadow copy of the pipelines, descriptor sets, vertex & index
+         *  buffers and dynamic state it has recorded so far. The following calls are then dropped without
+         *  reaching Vulkan, if they would not change the state already set:
+         *
+         *  - record_bind_descriptor_sets()    (only repeated calls with identical arguments and pipeline layout)
+         *  - record_bind_index_buffer()
+         *  - record_bind_pipeline() and record_bind_vk_pipeline()
+         *  - record_bind_vertex_buffers()
+         *  - record_set_blend_constants(), record_set_depth_bias(), record_set_depth_bounds(), record_set_line_width(),
+         *    record_set_scissor(), record_set_stencil_compare_mask(), record_set_stencil_reference(),
+         *    record_set_stencil_write_mask() and record_set_viewport().
+         *
+         *  The shadow state is discarded whenever recording starts, a render pass begins or ends, a subpass
+         *  changes or secondary command buffers are executed. Pushing descriptors discards the shadow copy of
+         *  descriptor set bindings for the affected bind point. Binding a different graphics pipeline discards
+         *  the shadow copy of dynamic state, since static pipeline state overwrites it.
+         *
+         *  Elided calls are not stored for STORE_COMMAND_BUFFER_COMMANDS builds. Use get_elided_call_counters()
+         *  to check how many calls have been dropped.
+         *
+         *  @param in_enabled true to enable the filter, false to disable it.
+         **/
+        void set_redundant_state_filtering_enabled(bool in_enabled);
+
         /** Stops an ongoing command recording process.
          *
          *  It is an error to invoke this function if the command buffer has not been put
@@ -1573,6 +1700,8 @@ namespace Anvil
         struct FillBufferCommand;
         struct NextSubpassCommand;
         struct PushConstantsCommand;
+        struct PushDescriptorSetKHRCommand;
+        struct PushDescriptorSetWithTemplateKHRCommand;
         struct ResetEventCommand;
         struct ResetQueryPoolCommand;
         struct ResolveImageCommand;
@@ -2536,6 +2665,44 @@ namespace Anvil
             }
         } PushConstantsCommand;
 
+        /** Holds all arguments passed to a vkCmdPushDescriptorSetKHR() command. */
+        typedef struct PushDescriptorSetKHRCommand : public Command
+        {
+            Anvil::PipelineLayout*   layout_ptr;
+            uint32_t                 n_set;
+            uint32_t                 n_writes;
+            Anvil::PipelineBindPoint pipeline_bind_point;
+
+            /** Constructor. **/
+            explicit PushDescriptorSetKHRCommand(Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                                 Anvil::PipelineLayout*   in_layout_ptr,
+                                                 uint32_t                 in_n_set,
+                                                 uint32_t                 in_n_writes);
+
+            /** Destructor. */
+            virtual ~PushDescriptorSetKHRCommand()
+            {
+                /* Stub */
+            }
+        } PushDescriptorSetKHRCommand;
+
+        /** Holds all arguments passed to a vkCmdPushDescriptorSetWithTemplateKHR() command. */
+        typedef struct PushDescriptorSetWithTemplateKHRCommand : public Command
+        {
+            const void*                            data_ptr;
+            const Anvil::DescriptorUpdateTemplate* template_ptr;
+
+            /** Constructor. **/
+            explicit PushDescriptorSetWithTemplateKHRCommand(const Anvil::DescriptorUpdateTemplate* in_template_ptr,
+                                                             const void*                            in_data_ptr);
+
+            /** Destructor. */
+            virtual ~PushDescriptorSetWithTemplateKHRCommand()
+            {
+                /* Stub */
+            }
+        } PushDescriptorSetWithTemplateKHRCommand;
+
         /** Holds all arguments passed to a vkCmdResetEvent() command. **/
         typedef struct ResetEventCommand : public Command
         {
@@ -2945,6 +3112,8 @@ namespace Anvil
             void clear_commands();
         #endif
 
+        void reset_shadow_state();
+
         /* Protected variables */
         #ifdef STORE_COMMAND_BUFFER_COMMANDS
             Commands m_commands;
@@ -2953,6 +3122,8 @@ namespace Anvil
         VkCommandBuffer          m_command_buffer;
         uint32_t                 m_device_mask;
         const Anvil::BaseDevice* m_device_ptr;
+        ElidedCallCounters       m_elided_call_counters;
+        bool                     m_is_redundant_state_filtering_enabled;
         bool                     m_is_renderpass_active;
         uint32_t                 m_n_debug_label_regions_started;
         Anvil::CommandPool*      m_parent_command_pool_ptr;
@@ -2964,12 +3135,117 @@ namespace Anvil
 
     private:
         /* Private type definitions */
+        enum
+        {
+            /* Graphics & compute */
+            N_SHADOW_BIND_POINTS = 2,
+
+            /* Front & back */
+            N_SHADOW_STENCIL_FACES = 2
+        };
+
+        /** Arguments of a vkCmdBindDescriptorSets() call, as cached by the redundant state filter. */
+        typedef struct ShadowDescriptorSetBinding
+        {
+            std::vector<uint32_t>        dynamic_offsets;
+            Anvil::PipelineLayout*       layout_ptr;
+            std::vector<VkDescriptorSet> sets;
+
+            ShadowDescriptorSetBinding()
+                :layout_ptr(nullptr)
+            {
+                /* Stub */
+            }
+        } ShadowDescriptorSetBinding;
+
+        /** Shadow copy of the state recorded into the command buffer so far. Only maintained if redundant state
+         *  filtering is enabled.
+         **/
+        typedef struct ShadowState
+        {
+            /* Indexed by bind point index & first set index. Entries with a null layout are unknown. */
+            std::vector<ShadowDescriptorSetBinding> descriptor_set_bindings[N_SHADOW_BIND_POINTS];
+            VkPipeline                              pipelines              [N_SHADOW_BIND_POINTS];
+
+            VkBuffer         index_buffer;
+            VkDeviceSize     index_buffer_offset;
+            Anvil::IndexType index_type;
+
+            /* VK_NULL_HANDLE entries are unknown */
+            std::vector<VkBuffer>     vertex_buffers;
+            std::vector<VkDeviceSize> vertex_buffer_offsets;
+
+            float blend_constants[4];
+            float depth_bias     [3];
+            float depth_bounds   [2];
+            float line_width;
+
+            bool is_blend_constants_set;
+            bool is_depth_bias_set;
+            bool is_depth_bounds_set;
+            bool is_line_width_set;
+
+            bool     is_stencil_compare_mask_set[N_SHADOW_STENCIL_FACES];
+            bool     is_stencil_reference_set   [N_SHADOW_STENCIL_FACES];
+            bool     is_stencil_write_mask_set  [N_SHADOW_STENCIL_FACES];
+            uint32_t stencil_compare_masks      [N_SHADOW_STENCIL_FACES];
+            uint32_t stencil_references         [N_SHADOW_STENCIL_FACES];
+            uint32_t stencil_write_masks        [N_SHADOW_STENCIL_FACES];
+
+            std::vector<bool>       is_scissor_set;
+            std::vector<bool>       is_viewport_set;
+            std::vector<VkRect2D>   scissors;
+            std::vector<VkViewport> viewports;
+
+            ShadowState()
+            {
+                reset();
+            }
+
+            void reset              ();
+            void reset_dynamic_state();
+        } ShadowState;
 
         /* Private functions */
         CommandBufferBase           (const CommandBufferBase&);
         CommandBufferBase& operator=(const CommandBufferBase&);
 
+        void invalidate_shadow_descriptor_set_bindings(Anvil::PipelineBindPoint in_pipeline_bind_point);
+
+        bool should_elide_bind_descriptor_sets(Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                               Anvil::PipelineLayout*   in_layout_ptr,
+                                               uint32_t                 in_first_set,
+                                               uint32_t                 in_set_count,
+                                               const VkDescriptorSet*   in_descriptor_sets_vk_ptr,
+                                               uint32_t                 in_dynamic_offset_count,
+                                               const uint32_t*          in_dynamic_offset_ptrs);
+        bool should_elide_bind_index_buffer   (VkBuffer                 in_buffer_vk,
+                                               VkDeviceSize             in_offset,
+                                               Anvil::IndexType         in_index_type);
+        bool should_elide_bind_pipeline       (Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                               VkPipeline               in_pipeline_vk);
+        bool should_elide_bind_vertex_buffers (uint32_t                 in_start_binding,
+                                               uint32_t                 in_binding_count,
+                                               const VkBuffer*          in_buffers_vk_ptr,
+                                               const VkDeviceSize*      in_offsets_ptr);
+        bool should_elide_set_scissor         (uint32_t                 in_first_scissor,
+                                               uint32_t                 in_scissor_count,
+                                               const VkRect2D*          in_scissor_ptrs);
+        bool should_elide_set_viewport        (uint32_t                 in_first_viewport,
+                                               uint32_t                 in_viewport_count,
+                                               const VkViewport*        in_viewport_ptrs);
+
+        static bool should_elide_set_float_state(uint32_t     in_n_values,
+                                                 const float* in_values_ptr,
+                                                 bool*        inout_is_set_ptr,
+                                                 float*       inout_values_ptr);
+        static bool should_elide_set_stencil_state(Anvil::StencilFaceFlags in_face_mask,
+                                                   uint32_t                in_value,
+                                                   bool*                   inout_is_set_ptr,
+                                                   uint32_t*               inout_values_ptr);
+
         /* Private variables */
+        ShadowState m_shadow_state;
 
         friend class Anvil::CommandPool;
     };
@@ -65,6 +65,9 @@ namespace Anvil
         virtual ~DescriptorPool();
 
         /** Allocates user-specified number of descriptors sets with user-defined layouts.
+         *
+         *  Push descriptor layouts cannot be used to allocate descriptor sets. If any of the specified layouts
+         *  is one, the function fails without allocating any set and leaves @param out_opt_result_ptr untouched.
          *
          *  @param in_n_sets                     Number of sets to allocate.
          *  @param in_descriptor_set_layouts_ptr Pointer to an array of Vulkan DS layouts to use for the call.
@@ -934,9 +934,10 @@ namespace Anvil
         mutable std::vector<VkWriteDescriptorSetInlineUniformBlockEXT> m_cached_ds_write_iub_items_vk;
         mutable std::vector<VkWriteDescriptorSet>                      m_cached_ds_write_items_vk;
 
-        mutable std::vector<DescriptorUpdateTemplateEntry>                                                     m_template_entries;
-        mutable std::map<std::vector<DescriptorUpdateTemplateEntry>, Anvil::DescriptorUpdateTemplateUniquePtr> m_template_object_map;
-        mutable std::vector<uint8_t>                                                                           m_template_raw_data;
+        /* Scratch storage reused across template-based updates, so that no allocations are needed once warmed up.
+         * Template objects themselves are owned by the device's DescriptorUpdateTemplateCache. */
+        mutable std::vector<DescriptorUpdateTemplateEntry> m_template_entries;
+        mutable std::vector<uint8_t>                       m_template_raw_data;
 
         friend class Anvil::DescriptorPool;
     };
@@ -69,6 +69,59 @@ namespace Anvil
                                                                                           const uint32_t&                             in_n_update_entries,
                                                                                           MTSafety                                    in_mt_safety = Anvil::MTSafety::INHERIT_FROM_PARENT_DEVICE);
 
+        /** Creates a new DescriptorUpdateTemplate instance, which can be used to push descriptors directly into command buffers
+         *  by calling CommandBufferBase::record_push_descriptor_set_with_template().
+         *
+         *  Requires VK_KHR_push_descriptor and VK_KHR_descriptor_update_template.
+         *
+         *  @param in_device_ptr          Device the template will be created for. Must not be null.
+         *  @param in_pipeline_bind_point Pipeline bind point the descriptors are going to be pushed for.
+         *  @param in_pipeline_layout_ptr Pipeline layout the descriptors are going to be pushed for. Must not be null.
+         *  @param in_n_set               Index of the descriptor set within @param in_pipeline_layout_ptr to use. The descriptor
+         *                                set must have been created with PUSH_DESCRIPTOR_BIT_KHR layout create flag.
+         *  @param in_update_entries_ptr  Array of @param in_n_update_entries update entries. Must not be null.
+         *  @param in_n_update_entries    Number of update entries. Must not be 0.
+         *
+         *  @return New template instance if successful, null otherwise.
+         **/
+        static Anvil::DescriptorUpdateTemplateUniquePtr create_for_push_descriptor_set_updates(const Anvil::BaseDevice*                    in_device_ptr,
+                                                                                               Anvil::PipelineBindPoint                    in_pipeline_bind_point,
+                                                                                               const Anvil::PipelineLayout*                in_pipeline_layout_ptr,
+                                                                                               uint32_t                                    in_n_set,
+                                                                                               const Anvil::DescriptorUpdateTemplateEntry* in_update_entries_ptr,
+                                                                                               const uint32_t&                             in_n_update_entries,
+                                                                                               MTSafety                                    in_mt_safety = Anvil::MTSafety::INHERIT_FROM_PARENT_DEVICE);
+
+        /** Returns index of the descriptor set descriptors are pushed for. Only meaningful for push descriptor templates. */
+        uint32_t get_n_set() const
+        {
+            return m_n_set;
+        }
+
+        /** Returns pipeline bind point the template has been created for. Only meaningful for push descriptor templates. */
+        Anvil::PipelineBindPoint get_pipeline_bind_point() const
+        {
+            return m_pipeline_bind_point;
+        }
+
+        /** Returns pipeline layout the template has been created for. Only set for push descriptor templates. */
+        const Anvil::PipelineLayout* get_pipeline_layout() const
+        {
+            return m_pipeline_layout_ptr;
+        }
+
+        /** Returns raw Vulkan handle of the template. */
+        VkDescriptorUpdateTemplateKHR get_update_template_vk() const
+        {
+            return m_vk_object;
+        }
+
+        /** Tells if the template has been created with create_for_push_descriptor_set_updates(). */
+        bool is_push_descriptor_template() const
+        {
+            return (m_pipeline_layout_ptr != nullptr);
+        }
+
         /* Issues a MT-safe (if needed) vkUpdateDescriptorSetWithTeeplateKHR() call against the specified descriptor set. */
         void update_descriptor_set(const Anvil::DescriptorSet* inout_ds_ptr,
                                    const void*                 in_data_ptr) const;
@@ -76,7 +129,10 @@ namespace Anvil
     private:
         /* Private functions */
 
-        bool init(const Anvil::DescriptorSetLayout*           in_descriptor_set_layout_ptr,
+        bool init(const Anvil::DescriptorSetLayout*           in_opt_descriptor_set_layout_ptr,
+                  Anvil::PipelineBindPoint                    in_pipeline_bind_point,
+                  const Anvil::PipelineLayout*                in_opt_pipeline_layout_ptr,
+                  uint32_t                                    in_n_set,
                   const Anvil::DescriptorUpdateTemplateEntry* in_update_entries_ptr,
                   const uint32_t&                             in_n_update_entries);
 
@@ -90,6 +146,9 @@ namespace Anvil
         /* Private variables */
         const Anvil::BaseDevice*                m_device_ptr;
         Anvil::DescriptorSetCreateInfoUniquePtr m_ds_create_info_ptr;
+        uint32_t                                m_n_set;
+        Anvil::PipelineBindPoint                m_pipeline_bind_point;
+        const Anvil::PipelineLayout*            m_pipeline_layout_ptr;
         VkDescriptorUpdateTemplateKHR           m_vk_object;
     };
 }; /* namespace Anvil */
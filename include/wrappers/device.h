@@ -99,6 +99,14 @@ namespace Anvil
             return m_descriptor_set_layout_manager_ptr.get();
         }
 
+        /** Returns a device-wide cache of descriptor update templates, shared by all descriptor sets
+         *  created for this device.
+         **/
+        Anvil::DescriptorUpdateTemplateCache* get_descriptor_update_template_cache() const
+        {
+            return m_descriptor_update_template_cache_ptr.get();
+        }
+
         /** Retrieves a raw Vulkan handle for this device.
          *
          *  @return As per description
@@ -311,6 +319,20 @@ namespace Anvil
             return m_khr_maintenance3_extension_entrypoints;
         }
 
+        /** Returns a container with entry-points to functions introduced by VK_KHR_push_descriptor extension.
+         *
+         *  vkCmdPushDescriptorSetWithTemplateKHR() is only exposed if VK_KHR_descriptor_update_template is also
+         *  supported by the device.
+         *
+         *  Will fire an assertion failure if the extension was not requested at device creation time.
+         **/
+        const ExtensionKHRPushDescriptorEntrypoints& get_extension_khr_push_descriptor_entrypoints() const
+        {
+            anvil_assert(m_extension_enabled_info_ptr->get_device_extension_info()->khr_push_descriptor() );
+
+            return m_khr_push_descriptor_extension_entrypoints;
+        }
+
         /** Returns a container with entry-points to functions introduced by VK_KHR_sampler_ycbcr_conversion extension. **/
         const ExtensionKHRSamplerYCbCrConversionEntrypoints& get_extension_khr_sampler_ycbcr_conversion_entrypoints() const
         {
@@ -330,6 +352,17 @@ namespace Anvil
             return m_khr_swapchain_extension_entrypoints;
         }
 
+        /** Returns a container with entry-points to functions introduced by VK_KHR_timeline_semaphore extension.
+         *
+         *  Will fire an assertion failure if the extension was not requested at device creation time.
+         **/
+        const ExtensionKHRTimelineSemaphoreEntrypoints& get_extension_khr_timeline_semaphore_entrypoints() const
+        {
+            anvil_assert(m_extension_enabled_info_ptr->get_device_extension_info()->khr_timeline_semaphore() );
+
+            return m_khr_timeline_semaphore_extension_entrypoints;
+        }
+
         /** Retrieves a graphics pipeline manager, created for this device instance.
          *
          *  @return As per description
@@ -475,6 +508,16 @@ namespace Anvil
         virtual bool get_physical_device_surface_capabilities(Anvil::RenderingSurface*    in_surface_ptr,
                                                               Anvil::SurfaceCapabilities* out_result_ptr) const = 0;
 
+        /** Returns the device-level resource release queue. Objects handed over to the queue are destroyed once the GPU
+         *  finishes executing all work submitted prior to the release request. See ResourceReleaseQueue for details.
+         *
+         *  @return As per description
+         **/
+        Anvil::ResourceReleaseQueue* get_resource_release_queue() const
+        {
+            return m_resource_release_queue_ptr.get();
+        }
+
         /** Returns a pipeline cache, created specifically for this device.
          *
          *  @return As per description
@@ -761,9 +804,11 @@ namespace Anvil
         ExtensionKHRGetMemoryRequirements2Entrypoints     m_khr_get_memory_requirements2_extension_entrypoints;
         ExtensionKHRMaintenance1Entrypoints               m_khr_maintenance1_extension_entrypoints;
         ExtensionKHRMaintenance3Entrypoints               m_khr_maintenance3_extension_entrypoints;
+        ExtensionKHRPushDescriptorEntrypoints             m_khr_push_descriptor_extension_entrypoints;
         ExtensionKHRSamplerYCbCrConversionEntrypoints     m_khr_sampler_ycbcr_conversion_extension_entrypoints;
         ExtensionKHRSurfaceEntrypoints                    m_khr_surface_extension_entrypoints;
         ExtensionKHRSwapchainEntrypoints                  m_khr_swapchain_extension_entrypoints;
+        ExtensionKHRTimelineSemaphoreEntrypoints          m_khr_timeline_semaphore_extension_entrypoints;
 
         #if defined(_WIN32)
             ExtensionKHRExternalFenceWin32Entrypoints     m_khr_external_fence_win32_extension_entrypoints;
@@ -785,12 +830,14 @@ namespace Anvil
 
         std::unique_ptr<Anvil::ComputePipelineManager>   m_compute_pipeline_manager_ptr;
         DescriptorSetLayoutManagerUniquePtr              m_descriptor_set_layout_manager_ptr;
+        DescriptorUpdateTemplateCacheUniquePtr           m_descriptor_update_template_cache_ptr;
         mutable Anvil::DescriptorSetGroupUniquePtr       m_dummy_dsg_ptr;
         mutable std::mutex                               m_dummy_dsg_mutex;
         std::unique_ptr<Anvil::ExtensionInfo<bool> >     m_extension_enabled_info_ptr;
         GraphicsPipelineManagerUniquePtr                 m_graphics_pipeline_manager_ptr;
         PipelineCacheUniquePtr                           m_pipeline_cache_ptr;
         PipelineLayoutManagerUniquePtr                   m_pipeline_layout_manager_ptr;
+        ResourceReleaseQueueUniquePtr                    m_resource_release_queue_ptr;
         Anvil::ShaderModuleCacheUniquePtr                m_shader_module_cache_ptr;
 
         std::vector<CommandPoolUniquePtr> m_command_pool_ptr_per_vk_queue_fam;
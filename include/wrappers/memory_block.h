@@ -32,6 +32,11 @@
  *    a number of read & write ops, after which the object can be unmapped.
  *  - provides a way to create derivative memory blocks, whose storage is "carved out" of the
  *    parent memory block's.
+ *  - can keep host-visible memory persistently mapped, so that read() and write() calls do not
+ *    need to map & unmap the underlying storage every time they are invoked.
+ *  - provides write batches, which defer flushing of non-coherent memory regions modified with
+ *    write() until the batch is closed. All dirty regions are then flushed with a single
+ *    vkFlushMappedMemoryRanges() call.
  **/
 #ifndef WRAPPERS_MEMORY_BLOCK_H
 #define WRAPPERS_MEMORY_BLOCK_H
@@ -61,6 +66,18 @@ namespace Anvil
     public:
         /* Public functions */
 
+        /** Opens a write batch. Until a matching end_write_batch() call is made, write() calls will not flush
+         *  modified regions of non-coherent memory. Instead, the regions are accumulated and flushed with
+         *  a single API call at end_write_batch() time. The memory also stays mapped for the batch's lifetime.
+         *
+         *  Write batches can be nested. Modified regions are flushed when the outermost batch is closed.
+         *
+         *  For derived memory blocks, the batch is opened for the root memory block.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool begin_write_batch();
+
         /* TODO
          *
          * @param in_create_info_ptr TODO
@@ -92,6 +109,16 @@ namespace Anvil
         /** Releases the Vulkan counterpart and unregisters the wrapper instance from the object tracker */
         virtual ~MemoryBlock();
 
+        /** Closes a write batch opened with a preceding begin_write_batch() call.
+         *
+         *  If this is the outermost batch, all regions modified while the batch was open are merged, aligned to
+         *  nonCoherentAtomSize and flushed with a single vkFlushMappedMemoryRanges() call. For coherent memory,
+         *  no flush is performed.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool end_write_batch();
+
         const Anvil::MemoryBlockCreateInfo* get_create_info_ptr() const
         {
             return m_create_info_ptr.get();
@@ -125,6 +152,12 @@ namespace Anvil
          *  @return true if intersection has been detected, false otherwise. */
         bool intersects(const Anvil::MemoryBlock* in_memory_block_ptr) const;
 
+        /** Tells whether set_persistently_mapped() has been used to keep the memory block mapped. */
+        bool is_persistently_mapped() const
+        {
+            return m_is_persistently_mapped;
+        }
+
         /** Maps the specified region of the underlying memory object to the process space.
          *
          *  Neither the object, nor its parent(s) is allowed to be mapped
@@ -171,6 +204,39 @@ namespace Anvil
                   VkDeviceSize in_size,
                   void*        out_result_ptr);
 
+        /** Reads data from multiple regions of the memory block. Works like @param in_n_regions read() calls,
+         *  except that for non-coherent memory, all regions are invalidated with a single
+         *  vkInvalidateMappedMemoryRanges() call, after having been merged and aligned to nonCoherentAtomSize.
+         *
+         *  @param in_n_regions         Number of regions to read. Must not be 0.
+         *  @param in_start_offsets_ptr Array of @param in_n_regions start offsets. Must not be nullptr.
+         *  @param in_sizes_ptr         Array of @param in_n_regions region sizes. Must not be nullptr.
+         *  @param out_result_ptrs_ptr  Array of @param in_n_regions pointers to copy the read data to. Must
+         *                              not be nullptr.
+         *
+         *  @return true if the call was successful, false otherwise.
+         **/
+        bool read_batch(uint32_t            in_n_regions,
+                        const VkDeviceSize* in_start_offsets_ptr,
+                        const VkDeviceSize* in_sizes_ptr,
+                        void* const*        out_result_ptrs_ptr);
+
+        /** Opts the memory block in or out of persistent mapping.
+         *
+         *  While persistently mapped, the underlying storage stays mapped into process space, so read(), write()
+         *  and map() calls do not need to call vkMapMemory() and vkUnmapMemory() (or their memory allocator
+         *  backend counterparts) each time they are invoked.
+         *
+         *  Requires the memory block to be host-visible. Works for both memory blocks allocated directly and
+         *  memory blocks provided by a memory allocator backend. For derived memory blocks, the root memory
+         *  block is kept mapped for as long as at least one of its derivatives is persistently mapped.
+         *
+         *  @param in_should_be_persistently_mapped true to keep the memory mapped, false to release the mapping.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool set_persistently_mapped(bool in_should_be_persistently_mapped);
+
         /** Unmaps the mapped storage from the process space.
          *
          *  The call should only be made after a map() call.
@@ -203,6 +269,19 @@ namespace Anvil
                    VkDeviceSize in_size,
                    const void*  in_data);
 
+        /** Works like write(), except that data is produced by @param in_producer_function directly in the mapped
+         *  region, instead of being copied from a user-specified location.
+         *
+         *  @param in_start_offset      Start offset of the region to modify.
+         *  @param in_size              Size of the region to be modified.
+         *  @param in_producer_function Function to call with a pointer to the mapped region. Must not be nullptr.
+         *
+         *  @return true if the call was successful, false otherwise.
+         **/
+        bool write_with_producer(VkDeviceSize                       in_start_offset,
+                                 VkDeviceSize                       in_size,
+                                 const MemoryWriteProducerFunction& in_producer_function);
+
     private:
         /* Private functions */
 
@@ -220,10 +299,34 @@ namespace Anvil
         MemoryBlock           (const MemoryBlock&);
         MemoryBlock& operator=(const MemoryBlock&);
 
-        void     close_gpu_memory_access     ();
-        uint32_t get_device_memory_type_index(uint32_t                  in_memory_type_bits,
-                                              Anvil::MemoryFeatureFlags in_memory_features);
-        bool     open_gpu_memory_access      ();
+        /* Private type definitions */
+        typedef struct MappedRange
+        {
+            VkDeviceSize start_offset;
+            VkDeviceSize end_offset;
+
+            MappedRange(VkDeviceSize in_start_offset,
+                        VkDeviceSize in_end_offset)
+                :start_offset(in_start_offset),
+                 end_offset  (in_end_offset)
+            {
+                /* Stub */
+            }
+
+            bool operator<(const MappedRange& in_range) const
+            {
+                return start_offset < in_range.start_offset;
+            }
+        } MappedRange;
+
+        void                close_gpu_memory_access     ();
+        bool                flush_or_invalidate_ranges  (bool                      in_should_flush,
+                                                         uint32_t                  in_n_ranges,
+                                                         const MappedRange*        in_ranges_ptr);
+        uint32_t            get_device_memory_type_index(uint32_t                  in_memory_type_bits,
+                                                         Anvil::MemoryFeatureFlags in_memory_features);
+        Anvil::MemoryBlock* get_root_memory_block       ();
+        bool                open_gpu_memory_access      ();
 
         /* IMemoryBlockBackendSupport */
         void set_parent_memory_allocator_backend_ptr(std::shared_ptr<Anvil::IMemoryAllocatorBackendBase> in_backend_ptr,
@@ -252,8 +355,12 @@ namespace Anvil
         }
 
         /* Private members */
-        std::atomic<uint32_t> m_gpu_data_map_count; /* Only set for root memory blocks */
-        void*                 m_gpu_data_ptr;       /* Only set for root memory blocks */
+        std::atomic<uint32_t>    m_gpu_data_map_count;        /* Only set for root memory blocks */
+        void*                    m_gpu_data_ptr;              /* Only set for root memory blocks */
+        uint32_t                 m_n_open_write_batches;      /* Only set for root memory blocks */
+        std::vector<MappedRange> m_write_batch_dirty_ranges;  /* Only set for root memory blocks */
+
+        bool m_is_persistently_mapped;
 
         void*                                 m_backend_object;
         Anvil::MemoryBlockCreateInfoUniquePtr m_create_info_ptr;
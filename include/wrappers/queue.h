@@ -159,6 +159,16 @@ namespace Anvil
             return m_queue_family_index;
         }
 
+        /** Retrieves the submission tracking value reached so far by the queue. Any resource, whose last use has been
+         *  submitted before get_submission_tracking_value() returned a value lower than or equal to this one, is no longer
+         *  in use by the GPU.
+         *
+         *  @param out_result_ptr Deref will be set to the value. Must not be nullptr.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool get_completed_submission_tracking_value(uint64_t* out_result_ptr) const;
+
         /** Retrieves global priority used to create the queue.
          *
          *  Only meaningful if VK_EXT_queue_global_priority if supported.
@@ -174,6 +184,19 @@ namespace Anvil
             return m_queue_index;
         }
 
+        /** Returns a submission tracking value, which the queue is going to reach once all work submitted to the queue
+         *  so far finishes executing. See get_completed_submission_tracking_value() and wait_for_submission_tracking_value().
+         *
+         *  Submission tracking is opt-in. The first call creates the tracking timeline and signals a value which covers
+         *  all work submitted so far. From then on, every submit() and bind_sparse_memory() call signals the next tracking
+         *  value as part of the submission, and subsequent calls do not submit any work to the queue. Queues whose
+         *  tracking value is never queried do not pay for the signal operations.
+         *
+         *  @return As per description. If the tracking timeline could not be created, the function waits for the queue
+         *          to become idle and returns 0.
+         **/
+        uint64_t get_submission_tracking_value();
+
         /** Inserts a single queue debug label.
          *
          *  Requires VK_EXT_debug_utils support. Otherwise, the call is moot.
@@ -292,10 +315,26 @@ namespace Anvil
             return m_supports_sparse_bindings;
         }
 
+        /** Blocks until the queue reaches submission tracking value @param in_value or the timeout expires.
+         *
+         *  @param in_value   Value to wait for. Must have been returned by a preceding get_submission_tracking_value() call.
+         *  @param in_timeout Timeout, expressed in nanoseconds.
+         *
+         *  @return true if the value has been reached, false otherwise.
+         **/
+        bool wait_for_submission_tracking_value(uint64_t in_value,
+                                                uint64_t in_timeout = UINT64_MAX) const;
+
         void wait_idle();
 
     private:
         /* Private functions */
+        Anvil::FenceUniquePtr acquire_submission_tracking_fence (const Anvil::Fence*   in_opt_batch_fence_ptr);
+        bool                  init_submission_tracking_semaphore();
+        bool                  is_submission_tracking_enabled    () const;
+        bool                  signal_submission_tracking_value  (uint64_t              in_value,
+                                                                 Anvil::FenceUniquePtr in_opt_submitted_fence_ptr);
+
         bool present_internal   (Anvil::DeviceGroupPresentModeFlagBits in_presentation_mode,
                                  uint32_t                              in_n_swapchains,
                                  Anvil::Swapchain* const*              in_swapchains,
@@ -349,6 +388,10 @@ namespace Anvil
         Anvil::FenceUniquePtr            m_submit_fence_ptr;
         bool                             m_supports_protected_memory_operations;
         bool                             m_supports_sparse_bindings;
+
+        mutable std::mutex                m_submission_tracking_mutex;
+        Anvil::TimelineSemaphoreUniquePtr m_submission_tracking_semaphore_ptr;
+        uint64_t                          m_submission_tracking_value;
     };
 }; /* namespace Anvil */
 
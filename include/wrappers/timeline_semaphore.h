@@ -0,0 +1,241 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/** Implements a wrapper for a single Vulkan timeline semaphore. Implemented in order to:
+ *
+ *  - simplify life-time management of timeline semaphores.
+ *  - let ObjectTracker detect leaking timeline semaphore instances.
+ *  - provide a fall-back implementation for devices which do not support VK_KHR_timeline_semaphore.
+ *
+ *  A timeline semaphore carries a monotonically increasing 64-bit counter value. The value can be
+ *  signalled & waited upon both from the host and from queue submissions (see SubmitInfo::set_timeline_semaphores()).
+ *  This lets the app track completion of a whole stream of submissions with a single object, instead
+ *  of juggling an array of per-frame fences.
+ *
+ *  If VK_KHR_timeline_semaphore has not been enabled for the device, the wrapper emulates the timeline:
+ *
+ *  - Each queue-side signal operation is backed by a fence, submitted right after the batch which signals
+ *    the semaphore. Fences are recycled once signalled.
+ *  - Queue-side wait operations are performed on the host by Queue::submit() before the batch is submitted.
+ *    Wait-before-signal is NOT supported: the signal operation the wait depends on must have already been
+ *    submitted or performed from the host by the time Queue::submit() is called. Otherwise, Queue::submit()
+ *    fails and returns false without submitting anything. If the signal operation has been submitted, but has
+ *    not completed yet, Queue::submit() blocks the calling thread until it does.
+ *  - get_semaphore() returns VK_NULL_HANDLE.
+ *
+ *  Host-side signal & wait operations, as well as value queries, are thread-safe for emulated timeline semaphores.
+ **/
+#ifndef WRAPPERS_TIMELINE_SEMAPHORE_H
+#define WRAPPERS_TIMELINE_SEMAPHORE_H
+
+#include "misc/debug_marker.h"
+#include "misc/mt_safety.h"
+#include "misc/types.h"
+#include <condition_variable>
+#include <deque>
+
+namespace Anvil
+{
+    /* Wrapper class for Vulkan timeline semaphores */
+    class TimelineSemaphore : public DebugMarkerSupportProvider<TimelineSemaphore>,
+                              public MTSafetySupportProvider
+    {
+    public:
+        /* Public functions */
+
+        /** Creates a single timeline semaphore instance and registers the object in Object Tracker.
+         *
+         *  If VK_KHR_timeline_semaphore is not enabled for @param in_device_ptr, an emulated timeline semaphore
+         *  is created instead. Please see the header for more details.
+         *
+         *  @param in_device_ptr    Device to create the semaphore for. Must not be null.
+         *  @param in_initial_value Initial counter value.
+         *  @param in_mt_safety     MT safety setting to use.
+         *
+         *  @return New instance if successful, null otherwise.
+         **/
+        static Anvil::TimelineSemaphoreUniquePtr create(const Anvil::BaseDevice* in_device_ptr,
+                                                        uint64_t                 in_initial_value = 0,
+                                                        MTSafety                 in_mt_safety     = Anvil::MTSafety::INHERIT_FROM_PARENT_DEVICE);
+
+        /** Destructor.
+         *
+         *  Destroys the Vulkan counterpart and unregisters the wrapper instance from the Object Tracker.
+         *  For emulated semaphores, waits until all pending queue-side signal operations complete.
+         **/
+        virtual ~TimelineSemaphore();
+
+        const Anvil::BaseDevice* get_device() const
+        {
+            return m_device_ptr;
+        }
+
+        /** Retrieves a raw handle to the underlying Vulkan semaphore instance.
+         *
+         *  Returns VK_NULL_HANDLE for emulated timeline semaphores.
+         */
+        VkSemaphore get_semaphore() const
+        {
+            return m_semaphore;
+        }
+
+        /** Retrieves a pointer to a raw handle of the underlying Vulkan semaphore instance */
+        const VkSemaphore* get_semaphore_ptr() const
+        {
+            return &m_semaphore;
+        }
+
+        /** Returns the current counter value of the semaphore.
+         *
+         *  @param out_value_ptr Deref will be set to the current counter value if the function succeeds. Must not be null.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool get_value(uint64_t* out_value_ptr);
+
+        /** Tells whether the timeline is emulated with fences, because VK_KHR_timeline_semaphore is not
+         *  supported by the device.
+         **/
+        bool is_emulated() const
+        {
+            return (m_semaphore == VK_NULL_HANDLE);
+        }
+
+        /** Sets the counter value of the semaphore from the host.
+         *
+         *  @param in_value New value. Must be larger than the current counter value, and than the values of any
+         *                  pending queue-side signal operations.
+         *
+         *  @return true if successful, false otherwise.
+         **/
+        bool signal(uint64_t in_value);
+
+        /** Blocks until the counter value of the semaphore becomes at least @param in_value, or until the timeout
+         *  expires.
+         *
+         *  @param in_value   Value to wait for.
+         *  @param in_timeout Timeout in nanoseconds.
+         *
+         *  @return true if the semaphore reached the requested value, false if the timeout expired or an error occurred.
+         **/
+        bool wait(uint64_t in_value,
+                  uint64_t in_timeout = UINT64_MAX);
+
+        /** Blocks until all (or any, if @param in_wait_all is false) of the specified semaphores reach the
+         *  corresponding values, or until the timeout expires.
+         *
+         *  All semaphores must have been created for @param in_device_ptr.
+         *
+         *  @param in_device_ptr      Device the semaphores have been created for. Must not be null.
+         *  @param in_n_semaphores    Number of semaphores to wait on. Must not be 0.
+         *  @param in_semaphore_ptrs  Array of @param in_n_semaphores semaphores to wait on. Must not be null.
+         *  @param in_values          Array of @param in_n_semaphores values to wait for. Must not be null.
+         *  @param in_wait_all        true to wait for all semaphores, false to wait for any of them.
+         *  @param in_timeout         Timeout in nanoseconds.
+         *
+         *  @return true if the wait condition was satisfied, false if the timeout expired or an error occurred.
+         **/
+        static bool wait_multiple(const Anvil::BaseDevice*         in_device_ptr,
+                                  uint32_t                         in_n_semaphores,
+                                  Anvil::TimelineSemaphore* const* in_semaphore_ptrs,
+                                  const uint64_t*                  in_values,
+                                  bool                             in_wait_all,
+                                  uint64_t                         in_timeout = UINT64_MAX);
+
+    private:
+        /* Private type definitions */
+        typedef struct PendingSignal
+        {
+            Anvil::FenceUniquePtr fence_ptr;
+            uint64_t              value;
+
+            PendingSignal(Anvil::FenceUniquePtr in_fence_ptr,
+                          uint64_t              in_value)
+                :fence_ptr(std::move(in_fence_ptr) ),
+                 value    (in_value)
+            {
+                /* Stub */
+            }
+        } PendingSignal;
+
+        /* Private functions */
+
+        /* Constructor. Please see create() for specification */
+        TimelineSemaphore(const Anvil::BaseDevice* in_device_ptr,
+                          uint64_t                 in_initial_value,
+                          MTSafety                 in_mt_safety);
+
+        bool init(uint64_t in_initial_value);
+
+        /* Tells whether the emulated counter value has already reached @param in_value, or a pending queue-side
+         * signal operation is going to make it reach the value. Used by Queue::submit() to reject wait-before-signal
+         * submissions, which cannot be emulated.
+         */
+        bool is_emulated_value_reachable(uint64_t in_value);
+
+        /* Returns an unsignalled fence, which the caller can submit together with a batch and then hand back with
+         * enqueue_emulated_signal_fence(). Recycles a retired fence if possible.
+         *
+         * Returns nullptr if the fence could not be created.
+         */
+        Anvil::FenceUniquePtr acquire_emulation_fence();
+
+        /* Called back by Queue::submit() right after a batch which signals the emulated semaphore is submitted.
+         *
+         * Submits a fence to @param in_queue_vk which is going to be signalled once all prior work submitted
+         * to the queue completes, and associates it with @param in_value.
+         *
+         * The queue must be locked by the caller.
+         */
+        bool enqueue_emulated_signal(VkQueue  in_queue_vk,
+                                     uint64_t in_value);
+
+        /* Associates @param in_value with @param in_fence_ptr, which must have been returned by acquire_emulation_fence()
+         * and already been submitted. Used by Queue to signal the emulated semaphore without an additional submission.
+         */
+        void enqueue_emulated_signal_fence(Anvil::FenceUniquePtr in_fence_ptr,
+                                           uint64_t              in_value);
+
+        /* Retires pending signal operations whose fences have already been signalled.
+         *
+         * Emulation mutex must be locked by the caller.
+         */
+        void update_emulated_value();
+
+        /* Private variables */
+        VkSemaphore m_semaphore;
+
+        std::condition_variable            m_emulation_cv;
+        std::vector<Anvil::FenceUniquePtr> m_emulation_free_fences;
+        std::mutex                         m_emulation_mutex;
+        uint32_t                           m_emulation_n_waiters;
+        std::deque<PendingSignal>          m_emulation_pending_signals;
+        uint64_t                           m_emulation_value;
+
+        friend class Anvil::Queue;
+
+        ANVIL_DISABLE_ASSIGNMENT_OPERATOR(TimelineSemaphore);
+        ANVIL_DISABLE_COPY_CONSTRUCTOR(TimelineSemaphore);
+    };
+}; /* namespace Anvil */
+
+#endif /* WRAPPERS_TIMELINE_SEMAPHORE_H */
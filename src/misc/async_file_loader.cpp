@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/async_file_loader.h"
+#include "misc/debug.h"
+
+
+/* Please see header for specification */
+Anvil::AsyncFileLoader::AsyncFileLoader()
+    :m_n_pending_requests(0),
+     m_terminating       (false)
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::AsyncFileLoader::~AsyncFileLoader()
+{
+    {
+        std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+        m_terminating = true;
+    }
+
+    m_request_submitted_cv.notify_all();
+
+    /* I/O threads drain the request queue before they quit. */
+    for (auto& current_thread : m_threads)
+    {
+        if (current_thread.joinable() )
+        {
+            current_thread.join();
+        }
+    }
+
+    anvil_assert(m_requests.empty() );
+}
+
+/* Please see header for specification */
+Anvil::AsyncFileLoaderUniquePtr Anvil::AsyncFileLoader::create(uint32_t in_n_threads)
+{
+    Anvil::AsyncFileLoaderUniquePtr result_ptr(nullptr,
+                                               std::default_delete<Anvil::AsyncFileLoader>() );
+
+    result_ptr.reset(
+        new Anvil::AsyncFileLoader()
+    );
+
+    if (result_ptr != nullptr)
+    {
+        if (!result_ptr->init(in_n_threads) )
+        {
+            result_ptr.reset();
+        }
+    }
+
+    return result_ptr;
+}
+
+/* Please see header for specification */
+uint32_t Anvil::AsyncFileLoader::get_n_pending_requests() const
+{
+    std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+    return m_n_pending_requests;
+}
+
+/** Spawns I/O threads.
+ *
+ *  @param in_n_threads Number of threads to spawn. Must not be 0.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::AsyncFileLoader::init(uint32_t in_n_threads)
+{
+    bool result = false;
+
+    if (in_n_threads == 0)
+    {
+        anvil_assert(in_n_threads != 0);
+
+        goto end;
+    }
+
+    for (uint32_t n_thread = 0;
+                  n_thread < in_n_threads;
+                ++n_thread)
+    {
+        m_threads.push_back(
+            std::thread(&AsyncFileLoader::thread_main,
+                        this)
+        );
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::AsyncFileLoader::load(const std::string&                   in_filename,
+                                  const AsyncFileLoadCallbackFunction& in_callback,
+                                  bool                                 in_prefetch)
+{
+    bool result = false;
+
+    if (in_callback == nullptr)
+    {
+        anvil_assert(in_callback != nullptr);
+
+        goto end;
+    }
+
+    {
+        std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+        if (m_terminating)
+        {
+            anvil_assert(!m_terminating);
+
+            goto end;
+        }
+
+        m_requests.push_back(
+            Request(in_filename,
+                    in_callback,
+                    in_prefetch)
+        );
+
+        ++m_n_pending_requests;
+    }
+
+    m_request_submitted_cv.notify_one();
+
+    result = true;
+end:
+    return result;
+}
+
+/** Entry-point of an I/O thread.
+ *
+ *  Picks up requests one at a time, until the loader is being destroyed and there are no more
+ *  requests left to handle.
+ **/
+void Anvil::AsyncFileLoader::thread_main()
+{
+    while (true)
+    {
+        Anvil::MappedFileUniquePtr mapped_file_ptr;
+        std::unique_ptr<Request>   request_ptr;
+
+        {
+            std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+            m_request_submitted_cv.wait(mutex_lock,
+                                        [this]()
+                                        {
+                                            return m_terminating       ||
+                                                   !m_requests.empty();
+                                        });
+
+            if (m_requests.empty() )
+            {
+                anvil_assert(m_terminating);
+
+                break;
+            }
+
+            request_ptr.reset(
+                new Request(std::move(m_requests.front() ) )
+            );
+
+            m_requests.pop_front();
+        }
+
+        /* Mapping the file & faulting its pages in is the part which may block on disk I/O, so do
+         * it without holding the lock. */
+        mapped_file_ptr = Anvil::MappedFile::create(request_ptr->filename,
+                                                    request_ptr->prefetch);
+
+        request_ptr->callback(request_ptr->filename,
+                              std::move(mapped_file_ptr) );
+
+        {
+            std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+            anvil_assert(m_n_pending_requests > 0);
+
+            if (--m_n_pending_requests == 0)
+            {
+                m_idle_cv.notify_all();
+            }
+        }
+    }
+}
+
+/* Please see header for specification */
+void Anvil::AsyncFileLoader::wait_idle()
+{
+    std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+    m_idle_cv.wait(mutex_lock,
+                   [this]()
+                   {
+                       return (m_n_pending_requests == 0);
+                   });
+}
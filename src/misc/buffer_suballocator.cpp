@@ -0,0 +1,298 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/buffer_create_info.h"
+#include "misc/buffer_suballocator.h"
+#include "misc/debug.h"
+#include "wrappers/buffer.h"
+#include "wrappers/device.h"
+#include "wrappers/physical_device.h"
+#include <algorithm>
+#include <functional>
+
+/* Please see header for specification */
+Anvil::BufferSubAllocator::BufferSubAllocator(Anvil::Buffer* in_parent_buffer_ptr,
+                                              VkDeviceSize   in_block_size)
+    :m_block_size               (in_block_size),
+     m_bump_offset              (0),
+     m_n_allocations            (0),
+     m_non_empty_size_class_mask(0),
+     m_parent_buffer_ptr        (in_parent_buffer_ptr),
+     m_parent_buffer_size       (in_parent_buffer_ptr->get_create_info_ptr()->get_size() ),
+     m_used_size                (0)
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::BufferSubAllocator::~BufferSubAllocator()
+{
+    /* Child buffers call back into this instance when released, so they must not outlive it */
+    anvil_assert(m_n_allocations == 0);
+}
+
+/* Please see header for specification */
+Anvil::BufferUniquePtr Anvil::BufferSubAllocator::allocate(VkDeviceSize in_size,
+                                                           VkDeviceSize in_alignment)
+{
+    Anvil::BufferUniquePtr child_buffer_ptr (nullptr,
+                                             std::default_delete<Anvil::Buffer>() );
+    VkDeviceSize           class_size       (0);
+    bool                   is_reserved      (false);
+    VkDeviceSize           offset           (0);
+    Anvil::BufferUniquePtr result_ptr       (nullptr,
+                                             std::default_delete<Anvil::Buffer>() );
+    uint32_t               size_class       (UINT32_MAX);
+
+    anvil_assert(in_size != 0);
+    anvil_assert(Anvil::Utils::is_pow2(in_alignment) );
+
+    if (in_size      == 0            ||
+        in_alignment >  m_block_size)
+    {
+        /* Every range handed out starts at a multiple of the block size, so stricter alignments cannot be honored */
+        anvil_assert(in_alignment <= m_block_size);
+
+        goto end;
+    }
+
+    size_class = get_size_class(in_size);
+
+    if (size_class >= N_MAX_SIZE_CLASSES)
+    {
+        goto end;
+    }
+
+    class_size = m_block_size << size_class;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (m_free_offsets[size_class].size() > 0)
+        {
+            /* 1. Reuse a previously released range of matching size class. */
+            offset = m_free_offsets[size_class].back();
+
+            m_free_offsets[size_class].pop_back();
+
+            if (m_free_offsets[size_class].size() == 0)
+            {
+                m_non_empty_size_class_mask &= ~(1ull << size_class);
+            }
+
+            is_reserved = true;
+        }
+        else
+        if (m_bump_offset              <= m_parent_buffer_size &&
+            m_parent_buffer_size - m_bump_offset >= class_size)
+        {
+            /* 2. Carve a new range out of the untouched tail of the parent buffer. */
+            offset         = m_bump_offset;
+            m_bump_offset += class_size;
+            is_reserved    = true;
+        }
+        else
+        {
+            /* 3. Split the smallest free range of a larger size class. The range is cut in halves, until a range of
+             *    the requested size class is obtained. All the halves that are not needed are moved to the free lists
+             *    of the corresponding, smaller size classes.
+             */
+            for (uint32_t n_larger_size_class = size_class + 1;
+                          n_larger_size_class < N_MAX_SIZE_CLASSES;
+                        ++n_larger_size_class)
+            {
+                if ((m_non_empty_size_class_mask & (1ull << n_larger_size_class)) == 0)
+                {
+                    continue;
+                }
+
+                offset = m_free_offsets[n_larger_size_class].back();
+
+                m_free_offsets[n_larger_size_class].pop_back();
+
+                if (m_free_offsets[n_larger_size_class].size() == 0)
+                {
+                    m_non_empty_size_class_mask &= ~(1ull << n_larger_size_class);
+                }
+
+                for (uint32_t n_split_size_class = size_class;
+                              n_split_size_class < n_larger_size_class;
+                            ++n_split_size_class)
+                {
+                    m_free_offsets[n_split_size_class].push_back(offset + (m_block_size << n_split_size_class) );
+
+                    m_non_empty_size_class_mask |= (1ull << n_split_size_class);
+                }
+
+                is_reserved = true;
+                break;
+            }
+        }
+
+        if (is_reserved)
+        {
+            ++m_n_allocations;
+
+            m_used_size += class_size;
+        }
+    }
+
+    if (!is_reserved)
+    {
+        goto end;
+    }
+
+    child_buffer_ptr = Anvil::Buffer::create(
+        Anvil::BufferCreateInfo::create_no_alloc_child(m_parent_buffer_ptr,
+                                                       offset,
+                                                       in_size)
+    );
+
+    if (child_buffer_ptr == nullptr)
+    {
+        anvil_assert(child_buffer_ptr != nullptr);
+
+        on_child_released(nullptr,
+                          offset,
+                          size_class);
+
+        goto end;
+    }
+
+    result_ptr = Anvil::BufferUniquePtr(child_buffer_ptr.release(),
+                                        std::bind(&BufferSubAllocator::on_child_released,
+                                                  this,
+                                                  std::placeholders::_1,
+                                                  offset,
+                                                  size_class) );
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+Anvil::BufferSubAllocatorUniquePtr Anvil::BufferSubAllocator::create(Anvil::Buffer* in_parent_buffer_ptr,
+                                                                     VkDeviceSize   in_min_block_size)
+{
+    VkDeviceSize                       block_size(in_min_block_size);
+    Anvil::BufferSubAllocatorUniquePtr result_ptr(nullptr,
+                                                  std::default_delete<Anvil::BufferSubAllocator>() );
+
+    anvil_assert(in_parent_buffer_ptr != nullptr);
+
+    if (block_size == 0)
+    {
+        const auto& limits(in_parent_buffer_ptr->get_create_info_ptr()->get_device()->get_physical_device_properties().core_vk1_0_properties_ptr->limits);
+
+        block_size = std::max(std::max(limits.min_uniform_buffer_offset_alignment,
+                                       limits.min_storage_buffer_offset_alignment),
+                              std::max(limits.min_texel_buffer_offset_alignment,
+                                       static_cast<VkDeviceSize>(16) ));
+
+        /* Alignments reported by the device are powers-of-two, but stay on the safe side. */
+        while (!Anvil::Utils::is_pow2(block_size) )
+        {
+            block_size += (block_size & (~block_size + 1) );
+        }
+    }
+
+    if (!Anvil::Utils::is_pow2(block_size) )
+    {
+        anvil_assert(Anvil::Utils::is_pow2(block_size) );
+
+        goto end;
+    }
+
+    result_ptr.reset(
+        new Anvil::BufferSubAllocator(in_parent_buffer_ptr,
+                                      block_size)
+    );
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+uint32_t Anvil::BufferSubAllocator::get_n_allocations() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    return m_n_allocations;
+}
+
+/** Returns the size class, whose ranges are large enough to hold @param in_size bytes.
+ *
+ *  @param in_size Number of bytes to allocate. Must not be 0.
+ *
+ *  @return Index of the size class. Ranges of size class N take (block size << N) bytes.
+ **/
+uint32_t Anvil::BufferSubAllocator::get_size_class(VkDeviceSize in_size) const
+{
+    const VkDeviceSize n_blocks  ((in_size + m_block_size - 1) / m_block_size);
+    uint32_t           result    (0);
+
+    while (result                       <  N_MAX_SIZE_CLASSES &&
+           (VkDeviceSize(1) << result)  <  n_blocks)
+    {
+        ++result;
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+VkDeviceSize Anvil::BufferSubAllocator::get_used_size() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    return m_used_size;
+}
+
+/** Deleter assigned to all child buffers returned by allocate(). Destroys the child buffer and returns
+ *  its range to the free list of the size class it was allocated from.
+ *
+ *  @param in_child_buffer_ptr Child buffer to destroy. May be nullptr.
+ *  @param in_start_offset     Start offset of the range, relative to the parent buffer's storage.
+ *  @param in_size_class       Size class the range was allocated from.
+ **/
+void Anvil::BufferSubAllocator::on_child_released(Anvil::Buffer* in_child_buffer_ptr,
+                                                  VkDeviceSize   in_start_offset,
+                                                  uint32_t       in_size_class)
+{
+    if (in_child_buffer_ptr != nullptr)
+    {
+        delete in_child_buffer_ptr;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        anvil_assert(m_n_allocations > 0);
+
+        m_free_offsets[in_size_class].push_back(in_start_offset);
+
+        m_non_empty_size_class_mask |= (1ull << in_size_class);
+        m_used_size                 -= (m_block_size << in_size_class);
+
+        --m_n_allocations;
+    }
+}
@@ -0,0 +1,1382 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/buffer_create_info.h"
+#include "misc/compute_pipeline_create_info.h"
+#include "misc/compute_primitives.h"
+#include "misc/debug.h"
+#include "misc/descriptor_set_create_info.h"
+#include "misc/glsl_to_spirv.h"
+#include "wrappers/buffer.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/compute_pipeline_manager.h"
+#include "wrappers/descriptor_set.h"
+#include "wrappers/descriptor_set_group.h"
+#include "wrappers/device.h"
+#include "wrappers/shader_module.h"
+
+/* Number of invocations in a single workgroup. */
+#define WORKGROUP_SIZE (256)
+
+/* Number of elements processed by a single invocation. */
+#define ELEMENTS_PER_THREAD (4)
+
+/* Number of elements processed by a single workgroup. */
+#define BLOCK_SIZE (WORKGROUP_SIZE * ELEMENTS_PER_THREAD)
+
+/* Maximum number of scan levels. Four levels of 1024-element blocks cover the whole uint32 range. */
+#define MAX_SCAN_LEVELS (4)
+
+/* Radix sort configuration. */
+#define RADIX_BITS_PER_PASS (4)
+#define RADIX_N_DIGITS      (1 << RADIX_BITS_PER_PASS)
+#define RADIX_N_PASSES      (32 / RADIX_BITS_PER_PASS)
+
+/* Subgroups smaller than this are not used. Determines the size of the shared array holding per-subgroup totals. */
+#define MIN_SUBGROUP_SIZE (16)
+
+/* Push constant flags. Must match the shader. */
+#define FLAG_INCLUSIVE         (1 << 0)
+#define FLAG_WRITE_OUTPUT      (1 << 1)
+#define FLAG_WRITE_BLOCK_TOTAL (1 << 2)
+#define FLAG_SCATTER_VALUES    (1 << 3)
+
+/* Bindings used by all kernels. The meaning of each binding depends on the kernel; unused bindings are
+ * filled with a dummy buffer. */
+#define BINDING_INPUT         (0)
+#define BINDING_OUTPUT        (1)
+#define BINDING_AUX           (2)
+#define BINDING_INPUT_VALUES  (3)
+#define BINDING_OUTPUT_VALUES (4)
+#define N_BINDINGS            (5)
+
+#define PUSH_CONSTANTS_SIZE (sizeof(uint32_t) * 4)
+
+
+/* All kernels live in a single source. KERNEL, OP, USE_SUBGROUPS and the configuration defines are injected
+ * with add_definition_value_pair() at compilation time.
+ *
+ * Kernel values must match the order of ComputePrimitive::Kernel.
+ */
+static const char* g_glsl_compute_primitives =
+    "#version 450\n"
+    "\n"
+    "#define KERNEL_ADD_BLOCK_TOTALS     0\n"
+    "#define KERNEL_COMPACT_SCATTER      1\n"
+    "#define KERNEL_RADIX_COUNT          2\n"
+    "#define KERNEL_RADIX_SCATTER        3\n"
+    "#define KERNEL_SCAN_BLOCK           4\n"
+    "#define KERNEL_SCAN_BLOCK_PREDICATE 5\n"
+    "\n"
+    "#define FLAG_INCLUSIVE         1u\n"
+    "#define FLAG_WRITE_OUTPUT      2u\n"
+    "#define FLAG_WRITE_BLOCK_TOTAL 4u\n"
+    "#define FLAG_SCATTER_VALUES    8u\n"
+    "\n"
+    "#if OP == 0\n"
+    "    #define IDENTITY                 0u\n"
+    "    #define COMBINE(a, b)            ((a) + (b))\n"
+    "    #define SUBGROUP_EXCLUSIVE(a)    subgroupExclusiveAdd(a)\n"
+    "    #define SUBGROUP_INCLUSIVE(a)    subgroupInclusiveAdd(a)\n"
+    "#elif OP == 1\n"
+    "    #define IDENTITY                 0u\n"
+    "    #define COMBINE(a, b)            max(a, b)\n"
+    "    #define SUBGROUP_EXCLUSIVE(a)    subgroupExclusiveMax(a)\n"
+    "    #define SUBGROUP_INCLUSIVE(a)    subgroupInclusiveMax(a)\n"
+    "#else\n"
+    "    #define IDENTITY                 0xFFFFFFFFu\n"
+    "    #define COMBINE(a, b)            min(a, b)\n"
+    "    #define SUBGROUP_EXCLUSIVE(a)    subgroupExclusiveMin(a)\n"
+    "    #define SUBGROUP_INCLUSIVE(a)    subgroupInclusiveMin(a)\n"
+    "#endif\n"
+    "\n"
+    "layout(local_size_x = WORKGROUP_SIZE) in;\n"
+    "\n"
+    "/* x: number of elements, y: flags, z: radix shift, w: number of blocks */\n"
+    "layout(push_constant) uniform Params\n"
+    "{\n"
+    "    uvec4 params;\n"
+    "};\n"
+    "\n"
+    "layout(std430, set = 0, binding = 0) buffer InputData        { uint input_data[];         };\n"
+    "layout(std430, set = 0, binding = 1) buffer OutputData       { uint output_data[];        };\n"
+    "layout(std430, set = 0, binding = 2) buffer AuxData          { uint aux_data[];           };\n"
+    "layout(std430, set = 0, binding = 3) buffer InputValuesData  { uint input_values_data[];  };\n"
+    "layout(std430, set = 0, binding = 4) buffer OutputValuesData { uint output_values_data[]; };\n"
+    "\n"
+    "#if USE_SUBGROUPS\n"
+    "    /* Assumes invocations are assigned to subgroups in local invocation index order, and that all subgroups are full. */\n"
+    "    shared uint s_subgroup_prefixes[WORKGROUP_SIZE / MIN_SUBGROUP_SIZE];\n"
+    "    shared uint s_total;\n"
+    "\n"
+    "    uint workgroup_exclusive_scan(uint value, out uint total)\n"
+    "    {\n"
+    "        const uint subgroup_exclusive = SUBGROUP_EXCLUSIVE(value);\n"
+    "        const uint subgroup_inclusive = COMBINE(subgroup_exclusive, value);\n"
+    "        uint       result;\n"
+    "\n"
+    "        if (gl_SubgroupInvocationID == gl_SubgroupSize - 1)\n"
+    "        {\n"
+    "            s_subgroup_prefixes[gl_SubgroupID] = subgroup_inclusive;\n"
+    "        }\n"
+    "\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        if (gl_SubgroupID == 0)\n"
+    "        {\n"
+    "            const bool is_active       = (gl_SubgroupInvocationID < gl_NumSubgroups);\n"
+    "            const uint subgroup_total  = (is_active) ? s_subgroup_prefixes[gl_SubgroupInvocationID] : IDENTITY;\n"
+    "            const uint subgroup_prefix = SUBGROUP_EXCLUSIVE(subgroup_total);\n"
+    "\n"
+    "            if (is_active)\n"
+    "            {\n"
+    "                s_subgroup_prefixes[gl_SubgroupInvocationID] = subgroup_prefix;\n"
+    "            }\n"
+    "\n"
+    "            if (gl_SubgroupInvocationID == gl_SubgroupSize - 1)\n"
+    "            {\n"
+    "                s_total = COMBINE(subgroup_prefix, subgroup_total);\n"
+    "            }\n"
+    "        }\n"
+    "\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        result = COMBINE(s_subgroup_prefixes[gl_SubgroupID], subgroup_exclusive);\n"
+    "        total  = s_total;\n"
+    "\n"
+    "        /* Make sure all invocations have read the results before shared memory is reused. */\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        return result;\n"
+    "    }\n"
+    "#else\n"
+    "    shared uint s_scan[WORKGROUP_SIZE];\n"
+    "\n"
+    "    /* Work-efficient (Blelloch) up-sweep / down-sweep scan. */\n"
+    "    uint workgroup_exclusive_scan(uint value, out uint total)\n"
+    "    {\n"
+    "        const uint lid    = gl_LocalInvocationID.x;\n"
+    "        uint       offset = 1;\n"
+    "        uint       result;\n"
+    "\n"
+    "        s_scan[lid] = value;\n"
+    "\n"
+    "        for (uint d = WORKGROUP_SIZE >> 1; d > 0; d >>= 1)\n"
+    "        {\n"
+    "            memoryBarrierShared();\n"
+    "            barrier();\n"
+    "\n"
+    "            if (lid < d)\n"
+    "            {\n"
+    "                const uint ai = offset * (2 * lid + 1) - 1;\n"
+    "                const uint bi = offset * (2 * lid + 2) - 1;\n"
+    "\n"
+    "                s_scan[bi] = COMBINE(s_scan[ai], s_scan[bi]);\n"
+    "            }\n"
+    "\n"
+    "            offset <<= 1;\n"
+    "        }\n"
+    "\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        total = s_scan[WORKGROUP_SIZE - 1];\n"
+    "\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        if (lid == 0)\n"
+    "        {\n"
+    "            s_scan[WORKGROUP_SIZE - 1] = IDENTITY;\n"
+    "        }\n"
+    "\n"
+    "        for (uint d = 1; d < WORKGROUP_SIZE; d <<= 1)\n"
+    "        {\n"
+    "            offset >>= 1;\n"
+    "\n"
+    "            memoryBarrierShared();\n"
+    "            barrier();\n"
+    "\n"
+    "            if (lid < d)\n"
+    "            {\n"
+    "                const uint ai = offset * (2 * lid + 1) - 1;\n"
+    "                const uint bi = offset * (2 * lid + 2) - 1;\n"
+    "                const uint t  = s_scan[ai];\n"
+    "\n"
+    "                s_scan[ai] = s_scan[bi];\n"
+    "                s_scan[bi] = COMBINE(t, s_scan[bi]);\n"
+    "            }\n"
+    "        }\n"
+    "\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        result = s_scan[lid];\n"
+    "\n"
+    "        /* Make sure all invocations have read the results before shared memory is reused. */\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        return result;\n"
+    "    }\n"
+    "#endif\n"
+    "\n"
+    "#if KERNEL == KERNEL_SCAN_BLOCK || KERNEL == KERNEL_SCAN_BLOCK_PREDICATE\n"
+    "    /* Scans a single block. Optionally writes the scanned values and/or the block total to aux_data. */\n"
+    "    void main()\n"
+    "    {\n"
+    "        const uint n_elements   = params.x;\n"
+    "        const uint flags        = params.y;\n"
+    "        const uint base         = gl_WorkGroupID.x * BLOCK_SIZE + gl_LocalInvocationID.x * ELEMENTS_PER_THREAD;\n"
+    "        uint       block_total;\n"
+    "        uint       prefix;\n"
+    "        uint       thread_total = IDENTITY;\n"
+    "        uint       values[ELEMENTS_PER_THREAD];\n"
+    "\n"
+    "        for (uint n = 0; n < ELEMENTS_PER_THREAD; ++n)\n"
+    "        {\n"
+    "            const uint index = base + n;\n"
+    "\n"
+    "            #if KERNEL == KERNEL_SCAN_BLOCK_PREDICATE\n"
+    "            {\n"
+    "                values[n] = (index < n_elements && input_data[index] != 0) ? 1u : 0u;\n"
+    "            }\n"
+    "            #else\n"
+    "            {\n"
+    "                values[n] = (index < n_elements) ? input_data[index] : IDENTITY;\n"
+    "            }\n"
+    "            #endif\n"
+    "\n"
+    "            thread_total = COMBINE(thread_total, values[n]);\n"
+    "        }\n"
+    "\n"
+    "        prefix = workgroup_exclusive_scan(thread_total, block_total);\n"
+    "\n"
+    "        if ((flags & FLAG_WRITE_OUTPUT) != 0)\n"
+    "        {\n"
+    "            const bool is_inclusive = ((flags & FLAG_INCLUSIVE) != 0);\n"
+    "\n"
+    "            for (uint n = 0; n < ELEMENTS_PER_THREAD; ++n)\n"
+    "            {\n"
+    "                const uint index       = base + n;\n"
+    "                const uint next_prefix = COMBINE(prefix, values[n]);\n"
+    "\n"
+    "                if (index < n_elements)\n"
+    "                {\n"
+    "                    output_data[index] = (is_inclusive) ? next_prefix : prefix;\n"
+    "                }\n"
+    "\n"
+    "                prefix = next_prefix;\n"
+    "            }\n"
+    "        }\n"
+    "\n"
+    "        if ((flags & FLAG_WRITE_BLOCK_TOTAL) != 0 &&\n"
+    "            gl_LocalInvocationID.x           == 0)\n"
+    "        {\n"
+    "            aux_data[gl_WorkGroupID.x] = block_total;\n"
+    "        }\n"
+    "    }\n"
+    "#elif KERNEL == KERNEL_ADD_BLOCK_TOTALS\n"
+    "    /* Combines scanned block totals with the per-block scan results. The first block needs no fix-up. */\n"
+    "    void main()\n"
+    "    {\n"
+    "        const uint n_elements = params.x;\n"
+    "        const uint base       = gl_WorkGroupID.x * BLOCK_SIZE + gl_LocalInvocationID.x * ELEMENTS_PER_THREAD;\n"
+    "\n"
+    "        if (gl_WorkGroupID.x == 0)\n"
+    "        {\n"
+    "            return;\n"
+    "        }\n"
+    "\n"
+    "        const uint block_prefix = aux_data[gl_WorkGroupID.x];\n"
+    "\n"
+    "        for (uint n = 0; n < ELEMENTS_PER_THREAD; ++n)\n"
+    "        {\n"
+    "            const uint index = base + n;\n"
+    "\n"
+    "            if (index < n_elements)\n"
+    "            {\n"
+    "                output_data[index] = COMBINE(block_prefix, output_data[index]);\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "#elif KERNEL == KERNEL_RADIX_COUNT\n"
+    "    /* Builds a per-block digit histogram, stored digit-major so that an exclusive scan of the whole\n"
+    "     * histogram yields global scatter offsets for each (digit, block) pair. */\n"
+    "    shared uint s_histogram[RADIX_N_DIGITS];\n"
+    "\n"
+    "    void main()\n"
+    "    {\n"
+    "        const uint n_elements = params.x;\n"
+    "        const uint shift      = params.z;\n"
+    "        const uint n_blocks   = params.w;\n"
+    "        const uint lid        = gl_LocalInvocationID.x;\n"
+    "        const uint base       = gl_WorkGroupID.x * BLOCK_SIZE + lid * ELEMENTS_PER_THREAD;\n"
+    "\n"
+    "        if (lid < RADIX_N_DIGITS)\n"
+    "        {\n"
+    "            s_histogram[lid] = 0;\n"
+    "        }\n"
+    "\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        for (uint n = 0; n < ELEMENTS_PER_THREAD; ++n)\n"
+    "        {\n"
+    "            const uint index = base + n;\n"
+    "\n"
+    "            if (index < n_elements)\n"
+    "            {\n"
+    "                atomicAdd(s_histogram[(input_data[index] >> shift) & (RADIX_N_DIGITS - 1)], 1u);\n"
+    "            }\n"
+    "        }\n"
+    "\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        if (lid < RADIX_N_DIGITS)\n"
+    "        {\n"
+    "            aux_data[lid * n_blocks + gl_WorkGroupID.x] = s_histogram[lid];\n"
+    "        }\n"
+    "    }\n"
+    "#elif KERNEL == KERNEL_RADIX_SCATTER\n"
+    "    /* Scatters keys (and values) to their sorted locations. Ranks within the block are computed by scanning\n"
+    "     * per-invocation digit counts, packed as 16-bit pairs, which keeps the sort stable. */\n"
+    "    shared uint s_digit_offsets[RADIX_N_DIGITS];\n"
+    "\n"
+    "    void main()\n"
+    "    {\n"
+    "        const uint n_elements = params.x;\n"
+    "        const uint flags      = params.y;\n"
+    "        const uint shift      = params.z;\n"
+    "        const uint n_blocks   = params.w;\n"
+    "        const uint lid        = gl_LocalInvocationID.x;\n"
+    "        const uint base       = gl_WorkGroupID.x * BLOCK_SIZE + lid * ELEMENTS_PER_THREAD;\n"
+    "        uint       digits     [ELEMENTS_PER_THREAD];\n"
+    "        uint       keys       [ELEMENTS_PER_THREAD];\n"
+    "        uint       packed_counts[RADIX_N_DIGITS / 2];\n"
+    "        uint       unused_total;\n"
+    "\n"
+    "        for (uint n = 0; n < RADIX_N_DIGITS / 2; ++n)\n"
+    "        {\n"
+    "            packed_counts[n] = 0;\n"
+    "        }\n"
+    "\n"
+    "        for (uint n = 0; n < ELEMENTS_PER_THREAD; ++n)\n"
+    "        {\n"
+    "            const uint index = base + n;\n"
+    "\n"
+    "            keys  [n] = (index < n_elements) ? input_data[index] : 0;\n"
+    "            digits[n] = (keys[n] >> shift) & (RADIX_N_DIGITS - 1);\n"
+    "\n"
+    "            if (index < n_elements)\n"
+    "            {\n"
+    "                packed_counts[digits[n] >> 1] += 1u << ((digits[n] & 1) * 16);\n"
+    "            }\n"
+    "        }\n"
+    "\n"
+    "        for (uint n = 0; n < RADIX_N_DIGITS / 2; ++n)\n"
+    "        {\n"
+    "            packed_counts[n] = workgroup_exclusive_scan(packed_counts[n], unused_total);\n"
+    "        }\n"
+    "\n"
+    "        if (lid < RADIX_N_DIGITS)\n"
+    "        {\n"
+    "            s_digit_offsets[lid] = aux_data[lid * n_blocks + gl_WorkGroupID.x];\n"
+    "        }\n"
+    "\n"
+    "        memoryBarrierShared();\n"
+    "        barrier();\n"
+    "\n"
+    "        for (uint n = 0; n < ELEMENTS_PER_THREAD; ++n)\n"
+    "        {\n"
+    "            const uint index = base + n;\n"
+    "\n"
+    "            if (index < n_elements)\n"
+    "            {\n"
+    "                const uint digit        = digits[n];\n"
+    "                const uint packed_shift = (digit & 1) * 16;\n"
+    "                const uint rank         = (packed_counts[digit >> 1] >> packed_shift) & 0xFFFFu;\n"
+    "                const uint dst_index    = s_digit_offsets[digit] + rank;\n"
+    "\n"
+    "                packed_counts[digit >> 1] += 1u << packed_shift;\n"
+    "                output_data  [dst_index]   = keys[n];\n"
+    "\n"
+    "                if ((flags & FLAG_SCATTER_VALUES) != 0)\n"
+    "                {\n"
+    "                    output_values_data[dst_index] = input_values_data[index];\n"
+    "                }\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "#elif KERNEL == KERNEL_COMPACT_SCATTER\n"
+    "    /* Copies selected elements to the locations computed by the predicate scan, and stores the element count. */\n"
+    "    void main()\n"
+    "    {\n"
+    "        const uint n_elements = params.x;\n"
+    "        const uint base       = gl_WorkGroupID.x * BLOCK_SIZE + gl_LocalInvocationID.x * ELEMENTS_PER_THREAD;\n"
+    "\n"
+    "        for (uint n = 0; n < ELEMENTS_PER_THREAD; ++n)\n"
+    "        {\n"
+    "            const uint index = base + n;\n"
+    "\n"
+    "            if (index < n_elements)\n"
+    "            {\n"
+    "                const bool is_selected = (input_values_data[index] != 0);\n"
+    "\n"
+    "                if (is_selected)\n"
+    "                {\n"
+    "                    output_data[aux_data[index] ] = input_data[index];\n"
+    "                }\n"
+    "\n"
+    "                if (index == n_elements - 1)\n"
+    "                {\n"
+    "                    output_values_data[0] = aux_data[index] + ((is_selected) ? 1u : 0u);\n"
+    "                }\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "#endif\n";
+
+
+/** Returns the number of blocks needed to cover @param in_n_elements elements. */
+static uint32_t get_n_blocks(uint32_t in_n_elements)
+{
+    return static_cast<uint32_t>( (static_cast<uint64_t>(in_n_elements) + BLOCK_SIZE - 1) / BLOCK_SIZE);
+}
+
+
+/* Please see header for specification */
+Anvil::ComputePrimitive::ComputePrimitive(const Anvil::BaseDevice*         in_device_ptr,
+                                          Anvil::ComputePrimitiveType      in_type,
+                                          Anvil::ComputePrimitiveOperation in_operation,
+                                          uint32_t                         in_max_n_elements,
+                                          bool                             in_use_subgroup_ops)
+    :m_device_ptr       (in_device_ptr),
+     m_max_n_elements   (in_max_n_elements),
+     m_operation        (in_operation),
+     m_type             (in_type),
+     m_use_subgroup_ops (false),
+     m_radix_sort_values(false)
+{
+    const auto& device_properties = in_device_ptr->get_physical_device_properties();
+
+    for (uint32_t n_kernel = 0;
+                  n_kernel < static_cast<uint32_t>(Kernel::COUNT);
+                ++n_kernel)
+    {
+        m_pipeline_ids[n_kernel] = UINT32_MAX;
+    }
+
+    /* Only use subgroup operations if the device supports everything the subgroup path relies on. */
+    if (in_use_subgroup_ops                             &&
+        device_properties.core_vk1_1_properties_ptr != nullptr)
+    {
+        const auto& subgroup_props = device_properties.core_vk1_1_properties_ptr->subgroup_properties;
+
+        m_use_subgroup_ops = ((subgroup_props.supported_stages     & Anvil::ShaderStageFlagBits::COMPUTE_BIT)         != 0)                      &&
+                             ((subgroup_props.supported_operations & Anvil::SubgroupFeatureFlagBits::BASIC_BIT)       != 0)                      &&
+                             ((subgroup_props.supported_operations & Anvil::SubgroupFeatureFlagBits::ARITHMETIC_BIT)  != 0)                      &&
+                              subgroup_props.subgroup_size                                                           >= MIN_SUBGROUP_SIZE         &&
+                              subgroup_props.subgroup_size                                                           <= WORKGROUP_SIZE;
+    }
+}
+
+/* Please see header for specification */
+Anvil::ComputePrimitive::~ComputePrimitive()
+{
+    auto compute_pipeline_manager_ptr = m_device_ptr->get_compute_pipeline_manager();
+
+    /* Release descriptor sets and scratch buffers before the pipelines, which refer to the same layouts. */
+    m_compact_scatter_dsg_ptr.reset();
+    m_radix_count_dsg_ptrs[0].reset();
+    m_radix_count_dsg_ptrs[1].reset();
+    m_radix_scatter_dsg_ptrs[0].reset();
+    m_radix_scatter_dsg_ptrs[1].reset();
+    m_scan_levels.clear();
+
+    for (const auto& current_pipeline_id : m_pipeline_ids_to_release)
+    {
+        compute_pipeline_manager_ptr->delete_pipeline(current_pipeline_id);
+    }
+}
+
+/* Please see header for specification */
+Anvil::ComputePrimitiveUniquePtr Anvil::ComputePrimitive::create_compaction(const Anvil::BaseDevice* in_device_ptr,
+                                                                            Anvil::Buffer*           in_input_buffer_ptr,
+                                                                            Anvil::Buffer*           in_predicate_buffer_ptr,
+                                                                            Anvil::Buffer*           in_output_buffer_ptr,
+                                                                            Anvil::Buffer*           in_output_count_buffer_ptr,
+                                                                            uint32_t                 in_max_n_elements,
+                                                                            bool                     in_use_subgroup_ops)
+{
+    static const Kernel kernels[] =
+    {
+        Kernel::ADD_BLOCK_TOTALS,
+        Kernel::COMPACT_SCATTER,
+        Kernel::SCAN_BLOCK,
+        Kernel::SCAN_BLOCK_PREDICATE,
+    };
+
+    Anvil::Buffer*            scatter_buffer_ptrs[N_BINDINGS];
+    ComputePrimitiveUniquePtr result_ptr         (nullptr,
+                                                  std::default_delete<ComputePrimitive>() );
+
+    anvil_assert(in_input_buffer_ptr        != nullptr);
+    anvil_assert(in_predicate_buffer_ptr    != nullptr);
+    anvil_assert(in_output_buffer_ptr       != nullptr);
+    anvil_assert(in_output_count_buffer_ptr != nullptr);
+
+    result_ptr.reset(
+        new ComputePrimitive(in_device_ptr,
+                             Anvil::ComputePrimitiveType::COMPACTION,
+                             Anvil::ComputePrimitiveOperation::ADD,
+                             in_max_n_elements,
+                             in_use_subgroup_ops)
+    );
+
+    if (!result_ptr->init_pipelines(kernels,
+                                    sizeof(kernels) / sizeof(kernels[0]) ))
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+    result_ptr->m_compact_index_buffer_ptr = result_ptr->create_scratch_buffer(sizeof(uint32_t) * in_max_n_elements);
+
+    if (result_ptr->m_compact_index_buffer_ptr == nullptr)
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+    if (!result_ptr->init_scan_levels(in_predicate_buffer_ptr,
+                                      result_ptr->m_compact_index_buffer_ptr.get(),
+                                      nullptr, /* in_opt_reduction_output_buffer_ptr */
+                                      in_max_n_elements) )
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+    scatter_buffer_ptrs[BINDING_INPUT]         = in_input_buffer_ptr;
+    scatter_buffer_ptrs[BINDING_OUTPUT]        = in_output_buffer_ptr;
+    scatter_buffer_ptrs[BINDING_AUX]           = result_ptr->m_compact_index_buffer_ptr.get();
+    scatter_buffer_ptrs[BINDING_INPUT_VALUES]  = in_predicate_buffer_ptr;
+    scatter_buffer_ptrs[BINDING_OUTPUT_VALUES] = in_output_count_buffer_ptr;
+
+    result_ptr->m_compact_scatter_dsg_ptr = result_ptr->create_dsg(scatter_buffer_ptrs,
+                                                                   N_BINDINGS);
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+Anvil::ComputePrimitiveUniquePtr Anvil::ComputePrimitive::create_radix_sort(const Anvil::BaseDevice* in_device_ptr,
+                                                                            Anvil::Buffer*           in_key_buffer_ptr,
+                                                                            Anvil::Buffer*           in_opt_value_buffer_ptr,
+                                                                            uint32_t                 in_max_n_elements,
+                                                                            bool                     in_use_subgroup_ops)
+{
+    static const Kernel kernels[] =
+    {
+        Kernel::ADD_BLOCK_TOTALS,
+        Kernel::RADIX_COUNT,
+        Kernel::RADIX_SCATTER,
+        Kernel::SCAN_BLOCK,
+    };
+
+    const uint32_t            max_n_blocks(get_n_blocks(in_max_n_elements) );
+    ComputePrimitiveUniquePtr result_ptr  (nullptr,
+                                           std::default_delete<ComputePrimitive>() );
+
+    anvil_assert(in_key_buffer_ptr != nullptr);
+
+    result_ptr.reset(
+        new ComputePrimitive(in_device_ptr,
+                             Anvil::ComputePrimitiveType::RADIX_SORT,
+                             Anvil::ComputePrimitiveOperation::ADD,
+                             in_max_n_elements,
+                             in_use_subgroup_ops)
+    );
+
+    result_ptr->m_radix_sort_values = (in_opt_value_buffer_ptr != nullptr);
+
+    if (!result_ptr->init_pipelines(kernels,
+                                    sizeof(kernels) / sizeof(kernels[0]) ))
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+    /* Each pass scatters from one buffer to the other. The number of passes is even, so the sorted data ends up
+     * in the app-specified buffers. */
+    result_ptr->m_radix_histogram_buffer_ptr   = result_ptr->create_scratch_buffer(sizeof(uint32_t) * RADIX_N_DIGITS * max_n_blocks);
+    result_ptr->m_radix_scratch_key_buffer_ptr = result_ptr->create_scratch_buffer(sizeof(uint32_t) * in_max_n_elements);
+
+    if (result_ptr->m_radix_histogram_buffer_ptr   == nullptr ||
+        result_ptr->m_radix_scratch_key_buffer_ptr == nullptr)
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+    if (result_ptr->m_radix_sort_values)
+    {
+        result_ptr->m_radix_scratch_value_buffer_ptr = result_ptr->create_scratch_buffer(sizeof(uint32_t) * in_max_n_elements);
+
+        if (result_ptr->m_radix_scratch_value_buffer_ptr == nullptr)
+        {
+            result_ptr.reset();
+
+            goto end;
+        }
+    }
+
+    if (!result_ptr->init_scan_levels(result_ptr->m_radix_histogram_buffer_ptr.get(),
+                                      result_ptr->m_radix_histogram_buffer_ptr.get(),
+                                      nullptr, /* in_opt_reduction_output_buffer_ptr */
+                                      RADIX_N_DIGITS * max_n_blocks) )
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+    for (uint32_t n_parity = 0;
+                  n_parity < 2;
+                ++n_parity)
+    {
+        Anvil::Buffer* key_buffer_ptrs  [2] = {in_key_buffer_ptr,       result_ptr->m_radix_scratch_key_buffer_ptr.get()   };
+        Anvil::Buffer* value_buffer_ptrs[2] = {in_opt_value_buffer_ptr, result_ptr->m_radix_scratch_value_buffer_ptr.get() };
+        Anvil::Buffer* count_buffer_ptrs  [N_BINDINGS];
+        Anvil::Buffer* scatter_buffer_ptrs[N_BINDINGS];
+
+        count_buffer_ptrs[BINDING_INPUT]         = key_buffer_ptrs[n_parity];
+        count_buffer_ptrs[BINDING_OUTPUT]        = nullptr;
+        count_buffer_ptrs[BINDING_AUX]           = result_ptr->m_radix_histogram_buffer_ptr.get();
+        count_buffer_ptrs[BINDING_INPUT_VALUES]  = nullptr;
+        count_buffer_ptrs[BINDING_OUTPUT_VALUES] = nullptr;
+
+        scatter_buffer_ptrs[BINDING_INPUT]         = key_buffer_ptrs  [n_parity];
+        scatter_buffer_ptrs[BINDING_OUTPUT]        = key_buffer_ptrs  [1 - n_parity];
+        scatter_buffer_ptrs[BINDING_AUX]           = result_ptr->m_radix_histogram_buffer_ptr.get();
+        scatter_buffer_ptrs[BINDING_INPUT_VALUES]  = value_buffer_ptrs[n_parity];
+        scatter_buffer_ptrs[BINDING_OUTPUT_VALUES] = value_buffer_ptrs[1 - n_parity];
+
+        result_ptr->m_radix_count_dsg_ptrs  [n_parity] = result_ptr->create_dsg(count_buffer_ptrs,
+                                                                                N_BINDINGS);
+        result_ptr->m_radix_scatter_dsg_ptrs[n_parity] = result_ptr->create_dsg(scatter_buffer_ptrs,
+                                                                                N_BINDINGS);
+    }
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+Anvil::ComputePrimitiveUniquePtr Anvil::ComputePrimitive::create_reduction(const Anvil::BaseDevice*         in_device_ptr,
+                                                                           Anvil::ComputePrimitiveOperation in_operation,
+                                                                           Anvil::Buffer*                   in_input_buffer_ptr,
+                                                                           Anvil::Buffer*                   in_output_buffer_ptr,
+                                                                           uint32_t                         in_max_n_elements,
+                                                                           bool                             in_use_subgroup_ops)
+{
+    static const Kernel kernels[] =
+    {
+        Kernel::SCAN_BLOCK,
+    };
+
+    ComputePrimitiveUniquePtr result_ptr(nullptr,
+                                         std::default_delete<ComputePrimitive>() );
+
+    anvil_assert(in_input_buffer_ptr  != nullptr);
+    anvil_assert(in_output_buffer_ptr != nullptr);
+
+    result_ptr.reset(
+        new ComputePrimitive(in_device_ptr,
+                             Anvil::ComputePrimitiveType::REDUCTION,
+                             in_operation,
+                             in_max_n_elements,
+                             in_use_subgroup_ops)
+    );
+
+    if (!result_ptr->init_pipelines(kernels,
+                                    sizeof(kernels) / sizeof(kernels[0]) ))
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+    if (!result_ptr->init_scan_levels(in_input_buffer_ptr,
+                                      nullptr, /* in_output_buffer_ptr */
+                                      in_output_buffer_ptr,
+                                      in_max_n_elements) )
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+Anvil::ComputePrimitiveUniquePtr Anvil::ComputePrimitive::create_scan(const Anvil::BaseDevice*         in_device_ptr,
+                                                                      bool                             in_inclusive,
+                                                                      Anvil::ComputePrimitiveOperation in_operation,
+                                                                      Anvil::Buffer*                   in_input_buffer_ptr,
+                                                                      Anvil::Buffer*                   in_output_buffer_ptr,
+                                                                      uint32_t                         in_max_n_elements,
+                                                                      bool                             in_use_subgroup_ops)
+{
+    static const Kernel kernels[] =
+    {
+        Kernel::ADD_BLOCK_TOTALS,
+        Kernel::SCAN_BLOCK,
+    };
+
+    ComputePrimitiveUniquePtr result_ptr(nullptr,
+                                         std::default_delete<ComputePrimitive>() );
+
+    anvil_assert(in_input_buffer_ptr  != nullptr);
+    anvil_assert(in_output_buffer_ptr != nullptr);
+
+    result_ptr.reset(
+        new ComputePrimitive(in_device_ptr,
+                             (in_inclusive) ? Anvil::ComputePrimitiveType::INCLUSIVE_SCAN
+                                            : Anvil::ComputePrimitiveType::EXCLUSIVE_SCAN,
+                             in_operation,
+                             in_max_n_elements,
+                             in_use_subgroup_ops)
+    );
+
+    if (!result_ptr->init_pipelines(kernels,
+                                    sizeof(kernels) / sizeof(kernels[0]) ))
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+    if (!result_ptr->init_scan_levels(in_input_buffer_ptr,
+                                      in_output_buffer_ptr,
+                                      nullptr, /* in_opt_reduction_output_buffer_ptr */
+                                      in_max_n_elements) )
+    {
+        result_ptr.reset();
+
+        goto end;
+    }
+
+end:
+    return result_ptr;
+}
+
+/** Creates a new descriptor set group, whose layout is shared with all other DSGs created by the instance.
+ *
+ *  @param in_buffer_ptrs Buffers to bind, one per binding. Null items are replaced with the first buffer.
+ *                        The first item must not be nullptr.
+ *  @param in_n_buffers   Number of items under @param in_buffer_ptrs. Must be equal to N_BINDINGS.
+ *
+ *  @return New DSG instance.
+ **/
+Anvil::DescriptorSetGroupUniquePtr Anvil::ComputePrimitive::create_dsg(Anvil::Buffer* const* in_buffer_ptrs,
+                                                                       uint32_t              in_n_buffers) const
+{
+    Anvil::DescriptorSetGroupUniquePtr result_ptr;
+
+    anvil_assert(in_n_buffers      == N_BINDINGS);
+    anvil_assert(in_buffer_ptrs[0] != nullptr);
+
+    result_ptr = Anvil::DescriptorSetGroup::create(m_layout_dsg_ptr.get(),
+                                                   false); /* in_releaseable_sets */
+
+    for (uint32_t n_binding = 0;
+                  n_binding < in_n_buffers;
+                ++n_binding)
+    {
+        Anvil::Buffer* buffer_ptr = (in_buffer_ptrs[n_binding] != nullptr) ? in_buffer_ptrs[n_binding]
+                                                                           : in_buffer_ptrs[0];
+
+        result_ptr->set_binding_item(0, /* n_set */
+                                     n_binding,
+                                     Anvil::DescriptorSet::StorageBufferBindingElement(buffer_ptr) );
+    }
+
+    return result_ptr;
+}
+
+/** Creates a device-local storage buffer of the specified size, used for intermediate data.
+ *
+ *  @return New buffer instance if successful, null otherwise.
+ **/
+Anvil::BufferUniquePtr Anvil::ComputePrimitive::create_scratch_buffer(VkDeviceSize in_size) const
+{
+    auto create_info_ptr = Anvil::BufferCreateInfo::create_alloc(m_device_ptr,
+                                                                 in_size,
+                                                                 Anvil::QueueFamilyFlagBits::COMPUTE_BIT,
+                                                                 Anvil::SharingMode::EXCLUSIVE,
+                                                                 Anvil::BufferCreateFlagBits::NONE,
+                                                                 Anvil::BufferUsageFlagBits::STORAGE_BUFFER_BIT,
+                                                                 Anvil::MemoryFeatureFlagBits::NONE);
+
+    return Anvil::Buffer::create(std::move(create_info_ptr) );
+}
+
+/** Compiles compute shaders for the specified kernels and bakes corresponding compute pipelines. Also creates
+ *  the DSG defining the descriptor set layout used by all kernels.
+ *
+ *  @param in_kernels   Kernels to create pipelines for. Must not be nullptr.
+ *  @param in_n_kernels Number of items under @param in_kernels.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::ComputePrimitive::init_pipelines(const Kernel* in_kernels,
+                                             uint32_t      in_n_kernels)
+{
+    auto                                                 compute_pipeline_manager_ptr = m_device_ptr->get_compute_pipeline_manager();
+    std::vector<Anvil::DescriptorSetCreateInfoUniquePtr> ds_create_info_ptrs(1);
+    const auto&                                          limits                       = m_device_ptr->get_physical_device_properties().core_vk1_0_properties_ptr->limits;
+    bool                                                 result                       = false;
+
+    anvil_assert(m_max_n_elements > 0);
+
+    /* Level 0 is the largest dispatch any of the primitives issues. */
+    if (get_n_blocks(m_max_n_elements) > limits.max_compute_work_group_count[0])
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    ds_create_info_ptrs[0] = Anvil::DescriptorSetCreateInfo::create();
+
+    for (uint32_t n_binding = 0;
+                  n_binding < N_BINDINGS;
+                ++n_binding)
+    {
+        ds_create_info_ptrs[0]->add_binding(n_binding,
+                                            Anvil::DescriptorType::STORAGE_BUFFER,
+                                            1, /* n_elements */
+                                            Anvil::ShaderStageFlagBits::COMPUTE_BIT);
+    }
+
+    m_layout_dsg_ptr = Anvil::DescriptorSetGroup::create(m_device_ptr,
+                                                         ds_create_info_ptrs,
+                                                         false); /* in_releaseable_sets */
+
+    if (m_layout_dsg_ptr == nullptr)
+    {
+        anvil_assert(m_layout_dsg_ptr != nullptr);
+
+        goto end;
+    }
+
+    for (uint32_t n_kernel = 0;
+                  n_kernel < in_n_kernels;
+                ++n_kernel)
+    {
+        const Kernel                                 kernel              = in_kernels[n_kernel];
+        Anvil::ComputePipelineCreateInfoUniquePtr    pipeline_info_ptr;
+        Anvil::ShaderModuleUniquePtr                 shader_module_ptr;
+        Anvil::GLSLShaderToSPIRVGeneratorUniquePtr   spirv_generator_ptr;
+
+        spirv_generator_ptr = Anvil::GLSLShaderToSPIRVGenerator::create(m_device_ptr,
+                                                                        Anvil::GLSLShaderToSPIRVGenerator::MODE_USE_SPECIFIED_SOURCE,
+                                                                        g_glsl_compute_primitives,
+                                                                        Anvil::ShaderStage::COMPUTE,
+                                                                        (m_use_subgroup_ops) ? Anvil::SpvVersion::_1_3
+                                                                                             : Anvil::SpvVersion::_1_0);
+
+        if (spirv_generator_ptr == nullptr)
+        {
+            anvil_assert(spirv_generator_ptr != nullptr);
+
+            goto end;
+        }
+
+        spirv_generator_ptr->add_definition_value_pair("BLOCK_SIZE",          BLOCK_SIZE);
+        spirv_generator_ptr->add_definition_value_pair("ELEMENTS_PER_THREAD", ELEMENTS_PER_THREAD);
+        spirv_generator_ptr->add_definition_value_pair("KERNEL",              static_cast<uint32_t>(kernel) );
+        spirv_generator_ptr->add_definition_value_pair("MIN_SUBGROUP_SIZE",   MIN_SUBGROUP_SIZE);
+        spirv_generator_ptr->add_definition_value_pair("OP",                  static_cast<uint32_t>(m_operation) );
+        spirv_generator_ptr->add_definition_value_pair("RADIX_N_DIGITS",      RADIX_N_DIGITS);
+        spirv_generator_ptr->add_definition_value_pair("USE_SUBGROUPS",       (m_use_subgroup_ops) ? 1 : 0);
+        spirv_generator_ptr->add_definition_value_pair("WORKGROUP_SIZE",      WORKGROUP_SIZE);
+
+        if (m_use_subgroup_ops)
+        {
+            spirv_generator_ptr->add_extension_behavior("GL_KHR_shader_subgroup_basic",
+                                                        Anvil::GLSLShaderToSPIRVGenerator::EXTENSION_BEHAVIOR_REQUIRE);
+            spirv_generator_ptr->add_extension_behavior("GL_KHR_shader_subgroup_arithmetic",
+                                                        Anvil::GLSLShaderToSPIRVGenerator::EXTENSION_BEHAVIOR_REQUIRE);
+        }
+
+        shader_module_ptr = Anvil::ShaderModule::create_from_spirv_generator(m_device_ptr,
+                                                                             spirv_generator_ptr.get() );
+
+        if (shader_module_ptr == nullptr)
+        {
+            anvil_assert(shader_module_ptr != nullptr);
+
+            goto end;
+        }
+
+        m_shader_entrypoint_ptrs.push_back(
+            std::unique_ptr<Anvil::ShaderModuleStageEntryPoint>(
+                new Anvil::ShaderModuleStageEntryPoint("main",
+                                                       std::move(shader_module_ptr),
+                                                       Anvil::ShaderStage::COMPUTE)
+            )
+        );
+
+        pipeline_info_ptr = Anvil::ComputePipelineCreateInfo::create(Anvil::PipelineCreateFlagBits::NONE,
+                                                                     *m_shader_entrypoint_ptrs.back() );
+
+        pipeline_info_ptr->attach_push_constant_range    (0, /* in_offset */
+                                                          PUSH_CONSTANTS_SIZE,
+                                                          Anvil::ShaderStageFlagBits::COMPUTE_BIT);
+        pipeline_info_ptr->set_descriptor_set_create_info(m_layout_dsg_ptr->get_descriptor_set_create_info() );
+
+        if (!compute_pipeline_manager_ptr->add_pipeline(std::move(pipeline_info_ptr),
+                                                        &m_pipeline_ids[static_cast<uint32_t>(kernel)]) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        m_pipeline_ids_to_release.push_back(m_pipeline_ids[static_cast<uint32_t>(kernel)]);
+    }
+
+    result = compute_pipeline_manager_ptr->bake();
+    anvil_assert(result);
+
+end:
+    return result;
+}
+
+/** Creates scratch buffers and descriptor sets for a multi-level scan or reduction of up to @param in_max_n_elements
+ *  elements.
+ *
+ *  Level 0 reads from @param in_input_buffer_ptr and writes to @param in_output_buffer_ptr. Each following level
+ *  scans the block totals of the previous level in place.
+ *
+ *  @param in_input_buffer_ptr                Buffer to read level 0 data from. Must not be nullptr.
+ *  @param in_output_buffer_ptr               Buffer to write level 0 scan results to. Must be nullptr for reductions.
+ *  @param in_opt_reduction_output_buffer_ptr Buffer to write the reduction result to. Must only be specified for
+ *                                            reductions.
+ *  @param in_max_n_elements                  Maximum number of elements to scan.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::ComputePrimitive::init_scan_levels(Anvil::Buffer* in_input_buffer_ptr,
+                                               Anvil::Buffer* in_output_buffer_ptr,
+                                               Anvil::Buffer* in_opt_reduction_output_buffer_ptr,
+                                               uint32_t       in_max_n_elements)
+{
+    const bool     is_reduction     (in_opt_reduction_output_buffer_ptr != nullptr);
+    Anvil::Buffer* level_input_ptr  (in_input_buffer_ptr);
+    Anvil::Buffer* level_output_ptr (in_output_buffer_ptr);
+    uint32_t       level_n_elements (in_max_n_elements);
+    bool           result           (false);
+
+    anvil_assert(is_reduction == (in_output_buffer_ptr == nullptr) );
+
+    while (true)
+    {
+        const uint32_t n_blocks = get_n_blocks(level_n_elements);
+        Anvil::Buffer* level_buffer_ptrs[N_BINDINGS];
+        ScanLevel      new_level;
+
+        if (m_scan_levels.size() >= MAX_SCAN_LEVELS)
+        {
+            anvil_assert(m_scan_levels.size() < MAX_SCAN_LEVELS);
+
+            goto end;
+        }
+
+        if (n_blocks > 1)
+        {
+            new_level.block_totals_buffer_ptr = create_scratch_buffer(sizeof(uint32_t) * n_blocks);
+
+            if (new_level.block_totals_buffer_ptr == nullptr)
+            {
+                anvil_assert(new_level.block_totals_buffer_ptr != nullptr);
+
+                goto end;
+            }
+        }
+
+        level_buffer_ptrs[BINDING_INPUT]         = level_input_ptr;
+        level_buffer_ptrs[BINDING_OUTPUT]        = level_output_ptr;
+        level_buffer_ptrs[BINDING_AUX]           = new_level.block_totals_buffer_ptr.get();
+        level_buffer_ptrs[BINDING_INPUT_VALUES]  = nullptr;
+        level_buffer_ptrs[BINDING_OUTPUT_VALUES] = nullptr;
+
+        new_level.dsg_ptr = create_dsg(level_buffer_ptrs,
+                                       N_BINDINGS);
+
+        if (is_reduction)
+        {
+            level_buffer_ptrs[BINDING_AUX] = in_opt_reduction_output_buffer_ptr;
+
+            new_level.final_dsg_ptr = create_dsg(level_buffer_ptrs,
+                                                 N_BINDINGS);
+        }
+
+        level_input_ptr  = new_level.block_totals_buffer_ptr.get();
+        level_output_ptr = (is_reduction) ? nullptr
+                                          : new_level.block_totals_buffer_ptr.get();
+        level_n_elements = n_blocks;
+
+        m_scan_levels.push_back(std::move(new_level) );
+
+        if (n_blocks == 1)
+        {
+            break;
+        }
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::ComputePrimitive::record(Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                                     uint32_t                  in_n_elements)
+{
+    const uint32_t n_blocks(get_n_blocks(in_n_elements) );
+    bool           result  (false);
+
+    if (in_cmd_buffer_ptr == nullptr                                   ||
+        in_n_elements     == 0                                         ||
+        in_n_elements      > m_max_n_elements)
+    {
+        anvil_assert(in_cmd_buffer_ptr != nullptr);
+        anvil_assert(in_n_elements     != 0);
+        anvil_assert(in_n_elements     <= m_max_n_elements);
+
+        goto end;
+    }
+
+    switch (m_type)
+    {
+        case Anvil::ComputePrimitiveType::COMPACTION:
+        {
+            result = record_scan_levels(in_cmd_buffer_ptr,
+                                        in_n_elements,
+                                        Kernel::SCAN_BLOCK_PREDICATE,
+                                        false,  /* in_inclusive */
+                                        false); /* in_reduction */
+
+            result &= record_barrier (in_cmd_buffer_ptr);
+            result &= record_dispatch(in_cmd_buffer_ptr,
+                                      Kernel::COMPACT_SCATTER,
+                                      m_compact_scatter_dsg_ptr.get(),
+                                      in_n_elements,
+                                      0, /* in_flags */
+                                      0, /* in_shift */
+                                      n_blocks);
+
+            break;
+        }
+
+        case Anvil::ComputePrimitiveType::EXCLUSIVE_SCAN:
+        case Anvil::ComputePrimitiveType::INCLUSIVE_SCAN:
+        {
+            result = record_scan_levels(in_cmd_buffer_ptr,
+                                        in_n_elements,
+                                        Kernel::SCAN_BLOCK,
+                                        (m_type == Anvil::ComputePrimitiveType::INCLUSIVE_SCAN),
+                                        false); /* in_reduction */
+
+            break;
+        }
+
+        case Anvil::ComputePrimitiveType::RADIX_SORT:
+        {
+            result = true;
+
+            for (uint32_t n_pass = 0;
+                          n_pass < RADIX_N_PASSES;
+                        ++n_pass)
+            {
+                const uint32_t n_parity = (n_pass % 2);
+                const uint32_t shift    = (n_pass * RADIX_BITS_PER_PASS);
+
+                if (n_pass > 0)
+                {
+                    result &= record_barrier(in_cmd_buffer_ptr);
+                }
+
+                result &= record_dispatch(in_cmd_buffer_ptr,
+                                          Kernel::RADIX_COUNT,
+                                          m_radix_count_dsg_ptrs[n_parity].get(),
+                                          in_n_elements,
+                                          0, /* in_flags */
+                                          shift,
+                                          n_blocks);
+                result &= record_barrier (in_cmd_buffer_ptr);
+
+                result &= record_scan_levels(in_cmd_buffer_ptr,
+                                             RADIX_N_DIGITS * n_blocks,
+                                             Kernel::SCAN_BLOCK,
+                                             false,  /* in_inclusive */
+                                             false); /* in_reduction */
+
+                result &= record_barrier (in_cmd_buffer_ptr);
+                result &= record_dispatch(in_cmd_buffer_ptr,
+                                          Kernel::RADIX_SCATTER,
+                                          m_radix_scatter_dsg_ptrs[n_parity].get(),
+                                          in_n_elements,
+                                          (m_radix_sort_values) ? FLAG_SCATTER_VALUES : 0,
+                                          shift,
+                                          n_blocks);
+            }
+
+            break;
+        }
+
+        case Anvil::ComputePrimitiveType::REDUCTION:
+        {
+            result = record_scan_levels(in_cmd_buffer_ptr,
+                                        in_n_elements,
+                                        Kernel::SCAN_BLOCK,
+                                        false, /* in_inclusive */
+                                        true); /* in_reduction */
+
+            break;
+        }
+
+        default:
+        {
+            anvil_assert_fail();
+        }
+    }
+
+end:
+    return result;
+}
+
+/** Records a compute->compute memory barrier, making results of a dispatch visible to the following one. */
+bool Anvil::ComputePrimitive::record_barrier(Anvil::CommandBufferBase* in_cmd_buffer_ptr) const
+{
+    const Anvil::MemoryBarrier barrier(Anvil::AccessFlagBits::SHADER_READ_BIT | Anvil::AccessFlagBits::SHADER_WRITE_BIT, /* in_destination_access_mask */
+                                       Anvil::AccessFlagBits::SHADER_WRITE_BIT);                                         /* in_source_access_mask      */
+
+    return in_cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::COMPUTE_SHADER_BIT,
+                                                      Anvil::PipelineStageFlagBits::COMPUTE_SHADER_BIT,
+                                                      Anvil::DependencyFlagBits::NONE,
+                                                      1, /* in_memory_barrier_count */
+                                                      &barrier,
+                                                      0, /* in_buffer_memory_barrier_count */
+                                                      nullptr,
+                                                      0, /* in_image_memory_barrier_count */
+                                                      nullptr);
+}
+
+/** Binds the pipeline & descriptor set for the specified kernel, updates push constants and dispatches
+ *  @param in_n_workgroups workgroups.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::ComputePrimitive::record_dispatch(Anvil::CommandBufferBase*  in_cmd_buffer_ptr,
+                                              Kernel                     in_kernel,
+                                              Anvil::DescriptorSetGroup* in_dsg_ptr,
+                                              uint32_t                   in_n_elements,
+                                              uint32_t                   in_flags,
+                                              uint32_t                   in_shift,
+                                              uint32_t                   in_n_workgroups)
+{
+    const Anvil::PipelineID      pipeline_id     = m_pipeline_ids[static_cast<uint32_t>(in_kernel)];
+    Anvil::PipelineLayout*       pipeline_layout_ptr;
+    const uint32_t               push_constants[] =
+    {
+        in_n_elements,
+        in_flags,
+        in_shift,
+        in_n_workgroups
+    };
+    const Anvil::DescriptorSet*  ds_ptr;
+    bool                         result          = false;
+
+    static_assert(sizeof(push_constants) == PUSH_CONSTANTS_SIZE,
+                  "Push constant data size must match the range attached to the pipelines");
+
+    anvil_assert(pipeline_id != UINT32_MAX);
+
+    pipeline_layout_ptr = m_device_ptr->get_compute_pipeline_manager()->get_pipeline_layout(pipeline_id);
+    ds_ptr              = in_dsg_ptr->get_descriptor_set                                   (0); /* in_n_set */
+
+    if (!in_cmd_buffer_ptr->record_bind_pipeline(Anvil::PipelineBindPoint::COMPUTE,
+                                                 pipeline_id) )
+    {
+        goto end;
+    }
+
+    if (!in_cmd_buffer_ptr->record_bind_descriptor_sets(Anvil::PipelineBindPoint::COMPUTE,
+                                                        pipeline_layout_ptr,
+                                                        0, /* in_first_set */
+                                                        1, /* in_set_count */
+                                                        &ds_ptr,
+                                                        0,        /* in_dynamic_offset_count */
+                                                        nullptr)) /* in_dynamic_offset_ptrs  */
+    {
+        goto end;
+    }
+
+    if (!in_cmd_buffer_ptr->record_push_constants(pipeline_layout_ptr,
+                                                  Anvil::ShaderStageFlagBits::COMPUTE_BIT,
+                                                  0, /* in_offset */
+                                                  sizeof(push_constants),
+                                                  push_constants) )
+    {
+        goto end;
+    }
+
+    result = in_cmd_buffer_ptr->record_dispatch(in_n_workgroups,
+                                                1,  /* in_y */
+                                                1); /* in_z */
+
+end:
+    return result;
+}
+
+/** Records a multi-level scan or reduction of @param in_n_elements elements, using scan levels configured by
+ *  init_scan_levels().
+ *
+ *  The up-sweep scans each level and stores block totals, which are then scanned by the following level. The last
+ *  level always fits in a single block. For scans, a down-sweep then adds scanned block totals back to each level.
+ *
+ *  @param in_cmd_buffer_ptr     Command buffer to record commands into.
+ *  @param in_n_elements         Number of level 0 elements.
+ *  @param in_first_level_kernel Kernel to use for level 0.
+ *  @param in_inclusive          true if level 0 should be scanned inclusively.
+ *  @param in_reduction          true if only the total of the last level should be stored.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::ComputePrimitive::record_scan_levels(Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                                                 uint32_t                  in_n_elements,
+                                                 Kernel                    in_first_level_kernel,
+                                                 bool                      in_inclusive,
+                                                 bool                      in_reduction)
+{
+    uint32_t level_n_elements[MAX_SCAN_LEVELS];
+    uint32_t n_levels        = 0;
+    bool     result          = true;
+
+    /* Determine how many levels are needed for this element count. */
+    level_n_elements[0] = in_n_elements;
+
+    while (true)
+    {
+        const uint32_t n_blocks = get_n_blocks(level_n_elements[n_levels]);
+
+        ++n_levels;
+
+        if (n_blocks == 1)
+        {
+            break;
+        }
+
+        anvil_assert(n_levels < MAX_SCAN_LEVELS);
+
+        level_n_elements[n_levels] = n_blocks;
+    }
+
+    anvil_assert(n_levels <= m_scan_levels.size() );
+
+    /* Up-sweep */
+    for (uint32_t n_level = 0;
+                  n_level < n_levels;
+                ++n_level)
+    {
+        const bool                 is_last_level = (n_level == n_levels - 1);
+        const ScanLevel&           level         = m_scan_levels.at(n_level);
+        Anvil::DescriptorSetGroup* dsg_ptr       = (in_reduction && is_last_level) ? level.final_dsg_ptr.get()
+                                                                                   : level.dsg_ptr.get();
+        uint32_t                   flags         = 0;
+
+        if (!in_reduction)
+        {
+            flags |= FLAG_WRITE_OUTPUT;
+
+            if (n_level == 0 && in_inclusive)
+            {
+                flags |= FLAG_INCLUSIVE;
+            }
+        }
+
+        if (!is_last_level || in_reduction)
+        {
+            flags |= FLAG_WRITE_BLOCK_TOTAL;
+        }
+
+        if (n_level > 0)
+        {
+            result &= record_barrier(in_cmd_buffer_ptr);
+        }
+
+        result &= record_dispatch(in_cmd_buffer_ptr,
+                                  (n_level == 0) ? in_first_level_kernel : Kernel::SCAN_BLOCK,
+                                  dsg_ptr,
+                                  level_n_elements[n_level],
+                                  flags,
+                                  0, /* in_shift */
+                                  get_n_blocks(level_n_elements[n_level]) );
+    }
+
+    /* Down-sweep */
+    if (!in_reduction)
+    {
+        for (int32_t n_level = static_cast<int32_t>(n_levels) - 2;
+                     n_level >= 0;
+                   --n_level)
+        {
+            result &= record_barrier (in_cmd_buffer_ptr);
+            result &= record_dispatch(in_cmd_buffer_ptr,
+                                      Kernel::ADD_BLOCK_TOTALS,
+                                      m_scan_levels.at(n_level).dsg_ptr.get(),
+                                      level_n_elements[n_level],
+                                      0, /* in_flags */
+                                      0, /* in_shift */
+                                      get_n_blocks(level_n_elements[n_level]) );
+        }
+    }
+
+    return result;
+}
@@ -27,7 +27,8 @@
 
 /** Please see header for specification */
 Anvil::DescriptorSetCreateInfo::DescriptorSetCreateInfo()
-    :m_n_variable_descriptor_count_binding   (UINT32_MAX),
+    :m_create_flags                          (Anvil::DescriptorSetLayoutCreateFlagBits::NONE),
+     m_n_variable_descriptor_count_binding   (UINT32_MAX),
      m_variable_descriptor_count_binding_size(0)
 {
     /* Stub */
@@ -135,6 +136,16 @@ std::unique_ptr<Anvil::DescriptorSetLayoutCreateInfoContainer> Anvil::Descriptor
         goto end;
     }
 
+    if ( is_push_descriptor_layout()                                  &&
+        !in_device_ptr->get_extension_info()->khr_push_descriptor() )
+    {
+        /* Push descriptor layouts are only available on implementations that report support for VK_KHR_push_descriptor! */
+        anvil_assert(in_device_ptr->get_extension_info()->khr_push_descriptor() );
+
+        result_ptr.reset();
+        goto end;
+    }
+
     /* Count the number of immutable samplers defined. This is needed because if sampler_items is reallocated
      * after we start building the VkSampler array contents, all previously initialized VkDescriptorSetLayoutBinding
      * instances will start referring to invalid sampler arrays.
@@ -171,7 +182,7 @@ std::unique_ptr<Anvil::DescriptorSetLayoutCreateInfoContainer> Anvil::Descriptor
         VkDescriptorSetLayoutCreateInfo create_info;
 
         create_info.bindingCount = n_bindings_defined;
-        create_info.flags        = 0;
+        create_info.flags        = m_create_flags.get_vk();
         create_info.pNext        = nullptr;
         create_info.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
 
@@ -424,6 +435,7 @@ end:
 bool Anvil::DescriptorSetCreateInfo::operator==(const Anvil::DescriptorSetCreateInfo& in_ds) const
 {
     return (m_bindings                               == in_ds.m_bindings                               &&
+            m_create_flags                           == in_ds.m_create_flags                           &&
             m_n_variable_descriptor_count_binding    == in_ds.m_n_variable_descriptor_count_binding    &&
             m_variable_descriptor_count_binding_size == in_ds.m_variable_descriptor_count_binding_size);
 }
\ No newline at end of file
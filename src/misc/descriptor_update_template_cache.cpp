@@ -0,0 +1,218 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/descriptor_update_template_cache.h"
+#include "misc/object_tracker.h"
+#include "wrappers/descriptor_set_layout.h"
+#include "wrappers/descriptor_update_template.h"
+#include <algorithm>
+#include <functional>
+
+/* Please see header for specification */
+Anvil::DescriptorUpdateTemplateCache::DescriptorUpdateTemplateCache(const Anvil::BaseDevice* in_device_ptr)
+    :MTSafetySupportProvider(true),
+     m_device_ptr           (in_device_ptr),
+     m_n_cached_templates   (0)
+{
+    update_subscriptions(true);
+}
+
+/* Please see header for specification */
+Anvil::DescriptorUpdateTemplateCache::~DescriptorUpdateTemplateCache()
+{
+    update_subscriptions(false);
+}
+
+/* Please see header for specification */
+Anvil::DescriptorUpdateTemplateCacheUniquePtr Anvil::DescriptorUpdateTemplateCache::create(const Anvil::BaseDevice* in_device_ptr)
+{
+    Anvil::DescriptorUpdateTemplateCacheUniquePtr result_ptr(nullptr,
+                                                             std::default_delete<Anvil::DescriptorUpdateTemplateCache>() );
+
+    anvil_assert(in_device_ptr != nullptr);
+
+    result_ptr.reset(
+        new Anvil::DescriptorUpdateTemplateCache(in_device_ptr)
+    );
+
+    return result_ptr;
+}
+
+/** Computes a hash of the specified descriptor update template entries.
+ *
+ *  @param in_entries_ptr Array of @param in_n_entries entries to hash.
+ *  @param in_n_entries   Number of entries to hash.
+ *
+ *  @return As per description.
+ **/
+size_t Anvil::DescriptorUpdateTemplateCache::get_hash(const Anvil::DescriptorUpdateTemplateEntry* in_entries_ptr,
+                                                      uint32_t                                    in_n_entries)
+{
+    std::hash<size_t> hash_size_t;
+    size_t            result_hash(in_n_entries);
+
+    for (uint32_t n_entry = 0;
+                  n_entry < in_n_entries;
+                ++n_entry)
+    {
+        const auto&  current_entry = in_entries_ptr[n_entry];
+        const size_t values[] =
+        {
+            static_cast<size_t>(current_entry.descriptor_type),
+            current_entry.n_descriptors,
+            current_entry.n_destination_array_element,
+            current_entry.n_destination_binding,
+            current_entry.offset,
+            current_entry.stride
+        };
+
+        for (const auto& current_value : values)
+        {
+            /* Entry order matters, so mix the values instead of XORing them together */
+            result_hash ^= hash_size_t(current_value) + 0x9e3779b9 + (result_hash << 6) + (result_hash >> 2);
+        }
+    }
+
+    return result_hash;
+}
+
+/* Please see header for specification */
+uint32_t Anvil::DescriptorUpdateTemplateCache::get_n_cached_templates() const
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock(*get_mutex() );
+
+    return m_n_cached_templates;
+}
+
+/* Please see header for specification */
+const Anvil::DescriptorUpdateTemplate* Anvil::DescriptorUpdateTemplateCache::get_template(const Anvil::DescriptorSetLayout*           in_layout_ptr,
+                                                                                         const Anvil::DescriptorUpdateTemplateEntry* in_entries_ptr,
+                                                                                         uint32_t                                    in_n_entries)
+{
+    const size_t                           hash      (get_hash(in_entries_ptr,
+                                                               in_n_entries) );
+    std::unique_lock<std::recursive_mutex> mutex_lock(*get_mutex() );
+    std::unique_ptr<Item>                  new_item_ptr;
+    const Anvil::DescriptorUpdateTemplate* result_ptr(nullptr);
+
+    anvil_assert(in_layout_ptr  != nullptr);
+    anvil_assert(in_entries_ptr != nullptr);
+    anvil_assert(in_n_entries   >  0);
+
+    auto& items = m_items_per_layout[in_layout_ptr][hash];
+
+    for (const auto& current_item_ptr : items)
+    {
+        if (current_item_ptr->entries.size() == in_n_entries &&
+            std::equal(current_item_ptr->entries.begin(),
+                       current_item_ptr->entries.end  (),
+                       in_entries_ptr) )
+        {
+            result_ptr = current_item_ptr->template_ptr.get();
+
+            goto end;
+        }
+    }
+
+    /* Need to create a new template object.. */
+    new_item_ptr.reset(new Item() );
+
+    new_item_ptr->entries.assign(in_entries_ptr,
+                                 in_entries_ptr + in_n_entries);
+    new_item_ptr->template_ptr = Anvil::DescriptorUpdateTemplate::create_for_descriptor_set_updates(m_device_ptr,
+                                                                                                    in_layout_ptr,
+                                                                                                    in_entries_ptr,
+                                                                                                    in_n_entries,
+                                                                                                    Anvil::MTSafety::DISABLED);
+
+    if (new_item_ptr->template_ptr == nullptr)
+    {
+        anvil_assert(new_item_ptr->template_ptr != nullptr);
+
+        goto end;
+    }
+
+    result_ptr = new_item_ptr->template_ptr.get();
+
+    items.push_back(std::move(new_item_ptr) );
+
+    ++m_n_cached_templates;
+
+end:
+    return result_ptr;
+}
+
+/** Releases all templates created for a descriptor set layout which is about to be released.
+ *
+ *  @param in_callback_arg_ptr OnObjectAboutToBeUnregisteredCallbackArgument instance. Must not be nullptr.
+ **/
+void Anvil::DescriptorUpdateTemplateCache::on_descriptor_set_layout_object_about_to_be_released(CallbackArgument* in_callback_arg_ptr)
+{
+    const auto                             callback_arg_ptr(dynamic_cast<OnObjectAboutToBeUnregisteredCallbackArgument*>(in_callback_arg_ptr) );
+    std::unique_lock<std::recursive_mutex> mutex_lock      (*get_mutex() );
+    const Anvil::DescriptorSetLayout*      layout_ptr      (nullptr);
+    decltype(m_items_per_layout)::iterator layout_iterator;
+
+    anvil_assert(callback_arg_ptr != nullptr);
+
+    layout_ptr      = static_cast<const Anvil::DescriptorSetLayout*>(callback_arg_ptr->object_raw_ptr);
+    layout_iterator = m_items_per_layout.find(layout_ptr);
+
+    if (layout_iterator != m_items_per_layout.end() )
+    {
+        for (const auto& current_hash_items : layout_iterator->second)
+        {
+            anvil_assert(m_n_cached_templates >= static_cast<uint32_t>(current_hash_items.second.size() ));
+
+            m_n_cached_templates -= static_cast<uint32_t>(current_hash_items.second.size() );
+        }
+
+        m_items_per_layout.erase(layout_iterator);
+    }
+}
+
+/** Subscribes to or unsubscribes from object tracker notifications about descriptor set layout releases.
+ *
+ *  @param in_should_init true to subscribe, false to unsubscribe.
+ **/
+void Anvil::DescriptorUpdateTemplateCache::update_subscriptions(bool in_should_init)
+{
+    auto object_tracker_ptr = Anvil::ObjectTracker::get();
+
+    auto on_object_about_to_be_released_func = std::bind(&DescriptorUpdateTemplateCache::on_descriptor_set_layout_object_about_to_be_released,
+                                                         this,
+                                                         std::placeholders::_1);
+
+    if (in_should_init)
+    {
+        object_tracker_ptr->register_for_callbacks(OBJECT_TRACKER_CALLBACK_ID_ON_DESCRIPTOR_SET_LAYOUT_OBJECT_ABOUT_TO_BE_UNREGISTERED,
+                                                   on_object_about_to_be_released_func,
+                                                   this);
+    }
+    else
+    {
+        object_tracker_ptr->unregister_from_callbacks(OBJECT_TRACKER_CALLBACK_ID_ON_DESCRIPTOR_SET_LAYOUT_OBJECT_ABOUT_TO_BE_UNREGISTERED,
+                                                      on_object_about_to_be_released_func,
+                                                      this);
+    }
+}
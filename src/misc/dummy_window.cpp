@@ -21,14 +21,19 @@
 //
 #include "misc/buffer_create_info.h"
 #include "misc/dummy_window.h"
+#include "misc/fence_create_info.h"
+#include "misc/formats.h"
 #include "misc/image_create_info.h"
 #include "misc/io.h"
 #include "misc/swapchain_create_info.h"
 #include "wrappers/buffer.h"
 #include "wrappers/command_buffer.h"
 #include "wrappers/command_pool.h"
+#include "wrappers/device.h"
+#include "wrappers/fence.h"
 #include "wrappers/semaphore.h"
 #include "wrappers/swapchain.h"
+#include <algorithm>
 #include <sstream>
 #include <thread>
 
@@ -154,45 +159,190 @@ Anvil::DummyWindowWithPNGSnapshots::DummyWindowWithPNGSnapshots(const std::strin
                  in_height,
                  in_present_callback_func)
 {
-    m_height             = in_height;
-    m_n_frames_presented = 0;
-    m_swapchain_ptr      = nullptr;
-    m_title              = in_title;
-    m_width              = in_width;
-    m_window_owned       = true;
+    m_height               = in_height;
+    m_n_frames_presented   = 0;
+    m_n_jobs_in_progress   = 0;
+    m_n_next_readback_slot = 0;
+    m_swapchain_ptr        = nullptr;
+    m_title                = in_title;
+    m_width                = in_width;
+    m_window_owned         = true;
+    m_workers_terminating  = false;
 }
 
 /** Please see header for specification */
-std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_image_raw_r8g8b8a8_unorm_data(Anvil::Image* in_swapchain_image_ptr)
+Anvil::DummyWindowWithPNGSnapshots::~DummyWindowWithPNGSnapshots()
+{
+    /* Readback slots are normally flushed at the end of run(). Do not rely on it: if run() has not been called or
+     * has not returned, readbacks may still be in flight. Wait for them & hand them over to worker threads before
+     * the slots and the command pool are released. This is a nop if there is nothing left to flush. */
+    flush_snapshots();
+
+    /* Worker threads drain the job queue before they quit. */
+    {
+        std::unique_lock<std::mutex> lock(m_job_queue_mutex);
+
+        m_workers_terminating = true;
+    }
+
+    m_job_queue_changed_cv.notify_all();
+
+    for (auto& current_thread : m_worker_threads)
+    {
+        current_thread.join();
+    }
+}
+
+/** Please see header for specification */
+void Anvil::DummyWindowWithPNGSnapshots::flush_snapshots()
+{
+    /* Harvest all in-flight readbacks in submission order. */
+    for (uint32_t n_slot = 0;
+                  n_slot < static_cast<uint32_t>(m_readback_slots.size() );
+                ++n_slot)
+    {
+        auto slot_ptr = m_readback_slots.at( (m_n_next_readback_slot + n_slot) % m_readback_slots.size() ).get();
+
+        if (slot_ptr->is_in_flight)
+        {
+            harvest_readback_slot(slot_ptr,
+                                  true); /* in_should_block */
+        }
+    }
+
+    /* Wait until worker threads are done with all the snapshots */
+    {
+        std::unique_lock<std::mutex> lock(m_job_queue_mutex);
+
+        m_job_queue_changed_cv.wait(lock,
+                                    [this]()
+                                    {
+                                        return m_job_queue.empty() && m_n_jobs_in_progress == 0;
+                                    });
+    }
+
+    /* Command buffers must be released before their parent pool. */
+    m_readback_slots.clear();
+    m_command_pool_ptr.reset();
+
+    m_n_next_readback_slot = 0;
+}
+
+/** Please see header for specification */
+bool Anvil::DummyWindowWithPNGSnapshots::harvest_readback_slot(ReadbackSlot* in_slot_ptr,
+                                                               bool          in_should_block)
+{
+    SnapshotJob new_job;
+    bool        result = false;
+
+    anvil_assert(in_slot_ptr->is_in_flight);
+
+    if (in_should_block)
+    {
+        Anvil::Vulkan::vkWaitForFences(m_swapchain_ptr->get_create_info_ptr()->get_device()->get_device_vk(),
+                                       1, /* fenceCount */
+                                       in_slot_ptr->fence_ptr->get_fence_ptr(),
+                                       VK_TRUE, /* waitAll */
+                                       UINT64_MAX);
+    }
+    else
+    if (!in_slot_ptr->fence_ptr->is_set() )
+    {
+        goto end;
+    }
+
+    new_job.data_ptr.reset(new uint8_t[static_cast<size_t>(in_slot_ptr->buffer_size)]);
+    new_job.file_name = in_slot_ptr->file_name;
+    new_job.format    = in_slot_ptr->format;
+    new_job.height    = in_slot_ptr->height;
+    new_job.width     = in_slot_ptr->width;
+
+    in_slot_ptr->buffer_ptr->read(0, /* in_start_offset */
+                                  in_slot_ptr->buffer_size,
+                                  new_job.data_ptr.get() );
+
+    in_slot_ptr->is_in_flight = false;
+
+    /* Hand the snapshot over to the worker threads. If they are falling behind, wait for them to catch up so that
+     * the number of pending snapshots (and the memory they occupy) stays bounded. */
+    {
+        std::unique_lock<std::mutex> lock(m_job_queue_mutex);
+
+        m_job_queue_changed_cv.wait(lock,
+                                    [this]()
+                                    {
+                                        return m_job_queue.size() < N_MAX_PENDING_JOBS_PER_WORKER * m_worker_threads.size();
+                                    });
+
+        m_job_queue.push_back(std::move(new_job) );
+    }
+
+    m_job_queue_changed_cv.notify_all();
+
+    result = true;
+end:
+    return result;
+}
+
+/** Please see header for specification */
+void Anvil::DummyWindowWithPNGSnapshots::run()
+{
+    bool running = true;
+
+    while (running && !m_window_should_close)
+    {
+        m_present_callback_func();
+
+        store_swapchain_frame();
+
+        running = !m_window_should_close;
+    }
+
+    /* Make sure all snapshots hit the disk before the app is given a chance to release the swapchain & the device. */
+    flush_snapshots();
+
+    m_window_close_finished = true;
+}
+
+/** Please see header for specification */
+bool Anvil::DummyWindowWithPNGSnapshots::schedule_readback(ReadbackSlot*      in_slot_ptr,
+                                                           Anvil::Image*      in_swapchain_image_ptr,
+                                                           const std::string& in_file_name)
 {
     const Anvil::BaseDevice*           device_ptr                       (m_swapchain_ptr->get_create_info_ptr()->get_device() );
-    std::unique_ptr<uint8_t[]>         result_ptr;
-    Anvil::Format                      swapchain_image_format           (in_swapchain_image_ptr->get_create_info_ptr()->get_format() );
+    uint32_t                           n_component_bits[4]              = {0};
+    bool                               result                           (false);
+    const Anvil::Format                swapchain_image_format           (in_swapchain_image_ptr->get_create_info_ptr()->get_format() );
+    uint32_t                           swapchain_image_height           (0);
+    VkDeviceSize                       swapchain_image_size             (0);
     const Anvil::ImageSubresourceRange swapchain_image_subresource_range(in_swapchain_image_ptr->get_subresource_range            () );
+    uint32_t                           swapchain_image_width            (0);
+    Anvil::Queue*                      universal_queue_ptr              (device_ptr->get_universal_queue(0) );
+    const uint32_t                     universal_queue_family_index     (universal_queue_ptr->get_queue_family_index() );
 
-    /* Sanity checks .. */
-    ANVIL_REDUNDANT_VARIABLE(swapchain_image_format);
-
+    anvil_assert(!in_slot_ptr->is_in_flight);
     anvil_assert(swapchain_image_subresource_range.aspect_mask == Anvil::ImageAspectFlagBits::COLOR_BIT);
 
-    /* Initialize storage for the raw R8G8B8A8 image data */
-    Anvil::BufferUniquePtr raw_image_buffer_ptr;
-    uint32_t               raw_image_size         = 0;
-    uint32_t               swapchain_image_height = 0;
-    uint32_t               swapchain_image_width  = 0;
-
     in_swapchain_image_ptr->get_image_mipmap_size(0, /* n_mipmap */
                                                  &swapchain_image_width,
                                                  &swapchain_image_height,
-                                                 nullptr); /* out_opt_depth_ptr */
+                                                  nullptr); /* out_opt_depth_ptr */
 
-    raw_image_size = 4 /* RGBA8 */ * swapchain_image_width * swapchain_image_height;
+    Anvil::Formats::get_format_n_component_bits_nonyuv(swapchain_image_format,
+                                                       n_component_bits + 0,
+                                                       n_component_bits + 1,
+                                                       n_component_bits + 2,
+                                                       n_component_bits + 3);
 
-    result_ptr.reset(new unsigned char[raw_image_size]);
+    swapchain_image_size = static_cast<VkDeviceSize>(swapchain_image_width) * swapchain_image_height *
+                           (n_component_bits[0] + n_component_bits[1] + n_component_bits[2] + n_component_bits[3]) / 8;
 
+    /* Swapchain images are copied as-is. Conversion to R8G8B8A8 is done on the CPU by worker threads,
+     * so no intermediate image or blit is needed. */
+    if (in_slot_ptr->buffer_size != swapchain_image_size)
     {
         auto create_info_ptr = Anvil::BufferCreateInfo::create_alloc(device_ptr,
-                                                                     raw_image_size,
+                                                                     swapchain_image_size,
                                                                      Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
                                                                      Anvil::SharingMode::EXCLUSIVE,
                                                                      Anvil::BufferCreateFlagBits::NONE,
@@ -201,50 +351,33 @@ std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_ima
 
         create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
 
-        raw_image_buffer_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
-    }
+        in_slot_ptr->buffer_ptr  = Anvil::Buffer::create(std::move(create_info_ptr) );
+        in_slot_ptr->buffer_size = swapchain_image_size;
 
-    /* 2. Create the intermediate image */
-    Anvil::ImageBlit intermediate_image_blit;
-    ImageUniquePtr   intermediate_image_ptr;
+        if (in_slot_ptr->buffer_ptr == nullptr)
+        {
+            anvil_assert(in_slot_ptr->buffer_ptr != nullptr);
 
-    {
-        auto create_info_ptr = Anvil::ImageCreateInfo::create_alloc(device_ptr,
-                                                                    Anvil::ImageType::_2D,
-                                                                    Anvil::Format::R8G8B8A8_UNORM,
-                                                                    Anvil::ImageTiling::OPTIMAL,
-                                                                    Anvil::ImageUsageFlagBits::TRANSFER_SRC_BIT | Anvil::ImageUsageFlagBits::TRANSFER_DST_BIT,
-                                                                    swapchain_image_width,
-                                                                    swapchain_image_height,
-                                                                    1,      /* in_base_mipmap_depth */
-                                                                    1,      /* in_n_layers          */
-                                                                    Anvil::SampleCountFlagBits::_1_BIT,
-                                                                    Anvil::QueueFamilyFlagBits::GRAPHICS_BIT,
-                                                                    Anvil::SharingMode::EXCLUSIVE,
-                                                                    false,  /* in_use_full_mipmap_chain */
-                                                                    Anvil::MemoryFeatureFlagBits::NONE,
-                                                                    Anvil::ImageCreateFlagBits::NONE,
-                                                                    Anvil::ImageLayout::TRANSFER_DST_OPTIMAL);
+            in_slot_ptr->buffer_size = 0;
 
-        create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
-
-        intermediate_image_ptr = Anvil::Image::create(std::move(create_info_ptr) );
+            goto end;
+        }
     }
 
-    /* 3. Set up the command buffer */
-    auto                command_buffer_ptr           = Anvil::PrimaryCommandBufferUniquePtr();
-    Anvil::CommandPool* universal_command_pool_ptr   = nullptr;
-    Anvil::Queue*       universal_queue_ptr          = device_ptr->get_universal_queue            (0);
-    const uint32_t      universal_queue_family_index = universal_queue_ptr->get_queue_family_index();
-
-    universal_command_pool_ptr = device_ptr->get_command_pool_for_queue_family_index(universal_queue_ptr->get_queue_family_index() );
-    command_buffer_ptr         = universal_command_pool_ptr->alloc_primary_level_command_buffer();
-
-    command_buffer_ptr->start_recording(true,   /* one_time_submit          */
-                                        false); /* simultaneous_use_allowed */
+    in_slot_ptr->cmd_buffer_ptr->start_recording(true,   /* one_time_submit          */
+                                                 false); /* simultaneous_use_allowed */
     {
         Anvil::BufferImageCopy buffer_image_copy_region;
 
+        Anvil::BufferBarrier transfer_dst_to_host_read_buffer_barrier(
+            Anvil::AccessFlagBits::TRANSFER_WRITE_BIT, /* source_access_mask      */
+            Anvil::AccessFlagBits::HOST_READ_BIT,      /* destination_access_mask */
+            universal_queue_family_index,
+            universal_queue_family_index,
+            in_slot_ptr->buffer_ptr.get(),
+            0, /* in_offset */
+            swapchain_image_size);
+
         Anvil::ImageBarrier general_to_transfer_src_image_barrier(
             Anvil::AccessFlagBits::COLOR_ATTACHMENT_WRITE_BIT | Anvil::AccessFlagBits::TRANSFER_WRITE_BIT | Anvil::AccessFlagBits::MEMORY_READ_BIT, /* source_access_mask      */
             Anvil::AccessFlagBits::TRANSFER_READ_BIT,                                                                                               /* destination_access_mask */
@@ -256,16 +389,6 @@ std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_ima
             swapchain_image_subresource_range
         );
 
-        Anvil::ImageBarrier transfer_dst_to_transfer_src_image_barrier(
-            Anvil::AccessFlagBits::TRANSFER_WRITE_BIT, /* source_access_mask      */
-            Anvil::AccessFlagBits::TRANSFER_READ_BIT,  /* desitnation_access_mask */
-            Anvil::ImageLayout::TRANSFER_DST_OPTIMAL,
-            Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
-            universal_queue_family_index,
-            universal_queue_family_index,
-            intermediate_image_ptr.get(),
-            swapchain_image_subresource_range);
-
         Anvil::ImageBarrier transfer_src_to_general_image_barrier(
             Anvil::AccessFlagBits::TRANSFER_READ_BIT, /* source_access_mask      */
             Anvil::AccessFlags(),                     /* destination_access_mask */
@@ -276,47 +399,15 @@ std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_ima
             in_swapchain_image_ptr,
             swapchain_image_subresource_range);
 
-        command_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::COLOR_ATTACHMENT_OUTPUT_BIT | Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* src_stage_mask                 */
-                                                    Anvil::PipelineStageFlagBits::TRANSFER_BIT,                                                             /* dst_stage_mask                 */
-                                                    Anvil::DependencyFlagBits::NONE,
-                                                    0,                                                                                                      /* in_memory_barrier_count        */
-                                                    nullptr,                                                                                                /* in_memory_barrier_ptrs         */
-                                                    0,                                                                                                      /* in_buffer_memory_barrier_count */
-                                                    nullptr,                                                                                                /* in_buffer_memory_barrier_ptrs  */
-                                                    1,                                                                                                      /* in_image_memory_barrier_count  */
-                                                   &general_to_transfer_src_image_barrier);
-
-        intermediate_image_blit.dst_offsets[0].x                 = 0;
-        intermediate_image_blit.dst_offsets[0].y                 = 0;
-        intermediate_image_blit.dst_offsets[0].z                 = 0;
-        intermediate_image_blit.dst_offsets[1].x                 = static_cast<int32_t>(swapchain_image_width);
-        intermediate_image_blit.dst_offsets[1].y                 = static_cast<int32_t>(swapchain_image_height);
-        intermediate_image_blit.dst_offsets[1].z                 = 1;
-        intermediate_image_blit.dst_subresource.base_array_layer = 0;
-        intermediate_image_blit.dst_subresource.layer_count      = 1;
-        intermediate_image_blit.dst_subresource.aspect_mask      = Anvil::ImageAspectFlagBits::COLOR_BIT;
-        intermediate_image_blit.dst_subresource.mip_level        = 0;
-        intermediate_image_blit.src_offsets[0]                   = intermediate_image_blit.dst_offsets[0];
-        intermediate_image_blit.src_offsets[1]                   = intermediate_image_blit.dst_offsets[1];
-        intermediate_image_blit.src_subresource                  = intermediate_image_blit.dst_subresource;
-
-        command_buffer_ptr->record_blit_image(in_swapchain_image_ptr,
-                                              Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
-                                              intermediate_image_ptr.get(),
-                                              Anvil::ImageLayout::TRANSFER_DST_OPTIMAL,
-                                              1, /* regionCount */
-                                             &intermediate_image_blit,
-                                              Anvil::Filter::NEAREST);
-
-        command_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* src_stage_mask                 */
-                                                    Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* dst_stage_mask                 */
-                                                    Anvil::DependencyFlagBits::NONE,
-                                                    0,                                          /* in_memory_barrier_count        */
-                                                    nullptr,                                    /* in_memory_barrier_ptrs         */
-                                                    0,                                          /* in_buffer_memory_barrier_count */
-                                                    nullptr,                                    /* in_buffer_memory_barrier_ptrs  */
-                                                    1,                                          /* in_image_memory_barrier_count  */
-                                                   &transfer_dst_to_transfer_src_image_barrier);
+        in_slot_ptr->cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::COLOR_ATTACHMENT_OUTPUT_BIT | Anvil::PipelineStageFlagBits::TRANSFER_BIT, /* src_stage_mask                 */
+                                                             Anvil::PipelineStageFlagBits::TRANSFER_BIT,                                                             /* dst_stage_mask                 */
+                                                             Anvil::DependencyFlagBits::NONE,
+                                                             0,                                                                                                      /* in_memory_barrier_count        */
+                                                             nullptr,                                                                                                /* in_memory_barrier_ptrs         */
+                                                             0,                                                                                                      /* in_buffer_memory_barrier_count */
+                                                             nullptr,                                                                                                /* in_buffer_memory_barrier_ptrs  */
+                                                             1,                                                                                                      /* in_image_memory_barrier_count  */
+                                                            &general_to_transfer_src_image_barrier);
 
         buffer_image_copy_region.buffer_image_height                = 0; /* assume tight packing */
         buffer_image_copy_region.buffer_offset                      = 0;
@@ -332,57 +423,50 @@ std::unique_ptr<uint8_t[]> Anvil::DummyWindowWithPNGSnapshots::get_swapchain_ima
         buffer_image_copy_region.image_subresource.layer_count      = 1;
         buffer_image_copy_region.image_subresource.mip_level        = 0;
 
-        command_buffer_ptr->record_copy_image_to_buffer(intermediate_image_ptr.get(),
-                                                        Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
-                                                        raw_image_buffer_ptr.get(),
-                                                        1, /* regionCount */
-                                                       &buffer_image_copy_region);
-
-        command_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT,    /* src_stage_mask */
-                                                    Anvil::PipelineStageFlagBits::TOP_OF_PIPE_BIT, /* dst_stage_mask */
-                                                    Anvil::DependencyFlagBits::NONE,
-                                                    0,                                             /* in_memory_barrier_count        */
-                                                    nullptr,                                       /* in_memory_barrier_ptrs         */
-                                                    0,                                             /* in_buffer_memory_barrier_count */
-                                                    nullptr,                                       /* in_buffer_memory_barrier_ptrs  */
-                                                    1,                                             /* in_image_memory_barrier_count  */
-                                                   &transfer_src_to_general_image_barrier);
+        in_slot_ptr->cmd_buffer_ptr->record_copy_image_to_buffer(in_swapchain_image_ptr,
+                                                                 Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
+                                                                 in_slot_ptr->buffer_ptr.get(),
+                                                                 1, /* regionCount */
+                                                                &buffer_image_copy_region);
+
+        /* Nothing waits for the copy on the CPU, so commands submitted later which write to the swapchain image
+         * need an execution dependency on the transfer read. */
+        in_slot_ptr->cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT,                                          /* src_stage_mask */
+                                                             Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT | Anvil::PipelineStageFlagBits::HOST_BIT, /* dst_stage_mask */
+                                                             Anvil::DependencyFlagBits::NONE,
+                                                             0,                                                                                   /* in_memory_barrier_count        */
+                                                             nullptr,                                                                             /* in_memory_barrier_ptrs         */
+                                                             1,                                                                                   /* in_buffer_memory_barrier_count */
+                                                            &transfer_dst_to_host_read_buffer_barrier,
+                                                             1,                                                                                   /* in_image_memory_barrier_count  */
+                                                            &transfer_src_to_general_image_barrier);
     }
-    command_buffer_ptr->stop_recording();
+    in_slot_ptr->cmd_buffer_ptr->stop_recording();
 
-    /* Execute the command buffer */
+    in_slot_ptr->fence_ptr->reset();
+
+    /* Submit the command buffer. Do NOT wait for the copy to finish. */
     {
-        Anvil::CommandBufferBase* cmd_buffer_raw_ptr = command_buffer_ptr.get();
+        Anvil::CommandBufferBase* cmd_buffer_raw_ptr = in_slot_ptr->cmd_buffer_ptr.get();
 
-        universal_queue_ptr->submit(Anvil::SubmitInfo::create_execute(&cmd_buffer_raw_ptr,
-                                                                      1,    /* in_n_cmd_buffers */
-                                                                      true) /* should_block     */
+        result = universal_queue_ptr->submit(Anvil::SubmitInfo::create_execute(&cmd_buffer_raw_ptr,
+                                                                               1,     /* in_n_cmd_buffers */
+                                                                               false, /* should_block     */
+                                                                               in_slot_ptr->fence_ptr.get() )
         );
     }
 
-    /* Read back the result data */
-    raw_image_buffer_ptr->read(0, /* offset */
-                               raw_image_size,
-                               result_ptr.get() );
-
-    return result_ptr;
-}
-
-/** Please see header for specification */
-void Anvil::DummyWindowWithPNGSnapshots::run()
-{
-    bool running = true;
-
-    while (running && !m_window_should_close)
+    if (result)
     {
-        m_present_callback_func();
-
-        store_swapchain_frame();
-
-        running = !m_window_should_close;
+        in_slot_ptr->file_name    = in_file_name;
+        in_slot_ptr->format       = swapchain_image_format;
+        in_slot_ptr->height       = swapchain_image_height;
+        in_slot_ptr->is_in_flight = true;
+        in_slot_ptr->width        = swapchain_image_width;
     }
 
-    m_window_close_finished = true;
+end:
+    return result;
 }
 
 /** Please see header for specification */
@@ -398,16 +482,80 @@ void Anvil::DummyWindowWithPNGSnapshots::store_swapchain_frame()
 {
     anvil_assert(m_swapchain_ptr != nullptr);
 
-    /* Retrieve image contents */
-    const uint32_t swapchain_image_index        = m_swapchain_ptr->get_last_acquired_image_index();
-    Anvil::Image*  swapchain_image_ptr          = m_swapchain_ptr->get_image                    (swapchain_image_index);
-    auto           swapchain_image_raw_data_ptr = get_swapchain_image_raw_r8g8b8a8_unorm_data   (swapchain_image_ptr);
-    uint32_t       swapchain_image_size[2];
+    const Anvil::BaseDevice* device_ptr            = m_swapchain_ptr->get_create_info_ptr()->get_device();
+    ReadbackSlot*            slot_ptr              = nullptr;
+    const uint32_t           swapchain_image_index = m_swapchain_ptr->get_last_acquired_image_index();
+    Anvil::Image*            swapchain_image_ptr   = m_swapchain_ptr->get_image(swapchain_image_index);
+
+    /* Spawn worker threads & set up readback slots on first use. One hardware thread is left to the rendering thread. */
+    if (m_worker_threads.size() == 0)
+    {
+        const uint32_t n_workers = std::min(std::max(std::thread::hardware_concurrency(), 2u) - 1,
+                                            static_cast<uint32_t>(N_MAX_WORKERS) );
+
+        for (uint32_t n_worker = 0;
+                      n_worker < n_workers;
+                    ++n_worker)
+        {
+            m_worker_threads.push_back(
+                std::thread(&DummyWindowWithPNGSnapshots::worker_thread_main,
+                            this)
+            );
+        }
+    }
+
+    if (m_readback_slots.size() == 0)
+    {
+        m_command_pool_ptr = Anvil::CommandPool::create(const_cast<Anvil::BaseDevice*>(device_ptr),
+                                                        Anvil::CommandPoolCreateFlagBits::CREATE_RESET_COMMAND_BUFFER_BIT,
+                                                        device_ptr->get_universal_queue(0)->get_queue_family_index(),
+                                                        Anvil::MTSafety::DISABLED);
+
+        anvil_assert(m_command_pool_ptr != nullptr);
+
+        for (uint32_t n_slot = 0;
+                      n_slot < N_READBACK_SLOTS;
+                    ++n_slot)
+        {
+            std::unique_ptr<ReadbackSlot> new_slot_ptr(new ReadbackSlot() );
 
-    swapchain_image_ptr->get_image_mipmap_size(0, /* n_mipmap */
-                                               swapchain_image_size + 0,
-                                               swapchain_image_size + 1,
-                                               nullptr); /* out_opt_depth_ptr */
+            {
+                auto create_info_ptr = Anvil::FenceCreateInfo::create(device_ptr,
+                                                                      false); /* in_create_signalled */
+
+                create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
+
+                new_slot_ptr->fence_ptr = Anvil::Fence::create(std::move(create_info_ptr) );
+            }
+
+            new_slot_ptr->cmd_buffer_ptr = m_command_pool_ptr->alloc_primary_level_command_buffer();
+
+            m_readback_slots.push_back(std::move(new_slot_ptr) );
+        }
+    }
+
+    /* Pass readbacks which have already completed to worker threads. This never blocks on the GPU. */
+    for (uint32_t n_slot = 0;
+                  n_slot < N_READBACK_SLOTS;
+                ++n_slot)
+    {
+        auto current_slot_ptr = m_readback_slots.at( (m_n_next_readback_slot + n_slot) % N_READBACK_SLOTS).get();
+
+        if (current_slot_ptr->is_in_flight)
+        {
+            harvest_readback_slot(current_slot_ptr,
+                                  false); /* in_should_block */
+        }
+    }
+
+    /* If all slots are busy, wait for the oldest readback to complete */
+    slot_ptr = m_readback_slots.at(m_n_next_readback_slot).get();
+
+    if (slot_ptr->is_in_flight)
+    {
+        harvest_readback_slot(slot_ptr,
+                              true); /* in_should_block */
+    }
 
     /* Determine what name should be used for the snapshot file */
     std::stringstream snapshot_file_name_sstream;
@@ -417,23 +565,103 @@ void Anvil::DummyWindowWithPNGSnapshots::store_swapchain_frame()
                                << m_n_frames_presented++
                                << ".png";
 
-    /* Convert the retrieved data to a PNG blob */
-    void*  result_data_ptr  = nullptr;
-    size_t result_data_size = 0;
+    if (schedule_readback(slot_ptr,
+                          swapchain_image_ptr,
+                          snapshot_file_name_sstream.str() ))
+    {
+        m_n_next_readback_slot = (m_n_next_readback_slot + 1) % N_READBACK_SLOTS;
+    }
+}
 
-    result_data_ptr = tdefl_write_image_to_png_file_in_memory(swapchain_image_raw_data_ptr.get(),
-                                                              static_cast<int32_t>(swapchain_image_size[0]),
-                                                              static_cast<int32_t>(swapchain_image_size[1]),
-                                                              4, /* num_chans */
-                                                             &result_data_size);
+/** Please see header for specification */
+void Anvil::DummyWindowWithPNGSnapshots::worker_thread_main()
+{
+    while (true)
+    {
+        SnapshotJob job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_job_queue_mutex);
+
+            m_job_queue_changed_cv.wait(lock,
+                                        [this]()
+                                        {
+                                            return m_workers_terminating || !m_job_queue.empty();
+                                        });
+
+            if (m_job_queue.empty() )
+            {
+                /* Only ever reached if the window is being destroyed */
+                break;
+            }
+
+            job = std::move(m_job_queue.front() );
+
+            m_job_queue.pop_front();
+            m_n_jobs_in_progress++;
+        }
 
-    anvil_assert(result_data_ptr != nullptr);
+        /* A slot in the queue has been freed up, so the rendering thread may need waking up. */
+        m_job_queue_changed_cv.notify_all();
 
-    /* Store it in a file */
-    Anvil::IO::write_binary_file(snapshot_file_name_sstream.str(),
-                                 result_data_ptr,
-                                 static_cast<uint32_t>(result_data_size) );
+        {
+            std::unique_ptr<uint8_t[]> rgba8_data_ptr;
+            const uint8_t*             png_input_data_ptr = job.data_ptr.get();
+            void*                      result_data_ptr    = nullptr;
+            size_t                     result_data_size   = 0;
+
+            /* Convert the retrieved data to R8G8B8A8_UNORM, unless it already uses that format */
+            if (job.format != Anvil::Format::R8G8B8A8_UNORM)
+            {
+                rgba8_data_ptr.reset(new uint8_t[static_cast<size_t>(job.width) * job.height * 4 /* RGBA8 */]);
+
+                if (Anvil::Formats::convert_pixels(job.format,
+                                                   job.data_ptr.get(),
+                                                   Anvil::Format::R8G8B8A8_UNORM,
+                                                   rgba8_data_ptr.get(),
+                                                   job.width * job.height) )
+                {
+                    png_input_data_ptr = rgba8_data_ptr.get();
+                }
+                else
+                {
+                    png_input_data_ptr = nullptr;
+                }
+
+                /* Raw swapchain data is no longer needed */
+                job.data_ptr.reset();
+            }
+
+            /* Convert the R8G8B8A8 data to a PNG blob */
+            if (png_input_data_ptr != nullptr)
+            {
+                result_data_ptr = tdefl_write_image_to_png_file_in_memory(png_input_data_ptr,
+                                                                          static_cast<int32_t>(job.width),
+                                                                          static_cast<int32_t>(job.height),
+                                                                          4, /* num_chans */
+                                                                         &result_data_size);
+            }
+
+            anvil_assert(result_data_ptr != nullptr);
+
+            /* Store it in a file */
+            if (result_data_ptr != nullptr)
+            {
+                Anvil::IO::write_binary_file(job.file_name,
+                                             result_data_ptr,
+                                             static_cast<uint32_t>(result_data_size) );
+
+                /* Clean up */
+                free(result_data_ptr);
+            }
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_job_queue_mutex);
 
-    /* Clean up */
-    free(result_data_ptr);
-}
\ No newline at end of file
+            m_n_jobs_in_progress--;
+        }
+
+        m_job_queue_changed_cv.notify_all();
+    }
+}
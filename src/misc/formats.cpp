@@ -24,8 +24,16 @@
 #include "misc/formats.h"
 #include "misc/types.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <unordered_map>
 
+#if defined(__SSSE3__) || defined(__AVX__)
+    #include <tmmintrin.h>
+
+    #define ANVIL_FORMATS_USE_SSSE3
+#endif
+
 static const struct FormatInfo
 {
     Anvil::Format          format;
@@ -507,13 +515,13 @@ static const std::unordered_map<Anvil::Format, NonYUVFormatBitLayoutInfo, Anvil:
     {Anvil::Format::R8G8_UINT,                   {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
     {Anvil::Format::R8G8_SINT,                   {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
     {Anvil::Format::R8G8_SRGB,                   {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
-    {Anvil::Format::R8G8B8_UNORM,                {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
-    {Anvil::Format::R8G8B8_SNORM,                {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
-    {Anvil::Format::R8G8B8_USCALED,              {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
-    {Anvil::Format::R8G8B8_SSCALED,              {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
-    {Anvil::Format::R8G8B8_UINT,                 {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
-    {Anvil::Format::R8G8B8_SINT,                 {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
-    {Anvil::Format::R8G8B8_SRGB,                 {0,          7,          8,            15,         UINT32_MAX,  UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
+    {Anvil::Format::R8G8B8_UNORM,                {0,          7,          8,            15,         16,          23,          UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
+    {Anvil::Format::R8G8B8_SNORM,                {0,          7,          8,            15,         16,          23,          UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
+    {Anvil::Format::R8G8B8_USCALED,              {0,          7,          8,            15,         16,          23,          UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
+    {Anvil::Format::R8G8B8_SSCALED,              {0,          7,          8,            15,         16,          23,          UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
+    {Anvil::Format::R8G8B8_UINT,                 {0,          7,          8,            15,         16,          23,          UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
+    {Anvil::Format::R8G8B8_SINT,                 {0,          7,          8,            15,         16,          23,          UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
+    {Anvil::Format::R8G8B8_SRGB,                 {0,          7,          8,            15,         16,          23,          UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
     {Anvil::Format::B8G8R8_UNORM,                {16,         23,         8,            15,         0,           7,           UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
     {Anvil::Format::B8G8R8_SNORM,                {16,         23,         8,            15,         0,           7,           UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
     {Anvil::Format::B8G8R8_USCALED,              {16,         23,         8,            15,         0,           7,           UINT32_MAX,   UINT32_MAX, UINT32_MAX,    UINT32_MAX,  UINT32_MAX,   UINT32_MAX, UINT32_MAX,     UINT32_MAX} },
@@ -1192,6 +1200,1438 @@ static const std::vector<Anvil::Format> g_compatibility_classes[] =
     }
 };
 
+/* Pixel conversion helpers ==> */
+
+/** Bit-casts a float to its 32-bit integer representation and vice versa. */
+static uint32_t float_as_uint(float in_value)
+{
+    uint32_t result;
+
+    memcpy(&result,
+           &in_value,
+           sizeof(result) );
+
+    return result;
+}
+
+static float uint_as_float(uint32_t in_value)
+{
+    float result;
+
+    memcpy(&result,
+           &in_value,
+           sizeof(result) );
+
+    return result;
+}
+
+/** Converts a single FP16 value to FP32. Uses the same approach as the vectorized path, so both yield
+ *  bit-identical results.
+ *
+ *  Unlike fp16_to_fp32_fast5(), the exponent is rebiased with integer arithmetic, so FP16 denormals
+ *  convert correctly even if the FPU has been configured to flush FP32 denormals to zero (as is the case
+ *  for -ffast-math builds).
+ **/
+static float convert_fp16_to_fp32(uint16_t in_value)
+{
+    const uint32_t shifted_exp = 0x7c00u << 13;
+    uint32_t       result_u32  = (in_value & 0x7fffu) << 13;
+    const uint32_t exp         = result_u32 & shifted_exp;
+
+    result_u32 += (127 - 15) << 23;
+
+    if (exp == shifted_exp)
+    {
+        /* Inf/NaN */
+        result_u32 += (128 - 16) << 23;
+    }
+    else
+    if (exp == 0)
+    {
+        /* Zero/denormal */
+        result_u32 = float_as_uint(uint_as_float(result_u32 + (1 << 23) ) - uint_as_float(113 << 23) );
+    }
+
+    result_u32 |= static_cast<uint32_t>(in_value & 0x8000u) << 16;
+
+    return uint_as_float(result_u32);
+}
+
+/** Converts a single FP32 value to FP16, rounding to nearest even. Uses the same approach as the
+ *  vectorized path (see fp32_to_fp16_fast3_rtne() in fp16.cpp), so both yield bit-identical results.
+ **/
+static uint16_t convert_fp32_to_fp16(float in_value)
+{
+    const uint32_t f32infty     = 255u << 23;
+    const uint32_t f16max       = (127u + 16u) << 23;
+    const float    denorm_magic = uint_as_float( ( (127 - 15) + (23 - 10) + 1) << 23);
+    uint32_t       in_u32       = float_as_uint(in_value);
+    uint16_t       result       = 0;
+    const uint32_t sign         = in_u32 & 0x80000000u;
+
+    in_u32 ^= sign;
+
+    if (in_u32 >= f16max)
+    {
+        result = (in_u32 > f32infty) ? 0x7e00u : 0x7c00u;
+    }
+    else
+    if (in_u32 < (113u << 23) )
+    {
+        result = static_cast<uint16_t>(float_as_uint(uint_as_float(in_u32) + denorm_magic) - float_as_uint(denorm_magic) );
+    }
+    else
+    {
+        const uint32_t mantissa_odd = (in_u32 >> 13) & 1;
+
+        in_u32 += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu;
+        in_u32 += mantissa_odd;
+
+        result = static_cast<uint16_t>(in_u32 >> 13);
+    }
+
+    return static_cast<uint16_t>(result | (sign >> 16) );
+}
+
+#if defined(ANVIL_FORMATS_USE_SSSE3)
+    /** Vectorized equivalent of convert_fp16_to_fp32(). Converts 4 FP16 values, stored in the lower
+     *  16 bits of each 32-bit lane of @param in_values, to FP32.
+     **/
+    static __m128 convert_fp16x4_to_fp32x4(__m128i in_values)
+    {
+        const __m128i mask_nosign = _mm_set1_epi32(0x7fff);
+        const __m128i shifted_exp = _mm_set1_epi32(0x7c00 << 13);
+        const __m128i exp_bias    = _mm_set1_epi32( (127 - 15) << 23);
+        const __m128i infnan_bias = _mm_set1_epi32( (128 - 16) << 23);
+        const __m128i denorm_bias = _mm_set1_epi32(1 << 23);
+        const __m128  denorm_magic = _mm_castsi128_ps(_mm_set1_epi32(113 << 23) );
+
+        const __m128i expmant     = _mm_and_si128  (mask_nosign, in_values);
+        const __m128i justsign    = _mm_xor_si128  (in_values,   expmant);
+        const __m128i shifted     = _mm_slli_epi32 (expmant,     13);
+        const __m128i exp         = _mm_and_si128  (shifted,     shifted_exp);
+        const __m128i b_isinfnan  = _mm_cmpeq_epi32(exp,         shifted_exp);
+        const __m128i b_iszero    = _mm_cmpeq_epi32(exp,         _mm_setzero_si128() );
+        const __m128i rebiased    = _mm_add_epi32  (_mm_add_epi32(shifted, exp_bias),
+                                                    _mm_and_si128(b_isinfnan, infnan_bias) );
+        const __m128  denormal    = _mm_sub_ps     (_mm_castsi128_ps(_mm_add_epi32(rebiased, denorm_bias) ),
+                                                    denorm_magic);
+        const __m128i joined      = _mm_or_si128   (_mm_and_si128   (b_iszero, _mm_castps_si128(denormal) ),
+                                                    _mm_andnot_si128(b_iszero, rebiased) );
+
+        return _mm_castsi128_ps(_mm_or_si128(joined,
+                                             _mm_slli_epi32(justsign, 16) ));
+    }
+
+    /** Vectorized equivalent of convert_fp32_to_fp16(). Returns 4 FP16 values, each stored in the lower
+     *  16 bits of a 32-bit lane.
+     **/
+    static __m128i convert_fp32x4_to_fp16x4(__m128 in_values)
+    {
+        const __m128i mask_sign        = _mm_set1_epi32(INT32_MIN);
+        const __m128i c_f16max         = _mm_set1_epi32( (127 + 16) << 23);
+        const __m128i c_nanbit         = _mm_set1_epi32(0x200);
+        const __m128i c_infty_as_fp16  = _mm_set1_epi32(0x7c00);
+        const __m128i c_min_normal     = _mm_set1_epi32( (127 - 14) << 23);
+        const __m128i c_subnorm_magic  = _mm_set1_epi32( ( (127 - 15) + (23 - 10) + 1) << 23);
+        const __m128i c_normal_bias    = _mm_set1_epi32(0xfff - ( (127 - 15) << 23) );
+        const __m128i c_f32infty       = _mm_set1_epi32(255 << 23);
+
+        const __m128  msign            = _mm_castsi128_ps(mask_sign);
+        const __m128  justsign         = _mm_and_ps   (msign, in_values);
+        const __m128  absf             = _mm_xor_ps   (in_values, justsign);
+        const __m128i absf_int         = _mm_castps_si128(absf);
+        const __m128i b_isnan          = _mm_cmpgt_epi32(absf_int, c_f32infty);
+        const __m128i b_isregular      = _mm_cmpgt_epi32(c_f16max, absf_int);
+        const __m128i nan_bits         = _mm_and_si128  (b_isnan,  c_nanbit);
+        const __m128i inf_or_nan       = _mm_or_si128   (nan_bits, c_infty_as_fp16);
+
+        const __m128i b_issub          = _mm_cmpgt_epi32(c_min_normal, absf_int);
+
+        /* "result is subnormal" path */
+        const __m128  subnorm1         = _mm_add_ps     (absf, _mm_castsi128_ps(c_subnorm_magic) );
+        const __m128i subnorm2         = _mm_sub_epi32  (_mm_castps_si128(subnorm1), c_subnorm_magic);
+
+        /* "result is normal" path */
+        const __m128i mantoddbit       = _mm_slli_epi32 (absf_int, 31 - 13);
+        const __m128i mantodd          = _mm_srai_epi32 (mantoddbit, 31);
+        const __m128i round1           = _mm_add_epi32  (absf_int, c_normal_bias);
+        const __m128i round2           = _mm_sub_epi32  (round1,   mantodd);
+        const __m128i normal           = _mm_srli_epi32 (round2,   13);
+
+        /* Combine the two non-specials */
+        const __m128i nonspecial       = _mm_or_si128   (_mm_and_si128   (subnorm2, b_issub),
+                                                         _mm_andnot_si128(b_issub,  normal) );
+
+        /* Merge in specials as well */
+        const __m128i joined           = _mm_or_si128   (_mm_and_si128   (nonspecial,  b_isregular),
+                                                         _mm_andnot_si128(b_isregular, inf_or_nan) );
+
+        const __m128i sign_shift       = _mm_srli_epi32 (_mm_castps_si128(justsign), 16);
+
+        return _mm_or_si128(joined,
+                            sign_shift);
+    }
+#endif
+
+/** Converts @param in_n_values FP16 values to FP32. */
+static void convert_fp16_values_to_fp32(const uint16_t* in_src_ptr,
+                                        float*          out_dst_ptr,
+                                        uint32_t        in_n_values)
+{
+    uint32_t n_value = 0;
+
+    #if defined(ANVIL_FORMATS_USE_SSSE3)
+    {
+        for (;
+             n_value + 4 <= in_n_values;
+             n_value += 4)
+        {
+            const __m128i src_values = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in_src_ptr + n_value) ),
+                                                          _mm_setzero_si128() );
+
+            _mm_storeu_ps(out_dst_ptr + n_value,
+                          convert_fp16x4_to_fp32x4(src_values) );
+        }
+    }
+    #endif
+
+    for (;
+         n_value < in_n_values;
+       ++n_value)
+    {
+        out_dst_ptr[n_value] = convert_fp16_to_fp32(in_src_ptr[n_value]);
+    }
+}
+
+/** Converts @param in_n_values FP32 values to FP16. */
+static void convert_fp32_values_to_fp16(const float* in_src_ptr,
+                                        uint16_t*    out_dst_ptr,
+                                        uint32_t     in_n_values)
+{
+    uint32_t n_value = 0;
+
+    #if defined(ANVIL_FORMATS_USE_SSSE3)
+    {
+        const __m128i pack_mask = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+
+        for (;
+             n_value + 4 <= in_n_values;
+             n_value += 4)
+        {
+            const __m128i dst_values = convert_fp32x4_to_fp16x4(_mm_loadu_ps(in_src_ptr + n_value) );
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out_dst_ptr + n_value),
+                             _mm_shuffle_epi8(dst_values,
+                                              pack_mask) );
+        }
+    }
+    #endif
+
+    for (;
+         n_value < in_n_values;
+       ++n_value)
+    {
+        out_dst_ptr[n_value] = convert_fp32_to_fp16(in_src_ptr[n_value]);
+    }
+}
+
+/** Copies 8-bit components between two formats whose components are all 8 bits wide.
+ *
+ *  @param in_dst_byte_src_indices For each destination byte, index of the source byte to copy the value from, or
+ *                                 UINT8_MAX if the corresponding value from @param in_dst_byte_fill_values should
+ *                                 be used instead.
+ **/
+static void permute_8bit_components(const uint8_t* in_src_ptr,
+                                    uint32_t       in_n_src_bytes_per_pixel,
+                                    uint8_t*       out_dst_ptr,
+                                    uint32_t       in_n_dst_bytes_per_pixel,
+                                    const uint8_t* in_dst_byte_src_indices,
+                                    const uint8_t* in_dst_byte_fill_values,
+                                    uint32_t       in_n_pixels)
+{
+    uint32_t n_pixel = 0;
+
+    #if defined(ANVIL_FORMATS_USE_SSSE3)
+    {
+        if (in_n_src_bytes_per_pixel == 4 &&
+            in_n_dst_bytes_per_pixel == 4)
+        {
+            alignas(16) uint8_t fill_values [16];
+            alignas(16) uint8_t shuffle_mask[16];
+
+            for (uint32_t n_byte = 0;
+                          n_byte < sizeof(shuffle_mask);
+                        ++n_byte)
+            {
+                const uint8_t src_index = in_dst_byte_src_indices[n_byte % 4];
+
+                if (src_index == UINT8_MAX)
+                {
+                    fill_values [n_byte] = in_dst_byte_fill_values[n_byte % 4];
+                    shuffle_mask[n_byte] = 0x80;
+                }
+                else
+                {
+                    fill_values [n_byte] = 0;
+                    shuffle_mask[n_byte] = static_cast<uint8_t>( (n_byte / 4) * 4 + src_index);
+                }
+            }
+
+            {
+                const __m128i fill_values_vec  = _mm_load_si128(reinterpret_cast<const __m128i*>(fill_values) );
+                const __m128i shuffle_mask_vec = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle_mask) );
+
+                for (;
+                     n_pixel + 4 <= in_n_pixels;
+                     n_pixel += 4)
+                {
+                    const __m128i src_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in_src_ptr + n_pixel * 4) );
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out_dst_ptr + n_pixel * 4),
+                                     _mm_or_si128(_mm_shuffle_epi8(src_pixels,
+                                                                   shuffle_mask_vec),
+                                                  fill_values_vec) );
+                }
+            }
+        }
+    }
+    #endif
+
+    for (;
+         n_pixel < in_n_pixels;
+       ++n_pixel)
+    {
+        const uint8_t* src_pixel_ptr = in_src_ptr  + n_pixel * in_n_src_bytes_per_pixel;
+        uint8_t*       dst_pixel_ptr = out_dst_ptr + n_pixel * in_n_dst_bytes_per_pixel;
+
+        for (uint32_t n_byte = 0;
+                      n_byte < in_n_dst_bytes_per_pixel;
+                    ++n_byte)
+        {
+            const uint8_t src_index = in_dst_byte_src_indices[n_byte];
+
+            dst_pixel_ptr[n_byte] = (src_index != UINT8_MAX) ? src_pixel_ptr[src_index]
+                                                             : in_dst_byte_fill_values[n_byte];
+        }
+    }
+}
+
+/** Describes how to compute a single output value from a 32-bit packed UNORM pixel:
+ *
+ *  result = float( (pixel >> shift) & mask) * scale + bias
+ **/
+typedef struct PackedUNormComponentInfo
+{
+    float    bias;
+    uint32_t mask;
+    float    scale;
+    uint32_t shift;
+
+    PackedUNormComponentInfo()
+    {
+        bias  = 0.0f;
+        mask  = 0;
+        scale = 0.0f;
+        shift = 0;
+    }
+} PackedUNormComponentInfo;
+
+/** Unpacks 32-bit packed UNORM pixels (eg. 10:10:10:2 formats) to 4 FP32 values per pixel, or 4 8-bit UNORM values
+ *  per pixel, depending on whether @param out_opt_dst_fp32_ptr or @param out_opt_dst_u8_ptr is not null.
+ *
+ *  8-bit values are clamped to [0, 255] and rounded to nearest. Scale & bias of @param in_components need to take
+ *  the destination value range into account.
+ **/
+static void unpack_unorm_pack32_pixels(const uint32_t*                 in_src_ptr,
+                                       const PackedUNormComponentInfo* in_components,
+                                       float*                          out_opt_dst_fp32_ptr,
+                                       uint8_t*                        out_opt_dst_u8_ptr,
+                                       uint32_t                        in_n_pixels)
+{
+    uint32_t n_pixel = 0;
+
+    #if defined(ANVIL_FORMATS_USE_SSSE3)
+    {
+        const __m128i transpose_mask = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+        for (;
+             n_pixel + 4 <= in_n_pixels;
+             n_pixel += 4)
+        {
+            const __m128i src_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in_src_ptr + n_pixel) );
+            __m128        values[4];
+
+            for (uint32_t n_component = 0;
+                          n_component < 4;
+                        ++n_component)
+            {
+                const PackedUNormComponentInfo& component = in_components[n_component];
+                const __m128i                   bits      = _mm_and_si128(_mm_srl_epi32(src_pixels,
+                                                                                        _mm_cvtsi32_si128(static_cast<int>(component.shift) )),
+                                                                          _mm_set1_epi32(static_cast<int>(component.mask) ));
+
+                values[n_component] = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(bits),
+                                                            _mm_set1_ps   (component.scale) ),
+                                                 _mm_set1_ps(component.bias) );
+            }
+
+            if (out_opt_dst_fp32_ptr != nullptr)
+            {
+                _MM_TRANSPOSE4_PS(values[0],
+                                  values[1],
+                                  values[2],
+                                  values[3]);
+
+                for (uint32_t n_result_pixel = 0;
+                              n_result_pixel < 4;
+                            ++n_result_pixel)
+                {
+                    _mm_storeu_ps(out_opt_dst_fp32_ptr + (n_pixel + n_result_pixel) * 4,
+                                  values[n_result_pixel]);
+                }
+            }
+            else
+            {
+                /* Saturating packs yield R0R1R2R3 G0G1G2G3 B0B1B2B3 A0A1A2A3, which is then transposed to RGBA order. */
+                const __m128i values01 = _mm_packs_epi32 (_mm_cvtps_epi32(values[0]), _mm_cvtps_epi32(values[1]) );
+                const __m128i values23 = _mm_packs_epi32 (_mm_cvtps_epi32(values[2]), _mm_cvtps_epi32(values[3]) );
+                const __m128i packed   = _mm_packus_epi16(values01, values23);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out_opt_dst_u8_ptr + n_pixel * 4),
+                                 _mm_shuffle_epi8(packed,
+                                                  transpose_mask) );
+            }
+        }
+    }
+    #endif
+
+    for (;
+         n_pixel < in_n_pixels;
+       ++n_pixel)
+    {
+        for (uint32_t n_component = 0;
+                      n_component < 4;
+                    ++n_component)
+        {
+            const PackedUNormComponentInfo& component = in_components[n_component];
+            const float                     value     = static_cast<float>( (in_src_ptr[n_pixel] >> component.shift) & component.mask) * component.scale + component.bias;
+
+            if (out_opt_dst_fp32_ptr != nullptr)
+            {
+                out_opt_dst_fp32_ptr[n_pixel * 4 + n_component] = value;
+            }
+            else
+            {
+                out_opt_dst_u8_ptr[n_pixel * 4 + n_component] = static_cast<uint8_t>(std::min(std::max(value + 0.5f, 0.0f),
+                                                                                              255.0f) );
+            }
+        }
+    }
+}
+
+/** Converts @param in_n_pixels Y'CbCr triples to R8G8B8A8 pixels.
+ *
+ *  Each output component is computed as:
+ *
+ *  result = clamp(matrix[c][0] * y + matrix[c][1] * cb + matrix[c][2] * cr + matrix[c][3], 0, 255)
+ *
+ *  The alpha component is always set to 255.
+ **/
+static void convert_ycbcr_to_rgba8(const int32_t* in_y_ptr,
+                                   const int32_t* in_cb_ptr,
+                                   const int32_t* in_cr_ptr,
+                                   const float    in_matrix[3][4],
+                                   uint8_t*       out_dst_ptr,
+                                   uint32_t       in_n_pixels)
+{
+    uint32_t n_pixel = 0;
+
+    #if defined(ANVIL_FORMATS_USE_SSSE3)
+    {
+        const __m128i alpha          = _mm_set1_epi32(255);
+        const __m128i transpose_mask = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+        for (;
+             n_pixel + 4 <= in_n_pixels;
+             n_pixel += 4)
+        {
+            const __m128 y  = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in_y_ptr  + n_pixel) ));
+            const __m128 cb = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in_cb_ptr + n_pixel) ));
+            const __m128 cr = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in_cr_ptr + n_pixel) ));
+            __m128i      rgb[3];
+
+            for (uint32_t n_component = 0;
+                          n_component < 3;
+                        ++n_component)
+            {
+                const float* row_ptr = in_matrix[n_component];
+
+                rgb[n_component] = _mm_cvtps_epi32(_mm_add_ps(_mm_add_ps(_mm_mul_ps(y,  _mm_set1_ps(row_ptr[0]) ),
+                                                                         _mm_mul_ps(cb, _mm_set1_ps(row_ptr[1]) )),
+                                                              _mm_add_ps(_mm_mul_ps(cr, _mm_set1_ps(row_ptr[2]) ),
+                                                                         _mm_set1_ps(row_ptr[3]) )));
+            }
+
+            {
+                const __m128i rg     = _mm_packs_epi32 (rgb[0], rgb[1]);
+                const __m128i ba     = _mm_packs_epi32 (rgb[2], alpha);
+                const __m128i packed = _mm_packus_epi16(rg,     ba);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out_dst_ptr + n_pixel * 4),
+                                 _mm_shuffle_epi8(packed,
+                                                  transpose_mask) );
+            }
+        }
+    }
+    #endif
+
+    for (;
+         n_pixel < in_n_pixels;
+       ++n_pixel)
+    {
+        for (uint32_t n_component = 0;
+                      n_component < 3;
+                    ++n_component)
+        {
+            const float* row_ptr = in_matrix[n_component];
+            const float  value   = row_ptr[0] * static_cast<float>(in_y_ptr [n_pixel]) +
+                                   row_ptr[1] * static_cast<float>(in_cb_ptr[n_pixel]) +
+                                   row_ptr[2] * static_cast<float>(in_cr_ptr[n_pixel]) +
+                                   row_ptr[3];
+
+            out_dst_ptr[n_pixel * 4 + n_component] = static_cast<uint8_t>(std::min(std::max(value + 0.5f, 0.0f),
+                                                                                    255.0f) );
+        }
+
+        out_dst_ptr[n_pixel * 4 + 3] = 255;
+    }
+}
+
+/** Describes where & how color components of a non-compressed, non-YUV color format are stored. */
+typedef struct PixelLayout
+{
+    uint32_t          component_n_bits    [4]; /* R, G, B, A. 0 if the component is not used by the format. */
+    uint32_t          component_start_bits[4]; /* R, G, B, A. UINT32_MAX if the component is not used by the format. */
+    Anvil::FormatType format_type;
+    uint32_t          n_bytes_per_pixel;
+} PixelLayout;
+
+/** Fills @param out_layout_ptr with layout info of @param in_format.
+ *
+ *  @return true if @param in_format can be used as a source or destination format of Anvil::Formats::convert_pixels(),
+ *          false otherwise.
+ **/
+static bool get_pixel_layout(Anvil::Format in_format,
+                             PixelLayout*  out_layout_ptr)
+{
+    const auto layout_iterator = g_nonyuv_format_bit_layout_info.find(in_format);
+    uint32_t   n_pixel_bits    = 0;
+    bool       result          = false;
+
+    /* NOTE: YUV formats are not included in the non-YUV bit layout map. */
+    if (layout_iterator == g_nonyuv_format_bit_layout_info.end() ||
+        Anvil::Formats::is_format_compressed(in_format) )
+    {
+        goto end;
+    }
+
+    {
+        const NonYUVFormatBitLayoutInfo& layout       = layout_iterator->second;
+        const uint32_t                   start_bits[] =
+        {
+            layout.red_component_start_bit_index,
+            layout.green_component_start_bit_index,
+            layout.blue_component_start_bit_index,
+            layout.alpha_component_start_bit_index
+        };
+        const uint32_t                   last_bits[]  =
+        {
+            layout.red_component_last_bit_index,
+            layout.green_component_last_bit_index,
+            layout.blue_component_last_bit_index,
+            layout.alpha_component_last_bit_index
+        };
+
+        if (layout.shared_component_start_bit_index  != UINT32_MAX ||
+            layout.depth_component_start_bit_index   != UINT32_MAX ||
+            layout.stencil_component_start_bit_index != UINT32_MAX)
+        {
+            goto end;
+        }
+
+        out_layout_ptr->format_type = g_formats[static_cast<uint32_t>(in_format)].format_type;
+
+        switch (out_layout_ptr->format_type)
+        {
+            case Anvil::FormatType::SFLOAT:
+            case Anvil::FormatType::SINT:
+            case Anvil::FormatType::SNORM:
+            case Anvil::FormatType::SRGB:
+            case Anvil::FormatType::SSCALED:
+            case Anvil::FormatType::UINT:
+            case Anvil::FormatType::UNORM:
+            case Anvil::FormatType::USCALED:
+            {
+                break;
+            }
+
+            default:
+            {
+                goto end;
+            }
+        }
+
+        for (uint32_t n_component = 0;
+                      n_component < 4;
+                    ++n_component)
+        {
+            if (start_bits[n_component] == UINT32_MAX)
+            {
+                out_layout_ptr->component_n_bits    [n_component] = 0;
+                out_layout_ptr->component_start_bits[n_component] = UINT32_MAX;
+
+                continue;
+            }
+
+            out_layout_ptr->component_n_bits    [n_component] = last_bits[n_component] - start_bits[n_component] + 1;
+            out_layout_ptr->component_start_bits[n_component] = start_bits[n_component];
+
+            /* 64-bit components are only supported for floating-point formats, since integer values of that size
+             * cannot be represented exactly by the intermediate representation used for conversions. */
+            if (out_layout_ptr->component_n_bits[n_component] > 32                 &&
+                out_layout_ptr->format_type                   != Anvil::FormatType::SFLOAT)
+            {
+                goto end;
+            }
+
+            n_pixel_bits = std::max(n_pixel_bits,
+                                    last_bits[n_component] + 1);
+        }
+    }
+
+    if (n_pixel_bits       == 0 ||
+        (n_pixel_bits % 8) != 0)
+    {
+        goto end;
+    }
+
+    out_layout_ptr->n_bytes_per_pixel = n_pixel_bits / 8;
+    result                            = true;
+end:
+    return result;
+}
+
+/** Reads @param in_n_bits bits, starting at bit @param in_start_bit, from a little-endian bit stream. */
+static uint64_t read_bits(const uint8_t* in_data_ptr,
+                          uint32_t       in_start_bit,
+                          uint32_t       in_n_bits)
+{
+    uint64_t result = 0;
+
+    for (uint32_t n_bit = 0;
+                  n_bit < in_n_bits;
+                 )
+    {
+        const uint32_t current_bit     = in_start_bit + n_bit;
+        const uint32_t n_bit_in_byte   = current_bit % 8;
+        const uint32_t n_bits_to_read  = std::min(8 - n_bit_in_byte,
+                                                  in_n_bits - n_bit);
+        const uint64_t bits            = (in_data_ptr[current_bit / 8] >> n_bit_in_byte) & ( (1u << n_bits_to_read) - 1);
+
+        result |= bits << n_bit;
+        n_bit  += n_bits_to_read;
+    }
+
+    return result;
+}
+
+/** Writes @param in_n_bits lowest bits of @param in_value, starting at bit @param in_start_bit, to a little-endian
+ *  bit stream. Bits which are already set in the stream are not cleared.
+ **/
+static void write_bits(uint8_t* out_data_ptr,
+                       uint32_t in_start_bit,
+                       uint32_t in_n_bits,
+                       uint64_t in_value)
+{
+    for (uint32_t n_bit = 0;
+                  n_bit < in_n_bits;
+                 )
+    {
+        const uint32_t current_bit     = in_start_bit + n_bit;
+        const uint32_t n_bit_in_byte   = current_bit % 8;
+        const uint32_t n_bits_to_write = std::min(8 - n_bit_in_byte,
+                                                  in_n_bits - n_bit);
+        const uint32_t bits            = static_cast<uint32_t>(in_value >> n_bit) & ( (1u << n_bits_to_write) - 1);
+
+        out_data_ptr[current_bit / 8] |= static_cast<uint8_t>(bits << n_bit_in_byte);
+        n_bit                         += n_bits_to_write;
+    }
+}
+
+/** Decodes a raw component value to its numerical representation. */
+static double decode_component(uint64_t          in_bits,
+                               uint32_t          in_n_bits,
+                               Anvil::FormatType in_format_type,
+                               bool              in_is_alpha)
+{
+    double result = 0.0;
+
+    switch (in_format_type)
+    {
+        case Anvil::FormatType::SFLOAT:
+        {
+            if (in_n_bits == 16)
+            {
+                result = convert_fp16_to_fp32(static_cast<uint16_t>(in_bits) );
+            }
+            else
+            if (in_n_bits == 32)
+            {
+                result = uint_as_float(static_cast<uint32_t>(in_bits) );
+            }
+            else
+            {
+                anvil_assert(in_n_bits == 64);
+
+                memcpy(&result,
+                       &in_bits,
+                       sizeof(result) );
+            }
+
+            break;
+        }
+
+        case Anvil::FormatType::SINT:
+        case Anvil::FormatType::SNORM:
+        case Anvil::FormatType::SSCALED:
+        {
+            const uint64_t sign_bit = 1ull << (in_n_bits - 1);
+
+            result = (in_bits & sign_bit) ? -static_cast<double>( (sign_bit << 1) - in_bits)
+                                          :  static_cast<double>(in_bits);
+
+            if (in_format_type == Anvil::FormatType::SNORM)
+            {
+                result = std::max(result / static_cast<double>(sign_bit - 1),
+                                  -1.0);
+            }
+
+            break;
+        }
+
+        case Anvil::FormatType::UINT:
+        case Anvil::FormatType::USCALED:
+        {
+            result = static_cast<double>(in_bits);
+
+            break;
+        }
+
+        case Anvil::FormatType::SRGB:
+        case Anvil::FormatType::UNORM:
+        {
+            result = static_cast<double>(in_bits) / static_cast<double>( (1ull << in_n_bits) - 1);
+
+            if (in_format_type == Anvil::FormatType::SRGB &&
+               !in_is_alpha)
+            {
+                result = (result <= 0.04045) ? result / 12.92
+                                             : pow( (result + 0.055) / 1.055, 2.4);
+            }
+
+            break;
+        }
+
+        default:
+        {
+            anvil_assert_fail();
+        }
+    }
+
+    return result;
+}
+
+/** Encodes numerical representation of a component value to its raw form. Values which cannot be represented
+ *  are clamped to the nearest representable value.
+ **/
+static uint64_t encode_component(double            in_value,
+                                 uint32_t          in_n_bits,
+                                 Anvil::FormatType in_format_type,
+                                 bool              in_is_alpha)
+{
+    uint64_t result = 0;
+
+    switch (in_format_type)
+    {
+        case Anvil::FormatType::SFLOAT:
+        {
+            if (in_n_bits == 16)
+            {
+                result = convert_fp32_to_fp16(static_cast<float>(in_value) );
+            }
+            else
+            if (in_n_bits == 32)
+            {
+                result = float_as_uint(static_cast<float>(in_value) );
+            }
+            else
+            {
+                anvil_assert(in_n_bits == 64);
+
+                memcpy(&result,
+                       &in_value,
+                       sizeof(result) );
+            }
+
+            break;
+        }
+
+        case Anvil::FormatType::SINT:
+        case Anvil::FormatType::SNORM:
+        case Anvil::FormatType::SSCALED:
+        {
+            const double max_value = static_cast<double>( (1ull << (in_n_bits - 1) ) - 1);
+            double       value     = in_value;
+
+            if (in_format_type == Anvil::FormatType::SNORM)
+            {
+                value = std::min(std::max(value, -1.0), 1.0) * max_value;
+            }
+            else
+            {
+                value = std::min(std::max(value, -max_value - 1.0), max_value);
+            }
+
+            result = static_cast<uint64_t>(static_cast<int64_t>(floor(value + 0.5) ) ) & ( (1ull << in_n_bits) - 1);
+
+            break;
+        }
+
+        case Anvil::FormatType::UINT:
+        case Anvil::FormatType::USCALED:
+        {
+            const double max_value = static_cast<double>( (1ull << in_n_bits) - 1);
+
+            result = static_cast<uint64_t>(floor(std::min(std::max(in_value, 0.0), max_value) + 0.5) );
+
+            break;
+        }
+
+        case Anvil::FormatType::SRGB:
+        case Anvil::FormatType::UNORM:
+        {
+            const double max_value = static_cast<double>( (1ull << in_n_bits) - 1);
+            double       value     = std::min(std::max(in_value, 0.0), 1.0);
+
+            if (in_format_type == Anvil::FormatType::SRGB &&
+               !in_is_alpha)
+            {
+                value = (value <= 0.0031308) ? value * 12.92
+                                             : 1.055 * pow(value, 1.0 / 2.4) - 0.055;
+            }
+
+            result = static_cast<uint64_t>(floor(value * max_value + 0.5) );
+
+            break;
+        }
+
+        default:
+        {
+            anvil_assert_fail();
+        }
+    }
+
+    return result;
+}
+
+/** Converts pixels one component at a time. Supports all formats for which get_pixel_layout() succeeds. */
+static void convert_pixels_generic(const PixelLayout& in_src_layout,
+                                   const uint8_t*     in_src_ptr,
+                                   const PixelLayout& in_dst_layout,
+                                   uint8_t*           out_dst_ptr,
+                                   uint32_t           in_n_pixels)
+{
+    memset(out_dst_ptr,
+           0,
+           static_cast<size_t>(in_n_pixels) * in_dst_layout.n_bytes_per_pixel);
+
+    for (uint32_t n_pixel = 0;
+                  n_pixel < in_n_pixels;
+                ++n_pixel)
+    {
+        const uint8_t* src_pixel_ptr = in_src_ptr  + static_cast<size_t>(n_pixel) * in_src_layout.n_bytes_per_pixel;
+        uint8_t*       dst_pixel_ptr = out_dst_ptr + static_cast<size_t>(n_pixel) * in_dst_layout.n_bytes_per_pixel;
+
+        for (uint32_t n_component = 0;
+                      n_component < 4;
+                    ++n_component)
+        {
+            const bool is_alpha = (n_component == 3);
+            double     value    = (is_alpha) ? 1.0 : 0.0;
+
+            if (in_dst_layout.component_n_bits[n_component] == 0)
+            {
+                continue;
+            }
+
+            if (in_src_layout.component_n_bits[n_component] != 0)
+            {
+                value = decode_component(read_bits(src_pixel_ptr,
+                                                   in_src_layout.component_start_bits[n_component],
+                                                   in_src_layout.component_n_bits    [n_component]),
+                                         in_src_layout.component_n_bits[n_component],
+                                         in_src_layout.format_type,
+                                         is_alpha);
+            }
+
+            write_bits(dst_pixel_ptr,
+                       in_dst_layout.component_start_bits[n_component],
+                       in_dst_layout.component_n_bits    [n_component],
+                       encode_component(value,
+                                        in_dst_layout.component_n_bits[n_component],
+                                        in_dst_layout.format_type,
+                                        is_alpha) );
+        }
+    }
+}
+
+/** Handles conversions between formats whose components are all 8-bit wide, byte-aligned and use the same
+ *  format type (eg. B8G8R8A8_UNORM <-> R8G8B8A8_UNORM).
+ *
+ *  @return true if the conversion has been handled, false if the formats are not eligible for this path.
+ **/
+static bool convert_pixels_8bit_components(const PixelLayout& in_src_layout,
+                                           const uint8_t*     in_src_ptr,
+                                           const PixelLayout& in_dst_layout,
+                                           uint8_t*           out_dst_ptr,
+                                           uint32_t           in_n_pixels)
+{
+    uint8_t dst_byte_fill_values[4] = {0, 0, 0, 0};
+    uint8_t dst_byte_src_indices[4] = {UINT8_MAX, UINT8_MAX, UINT8_MAX, UINT8_MAX};
+    uint8_t one_value               = 0;
+
+    if (in_src_layout.format_type != in_dst_layout.format_type ||
+        in_dst_layout.n_bytes_per_pixel > 4)
+    {
+        return false;
+    }
+
+    for (uint32_t n_component = 0;
+                  n_component < 4;
+                ++n_component)
+    {
+        if ( (in_src_layout.component_n_bits[n_component] != 0 && in_src_layout.component_n_bits[n_component] != 8)       ||
+             (in_dst_layout.component_n_bits[n_component] != 0 && in_dst_layout.component_n_bits[n_component] != 8)       ||
+             (in_src_layout.component_n_bits[n_component] != 0 && (in_src_layout.component_start_bits[n_component] % 8) != 0) ||
+             (in_dst_layout.component_n_bits[n_component] != 0 && (in_dst_layout.component_start_bits[n_component] % 8) != 0) )
+        {
+            return false;
+        }
+    }
+
+    switch (in_dst_layout.format_type)
+    {
+        case Anvil::FormatType::SRGB:
+        case Anvil::FormatType::UNORM:   one_value = 0xFF; break;
+        case Anvil::FormatType::SNORM:   one_value = 0x7F; break;
+        case Anvil::FormatType::SINT:
+        case Anvil::FormatType::SSCALED:
+        case Anvil::FormatType::UINT:
+        case Anvil::FormatType::USCALED: one_value = 1;    break;
+
+        default:
+        {
+            return false;
+        }
+    }
+
+    for (uint32_t n_component = 0;
+                  n_component < 4;
+                ++n_component)
+    {
+        if (in_dst_layout.component_n_bits[n_component] == 0)
+        {
+            continue;
+        }
+
+        const uint32_t n_dst_byte = in_dst_layout.component_start_bits[n_component] / 8;
+
+        if (in_src_layout.component_n_bits[n_component] != 0)
+        {
+            dst_byte_src_indices[n_dst_byte] = static_cast<uint8_t>(in_src_layout.component_start_bits[n_component] / 8);
+        }
+        else
+        if (n_component == 3)
+        {
+            dst_byte_fill_values[n_dst_byte] = one_value;
+        }
+    }
+
+    permute_8bit_components(in_src_ptr,
+                            in_src_layout.n_bytes_per_pixel,
+                            out_dst_ptr,
+                            in_dst_layout.n_bytes_per_pixel,
+                            dst_byte_src_indices,
+                            dst_byte_fill_values,
+                            in_n_pixels);
+
+    return true;
+}
+
+/** Handles conversions between FP16 and FP32 formats which use the same component ordering
+ *  (eg. R16G16B16A16_SFLOAT <-> R32G32B32A32_SFLOAT).
+ *
+ *  @return true if the conversion has been handled, false if the formats are not eligible for this path.
+ **/
+static bool convert_pixels_fp16_fp32(const PixelLayout& in_src_layout,
+                                     const uint8_t*     in_src_ptr,
+                                     const PixelLayout& in_dst_layout,
+                                     uint8_t*           out_dst_ptr,
+                                     uint32_t           in_n_pixels)
+{
+    uint32_t n_components = 0;
+
+    if (in_src_layout.format_type != Anvil::FormatType::SFLOAT ||
+        in_dst_layout.format_type != Anvil::FormatType::SFLOAT)
+    {
+        return false;
+    }
+
+    for (uint32_t n_component = 0;
+                  n_component < 4;
+                ++n_component)
+    {
+        const uint32_t n_src_bits = in_src_layout.component_n_bits[n_component];
+        const uint32_t n_dst_bits = in_dst_layout.component_n_bits[n_component];
+
+        if (n_src_bits == 0 &&
+            n_dst_bits == 0)
+        {
+            continue;
+        }
+
+        if (!(n_src_bits == 16 && n_dst_bits == 32 && in_dst_layout.component_start_bits[n_component] == in_src_layout.component_start_bits[n_component] * 2) &&
+            !(n_src_bits == 32 && n_dst_bits == 16 && in_src_layout.component_start_bits[n_component] == in_dst_layout.component_start_bits[n_component] * 2) )
+        {
+            return false;
+        }
+
+        ++n_components;
+    }
+
+    if (in_src_layout.n_bytes_per_pixel < in_dst_layout.n_bytes_per_pixel)
+    {
+        convert_fp16_values_to_fp32(reinterpret_cast<const uint16_t*>(in_src_ptr),
+                                    reinterpret_cast<float*>         (out_dst_ptr),
+                                    in_n_pixels * n_components);
+    }
+    else
+    {
+        convert_fp32_values_to_fp16(reinterpret_cast<const float*>(in_src_ptr),
+                                    reinterpret_cast<uint16_t*>   (out_dst_ptr),
+                                    in_n_pixels * n_components);
+    }
+
+    return true;
+}
+
+/** Handles conversions from 32-bit UNORM formats (eg. A2B10G10R10_UNORM_PACK32) to R32G32B32A32_SFLOAT or to
+ *  4-component 8-bit UNORM formats.
+ *
+ *  @return true if the conversion has been handled, false if the formats are not eligible for this path.
+ **/
+static bool convert_pixels_unorm_pack32(const PixelLayout& in_src_layout,
+                                        const uint8_t*     in_src_ptr,
+                                        const PixelLayout& in_dst_layout,
+                                        uint8_t*           out_dst_ptr,
+                                        uint32_t           in_n_pixels)
+{
+    PackedUNormComponentInfo dst_components[4];
+    bool                     is_dst_fp32;
+    float                    range;
+
+    if (in_src_layout.format_type       != Anvil::FormatType::UNORM ||
+        in_src_layout.n_bytes_per_pixel != 4)
+    {
+        return false;
+    }
+
+    if (in_dst_layout.format_type       == Anvil::FormatType::SFLOAT &&
+        in_dst_layout.n_bytes_per_pixel == 16)
+    {
+        is_dst_fp32 = true;
+        range       = 1.0f;
+    }
+    else
+    if (in_dst_layout.format_type       == Anvil::FormatType::UNORM &&
+        in_dst_layout.n_bytes_per_pixel == 4)
+    {
+        is_dst_fp32 = false;
+        range       = 255.0f;
+    }
+    else
+    {
+        return false;
+    }
+
+    for (uint32_t n_component = 0;
+                  n_component < 4;
+                ++n_component)
+    {
+        const uint32_t dst_component_n_bits = (is_dst_fp32) ? 32 : 8;
+
+        if (in_dst_layout.component_n_bits[n_component] != dst_component_n_bits ||
+            in_src_layout.component_n_bits[n_component] >  16)
+        {
+            return false;
+        }
+
+        PackedUNormComponentInfo& dst_component = dst_components[in_dst_layout.component_start_bits[n_component] / dst_component_n_bits];
+
+        if (in_src_layout.component_n_bits[n_component] != 0)
+        {
+            dst_component.mask  = (1u << in_src_layout.component_n_bits[n_component]) - 1;
+            dst_component.scale = range / static_cast<float>(dst_component.mask);
+            dst_component.shift = in_src_layout.component_start_bits[n_component];
+        }
+        else
+        if (n_component == 3)
+        {
+            dst_component.bias = range;
+        }
+    }
+
+    unpack_unorm_pack32_pixels(reinterpret_cast<const uint32_t*>(in_src_ptr),
+                               dst_components,
+                               (is_dst_fp32) ? reinterpret_cast<float*>(out_dst_ptr) : nullptr,
+                               (is_dst_fp32) ? nullptr                                : out_dst_ptr,
+                               in_n_pixels);
+
+    return true;
+}
+
+/** Computes the matrix which converts raw 8-bit Y'CbCr values to 8-bit RGB values, as expected by
+ *  convert_ycbcr_to_rgba8().
+ **/
+static void get_ycbcr_to_rgb_matrix(Anvil::SamplerYCbCrModelConversion in_model_conversion,
+                                    bool                               in_narrow_range,
+                                    float                              out_matrix[3][4])
+{
+    /* Coefficients applied to range-expanded Y', Cb and Cr values, in R, G, B order */
+    double       coeffs[3][3] = {{0.0}};
+    const double c_offset     = 128.0;
+    const double c_scale      = (in_narrow_range) ? 255.0 / 224.0 : 1.0;
+    const double y_offset     = (in_narrow_range) ? 16.0          : 0.0;
+    const double y_scale      = (in_narrow_range) ? 255.0 / 219.0 : 1.0;
+    double       kb           = 0.0;
+    double       kr           = 0.0;
+
+    switch (in_model_conversion)
+    {
+        case Anvil::SamplerYCbCrModelConversion::RGB_IDENTITY_KHR:
+        {
+            const float rgb_identity_matrix[3][4] =
+            {
+                {0.0f, 0.0f, 1.0f, 0.0f},
+                {1.0f, 0.0f, 0.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f, 0.0f}
+            };
+
+            memcpy(out_matrix,
+                   rgb_identity_matrix,
+                   sizeof(rgb_identity_matrix) );
+
+            return;
+        }
+
+        case Anvil::SamplerYCbCrModelConversion::YCBCR_IDENTITY_KHR:
+        {
+            coeffs[0][2] = 1.0;
+            coeffs[1][0] = 1.0;
+            coeffs[2][1] = 1.0;
+
+            break;
+        }
+
+        case Anvil::SamplerYCbCrModelConversion::YCBCR_601_KHR:  kr = 0.299;  kb = 0.114;  break;
+        case Anvil::SamplerYCbCrModelConversion::YCBCR_709_KHR:  kr = 0.2126; kb = 0.0722; break;
+        case Anvil::SamplerYCbCrModelConversion::YCBCR_2020_KHR: kr = 0.2627; kb = 0.0593; break;
+
+        default:
+        {
+            anvil_assert_fail();
+        }
+    }
+
+    if (kr != 0.0)
+    {
+        const double kg = 1.0 - kr - kb;
+
+        coeffs[0][0] = 1.0;
+        coeffs[0][2] = 2.0 * (1.0 - kr);
+        coeffs[1][0] = 1.0;
+        coeffs[1][1] = -2.0 * kb * (1.0 - kb) / kg;
+        coeffs[1][2] = -2.0 * kr * (1.0 - kr) / kg;
+        coeffs[2][0] = 1.0;
+        coeffs[2][1] = 2.0 * (1.0 - kb);
+    }
+
+    for (uint32_t n_row = 0;
+                  n_row < 3;
+                ++n_row)
+    {
+        out_matrix[n_row][0] = static_cast<float>(coeffs[n_row][0] * y_scale);
+        out_matrix[n_row][1] = static_cast<float>(coeffs[n_row][1] * c_scale);
+        out_matrix[n_row][2] = static_cast<float>(coeffs[n_row][2] * c_scale);
+        out_matrix[n_row][3] = static_cast<float>(-coeffs[n_row][0] * y_scale * y_offset
+                                                  -(coeffs[n_row][1] + coeffs[n_row][2]) * c_scale * c_offset);
+    }
+}
+
+/* <== Pixel conversion helpers */
+
+/** Please see header for specification */
+bool Anvil::Formats::convert_pixels(Anvil::Format in_src_format,
+                                    const void*   in_src_data_ptr,
+                                    Anvil::Format in_dst_format,
+                                    void*         out_dst_data_ptr,
+                                    uint32_t      in_n_pixels)
+{
+    PixelLayout    dst_layout;
+    bool           result      = false;
+    PixelLayout    src_layout;
+    const uint8_t* src_u8_ptr  = reinterpret_cast<const uint8_t*>(in_src_data_ptr);
+    uint8_t*       dst_u8_ptr  = reinterpret_cast<uint8_t*>      (out_dst_data_ptr);
+
+    if (!get_pixel_layout(in_src_format,
+                         &src_layout) ||
+        !get_pixel_layout(in_dst_format,
+                         &dst_layout) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (in_src_format == in_dst_format)
+    {
+        memcpy(out_dst_data_ptr,
+               in_src_data_ptr,
+               static_cast<size_t>(in_n_pixels) * src_layout.n_bytes_per_pixel);
+    }
+    else
+    if (!convert_pixels_8bit_components(src_layout, src_u8_ptr, dst_layout, dst_u8_ptr, in_n_pixels) &&
+        !convert_pixels_fp16_fp32      (src_layout, src_u8_ptr, dst_layout, dst_u8_ptr, in_n_pixels) &&
+        !convert_pixels_unorm_pack32   (src_layout, src_u8_ptr, dst_layout, dst_u8_ptr, in_n_pixels) )
+    {
+        convert_pixels_generic(src_layout,
+                               src_u8_ptr,
+                               dst_layout,
+                               dst_u8_ptr,
+                               in_n_pixels);
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/** Please see header for specification */
+bool Anvil::Formats::convert_yuv_to_r8g8b8a8_unorm(Anvil::Format                      in_src_format,
+                                                   uint32_t                           in_width,
+                                                   uint32_t                           in_height,
+                                                   const void* const*                 in_src_plane_data_ptrs,
+                                                   const VkDeviceSize*                in_src_plane_row_pitches,
+                                                   Anvil::SamplerYCbCrModelConversion in_model_conversion,
+                                                   bool                               in_narrow_range,
+                                                   void*                              out_dst_data_ptr,
+                                                   VkDeviceSize                       in_dst_row_pitch)
+{
+    /* Describes where data of a single channel can be found. Data of the pixel at (x, y) is stored at:
+     *
+     * plane[n_plane] + (y / subsampling_y) * row_pitch + (x / n_pixels_per_block) * n_bytes_per_block + byte_offsets[x % n_pixels_per_block]
+     */
+    typedef struct
+    {
+        uint32_t byte_offsets[2];
+        uint32_t n_bytes_per_block;
+        uint32_t n_pixels_per_block;
+        uint32_t n_plane;
+        uint32_t subsampling_y;
+    } ChannelLocation;
+
+    ChannelLocation      cb_location;
+    std::vector<int32_t> cb_values;
+    ChannelLocation      cr_location;
+    std::vector<int32_t> cr_values;
+    float                matrix[3][4];
+    uint32_t             p0g0_start_bit = UINT32_MAX;
+    uint32_t             p0g1_start_bit = UINT32_MAX;
+    uint32_t             p0b0_start_bit = UINT32_MAX;
+    uint32_t             p0r0_start_bit = UINT32_MAX;
+    uint32_t             p1b0_start_bit = UINT32_MAX;
+    uint32_t             p1r0_start_bit = UINT32_MAX;
+    uint32_t             p2b0_start_bit = UINT32_MAX;
+    uint32_t             p2r0_start_bit = UINT32_MAX;
+    bool                 result         = false;
+    ChannelLocation      y_location;
+    std::vector<int32_t> y_values;
+
+    switch (in_src_format)
+    {
+        case Anvil::Format::B8G8R8G8_422_UNORM:
+        case Anvil::Format::G8B8G8R8_422_UNORM:
+        case Anvil::Format::G8_B8R8_2PLANE_420_UNORM:
+        case Anvil::Format::G8_B8R8_2PLANE_422_UNORM:
+        case Anvil::Format::G8_B8_R8_3PLANE_420_UNORM:
+        case Anvil::Format::G8_B8_R8_3PLANE_422_UNORM:
+        case Anvil::Format::G8_B8_R8_3PLANE_444_UNORM:
+        {
+            break;
+        }
+
+        default:
+        {
+            /* Only 8-bit YUV formats are supported at the moment */
+            anvil_assert_fail();
+
+            goto end;
+        }
+    }
+
+    get_format_bit_layout_yuv(in_src_format,
+                             &p0r0_start_bit,
+                              nullptr, /* out_opt_plane0_r0_end_bit_index_ptr */
+                             &p0g0_start_bit,
+                              nullptr, /* out_opt_plane0_g0_end_bit_index_ptr */
+                             &p0b0_start_bit,
+                              nullptr, /* out_opt_plane0_b0_end_bit_index_ptr */
+                              nullptr, /* out_opt_plane0_a0_start_bit_index_ptr */
+                              nullptr, /* out_opt_plane0_a0_end_bit_index_ptr   */
+                             &p0g1_start_bit,
+                              nullptr, /* out_opt_plane0_g1_end_bit_index_ptr */
+                             &p1r0_start_bit,
+                              nullptr, /* out_opt_plane1_r0_end_bit_index_ptr   */
+                              nullptr, /* out_opt_plane1_g0_start_bit_index_ptr */
+                              nullptr, /* out_opt_plane1_g0_end_bit_index_ptr   */
+                             &p1b0_start_bit,
+                              nullptr, /* out_opt_plane1_b0_end_bit_index_ptr */
+                             &p2r0_start_bit,
+                              nullptr, /* out_opt_plane2_r0_end_bit_index_ptr   */
+                              nullptr, /* out_opt_plane2_g0_start_bit_index_ptr */
+                              nullptr, /* out_opt_plane2_g0_end_bit_index_ptr   */
+                             &p2b0_start_bit,
+                              nullptr); /* out_opt_plane2_b0_end_bit_index_ptr */
+
+    if (!is_format_multiplanar(in_src_format) )
+    {
+        /* Single-plane 4:2:2 formats store two pixels in each 32-bit block, sharing a single Cb & Cr pair. */
+        anvil_assert((in_width % 2) == 0);
+
+        y_location.byte_offsets[0]    = p0g0_start_bit / 8;
+        y_location.byte_offsets[1]    = p0g1_start_bit / 8;
+        y_location.n_bytes_per_block  = 4;
+        y_location.n_pixels_per_block = 2;
+        y_location.n_plane            = 0;
+        y_location.subsampling_y      = 1;
+
+        cb_location                 = y_location;
+        cb_location.byte_offsets[0] = p0b0_start_bit / 8;
+        cb_location.byte_offsets[1] = p0b0_start_bit / 8;
+
+        cr_location                 = y_location;
+        cr_location.byte_offsets[0] = p0r0_start_bit / 8;
+        cr_location.byte_offsets[1] = p0r0_start_bit / 8;
+    }
+    else
+    {
+        VkExtent3D       chroma_plane_extent;
+        uint32_t         chroma_plane_n_bits[4];
+        uint32_t         chroma_n_bytes_per_block = 0;
+        const VkExtent3D probe_extent             = {2, 2, 1};
+
+        get_yuv_format_plane_extent(in_src_format,
+                                    Anvil::ImageAspectFlagBits::PLANE_1_BIT,
+                                    probe_extent,
+                                   &chroma_plane_extent);
+        get_format_n_component_bits_yuv(in_src_format,
+                                        Anvil::ImageAspectFlagBits::PLANE_1_BIT,
+                                        chroma_plane_n_bits + 0,
+                                        chroma_plane_n_bits + 1,
+                                        chroma_plane_n_bits + 2,
+                                        chroma_plane_n_bits + 3);
+
+        chroma_n_bytes_per_block = (chroma_plane_n_bits[0] + chroma_plane_n_bits[1] + chroma_plane_n_bits[2] + chroma_plane_n_bits[3]) / 8;
+
+        y_location.byte_offsets[0]    = p0g0_start_bit / 8;
+        y_location.byte_offsets[1]    = p0g0_start_bit / 8;
+        y_location.n_bytes_per_block  = 1;
+        y_location.n_pixels_per_block = 1;
+        y_location.n_plane            = 0;
+        y_location.subsampling_y      = 1;
+
+        /* NOTE: Chroma subsampling is expressed by treating N horizontally adjacent pixels as a single block. */
+        cb_location.n_bytes_per_block  = chroma_n_bytes_per_block;
+        cb_location.n_pixels_per_block = probe_extent.width  / chroma_plane_extent.width;
+        cb_location.subsampling_y      = probe_extent.height / chroma_plane_extent.height;
+        cr_location                    = cb_location;
+
+        cb_location.n_plane         = (p1b0_start_bit != UINT32_MAX) ? 1 : 2;
+        cb_location.byte_offsets[0] = ( (p1b0_start_bit != UINT32_MAX) ? p1b0_start_bit : p2b0_start_bit) / 8;
+        cb_location.byte_offsets[1] = cb_location.byte_offsets[0];
+
+        cr_location.n_plane         = (p1r0_start_bit != UINT32_MAX) ? 1 : 2;
+        cr_location.byte_offsets[0] = ( (p1r0_start_bit != UINT32_MAX) ? p1r0_start_bit : p2r0_start_bit) / 8;
+        cr_location.byte_offsets[1] = cr_location.byte_offsets[0];
+    }
+
+    get_ycbcr_to_rgb_matrix(in_model_conversion,
+                            in_narrow_range,
+                            matrix);
+
+    cb_values.resize(in_width);
+    cr_values.resize(in_width);
+    y_values.resize (in_width);
+
+    for (uint32_t n_row = 0;
+                  n_row < in_height;
+                ++n_row)
+    {
+        const ChannelLocation* locations[]  = {&y_location,     &cb_location,     &cr_location};
+        int32_t*               value_ptrs[] = {y_values.data(), cb_values.data(), cr_values.data()};
+
+        for (uint32_t n_channel = 0;
+                      n_channel < sizeof(locations) / sizeof(locations[0]);
+                    ++n_channel)
+        {
+            const ChannelLocation& location    = *locations[n_channel];
+            const uint8_t*         src_row_ptr = reinterpret_cast<const uint8_t*>(in_src_plane_data_ptrs[location.n_plane]) +
+                                                 static_cast<size_t>( (n_row / location.subsampling_y) * in_src_plane_row_pitches[location.n_plane]);
+            int32_t*               values_ptr  = value_ptrs[n_channel];
+
+            for (uint32_t n_column = 0;
+                          n_column < in_width;
+                        ++n_column)
+            {
+                values_ptr[n_column] = src_row_ptr[(n_column / location.n_pixels_per_block) * location.n_bytes_per_block +
+                                                   location.byte_offsets[n_column % location.n_pixels_per_block] ];
+            }
+        }
+
+        convert_ycbcr_to_rgba8(y_values.data (),
+                               cb_values.data(),
+                               cr_values.data(),
+                               matrix,
+                               reinterpret_cast<uint8_t*>(out_dst_data_ptr) + static_cast<size_t>(n_row * in_dst_row_pitch),
+                               in_width);
+    }
+
+    result = true;
+end:
+    return result;
+}
+
 /** Please see header for specification */
 bool Anvil::Formats::get_compatible_formats(Anvil::Format         in_format,
                                             uint32_t*             out_n_compatible_formats_ptr,
@@ -1699,7 +3139,7 @@ void Anvil::Formats::get_format_bit_layout_yuv(Anvil::Format in_format,
 
     if (out_opt_plane0_g1_start_bit_index_ptr != nullptr)
     {
-        *out_opt_plane0_g1_start_bit_index_ptr = format_info.plane0_g0_start_bit_index;
+        *out_opt_plane0_g1_start_bit_index_ptr = format_info.plane0_g1_start_bit_index;
     }
 
     if (out_opt_plane0_g1_end_bit_index_ptr != nullptr)
@@ -0,0 +1,523 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include "misc/debug.h"
+#include "misc/fence_create_info.h"
+#include "misc/frame_scheduler.h"
+#include "misc/semaphore_create_info.h"
+#include "misc/uniform_ring_allocator.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
+#include "wrappers/device.h"
+#include "wrappers/fence.h"
+#include "wrappers/physical_device.h"
+#include "wrappers/query_pool.h"
+#include "wrappers/queue.h"
+#include "wrappers/semaphore.h"
+#include "wrappers/swapchain.h"
+
+
+/* Please see header for specification */
+Anvil::FrameScheduler::FrameScheduler(Anvil::BaseDevice* in_device_ptr,
+                                      Anvil::Queue*      in_queue_ptr,
+                                      Anvil::Swapchain*  in_opt_swapchain_ptr,
+                                      uint32_t           in_n_frames_in_flight)
+    :m_device_ptr             (in_device_ptr),
+     m_frame_contexts         (in_n_frames_in_flight),
+     m_is_frame_active        (false),
+     m_n_current_frame_context(in_n_frames_in_flight - 1),
+     m_n_frames               (0),
+     m_n_swapchain_image      (UINT32_MAX),
+     m_queue_ptr              (in_queue_ptr),
+     m_swapchain_ptr          (in_opt_swapchain_ptr),
+     m_timestamp_mask         (0),
+     m_timestamp_period       (0.0)
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::FrameScheduler::~FrameScheduler()
+{
+    anvil_assert(!m_is_frame_active);
+
+    /* Frame contexts must not be released while the GPU may still be using them */
+    for (const auto& current_frame_context : m_frame_contexts)
+    {
+        if (current_frame_context.has_been_submitted)
+        {
+            wait_for_frame_context(&current_frame_context,
+                                   UINT64_MAX);
+        }
+    }
+}
+
+/* Please see header for specification */
+bool Anvil::FrameScheduler::begin_frame(uint64_t                            in_timeout,
+                                        Anvil::SwapchainOperationErrorCode* out_opt_acquire_result_ptr)
+{
+    Anvil::SwapchainOperationErrorCode acquire_result   (Anvil::SwapchainOperationErrorCode::SUCCESS);
+    const uint32_t                     n_frame_context  ((m_n_current_frame_context + 1) % static_cast<uint32_t>(m_frame_contexts.size() ));
+    auto&                              frame_context    (m_frame_contexts.at(n_frame_context) );
+    uint32_t                           n_swapchain_image(UINT32_MAX);
+    bool                               result           (false);
+    const Clock::time_point            wait_start_time  (Clock::now() );
+    Clock::time_point                  wait_end_time;
+
+    anvil_assert(!m_is_frame_active);
+
+    if (frame_context.has_been_submitted)
+    {
+        if (!wait_for_frame_context(&frame_context,
+                                    in_timeout) )
+        {
+            goto end;
+        }
+
+        wait_end_time = Clock::now();
+
+        retire_frame_context(&frame_context);
+    }
+    else
+    {
+        wait_end_time = wait_start_time;
+    }
+
+    /* Everything which can fail is done before the image is acquired. Once the acquisition succeeds, the image
+     * available semaphore is going to be signalled, so the frame must not be abandoned. */
+    if (!init_render_finished_semaphores() )
+    {
+        goto end;
+    }
+
+    if (!frame_context.command_pool_ptr->reset(false /* in_release_resources */) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (m_transient_allocator_ptr != nullptr)
+    {
+        /* The frame which last used the slot has completed by now, so this is not expected to block for long */
+        if (!m_transient_allocator_ptr->begin_frame(UINT64_MAX) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+    }
+
+    /* Acquire the image before resetting the fence, so that a failed acquisition leaves the context reusable */
+    if (m_swapchain_ptr != nullptr)
+    {
+        acquire_result = m_swapchain_ptr->acquire_image(frame_context.image_available_semaphore_ptr.get(),
+                                                       &n_swapchain_image,
+                                                        false); /* in_should_block */
+
+        if (acquire_result != Anvil::SwapchainOperationErrorCode::SUCCESS    &&
+            acquire_result != Anvil::SwapchainOperationErrorCode::SUBOPTIMAL)
+        {
+            /* Nothing has been allocated from the transient allocator yet, so the frame can be closed right away */
+            if (m_transient_allocator_ptr != nullptr)
+            {
+                m_transient_allocator_ptr->end_frame();
+            }
+
+            goto end;
+        }
+    }
+
+    frame_context.fence_ptr->reset();
+
+    frame_context.have_timestamps_been_written = false;
+    frame_context.metrics                      = FrameMetrics();
+    frame_context.metrics.cpu_wait_time_ns     = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(wait_end_time - wait_start_time).count() );
+    frame_context.metrics.n_frame              = m_n_frames;
+
+    m_frame_start_time        = wait_end_time;
+    m_is_frame_active         = true;
+    m_n_current_frame_context = n_frame_context;
+    m_n_swapchain_image       = n_swapchain_image;
+
+    ++m_n_frames;
+
+    result = true;
+
+end:
+    if (out_opt_acquire_result_ptr != nullptr)
+    {
+        *out_opt_acquire_result_ptr = acquire_result;
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::FrameSchedulerUniquePtr Anvil::FrameScheduler::create(Anvil::BaseDevice* in_device_ptr,
+                                                             Anvil::Queue*      in_queue_ptr,
+                                                             Anvil::Swapchain*  in_opt_swapchain_ptr,
+                                                             uint32_t           in_n_frames_in_flight,
+                                                             VkDeviceSize       in_transient_data_size,
+                                                             bool               in_enable_gpu_timing)
+{
+    Anvil::FrameSchedulerUniquePtr result_ptr(nullptr,
+                                              std::default_delete<Anvil::FrameScheduler>() );
+
+    anvil_assert(in_device_ptr         != nullptr);
+    anvil_assert(in_queue_ptr          != nullptr);
+    anvil_assert(in_n_frames_in_flight >  0);
+
+    if (in_device_ptr->get_type() != Anvil::DeviceType::SINGLE_GPU)
+    {
+        anvil_assert(in_device_ptr->get_type() == Anvil::DeviceType::SINGLE_GPU);
+
+        goto end;
+    }
+
+    result_ptr.reset(
+        new Anvil::FrameScheduler(in_device_ptr,
+                                  in_queue_ptr,
+                                  in_opt_swapchain_ptr,
+                                  in_n_frames_in_flight)
+    );
+
+    if (in_enable_gpu_timing)
+    {
+        const auto     physical_device_ptr = dynamic_cast<const Anvil::SGPUDevice*>(in_device_ptr)->get_physical_device();
+        const uint32_t n_timestamp_bits    = physical_device_ptr->get_queue_families().at(in_queue_ptr->get_queue_family_index() ).n_timestamp_bits;
+
+        if (n_timestamp_bits == 0)
+        {
+            /* Timestamps are not supported by the queue family. Carry on without GPU timing. */
+            in_enable_gpu_timing = false;
+        }
+        else
+        {
+            result_ptr->m_timestamp_mask   = (n_timestamp_bits >= 64) ? UINT64_MAX
+                                                                      : ((1ull << n_timestamp_bits) - 1);
+            result_ptr->m_timestamp_period = in_device_ptr->get_physical_device_properties().core_vk1_0_properties_ptr->limits.timestamp_period;
+        }
+    }
+
+    for (auto& current_frame_context : result_ptr->m_frame_contexts)
+    {
+        if (!result_ptr->init_frame_context(&current_frame_context,
+                                             in_enable_gpu_timing) )
+        {
+            result_ptr.reset();
+
+            goto end;
+        }
+    }
+
+    if (in_transient_data_size > 0)
+    {
+        result_ptr->m_transient_allocator_ptr = Anvil::UniformRingAllocator::create(in_device_ptr,
+                                                                                    std::vector<Anvil::Queue*>(1, in_queue_ptr),
+                                                                                    in_transient_data_size,
+                                                                                    in_n_frames_in_flight);
+
+        if (result_ptr->m_transient_allocator_ptr == nullptr)
+        {
+            anvil_assert(result_ptr->m_transient_allocator_ptr != nullptr);
+
+            result_ptr.reset();
+
+            goto end;
+        }
+    }
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+bool Anvil::FrameScheduler::end_frame(Anvil::SwapchainOperationErrorCode* out_opt_present_result_ptr)
+{
+    auto&                              frame_context (m_frame_contexts.at(m_n_current_frame_context) );
+    Anvil::SwapchainOperationErrorCode present_result(Anvil::SwapchainOperationErrorCode::SUCCESS);
+    bool                               result        (false);
+    bool                               submit_result (false);
+    const Clock::time_point            submit_time   (Clock::now() );
+
+    anvil_assert(m_is_frame_active);
+
+    if (m_swapchain_ptr != nullptr)
+    {
+        static const Anvil::PipelineStageFlags wait_stage_mask        (Anvil::PipelineStageFlagBits::COLOR_ATTACHMENT_OUTPUT_BIT);
+        Anvil::Semaphore*                      image_available_sem_ptr(frame_context.image_available_semaphore_ptr.get() );
+        Anvil::Semaphore*                      render_finished_sem_ptr(m_render_finished_semaphores.at(m_n_swapchain_image).get() );
+
+        submit_result = m_queue_ptr->submit(
+            Anvil::SubmitInfo::create_wait_execute_signal(frame_context.command_buffer_ptr.get(),
+                                                          1, /* in_n_semaphores_to_signal */
+                                                         &render_finished_sem_ptr,
+                                                          1, /* in_n_semaphores_to_wait_on */
+                                                         &image_available_sem_ptr,
+                                                         &wait_stage_mask,
+                                                          false, /* in_should_block */
+                                                          frame_context.fence_ptr.get() )
+        );
+
+        if (submit_result)
+        {
+            result = m_queue_ptr->present(m_swapchain_ptr,
+                                          m_n_swapchain_image,
+                                          1, /* in_n_wait_semaphores */
+                                         &render_finished_sem_ptr,
+                                         &present_result);
+        }
+    }
+    else
+    {
+        submit_result = m_queue_ptr->submit(
+            Anvil::SubmitInfo::create_execute(frame_context.command_buffer_ptr.get(),
+                                              false, /* in_should_block */
+                                              frame_context.fence_ptr.get() )
+        );
+
+        result = submit_result;
+    }
+
+    anvil_assert(submit_result);
+
+    if (m_transient_allocator_ptr != nullptr)
+    {
+        m_transient_allocator_ptr->end_frame();
+    }
+
+    /* The fence is only going to be signalled if the submission went through. Otherwise, begin_frame() must not
+     * wait on it when the context comes up again. */
+    frame_context.has_been_submitted        = submit_result;
+    frame_context.metrics.cpu_frame_time_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(submit_time - m_frame_start_time).count() );
+    frame_context.submit_time               = submit_time;
+
+    m_is_frame_active = false;
+
+    if (out_opt_present_result_ptr != nullptr)
+    {
+        *out_opt_present_result_ptr = present_result;
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::PrimaryCommandBuffer* Anvil::FrameScheduler::get_command_buffer() const
+{
+    anvil_assert(m_is_frame_active);
+
+    return m_frame_contexts.at(m_n_current_frame_context).command_buffer_ptr.get();
+}
+
+/* Please see header for specification */
+Anvil::CommandPool* Anvil::FrameScheduler::get_command_pool() const
+{
+    return m_frame_contexts.at(m_n_current_frame_context).command_pool_ptr.get();
+}
+
+/** Creates sync objects, command pool & buffer and, optionally, the timestamp query pool of a frame context.
+ *
+ *  @param in_frame_context_ptr Frame context to initialize. Must not be nullptr.
+ *  @param in_enable_gpu_timing True if a timestamp query pool should be created for the context.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::FrameScheduler::init_frame_context(FrameContext* in_frame_context_ptr,
+                                               bool          in_enable_gpu_timing)
+{
+    bool result = false;
+
+    in_frame_context_ptr->command_pool_ptr = Anvil::CommandPool::create(m_device_ptr,
+                                                                        Anvil::CommandPoolCreateFlagBits::CREATE_TRANSIENT_BIT,
+                                                                        m_queue_ptr->get_queue_family_index() );
+
+    if (in_frame_context_ptr->command_pool_ptr == nullptr)
+    {
+        anvil_assert(in_frame_context_ptr->command_pool_ptr != nullptr);
+
+        goto end;
+    }
+
+    in_frame_context_ptr->command_buffer_ptr            = in_frame_context_ptr->command_pool_ptr->alloc_primary_level_command_buffer();
+    in_frame_context_ptr->fence_ptr                     = Anvil::Fence::create    (Anvil::FenceCreateInfo::create    (m_device_ptr,
+                                                                                                                      false) ); /* in_create_signalled */
+    in_frame_context_ptr->image_available_semaphore_ptr = Anvil::Semaphore::create(Anvil::SemaphoreCreateInfo::create(m_device_ptr) );
+
+    if (in_frame_context_ptr->command_buffer_ptr            == nullptr ||
+        in_frame_context_ptr->fence_ptr                     == nullptr ||
+        in_frame_context_ptr->image_available_semaphore_ptr == nullptr)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (in_enable_gpu_timing)
+    {
+        in_frame_context_ptr->timestamp_query_pool_ptr = Anvil::QueryPool::create_non_ps_query_pool(m_device_ptr,
+                                                                                                    VK_QUERY_TYPE_TIMESTAMP,
+                                                                                                    2); /* in_n_max_concurrent_queries */
+
+        if (in_frame_context_ptr->timestamp_query_pool_ptr == nullptr)
+        {
+            anvil_assert(in_frame_context_ptr->timestamp_query_pool_ptr != nullptr);
+
+            goto end;
+        }
+    }
+
+    result = true;
+
+end:
+    return result;
+}
+
+/** Makes sure a render finished semaphore exists for each image of the current swapchain.
+ *
+ *  The semaphores are waited on by present operations, so they are indexed by swapchain image rather than by frame
+ *  context. A semaphore can only be signalled again once its image has been re-acquired, which guarantees that the
+ *  preceding present operation has already waited on it.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::FrameScheduler::init_render_finished_semaphores()
+{
+    bool result = false;
+
+    if (m_swapchain_ptr == nullptr)
+    {
+        result = true;
+
+        goto end;
+    }
+
+    while (m_render_finished_semaphores.size() < m_swapchain_ptr->get_n_images() )
+    {
+        auto new_semaphore_ptr = Anvil::Semaphore::create(Anvil::SemaphoreCreateInfo::create(m_device_ptr) );
+
+        if (new_semaphore_ptr == nullptr)
+        {
+            anvil_assert(new_semaphore_ptr != nullptr);
+
+            goto end;
+        }
+
+        m_render_finished_semaphores.push_back(std::move(new_semaphore_ptr) );
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::FrameScheduler::record_gpu_timer_end(Anvil::CommandBufferBase* in_cmd_buffer_ptr)
+{
+    auto& frame_context = m_frame_contexts.at(m_n_current_frame_context);
+
+    anvil_assert(m_is_frame_active);
+
+    if (frame_context.timestamp_query_pool_ptr != nullptr)
+    {
+        in_cmd_buffer_ptr->record_write_timestamp(Anvil::PipelineStageFlagBits::BOTTOM_OF_PIPE_BIT,
+                                                  frame_context.timestamp_query_pool_ptr.get(),
+                                                  1); /* in_entry */
+
+        frame_context.have_timestamps_been_written = true;
+    }
+}
+
+/* Please see header for specification */
+void Anvil::FrameScheduler::record_gpu_timer_start(Anvil::CommandBufferBase* in_cmd_buffer_ptr)
+{
+    auto& frame_context = m_frame_contexts.at(m_n_current_frame_context);
+
+    anvil_assert(m_is_frame_active);
+
+    if (frame_context.timestamp_query_pool_ptr != nullptr)
+    {
+        in_cmd_buffer_ptr->record_reset_query_pool(frame_context.timestamp_query_pool_ptr.get(),
+                                                   0,  /* in_start_query */
+                                                   2); /* in_query_count */
+        in_cmd_buffer_ptr->record_write_timestamp (Anvil::PipelineStageFlagBits::TOP_OF_PIPE_BIT,
+                                                   frame_context.timestamp_query_pool_ptr.get(),
+                                                   0); /* in_entry */
+    }
+}
+
+/** Finalizes metrics of the frame, which last used @param in_frame_context_ptr. Must only be called after
+ *  the GPU has finished executing the frame.
+ **/
+void Anvil::FrameScheduler::retire_frame_context(FrameContext* in_frame_context_ptr)
+{
+    in_frame_context_ptr->metrics.submit_to_retire_time_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - in_frame_context_ptr->submit_time).count() );
+
+    if (in_frame_context_ptr->have_timestamps_been_written)
+    {
+        bool     all_results_retrieved = false;
+        uint64_t timestamps[2]         = {0, 0};
+
+        /* The frame has completed, so the results are available and no wait is needed */
+        if (in_frame_context_ptr->timestamp_query_pool_ptr->get_query_pool_results(0, /* in_first_query_index */
+                                                                                   2, /* in_n_queries */
+                                                                                   Anvil::QueryResultFlagBits::_64_BIT,
+                                                                                   timestamps,
+                                                                                  &all_results_retrieved) &&
+            all_results_retrieved)
+        {
+            const uint64_t n_ticks = (timestamps[1] - timestamps[0]) & m_timestamp_mask;
+
+            in_frame_context_ptr->metrics.gpu_time_ns = static_cast<uint64_t>(static_cast<double>(n_ticks) * m_timestamp_period);
+        }
+    }
+
+    in_frame_context_ptr->has_been_submitted = false;
+    m_last_retired_frame_metrics             = in_frame_context_ptr->metrics;
+}
+
+/* Please see header for specification */
+void Anvil::FrameScheduler::set_swapchain(Anvil::Swapchain* in_opt_swapchain_ptr)
+{
+    anvil_assert(!m_is_frame_active);
+
+    m_swapchain_ptr = in_opt_swapchain_ptr;
+}
+
+/** Blocks until the GPU finishes executing the frame, which last used @param in_frame_context_ptr.
+ *
+ *  @return true if successful, false if the timeout expired.
+ **/
+bool Anvil::FrameScheduler::wait_for_frame_context(const FrameContext* in_frame_context_ptr,
+                                                   uint64_t            in_timeout) const
+{
+    const VkResult result_vk = Anvil::Vulkan::vkWaitForFences(m_device_ptr->get_device_vk(),
+                                                              1, /* fenceCount */
+                                                              in_frame_context_ptr->fence_ptr->get_fence_ptr(),
+                                                              VK_TRUE, /* waitAll */
+                                                              in_timeout);
+
+    anvil_assert(result_vk == VK_SUCCESS ||
+                 result_vk == VK_TIMEOUT);
+
+    return (result_vk == VK_SUCCESS);
+}
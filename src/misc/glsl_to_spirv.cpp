@@ -22,6 +22,7 @@
 
 #include "misc/glsl_to_spirv.h"
 #include "misc/io.h"
+#include "misc/mapped_file.h"
 #include "misc/object_tracker.h"
 #include "wrappers/device.h"
 #include "wrappers/shader_module.h"
@@ -833,11 +834,10 @@ end:
     bool Anvil::GLSLShaderToSPIRVGenerator::bake_spirv_blob_by_spawning_glslang_process(const std::string& in_glsl_filename_with_path,
                                                                                         const std::string& in_spirv_filename_with_path) const
     {
-        auto        callback_arg            = OnGLSLToSPIRVConversionAboutToBeStartedCallbackArgument(this);
-        std::string glslangvalidator_params;
-        bool        result                  = false;
-        size_t      spirv_file_size         = 0;
-        char*       spirv_blob_ptr          = nullptr;
+        auto                       callback_arg            = OnGLSLToSPIRVConversionAboutToBeStartedCallbackArgument(this);
+        std::string                glslangvalidator_params;
+        bool                       result                  = false;
+        Anvil::MappedFileUniquePtr spirv_file_ptr;
 
         callback(GLSL_SHADER_TO_SPIRV_GENERATOR_CALLBACK_ID_CONVERSION_ABOUT_TO_START,
                 &callback_arg);
@@ -930,37 +930,25 @@ end:
         /* Now, read the SPIR-V file contents */
 
 
-        Anvil::IO::read_file(in_spirv_filename_with_path.c_str(),
-                             false, /* is_text_file */
-                            &spirv_blob_ptr,
-                            &spirv_file_size);
-
-        if (spirv_blob_ptr == nullptr)
+        if (!Anvil::IO::read_file_mapped(in_spirv_filename_with_path,
+                                         false, /* in_prefetch */
+                                        &spirv_file_ptr) )
         {
-            anvil_assert(spirv_blob_ptr != nullptr);
-
             goto end;
         }
 
-        if (spirv_file_size <= 0)
-        {
-            anvil_assert(spirv_file_size > 0);
+        m_spirv_blob.resize(spirv_file_ptr->get_size() );
 
-            goto end;
-        }
+        memcpy(&m_spirv_blob.at(0),
+               spirv_file_ptr->get_data(),
+               spirv_file_ptr->get_size() );
+
+        /* The mapping must be released before the file can be removed on Windows. */
+        spirv_file_ptr.reset();
 
         /* No need to keep the file any more. */
         Anvil::IO::delete_file(in_spirv_filename_with_path);
 
-        m_spirv_blob.resize(spirv_file_size);
-
-        memcpy(&m_spirv_blob.at(0),
-               spirv_blob_ptr,
-               spirv_file_size);
-
-        delete [] spirv_blob_ptr;
-        spirv_blob_ptr = nullptr;
-
         result = true;
 
     end:
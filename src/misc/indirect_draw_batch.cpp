@@ -0,0 +1,502 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include "misc/debug.h"
+#include "misc/indirect_draw_batch.h"
+#include "misc/uniform_ring_allocator.h"
+#include "wrappers/buffer.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/device.h"
+#include <algorithm>
+#include <cstring>
+
+/* Upper bound of minStorageBufferOffsetAlignment, as per spec. Used to size frame slots before the ring allocator
+ * is created, so that each of the three sub-allocations made per frame is guaranteed to fit. */
+#define MAX_SUBALLOCATION_ALIGNMENT (256)
+
+
+/* Please see header for specification */
+Anvil::IndirectDrawBatch::IndirectDrawBatch(uint32_t in_max_draws_per_frame,
+                                            uint32_t in_max_instances_per_frame,
+                                            uint32_t in_instance_data_stride)
+    :m_command_buffer_offset      (0),
+     m_command_data_ptr           (nullptr),
+     m_count_buffer_offset        (0),
+     m_count_data_ptr             (nullptr),
+     m_has_draw_indirect_count_amd(false),
+     m_has_draw_indirect_count_khr(false),
+     m_instance_buffer_offset     (0),
+     m_instance_data_ptr          (nullptr),
+     m_instance_data_stride       (in_instance_data_stride),
+     m_is_frame_active            (false),
+     m_max_draws_per_frame        (in_max_draws_per_frame),
+     m_max_indirect_draw_count    (1),
+     m_max_instances_per_frame    ((in_instance_data_stride > 0) ? in_max_instances_per_frame : 0),
+     m_n_counts_used              (0),
+     m_n_commands_used            (0),
+     m_n_instances_used           (0),
+     m_n_recorded_indirect_calls  (0)
+{
+    m_pending_draws.reserve(in_max_draws_per_frame);
+}
+
+/* Please see header for specification */
+Anvil::IndirectDrawBatch::~IndirectDrawBatch()
+{
+    anvil_assert(!m_is_frame_active);
+}
+
+/* Please see header for specification */
+bool Anvil::IndirectDrawBatch::add_draw(uint32_t    in_state_id,
+                                        uint32_t    in_index_count,
+                                        uint32_t    in_instance_count,
+                                        uint32_t    in_first_index,
+                                        int32_t     in_vertex_offset,
+                                        const void* in_opt_instance_data_ptr)
+{
+    Draw new_draw;
+    bool result = false;
+
+    anvil_assert(m_is_frame_active);
+    anvil_assert(in_instance_count >  0);
+    anvil_assert(in_state_id       <  static_cast<uint32_t>(m_states.size() ));
+
+    if (m_n_commands_used + static_cast<uint32_t>(m_pending_draws.size() ) >= m_max_draws_per_frame)
+    {
+        goto end;
+    }
+
+    new_draw.command.firstIndex    = in_first_index;
+    new_draw.command.firstInstance = 0;
+    new_draw.command.indexCount    = in_index_count;
+    new_draw.command.instanceCount = in_instance_count;
+    new_draw.command.vertexOffset  = in_vertex_offset;
+    new_draw.n_draw                = static_cast<uint32_t>(m_pending_draws.size() );
+    new_draw.sort_key              = (static_cast<uint64_t>(m_states.at(in_state_id).pipeline_id) << 32) | in_state_id;
+
+    if (m_instance_data_stride > 0)
+    {
+        anvil_assert(in_opt_instance_data_ptr != nullptr);
+
+        if (m_max_instances_per_frame - m_n_instances_used < in_instance_count)
+        {
+            goto end;
+        }
+
+        /* Instance data does not need to follow the sort order. Write it straight to its final location and point
+         * the draw at it with firstInstance. */
+        memcpy(m_instance_data_ptr + static_cast<size_t>(m_n_instances_used) * m_instance_data_stride,
+               in_opt_instance_data_ptr,
+               static_cast<size_t>(in_instance_count) * m_instance_data_stride);
+
+        new_draw.command.firstInstance = m_n_instances_used;
+        m_n_instances_used            += in_instance_count;
+    }
+
+    m_pending_draws.push_back(new_draw);
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+uint32_t Anvil::IndirectDrawBatch::add_state(Anvil::PipelineID                  in_pipeline_id,
+                                             Anvil::PipelineLayout*             in_pipeline_layout_ptr,
+                                             uint32_t                           in_first_set,
+                                             uint32_t                           in_n_descriptor_sets,
+                                             const Anvil::DescriptorSet* const* in_descriptor_set_ptrs,
+                                             uint32_t                           in_n_dynamic_offsets,
+                                             const uint32_t*                    in_dynamic_offset_ptrs)
+{
+    State new_state;
+
+    anvil_assert(in_n_descriptor_sets == 0 || (in_descriptor_set_ptrs != nullptr && in_pipeline_layout_ptr != nullptr) );
+    anvil_assert(in_n_dynamic_offsets == 0 ||  in_dynamic_offset_ptrs != nullptr);
+
+    new_state.descriptor_set_ptrs.assign(in_descriptor_set_ptrs,
+                                         in_descriptor_set_ptrs + in_n_descriptor_sets);
+    new_state.dynamic_offsets.assign    (in_dynamic_offset_ptrs,
+                                         in_dynamic_offset_ptrs + in_n_dynamic_offsets);
+
+    new_state.first_set           = in_first_set;
+    new_state.pipeline_id         = in_pipeline_id;
+    new_state.pipeline_layout_ptr = in_pipeline_layout_ptr;
+
+    m_states.push_back(new_state);
+
+    return static_cast<uint32_t>(m_states.size() - 1);
+}
+
+/* Please see header for specification */
+bool Anvil::IndirectDrawBatch::begin_frame(uint64_t in_timeout)
+{
+    void* command_data_ptr (nullptr);
+    void* count_data_ptr   (nullptr);
+    void* instance_data_ptr(nullptr);
+    bool  result           (false);
+
+    anvil_assert(!m_is_frame_active);
+
+    if (!m_ring_allocator_ptr->begin_frame(in_timeout) )
+    {
+        goto end;
+    }
+
+    /* The frame slot is sized to hold all three regions, so none of these can fail */
+    if (!m_ring_allocator_ptr->allocate(static_cast<VkDeviceSize>(m_max_draws_per_frame) * sizeof(VkDrawIndexedIndirectCommand),
+                                       &command_data_ptr,
+                                       &m_command_buffer_offset)                                                                 ||
+        !m_ring_allocator_ptr->allocate(static_cast<VkDeviceSize>(m_max_draws_per_frame) * sizeof(uint32_t),
+                                       &count_data_ptr,
+                                       &m_count_buffer_offset) )
+    {
+        anvil_assert_fail();
+
+        m_ring_allocator_ptr->end_frame();
+
+        goto end;
+    }
+
+    if (m_instance_data_stride > 0)
+    {
+        if (!m_ring_allocator_ptr->allocate(static_cast<VkDeviceSize>(m_max_instances_per_frame) * m_instance_data_stride,
+                                           &instance_data_ptr,
+                                           &m_instance_buffer_offset) )
+        {
+            anvil_assert_fail();
+
+            m_ring_allocator_ptr->end_frame();
+
+            goto end;
+        }
+    }
+
+    m_command_data_ptr  = static_cast<char*>    (command_data_ptr);
+    m_count_data_ptr    = static_cast<uint32_t*>(count_data_ptr);
+    m_instance_data_ptr = static_cast<char*>    (instance_data_ptr);
+    m_is_frame_active   = true;
+    m_n_commands_used   = 0;
+    m_n_counts_used     = 0;
+    m_n_instances_used  = 0;
+
+    m_pending_draws.clear();
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::IndirectDrawBatchUniquePtr Anvil::IndirectDrawBatch::create(const Anvil::BaseDevice*          in_device_ptr,
+                                                                   const std::vector<Anvil::Queue*>& in_queue_ptrs,
+                                                                   uint32_t                          in_max_draws_per_frame,
+                                                                   uint32_t                          in_max_instances_per_frame,
+                                                                   uint32_t                          in_instance_data_stride,
+                                                                   uint32_t                          in_n_frames_in_flight)
+{
+    VkDeviceSize                      frame_slot_size(0);
+    Anvil::IndirectDrawBatchUniquePtr result_ptr     (nullptr,
+                                                      std::default_delete<Anvil::IndirectDrawBatch>() );
+
+    anvil_assert(in_device_ptr          != nullptr);
+    anvil_assert(in_max_draws_per_frame >  0);
+    anvil_assert(in_n_frames_in_flight  >  0);
+
+    const auto& features(*in_device_ptr->get_physical_device_features  ().core_vk1_0_features_ptr);
+    const auto& limits  ( in_device_ptr->get_physical_device_properties().core_vk1_0_properties_ptr->limits);
+
+    if (in_instance_data_stride > 0           &&
+        !features.draw_indirect_first_instance)
+    {
+        /* Per-instance data is addressed with firstInstance, which must be 0 for indirect draws otherwise */
+        anvil_assert(features.draw_indirect_first_instance);
+
+        goto end;
+    }
+
+    frame_slot_size = Anvil::Utils::round_up(static_cast<VkDeviceSize>(in_max_draws_per_frame) * sizeof(VkDrawIndexedIndirectCommand),
+                                             static_cast<VkDeviceSize>(MAX_SUBALLOCATION_ALIGNMENT) ) +
+                      Anvil::Utils::round_up(static_cast<VkDeviceSize>(in_max_draws_per_frame) * sizeof(uint32_t),
+                                             static_cast<VkDeviceSize>(MAX_SUBALLOCATION_ALIGNMENT) );
+
+    if (in_instance_data_stride > 0)
+    {
+        anvil_assert(in_max_instances_per_frame > 0);
+
+        frame_slot_size += Anvil::Utils::round_up(static_cast<VkDeviceSize>(in_max_instances_per_frame) * in_instance_data_stride,
+                                                  static_cast<VkDeviceSize>(MAX_SUBALLOCATION_ALIGNMENT) );
+    }
+
+    result_ptr.reset(
+        new Anvil::IndirectDrawBatch(in_max_draws_per_frame,
+                                     in_max_instances_per_frame,
+                                     in_instance_data_stride)
+    );
+
+    /* Storage usage lets GPU culling passes rewrite indirect arguments & draw counts in place. */
+    result_ptr->m_ring_allocator_ptr = Anvil::UniformRingAllocator::create(in_device_ptr,
+                                                                           in_queue_ptrs,
+                                                                           frame_slot_size,
+                                                                           in_n_frames_in_flight,
+                                                                           Anvil::BufferUsageFlagBits::INDIRECT_BUFFER_BIT |
+                                                                           Anvil::BufferUsageFlagBits::STORAGE_BUFFER_BIT  |
+                                                                           Anvil::BufferUsageFlagBits::VERTEX_BUFFER_BIT);
+
+    if (result_ptr->m_ring_allocator_ptr == nullptr)
+    {
+        anvil_assert(result_ptr->m_ring_allocator_ptr != nullptr);
+
+        result_ptr.reset();
+
+        goto end;
+    }
+
+    result_ptr->m_has_draw_indirect_count_amd = in_device_ptr->get_extension_info()->amd_draw_indirect_count();
+    result_ptr->m_has_draw_indirect_count_khr = in_device_ptr->get_extension_info()->khr_draw_indirect_count();
+    result_ptr->m_max_indirect_draw_count     = (features.multi_draw_indirect) ? std::max(limits.max_draw_indirect_count, 1u)
+                                                                               : 1;
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+void Anvil::IndirectDrawBatch::end_frame()
+{
+    anvil_assert(m_is_frame_active);
+
+    m_ring_allocator_ptr->end_frame();
+
+    m_command_data_ptr  = nullptr;
+    m_count_data_ptr    = nullptr;
+    m_instance_data_ptr = nullptr;
+    m_is_frame_active   = false;
+
+    m_pending_draws.clear();
+}
+
+/* Please see header for specification */
+Anvil::Buffer* Anvil::IndirectDrawBatch::get_buffer() const
+{
+    return m_ring_allocator_ptr->get_buffer();
+}
+
+/* Please see header for specification */
+bool Anvil::IndirectDrawBatch::record(Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                                      uint32_t                  in_instance_data_binding)
+{
+    Anvil::Buffer*    buffer_ptr         (m_ring_allocator_ptr->get_buffer() );
+    bool              is_pipeline_bound  (false);
+    Anvil::PipelineID last_pipeline_id   (0);
+    uint32_t          n_bucket_end       (0);
+    uint32_t          n_bucket_start     (0);
+    const uint32_t    n_draws            (static_cast<uint32_t>(m_pending_draws.size() ));
+    bool              result             (false);
+
+    anvil_assert(in_cmd_buffer_ptr != nullptr);
+    anvil_assert(m_is_frame_active);
+
+    m_n_recorded_indirect_calls = 0;
+
+    if (n_draws == 0)
+    {
+        result = true;
+
+        goto end;
+    }
+
+    /* Group the draws by pipeline first and by render state second, so that each pipeline is bound only once. */
+    std::sort(m_pending_draws.begin(),
+              m_pending_draws.end  () );
+
+    for (uint32_t n_draw = 0;
+                  n_draw < n_draws;
+                ++n_draw)
+    {
+        memcpy(m_command_data_ptr + static_cast<size_t>(m_n_commands_used + n_draw) * sizeof(VkDrawIndexedIndirectCommand),
+              &m_pending_draws.at(n_draw).command,
+               sizeof(VkDrawIndexedIndirectCommand) );
+    }
+
+    if (m_instance_data_stride > 0)
+    {
+        const VkDeviceSize instance_buffer_offset = m_instance_buffer_offset;
+
+        if (!in_cmd_buffer_ptr->record_bind_vertex_buffers(in_instance_data_binding,
+                                                           1, /* in_binding_count */
+                                                          &buffer_ptr,
+                                                          &instance_buffer_offset) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+    }
+
+    while (n_bucket_start < n_draws)
+    {
+        const uint64_t sort_key (m_pending_draws.at(n_bucket_start).sort_key);
+        const State&   state    (m_states.at(static_cast<uint32_t>(sort_key & UINT32_MAX) ));
+
+        n_bucket_end = n_bucket_start + 1;
+
+        while (n_bucket_end                               < n_draws &&
+               m_pending_draws.at(n_bucket_end).sort_key == sort_key)
+        {
+            ++n_bucket_end;
+        }
+
+        if (!is_pipeline_bound                ||
+             state.pipeline_id != last_pipeline_id)
+        {
+            if (!in_cmd_buffer_ptr->record_bind_pipeline(Anvil::PipelineBindPoint::GRAPHICS,
+                                                         state.pipeline_id) )
+            {
+                anvil_assert_fail();
+
+                goto end;
+            }
+
+            is_pipeline_bound = true;
+            last_pipeline_id  = state.pipeline_id;
+        }
+
+        if (state.descriptor_set_ptrs.size() > 0)
+        {
+            if (!in_cmd_buffer_ptr->record_bind_descriptor_sets(Anvil::PipelineBindPoint::GRAPHICS,
+                                                                state.pipeline_layout_ptr,
+                                                                state.first_set,
+                                                                static_cast<uint32_t>(state.descriptor_set_ptrs.size() ),
+                                                               &state.descriptor_set_ptrs.at(0),
+                                                                static_cast<uint32_t>(state.dynamic_offsets.size() ),
+                                                                (state.dynamic_offsets.size() > 0) ? &state.dynamic_offsets.at(0)
+                                                                                                   : nullptr) )
+            {
+                anvil_assert_fail();
+
+                goto end;
+            }
+        }
+
+        if (!record_draws(in_cmd_buffer_ptr,
+                          m_n_commands_used + n_bucket_start,
+                          n_bucket_end      - n_bucket_start) )
+        {
+            goto end;
+        }
+
+        n_bucket_start = n_bucket_end;
+    }
+
+    result = true;
+end:
+    m_n_commands_used += n_draws;
+
+    m_pending_draws.clear();
+
+    return result;
+}
+
+/** Records indirect draw calls for a range of packed indirect commands, all of which share the render state.
+ *
+ *  Uses the count variant of the call if VK_KHR_draw_indirect_count or VK_AMD_draw_indirect_count is enabled.
+ *  Splits the range into multiple calls if it exceeds maxDrawIndirectCount, or into one call per command if
+ *  multiDrawIndirect is not supported.
+ *
+ *  @param in_cmd_buffer_ptr  Command buffer to record the calls into. Must not be nullptr.
+ *  @param in_n_first_command Index of the first command in the current frame's command region.
+ *  @param in_n_commands      Number of commands to draw. Must not be 0.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::IndirectDrawBatch::record_draws(Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                                            uint32_t                  in_n_first_command,
+                                            uint32_t                  in_n_commands)
+{
+    Anvil::Buffer* buffer_ptr       (m_ring_allocator_ptr->get_buffer() );
+    uint32_t       n_commands_left  (in_n_commands);
+    uint32_t       n_current_command(in_n_first_command);
+    bool           result           (false);
+    const uint32_t stride           (static_cast<uint32_t>(sizeof(VkDrawIndexedIndirectCommand) ));
+
+    anvil_assert(in_n_commands > 0);
+
+    while (n_commands_left > 0)
+    {
+        const uint32_t     n_commands    (std::min(n_commands_left,
+                                                   m_max_indirect_draw_count) );
+        const VkDeviceSize command_offset(m_command_buffer_offset + static_cast<VkDeviceSize>(n_current_command) * stride);
+        bool               call_result   (false);
+
+        if (m_has_draw_indirect_count_khr ||
+            m_has_draw_indirect_count_amd)
+        {
+            const VkDeviceSize count_offset(m_count_buffer_offset + static_cast<VkDeviceSize>(m_n_counts_used) * sizeof(uint32_t) );
+
+            anvil_assert(m_n_counts_used < m_max_draws_per_frame);
+
+            m_count_data_ptr[m_n_counts_used++] = n_commands;
+
+            if (m_has_draw_indirect_count_khr)
+            {
+                call_result = in_cmd_buffer_ptr->record_draw_indexed_indirect_count_KHR(buffer_ptr,
+                                                                                        command_offset,
+                                                                                        buffer_ptr,
+                                                                                        count_offset,
+                                                                                        n_commands,
+                                                                                        stride);
+            }
+            else
+            {
+                call_result = in_cmd_buffer_ptr->record_draw_indexed_indirect_count_AMD(buffer_ptr,
+                                                                                        command_offset,
+                                                                                        buffer_ptr,
+                                                                                        count_offset,
+                                                                                        n_commands,
+                                                                                        stride);
+            }
+        }
+        else
+        {
+            call_result = in_cmd_buffer_ptr->record_draw_indexed_indirect(buffer_ptr,
+                                                                          command_offset,
+                                                                          n_commands,
+                                                                          stride);
+        }
+
+        if (!call_result)
+        {
+            anvil_assert(call_result);
+
+            goto end;
+        }
+
+        ++m_n_recorded_indirect_calls;
+
+        n_commands_left   -= n_commands;
+        n_current_command += n_commands;
+    }
+
+    result = true;
+end:
+    return result;
+}
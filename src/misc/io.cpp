@@ -25,6 +25,7 @@
  */
 #include "misc/debug.h"
 #include "misc/io.h"
+#include "misc/mapped_file.h"
 #include "misc/types.h"
 #include <stdio.h>
 #include <string.h>
@@ -547,6 +548,30 @@ end:
     return result_bool;
 }
 
+/* Please see header for specification */
+bool Anvil::IO::read_file_mapped(const std::string&          in_filename,
+                                 bool                        in_prefetch,
+                                 Anvil::MappedFileUniquePtr* out_result_ptr)
+{
+    bool result = false;
+
+    anvil_assert(out_result_ptr != nullptr);
+
+    *out_result_ptr = Anvil::MappedFile::create(in_filename,
+                                                in_prefetch);
+
+    if (*out_result_ptr == nullptr)
+    {
+        anvil_assert(*out_result_ptr != nullptr);
+
+        goto end;
+    }
+
+    result = true;
+end:
+    return result;
+}
+
 /** Please see header for specification */
 bool Anvil::IO::write_binary_file(std::string  in_filename,
                                   const void*  in_data,
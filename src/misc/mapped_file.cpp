@@ -0,0 +1,306 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/mapped_file.h"
+#include "wrappers/buffer.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+/* Please see header for specification */
+Anvil::MappedFile::MappedFile(const std::string& in_filename)
+    :m_data_ptr(nullptr),
+     m_filename(in_filename),
+     m_size    (0)
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::MappedFile::~MappedFile()
+{
+    if (m_data_ptr != nullptr)
+    {
+        #if defined(_WIN32)
+        {
+            ::UnmapViewOfFile(m_data_ptr);
+        }
+        #else
+        {
+            munmap(m_data_ptr,
+                   m_size);
+        }
+        #endif
+
+        m_data_ptr = nullptr;
+    }
+}
+
+/* Please see header for specification */
+Anvil::MappedFileUniquePtr Anvil::MappedFile::create(const std::string& in_filename,
+                                                     bool               in_prefetch)
+{
+    Anvil::MappedFileUniquePtr result_ptr(nullptr,
+                                          std::default_delete<Anvil::MappedFile>() );
+
+    result_ptr.reset(
+        new Anvil::MappedFile(in_filename)
+    );
+
+    if (result_ptr != nullptr)
+    {
+        if (!result_ptr->init(in_prefetch) )
+        {
+            result_ptr.reset();
+        }
+    }
+
+    return result_ptr;
+}
+
+/** Opens the file and maps its whole contents into the process' address space.
+ *
+ *  File handles are closed before the function leaves. The mapping itself keeps the file
+ *  contents accessible until it is released in the destructor.
+ *
+ *  @param in_prefetch As per create().
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::MappedFile::init(bool in_prefetch)
+{
+    bool result = false;
+
+    #if defined(_WIN32)
+        HANDLE             file_handle         = INVALID_HANDLE_VALUE;
+        LARGE_INTEGER      file_size_large;
+        HANDLE             file_mapping_handle = nullptr;
+        const std::wstring filename_wide       = std::wstring(m_filename.begin(), m_filename.end() );
+
+        file_handle = ::CreateFileW(filename_wide.c_str(),
+                                    GENERIC_READ,
+                                    FILE_SHARE_READ,
+                                    nullptr, /* lpSecurityAttributes */
+                                    OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                    nullptr);
+
+        if (file_handle == INVALID_HANDLE_VALUE)
+        {
+            goto end;
+        }
+
+        if (::GetFileSizeEx(file_handle,
+                           &file_size_large) == 0)
+        {
+            goto end;
+        }
+
+        if (file_size_large.QuadPart == 0)
+        {
+            goto end;
+        }
+
+        m_size = static_cast<size_t>(file_size_large.QuadPart);
+
+        file_mapping_handle = ::CreateFileMappingW(file_handle,
+                                                   nullptr, /* lpFileMappingAttributes */
+                                                   PAGE_READONLY,
+                                                   0,       /* dwMaximumSizeHigh */
+                                                   0,       /* dwMaximumSizeLow  */
+                                                   nullptr  /* lpName            */);
+
+        if (file_mapping_handle == nullptr)
+        {
+            goto end;
+        }
+
+        m_data_ptr = ::MapViewOfFile(file_mapping_handle,
+                                     FILE_MAP_READ,
+                                     0,  /* dwFileOffsetHigh */
+                                     0,  /* dwFileOffsetLow  */
+                                     0); /* dwNumberOfBytesToMap - whole file */
+
+        if (m_data_ptr == nullptr)
+        {
+            goto end;
+        }
+    #else
+        int           file_descriptor = -1;
+        struct stat64 file_stats;
+        void*         mapping_ptr     = MAP_FAILED;
+
+        file_descriptor = open64(m_filename.c_str(),
+                                 O_RDONLY);
+
+        if (file_descriptor == -1)
+        {
+            goto end;
+        }
+
+        if (fstat64(file_descriptor,
+                   &file_stats) != 0)
+        {
+            goto end;
+        }
+
+        if (file_stats.st_size <= 0)
+        {
+            goto end;
+        }
+
+        m_size = static_cast<size_t>(file_stats.st_size);
+
+        mapping_ptr = mmap(nullptr, /* addr */
+                           m_size,
+                           PROT_READ,
+                           MAP_PRIVATE,
+                           file_descriptor,
+                           0); /* offset */
+
+        if (mapping_ptr == MAP_FAILED)
+        {
+            goto end;
+        }
+
+        m_data_ptr = mapping_ptr;
+    #endif
+
+    if (in_prefetch)
+    {
+        prefetch();
+    }
+
+    result = true;
+end:
+    #if defined(_WIN32)
+    {
+        /* The view keeps the mapping object & the file alive, so the handles can be closed right away. */
+        if (file_mapping_handle != nullptr)
+        {
+            ::CloseHandle(file_mapping_handle);
+        }
+
+        if (file_handle != INVALID_HANDLE_VALUE)
+        {
+            ::CloseHandle(file_handle);
+        }
+    }
+    #else
+    {
+        /* The mapping remains valid after the descriptor is closed. */
+        if (file_descriptor != -1)
+        {
+            close(file_descriptor);
+        }
+    }
+    #endif
+
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::MappedFile::prefetch() const
+{
+    const volatile char* data_ptr  = static_cast<const volatile char*>(m_data_ptr);
+    size_t               page_size = 0;
+    char                 dummy     = 0;
+
+    if (m_data_ptr == nullptr)
+    {
+        return;
+    }
+
+    #if defined(_WIN32)
+    {
+        SYSTEM_INFO system_info;
+
+        ::GetSystemInfo(&system_info);
+
+        page_size = static_cast<size_t>(system_info.dwPageSize);
+    }
+    #else
+    {
+        page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE) );
+
+        /* Let the kernel start reading ahead before we touch the pages one after another. */
+        madvise(m_data_ptr,
+                m_size,
+                MADV_WILLNEED);
+    }
+    #endif
+
+    if (page_size == 0)
+    {
+        page_size = 4096;
+    }
+
+    /* Touch one byte per page to fault the whole file in. */
+    for (size_t offset = 0;
+                offset < m_size;
+                offset += page_size)
+    {
+        dummy ^= data_ptr[offset];
+    }
+
+    dummy ^= data_ptr[m_size - 1];
+
+    ANVIL_REDUNDANT_VARIABLE(dummy);
+}
+
+/* Please see header for specification */
+bool Anvil::MappedFile::write_to_buffer(Anvil::Buffer* in_buffer_ptr,
+                                        VkDeviceSize   in_buffer_start_offset,
+                                        size_t         in_file_start_offset,
+                                        size_t         in_size,
+                                        Anvil::Queue*  in_opt_queue_ptr) const
+{
+    bool result = false;
+
+    anvil_assert(in_buffer_ptr != nullptr);
+
+    if (in_file_start_offset > m_size                        ||
+        in_size              > m_size - in_file_start_offset)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    /* Buffer::write() copies straight from the mapped pages into the buffer's memory (or the staging
+     * buffer), so the file contents are never copied into an intermediate heap allocation. */
+    result = in_buffer_ptr->write(in_buffer_start_offset,
+                                  in_size,
+                                  static_cast<const char*>(m_data_ptr) + in_file_start_offset,
+                                  in_opt_queue_ptr);
+
+end:
+    return result;
+}
@@ -0,0 +1,749 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/memalloc_backends/backend_incremental.h"
+#include "misc/debug.h"
+#include "misc/image_create_info.h"
+#include "misc/memory_allocator.h"
+#include "misc/memory_block_create_info.h"
+#include "wrappers/buffer.h"
+#include "wrappers/device.h"
+#include "wrappers/image.h"
+#include "wrappers/memory_block.h"
+#include <algorithm>
+
+
+namespace
+{
+    /** Returns index of the least significant bit set in @param in_value. @param in_value must not be 0. */
+    uint32_t get_lowest_set_bit_index(uint64_t in_value)
+    {
+        uint32_t result = 0;
+
+        anvil_assert(in_value != 0);
+
+        while ((in_value & 1) == 0)
+        {
+            in_value >>= 1;
+            ++result;
+        }
+
+        return result;
+    }
+
+    /** Returns index of the most significant bit set in @param in_value. @param in_value must not be 0. */
+    uint32_t get_highest_set_bit_index(uint64_t in_value)
+    {
+        uint32_t result = 0;
+
+        anvil_assert(in_value != 0);
+
+        while (in_value > 1)
+        {
+            in_value >>= 1;
+            ++result;
+        }
+
+        return result;
+    }
+}
+
+
+/** Please see header for specification */
+Anvil::MemoryAllocatorBackends::Incremental::TLSFAllocator::TLSFAllocator(VkDeviceSize in_size)
+    :m_first_level_bitmap(0),
+     m_n_allocations     (0)
+{
+    anvil_assert(in_size > 0);
+
+    m_second_level_bitmaps.fill(0);
+
+    m_regions[0] = Region(in_size,
+                          true); /* in_is_free */
+
+    insert_free_region(0, /* in_offset */
+                       in_size);
+}
+
+/** Please see header for specification */
+bool Anvil::MemoryAllocatorBackends::Incremental::TLSFAllocator::allocate(VkDeviceSize  in_size,
+                                                                          VkDeviceSize  in_alignment,
+                                                                          VkDeviceSize* out_offset_ptr)
+{
+    VkDeviceSize aligned_offset = 0;
+    VkDeviceSize region_end     = 0;
+    VkDeviceSize region_offset  = 0;
+    bool         result         = false;
+
+    anvil_assert(in_alignment   != 0);
+    anvil_assert(in_size        != 0);
+    anvil_assert(out_offset_ptr != nullptr);
+
+    /* Any region at least (size + alignment - 1) bytes large is guaranteed to be able to hold an aligned
+     * allocation of the requested size. */
+    if (!find_free_region(in_size + in_alignment - 1,
+                         &region_offset) )
+    {
+        goto end;
+    }
+
+    region_end = region_offset + m_regions.at(region_offset).size;
+
+    remove_free_region(region_offset,
+                       m_regions.at(region_offset).size);
+
+    aligned_offset = Anvil::Utils::round_up(region_offset,
+                                            in_alignment);
+
+    /* Return the leading & trailing parts of the region, which are not going to be used, back to the free-list. */
+    if (aligned_offset != region_offset)
+    {
+        m_regions[region_offset] = Region(aligned_offset - region_offset,
+                                          true); /* in_is_free */
+
+        insert_free_region(region_offset,
+                           aligned_offset - region_offset);
+    }
+
+    if (aligned_offset + in_size < region_end)
+    {
+        m_regions[aligned_offset + in_size] = Region(region_end - (aligned_offset + in_size),
+                                                     true); /* in_is_free */
+
+        insert_free_region(aligned_offset + in_size,
+                           region_end - (aligned_offset + in_size) );
+    }
+
+    m_regions[aligned_offset] = Region(in_size,
+                                       false); /* in_is_free */
+
+    ++m_n_allocations;
+
+    *out_offset_ptr = aligned_offset;
+    result          = true;
+end:
+    return result;
+}
+
+/** Looks for a free region which is at least @param in_size bytes large.
+ *
+ *  @param in_size        Minimum size of the region.
+ *  @param out_offset_ptr Deref will be set to the region's start offset if the function succeeds.
+ *
+ *  @return true if a region has been found, false otherwise.
+ **/
+bool Anvil::MemoryAllocatorBackends::Incremental::TLSFAllocator::find_free_region(VkDeviceSize  in_size,
+                                                                                  VkDeviceSize* out_offset_ptr) const
+{
+    uint32_t     n_first_level_bucket  = 0;
+    uint32_t     n_second_level_bucket = 0;
+    VkDeviceSize rounded_size          = in_size;
+    bool         result                = false;
+    uint32_t     second_level_bitmap   = 0;
+
+    /* Round the size up to the next bucket boundary, so that all regions stored in the bucket we end up with
+     * are large enough to hold the allocation. */
+    {
+        const uint32_t n_highest_bit = get_highest_set_bit_index(in_size);
+
+        if (n_highest_bit >= N_SECOND_LEVEL_BITS)
+        {
+            rounded_size += (static_cast<VkDeviceSize>(1) << (n_highest_bit - N_SECOND_LEVEL_BITS)) - 1;
+        }
+    }
+
+    get_bucket_indices(rounded_size,
+                      &n_first_level_bucket,
+                      &n_second_level_bucket);
+
+    second_level_bitmap = m_second_level_bitmaps.at(n_first_level_bucket) & (~0u << n_second_level_bucket);
+
+    if (second_level_bitmap == 0)
+    {
+        /* No large enough region in the first-level bucket. Use the smallest region from the next non-empty one. */
+        const uint64_t first_level_bitmap = (n_first_level_bucket + 1 < N_FIRST_LEVEL_BUCKETS) ? (m_first_level_bitmap & (~0ull << (n_first_level_bucket + 1) ))
+                                                                                               : 0;
+
+        if (first_level_bitmap == 0)
+        {
+            goto end;
+        }
+
+        n_first_level_bucket = get_lowest_set_bit_index(first_level_bitmap);
+        second_level_bitmap  = m_second_level_bitmaps.at(n_first_level_bucket);
+    }
+
+    n_second_level_bucket = get_lowest_set_bit_index(second_level_bitmap);
+
+    anvil_assert(!m_free_regions.at(n_first_level_bucket * N_SECOND_LEVEL_BUCKETS + n_second_level_bucket).empty() );
+
+    *out_offset_ptr = *m_free_regions.at(n_first_level_bucket * N_SECOND_LEVEL_BUCKETS + n_second_level_bucket).begin();
+    result          = true;
+end:
+    return result;
+}
+
+/** Please see header for specification */
+void Anvil::MemoryAllocatorBackends::Incremental::TLSFAllocator::free(VkDeviceSize in_offset)
+{
+    auto         region_iterator = m_regions.find(in_offset);
+    VkDeviceSize region_offset   = in_offset;
+    VkDeviceSize region_size     = 0;
+
+    anvil_assert(region_iterator != m_regions.end() );
+    anvil_assert(!region_iterator->second.is_free);
+    anvil_assert(m_n_allocations > 0);
+
+    region_size = region_iterator->second.size;
+
+    /* Merge the region with free neighbours, if any */
+    {
+        auto next_region_iterator = std::next(region_iterator);
+
+        if (next_region_iterator != m_regions.end() &&
+            next_region_iterator->second.is_free)
+        {
+            remove_free_region(next_region_iterator->first,
+                               next_region_iterator->second.size);
+
+            region_size += next_region_iterator->second.size;
+
+            m_regions.erase(next_region_iterator);
+        }
+    }
+
+    if (region_iterator != m_regions.begin() )
+    {
+        auto prev_region_iterator = std::prev(region_iterator);
+
+        if (prev_region_iterator->second.is_free)
+        {
+            remove_free_region(prev_region_iterator->first,
+                               prev_region_iterator->second.size);
+
+            region_offset  = prev_region_iterator->first;
+            region_size   += prev_region_iterator->second.size;
+
+            m_regions.erase(region_iterator);
+
+            region_iterator = prev_region_iterator;
+        }
+    }
+
+    region_iterator->second = Region(region_size,
+                                     true); /* in_is_free */
+
+    insert_free_region(region_offset,
+                       region_size);
+
+    --m_n_allocations;
+}
+
+/** Maps region size to first- and second-level bucket indices. */
+void Anvil::MemoryAllocatorBackends::Incremental::TLSFAllocator::get_bucket_indices(VkDeviceSize in_size,
+                                                                                    uint32_t*    out_n_first_level_bucket_ptr,
+                                                                                    uint32_t*    out_n_second_level_bucket_ptr) const
+{
+    const uint32_t n_highest_bit = get_highest_set_bit_index(in_size);
+
+    *out_n_first_level_bucket_ptr  = n_highest_bit;
+    *out_n_second_level_bucket_ptr = static_cast<uint32_t>(((n_highest_bit >= N_SECOND_LEVEL_BITS) ? (in_size >> (n_highest_bit - N_SECOND_LEVEL_BITS))
+                                                                                                   : (in_size << (N_SECOND_LEVEL_BITS - n_highest_bit))) & (N_SECOND_LEVEL_BUCKETS - 1) );
+}
+
+/** Stores a free region in the bucket corresponding to its size. */
+void Anvil::MemoryAllocatorBackends::Incremental::TLSFAllocator::insert_free_region(VkDeviceSize in_offset,
+                                                                                    VkDeviceSize in_size)
+{
+    uint32_t n_first_level_bucket  = 0;
+    uint32_t n_second_level_bucket = 0;
+
+    get_bucket_indices(in_size,
+                      &n_first_level_bucket,
+                      &n_second_level_bucket);
+
+    m_free_regions.at(n_first_level_bucket * N_SECOND_LEVEL_BUCKETS + n_second_level_bucket).insert(in_offset);
+
+    m_first_level_bitmap                              |= (1ull << n_first_level_bucket);
+    m_second_level_bitmaps.at(n_first_level_bucket)   |= (1u   << n_second_level_bucket);
+}
+
+/** Removes a free region from the bucket corresponding to its size. */
+void Anvil::MemoryAllocatorBackends::Incremental::TLSFAllocator::remove_free_region(VkDeviceSize in_offset,
+                                                                                    VkDeviceSize in_size)
+{
+    uint32_t n_first_level_bucket  = 0;
+    uint32_t n_second_level_bucket = 0;
+
+    get_bucket_indices(in_size,
+                      &n_first_level_bucket,
+                      &n_second_level_bucket);
+
+    auto& free_regions = m_free_regions.at(n_first_level_bucket * N_SECOND_LEVEL_BUCKETS + n_second_level_bucket);
+
+    anvil_assert(free_regions.find(in_offset) != free_regions.end() );
+
+    free_regions.erase(in_offset);
+
+    if (free_regions.empty() )
+    {
+        m_second_level_bitmaps.at(n_first_level_bucket) &= ~(1u << n_second_level_bucket);
+
+        if (m_second_level_bitmaps.at(n_first_level_bucket) == 0)
+        {
+            m_first_level_bitmap &= ~(1ull << n_first_level_bucket);
+        }
+    }
+}
+
+/** Please see header for specification */
+Anvil::MemoryAllocatorBackends::Incremental::Incremental(const Anvil::BaseDevice* in_device_ptr,
+                                                         VkDeviceSize             in_page_size)
+    :m_device_ptr(in_device_ptr),
+     m_page_size (in_page_size)
+{
+    anvil_assert(in_page_size > 0);
+}
+
+/** Please see header for specification */
+Anvil::MemoryAllocatorBackends::Incremental::~Incremental()
+{
+    /* Stub */
+}
+
+/** Assigns memory regions to all specified items. Items which can share memory are assigned regions of
+ *  existing pages, if there's enough space available. Otherwise, a new page is allocated.
+ *
+ *  Items which have already been assigned memory by previous bake invocations are not touched.
+ *
+ *  This function can be called multiple times.
+ *
+ *  @param in_items Items to bake memory objects for.
+ *
+ *  @return true if all items have been assigned memory, false if there was at least one failure.
+ **/
+bool Anvil::MemoryAllocatorBackends::Incremental::bake(Anvil::MemoryAllocator::Items& in_items)
+{
+    std::unique_lock<std::mutex> lock  (m_mutex);
+    bool                         result(true);
+
+    /* Pages which no longer hold any regions are only released at bake time, in order to avoid
+     * thrashing if apps release & re-create resources in a quick succession. */
+    release_empty_pages();
+
+    for (auto& current_item_ptr : in_items)
+    {
+        uint32_t n_memory_type = UINT32_MAX;
+
+        if (!get_memory_type_for_item(current_item_ptr.get(),
+                                     &n_memory_type) )
+        {
+            anvil_assert_fail();
+
+            result = false;
+            continue;
+        }
+
+        if (current_item_ptr->alloc_is_dedicated_memory                   ||
+            current_item_ptr->alloc_exportable_external_handle_types != 0)
+        {
+            if (!bake_dedicated_item(current_item_ptr.get(),
+                                     n_memory_type) )
+            {
+                result = false;
+            }
+        }
+        else
+        {
+            if (!bake_pooled_item(current_item_ptr.get(),
+                                  n_memory_type) )
+            {
+                result = false;
+            }
+        }
+    }
+
+    return result;
+}
+
+/** Creates a separate memory block for the specified item.
+ *
+ *  @param in_item_ptr      Item to create the memory block for.
+ *  @param in_n_memory_type Index of the memory type to use.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::MemoryAllocatorBackends::Incremental::bake_dedicated_item(Anvil::MemoryAllocator::Item* in_item_ptr,
+                                                                      uint32_t                      in_n_memory_type)
+{
+    const auto& memory_props    (m_device_ptr->get_physical_device_memory_properties() );
+    auto        create_info_ptr (Anvil::MemoryBlockCreateInfo::create_regular(m_device_ptr,
+                                                                              1u << in_n_memory_type,
+                                                                              in_item_ptr->alloc_size,
+                                                                              memory_props.types.at(in_n_memory_type).features) );
+
+    create_info_ptr->set_memory_priority(in_item_ptr->memory_priority);
+    create_info_ptr->set_device_mask    (in_item_ptr->alloc_device_mask);
+    create_info_ptr->set_mt_safety      (Anvil::Utils::convert_boolean_to_mt_safety_enum(m_device_ptr->is_mt_safe()) );
+
+    if (in_item_ptr->alloc_is_dedicated_memory)
+    {
+        create_info_ptr->use_dedicated_allocation(in_item_ptr->buffer_ptr,
+                                                  in_item_ptr->image_ptr);
+    }
+
+    if (in_item_ptr->alloc_exportable_external_handle_types != 0)
+    {
+        create_info_ptr->set_exportable_external_memory_handle_types(in_item_ptr->alloc_exportable_external_handle_types);
+    }
+
+    #if defined(_WIN32)
+    {
+        if (in_item_ptr->alloc_external_nt_handle_info_ptr != nullptr)
+        {
+            create_info_ptr->set_exportable_nt_handle_info(in_item_ptr->alloc_external_nt_handle_info_ptr->attributes_ptr,
+                                                           in_item_ptr->alloc_external_nt_handle_info_ptr->access,
+                                                           in_item_ptr->alloc_external_nt_handle_info_ptr->name);
+        }
+    }
+    #endif
+
+    in_item_ptr->alloc_memory_block_ptr = Anvil::MemoryBlock::create(std::move(create_info_ptr) );
+    in_item_ptr->is_baked               = (in_item_ptr->alloc_memory_block_ptr != nullptr);
+
+    anvil_assert(in_item_ptr->is_baked);
+
+    return in_item_ptr->is_baked;
+}
+
+/** Assigns the specified item a region of one of the pages maintained for the item's pool. If none of
+ *  the pages has a large enough free region, a new page is allocated.
+ *
+ *  @param in_item_ptr      Item to assign memory to.
+ *  @param in_n_memory_type Index of the memory type to use.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::MemoryAllocatorBackends::Incremental::bake_pooled_item(Anvil::MemoryAllocator::Item* in_item_ptr,
+                                                                   uint32_t                      in_n_memory_type)
+{
+    const bool         is_item_buffer  = (in_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_BUFFER                  ||
+                                          in_item_ptr->type == Anvil::MemoryAllocator::ITEM_TYPE_SPARSE_BUFFER_REGION);
+    const bool         is_item_linear  = (is_item_buffer)                                                                                           ||
+                                         (in_item_ptr->image_ptr->get_create_info_ptr()->get_tiling() == Anvil::ImageTiling::LINEAR);
+    const auto&        memory_props    (m_device_ptr->get_physical_device_memory_properties() );
+    Page*              page_ptr        (nullptr);
+    VkDeviceSize       region_offset   (0);
+    bool               result          (false);
+
+    /* Linear and non-linear resources are assigned separate pools, so that the buffer-image granularity
+     * requirement never needs to be taken into account. */
+    auto& pages = m_pools[PoolKey(in_item_ptr->alloc_device_mask,
+                                  is_item_linear,
+                                  in_item_ptr->memory_priority,
+                                  in_n_memory_type)];
+
+    for (auto& current_page_ptr : pages)
+    {
+        if (current_page_ptr->allocator_ptr->allocate(in_item_ptr->alloc_size,
+                                                      in_item_ptr->alloc_memory_required_alignment,
+                                                     &region_offset) )
+        {
+            page_ptr = current_page_ptr.get();
+
+            break;
+        }
+    }
+
+    if (page_ptr == nullptr)
+    {
+        const VkDeviceSize    page_size        (std::max(m_page_size,
+                                                         in_item_ptr->alloc_size) );
+        std::unique_ptr<Page> new_page_ptr     (new Page() );
+        auto                  create_info_ptr  (Anvil::MemoryBlockCreateInfo::create_regular(m_device_ptr,
+                                                                                             1u << in_n_memory_type,
+                                                                                             page_size,
+                                                                                             memory_props.types.at(in_n_memory_type).features) );
+
+        create_info_ptr->set_memory_priority(in_item_ptr->memory_priority);
+        create_info_ptr->set_device_mask    (in_item_ptr->alloc_device_mask);
+        create_info_ptr->set_mt_safety      (Anvil::Utils::convert_boolean_to_mt_safety_enum(m_device_ptr->is_mt_safe()) );
+
+        new_page_ptr->memory_block_ptr = Anvil::MemoryBlock::create(std::move(create_info_ptr) );
+
+        if (new_page_ptr->memory_block_ptr == nullptr)
+        {
+            anvil_assert(new_page_ptr->memory_block_ptr != nullptr);
+
+            goto end;
+        }
+
+        new_page_ptr->allocator_ptr.reset(
+            new TLSFAllocator(page_size)
+        );
+
+        /* A region starting at offset 0 meets all alignment requirements. */
+        if (!new_page_ptr->allocator_ptr->allocate(in_item_ptr->alloc_size,
+                                                   1, /* in_alignment */
+                                                  &region_offset) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        page_ptr = new_page_ptr.get();
+
+        pages.push_back(
+            std::move(new_page_ptr)
+        );
+    }
+
+    {
+        auto create_info_ptr = Anvil::MemoryBlockCreateInfo::create_derived(page_ptr->memory_block_ptr.get(),
+                                                                            region_offset,
+                                                                            in_item_ptr->alloc_size);
+
+        create_info_ptr->set_on_release_callback_function(
+            std::bind(&Incremental::on_region_released,
+                      this,
+                      page_ptr,
+                      region_offset)
+        );
+
+        in_item_ptr->alloc_memory_block_ptr = Anvil::MemoryBlock::create(std::move(create_info_ptr) );
+    }
+
+    if (in_item_ptr->alloc_memory_block_ptr == nullptr)
+    {
+        anvil_assert(in_item_ptr->alloc_memory_block_ptr != nullptr);
+
+        page_ptr->allocator_ptr->free(region_offset);
+
+        goto end;
+    }
+
+    /* Derived memory blocks hold a reference to the backend, so that pages outlive all regions handed out. */
+    dynamic_cast<IMemoryBlockBackendSupport*>(in_item_ptr->alloc_memory_block_ptr.get() )->set_parent_memory_allocator_backend_ptr(shared_from_this(),
+                                                                                                                                  reinterpret_cast<void*>(page_ptr->memory_block_ptr->get_memory() ));
+
+    in_item_ptr->is_baked = true;
+    result                = true;
+end:
+    return result;
+}
+
+/** Determines which memory type should be used for the specified item. The first memory type which supports
+ *  all features (including peer memory features, if any) requested for the item is chosen.
+ *
+ *  @param in_item_ptr           Item to use for the query.
+ *  @param out_n_memory_type_ptr Deref will be set to the memory type index, if the function succeeds.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::MemoryAllocatorBackends::Incremental::get_memory_type_for_item(Anvil::MemoryAllocator::Item* in_item_ptr,
+                                                                           uint32_t*                     out_n_memory_type_ptr) const
+{
+    const auto& memory_props             (m_device_ptr->get_physical_device_memory_properties() );
+    const auto& required_memory_features (in_item_ptr->alloc_memory_required_features);
+    bool        result                   (false);
+
+    for (uint32_t n_memory_type = 0;
+                  n_memory_type < static_cast<uint32_t>(memory_props.types.size() );
+                ++n_memory_type)
+    {
+        bool is_memory_type_compatible = true;
+
+        if ((in_item_ptr->alloc_memory_supported_memory_types & (1u << n_memory_type)) == 0)
+        {
+            continue;
+        }
+
+        if ((memory_props.types.at(n_memory_type).features & static_cast<Anvil::MemoryFeatureFlagBits>(required_memory_features.get_vk() )) != required_memory_features)
+        {
+            continue;
+        }
+
+        if (in_item_ptr->alloc_mgpu_peer_memory_reqs.size() > 0)
+        {
+            /* Make sure current memory type supports all required peer memory requirements specified by the user */
+            auto mgpu_device_ptr = dynamic_cast<const Anvil::MGPUDevice*>(m_device_ptr);
+
+            anvil_assert(m_device_ptr->get_type() == Anvil::DeviceType::MULTI_GPU);
+            anvil_assert(mgpu_device_ptr          != nullptr);
+
+            for (const auto& current_req : in_item_ptr->alloc_mgpu_peer_memory_reqs)
+            {
+                Anvil::PeerMemoryFeatureFlags current_memory_type_peer_memory_features;
+                const auto                    local_device_ptr                         = mgpu_device_ptr->get_physical_device(current_req.first.first);
+                const auto                    remote_device_ptr                        = mgpu_device_ptr->get_physical_device(current_req.first.second);
+
+                if (!mgpu_device_ptr->get_peer_memory_features(local_device_ptr,
+                                                               remote_device_ptr,
+                                                               memory_props.types.at(n_memory_type).heap_ptr->index,
+                                                              &current_memory_type_peer_memory_features) ||
+                    (current_memory_type_peer_memory_features & current_req.second) != current_req.second)
+                {
+                    is_memory_type_compatible = false;
+
+                    break;
+                }
+            }
+        }
+
+        if (is_memory_type_compatible)
+        {
+            *out_n_memory_type_ptr = n_memory_type;
+            result                 = true;
+
+            break;
+        }
+    }
+
+    return result;
+}
+
+/** Walks memory types in the same order as get_memory_type_for_item(). mGPU peer memory requirements are not taken
+ *  into account, since they are only known for specific items.
+ **/
+bool Anvil::MemoryAllocatorBackends::Incremental::get_memory_type_index(uint32_t                         in_memory_types,
+                                                                        const Anvil::MemoryFeatureFlags& in_required_memory_features,
+                                                                        uint32_t*                        out_n_memory_type_ptr) const
+{
+    uint32_t filtered_memory_types = 0;
+    bool     result                = false;
+
+    if (!Anvil::MemoryAllocator::get_mem_types_supporting_mem_features(m_device_ptr,
+                                                                       in_memory_types,
+                                                                       in_required_memory_features,
+                                                                      &filtered_memory_types) ||
+        filtered_memory_types == 0)
+    {
+        goto end;
+    }
+
+    *out_n_memory_type_ptr = 0;
+
+    while ((filtered_memory_types & (1u << *out_n_memory_type_ptr)) == 0)
+    {
+        ++(*out_n_memory_type_ptr);
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+VkResult Anvil::MemoryAllocatorBackends::Incremental::map(void*        in_memory_object,
+                                                          VkDeviceSize in_start_offset,
+                                                          VkDeviceSize in_memory_block_start_offset,
+                                                          VkDeviceSize in_size,
+                                                          void**       out_result_ptr)
+{
+    ANVIL_REDUNDANT_VARIABLE(in_memory_block_start_offset);
+
+    return Anvil::Vulkan::vkMapMemory(m_device_ptr->get_device_vk(),
+                                      reinterpret_cast<VkDeviceMemory>(in_memory_object),
+                                      in_start_offset,
+                                      in_size,
+                                      0, /* flags */
+                                      out_result_ptr);
+}
+
+/** Called back whenever a derived memory block, created for one of the items, goes out of scope.
+ *  Returns the region it used back to the page's free-list.
+ *
+ *  @param in_page_ptr Page the region has been carved out of.
+ *  @param in_offset   Start offset of the region.
+ **/
+void Anvil::MemoryAllocatorBackends::Incremental::on_region_released(Page*        in_page_ptr,
+                                                                     VkDeviceSize in_offset)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    in_page_ptr->allocator_ptr->free(in_offset);
+}
+
+/** Releases pages which no longer hold any regions. The last page of each pool is always preserved. */
+void Anvil::MemoryAllocatorBackends::Incremental::release_empty_pages()
+{
+    for (auto& current_pool : m_pools)
+    {
+        auto& pages = current_pool.second;
+
+        for (auto page_iterator  = pages.begin();
+                  page_iterator != pages.end() && pages.size() > 1;
+                 )
+        {
+            if ((*page_iterator)->allocator_ptr->is_empty() )
+            {
+                page_iterator = pages.erase(page_iterator);
+            }
+            else
+            {
+                ++page_iterator;
+            }
+        }
+    }
+}
+
+/** Always returns true */
+bool Anvil::MemoryAllocatorBackends::Incremental::supports_baking() const
+{
+    return true;
+}
+
+bool Anvil::MemoryAllocatorBackends::Incremental::supports_device_masks() const
+{
+    return true;
+}
+
+bool Anvil::MemoryAllocatorBackends::Incremental::supports_external_memory_handles(const Anvil::ExternalMemoryHandleTypeFlags&) const
+{
+    /* Exportable allocations are always assigned separate memory blocks */
+    return true;
+}
+
+/** Always returns true. Items are assigned memory independently of each other, so any subset of pending items
+ *  can be baked at any given time.
+ **/
+bool Anvil::MemoryAllocatorBackends::Incremental::supports_partial_baking() const
+{
+    return true;
+}
+
+bool Anvil::MemoryAllocatorBackends::Incremental::supports_protected_memory() const
+{
+    return true;
+}
+
+/** Always returns true. See supports_partial_baking(). */
+bool Anvil::MemoryAllocatorBackends::Incremental::supports_subset_baking() const
+{
+    return true;
+}
+
+void Anvil::MemoryAllocatorBackends::Incremental::unmap(void* in_memory_object)
+{
+    Anvil::Vulkan::vkUnmapMemory(m_device_ptr->get_device_vk(),
+                                 reinterpret_cast<VkDeviceMemory>(in_memory_object) );
+}
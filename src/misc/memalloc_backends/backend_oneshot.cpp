@@ -419,6 +419,37 @@ end:
     return result;
 }
 
+/** Returns the first memory type, which is included in @param in_memory_types and supports @param in_required_memory_features.
+ *  Matches the memory type selection order used by bake().
+ **/
+bool Anvil::MemoryAllocatorBackends::OneShot::get_memory_type_index(uint32_t                         in_memory_types,
+                                                                    const Anvil::MemoryFeatureFlags& in_required_memory_features,
+                                                                    uint32_t*                        out_n_memory_type_ptr) const
+{
+    uint32_t filtered_memory_types = 0;
+    bool     result                = false;
+
+    if (!Anvil::MemoryAllocator::get_mem_types_supporting_mem_features(m_device_ptr,
+                                                                       in_memory_types,
+                                                                       in_required_memory_features,
+                                                                      &filtered_memory_types) ||
+        filtered_memory_types == 0)
+    {
+        goto end;
+    }
+
+    *out_n_memory_type_ptr = 0;
+
+    while ((filtered_memory_types & (1u << *out_n_memory_type_ptr)) == 0)
+    {
+        ++(*out_n_memory_type_ptr);
+    }
+
+    result = true;
+end:
+    return result;
+}
+
 VkResult Anvil::MemoryAllocatorBackends::OneShot::map(void*        in_memory_object,
                                                       VkDeviceSize in_start_offset,
                                                       VkDeviceSize in_memory_block_start_offset,
@@ -456,11 +487,23 @@ bool Anvil::MemoryAllocatorBackends::OneShot::supports_external_memory_handles(c
     return true;
 }
 
+/** Always returns false. All pending items need to be baked in one go. */
+bool Anvil::MemoryAllocatorBackends::OneShot::supports_partial_baking() const
+{
+    return false;
+}
+
 bool Anvil::MemoryAllocatorBackends::OneShot::supports_protected_memory() const
 {
     return true;
 }
 
+/** Always returns false. All pending items need to be baked in one go. */
+bool Anvil::MemoryAllocatorBackends::OneShot::supports_subset_baking() const
+{
+    return false;
+}
+
 void Anvil::MemoryAllocatorBackends::OneShot::unmap(void* in_memory_object)
 {
     Anvil::Vulkan::vkUnmapMemory(m_device_ptr->get_device_vk(),
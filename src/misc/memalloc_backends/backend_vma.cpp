@@ -348,6 +348,30 @@ std::unique_ptr<Anvil::MemoryAllocatorBackends::VMA> Anvil::MemoryAllocatorBacke
     return result_ptr;
 }
 
+/** Asks VMA which memory type it would pick for an allocation created the same way bake() creates them. */
+bool Anvil::MemoryAllocatorBackends::VMA::get_memory_type_index(uint32_t                         in_memory_types,
+                                                                const Anvil::MemoryFeatureFlags& in_required_memory_features,
+                                                                uint32_t*                        out_n_memory_type_ptr) const
+{
+    VmaAllocationCreateInfo    allocation_create_info = {};
+    Anvil::MemoryHeapFlags     required_mem_heap_flags;
+    Anvil::MemoryPropertyFlags required_mem_property_flags;
+    VkResult                   result_vk;
+
+    Anvil::Utils::get_vk_property_flags_from_memory_feature_flags(in_required_memory_features,
+                                                                 &required_mem_property_flags,
+                                                                 &required_mem_heap_flags);
+
+    allocation_create_info.requiredFlags = required_mem_property_flags.get_vk();
+
+    result_vk = vmaFindMemoryTypeIndex(m_vma_allocator_ptr->get_handle(),
+                                       in_memory_types,
+                                      &allocation_create_info,
+                                       out_n_memory_type_ptr);
+
+    return is_vk_call_successful(result_vk);
+}
+
 /** Creates and stores a new VMAAllocator instance.
  *
  *  @return true if successful, false otherwise.
@@ -438,12 +462,26 @@ bool Anvil::MemoryAllocatorBackends::VMA::supports_external_memory_handles(const
     return false;
 }
 
+/** Always returns false. Implicit bakes assign memory to all pending items, so that VMA gets to see all requests
+ *  at once.
+ **/
+bool Anvil::MemoryAllocatorBackends::VMA::supports_partial_baking() const
+{
+    return false;
+}
+
 bool Anvil::MemoryAllocatorBackends::VMA::supports_protected_memory() const
 {
     /* Vulkan Memory Allocator does NOT support VK 1.1 features */
     return false;
 }
 
+/** Always returns true. Each item is allocated with a separate vmaAllocateMemory() call. */
+bool Anvil::MemoryAllocatorBackends::VMA::supports_subset_baking() const
+{
+    return true;
+}
+
 void Anvil::MemoryAllocatorBackends::VMA::unmap(void* in_memory_object)
 {
     vmaUnmapMemory(m_vma_allocator_ptr->get_handle(),
@@ -21,20 +21,26 @@
 //
 
 #include "misc/buffer_create_info.h"
+#include "misc/device_create_info.h"
 #include "misc/fence_create_info.h"
 #include "misc/formats.h"
 #include "misc/image_create_info.h"
 #include "misc/instance_create_info.h"
 #include "misc/memory_allocator.h"
+#include "misc/memalloc_backends/backend_incremental.h"
 #include "misc/memalloc_backends/backend_oneshot.h"
 #include "misc/memalloc_backends/backend_vma.h"
 #include "wrappers/buffer.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
 #include "wrappers/device.h"
 #include "wrappers/fence.h"
 #include "wrappers/image.h"
 #include "wrappers/instance.h"
 #include "wrappers/memory_block.h"
+#include "wrappers/physical_device.h"
 #include "wrappers/queue.h"
+#include <algorithm>
 #include <set>
 
 /* Please see header for specification */
@@ -316,7 +322,8 @@ Anvil::MemoryAllocator::Item::~Item()
 void Anvil::MemoryAllocator::Item::register_for_callbacks()
 {
     auto on_implicit_bake_needed_callback_func              = std::bind(&Anvil::MemoryAllocator::on_implicit_bake_needed,
-                                                                        memory_allocator_ptr);
+                                                                        memory_allocator_ptr,
+                                                                        std::placeholders::_1);
     auto on_is_alloc_pending_for_buffer_query_callback_func = std::bind(&Anvil::MemoryAllocator::on_is_alloc_pending_for_buffer_query,
                                                                         memory_allocator_ptr,
                                                                         std::placeholders::_1);
@@ -400,7 +407,8 @@ void Anvil::MemoryAllocator::Item::register_for_callbacks()
 void Anvil::MemoryAllocator::Item::unregister_from_callbacks()
 {
     auto on_implicit_bake_needed_callback_func              = std::bind(&Anvil::MemoryAllocator::on_implicit_bake_needed,
-                                                                        memory_allocator_ptr);
+                                                                        memory_allocator_ptr,
+                                                                        std::placeholders::_1);
     auto on_is_alloc_pending_for_buffer_query_callback_func = std::bind(&Anvil::MemoryAllocator::on_is_alloc_pending_for_buffer_query,
                                                                         memory_allocator_ptr,
                                                                         std::placeholders::_1);
@@ -448,9 +456,10 @@ void Anvil::MemoryAllocator::Item::unregister_from_callbacks()
 Anvil::MemoryAllocator::MemoryAllocator(const Anvil::BaseDevice*                 in_device_ptr,
                                         std::shared_ptr<IMemoryAllocatorBackend> in_backend_ptr,
                                         bool                                     in_mt_safe)
-    :MTSafetySupportProvider(in_mt_safe),
-     m_backend_ptr          (std::move(in_backend_ptr) ),
-     m_device_ptr           (in_device_ptr)
+    :MTSafetySupportProvider     (in_mt_safe),
+     m_backend_ptr               (std::move(in_backend_ptr) ),
+     m_device_ptr                (in_device_ptr),
+     m_is_budget_tracking_enabled(false)
 {
     /* Stub */
 }
@@ -461,7 +470,8 @@ Anvil::MemoryAllocator::~MemoryAllocator()
     if (m_items.size()                   > 0 &&
         m_backend_ptr->supports_baking() )
     {
-        bake();
+        bake_internal(false,    /* in_allow_evictions */
+                      nullptr); /* in_opt_object_ptr  */
     }
 }
 
@@ -731,6 +741,102 @@ bool Anvil::MemoryAllocator::add_buffer_with_float_data_vector_ptr_based_post_fi
     return result;
 }
 
+/* Please see header for specification */
+bool Anvil::MemoryAllocator::add_buffer_with_producer_based_post_fill(Anvil::Buffer*                              in_buffer_ptr,
+                                                                      MemoryWriteProducerFunction                 in_producer_function,
+                                                                      MemoryFeatureFlags                          in_required_memory_features,
+                                                                      const Anvil::ExternalMemoryHandleTypeFlags& in_opt_exportable_external_handle_types,
+#if defined(_WIN32)
+                                                                      const Anvil::ExternalNTHandleInfo*          in_opt_external_nt_handle_info_ptr,
+#endif
+                                                                      const uint32_t*                             in_opt_device_mask_ptr,
+                                                                      const MGPUPeerMemoryRequirements*           in_opt_mgpu_peer_memory_reqs_ptr,
+                                                                      const MGPUBindSparseDeviceIndices*          in_opt_mgpu_bind_sparse_device_indices_ptr,
+                                                                      const float&                                in_opt_memory_priority)
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr  = get_mutex();
+    bool                                   result;
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    anvil_assert(in_producer_function != nullptr);
+
+    result = add_buffer_internal(in_buffer_ptr,
+                                 in_required_memory_features,
+                                 in_opt_exportable_external_handle_types,
+#if defined(_WIN32)
+                                 in_opt_external_nt_handle_info_ptr,
+#endif
+                                 in_opt_device_mask_ptr,
+                                 in_opt_mgpu_peer_memory_reqs_ptr,
+                                 in_opt_mgpu_bind_sparse_device_indices_ptr,
+                                 in_opt_memory_priority);
+
+    if (result)
+    {
+        m_items.back()->buffer_ref_producer_function = std::move(in_producer_function);
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::MemoryAllocator::add_buffer_with_unowned_data_ptr_based_post_fill(Anvil::Buffer*                              in_buffer_ptr,
+                                                                              const void*                                 in_unowned_data_ptr,
+                                                                              MemoryFeatureFlags                          in_required_memory_features,
+                                                                              const Anvil::ExternalMemoryHandleTypeFlags& in_opt_exportable_external_handle_types,
+#if defined(_WIN32)
+                                                                              const Anvil::ExternalNTHandleInfo*          in_opt_external_nt_handle_info_ptr,
+#endif
+                                                                              const uint32_t*                             in_opt_device_mask_ptr,
+                                                                              const MGPUPeerMemoryRequirements*           in_opt_mgpu_peer_memory_reqs_ptr,
+                                                                              const MGPUBindSparseDeviceIndices*          in_opt_mgpu_bind_sparse_device_indices_ptr,
+                                                                              const float&                                in_opt_memory_priority)
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr  = get_mutex();
+    bool                                   result;
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    anvil_assert(in_unowned_data_ptr != nullptr);
+
+    result = add_buffer_internal(in_buffer_ptr,
+                                 in_required_memory_features,
+                                 in_opt_exportable_external_handle_types,
+#if defined(_WIN32)
+                                 in_opt_external_nt_handle_info_ptr,
+#endif
+                                 in_opt_device_mask_ptr,
+                                 in_opt_mgpu_peer_memory_reqs_ptr,
+                                 in_opt_mgpu_bind_sparse_device_indices_ptr,
+                                 in_opt_memory_priority);
+
+    if (result)
+    {
+        /* The data is copied straight from the user-specified location to mapped memory at bake time. */
+        m_items.back()->buffer_ref_producer_function = [in_unowned_data_ptr](void* out_data_ptr, VkDeviceSize in_size)
+        {
+            memcpy(out_data_ptr,
+                   in_unowned_data_ptr,
+                   static_cast<size_t>(in_size) );
+        };
+    }
+
+    return result;
+}
+
 /* Please see header for specification */
 bool Anvil::MemoryAllocator::add_buffer_with_uchar8_data_ptr_based_post_fill(Anvil::Buffer*                              in_buffer_ptr,
                                                                              std::unique_ptr<uint8_t[]>                  in_data_ptr,
@@ -1485,11 +1591,219 @@ end:
     return result;
 }
 
+/** Walks over all pending items and checks if allocating memory for them is going to exceed per-heap budget
+ *  reported by the implementation. If so, items are demoted and/or evicted as per the budget policy.
+ *
+ *  @param in_allow_evictions    True if items are allowed to be evicted, false if only demotions should be performed.
+ *  @param out_evicted_items_ptr Evicted items will be moved to this vector. Must not be nullptr.
+ **/
+void Anvil::MemoryAllocator::apply_budget_policy(bool   in_allow_evictions,
+                                                 Items* out_evicted_items_ptr)
+{
+    Anvil::MemoryBudget                           budget;
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> heap_demand;
+    const auto&                                   memory_props        (m_device_ptr->get_physical_device_memory_properties() );
+    const auto                                    physical_device_ptr (m_device_ptr->get_create_info_ptr()->get_physical_device_ptrs().at(0) );
+
+    const auto get_effective_priority = [](const Item* in_item_ptr)
+    {
+        /* FLT_MAX is used to indicate the app has not specified memory priority for the item. */
+        return (in_item_ptr->memory_priority == FLT_MAX) ? 0.5f
+                                                         : in_item_ptr->memory_priority;
+    };
+    const auto get_heap_limit = [&](uint32_t in_n_heap)
+    {
+        return static_cast<VkDeviceSize>(static_cast<double>(budget.heap_budget.at(in_n_heap) ) * m_budget_policy.usage_limit);
+    };
+    const auto get_projected_heap_usage = [&](uint32_t in_n_heap)
+    {
+        return budget.heap_usage.at(in_n_heap) + heap_demand.at(in_n_heap);
+    };
+
+    anvil_assert(out_evicted_items_ptr != nullptr);
+
+    /* Determine how much memory is going to be taken from each heap, if all pending items are baked. */
+    heap_demand.fill(0);
+
+    for (const auto& item_ptr : m_items)
+    {
+        const uint32_t n_heap = get_heap_index_for_memory_types(item_ptr->alloc_memory_supported_memory_types,
+                                                                item_ptr->alloc_memory_required_features);
+
+        if (n_heap < memory_props.n_heaps)
+        {
+            heap_demand.at(n_heap) += item_ptr->alloc_size;
+        }
+    }
+
+    budget = physical_device_ptr->get_available_memory_budget();
+
+    for (uint32_t n_heap = 0;
+                  n_heap < memory_props.n_heaps;
+                ++n_heap)
+    {
+        std::vector<Item*> candidate_items;
+        uint32_t           heap_memory_types = 0;
+
+        if (get_projected_heap_usage(n_heap) <= get_heap_limit(n_heap) )
+        {
+            continue;
+        }
+
+        /* Give the app a chance to release memory first */
+        if (m_budget_exceeded_callback_function != nullptr)
+        {
+            m_budget_exceeded_callback_function(this,
+                                                n_heap,
+                                                get_heap_limit          (n_heap),
+                                                get_projected_heap_usage(n_heap) );
+
+            budget = physical_device_ptr->get_available_memory_budget();
+
+            if (get_projected_heap_usage(n_heap) <= get_heap_limit(n_heap) )
+            {
+                continue;
+            }
+        }
+
+        /* Identify items which can be demoted or evicted, starting from the ones with the lowest priority. */
+        for (const auto& item_ptr : m_items)
+        {
+            const float priority = get_effective_priority(item_ptr.get() );
+
+            if (get_heap_index_for_memory_types(item_ptr->alloc_memory_supported_memory_types,
+                                                item_ptr->alloc_memory_required_features) != n_heap)
+            {
+                continue;
+            }
+
+            if ( priority <= m_budget_policy.max_demotable_priority                         ||
+                (priority <= m_budget_policy.max_evictable_priority && in_allow_evictions) )
+            {
+                candidate_items.push_back(item_ptr.get() );
+            }
+        }
+
+        std::stable_sort(candidate_items.begin(),
+                         candidate_items.end  (),
+                         [&](const Item* in_item1_ptr,
+                             const Item* in_item2_ptr)
+                         {
+                             return get_effective_priority(in_item1_ptr) < get_effective_priority(in_item2_ptr);
+                         });
+
+        for (uint32_t n_memory_type = 0;
+                      n_memory_type < static_cast<uint32_t>(memory_props.types.size() );
+                    ++n_memory_type)
+        {
+            if (memory_props.types.at(n_memory_type).heap_ptr->index == n_heap)
+            {
+                heap_memory_types |= (1u << n_memory_type);
+            }
+        }
+
+        for (auto& candidate_item_ptr : candidate_items)
+        {
+            bool        is_demoted = false;
+            const float priority   = get_effective_priority(candidate_item_ptr);
+
+            if (get_projected_heap_usage(n_heap) <= get_heap_limit(n_heap) )
+            {
+                break;
+            }
+
+            if (priority <= m_budget_policy.max_demotable_priority)
+            {
+                MemoryFeatureFlags demoted_memory_features = candidate_item_ptr->alloc_memory_required_features;
+                uint32_t           demoted_memory_types    = 0;
+
+                demoted_memory_features &= ~Anvil::MemoryFeatureFlagBits::DEVICE_LOCAL_BIT;
+                demoted_memory_features |=  Anvil::MemoryFeatureFlagBits::MAPPABLE_BIT;
+
+                if ((candidate_item_ptr->alloc_memory_types & ~heap_memory_types) != 0                      &&
+                    get_mem_types_supporting_mem_features(m_device_ptr,
+                                                          candidate_item_ptr->alloc_memory_types & ~heap_memory_types,
+                                                          demoted_memory_features,
+                                                         &demoted_memory_types) )
+                {
+                    const uint32_t n_target_heap = get_heap_index_for_memory_types(demoted_memory_types,
+                                                                                   demoted_memory_features);
+
+                    if (n_target_heap                                                        != n_heap                 &&
+                        n_target_heap                                                        <  memory_props.n_heaps   &&
+                        get_projected_heap_usage(n_target_heap) + candidate_item_ptr->alloc_size <= get_heap_limit(n_target_heap) )
+                    {
+                        candidate_item_ptr->alloc_memory_required_features      = demoted_memory_features;
+                        candidate_item_ptr->alloc_memory_supported_memory_types = demoted_memory_types;
+
+                        heap_demand.at(n_heap)        -= candidate_item_ptr->alloc_size;
+                        heap_demand.at(n_target_heap) += candidate_item_ptr->alloc_size;
+                        is_demoted                     = true;
+
+                        if (m_budget_action_callback_function != nullptr)
+                        {
+                            m_budget_action_callback_function(this,
+                                                              candidate_item_ptr,
+                                                              BUDGET_ACTION_DEMOTE);
+                        }
+                    }
+                }
+            }
+
+            if (!is_demoted                                        &&
+                 in_allow_evictions                                &&
+                 priority <= m_budget_policy.max_evictable_priority)
+            {
+                auto item_iterator = std::find_if(m_items.begin(),
+                                                  m_items.end  (),
+                                                  [&](const std::unique_ptr<Item>& in_item_ptr)
+                                                  {
+                                                      return in_item_ptr.get() == candidate_item_ptr;
+                                                  });
+
+                anvil_assert(item_iterator != m_items.end() );
+
+                heap_demand.at(n_heap) -= candidate_item_ptr->alloc_size;
+
+                out_evicted_items_ptr->push_back(std::move(*item_iterator) );
+                m_items.erase                   (item_iterator);
+
+                if (m_budget_action_callback_function != nullptr)
+                {
+                    m_budget_action_callback_function(this,
+                                                      candidate_item_ptr,
+                                                      BUDGET_ACTION_EVICT);
+                }
+            }
+        }
+    }
+}
+
 /* Please see header for specification */
 bool Anvil::MemoryAllocator::bake()
+{
+    return bake_internal(true,     /* in_allow_evictions */
+                         nullptr); /* in_opt_object_ptr  */
+}
+
+/** Bakes pending items.
+ *
+ *  @param in_allow_evictions True if the budget policy is allowed to evict pending items. Should be false
+ *                            for implicit bakes, since those are triggered by objects which need memory
+ *                            to be assigned right away.
+ *  @param in_opt_object_ptr  If not nullptr, only items associated with the specified buffer or image are
+ *                            baked. Remaining items stay pending. The backend must support subset baking.
+ *                            Otherwise, all pending items are baked.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::MemoryAllocator::bake_internal(bool        in_allow_evictions,
+                                           const void* in_opt_object_ptr)
 {
     Anvil::SparseMemoryBindInfoID                                          default_sparse_bind_info_id               = UINT32_MAX;
     std::map<ResourceMemoryDeviceIndexPair, Anvil::SparseMemoryBindInfoID> device_index_pair_to_sparse_bind_info_map;
+    Items                                                                  deferred_items;
+    Items                                                                  evicted_items;
     std::vector<Anvil::FenceUniquePtr>                                     fences;
     std::unique_lock<std::recursive_mutex>                                 mutex_lock;
     auto                                                                   mutex_ptr                                 = get_mutex();
@@ -1512,6 +1826,29 @@ bool Anvil::MemoryAllocator::bake()
         goto end;
     }
 
+    if (in_opt_object_ptr != nullptr)
+    {
+        Items pending_items;
+
+        anvil_assert(m_backend_ptr->supports_subset_baking() );
+
+        std::swap(pending_items,
+                  m_items);
+
+        for (auto& pending_item_ptr : pending_items)
+        {
+            if (pending_item_ptr->buffer_ptr == in_opt_object_ptr ||
+                pending_item_ptr->image_ptr  == in_opt_object_ptr)
+            {
+                m_items.push_back(std::move(pending_item_ptr) );
+            }
+            else
+            {
+                deferred_items.push_back(std::move(pending_item_ptr) );
+            }
+        }
+    }
+
     if (m_items.size() == 0)
     {
         result = true;
@@ -1519,6 +1856,19 @@ bool Anvil::MemoryAllocator::bake()
         goto end;
     }
 
+    if (m_is_budget_tracking_enabled)
+    {
+        apply_budget_policy(in_allow_evictions,
+                           &evicted_items);
+
+        if (m_items.size() == 0)
+        {
+            result = true;
+
+            goto end;
+        }
+    }
+
     result = m_backend_ptr->bake(m_items);
     if (!result)
     {
@@ -2030,6 +2380,13 @@ bool Anvil::MemoryAllocator::bake()
                                                   &(*current_item_ptr->buffer_ref_float_vector_data_ptr)[0]);
             }
             else
+            if (current_item_ptr->buffer_ref_producer_function != nullptr)
+            {
+                current_item_ptr->buffer_ptr->write_with_producer(0, /* start_offset */
+                                                                  buffer_size,
+                                                                  current_item_ptr->buffer_ref_producer_function);
+            }
+            else
             if (current_item_ptr->buffer_ref_uchar8_data_ptr != nullptr)
             {
                 current_item_ptr->buffer_ptr->write(0, /* start_offset */
@@ -2068,6 +2425,17 @@ bool Anvil::MemoryAllocator::bake()
     }
 
 end:
+    /* Deferred and evicted items stay pending until next bake() call */
+    for (auto& deferred_item_ptr : deferred_items)
+    {
+        m_items.push_back(std::move(deferred_item_ptr) );
+    }
+
+    for (auto& evicted_item_ptr : evicted_items)
+    {
+        m_items.push_back(std::move(evicted_item_ptr) );
+    }
+
     if (mutex_lock.owns_lock() )
     {
         mutex_lock.unlock();
@@ -2076,6 +2444,139 @@ end:
     return result;
 }
 
+/** Creates a new object with the same properties as the object described by @param in_move_ptr and assigns
+ *  it memory coming from this allocator.
+ *
+ *  @param in_move_ptr Move descriptor. new_buffer_ptr or new_image_ptr is updated on success.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::MemoryAllocator::create_defragmentation_object(DefragmentationMove* in_move_ptr)
+{
+    const void* new_object_ptr = nullptr;
+    bool        result         = false;
+
+    if (in_move_ptr->old_buffer_ptr != nullptr)
+    {
+        const Anvil::BufferCreateInfo* old_create_info_ptr = in_move_ptr->old_buffer_ptr->get_create_info_ptr();
+        auto                           create_info_ptr     = Anvil::BufferCreateInfo::create_no_alloc(m_device_ptr,
+                                                                                                      old_create_info_ptr->get_size          (),
+                                                                                                      old_create_info_ptr->get_queue_families(),
+                                                                                                      old_create_info_ptr->get_sharing_mode  (),
+                                                                                                      old_create_info_ptr->get_create_flags  (),
+                                                                                                      old_create_info_ptr->get_usage_flags   () );
+
+        create_info_ptr->set_mt_safety(old_create_info_ptr->get_mt_safety() );
+
+        in_move_ptr->new_buffer_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
+
+        if (in_move_ptr->new_buffer_ptr == nullptr)
+        {
+            anvil_assert(in_move_ptr->new_buffer_ptr != nullptr);
+
+            goto end;
+        }
+
+        if (!add_buffer(in_move_ptr->new_buffer_ptr.get(),
+                        in_move_ptr->memory_features) )
+        {
+            goto end;
+        }
+
+        new_object_ptr = in_move_ptr->new_buffer_ptr.get();
+    }
+    else
+    {
+        const Anvil::ImageCreateInfo* old_create_info_ptr = in_move_ptr->old_image_ptr->get_create_info_ptr();
+        uint32_t                      n_view_formats      = 0;
+        const Anvil::Format*          view_formats_ptr    = nullptr;
+        auto                          create_info_ptr     = Anvil::ImageCreateInfo::create_no_alloc(m_device_ptr,
+                                                                                                    old_create_info_ptr->get_type              (),
+                                                                                                    old_create_info_ptr->get_format            (),
+                                                                                                    old_create_info_ptr->get_tiling            (),
+                                                                                                    old_create_info_ptr->get_usage_flags       (),
+                                                                                                    old_create_info_ptr->get_base_mip_width    (),
+                                                                                                    old_create_info_ptr->get_base_mip_height   (),
+                                                                                                    old_create_info_ptr->get_base_mip_depth    (),
+                                                                                                    old_create_info_ptr->get_n_layers          (),
+                                                                                                    old_create_info_ptr->get_sample_count      (),
+                                                                                                    old_create_info_ptr->get_queue_families    (),
+                                                                                                    old_create_info_ptr->get_sharing_mode      (),
+                                                                                                    old_create_info_ptr->uses_full_mipmap_chain(),
+                                                                                                    old_create_info_ptr->get_create_flags      () );
+
+        old_create_info_ptr->get_image_view_formats(&n_view_formats,
+                                                    &view_formats_ptr);
+
+        if (n_view_formats > 0)
+        {
+            create_info_ptr->set_image_view_formats(n_view_formats,
+                                                    view_formats_ptr);
+        }
+
+        create_info_ptr->set_mt_safety                (old_create_info_ptr->get_mt_safety                () );
+        create_info_ptr->set_stencil_image_aspect_usage(old_create_info_ptr->get_stencil_image_aspect_usage() );
+
+        in_move_ptr->new_image_ptr = Anvil::Image::create(std::move(create_info_ptr) );
+
+        if (in_move_ptr->new_image_ptr == nullptr)
+        {
+            anvil_assert(in_move_ptr->new_image_ptr != nullptr);
+
+            goto end;
+        }
+
+        if (!add_image_whole(in_move_ptr->new_image_ptr.get(),
+                             in_move_ptr->memory_features) )
+        {
+            goto end;
+        }
+
+        new_object_ptr = in_move_ptr->new_image_ptr.get();
+    }
+
+    /* Only assign memory to the new object. Other pending items are left intact. */
+    result = bake_internal(false, /* in_allow_evictions */
+                           new_object_ptr);
+
+end:
+    if (!result)
+    {
+        in_move_ptr->new_buffer_ptr.reset();
+        in_move_ptr->new_image_ptr.reset ();
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::MemoryAllocatorUniquePtr Anvil::MemoryAllocator::create_incremental(const Anvil::BaseDevice* in_device_ptr,
+                                                                           VkDeviceSize             in_page_size,
+                                                                           MTSafety                 in_mt_safety)
+{
+    std::shared_ptr<IMemoryAllocatorBackend> backend_ptr;
+    const bool                               mt_safe    (Anvil::Utils::convert_mt_safety_enum_to_boolean(in_mt_safety,
+                                                                                                         in_device_ptr) );
+    std::unique_ptr<MemoryAllocator>         result_ptr (nullptr,
+                                                         std::default_delete<MemoryAllocator>() );
+
+    backend_ptr.reset(
+        new Anvil::MemoryAllocatorBackends::Incremental(in_device_ptr,
+                                                        in_page_size)
+    );
+
+    if (backend_ptr != nullptr)
+    {
+        result_ptr.reset(
+            new Anvil::MemoryAllocator(in_device_ptr,
+                                       backend_ptr,
+                                       mt_safe)
+        );
+    }
+
+    return std::move(result_ptr);
+}
+
 /* Please see header for specification */
 Anvil::MemoryAllocatorUniquePtr Anvil::MemoryAllocator::create_oneshot(const Anvil::BaseDevice* in_device_ptr,
                                                                        MTSafety                 in_mt_safety)
@@ -2126,6 +2627,347 @@ Anvil::MemoryAllocatorUniquePtr Anvil::MemoryAllocator::create_vma(const Anvil::
     return std::move(result_ptr);
 }
 
+/* Please see header for specification */
+bool Anvil::MemoryAllocator::defragment(Anvil::Queue*                              in_queue_ptr,
+                                        const std::vector<Anvil::Buffer*>&         in_buffers,
+                                        const std::vector<DefragmentationImage>&   in_images,
+                                        DefragmentationBufferMovedCallbackFunction in_buffer_moved_callback_function,
+                                        DefragmentationImageMovedCallbackFunction  in_image_moved_callback_function,
+                                        const DefragmentationInfo&                 in_info,
+                                        DefragmentationStats*                      out_opt_stats_ptr)
+{
+    std::vector<std::pair<VkDeviceSize, VkDeviceMemory> > memory_usage;
+    std::map<VkDeviceMemory, DefragmentationMoves>        moves_per_memory;
+    std::unique_lock<std::recursive_mutex>                mutex_lock;
+    auto                                                  mutex_ptr      = get_mutex();
+    bool                                                  result         = false;
+    DefragmentationStats                                  stats;
+    std::map<VkDeviceMemory, VkDeviceSize>                usage_per_memory;
+    Anvil::FenceUniquePtr                                 wait_fence_ptr;
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    if (in_queue_ptr                      == nullptr ||
+        in_buffer_moved_callback_function == nullptr ||
+        in_image_moved_callback_function  == nullptr)
+    {
+        anvil_assert(in_queue_ptr                      != nullptr);
+        anvil_assert(in_buffer_moved_callback_function != nullptr);
+        anvil_assert(in_image_moved_callback_function  != nullptr);
+
+        goto end;
+    }
+
+    if (!m_backend_ptr->supports_subset_baking() )
+    {
+        anvil_assert(m_backend_ptr->supports_subset_baking() );
+
+        goto end;
+    }
+
+    if (m_post_bake_per_buffer_item_mem_assignment_callback_function != nullptr ||
+        m_post_bake_per_image_item_mem_assignment_callback_function  != nullptr)
+    {
+        anvil_assert(m_post_bake_per_buffer_item_mem_assignment_callback_function == nullptr);
+        anvil_assert(m_post_bake_per_image_item_mem_assignment_callback_function  == nullptr);
+
+        goto end;
+    }
+
+    if (m_device_ptr->get_type() != Anvil::DeviceType::SINGLE_GPU)
+    {
+        anvil_assert(m_device_ptr->get_type() == Anvil::DeviceType::SINGLE_GPU);
+
+        goto end;
+    }
+
+    /* Group relocatable objects by the memory allocation they have been assigned a region of. */
+    for (auto buffer_ptr : in_buffers)
+    {
+        const Anvil::BufferCreateInfo*       create_info_ptr  = nullptr;
+        bool                                 is_dedicated     = false;
+        Anvil::MemoryBlock*                  memory_block_ptr = nullptr;
+        std::unique_ptr<DefragmentationMove> move_ptr;
+
+        if (buffer_ptr == nullptr)
+        {
+            continue;
+        }
+
+        create_info_ptr = buffer_ptr->get_create_info_ptr();
+
+        if ( create_info_ptr->get_type                                  () != Anvil::BufferType::NO_ALLOC                          ||
+            (create_info_ptr->get_create_flags                          () &  Anvil::BufferCreateFlagBits::SPARSE_BINDING_BIT) != 0 ||
+            (create_info_ptr->get_usage_flags                           () &  Anvil::BufferUsageFlagBits::TRANSFER_SRC_BIT)    == 0 ||
+            (create_info_ptr->get_usage_flags                           () &  Anvil::BufferUsageFlagBits::TRANSFER_DST_BIT)    == 0 ||
+             create_info_ptr->get_exportable_external_memory_handle_types() != Anvil::ExternalMemoryHandleTypeFlagBits::NONE       ||
+             m_per_object_pending_alloc_status.find(buffer_ptr)            != m_per_object_pending_alloc_status.end() )
+        {
+            continue;
+        }
+
+        memory_block_ptr = buffer_ptr->get_memory_block(0 /* in_n_memory_block */);
+
+        if (memory_block_ptr == nullptr)
+        {
+            continue;
+        }
+
+        memory_block_ptr->get_create_info_ptr()->get_dedicated_allocation_properties(&is_dedicated,
+                                                                                     nullptr,  /* out_opt_buffer_ptr_ptr */
+                                                                                     nullptr); /* out_opt_image_ptr_ptr  */
+
+        if (is_dedicated)
+        {
+            continue;
+        }
+
+        move_ptr.reset(new DefragmentationMove() );
+
+        move_ptr->memory_features = memory_block_ptr->get_create_info_ptr()->get_memory_features();
+        move_ptr->old_buffer_ptr  = buffer_ptr;
+        move_ptr->size            = memory_block_ptr->get_create_info_ptr()->get_size();
+
+        usage_per_memory[memory_block_ptr->get_memory()] += move_ptr->size;
+
+        moves_per_memory[memory_block_ptr->get_memory()].push_back(std::move(move_ptr) );
+    }
+
+    for (const auto& current_image : in_images)
+    {
+        const Anvil::ImageCreateInfo*        create_info_ptr  = nullptr;
+        bool                                 is_dedicated     = false;
+        Anvil::MemoryBlock*                  memory_block_ptr = nullptr;
+        std::unique_ptr<DefragmentationMove> move_ptr;
+
+        if (current_image.image_ptr    == nullptr                           ||
+            current_image.image_layout == Anvil::ImageLayout::UNDEFINED     ||
+            current_image.image_layout == Anvil::ImageLayout::PREINITIALIZED)
+        {
+            continue;
+        }
+
+        create_info_ptr = current_image.image_ptr->get_create_info_ptr();
+
+        if ( create_info_ptr->get_internal_type               () != Anvil::ImageInternalType::NO_ALLOC                 ||
+             create_info_ptr->is_sparse                       ()                                                       ||
+            (create_info_ptr->get_usage_flags                 () &  Anvil::ImageUsageFlagBits::TRANSFER_SRC_BIT) == 0 ||
+            (create_info_ptr->get_usage_flags                 () &  Anvil::ImageUsageFlagBits::TRANSFER_DST_BIT) == 0 ||
+             create_info_ptr->get_external_memory_handle_types() != Anvil::ExternalMemoryHandleTypeFlagBits::NONE     ||
+             Anvil::Formats::is_format_multiplanar(create_info_ptr->get_format() )                                     ||
+             m_per_object_pending_alloc_status.find(current_image.image_ptr) != m_per_object_pending_alloc_status.end() )
+        {
+            continue;
+        }
+
+        memory_block_ptr = current_image.image_ptr->get_memory_block();
+
+        if (memory_block_ptr == nullptr)
+        {
+            continue;
+        }
+
+        memory_block_ptr->get_create_info_ptr()->get_dedicated_allocation_properties(&is_dedicated,
+                                                                                     nullptr,  /* out_opt_buffer_ptr_ptr */
+                                                                                     nullptr); /* out_opt_image_ptr_ptr  */
+
+        if (is_dedicated)
+        {
+            continue;
+        }
+
+        move_ptr.reset(new DefragmentationMove() );
+
+        move_ptr->memory_features  = memory_block_ptr->get_create_info_ptr()->get_memory_features();
+        move_ptr->old_image_layout = current_image.image_layout;
+        move_ptr->old_image_ptr    = current_image.image_ptr;
+        move_ptr->size             = memory_block_ptr->get_create_info_ptr()->get_size();
+
+        usage_per_memory[memory_block_ptr->get_memory()] += move_ptr->size;
+
+        moves_per_memory[memory_block_ptr->get_memory()].push_back(std::move(move_ptr) );
+    }
+
+    /* Evacuate the least used allocations first. */
+    for (const auto& current_usage : usage_per_memory)
+    {
+        memory_usage.push_back(
+            std::make_pair(current_usage.second,
+                           current_usage.first)
+        );
+    }
+
+    std::sort(memory_usage.begin(),
+              memory_usage.end  () );
+
+    for (const auto& current_memory : memory_usage)
+    {
+        auto&                candidate_moves     = moves_per_memory.at(current_memory.second);
+        bool                 is_limit_reached    = false;
+        VkDeviceSize         n_bytes_scheduled   = 0;
+        DefragmentationMoves scheduled_moves;
+
+        for (auto& current_move_ptr : candidate_moves)
+        {
+            VkDeviceMemory new_memory = VK_NULL_HANDLE;
+
+            if (stats.n_allocations_moved + scheduled_moves.size()              >= in_info.max_allocations_to_move ||
+                stats.bytes_moved + n_bytes_scheduled + current_move_ptr->size >  in_info.max_bytes_to_move)
+            {
+                is_limit_reached = true;
+
+                break;
+            }
+
+            if (!create_defragmentation_object(current_move_ptr.get() ) )
+            {
+                continue;
+            }
+
+            new_memory = (current_move_ptr->new_buffer_ptr != nullptr) ? current_move_ptr->new_buffer_ptr->get_memory_block(0)->get_memory()
+                                                                       : current_move_ptr->new_image_ptr->get_memory_block ()->get_memory();
+
+            if (new_memory == current_memory.second)
+            {
+                /* The new object has been assigned a region of the very allocation we're trying to evacuate. Relocating
+                 * remaining objects would not let the allocation go. */
+                current_move_ptr->new_buffer_ptr.reset();
+                current_move_ptr->new_image_ptr.reset ();
+
+                break;
+            }
+
+            n_bytes_scheduled += current_move_ptr->size;
+
+            scheduled_moves.push_back(std::move(current_move_ptr) );
+        }
+
+        if (scheduled_moves.size() > 0)
+        {
+            Anvil::PrimaryCommandBufferUniquePtr cmd_buffer_ptr;
+
+            if (wait_fence_ptr == nullptr)
+            {
+                auto create_info_ptr = Anvil::FenceCreateInfo::create(m_device_ptr,
+                                                                      false); /* create_signalled */
+
+                create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
+
+                wait_fence_ptr = Anvil::Fence::create(std::move(create_info_ptr) );
+
+                if (wait_fence_ptr == nullptr)
+                {
+                    anvil_assert(wait_fence_ptr != nullptr);
+
+                    goto end;
+                }
+            }
+            else
+            {
+                wait_fence_ptr->reset();
+            }
+
+            if (!record_and_submit_defragmentation_moves(in_queue_ptr,
+                                                         scheduled_moves,
+                                                         wait_fence_ptr.get(),
+                                                        &cmd_buffer_ptr) )
+            {
+                goto end;
+            }
+
+            /* Do not block other threads from using the allocator while the copies execute. The new objects have
+             * already been assigned memory, so nothing the other threads may do in the meantime affects them. */
+            if (mutex_lock.owns_lock() )
+            {
+                mutex_lock.unlock();
+            }
+
+            Anvil::Vulkan::vkWaitForFences(m_device_ptr->get_device_vk(),
+                                           1, /* fenceCount */
+                                           wait_fence_ptr->get_fence_ptr(),
+                                           VK_FALSE, /* waitAll */
+                                           UINT64_MAX);
+
+            if (mutex_ptr != nullptr)
+            {
+                mutex_lock = std::move(
+                    std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+                );
+            }
+
+            for (auto& current_move_ptr : scheduled_moves)
+            {
+                if (current_move_ptr->old_buffer_ptr != nullptr)
+                {
+                    in_buffer_moved_callback_function(current_move_ptr->old_buffer_ptr,
+                                                      std::move(current_move_ptr->new_buffer_ptr) );
+                }
+                else
+                {
+                    in_image_moved_callback_function(current_move_ptr->old_image_ptr,
+                                                     std::move(current_move_ptr->new_image_ptr) );
+                }
+            }
+
+            stats.bytes_moved         += n_bytes_scheduled;
+            stats.n_allocations_moved += static_cast<uint32_t>(scheduled_moves.size() );
+
+            if (scheduled_moves.size() == candidate_moves.size() )
+            {
+                ++stats.n_memory_blocks_evacuated;
+            }
+        }
+
+        if (is_limit_reached)
+        {
+            break;
+        }
+    }
+
+    result = true;
+end:
+    if (out_opt_stats_ptr != nullptr)
+    {
+        *out_opt_stats_ptr = stats;
+    }
+
+    return result;
+}
+
+/** Returns index of the memory heap, from which the backend is going to try to allocate memory first for an item
+ *  which can use the specified memory types and requires the specified memory features. The memory type is chosen
+ *  by the backend itself (see IMemoryAllocatorBackend::get_memory_type_index()), so e.g. VMA's own memory type
+ *  selection is taken into account.
+ *
+ *  NOTE: Backends may fall back to memory types coming from other heaps if the first allocation attempt fails.
+ *        Budget projections are therefore exact only as long as allocations succeed.
+ *
+ *  @return Requested heap index or UINT32_MAX if no compatible memory type exists.
+ **/
+uint32_t Anvil::MemoryAllocator::get_heap_index_for_memory_types(uint32_t                         in_memory_types,
+                                                                 const Anvil::MemoryFeatureFlags& in_required_memory_features) const
+{
+    const auto& memory_props (m_device_ptr->get_physical_device_memory_properties() );
+    uint32_t    n_memory_type(UINT32_MAX);
+    uint32_t    result       (UINT32_MAX);
+
+    if (in_memory_types != 0                                                     &&
+        m_backend_ptr->get_memory_type_index(in_memory_types,
+                                             in_required_memory_features,
+                                            &n_memory_type)                      &&
+        n_memory_type < static_cast<uint32_t>(memory_props.types.size() ) )
+    {
+        result = memory_props.types.at(n_memory_type).heap_ptr->index;
+    }
+
+    return result;
+}
+
 bool Anvil::MemoryAllocator::do_external_memory_handle_type_sanity_checks(const Anvil::ExternalMemoryHandleTypeFlags& in_external_memory_handle_types) const
 {
     bool result = true;
@@ -2245,12 +3087,279 @@ void Anvil::MemoryAllocator::on_is_alloc_pending_for_image_query(CallbackArgumen
 }
 
 /* Please see header for specification */
-void Anvil::MemoryAllocator::on_implicit_bake_needed()
+void Anvil::MemoryAllocator::on_implicit_bake_needed(CallbackArgument* in_callback_arg_ptr)
 {
+    auto        buffer_callback_arg_ptr = dynamic_cast<OnMemoryBlockNeededForBufferCallbackArgument*>(in_callback_arg_ptr);
+    auto        image_callback_arg_ptr  = dynamic_cast<OnMemoryBlockNeededForImageCallbackArgument*> (in_callback_arg_ptr);
+    const void* object_ptr              = nullptr;
+
     /* Sanity checks */
     anvil_assert(m_items.size() >= 1);
 
-    bake();
+    /* Backends which do not support partial baking assign memory to all pending items at once */
+    if (m_backend_ptr->supports_partial_baking() )
+    {
+        if (buffer_callback_arg_ptr != nullptr)
+        {
+            object_ptr = buffer_callback_arg_ptr->buffer_ptr;
+        }
+        else
+        if (image_callback_arg_ptr != nullptr)
+        {
+            object_ptr = image_callback_arg_ptr->image_ptr;
+        }
+    }
+
+    bake_internal(false, /* in_allow_evictions */
+                  object_ptr);
+}
+
+/** Tells whether the device exposes all extensions required to track memory budget. */
+bool Anvil::MemoryAllocator::is_budget_tracking_supported() const
+{
+    return m_device_ptr->get_parent_instance()->get_enabled_extensions_info()->khr_get_physical_device_properties2() &&
+           m_device_ptr->get_extension_info      ()->ext_memory_budget                                       ();
+}
+
+/** Records copy commands for all moves described by @param in_moves into a new command buffer and submits it to
+ *  @param in_queue_ptr. @param in_fence_ptr is signalled once the commands finish executing. The function does not
+ *  block; the command buffer is handed over via @param out_cmd_buffer_ptr and must be kept alive until then.
+ *
+ *  Relocated images are transitioned to the layout the original images are in. Original images are transitioned
+ *  back to that layout after the copies complete.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::MemoryAllocator::record_and_submit_defragmentation_moves(Anvil::Queue*                         in_queue_ptr,
+                                                                     const DefragmentationMoves&           in_moves,
+                                                                     Anvil::Fence*                         in_fence_ptr,
+                                                                     Anvil::PrimaryCommandBufferUniquePtr* out_cmd_buffer_ptr)
+{
+    Anvil::PrimaryCommandBufferUniquePtr cmd_buffer_ptr;
+    Anvil::MemoryBarrier                 post_copy_memory_barrier(Anvil::AccessFlagBits::MEMORY_READ_BIT | Anvil::AccessFlagBits::MEMORY_WRITE_BIT, /* in_destination_access_mask */
+                                                                  Anvil::AccessFlagBits::TRANSFER_WRITE_BIT);
+    std::vector<Anvil::ImageBarrier>     post_copy_image_barriers;
+    Anvil::MemoryBarrier                 pre_copy_memory_barrier (Anvil::AccessFlagBits::TRANSFER_READ_BIT,                                          /* in_destination_access_mask */
+                                                                  Anvil::AccessFlagBits::MEMORY_WRITE_BIT);
+    std::vector<Anvil::ImageBarrier>     pre_copy_image_barriers;
+    bool                                 result                  (false);
+
+    cmd_buffer_ptr = m_device_ptr->get_command_pool_for_queue_family_index(in_queue_ptr->get_queue_family_index() )->alloc_primary_level_command_buffer();
+
+    if (cmd_buffer_ptr == nullptr)
+    {
+        anvil_assert(cmd_buffer_ptr != nullptr);
+
+        goto end;
+    }
+
+    for (const auto& current_move_ptr : in_moves)
+    {
+        if (current_move_ptr->old_image_ptr == nullptr)
+        {
+            continue;
+        }
+
+        pre_copy_image_barriers.push_back(
+            Anvil::ImageBarrier(Anvil::AccessFlagBits::MEMORY_WRITE_BIT,   /* in_source_access_mask      */
+                                Anvil::AccessFlagBits::TRANSFER_READ_BIT,  /* in_destination_access_mask */
+                                current_move_ptr->old_image_layout,
+                                Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                current_move_ptr->old_image_ptr,
+                                current_move_ptr->old_image_ptr->get_subresource_range() )
+        );
+        pre_copy_image_barriers.push_back(
+            Anvil::ImageBarrier(Anvil::AccessFlagBits::NONE,               /* in_source_access_mask      */
+                                Anvil::AccessFlagBits::TRANSFER_WRITE_BIT, /* in_destination_access_mask */
+                                Anvil::ImageLayout::UNDEFINED,
+                                Anvil::ImageLayout::TRANSFER_DST_OPTIMAL,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                current_move_ptr->new_image_ptr.get(),
+                                current_move_ptr->new_image_ptr->get_subresource_range() )
+        );
+
+        post_copy_image_barriers.push_back(
+            Anvil::ImageBarrier(Anvil::AccessFlagBits::NONE,               /* in_source_access_mask      */
+                                Anvil::AccessFlagBits::MEMORY_READ_BIT | Anvil::AccessFlagBits::MEMORY_WRITE_BIT,
+                                Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
+                                current_move_ptr->old_image_layout,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                current_move_ptr->old_image_ptr,
+                                current_move_ptr->old_image_ptr->get_subresource_range() )
+        );
+        post_copy_image_barriers.push_back(
+            Anvil::ImageBarrier(Anvil::AccessFlagBits::TRANSFER_WRITE_BIT, /* in_source_access_mask      */
+                                Anvil::AccessFlagBits::MEMORY_READ_BIT | Anvil::AccessFlagBits::MEMORY_WRITE_BIT,
+                                Anvil::ImageLayout::TRANSFER_DST_OPTIMAL,
+                                current_move_ptr->old_image_layout,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                VK_QUEUE_FAMILY_IGNORED,
+                                current_move_ptr->new_image_ptr.get(),
+                                current_move_ptr->new_image_ptr->get_subresource_range() )
+        );
+    }
+
+    cmd_buffer_ptr->start_recording(true,   /* one_time_submit          */
+                                    false); /* simultaneous_use_allowed */
+    {
+        cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT, /* in_src_stage_mask */
+                                                Anvil::PipelineStageFlagBits::TRANSFER_BIT,     /* in_dst_stage_mask */
+                                                Anvil::DependencyFlagBits::NONE,
+                                                1, /* in_memory_barrier_count */
+                                               &pre_copy_memory_barrier,
+                                                0,       /* in_buffer_memory_barrier_count */
+                                                nullptr, /* in_buffer_memory_barriers_ptr  */
+                                                static_cast<uint32_t>(pre_copy_image_barriers.size() ),
+                                                (pre_copy_image_barriers.size() > 0) ? &pre_copy_image_barriers.at(0) : nullptr);
+
+        for (const auto& current_move_ptr : in_moves)
+        {
+            if (current_move_ptr->old_buffer_ptr != nullptr)
+            {
+                Anvil::BufferCopy copy_region;
+
+                copy_region.dst_offset = 0;
+                copy_region.size       = current_move_ptr->old_buffer_ptr->get_create_info_ptr()->get_size();
+                copy_region.src_offset = 0;
+
+                cmd_buffer_ptr->record_copy_buffer(current_move_ptr->old_buffer_ptr,
+                                                   current_move_ptr->new_buffer_ptr.get(),
+                                                   1, /* in_region_count */
+                                                  &copy_region);
+            }
+            else
+            {
+                const Anvil::ImageSubresourceRange subresource_range(current_move_ptr->old_image_ptr->get_subresource_range() );
+                const uint32_t                     n_layers         (current_move_ptr->old_image_ptr->get_create_info_ptr()->get_n_layers() );
+                const uint32_t                     n_mipmaps        (current_move_ptr->old_image_ptr->get_n_mipmaps() );
+                std::vector<Anvil::ImageCopy>      copy_regions     (n_mipmaps);
+
+                for (uint32_t n_mipmap = 0;
+                              n_mipmap < n_mipmaps;
+                            ++n_mipmap)
+                {
+                    auto& current_region = copy_regions.at(n_mipmap);
+
+                    current_region.src_subresource.aspect_mask      = subresource_range.aspect_mask;
+                    current_region.src_subresource.base_array_layer = 0;
+                    current_region.src_subresource.layer_count      = n_layers;
+                    current_region.src_subresource.mip_level        = n_mipmap;
+                    current_region.dst_subresource                  = current_region.src_subresource;
+                    current_region.extent                           = current_move_ptr->old_image_ptr->get_image_extent_3D(n_mipmap);
+                    current_region.dst_offset.x                     = 0;
+                    current_region.dst_offset.y                     = 0;
+                    current_region.dst_offset.z                     = 0;
+                    current_region.src_offset                       = current_region.dst_offset;
+                }
+
+                cmd_buffer_ptr->record_copy_image(current_move_ptr->old_image_ptr,
+                                                  Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL,
+                                                  current_move_ptr->new_image_ptr.get(),
+                                                  Anvil::ImageLayout::TRANSFER_DST_OPTIMAL,
+                                                  n_mipmaps,
+                                                 &copy_regions.at(0) );
+            }
+        }
+
+        cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT,     /* in_src_stage_mask */
+                                                Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT, /* in_dst_stage_mask */
+                                                Anvil::DependencyFlagBits::NONE,
+                                                1, /* in_memory_barrier_count */
+                                               &post_copy_memory_barrier,
+                                                0,       /* in_buffer_memory_barrier_count */
+                                                nullptr, /* in_buffer_memory_barriers_ptr  */
+                                                static_cast<uint32_t>(post_copy_image_barriers.size() ),
+                                                (post_copy_image_barriers.size() > 0) ? &post_copy_image_barriers.at(0) : nullptr);
+    }
+    cmd_buffer_ptr->stop_recording();
+
+    result = in_queue_ptr->submit(
+        Anvil::SubmitInfo::create_execute(cmd_buffer_ptr.get(),
+                                          false, /* should_block */
+                                          in_fence_ptr)
+    );
+
+    if (result)
+    {
+        *out_cmd_buffer_ptr = std::move(cmd_buffer_ptr);
+    }
+
+end:
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::MemoryAllocator::set_budget_action_callback(BudgetActionCallbackFunction in_callback_function)
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    m_budget_action_callback_function = in_callback_function;
+}
+
+/* Please see header for specification */
+void Anvil::MemoryAllocator::set_budget_exceeded_callback(BudgetExceededCallbackFunction in_callback_function)
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    m_budget_exceeded_callback_function = in_callback_function;
+}
+
+/* Please see header for specification */
+bool Anvil::MemoryAllocator::set_budget_tracking_policy(bool                in_enable,
+                                                        const BudgetPolicy& in_policy)
+{
+    std::unique_lock<std::recursive_mutex> mutex_lock;
+    auto                                   mutex_ptr = get_mutex();
+    bool                                   result    = false;
+
+    if (mutex_ptr != nullptr)
+    {
+        mutex_lock = std::move(
+            std::unique_lock<std::recursive_mutex>(*mutex_ptr)
+        );
+    }
+
+    if (!in_enable)
+    {
+        m_is_budget_tracking_enabled = false;
+        result                       = true;
+
+        goto end;
+    }
+
+    if (!is_budget_tracking_supported() )
+    {
+        goto end;
+    }
+
+    anvil_assert(in_policy.usage_limit > 0.0f);
+
+    m_budget_policy              = in_policy;
+    m_is_budget_tracking_enabled = true;
+    result                       = true;
+
+end:
+    return result;
 }
 
 /* Please see header for specification */
@@ -0,0 +1,1952 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include "misc/debug.h"
+#include "misc/null_driver.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(ANVIL_USE_NULL_DRIVER)
+
+#define NULL_DRIVER_MAX_MIPMAP_LEVELS  (15)
+#define NULL_DRIVER_MAX_TEXEL_SIZE     (16)
+#define NULL_DRIVER_MEMORY_ALIGNMENT   (256)
+#define NULL_DRIVER_N_QUEUES           (16)
+
+
+/* Dispatchable objects. These are handed out as pointers, as required by the spec. */
+typedef struct NullCommandBuffer
+{
+    uint64_t n_commands;
+    uint64_t parent_command_pool_id;
+
+    explicit NullCommandBuffer(uint64_t in_parent_command_pool_id)
+        :n_commands            (0),
+         parent_command_pool_id(in_parent_command_pool_id)
+    {
+        /* Stub */
+    }
+} NullCommandBuffer;
+
+typedef struct NullQueue
+{
+    uint32_t n_queue;
+    uint32_t n_queue_family;
+
+    NullQueue(uint32_t in_n_queue_family,
+              uint32_t in_n_queue)
+        :n_queue       (in_n_queue),
+         n_queue_family(in_n_queue_family)
+    {
+        /* Stub */
+    }
+} NullQueue;
+
+typedef struct NullDevice
+{
+    std::map<uint32_t, std::unique_ptr<NullQueue> > queues;
+} NullDevice;
+
+typedef struct NullInstance
+{
+    /* Stub */
+} NullInstance;
+
+typedef struct NullPhysicalDevice
+{
+    /* Stub */
+} NullPhysicalDevice;
+
+/* Non-dispatchable objects, which need to carry state */
+typedef struct NullMemory
+{
+    std::unique_ptr<uint8_t[]> data_ptr;
+    VkDeviceSize               size;
+
+    explicit NullMemory(VkDeviceSize in_size)
+        :size(in_size)
+    {
+        /* Stub */
+    }
+} NullMemory;
+
+
+static std::atomic<uint64_t>                                           g_n_commands_recorded        (0);
+static std::atomic<uint64_t>                                           g_n_commands_submitted       (0);
+static std::atomic<uint64_t>                                           g_n_command_buffers_submitted(0);
+static std::atomic<uint64_t>                                           g_n_live_objects             (0);
+static std::atomic<uint64_t>                                           g_n_queue_submissions        (0);
+static std::atomic<uint64_t>                                           g_next_handle_id             (1);
+
+static std::unordered_map<uint64_t, VkDeviceSize>                      g_buffer_sizes;
+static std::unordered_map<uint64_t, std::unordered_set<NullCommandBuffer*> > g_command_pool_command_buffers;
+static std::unordered_map<uint64_t, bool>                              g_event_statuses;
+static std::unordered_map<uint64_t, bool>                              g_fence_statuses;
+static std::unordered_map<uint64_t, VkDeviceSize>                      g_image_sizes;
+static std::unordered_map<uint64_t, std::unique_ptr<NullMemory> >      g_memory_objects;
+static std::mutex                                                      g_mutex;
+static NullPhysicalDevice                                              g_physical_device;
+
+
+/** Converts a non-dispatchable handle to a numerical ID. Works for both 32- and 64-bit builds. */
+template<typename HandleType>
+static uint64_t get_handle_id(HandleType in_handle)
+{
+    uint64_t result;
+
+    static_assert(sizeof(HandleType) == sizeof(uint64_t),
+                  "Non-dispatchable handles are expected to be 64-bit");
+
+    memcpy(&result,
+           &in_handle,
+           sizeof(result) );
+
+    return result;
+}
+
+/** Generates a new non-dispatchable handle with a unique ID. Does not touch the live object counter. */
+template<typename HandleType>
+static HandleType generate_handle(uint64_t* out_opt_id_ptr = nullptr)
+{
+    const uint64_t new_id = g_next_handle_id.fetch_add(1,
+                                                       std::memory_order_relaxed);
+    HandleType     result;
+
+    static_assert(sizeof(HandleType) == sizeof(uint64_t),
+                  "Non-dispatchable handles are expected to be 64-bit");
+
+    memcpy(&result,
+           &new_id,
+           sizeof(result) );
+
+    if (out_opt_id_ptr != nullptr)
+    {
+        *out_opt_id_ptr = new_id;
+    }
+
+    return result;
+}
+
+/** Generates a new non-dispatchable handle with a unique ID and bumps the live object counter. */
+template<typename HandleType>
+static HandleType create_handle(uint64_t* out_opt_id_ptr = nullptr)
+{
+    g_n_live_objects.fetch_add(1,
+                               std::memory_order_relaxed);
+
+    return generate_handle<HandleType>(out_opt_id_ptr);
+}
+
+/** Decrements the live object counter, if @param in_handle is not a null handle. */
+template<typename HandleType>
+static void destroy_handle(HandleType in_handle)
+{
+    if (get_handle_id(in_handle) != 0)
+    {
+        g_n_live_objects.fetch_sub(1,
+                                   std::memory_order_relaxed);
+    }
+}
+
+/** Accounts for a single vkCmd*() call recorded into @param in_command_buffer. */
+static inline void record_command(VkCommandBuffer in_command_buffer)
+{
+    ++reinterpret_cast<NullCommandBuffer*>(in_command_buffer)->n_commands;
+}
+
+/** Marks @param in_fence as signalled. Null handles are ignored. */
+static void signal_fence(VkFence in_fence)
+{
+    const uint64_t fence_id = get_handle_id(in_fence);
+
+    if (fence_id != 0)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+
+        g_fence_statuses[fence_id] = true;
+    }
+}
+
+/** Fills the count & array pair as per the usual Vulkan two-call idiom. Only used for empty arrays. */
+static VkResult report_empty_array(uint32_t* inout_count_ptr)
+{
+    *inout_count_ptr = 0;
+
+    return VK_SUCCESS;
+}
+
+
+/* Instance & physical device entrypoints */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateInstance(const VkInstanceCreateInfo*  /* pCreateInfo */,
+                                                            const VkAllocationCallbacks* /* pAllocator  */,
+                                                            VkInstance*                  pInstance)
+{
+    *pInstance = reinterpret_cast<VkInstance>(new NullInstance() );
+
+    g_n_live_objects.fetch_add(1,
+                               std::memory_order_relaxed);
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyInstance(VkInstance                   instance,
+                                                         const VkAllocationCallbacks* /* pAllocator */)
+{
+    if (instance != VK_NULL_HANDLE)
+    {
+        delete reinterpret_cast<NullInstance*>(instance);
+
+        g_n_live_objects.fetch_sub(1,
+                                   std::memory_order_relaxed);
+    }
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkEnumeratePhysicalDevices(VkInstance        /* instance */,
+                                                                      uint32_t*         pPhysicalDeviceCount,
+                                                                      VkPhysicalDevice* pPhysicalDevices)
+{
+    if (pPhysicalDevices == nullptr)
+    {
+        *pPhysicalDeviceCount = 1;
+
+        return VK_SUCCESS;
+    }
+
+    if (*pPhysicalDeviceCount < 1)
+    {
+        return VK_INCOMPLETE;
+    }
+
+    pPhysicalDevices[0]   = reinterpret_cast<VkPhysicalDevice>(&g_physical_device);
+    *pPhysicalDeviceCount = 1;
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkEnumerateInstanceExtensionProperties(const char*            /* pLayerName  */,
+                                                                                  uint32_t*              pPropertyCount,
+                                                                                  VkExtensionProperties* /* pProperties */)
+{
+    return report_empty_array(pPropertyCount);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkEnumerateInstanceLayerProperties(uint32_t*          pPropertyCount,
+                                                                              VkLayerProperties* /* pProperties */)
+{
+    return report_empty_array(pPropertyCount);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkEnumerateDeviceExtensionProperties(VkPhysicalDevice       /* physicalDevice */,
+                                                                                const char*            /* pLayerName     */,
+                                                                                uint32_t*              pPropertyCount,
+                                                                                VkExtensionProperties* /* pProperties    */)
+{
+    return report_empty_array(pPropertyCount);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkEnumerateDeviceLayerProperties(VkPhysicalDevice   /* physicalDevice */,
+                                                                            uint32_t*          pPropertyCount,
+                                                                            VkLayerProperties* /* pProperties    */)
+{
+    return report_empty_array(pPropertyCount);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetPhysicalDeviceFeatures(VkPhysicalDevice          /* physicalDevice */,
+                                                                   VkPhysicalDeviceFeatures* pFeatures)
+{
+    /* VkPhysicalDeviceFeatures only consists of VkBool32 members. Report support for all of them. */
+    const uint32_t n_features   = sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32);
+    VkBool32*      features_ptr = reinterpret_cast<VkBool32*>(pFeatures);
+
+    static_assert(sizeof(VkPhysicalDeviceFeatures) % sizeof(VkBool32) == 0,
+                  "VkPhysicalDeviceFeatures is expected to only hold VkBool32 members");
+
+    for (uint32_t n_feature = 0;
+                  n_feature < n_features;
+                ++n_feature)
+    {
+        features_ptr[n_feature] = VK_TRUE;
+    }
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetPhysicalDeviceFormatProperties(VkPhysicalDevice    /* physicalDevice */,
+                                                                           VkFormat            format,
+                                                                           VkFormatProperties* pFormatProperties)
+{
+    const VkFormatFeatureFlags image_features = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT               |
+                                                VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT               |
+                                                VK_FORMAT_FEATURE_STORAGE_IMAGE_ATOMIC_BIT        |
+                                                VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT            |
+                                                VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BLEND_BIT      |
+                                                VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT    |
+                                                VK_FORMAT_FEATURE_BLIT_SRC_BIT                    |
+                                                VK_FORMAT_FEATURE_BLIT_DST_BIT                    |
+                                                VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    const VkFormatFeatureFlags buffer_features = VK_FORMAT_FEATURE_UNIFORM_TEXEL_BUFFER_BIT        |
+                                                 VK_FORMAT_FEATURE_STORAGE_TEXEL_BUFFER_BIT        |
+                                                 VK_FORMAT_FEATURE_STORAGE_TEXEL_BUFFER_ATOMIC_BIT |
+                                                 VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT;
+
+    if (format == VK_FORMAT_UNDEFINED)
+    {
+        memset(pFormatProperties,
+               0,
+               sizeof(*pFormatProperties) );
+    }
+    else
+    {
+        pFormatProperties->bufferFeatures        = buffer_features;
+        pFormatProperties->linearTilingFeatures  = image_features;
+        pFormatProperties->optimalTilingFeatures = image_features;
+    }
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkGetPhysicalDeviceImageFormatProperties(VkPhysicalDevice         /* physicalDevice */,
+                                                                                    VkFormat                 format,
+                                                                                    VkImageType              /* type   */,
+                                                                                    VkImageTiling            /* tiling */,
+                                                                                    VkImageUsageFlags        /* usage  */,
+                                                                                    VkImageCreateFlags       /* flags  */,
+                                                                                    VkImageFormatProperties* pImageFormatProperties)
+{
+    if (format == VK_FORMAT_UNDEFINED)
+    {
+        return VK_ERROR_FORMAT_NOT_SUPPORTED;
+    }
+
+    pImageFormatProperties->maxArrayLayers     = 2048;
+    pImageFormatProperties->maxExtent.depth    = 2048;
+    pImageFormatProperties->maxExtent.height   = 16384;
+    pImageFormatProperties->maxExtent.width    = 16384;
+    pImageFormatProperties->maxMipLevels       = NULL_DRIVER_MAX_MIPMAP_LEVELS;
+    pImageFormatProperties->maxResourceSize    = 1ull << 40;
+    pImageFormatProperties->sampleCounts       = VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_2_BIT | VK_SAMPLE_COUNT_4_BIT | VK_SAMPLE_COUNT_8_BIT;
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice                  /* physicalDevice */,
+                                                                           VkPhysicalDeviceMemoryProperties* pMemoryProperties)
+{
+    memset(pMemoryProperties,
+           0,
+           sizeof(*pMemoryProperties) );
+
+    pMemoryProperties->memoryHeapCount = 2;
+    pMemoryProperties->memoryHeaps[0].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+    pMemoryProperties->memoryHeaps[0].size  = 8ull * 1024 * 1024 * 1024;
+    pMemoryProperties->memoryHeaps[1].flags = 0;
+    pMemoryProperties->memoryHeaps[1].size  = 8ull * 1024 * 1024 * 1024;
+
+    pMemoryProperties->memoryTypeCount = 4;
+    pMemoryProperties->memoryTypes[0].heapIndex     = 0;
+    pMemoryProperties->memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    pMemoryProperties->memoryTypes[1].heapIndex     = 1;
+    pMemoryProperties->memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    pMemoryProperties->memoryTypes[2].heapIndex     = 1;
+    pMemoryProperties->memoryTypes[2].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    pMemoryProperties->memoryTypes[3].heapIndex     = 0;
+    pMemoryProperties->memoryTypes[3].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetPhysicalDeviceProperties(VkPhysicalDevice            /* physicalDevice */,
+                                                                     VkPhysicalDeviceProperties* pProperties)
+{
+    const VkSampleCountFlags sample_counts = VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_2_BIT | VK_SAMPLE_COUNT_4_BIT | VK_SAMPLE_COUNT_8_BIT;
+    VkPhysicalDeviceLimits&  limits        = pProperties->limits;
+
+    memset(pProperties,
+           0,
+           sizeof(*pProperties) );
+
+    pProperties->apiVersion    = VK_MAKE_VERSION(1, 0, 0);
+    pProperties->deviceID      = 0;
+    pProperties->deviceType    = VK_PHYSICAL_DEVICE_TYPE_CPU;
+    pProperties->driverVersion = 1;
+    pProperties->vendorID      = 0;
+
+    strncpy(pProperties->deviceName,
+            "Anvil null driver",
+            sizeof(pProperties->deviceName) - 1);
+
+    limits.bufferImageGranularity                          = 1;
+    limits.discreteQueuePriorities                         = 2;
+    limits.framebufferColorSampleCounts                    = sample_counts;
+    limits.framebufferDepthSampleCounts                    = sample_counts;
+    limits.framebufferNoAttachmentsSampleCounts            = sample_counts;
+    limits.framebufferStencilSampleCounts                  = sample_counts;
+    limits.lineWidthGranularity                            = 1.0f;
+    limits.lineWidthRange[0]                               = 1.0f;
+    limits.lineWidthRange[1]                               = 64.0f;
+    limits.maxBoundDescriptorSets                          = 32;
+    limits.maxClipDistances                                = 8;
+    limits.maxColorAttachments                             = 8;
+    limits.maxCombinedClipAndCullDistances                 = 8;
+    limits.maxComputeSharedMemorySize                      = 65536;
+    limits.maxComputeWorkGroupCount[0]                     = 65535;
+    limits.maxComputeWorkGroupCount[1]                     = 65535;
+    limits.maxComputeWorkGroupCount[2]                     = 65535;
+    limits.maxComputeWorkGroupInvocations                  = 1024;
+    limits.maxComputeWorkGroupSize[0]                      = 1024;
+    limits.maxComputeWorkGroupSize[1]                      = 1024;
+    limits.maxComputeWorkGroupSize[2]                      = 64;
+    limits.maxCullDistances                                = 8;
+    limits.maxDescriptorSetInputAttachments                = 1u << 20;
+    limits.maxDescriptorSetSampledImages                   = 1u << 20;
+    limits.maxDescriptorSetSamplers                        = 1u << 20;
+    limits.maxDescriptorSetStorageBuffers                  = 1u << 20;
+    limits.maxDescriptorSetStorageBuffersDynamic           = 16;
+    limits.maxDescriptorSetStorageImages                   = 1u << 20;
+    limits.maxDescriptorSetUniformBuffers                  = 1u << 20;
+    limits.maxDescriptorSetUniformBuffersDynamic           = 16;
+    limits.maxDrawIndexedIndexValue                        = UINT32_MAX;
+    limits.maxDrawIndirectCount                            = UINT32_MAX;
+    limits.maxFragmentCombinedOutputResources              = 1u << 20;
+    limits.maxFragmentDualSrcAttachments                   = 1;
+    limits.maxFragmentInputComponents                      = 128;
+    limits.maxFragmentOutputAttachments                    = 8;
+    limits.maxFramebufferHeight                            = 16384;
+    limits.maxFramebufferLayers                            = 2048;
+    limits.maxFramebufferWidth                             = 16384;
+    limits.maxGeometryInputComponents                      = 128;
+    limits.maxGeometryOutputComponents                     = 128;
+    limits.maxGeometryOutputVertices                       = 256;
+    limits.maxGeometryShaderInvocations                    = 32;
+    limits.maxGeometryTotalOutputComponents                = 1024;
+    limits.maxImageArrayLayers                             = 2048;
+    limits.maxImageDimension1D                             = 16384;
+    limits.maxImageDimension2D                             = 16384;
+    limits.maxImageDimension3D                             = 2048;
+    limits.maxImageDimensionCube                           = 16384;
+    limits.maxInterpolationOffset                          = 0.5f;
+    limits.maxMemoryAllocationCount                        = UINT32_MAX;
+    limits.maxPerStageDescriptorInputAttachments           = 1u << 20;
+    limits.maxPerStageDescriptorSampledImages              = 1u << 20;
+    limits.maxPerStageDescriptorSamplers                   = 1u << 20;
+    limits.maxPerStageDescriptorStorageBuffers             = 1u << 20;
+    limits.maxPerStageDescriptorStorageImages              = 1u << 20;
+    limits.maxPerStageDescriptorUniformBuffers             = 1u << 20;
+    limits.maxPerStageResources                            = 1u << 20;
+    limits.maxPushConstantsSize                            = 256;
+    limits.maxSampleMaskWords                              = 1;
+    limits.maxSamplerAllocationCount                       = 1u << 20;
+    limits.maxSamplerAnisotropy                            = 16.0f;
+    limits.maxSamplerLodBias                               = 16.0f;
+    limits.maxStorageBufferRange                           = UINT32_MAX;
+    limits.maxTessellationControlPerPatchOutputComponents  = 120;
+    limits.maxTessellationControlPerVertexInputComponents  = 128;
+    limits.maxTessellationControlPerVertexOutputComponents = 128;
+    limits.maxTessellationControlTotalOutputComponents     = 4096;
+    limits.maxTessellationEvaluationInputComponents        = 128;
+    limits.maxTessellationEvaluationOutputComponents       = 128;
+    limits.maxTessellationGenerationLevel                  = 64;
+    limits.maxTessellationPatchSize                        = 32;
+    limits.maxTexelBufferElements                          = UINT32_MAX;
+    limits.maxTexelGatherOffset                            = 31;
+    limits.maxTexelOffset                                  = 31;
+    limits.maxUniformBufferRange                           = 65536;
+    limits.maxVertexInputAttributeOffset                   = 2047;
+    limits.maxVertexInputAttributes                        = 32;
+    limits.maxVertexInputBindingStride                     = 2048;
+    limits.maxVertexInputBindings                          = 32;
+    limits.maxVertexOutputComponents                       = 128;
+    limits.maxViewportDimensions[0]                        = 16384;
+    limits.maxViewportDimensions[1]                        = 16384;
+    limits.maxViewports                                    = 16;
+    limits.minInterpolationOffset                          = -0.5f;
+    limits.minMemoryMapAlignment                           = 64;
+    limits.minStorageBufferOffsetAlignment                 = 16;
+    limits.minTexelBufferOffsetAlignment                   = 16;
+    limits.minTexelGatherOffset                            = -32;
+    limits.minTexelOffset                                  = -32;
+    limits.minUniformBufferOffsetAlignment                 = 16;
+    limits.mipmapPrecisionBits                             = 8;
+    limits.nonCoherentAtomSize                             = 64;
+    limits.optimalBufferCopyOffsetAlignment                = 1;
+    limits.optimalBufferCopyRowPitchAlignment              = 1;
+    limits.pointSizeGranularity                            = 1.0f;
+    limits.pointSizeRange[0]                               = 1.0f;
+    limits.pointSizeRange[1]                               = 64.0f;
+    limits.sampledImageColorSampleCounts                   = sample_counts;
+    limits.sampledImageDepthSampleCounts                   = sample_counts;
+    limits.sampledImageIntegerSampleCounts                 = sample_counts;
+    limits.sampledImageStencilSampleCounts                 = sample_counts;
+    limits.sparseAddressSpaceSize                          = 1ull << 40;
+    limits.standardSampleLocations                         = VK_TRUE;
+    limits.storageImageSampleCounts                        = sample_counts;
+    limits.strictLines                                     = VK_TRUE;
+    limits.subPixelInterpolationOffsetBits                 = 4;
+    limits.subPixelPrecisionBits                           = 8;
+    limits.subTexelPrecisionBits                           = 8;
+    limits.timestampComputeAndGraphics                     = VK_TRUE;
+    limits.timestampPeriod                                 = 1.0f;
+    limits.viewportBoundsRange[0]                          = -32768.0f;
+    limits.viewportBoundsRange[1]                          = 32767.0f;
+    limits.viewportSubPixelBits                            = 8;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetPhysicalDeviceQueueFamilyProperties(VkPhysicalDevice         /* physicalDevice */,
+                                                                                uint32_t*                pQueueFamilyPropertyCount,
+                                                                                VkQueueFamilyProperties* pQueueFamilyProperties)
+{
+    if (pQueueFamilyProperties == nullptr)
+    {
+        *pQueueFamilyPropertyCount = 1;
+
+        return;
+    }
+
+    if (*pQueueFamilyPropertyCount >= 1)
+    {
+        pQueueFamilyProperties[0].minImageTransferGranularity.depth  = 1;
+        pQueueFamilyProperties[0].minImageTransferGranularity.height = 1;
+        pQueueFamilyProperties[0].minImageTransferGranularity.width  = 1;
+        pQueueFamilyProperties[0].queueCount                         = NULL_DRIVER_N_QUEUES;
+        pQueueFamilyProperties[0].queueFlags                         = VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_SPARSE_BINDING_BIT | VK_QUEUE_TRANSFER_BIT;
+        pQueueFamilyProperties[0].timestampValidBits                 = 64;
+
+        *pQueueFamilyPropertyCount = 1;
+    }
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetPhysicalDeviceSparseImageFormatProperties(VkPhysicalDevice               /* physicalDevice */,
+                                                                                      VkFormat                       /* format         */,
+                                                                                      VkImageType                    /* type           */,
+                                                                                      VkSampleCountFlagBits          /* samples        */,
+                                                                                      VkImageUsageFlags              /* usage          */,
+                                                                                      VkImageTiling                  /* tiling         */,
+                                                                                      uint32_t*                      pPropertyCount,
+                                                                                      VkSparseImageFormatProperties* /* pProperties    */)
+{
+    report_empty_array(pPropertyCount);
+}
+
+static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL null_vkGetDeviceProcAddr(VkDevice    /* device */,
+                                                                         const char* pName)
+{
+    return Anvil::NullDriver::get_proc_address(pName);
+}
+
+static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL null_vkGetInstanceProcAddr(VkInstance  /* instance */,
+                                                                           const char* pName)
+{
+    return Anvil::NullDriver::get_proc_address(pName);
+}
+
+
+/* Device & queue entrypoints */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateDevice(VkPhysicalDevice             /* physicalDevice */,
+                                                          const VkDeviceCreateInfo*    /* pCreateInfo    */,
+                                                          const VkAllocationCallbacks* /* pAllocator     */,
+                                                          VkDevice*                    pDevice)
+{
+    *pDevice = reinterpret_cast<VkDevice>(new NullDevice() );
+
+    g_n_live_objects.fetch_add(1,
+                               std::memory_order_relaxed);
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyDevice(VkDevice                     device,
+                                                       const VkAllocationCallbacks* /* pAllocator */)
+{
+    if (device != VK_NULL_HANDLE)
+    {
+        delete reinterpret_cast<NullDevice*>(device);
+
+        g_n_live_objects.fetch_sub(1,
+                                   std::memory_order_relaxed);
+    }
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkDeviceWaitIdle(VkDevice /* device */)
+{
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetDeviceQueue(VkDevice device,
+                                                        uint32_t queueFamilyIndex,
+                                                        uint32_t queueIndex,
+                                                        VkQueue* pQueue)
+{
+    std::lock_guard<std::mutex> lock      (g_mutex);
+    NullDevice*                 device_ptr(reinterpret_cast<NullDevice*>(device) );
+    const uint32_t              queue_key ((queueFamilyIndex << 16) | queueIndex);
+    auto                        queue_iterator = device_ptr->queues.find(queue_key);
+
+    anvil_assert(queueFamilyIndex == 0);
+    anvil_assert(queueIndex       <  NULL_DRIVER_N_QUEUES);
+
+    if (queue_iterator == device_ptr->queues.end() )
+    {
+        std::unique_ptr<NullQueue> new_queue_ptr(new NullQueue(queueFamilyIndex,
+                                                               queueIndex) );
+
+        queue_iterator = device_ptr->queues.insert(
+            std::make_pair(queue_key,
+                           std::move(new_queue_ptr) )
+        ).first;
+    }
+
+    *pQueue = reinterpret_cast<VkQueue>(queue_iterator->second.get() );
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkQueueBindSparse(VkQueue                 /* queue         */,
+                                                             uint32_t                /* bindInfoCount */,
+                                                             const VkBindSparseInfo* /* pBindInfo     */,
+                                                             VkFence                 fence)
+{
+    g_n_queue_submissions.fetch_add(1,
+                                    std::memory_order_relaxed);
+
+    signal_fence(fence);
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkQueueSubmit(VkQueue             /* queue */,
+                                                         uint32_t            submitCount,
+                                                         const VkSubmitInfo* pSubmits,
+                                                         VkFence             fence)
+{
+    uint64_t n_command_buffers = 0;
+    uint64_t n_commands        = 0;
+
+    for (uint32_t n_submit = 0;
+                  n_submit < submitCount;
+                ++n_submit)
+    {
+        for (uint32_t n_command_buffer = 0;
+                      n_command_buffer < pSubmits[n_submit].commandBufferCount;
+                    ++n_command_buffer)
+        {
+            n_commands += reinterpret_cast<const NullCommandBuffer*>(pSubmits[n_submit].pCommandBuffers[n_command_buffer])->n_commands;
+        }
+
+        n_command_buffers += pSubmits[n_submit].commandBufferCount;
+    }
+
+    g_n_command_buffers_submitted.fetch_add(n_command_buffers,
+                                            std::memory_order_relaxed);
+    g_n_commands_submitted.fetch_add       (n_commands,
+                                            std::memory_order_relaxed);
+    g_n_queue_submissions.fetch_add        (1,
+                                            std::memory_order_relaxed);
+
+    signal_fence(fence);
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkQueueWaitIdle(VkQueue /* queue */)
+{
+    return VK_SUCCESS;
+}
+
+
+/* Memory entrypoints */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkAllocateMemory(VkDevice                     /* device     */,
+                                                            const VkMemoryAllocateInfo*  pAllocateInfo,
+                                                            const VkAllocationCallbacks* /* pAllocator */,
+                                                            VkDeviceMemory*              pMemory)
+{
+    std::lock_guard<std::mutex> lock       (g_mutex);
+    uint64_t                    memory_id  (0);
+
+    *pMemory = create_handle<VkDeviceMemory>(&memory_id);
+
+    g_memory_objects[memory_id].reset(
+        new NullMemory(pAllocateInfo->allocationSize)
+    );
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkFreeMemory(VkDevice                     /* device     */,
+                                                    VkDeviceMemory               memory,
+                                                    const VkAllocationCallbacks* /* pAllocator */)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    g_memory_objects.erase(get_handle_id(memory) );
+
+    destroy_handle(memory);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkMapMemory(VkDevice         /* device */,
+                                                       VkDeviceMemory   memory,
+                                                       VkDeviceSize     offset,
+                                                       VkDeviceSize     /* size  */,
+                                                       VkMemoryMapFlags /* flags */,
+                                                       void**           ppData)
+{
+    std::lock_guard<std::mutex> lock           (g_mutex);
+    auto                        memory_iterator(g_memory_objects.find(get_handle_id(memory) ));
+
+    if (memory_iterator == g_memory_objects.end() )
+    {
+        anvil_assert(memory_iterator != g_memory_objects.end() );
+
+        return VK_ERROR_MEMORY_MAP_FAILED;
+    }
+
+    /* Host storage is only allocated for memory objects which are actually mapped */
+    if (memory_iterator->second->data_ptr == nullptr)
+    {
+        memory_iterator->second->data_ptr.reset(
+            new (std::nothrow) uint8_t[static_cast<size_t>(memory_iterator->second->size)]
+        );
+
+        if (memory_iterator->second->data_ptr == nullptr)
+        {
+            return VK_ERROR_MEMORY_MAP_FAILED;
+        }
+    }
+
+    *ppData = memory_iterator->second->data_ptr.get() + offset;
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkUnmapMemory(VkDevice       /* device */,
+                                                     VkDeviceMemory /* memory */)
+{
+    /* Stub - storage stays around until the memory object is freed */
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkFlushMappedMemoryRanges(VkDevice                   /* device           */,
+                                                                     uint32_t                   /* memoryRangeCount */,
+                                                                     const VkMappedMemoryRange* /* pMemoryRanges    */)
+{
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkInvalidateMappedMemoryRanges(VkDevice                   /* device           */,
+                                                                          uint32_t                   /* memoryRangeCount */,
+                                                                          const VkMappedMemoryRange* /* pMemoryRanges    */)
+{
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetDeviceMemoryCommitment(VkDevice       /* device */,
+                                                                  VkDeviceMemory memory,
+                                                                  VkDeviceSize*  pCommittedMemoryInBytes)
+{
+    std::lock_guard<std::mutex> lock           (g_mutex);
+    auto                        memory_iterator(g_memory_objects.find(get_handle_id(memory) ));
+
+    *pCommittedMemoryInBytes = (memory_iterator != g_memory_objects.end() ) ? memory_iterator->second->size
+                                                                             : 0;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkBindBufferMemory(VkDevice       /* device       */,
+                                                              VkBuffer       /* buffer       */,
+                                                              VkDeviceMemory /* memory       */,
+                                                              VkDeviceSize   /* memoryOffset */)
+{
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkBindImageMemory(VkDevice       /* device       */,
+                                                             VkImage        /* image        */,
+                                                             VkDeviceMemory /* memory       */,
+                                                             VkDeviceSize   /* memoryOffset */)
+{
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetBufferMemoryRequirements(VkDevice              /* device */,
+                                                                     VkBuffer              buffer,
+                                                                     VkMemoryRequirements* pMemoryRequirements)
+{
+    std::lock_guard<std::mutex> lock           (g_mutex);
+    auto                        buffer_iterator(g_buffer_sizes.find(get_handle_id(buffer) ));
+    const VkDeviceSize          buffer_size    ((buffer_iterator != g_buffer_sizes.end() ) ? buffer_iterator->second : 0);
+
+    pMemoryRequirements->alignment      = NULL_DRIVER_MEMORY_ALIGNMENT;
+    pMemoryRequirements->memoryTypeBits = (1 << 4) - 1;
+    pMemoryRequirements->size           = (buffer_size + NULL_DRIVER_MEMORY_ALIGNMENT - 1) / NULL_DRIVER_MEMORY_ALIGNMENT * NULL_DRIVER_MEMORY_ALIGNMENT;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetImageMemoryRequirements(VkDevice              /* device */,
+                                                                    VkImage               image,
+                                                                    VkMemoryRequirements* pMemoryRequirements)
+{
+    std::lock_guard<std::mutex> lock          (g_mutex);
+    auto                        image_iterator(g_image_sizes.find(get_handle_id(image) ));
+
+    pMemoryRequirements->alignment      = NULL_DRIVER_MEMORY_ALIGNMENT;
+    pMemoryRequirements->memoryTypeBits = (1 << 4) - 1;
+    pMemoryRequirements->size           = (image_iterator != g_image_sizes.end() ) ? image_iterator->second : 0;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetImageSparseMemoryRequirements(VkDevice                         /* device                          */,
+                                                                          VkImage                          /* image                           */,
+                                                                          uint32_t*                        pSparseMemoryRequirementCount,
+                                                                          VkSparseImageMemoryRequirements* /* pSparseMemoryRequirements       */)
+{
+    report_empty_array(pSparseMemoryRequirementCount);
+}
+
+
+/* Synchronization entrypoints */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateFence(VkDevice                     /* device     */,
+                                                         const VkFenceCreateInfo*     pCreateInfo,
+                                                         const VkAllocationCallbacks* /* pAllocator */,
+                                                         VkFence*                     pFence)
+{
+    std::lock_guard<std::mutex> lock    (g_mutex);
+    uint64_t                    fence_id(0);
+
+    *pFence = create_handle<VkFence>(&fence_id);
+
+    g_fence_statuses[fence_id] = ((pCreateInfo->flags & VK_FENCE_CREATE_SIGNALED_BIT) != 0);
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyFence(VkDevice                     /* device     */,
+                                                     VkFence                      fence,
+                                                     const VkAllocationCallbacks* /* pAllocator */)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    g_fence_statuses.erase(get_handle_id(fence) );
+
+    destroy_handle(fence);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkGetFenceStatus(VkDevice /* device */,
+                                                           VkFence  fence)
+{
+    std::lock_guard<std::mutex> lock          (g_mutex);
+    auto                        fence_iterator(g_fence_statuses.find(get_handle_id(fence) ));
+
+    return (fence_iterator != g_fence_statuses.end() && fence_iterator->second) ? VK_SUCCESS
+                                                                                : VK_NOT_READY;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkResetFences(VkDevice       /* device */,
+                                                         uint32_t       fenceCount,
+                                                         const VkFence* pFences)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    for (uint32_t n_fence = 0;
+                  n_fence < fenceCount;
+                ++n_fence)
+    {
+        g_fence_statuses[get_handle_id(pFences[n_fence])] = false;
+    }
+
+    return VK_SUCCESS;
+}
+
+/* NOTE: Nothing can signal a fence asynchronously, so fences which are not signalled by the time of the call time out immediately. */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkWaitForFences(VkDevice       /* device  */,
+                                                           uint32_t       fenceCount,
+                                                           const VkFence* pFences,
+                                                           VkBool32       waitAll,
+                                                           uint64_t       /* timeout */)
+{
+    std::lock_guard<std::mutex> lock                (g_mutex);
+    uint32_t                    n_signalled_fences  (0);
+
+    for (uint32_t n_fence = 0;
+                  n_fence < fenceCount;
+                ++n_fence)
+    {
+        auto fence_iterator = g_fence_statuses.find(get_handle_id(pFences[n_fence]) );
+
+        if (fence_iterator != g_fence_statuses.end() &&
+            fence_iterator->second)
+        {
+            ++n_signalled_fences;
+        }
+    }
+
+    if ((waitAll == VK_TRUE  && n_signalled_fences == fenceCount) ||
+        (waitAll == VK_FALSE && n_signalled_fences >  0) )
+    {
+        return VK_SUCCESS;
+    }
+
+    return VK_TIMEOUT;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateSemaphore(VkDevice                     /* device      */,
+                                                             const VkSemaphoreCreateInfo* /* pCreateInfo */,
+                                                             const VkAllocationCallbacks* /* pAllocator  */,
+                                                             VkSemaphore*                 pSemaphore)
+{
+    *pSemaphore = create_handle<VkSemaphore>();
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroySemaphore(VkDevice                     /* device     */,
+                                                         VkSemaphore                  semaphore,
+                                                         const VkAllocationCallbacks* /* pAllocator */)
+{
+    destroy_handle(semaphore);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateEvent(VkDevice                     /* device      */,
+                                                         const VkEventCreateInfo*     /* pCreateInfo */,
+                                                         const VkAllocationCallbacks* /* pAllocator  */,
+                                                         VkEvent*                     pEvent)
+{
+    std::lock_guard<std::mutex> lock    (g_mutex);
+    uint64_t                    event_id(0);
+
+    *pEvent = create_handle<VkEvent>(&event_id);
+
+    g_event_statuses[event_id] = false;
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyEvent(VkDevice                     /* device     */,
+                                                     VkEvent                      event,
+                                                     const VkAllocationCallbacks* /* pAllocator */)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    g_event_statuses.erase(get_handle_id(event) );
+
+    destroy_handle(event);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkGetEventStatus(VkDevice /* device */,
+                                                           VkEvent  event)
+{
+    std::lock_guard<std::mutex> lock          (g_mutex);
+    auto                        event_iterator(g_event_statuses.find(get_handle_id(event) ));
+
+    return (event_iterator != g_event_statuses.end() && event_iterator->second) ? VK_EVENT_SET
+                                                                                : VK_EVENT_RESET;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkResetEvent(VkDevice /* device */,
+                                                       VkEvent  event)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    g_event_statuses[get_handle_id(event)] = false;
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkSetEvent(VkDevice /* device */,
+                                                     VkEvent  event)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    g_event_statuses[get_handle_id(event)] = true;
+
+    return VK_SUCCESS;
+}
+
+
+/* Query pool entrypoints */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateQueryPool(VkDevice                     /* device      */,
+                                                             const VkQueryPoolCreateInfo* /* pCreateInfo */,
+                                                             const VkAllocationCallbacks* /* pAllocator  */,
+                                                             VkQueryPool*                 pQueryPool)
+{
+    *pQueryPool = create_handle<VkQueryPool>();
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyQueryPool(VkDevice                     /* device     */,
+                                                         VkQueryPool                  queryPool,
+                                                         const VkAllocationCallbacks* /* pAllocator */)
+{
+    destroy_handle(queryPool);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkGetQueryPoolResults(VkDevice           /* device     */,
+                                                                 VkQueryPool        /* queryPool  */,
+                                                                 uint32_t           /* firstQuery */,
+                                                                 uint32_t           /* queryCount */,
+                                                                 size_t             dataSize,
+                                                                 void*              pData,
+                                                                 VkDeviceSize       /* stride     */,
+                                                                 VkQueryResultFlags /* flags      */)
+{
+    /* All queries are considered available & zero-valued. This also sets availability values, if requested, to zero
+     * which is fine, since apps are expected to either wait for the results or check availability on their own. */
+    memset(pData,
+           0,
+           dataSize);
+
+    return VK_SUCCESS;
+}
+
+
+/* Buffer & image entrypoints */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateBuffer(VkDevice                     /* device     */,
+                                                          const VkBufferCreateInfo*    pCreateInfo,
+                                                          const VkAllocationCallbacks* /* pAllocator */,
+                                                          VkBuffer*                    pBuffer)
+{
+    std::lock_guard<std::mutex> lock     (g_mutex);
+    uint64_t                    buffer_id(0);
+
+    *pBuffer = create_handle<VkBuffer>(&buffer_id);
+
+    g_buffer_sizes[buffer_id] = pCreateInfo->size;
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyBuffer(VkDevice                     /* device     */,
+                                                      VkBuffer                     buffer,
+                                                      const VkAllocationCallbacks* /* pAllocator */)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    g_buffer_sizes.erase(get_handle_id(buffer) );
+
+    destroy_handle(buffer);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateImage(VkDevice                     /* device     */,
+                                                         const VkImageCreateInfo*     pCreateInfo,
+                                                         const VkAllocationCallbacks* /* pAllocator */,
+                                                         VkImage*                     pImage)
+{
+    std::lock_guard<std::mutex> lock         (g_mutex);
+    uint64_t                    image_id     (0);
+    VkDeviceSize                n_texels     (0);
+    const uint32_t              n_mips       (std::min(pCreateInfo->mipLevels,
+                                                       static_cast<uint32_t>(NULL_DRIVER_MAX_MIPMAP_LEVELS) ));
+
+    /* Texel sizes are not tracked per format. Assume the worst case for every format, so that
+     * the memory requirements we report are always large enough. */
+    for (uint32_t n_mip = 0;
+                  n_mip < n_mips;
+                ++n_mip)
+    {
+        n_texels += static_cast<VkDeviceSize>(std::max(pCreateInfo->extent.width  >> n_mip, 1u) ) *
+                    static_cast<VkDeviceSize>(std::max(pCreateInfo->extent.height >> n_mip, 1u) ) *
+                    static_cast<VkDeviceSize>(std::max(pCreateInfo->extent.depth  >> n_mip, 1u) );
+    }
+
+    *pImage = create_handle<VkImage>(&image_id);
+
+    g_image_sizes[image_id] = n_texels                                        *
+                              pCreateInfo->arrayLayers                        *
+                              static_cast<VkDeviceSize>(pCreateInfo->samples) *
+                              NULL_DRIVER_MAX_TEXEL_SIZE;
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyImage(VkDevice                     /* device     */,
+                                                     VkImage                      image,
+                                                     const VkAllocationCallbacks* /* pAllocator */)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    g_image_sizes.erase(get_handle_id(image) );
+
+    destroy_handle(image);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetImageSubresourceLayout(VkDevice                  /* device       */,
+                                                                   VkImage                   /* image        */,
+                                                                   const VkImageSubresource* /* pSubresource */,
+                                                                   VkSubresourceLayout*      pLayout)
+{
+    memset(pLayout,
+           0,
+           sizeof(*pLayout) );
+}
+
+
+/* Stateless objects. Only their handles & the live object counter are maintained. */
+#define NULL_DRIVER_DEFINE_STATELESS_OBJECT(object_name, handle_type, create_info_type)                                            \
+    static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreate##object_name(VkDevice                     /* device      */,                \
+                                                                     const create_info_type*      /* pCreateInfo */,                \
+                                                                     const VkAllocationCallbacks* /* pAllocator  */,                \
+                                                                     handle_type*                 out_handle_ptr)                   \
+    {                                                                                                                              \
+        *out_handle_ptr = create_handle<handle_type>();                                                                            \
+                                                                                                                                   \
+        return VK_SUCCESS;                                                                                                         \
+    }                                                                                                                              \
+                                                                                                                                   \
+    static VKAPI_ATTR void VKAPI_CALL null_vkDestroy##object_name(VkDevice                     /* device     */,                    \
+                                                                  handle_type                  in_handle,                           \
+                                                                  const VkAllocationCallbacks* /* pAllocator */)                    \
+    {                                                                                                                              \
+        destroy_handle(in_handle);                                                                                                 \
+    }
+
+NULL_DRIVER_DEFINE_STATELESS_OBJECT(BufferView,          VkBufferView,          VkBufferViewCreateInfo)
+NULL_DRIVER_DEFINE_STATELESS_OBJECT(DescriptorSetLayout, VkDescriptorSetLayout, VkDescriptorSetLayoutCreateInfo)
+NULL_DRIVER_DEFINE_STATELESS_OBJECT(Framebuffer,         VkFramebuffer,         VkFramebufferCreateInfo)
+NULL_DRIVER_DEFINE_STATELESS_OBJECT(ImageView,           VkImageView,           VkImageViewCreateInfo)
+NULL_DRIVER_DEFINE_STATELESS_OBJECT(PipelineCache,       VkPipelineCache,       VkPipelineCacheCreateInfo)
+NULL_DRIVER_DEFINE_STATELESS_OBJECT(PipelineLayout,      VkPipelineLayout,      VkPipelineLayoutCreateInfo)
+NULL_DRIVER_DEFINE_STATELESS_OBJECT(RenderPass,          VkRenderPass,          VkRenderPassCreateInfo)
+NULL_DRIVER_DEFINE_STATELESS_OBJECT(Sampler,             VkSampler,             VkSamplerCreateInfo)
+NULL_DRIVER_DEFINE_STATELESS_OBJECT(ShaderModule,        VkShaderModule,        VkShaderModuleCreateInfo)
+
+#undef NULL_DRIVER_DEFINE_STATELESS_OBJECT
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkGetPipelineCacheData(VkDevice        /* device        */,
+                                                                  VkPipelineCache /* pipelineCache */,
+                                                                  size_t*         pDataSize,
+                                                                  void*           /* pData         */)
+{
+    *pDataSize = 0;
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkMergePipelineCaches(VkDevice               /* device        */,
+                                                                 VkPipelineCache        /* dstCache      */,
+                                                                 uint32_t               /* srcCacheCount */,
+                                                                 const VkPipelineCache* /* pSrcCaches    */)
+{
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkGetRenderAreaGranularity(VkDevice     /* device     */,
+                                                                  VkRenderPass /* renderPass */,
+                                                                  VkExtent2D*  pGranularity)
+{
+    pGranularity->height = 1;
+    pGranularity->width  = 1;
+}
+
+
+/* Pipeline entrypoints */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateComputePipelines(VkDevice                           /* device          */,
+                                                                    VkPipelineCache                    /* pipelineCache   */,
+                                                                    uint32_t                           createInfoCount,
+                                                                    const VkComputePipelineCreateInfo* /* pCreateInfos    */,
+                                                                    const VkAllocationCallbacks*       /* pAllocator      */,
+                                                                    VkPipeline*                        pPipelines)
+{
+    for (uint32_t n_pipeline = 0;
+                  n_pipeline < createInfoCount;
+                ++n_pipeline)
+    {
+        pPipelines[n_pipeline] = create_handle<VkPipeline>();
+    }
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateGraphicsPipelines(VkDevice                            /* device          */,
+                                                                     VkPipelineCache                     /* pipelineCache   */,
+                                                                     uint32_t                            createInfoCount,
+                                                                     const VkGraphicsPipelineCreateInfo* /* pCreateInfos    */,
+                                                                     const VkAllocationCallbacks*        /* pAllocator      */,
+                                                                     VkPipeline*                         pPipelines)
+{
+    for (uint32_t n_pipeline = 0;
+                  n_pipeline < createInfoCount;
+                ++n_pipeline)
+    {
+        pPipelines[n_pipeline] = create_handle<VkPipeline>();
+    }
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyPipeline(VkDevice                     /* device     */,
+                                                        VkPipeline                   pipeline,
+                                                        const VkAllocationCallbacks* /* pAllocator */)
+{
+    destroy_handle(pipeline);
+}
+
+
+/* Descriptor entrypoints.
+ *
+ * Descriptor sets are owned by their pools, so they are not accounted for by the live object counter. This lets
+ * vkResetDescriptorPool() and vkDestroyDescriptorPool() release them implicitly without any bookkeeping.
+ */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateDescriptorPool(VkDevice                          /* device      */,
+                                                                  const VkDescriptorPoolCreateInfo* /* pCreateInfo */,
+                                                                  const VkAllocationCallbacks*      /* pAllocator  */,
+                                                                  VkDescriptorPool*                 pDescriptorPool)
+{
+    *pDescriptorPool = create_handle<VkDescriptorPool>();
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyDescriptorPool(VkDevice                     /* device     */,
+                                                              VkDescriptorPool             descriptorPool,
+                                                              const VkAllocationCallbacks* /* pAllocator */)
+{
+    destroy_handle(descriptorPool);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkResetDescriptorPool(VkDevice                   /* device         */,
+                                                                 VkDescriptorPool           /* descriptorPool */,
+                                                                 VkDescriptorPoolResetFlags /* flags          */)
+{
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkAllocateDescriptorSets(VkDevice                           /* device        */,
+                                                                    const VkDescriptorSetAllocateInfo* pAllocateInfo,
+                                                                    VkDescriptorSet*                   pDescriptorSets)
+{
+    for (uint32_t n_set = 0;
+                  n_set < pAllocateInfo->descriptorSetCount;
+                ++n_set)
+    {
+        pDescriptorSets[n_set] = generate_handle<VkDescriptorSet>();
+    }
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkFreeDescriptorSets(VkDevice               /* device             */,
+                                                                VkDescriptorPool       /* descriptorPool     */,
+                                                                uint32_t               /* descriptorSetCount */,
+                                                                const VkDescriptorSet* /* pDescriptorSets    */)
+{
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkUpdateDescriptorSets(VkDevice                    /* device               */,
+                                                              uint32_t                    /* descriptorWriteCount */,
+                                                              const VkWriteDescriptorSet* /* pDescriptorWrites    */,
+                                                              uint32_t                    /* descriptorCopyCount  */,
+                                                              const VkCopyDescriptorSet*  /* pDescriptorCopies    */)
+{
+    /* Stub */
+}
+
+
+/* Command pool & command buffer entrypoints */
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkCreateCommandPool(VkDevice                       /* device      */,
+                                                               const VkCommandPoolCreateInfo* /* pCreateInfo */,
+                                                               const VkAllocationCallbacks*   /* pAllocator  */,
+                                                               VkCommandPool*                 pCommandPool)
+{
+    std::lock_guard<std::mutex> lock           (g_mutex);
+    uint64_t                    command_pool_id(0);
+
+    *pCommandPool = create_handle<VkCommandPool>(&command_pool_id);
+
+    g_command_pool_command_buffers[command_pool_id].clear();
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkDestroyCommandPool(VkDevice                     /* device     */,
+                                                           VkCommandPool                commandPool,
+                                                           const VkAllocationCallbacks* /* pAllocator */)
+{
+    std::lock_guard<std::mutex> lock                 (g_mutex);
+    auto                        command_pool_iterator(g_command_pool_command_buffers.find(get_handle_id(commandPool) ));
+
+    if (command_pool_iterator != g_command_pool_command_buffers.end() )
+    {
+        /* Command buffers which have not been freed explicitly are released together with their parent pool */
+        for (auto command_buffer_ptr : command_pool_iterator->second)
+        {
+            delete command_buffer_ptr;
+
+            g_n_live_objects.fetch_sub(1,
+                                       std::memory_order_relaxed);
+        }
+
+        g_command_pool_command_buffers.erase(command_pool_iterator);
+    }
+
+    destroy_handle(commandPool);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkResetCommandPool(VkDevice                /* device */,
+                                                              VkCommandPool           commandPool,
+                                                              VkCommandPoolResetFlags /* flags  */)
+{
+    std::lock_guard<std::mutex> lock                 (g_mutex);
+    auto                        command_pool_iterator(g_command_pool_command_buffers.find(get_handle_id(commandPool) ));
+
+    if (command_pool_iterator != g_command_pool_command_buffers.end() )
+    {
+        for (auto command_buffer_ptr : command_pool_iterator->second)
+        {
+            command_buffer_ptr->n_commands = 0;
+        }
+    }
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkAllocateCommandBuffers(VkDevice                           /* device */,
+                                                                    const VkCommandBufferAllocateInfo* pAllocateInfo,
+                                                                    VkCommandBuffer*                   pCommandBuffers)
+{
+    std::lock_guard<std::mutex> lock           (g_mutex);
+    const uint64_t              command_pool_id(get_handle_id(pAllocateInfo->commandPool) );
+    auto&                       command_buffers(g_command_pool_command_buffers[command_pool_id]);
+
+    for (uint32_t n_command_buffer = 0;
+                  n_command_buffer < pAllocateInfo->commandBufferCount;
+                ++n_command_buffer)
+    {
+        NullCommandBuffer* new_command_buffer_ptr = new NullCommandBuffer(command_pool_id);
+
+        command_buffers.insert(new_command_buffer_ptr);
+
+        pCommandBuffers[n_command_buffer] = reinterpret_cast<VkCommandBuffer>(new_command_buffer_ptr);
+    }
+
+    g_n_live_objects.fetch_add(pAllocateInfo->commandBufferCount,
+                               std::memory_order_relaxed);
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkFreeCommandBuffers(VkDevice               /* device */,
+                                                           VkCommandPool          commandPool,
+                                                           uint32_t               commandBufferCount,
+                                                           const VkCommandBuffer* pCommandBuffers)
+{
+    std::lock_guard<std::mutex> lock           (g_mutex);
+    auto&                       command_buffers(g_command_pool_command_buffers[get_handle_id(commandPool)]);
+
+    for (uint32_t n_command_buffer = 0;
+                  n_command_buffer < commandBufferCount;
+                ++n_command_buffer)
+    {
+        NullCommandBuffer* command_buffer_ptr = reinterpret_cast<NullCommandBuffer*>(pCommandBuffers[n_command_buffer]);
+
+        if (command_buffer_ptr == nullptr)
+        {
+            continue;
+        }
+
+        command_buffers.erase(command_buffer_ptr);
+
+        delete command_buffer_ptr;
+
+        g_n_live_objects.fetch_sub(1,
+                                   std::memory_order_relaxed);
+    }
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkBeginCommandBuffer(VkCommandBuffer                 commandBuffer,
+                                                                const VkCommandBufferBeginInfo* /* pBeginInfo */)
+{
+    reinterpret_cast<NullCommandBuffer*>(commandBuffer)->n_commands = 0;
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkEndCommandBuffer(VkCommandBuffer commandBuffer)
+{
+    g_n_commands_recorded.fetch_add(reinterpret_cast<NullCommandBuffer*>(commandBuffer)->n_commands,
+                                    std::memory_order_relaxed);
+
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL null_vkResetCommandBuffer(VkCommandBuffer           commandBuffer,
+                                                                VkCommandBufferResetFlags /* flags */)
+{
+    reinterpret_cast<NullCommandBuffer*>(commandBuffer)->n_commands = 0;
+
+    return VK_SUCCESS;
+}
+
+
+/* Command recording entrypoints. These only bump the command counter of the command buffer. */
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdBeginQuery(VkCommandBuffer     commandBuffer,
+                                                       VkQueryPool         /* queryPool */,
+                                                       uint32_t            /* query     */,
+                                                       VkQueryControlFlags /* flags     */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdBeginRenderPass(VkCommandBuffer              commandBuffer,
+                                                            const VkRenderPassBeginInfo* /* pRenderPassBegin */,
+                                                            VkSubpassContents            /* contents         */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdBindDescriptorSets(VkCommandBuffer        commandBuffer,
+                                                               VkPipelineBindPoint    /* pipelineBindPoint  */,
+                                                               VkPipelineLayout       /* layout             */,
+                                                               uint32_t               /* firstSet           */,
+                                                               uint32_t               /* descriptorSetCount */,
+                                                               const VkDescriptorSet* /* pDescriptorSets    */,
+                                                               uint32_t               /* dynamicOffsetCount */,
+                                                               const uint32_t*        /* pDynamicOffsets    */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer,
+                                                            VkBuffer        /* buffer    */,
+                                                            VkDeviceSize    /* offset    */,
+                                                            VkIndexType     /* indexType */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdBindPipeline(VkCommandBuffer     commandBuffer,
+                                                         VkPipelineBindPoint /* pipelineBindPoint */,
+                                                         VkPipeline          /* pipeline          */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdBindVertexBuffers(VkCommandBuffer     commandBuffer,
+                                                              uint32_t            /* firstBinding */,
+                                                              uint32_t            /* bindingCount */,
+                                                              const VkBuffer*     /* pBuffers     */,
+                                                              const VkDeviceSize* /* pOffsets     */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdBlitImage(VkCommandBuffer    commandBuffer,
+                                                      VkImage            /* srcImage       */,
+                                                      VkImageLayout      /* srcImageLayout */,
+                                                      VkImage            /* dstImage       */,
+                                                      VkImageLayout      /* dstImageLayout */,
+                                                      uint32_t           /* regionCount    */,
+                                                      const VkImageBlit* /* pRegions       */,
+                                                      VkFilter           /* filter         */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdClearAttachments(VkCommandBuffer          commandBuffer,
+                                                             uint32_t                 /* attachmentCount */,
+                                                             const VkClearAttachment* /* pAttachments    */,
+                                                             uint32_t                 /* rectCount       */,
+                                                             const VkClearRect*       /* pRects          */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdClearColorImage(VkCommandBuffer                commandBuffer,
+                                                            VkImage                        /* image       */,
+                                                            VkImageLayout                  /* imageLayout */,
+                                                            const VkClearColorValue*       /* pColor      */,
+                                                            uint32_t                       /* rangeCount  */,
+                                                            const VkImageSubresourceRange* /* pRanges     */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdClearDepthStencilImage(VkCommandBuffer                 commandBuffer,
+                                                                   VkImage                         /* image         */,
+                                                                   VkImageLayout                   /* imageLayout   */,
+                                                                   const VkClearDepthStencilValue* /* pDepthStencil */,
+                                                                   uint32_t                        /* rangeCount    */,
+                                                                   const VkImageSubresourceRange*  /* pRanges       */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdCopyBuffer(VkCommandBuffer     commandBuffer,
+                                                       VkBuffer            /* srcBuffer   */,
+                                                       VkBuffer            /* dstBuffer   */,
+                                                       uint32_t            /* regionCount */,
+                                                       const VkBufferCopy* /* pRegions    */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdCopyBufferToImage(VkCommandBuffer          commandBuffer,
+                                                              VkBuffer                 /* srcBuffer      */,
+                                                              VkImage                  /* dstImage       */,
+                                                              VkImageLayout            /* dstImageLayout */,
+                                                              uint32_t                 /* regionCount    */,
+                                                              const VkBufferImageCopy* /* pRegions       */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdCopyImage(VkCommandBuffer    commandBuffer,
+                                                      VkImage            /* srcImage       */,
+                                                      VkImageLayout      /* srcImageLayout */,
+                                                      VkImage            /* dstImage       */,
+                                                      VkImageLayout      /* dstImageLayout */,
+                                                      uint32_t           /* regionCount    */,
+                                                      const VkImageCopy* /* pRegions       */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdCopyImageToBuffer(VkCommandBuffer          commandBuffer,
+                                                              VkImage                  /* srcImage       */,
+                                                              VkImageLayout            /* srcImageLayout */,
+                                                              VkBuffer                 /* dstBuffer      */,
+                                                              uint32_t                 /* regionCount    */,
+                                                              const VkBufferImageCopy* /* pRegions       */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdCopyQueryPoolResults(VkCommandBuffer    commandBuffer,
+                                                                 VkQueryPool        /* queryPool  */,
+                                                                 uint32_t           /* firstQuery */,
+                                                                 uint32_t           /* queryCount */,
+                                                                 VkBuffer           /* dstBuffer  */,
+                                                                 VkDeviceSize       /* dstOffset  */,
+                                                                 VkDeviceSize       /* stride     */,
+                                                                 VkQueryResultFlags /* flags      */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdDispatch(VkCommandBuffer commandBuffer,
+                                                     uint32_t        /* groupCountX */,
+                                                     uint32_t        /* groupCountY */,
+                                                     uint32_t        /* groupCountZ */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdDispatchIndirect(VkCommandBuffer commandBuffer,
+                                                             VkBuffer        /* buffer */,
+                                                             VkDeviceSize    /* offset */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdDraw(VkCommandBuffer commandBuffer,
+                                                 uint32_t        /* vertexCount   */,
+                                                 uint32_t        /* instanceCount */,
+                                                 uint32_t        /* firstVertex   */,
+                                                 uint32_t        /* firstInstance */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdDrawIndexed(VkCommandBuffer commandBuffer,
+                                                        uint32_t        /* indexCount    */,
+                                                        uint32_t        /* instanceCount */,
+                                                        uint32_t        /* firstIndex    */,
+                                                        int32_t         /* vertexOffset  */,
+                                                        uint32_t        /* firstInstance */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer,
+                                                                VkBuffer        /* buffer    */,
+                                                                VkDeviceSize    /* offset    */,
+                                                                uint32_t        /* drawCount */,
+                                                                uint32_t        /* stride    */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdDrawIndirect(VkCommandBuffer commandBuffer,
+                                                         VkBuffer        /* buffer    */,
+                                                         VkDeviceSize    /* offset    */,
+                                                         uint32_t        /* drawCount */,
+                                                         uint32_t        /* stride    */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdEndQuery(VkCommandBuffer commandBuffer,
+                                                     VkQueryPool     /* queryPool */,
+                                                     uint32_t        /* query     */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdEndRenderPass(VkCommandBuffer commandBuffer)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdFillBuffer(VkCommandBuffer commandBuffer,
+                                                       VkBuffer        /* dstBuffer */,
+                                                       VkDeviceSize    /* dstOffset */,
+                                                       VkDeviceSize    /* size      */,
+                                                       uint32_t        /* data      */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdNextSubpass(VkCommandBuffer   commandBuffer,
+                                                        VkSubpassContents /* contents */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdPipelineBarrier(VkCommandBuffer              commandBuffer,
+                                                            VkPipelineStageFlags         /* srcStageMask             */,
+                                                            VkPipelineStageFlags         /* dstStageMask             */,
+                                                            VkDependencyFlags            /* dependencyFlags          */,
+                                                            uint32_t                     /* memoryBarrierCount       */,
+                                                            const VkMemoryBarrier*       /* pMemoryBarriers          */,
+                                                            uint32_t                     /* bufferMemoryBarrierCount */,
+                                                            const VkBufferMemoryBarrier* /* pBufferMemoryBarriers    */,
+                                                            uint32_t                     /* imageMemoryBarrierCount  */,
+                                                            const VkImageMemoryBarrier*  /* pImageMemoryBarriers     */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdPushConstants(VkCommandBuffer    commandBuffer,
+                                                          VkPipelineLayout   /* layout     */,
+                                                          VkShaderStageFlags /* stageFlags */,
+                                                          uint32_t           /* offset     */,
+                                                          uint32_t           /* size       */,
+                                                          const void*        /* pValues    */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdResetEvent(VkCommandBuffer      commandBuffer,
+                                                       VkEvent              /* event     */,
+                                                       VkPipelineStageFlags /* stageMask */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdResetQueryPool(VkCommandBuffer commandBuffer,
+                                                           VkQueryPool     /* queryPool  */,
+                                                           uint32_t        /* firstQuery */,
+                                                           uint32_t        /* queryCount */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdResolveImage(VkCommandBuffer       commandBuffer,
+                                                         VkImage               /* srcImage       */,
+                                                         VkImageLayout         /* srcImageLayout */,
+                                                         VkImage               /* dstImage       */,
+                                                         VkImageLayout         /* dstImageLayout */,
+                                                         uint32_t              /* regionCount    */,
+                                                         const VkImageResolve* /* pRegions       */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetBlendConstants(VkCommandBuffer commandBuffer,
+                                                              const float     /* blendConstants */[4])
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetDepthBias(VkCommandBuffer commandBuffer,
+                                                         float           /* depthBiasConstantFactor */,
+                                                         float           /* depthBiasClamp          */,
+                                                         float           /* depthBiasSlopeFactor    */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetDepthBounds(VkCommandBuffer commandBuffer,
+                                                           float           /* minDepthBounds */,
+                                                           float           /* maxDepthBounds */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetEvent(VkCommandBuffer      commandBuffer,
+                                                     VkEvent              /* event     */,
+                                                     VkPipelineStageFlags /* stageMask */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetLineWidth(VkCommandBuffer commandBuffer,
+                                                         float           /* lineWidth */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetScissor(VkCommandBuffer commandBuffer,
+                                                       uint32_t        /* firstScissor */,
+                                                       uint32_t        /* scissorCount */,
+                                                       const VkRect2D* /* pScissors    */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetStencilCompareMask(VkCommandBuffer    commandBuffer,
+                                                                  VkStencilFaceFlags /* faceMask    */,
+                                                                  uint32_t           /* compareMask */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetStencilReference(VkCommandBuffer    commandBuffer,
+                                                                VkStencilFaceFlags /* faceMask  */,
+                                                                uint32_t           /* reference */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetStencilWriteMask(VkCommandBuffer    commandBuffer,
+                                                                VkStencilFaceFlags /* faceMask  */,
+                                                                uint32_t           /* writeMask */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdSetViewport(VkCommandBuffer   commandBuffer,
+                                                        uint32_t          /* firstViewport */,
+                                                        uint32_t          /* viewportCount */,
+                                                        const VkViewport* /* pViewports    */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdUpdateBuffer(VkCommandBuffer commandBuffer,
+                                                         VkBuffer        /* dstBuffer */,
+                                                         VkDeviceSize    /* dstOffset */,
+                                                         VkDeviceSize    /* dataSize  */,
+                                                         const void*     /* pData     */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdWaitEvents(VkCommandBuffer              commandBuffer,
+                                                       uint32_t                     /* eventCount               */,
+                                                       const VkEvent*               /* pEvents                  */,
+                                                       VkPipelineStageFlags         /* srcStageMask             */,
+                                                       VkPipelineStageFlags         /* dstStageMask             */,
+                                                       uint32_t                     /* memoryBarrierCount       */,
+                                                       const VkMemoryBarrier*       /* pMemoryBarriers          */,
+                                                       uint32_t                     /* bufferMemoryBarrierCount */,
+                                                       const VkBufferMemoryBarrier* /* pBufferMemoryBarriers    */,
+                                                       uint32_t                     /* imageMemoryBarrierCount  */,
+                                                       const VkImageMemoryBarrier*  /* pImageMemoryBarriers     */)
+{
+    record_command(commandBuffer);
+}
+
+static VKAPI_ATTR void VKAPI_CALL null_vkCmdWriteTimestamp(VkCommandBuffer         commandBuffer,
+                                                           VkPipelineStageFlagBits /* pipelineStage */,
+                                                           VkQueryPool             /* queryPool     */,
+                                                           uint32_t                /* query         */)
+{
+    record_command(commandBuffer);
+}
+
+
+/* Please see header for specification */
+PFN_vkVoidFunction Anvil::NullDriver::get_proc_address(const char* in_name)
+{
+    #define NULL_DRIVER_ENTRYPOINT(name) {#name, reinterpret_cast<PFN_vkVoidFunction>(null_##name)}
+
+    static const std::unordered_map<std::string, PFN_vkVoidFunction> entrypoints =
+    {
+        NULL_DRIVER_ENTRYPOINT(vkAllocateCommandBuffers),
+        NULL_DRIVER_ENTRYPOINT(vkAllocateDescriptorSets),
+        NULL_DRIVER_ENTRYPOINT(vkAllocateMemory),
+        NULL_DRIVER_ENTRYPOINT(vkBeginCommandBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkBindBufferMemory),
+        NULL_DRIVER_ENTRYPOINT(vkBindImageMemory),
+        NULL_DRIVER_ENTRYPOINT(vkCmdBeginQuery),
+        NULL_DRIVER_ENTRYPOINT(vkCmdBeginRenderPass),
+        NULL_DRIVER_ENTRYPOINT(vkCmdBindDescriptorSets),
+        NULL_DRIVER_ENTRYPOINT(vkCmdBindIndexBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkCmdBindPipeline),
+        NULL_DRIVER_ENTRYPOINT(vkCmdBindVertexBuffers),
+        NULL_DRIVER_ENTRYPOINT(vkCmdBlitImage),
+        NULL_DRIVER_ENTRYPOINT(vkCmdClearAttachments),
+        NULL_DRIVER_ENTRYPOINT(vkCmdClearColorImage),
+        NULL_DRIVER_ENTRYPOINT(vkCmdClearDepthStencilImage),
+        NULL_DRIVER_ENTRYPOINT(vkCmdCopyBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkCmdCopyBufferToImage),
+        NULL_DRIVER_ENTRYPOINT(vkCmdCopyImage),
+        NULL_DRIVER_ENTRYPOINT(vkCmdCopyImageToBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkCmdCopyQueryPoolResults),
+        NULL_DRIVER_ENTRYPOINT(vkCmdDispatch),
+        NULL_DRIVER_ENTRYPOINT(vkCmdDispatchIndirect),
+        NULL_DRIVER_ENTRYPOINT(vkCmdDraw),
+        NULL_DRIVER_ENTRYPOINT(vkCmdDrawIndexed),
+        NULL_DRIVER_ENTRYPOINT(vkCmdDrawIndexedIndirect),
+        NULL_DRIVER_ENTRYPOINT(vkCmdDrawIndirect),
+        NULL_DRIVER_ENTRYPOINT(vkCmdEndQuery),
+        NULL_DRIVER_ENTRYPOINT(vkCmdEndRenderPass),
+        NULL_DRIVER_ENTRYPOINT(vkCmdFillBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkCmdNextSubpass),
+        NULL_DRIVER_ENTRYPOINT(vkCmdPipelineBarrier),
+        NULL_DRIVER_ENTRYPOINT(vkCmdPushConstants),
+        NULL_DRIVER_ENTRYPOINT(vkCmdResetEvent),
+        NULL_DRIVER_ENTRYPOINT(vkCmdResetQueryPool),
+        NULL_DRIVER_ENTRYPOINT(vkCmdResolveImage),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetBlendConstants),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetDepthBias),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetDepthBounds),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetEvent),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetLineWidth),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetScissor),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetStencilCompareMask),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetStencilReference),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetStencilWriteMask),
+        NULL_DRIVER_ENTRYPOINT(vkCmdSetViewport),
+        NULL_DRIVER_ENTRYPOINT(vkCmdUpdateBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkCmdWaitEvents),
+        NULL_DRIVER_ENTRYPOINT(vkCmdWriteTimestamp),
+        NULL_DRIVER_ENTRYPOINT(vkCreateBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkCreateBufferView),
+        NULL_DRIVER_ENTRYPOINT(vkCreateCommandPool),
+        NULL_DRIVER_ENTRYPOINT(vkCreateComputePipelines),
+        NULL_DRIVER_ENTRYPOINT(vkCreateDescriptorPool),
+        NULL_DRIVER_ENTRYPOINT(vkCreateDescriptorSetLayout),
+        NULL_DRIVER_ENTRYPOINT(vkCreateDevice),
+        NULL_DRIVER_ENTRYPOINT(vkCreateEvent),
+        NULL_DRIVER_ENTRYPOINT(vkCreateFence),
+        NULL_DRIVER_ENTRYPOINT(vkCreateFramebuffer),
+        NULL_DRIVER_ENTRYPOINT(vkCreateGraphicsPipelines),
+        NULL_DRIVER_ENTRYPOINT(vkCreateImage),
+        NULL_DRIVER_ENTRYPOINT(vkCreateImageView),
+        NULL_DRIVER_ENTRYPOINT(vkCreateInstance),
+        NULL_DRIVER_ENTRYPOINT(vkCreatePipelineCache),
+        NULL_DRIVER_ENTRYPOINT(vkCreatePipelineLayout),
+        NULL_DRIVER_ENTRYPOINT(vkCreateQueryPool),
+        NULL_DRIVER_ENTRYPOINT(vkCreateRenderPass),
+        NULL_DRIVER_ENTRYPOINT(vkCreateSampler),
+        NULL_DRIVER_ENTRYPOINT(vkCreateSemaphore),
+        NULL_DRIVER_ENTRYPOINT(vkCreateShaderModule),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyBufferView),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyCommandPool),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyDescriptorPool),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyDescriptorSetLayout),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyDevice),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyEvent),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyFence),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyFramebuffer),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyImage),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyImageView),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyInstance),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyPipeline),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyPipelineCache),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyPipelineLayout),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyQueryPool),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyRenderPass),
+        NULL_DRIVER_ENTRYPOINT(vkDestroySampler),
+        NULL_DRIVER_ENTRYPOINT(vkDestroySemaphore),
+        NULL_DRIVER_ENTRYPOINT(vkDestroyShaderModule),
+        NULL_DRIVER_ENTRYPOINT(vkDeviceWaitIdle),
+        NULL_DRIVER_ENTRYPOINT(vkEndCommandBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkEnumerateDeviceExtensionProperties),
+        NULL_DRIVER_ENTRYPOINT(vkEnumerateDeviceLayerProperties),
+        NULL_DRIVER_ENTRYPOINT(vkEnumerateInstanceExtensionProperties),
+        NULL_DRIVER_ENTRYPOINT(vkEnumerateInstanceLayerProperties),
+        NULL_DRIVER_ENTRYPOINT(vkEnumeratePhysicalDevices),
+        NULL_DRIVER_ENTRYPOINT(vkFlushMappedMemoryRanges),
+        NULL_DRIVER_ENTRYPOINT(vkFreeCommandBuffers),
+        NULL_DRIVER_ENTRYPOINT(vkFreeDescriptorSets),
+        NULL_DRIVER_ENTRYPOINT(vkFreeMemory),
+        NULL_DRIVER_ENTRYPOINT(vkGetBufferMemoryRequirements),
+        NULL_DRIVER_ENTRYPOINT(vkGetDeviceMemoryCommitment),
+        NULL_DRIVER_ENTRYPOINT(vkGetDeviceProcAddr),
+        NULL_DRIVER_ENTRYPOINT(vkGetDeviceQueue),
+        NULL_DRIVER_ENTRYPOINT(vkGetEventStatus),
+        NULL_DRIVER_ENTRYPOINT(vkGetFenceStatus),
+        NULL_DRIVER_ENTRYPOINT(vkGetImageMemoryRequirements),
+        NULL_DRIVER_ENTRYPOINT(vkGetImageSparseMemoryRequirements),
+        NULL_DRIVER_ENTRYPOINT(vkGetImageSubresourceLayout),
+        NULL_DRIVER_ENTRYPOINT(vkGetInstanceProcAddr),
+        NULL_DRIVER_ENTRYPOINT(vkGetPhysicalDeviceFeatures),
+        NULL_DRIVER_ENTRYPOINT(vkGetPhysicalDeviceFormatProperties),
+        NULL_DRIVER_ENTRYPOINT(vkGetPhysicalDeviceImageFormatProperties),
+        NULL_DRIVER_ENTRYPOINT(vkGetPhysicalDeviceMemoryProperties),
+        NULL_DRIVER_ENTRYPOINT(vkGetPhysicalDeviceProperties),
+        NULL_DRIVER_ENTRYPOINT(vkGetPhysicalDeviceQueueFamilyProperties),
+        NULL_DRIVER_ENTRYPOINT(vkGetPhysicalDeviceSparseImageFormatProperties),
+        NULL_DRIVER_ENTRYPOINT(vkGetPipelineCacheData),
+        NULL_DRIVER_ENTRYPOINT(vkGetQueryPoolResults),
+        NULL_DRIVER_ENTRYPOINT(vkGetRenderAreaGranularity),
+        NULL_DRIVER_ENTRYPOINT(vkInvalidateMappedMemoryRanges),
+        NULL_DRIVER_ENTRYPOINT(vkMapMemory),
+        NULL_DRIVER_ENTRYPOINT(vkMergePipelineCaches),
+        NULL_DRIVER_ENTRYPOINT(vkQueueBindSparse),
+        NULL_DRIVER_ENTRYPOINT(vkQueueSubmit),
+        NULL_DRIVER_ENTRYPOINT(vkQueueWaitIdle),
+        NULL_DRIVER_ENTRYPOINT(vkResetCommandBuffer),
+        NULL_DRIVER_ENTRYPOINT(vkResetCommandPool),
+        NULL_DRIVER_ENTRYPOINT(vkResetDescriptorPool),
+        NULL_DRIVER_ENTRYPOINT(vkResetEvent),
+        NULL_DRIVER_ENTRYPOINT(vkResetFences),
+        NULL_DRIVER_ENTRYPOINT(vkSetEvent),
+        NULL_DRIVER_ENTRYPOINT(vkUnmapMemory),
+        NULL_DRIVER_ENTRYPOINT(vkUpdateDescriptorSets),
+        NULL_DRIVER_ENTRYPOINT(vkWaitForFences),
+    };
+
+    #undef NULL_DRIVER_ENTRYPOINT
+
+    auto entrypoint_iterator = entrypoints.find(in_name);
+
+    /* Vulkan 1.1 and extension entrypoints are not exposed */
+    return (entrypoint_iterator != entrypoints.end() ) ? entrypoint_iterator->second
+                                                       : nullptr;
+}
+
+/* Please see header for specification */
+Anvil::NullDriver::Statistics Anvil::NullDriver::get_statistics()
+{
+    Statistics result;
+
+    result.n_command_buffers_submitted = g_n_command_buffers_submitted.load(std::memory_order_relaxed);
+    result.n_commands_recorded         = g_n_commands_recorded.load        (std::memory_order_relaxed);
+    result.n_commands_submitted        = g_n_commands_submitted.load       (std::memory_order_relaxed);
+    result.n_live_objects              = g_n_live_objects.load             (std::memory_order_relaxed);
+    result.n_queue_submissions         = g_n_queue_submissions.load        (std::memory_order_relaxed);
+
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::NullDriver::reset_statistics()
+{
+    g_n_command_buffers_submitted.store(0,
+                                        std::memory_order_relaxed);
+    g_n_commands_recorded.store        (0,
+                                        std::memory_order_relaxed);
+    g_n_commands_submitted.store       (0,
+                                        std::memory_order_relaxed);
+    g_n_queue_submissions.store        (0,
+                                        std::memory_order_relaxed);
+}
+
+#endif /* ANVIL_USE_NULL_DRIVER */
@@ -208,6 +208,12 @@ void Anvil::ObjectTracker::unregister_object(const ObjectType& in_object_type,
     }
 
     /* Notify any observers about the event. */
+    if (in_object_type == Anvil::ObjectType::DESCRIPTOR_SET_LAYOUT)
+    {
+        callback_safe(OBJECT_TRACKER_CALLBACK_ID_ON_DESCRIPTOR_SET_LAYOUT_OBJECT_ABOUT_TO_BE_UNREGISTERED,
+                     &callback_arg);
+    }
+    else
     if (in_object_type == Anvil::ObjectType::DEVICE)
     {
         callback_safe(OBJECT_TRACKER_CALLBACK_ID_ON_DEVICE_OBJECT_ABOUT_TO_BE_UNREGISTERED,
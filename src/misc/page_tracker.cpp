@@ -23,13 +23,14 @@
 #include "wrappers/memory_block.h"
 #include "misc/debug.h"
 #include "misc/page_tracker.h"
+#include <algorithm>
 
 /** Please see header for specification */
 Anvil::PageTracker::PageTracker(VkDeviceSize in_region_size,
                                 VkDeviceSize in_page_size)
-    :m_n_total_pages              (static_cast<uint32_t>(in_region_size / in_page_size) ),
+    :m_n_pages_with_memory_backing(0),
+     m_n_total_pages              (static_cast<uint32_t>(in_region_size / in_page_size) ),
      m_page_size                  (in_page_size),
-     m_n_pages_with_memory_backing(0),
      m_region_size                (in_region_size)
 {
     m_sparse_page_occupancy.resize(
@@ -38,6 +39,44 @@ Anvil::PageTracker::PageTracker(VkDeviceSize in_region_size,
 
 }
 
+/** Tells whether two bindings can be merged into one, which happens if @param in_next_binding immediately
+ *  follows @param in_binding both in the tracked region and in the same memory block.
+ **/
+bool Anvil::PageTracker::can_coalesce(const MemoryBlockBinding& in_binding,
+                                      const MemoryBlockBinding& in_next_binding)
+{
+    return (in_binding.memory_block_ptr                           == in_next_binding.memory_block_ptr          &&
+            in_binding.start_offset              + in_binding.size == in_next_binding.start_offset              &&
+            in_binding.memory_block_start_offset + in_binding.size == in_next_binding.memory_block_start_offset);
+}
+
+/** Returns an iterator pointing at the first stored binding which ends after @param in_offset,
+ *  or end() if there is no such binding. Runs in O(log n).
+ **/
+std::vector<Anvil::PageTracker::MemoryBlockBinding>::const_iterator Anvil::PageTracker::find_first_binding_ending_after(VkDeviceSize in_offset) const
+{
+    auto result = std::upper_bound(m_memory_blocks.begin(),
+                                   m_memory_blocks.end  (),
+                                   in_offset,
+                                   [](VkDeviceSize              in_value,
+                                      const MemoryBlockBinding& in_binding)
+                                   {
+                                       return in_value < in_binding.start_offset;
+                                   });
+
+    if (result != m_memory_blocks.begin() )
+    {
+        const auto prev_binding_iterator = result - 1;
+
+        if (prev_binding_iterator->start_offset + prev_binding_iterator->size > in_offset)
+        {
+            result = prev_binding_iterator;
+        }
+    }
+
+    return result;
+}
+
 /** Please see header for specification */
 Anvil::MemoryBlock* Anvil::PageTracker::get_memory_block(VkDeviceSize  in_start_offset,
                                                          VkDeviceSize  in_size,
@@ -53,15 +92,15 @@ Anvil::MemoryBlock* Anvil::PageTracker::get_memory_block(VkDeviceSize  in_start_
     }
 
     /* Handle the request */
-    for (const auto& current_memory_block : m_memory_blocks)
     {
-        if (current_memory_block.start_offset                             <= in_start_offset           &&
-            current_memory_block.start_offset + current_memory_block.size >= in_start_offset + in_size)
-        {
-            result_ptr                          = current_memory_block.memory_block_ptr;
-            *out_memory_region_start_offset_ptr = in_start_offset - current_memory_block.start_offset;
+        const auto binding_iterator = find_first_binding_ending_after(in_start_offset);
 
-            break;
+        if (binding_iterator                                          != m_memory_blocks.end() &&
+            binding_iterator->start_offset                            <= in_start_offset       &&
+            binding_iterator->start_offset + binding_iterator->size   >= in_start_offset + in_size)
+        {
+            result_ptr                          = binding_iterator->memory_block_ptr;
+            *out_memory_region_start_offset_ptr = binding_iterator->memory_block_start_offset + (in_start_offset - binding_iterator->start_offset);
         }
     }
 
@@ -75,12 +114,16 @@ bool Anvil::PageTracker::set_binding(MemoryBlock* in_memory_block_ptr,
                                      VkDeviceSize in_start_offset,
                                      VkDeviceSize in_size)
 {
-    const auto     end_offset_page_aligned    = Anvil::Utils::round_up(in_start_offset + in_size,
-                                                                       m_page_size);
-    uint32_t       n_pages;
-    uint32_t       occupancy_item_start_index;
-    const uint32_t pages_per_vec_item         = 32;
-    bool           result                     = false;
+    const auto                      end_offset_page_aligned    = Anvil::Utils::round_up(in_start_offset + in_size,
+                                                                                        m_page_size);
+    const VkDeviceSize              end_offset                 = in_start_offset + in_size;
+    uint32_t                        n_first_binding;
+    uint32_t                        n_last_binding;
+    uint32_t                        n_pages;
+    std::vector<MemoryBlockBinding> new_bindings;
+    uint32_t                        occupancy_item_start_index;
+    const uint32_t                  pages_per_vec_item         = 32;
+    bool                            result                     = false;
 
     /* Sanity checks */
     if (in_start_offset + in_size > m_region_size)
@@ -106,114 +149,112 @@ bool Anvil::PageTracker::set_binding(MemoryBlock* in_memory_block_ptr,
         goto end;
     }
 
-    /* Store the memory block binding */
-    for (auto mem_binding_iterator  = m_memory_blocks.begin();
-              mem_binding_iterator != m_memory_blocks.end();
-            ++mem_binding_iterator)
+    /* Bindings are stored in a vector sorted by start offset, with no two bindings overlapping. Determine
+     * the range of bindings which overlap with the new one. Anything else is left intact. */
+    n_first_binding = static_cast<uint32_t>(find_first_binding_ending_after(in_start_offset) - m_memory_blocks.cbegin() );
+    n_last_binding  = n_first_binding;
+
+    while (n_last_binding                                  < m_memory_blocks.size() &&
+           m_memory_blocks.at(n_last_binding).start_offset < end_offset)
     {
-        auto& mem_binding = *mem_binding_iterator;
+        ++n_last_binding;
+    }
 
-        const bool does_not_overlap = (in_start_offset + in_size -1                    < mem_binding.start_offset || /* XXYY , X = new binding, Y = this binding */
-                                       mem_binding.start_offset + mem_binding.size - 1 < in_start_offset);           /* YYXX */
+    /* Overlapping bindings are replaced with up to three bindings:
+     *
+     * 1) the part of the first overlapping binding, which precedes the new binding.
+     * 2) the new binding itself, unless it removes memory backing.
+     * 3) the part of the last overlapping binding, which follows the new binding.
+     */
+    if (n_first_binding != n_last_binding)
+    {
+        const auto& first_binding = m_memory_blocks.at(n_first_binding);
 
-        if (does_not_overlap)
+        if (first_binding.start_offset < in_start_offset)
         {
-            continue;
+            new_bindings.push_back(
+                MemoryBlockBinding(first_binding.memory_block_ptr,
+                                   first_binding.memory_block_start_offset,
+                                   in_start_offset - first_binding.start_offset, /* in_size         */
+                                   first_binding.start_offset)                   /* in_start_offset */
+            );
         }
+    }
 
-        /* There are four cases we need to handle separately :
-         *
-         * 1)  ###      - The new block _ interleaves with current memory block # from the left side.
-         *    __          Need to truncate # from the left side.
-         *
-         * 2)  ###      - The new block _ splits current memory block # in half.
-         *      _         Need to split # to two separate memory blocks.
-         *
-         * 3)  ###      - The new block _ interleaves with current memory block # from the right side.
-         *       __       Need to truncate # from the right side.
-         *
-         * 4)  ###      - The new block _ is going to be completely overwritten by _
-         *    _____       Need to remove it.
-         */
-        if ( in_start_offset            <=  mem_binding.start_offset                     &&
-             in_start_offset            <  (mem_binding.start_offset + mem_binding.size) &&
-            (in_start_offset + in_size) >=  mem_binding.start_offset                     &&
-            (in_start_offset + in_size) <  (mem_binding.start_offset + mem_binding.size) )
-        {
-            /* Case 1 */
-            mem_binding.size         -= in_start_offset + in_size - (mem_binding.start_offset);
-            mem_binding.start_offset  = in_start_offset + in_size;
-        }
-        else
-        if ( in_start_offset            >  mem_binding.start_offset                     &&
-             in_start_offset            < (mem_binding.start_offset + mem_binding.size) &&
-            (in_start_offset + in_size) >  mem_binding.start_offset                     &&
-            (in_start_offset + in_size) < (mem_binding.start_offset + mem_binding.size))
+    if (in_memory_block_ptr != nullptr)
+    {
+        new_bindings.push_back(
+            MemoryBlockBinding(in_memory_block_ptr,
+                               in_memory_block_start_offset,
+                               in_size,
+                               in_start_offset)
+        );
+    }
+
+    if (n_first_binding != n_last_binding)
+    {
+        const auto&        last_binding     = m_memory_blocks.at(n_last_binding - 1);
+        const VkDeviceSize last_binding_end = last_binding.start_offset + last_binding.size;
+
+        if (last_binding_end > end_offset)
         {
-            /* Case 2 */
-            MemoryBlockBinding left_half (mem_binding.memory_block_ptr,
-                                          mem_binding.memory_block_start_offset,
-                                          in_start_offset - mem_binding.start_offset, /* in_size         */
-                                          mem_binding.start_offset);                  /* in_start_offset */
-            MemoryBlockBinding right_half(mem_binding.memory_block_ptr,
-                                          mem_binding.memory_block_start_offset,
-                                          mem_binding.start_offset + mem_binding.size - (in_start_offset + in_size) + 1, /* in_size         */
-                                          in_start_offset + in_size);                                                    /* in_start_offset */
-
-            m_memory_blocks.push_back(left_half);
-            m_memory_blocks.push_back(right_half);
-
-            m_memory_blocks.erase(mem_binding_iterator);
+            new_bindings.push_back(
+                MemoryBlockBinding(last_binding.memory_block_ptr,
+                                   last_binding.memory_block_start_offset + (end_offset - last_binding.start_offset),
+                                   last_binding_end - end_offset, /* in_size         */
+                                   end_offset)                    /* in_start_offset */
+            );
         }
-        else
-        if ( in_start_offset            >  mem_binding.start_offset                     &&
-             in_start_offset            > (mem_binding.start_offset + mem_binding.size) &&
-            (in_start_offset + in_size) >  mem_binding.start_offset                     &&
-            (in_start_offset + in_size) > (mem_binding.start_offset + mem_binding.size) )
+    }
+
+    m_memory_blocks.erase (m_memory_blocks.begin() + n_first_binding,
+                           m_memory_blocks.begin() + n_last_binding);
+    m_memory_blocks.insert(m_memory_blocks.begin() + n_first_binding,
+                           new_bindings.begin(),
+                           new_bindings.end  () );
+
+    /* Coalesce the new binding with its neighbours, if they refer to adjacent regions of the same memory block */
+    if (in_memory_block_ptr != nullptr)
+    {
+        uint32_t n_new_binding = n_first_binding + ((new_bindings.front().start_offset < in_start_offset) ? 1 : 0);
+
+        if (n_new_binding + 1 < m_memory_blocks.size() &&
+            can_coalesce(m_memory_blocks.at(n_new_binding),
+                         m_memory_blocks.at(n_new_binding + 1) ))
         {
-            /* Case 3 */
-            mem_binding.size = (mem_binding.start_offset + mem_binding.size) - in_start_offset + 1;
+            m_memory_blocks.at(n_new_binding).size += m_memory_blocks.at(n_new_binding + 1).size;
+
+            m_memory_blocks.erase(m_memory_blocks.begin() + n_new_binding + 1);
         }
-        else
+
+        if (n_new_binding > 0                                   &&
+            can_coalesce(m_memory_blocks.at(n_new_binding - 1),
+                         m_memory_blocks.at(n_new_binding) ))
         {
-            /* Must be case 4 */
-            anvil_assert( in_start_offset            <=  mem_binding.start_offset                     &&
-                         (in_start_offset + in_size) >= (mem_binding.start_offset + mem_binding.size) );
+            m_memory_blocks.at(n_new_binding - 1).size += m_memory_blocks.at(n_new_binding).size;
 
-            m_memory_blocks.erase(mem_binding_iterator);
+            m_memory_blocks.erase(m_memory_blocks.begin() + n_new_binding);
         }
-
-        /* No more than one memory binding can be assigned to the same memory region */
-        break;
     }
 
-    m_memory_blocks.push_back(
-        MemoryBlockBinding(
-            in_memory_block_ptr,
-            in_memory_block_start_offset,
-            in_size,
-            in_start_offset)
-        );
-
     /* Update page occupancy info */
     n_pages                    = static_cast<uint32_t>(in_size         / m_page_size);
     occupancy_item_start_index = static_cast<uint32_t>(in_start_offset / m_page_size);
 
-    /* TODO: Perf of the code below could definitely be improved */
     for (uint32_t n_page = 0;
                   n_page < n_pages;
                 ++n_page)
     {
         const uint32_t occupancy_item_index = (occupancy_item_start_index + n_page) % pages_per_vec_item;
         const uint32_t occupancy_vec_index  = (occupancy_item_start_index + n_page) / pages_per_vec_item;
-        const uint32_t n_page_mask          = m_sparse_page_occupancy[occupancy_vec_index].raw & (1 << occupancy_item_index);
+        const uint32_t n_page_mask          = m_sparse_page_occupancy[occupancy_vec_index].raw & (1u << occupancy_item_index);
 
         /* Change the number of memory-backed pages only if a bit would be flipped */
         if (in_memory_block_ptr != nullptr)
         {
             if (n_page_mask == 0)
             {
-                m_sparse_page_occupancy[occupancy_vec_index].raw |= (1 << occupancy_item_index);
+                m_sparse_page_occupancy[occupancy_vec_index].raw |= (1u << occupancy_item_index);
 
                 ++m_n_pages_with_memory_backing;
             }
@@ -222,7 +263,7 @@ bool Anvil::PageTracker::set_binding(MemoryBlock* in_memory_block_ptr,
         {
             if (n_page_mask != 0)
             {
-                m_sparse_page_occupancy[occupancy_vec_index].raw &= ~(1 << occupancy_item_index);
+                m_sparse_page_occupancy[occupancy_vec_index].raw &= ~(1u << occupancy_item_index);
 
                 --m_n_pages_with_memory_backing;
             }
@@ -233,4 +274,4 @@ bool Anvil::PageTracker::set_binding(MemoryBlock* in_memory_block_ptr,
     result = true;
 end:
     return result;
-}
\ No newline at end of file
+}
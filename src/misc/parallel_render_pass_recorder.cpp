@@ -0,0 +1,371 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/parallel_render_pass_recorder.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
+#include "wrappers/device.h"
+#include <algorithm>
+
+/* Please see header for specification */
+Anvil::ParallelRenderPassRecorder::ParallelRenderPassRecorder(Anvil::BaseDevice* in_device_ptr,
+                                                              uint32_t           in_queue_family_index)
+    :m_device_ptr              (in_device_ptr),
+     m_queue_family_index      (in_queue_family_index),
+     m_job_generation          (0),
+     m_n_pending_workers       (0),
+     m_terminating             (false),
+     m_current_callback_ptr    (nullptr),
+     m_current_device_mask     (UINT32_MAX),
+     m_current_framebuffer_ptr (nullptr),
+     m_current_n_active_workers(0),
+     m_current_render_pass_ptr (nullptr),
+     m_current_subpass_id      (0)
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::ParallelRenderPassRecorder::~ParallelRenderPassRecorder()
+{
+    {
+        std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+        m_terminating = true;
+    }
+
+    m_job_submitted_cv.notify_all();
+
+    for (auto& current_worker_ptr : m_workers)
+    {
+        if (current_worker_ptr->thread.joinable() )
+        {
+            current_worker_ptr->thread.join();
+        }
+    }
+
+    /* Command buffers must be released before their parent pools. */
+    for (auto& current_worker_ptr : m_workers)
+    {
+        current_worker_ptr->cmd_buffer_ptr.reset();
+        current_worker_ptr->command_pool_ptr.reset();
+    }
+}
+
+/* Please see header for specification */
+Anvil::ParallelRenderPassRecorderUniquePtr Anvil::ParallelRenderPassRecorder::create(Anvil::BaseDevice* in_device_ptr,
+                                                                                     uint32_t           in_queue_family_index,
+                                                                                     uint32_t           in_n_workers)
+{
+    Anvil::ParallelRenderPassRecorderUniquePtr result_ptr(nullptr,
+                                                          std::default_delete<Anvil::ParallelRenderPassRecorder>() );
+
+    anvil_assert(in_device_ptr != nullptr);
+
+    result_ptr.reset(
+        new Anvil::ParallelRenderPassRecorder(in_device_ptr,
+                                              in_queue_family_index)
+    );
+
+    if (result_ptr != nullptr)
+    {
+        if (!result_ptr->init(in_n_workers) )
+        {
+            result_ptr.reset();
+        }
+    }
+
+    return result_ptr;
+}
+
+/** Allocates per-worker command pools & secondary command buffers and spawns worker threads.
+ *
+ *  @param in_n_workers Number of workers to set up, including the calling thread. 0 means "use
+ *                      as many workers as there are hardware threads".
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::ParallelRenderPassRecorder::init(uint32_t in_n_workers)
+{
+    bool result = false;
+
+    if (in_n_workers == 0)
+    {
+        in_n_workers = std::max(std::thread::hardware_concurrency(),
+                                1u);
+    }
+
+    for (uint32_t n_worker = 0;
+                  n_worker < in_n_workers;
+                ++n_worker)
+    {
+        std::unique_ptr<Worker> new_worker_ptr(new Worker() );
+
+        /* Each pool is only ever accessed from a single thread, so there's no need for the pools to be MT-safe. */
+        new_worker_ptr->command_pool_ptr = Anvil::CommandPool::create(m_device_ptr,
+                                                                      Anvil::CommandPoolCreateFlagBits::CREATE_TRANSIENT_BIT,
+                                                                      m_queue_family_index,
+                                                                      Anvil::MTSafety::DISABLED);
+
+        if (new_worker_ptr->command_pool_ptr == nullptr)
+        {
+            anvil_assert(new_worker_ptr->command_pool_ptr != nullptr);
+
+            goto end;
+        }
+
+        new_worker_ptr->cmd_buffer_ptr = new_worker_ptr->command_pool_ptr->alloc_secondary_level_command_buffer();
+
+        if (new_worker_ptr->cmd_buffer_ptr == nullptr)
+        {
+            anvil_assert(new_worker_ptr->cmd_buffer_ptr != nullptr);
+
+            goto end;
+        }
+
+        m_workers.push_back(
+            std::move(new_worker_ptr)
+        );
+    }
+
+    /* Worker 0 is the thread which calls record(). Spawn threads for the remaining ones. */
+    for (uint32_t n_worker = 1;
+                  n_worker < in_n_workers;
+                ++n_worker)
+    {
+        m_workers.at(n_worker)->thread = std::thread(&ParallelRenderPassRecorder::thread_main,
+                                                     this,
+                                                     n_worker);
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::ParallelRenderPassRecorder::record(Anvil::PrimaryCommandBuffer*             in_primary_cmd_buffer_ptr,
+                                               Anvil::RenderPass*                       in_render_pass_ptr,
+                                               Anvil::SubPassID                         in_subpass_id,
+                                               Anvil::Framebuffer*                      in_opt_framebuffer_ptr,
+                                               uint32_t                                 in_n_work_items,
+                                               const ParallelRecordingCallbackFunction& in_callback,
+                                               uint32_t                                 in_n_min_items_per_worker,
+                                               uint32_t                                 in_opt_device_mask)
+{
+    std::vector<Anvil::SecondaryCommandBuffer*> cmd_buffer_ptrs;
+    uint32_t                                    n_active_workers = 0;
+    bool                                        result           = false;
+
+    anvil_assert(in_primary_cmd_buffer_ptr != nullptr);
+    anvil_assert(in_render_pass_ptr        != nullptr);
+    anvil_assert(in_n_min_items_per_worker != 0);
+
+    if (in_n_work_items == 0)
+    {
+        result = true;
+
+        goto end;
+    }
+
+    /* Determine how many workers to use & distribute work items across them. Any remainder is spread across
+     * the first few workers, so that ranges never differ in size by more than one item. */
+    {
+        const uint32_t n_max_workers_for_item_count = std::max(in_n_work_items / std::max(in_n_min_items_per_worker, 1u),
+                                                               1u);
+        uint32_t       n_current_item               = 0;
+        uint32_t       n_items_per_worker;
+        uint32_t       n_remainder_items;
+
+        n_active_workers   = std::min(n_max_workers_for_item_count,
+                                      static_cast<uint32_t>(m_workers.size() ));
+        n_items_per_worker = in_n_work_items / n_active_workers;
+        n_remainder_items  = in_n_work_items % n_active_workers;
+
+        for (uint32_t n_worker = 0;
+                      n_worker < n_active_workers;
+                    ++n_worker)
+        {
+            auto& current_worker_ptr = m_workers.at(n_worker);
+
+            current_worker_ptr->n_first_item = n_current_item;
+            current_worker_ptr->n_items      = n_items_per_worker + ((n_worker < n_remainder_items) ? 1 : 0);
+            current_worker_ptr->result       = false;
+
+            n_current_item += current_worker_ptr->n_items;
+        }
+
+        anvil_assert(n_current_item == in_n_work_items);
+    }
+
+    /* Kick off the background workers */
+    {
+        std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+        m_current_callback_ptr     = &in_callback;
+        m_current_device_mask      = in_opt_device_mask;
+        m_current_framebuffer_ptr  = in_opt_framebuffer_ptr;
+        m_current_n_active_workers = n_active_workers;
+        m_current_render_pass_ptr  = in_render_pass_ptr;
+        m_current_subpass_id       = in_subpass_id;
+        m_n_pending_workers        = n_active_workers - 1;
+
+        ++m_job_generation;
+    }
+
+    if (n_active_workers > 1)
+    {
+        m_job_submitted_cv.notify_all();
+    }
+
+    /* The calling thread takes care of the first range.. */
+    record_worker(0);
+
+    /* ..and then waits for the remaining workers to finish. */
+    {
+        std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+        m_job_done_cv.wait(mutex_lock,
+                           [this]()
+                           {
+                               return (m_n_pending_workers == 0);
+                           });
+
+        m_current_callback_ptr = nullptr;
+    }
+
+    /* Stitch the results together, preserving work item order. */
+    cmd_buffer_ptrs.reserve(n_active_workers);
+
+    for (uint32_t n_worker = 0;
+                  n_worker < n_active_workers;
+                ++n_worker)
+    {
+        const auto& current_worker_ptr = m_workers.at(n_worker);
+
+        if (!current_worker_ptr->result)
+        {
+            anvil_assert(current_worker_ptr->result);
+
+            goto end;
+        }
+
+        cmd_buffer_ptrs.push_back(current_worker_ptr->cmd_buffer_ptr.get() );
+    }
+
+    result = in_primary_cmd_buffer_ptr->record_execute_commands(n_active_workers,
+                                                                &cmd_buffer_ptrs.at(0) );
+
+end:
+    return result;
+}
+
+/** Records the work item range assigned to the specified worker into the worker's secondary command buffer.
+ *
+ *  @param in_n_worker Index of the worker to record commands for.
+ **/
+void Anvil::ParallelRenderPassRecorder::record_worker(uint32_t in_n_worker)
+{
+    auto& worker_ptr = m_workers.at(in_n_worker);
+
+    /* The pool only holds the worker's command buffer. Resetting the pool, rather than the command buffer,
+     * lets the driver recycle all memory used by the previous recording in one go. */
+    worker_ptr->result = worker_ptr->command_pool_ptr->reset(false /* in_release_resources */);
+
+    if (worker_ptr->result)
+    {
+        worker_ptr->result = worker_ptr->cmd_buffer_ptr->start_recording(true,  /* in_one_time_submit          */
+                                                                         false, /* in_simultaneous_use_allowed */
+                                                                         true,  /* in_renderpass_usage_only    */
+                                                                         m_current_framebuffer_ptr,
+                                                                         m_current_render_pass_ptr,
+                                                                         m_current_subpass_id,
+                                                                         Anvil::OcclusionQuerySupportScope::NOT_REQUIRED,
+                                                                         false, /* in_occlusion_query_used_by_primary_command_buffer */
+                                                                         Anvil::QueryPipelineStatisticFlags(),
+                                                                         m_current_device_mask);
+    }
+
+    if (worker_ptr->result)
+    {
+        (*m_current_callback_ptr)(worker_ptr->cmd_buffer_ptr.get(),
+                                  in_n_worker,
+                                  worker_ptr->n_first_item,
+                                  worker_ptr->n_items);
+
+        worker_ptr->result = worker_ptr->cmd_buffer_ptr->stop_recording();
+    }
+}
+
+/** Entry-point of a background worker thread.
+ *
+ *  @param in_n_worker Index of the worker the thread should record commands for. Must not be 0.
+ **/
+void Anvil::ParallelRenderPassRecorder::thread_main(uint32_t in_n_worker)
+{
+    uint64_t last_job_generation = 0;
+
+    anvil_assert(in_n_worker != 0);
+
+    while (true)
+    {
+        bool should_record;
+
+        {
+            std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+            m_job_submitted_cv.wait(mutex_lock,
+                                    [this, last_job_generation]()
+                                    {
+                                        return m_terminating                          ||
+                                               m_job_generation != last_job_generation;
+                                    });
+
+            if (m_terminating)
+            {
+                break;
+            }
+
+            last_job_generation = m_job_generation;
+            should_record       = (in_n_worker < m_current_n_active_workers);
+        }
+
+        if (!should_record)
+        {
+            continue;
+        }
+
+        record_worker(in_n_worker);
+
+        {
+            std::unique_lock<std::mutex> mutex_lock(m_mutex);
+
+            anvil_assert(m_n_pending_workers > 0);
+
+            if (--m_n_pending_workers == 0)
+            {
+                m_job_done_cv.notify_one();
+            }
+        }
+    }
+}
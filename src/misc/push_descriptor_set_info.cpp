@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/buffer_create_info.h"
+#include "misc/debug.h"
+#include "misc/push_descriptor_set_info.h"
+#include "wrappers/buffer.h"
+#include "wrappers/buffer_view.h"
+#include "wrappers/image_view.h"
+#include "wrappers/sampler.h"
+
+/* Please see header for specification */
+Anvil::PushDescriptorSetInfo::PushDescriptorSetInfo()
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::PushDescriptorSetInfo::~PushDescriptorSetInfo()
+{
+    /* Stub */
+}
+
+/** Appends a VkDescriptorBufferInfo structure describing @param in_element to the internal storage.
+ *
+ *  @return Index of the new structure.
+ **/
+uint32_t Anvil::PushDescriptorSetInfo::append_info(const Anvil::DescriptorSet::BufferBindingElement& in_element)
+{
+    VkDescriptorBufferInfo buffer_info;
+    const uint32_t         result = static_cast<uint32_t>(m_buffer_infos_vk.size() );
+
+    buffer_info.buffer = in_element.buffer_ptr->get_buffer();
+
+    if (in_element.start_offset != UINT64_MAX)
+    {
+        buffer_info.offset = in_element.buffer_ptr->get_buffer_offset_vk(in_element.start_offset);
+        buffer_info.range  = in_element.buffer_ptr->get_buffer_size_vk(in_element.start_offset,
+                                                                       in_element.size);
+    }
+    else
+    {
+        buffer_info.offset = in_element.buffer_ptr->get_buffer_offset_vk(0);
+        buffer_info.range  = in_element.buffer_ptr->get_create_info_ptr()->get_size();
+    }
+
+    m_buffer_infos_vk.push_back(buffer_info);
+
+    return result;
+}
+
+/** Appends a VkDescriptorImageInfo structure describing @param in_element to the internal storage.
+ *
+ *  @return Index of the new structure.
+ **/
+uint32_t Anvil::PushDescriptorSetInfo::append_info(const Anvil::DescriptorSet::CombinedImageSamplerBindingElement& in_element)
+{
+    VkDescriptorImageInfo image_info;
+    const uint32_t        result = static_cast<uint32_t>(m_image_infos_vk.size() );
+
+    /* NOTE: A null sampler corresponds to an immutable sampler, in which case the handle is ignored. */
+    image_info.imageLayout = static_cast<VkImageLayout>(in_element.image_layout);
+    image_info.imageView   = (in_element.image_view_ptr != nullptr) ? in_element.image_view_ptr->get_image_view() : VK_NULL_HANDLE;
+    image_info.sampler     = (in_element.sampler_ptr    != nullptr) ? in_element.sampler_ptr->get_sampler()       : VK_NULL_HANDLE;
+
+    m_image_infos_vk.push_back(image_info);
+
+    return result;
+}
+
+/** Appends a VkDescriptorImageInfo structure describing @param in_element to the internal storage.
+ *
+ *  @return Index of the new structure.
+ **/
+uint32_t Anvil::PushDescriptorSetInfo::append_info(const Anvil::DescriptorSet::ImageBindingElement& in_element)
+{
+    VkDescriptorImageInfo image_info;
+    const uint32_t        result = static_cast<uint32_t>(m_image_infos_vk.size() );
+
+    image_info.imageLayout = static_cast<VkImageLayout>(in_element.image_layout);
+    image_info.imageView   = in_element.image_view_ptr->get_image_view();
+    image_info.sampler     = VK_NULL_HANDLE;
+
+    m_image_infos_vk.push_back(image_info);
+
+    return result;
+}
+
+/** Appends a VkDescriptorImageInfo structure describing @param in_element to the internal storage.
+ *
+ *  @return Index of the new structure.
+ **/
+uint32_t Anvil::PushDescriptorSetInfo::append_info(const Anvil::DescriptorSet::SamplerBindingElement& in_element)
+{
+    VkDescriptorImageInfo image_info;
+    const uint32_t        result = static_cast<uint32_t>(m_image_infos_vk.size() );
+
+    image_info.imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.imageView   = VK_NULL_HANDLE;
+    image_info.sampler     = (in_element.sampler_ptr != nullptr) ? in_element.sampler_ptr->get_sampler() : VK_NULL_HANDLE;
+
+    m_image_infos_vk.push_back(image_info);
+
+    return result;
+}
+
+/** Appends a VkBufferView handle described by @param in_element to the internal storage.
+ *
+ *  @return Index of the new handle.
+ **/
+uint32_t Anvil::PushDescriptorSetInfo::append_info(const Anvil::DescriptorSet::TexelBufferBindingElement& in_element)
+{
+    const uint32_t result = static_cast<uint32_t>(m_buffer_views_vk.size() );
+
+    m_buffer_views_vk.push_back(in_element.buffer_view_ptr->get_buffer_view() );
+
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::PushDescriptorSetInfo::clear()
+{
+    m_buffer_infos_vk.clear();
+    m_buffer_views_vk.clear();
+    m_image_infos_vk.clear ();
+    m_writes.clear         ();
+}
+
+/* Please see header for specification */
+Anvil::PushDescriptorSetInfoUniquePtr Anvil::PushDescriptorSetInfo::create()
+{
+    Anvil::PushDescriptorSetInfoUniquePtr result_ptr(nullptr,
+                                                     std::default_delete<Anvil::PushDescriptorSetInfo>() );
+
+    result_ptr.reset(
+        new Anvil::PushDescriptorSetInfo()
+    );
+
+    return result_ptr;
+}
+
+/* Please see header for specification */
+const VkWriteDescriptorSet* Anvil::PushDescriptorSetInfo::get_write_descriptor_sets_vk() const
+{
+    const uint32_t              n_writes   = static_cast<uint32_t>(m_writes.size() );
+    const VkWriteDescriptorSet* result_ptr = nullptr;
+
+    if (n_writes == 0)
+    {
+        goto end;
+    }
+
+    /* Info vectors may have been reallocated since the writes were specified, so pointers are only resolved here. */
+    m_writes_vk.resize(n_writes);
+
+    for (uint32_t n_write = 0;
+                  n_write < n_writes;
+                ++n_write)
+    {
+        const auto&           current_write    = m_writes.at   (n_write);
+        VkWriteDescriptorSet& current_write_vk = m_writes_vk.at(n_write);
+
+        current_write_vk.descriptorCount  = current_write.n_elements;
+        current_write_vk.descriptorType   = static_cast<VkDescriptorType>(current_write.descriptor_type);
+        current_write_vk.dstArrayElement  = current_write.n_first_element;
+        current_write_vk.dstBinding       = current_write.n_binding;
+        current_write_vk.dstSet           = VK_NULL_HANDLE; /* Ignored for push descriptors */
+        current_write_vk.pBufferInfo      = nullptr;
+        current_write_vk.pImageInfo       = nullptr;
+        current_write_vk.pNext            = nullptr;
+        current_write_vk.pTexelBufferView = nullptr;
+        current_write_vk.sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+
+        switch (current_write.descriptor_type)
+        {
+            case Anvil::DescriptorType::COMBINED_IMAGE_SAMPLER:
+            case Anvil::DescriptorType::INPUT_ATTACHMENT:
+            case Anvil::DescriptorType::SAMPLED_IMAGE:
+            case Anvil::DescriptorType::SAMPLER:
+            case Anvil::DescriptorType::STORAGE_IMAGE:
+            {
+                current_write_vk.pImageInfo = &m_image_infos_vk.at(current_write.n_first_info);
+
+                break;
+            }
+
+            case Anvil::DescriptorType::STORAGE_BUFFER:
+            case Anvil::DescriptorType::UNIFORM_BUFFER:
+            {
+                current_write_vk.pBufferInfo = &m_buffer_infos_vk.at(current_write.n_first_info);
+
+                break;
+            }
+
+            case Anvil::DescriptorType::STORAGE_TEXEL_BUFFER:
+            case Anvil::DescriptorType::UNIFORM_TEXEL_BUFFER:
+            {
+                current_write_vk.pTexelBufferView = &m_buffer_views_vk.at(current_write.n_first_info);
+
+                break;
+            }
+
+            default:
+            {
+                anvil_assert_fail();
+            }
+        }
+    }
+
+    result_ptr = &m_writes_vk.at(0);
+
+end:
+    return result_ptr;
+}
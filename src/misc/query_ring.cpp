@@ -0,0 +1,474 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/buffer_create_info.h"
+#include "misc/debug.h"
+#include "misc/query_ring.h"
+#include "wrappers/buffer.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/device.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/query_pool.h"
+#include "wrappers/queue.h"
+
+
+/* Please see header for specification */
+Anvil::QueryRing::QueryRing(Anvil::BaseDevice* in_device_ptr,
+                            Anvil::Queue*      in_queue_ptr,
+                            uint32_t           in_n_queries_per_frame,
+                            uint32_t           in_n_frame_slots,
+                            uint32_t           in_n_values_per_query)
+    :m_device_ptr          (in_device_ptr),
+     m_frame_slots         (in_n_frame_slots),
+     m_is_frame_active     (false),
+     m_mapped_data_ptr     (nullptr),
+     m_n_current_frame_slot(in_n_frame_slots - 1),
+     m_n_queries_per_frame (in_n_queries_per_frame),
+     m_n_values_per_query  (in_n_values_per_query),
+     m_queue_ptr           (in_queue_ptr)
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::QueryRing::~QueryRing()
+{
+    anvil_assert(!m_is_frame_active);
+
+    if (m_mapped_data_ptr != nullptr)
+    {
+        auto memory_block_ptr = m_buffer_ptr->get_memory_block(0 /* in_n_memory_block */);
+
+        memory_block_ptr->unmap                  ();
+        memory_block_ptr->set_persistently_mapped(false);
+
+        m_mapped_data_ptr = nullptr;
+    }
+}
+
+/* Please see header for specification */
+bool Anvil::QueryRing::allocate(uint32_t                  in_n_queries,
+                                QueryRingCallbackFunction in_callback_function,
+                                Anvil::QueryIndex*        out_first_query_index_ptr)
+{
+    auto&      frame_slot(m_frame_slots.at(m_n_current_frame_slot) );
+    Allocation new_allocation;
+    bool       result    (false);
+
+    anvil_assert(in_n_queries              != 0);
+    anvil_assert(m_is_frame_active);
+    anvil_assert(out_first_query_index_ptr != nullptr);
+
+    if (m_n_queries_per_frame - frame_slot.n_allocated_queries < in_n_queries)
+    {
+        /* The frame slot has run out of queries. */
+        goto end;
+    }
+
+    new_allocation.callback_function = std::move(in_callback_function);
+    new_allocation.n_first_query     = frame_slot.n_allocated_queries;
+    new_allocation.n_queries         = in_n_queries;
+
+    *out_first_query_index_ptr = m_n_current_frame_slot * m_n_queries_per_frame + frame_slot.n_allocated_queries;
+
+    frame_slot.allocations.push_back(std::move(new_allocation) );
+
+    frame_slot.n_allocated_queries += in_n_queries;
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::QueryRing::begin_frame(Anvil::CommandBufferBase* in_cmd_buffer_ptr,
+                                   uint64_t                  in_timeout)
+{
+    const uint32_t n_frame_slot((m_n_current_frame_slot + 1) % static_cast<uint32_t>(m_frame_slots.size() ));
+    auto&          frame_slot  (m_frame_slots.at(n_frame_slot) );
+    bool           result      (false);
+
+    anvil_assert(!m_is_frame_active);
+    anvil_assert(in_cmd_buffer_ptr != nullptr);
+
+    tag_recorded_frame_slots();
+
+    /* The slot is the oldest one, so delivering its results keeps callbacks in frame order. The wait only blocks if
+     * the GPU is more than get_n_frame_slots() - 1 frames behind. */
+    if (frame_slot.state == FrameSlotState::SUBMITTED)
+    {
+        if (!m_queue_ptr->wait_for_submission_tracking_value(frame_slot.submission_tracking_value,
+                                                             in_timeout) )
+        {
+            goto end;
+        }
+
+        deliver_frame_slot_results(n_frame_slot);
+    }
+
+    anvil_assert(frame_slot.state == FrameSlotState::IDLE);
+
+    if (!in_cmd_buffer_ptr->record_reset_query_pool(m_query_pool_ptr.get(),
+                                                    n_frame_slot * m_n_queries_per_frame,
+                                                    m_n_queries_per_frame) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    frame_slot.allocations.clear();
+
+    frame_slot.n_allocated_queries = 0;
+    frame_slot.state               = FrameSlotState::RECORDING;
+    m_is_frame_active              = true;
+    m_n_current_frame_slot         = n_frame_slot;
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::QueryRingUniquePtr Anvil::QueryRing::create_non_ps_query_ring(Anvil::BaseDevice* in_device_ptr,
+                                                                     Anvil::Queue*      in_queue_ptr,
+                                                                     VkQueryType        in_query_type,
+                                                                     uint32_t           in_n_queries_per_frame,
+                                                                     uint32_t           in_n_frame_slots)
+{
+    Anvil::QueryPoolUniquePtr query_pool_ptr;
+    Anvil::QueryRingUniquePtr result_ptr    (nullptr,
+                                             std::default_delete<Anvil::QueryRing>() );
+
+    anvil_assert(in_device_ptr          != nullptr);
+    anvil_assert(in_queue_ptr           != nullptr);
+    anvil_assert(in_query_type          == VK_QUERY_TYPE_OCCLUSION ||
+                 in_query_type          == VK_QUERY_TYPE_TIMESTAMP);
+    anvil_assert(in_n_queries_per_frame >  0);
+    anvil_assert(in_n_frame_slots       >  0);
+
+    query_pool_ptr = Anvil::QueryPool::create_non_ps_query_pool(in_device_ptr,
+                                                                in_query_type,
+                                                                in_n_queries_per_frame * in_n_frame_slots);
+
+    if (query_pool_ptr == nullptr)
+    {
+        anvil_assert(query_pool_ptr != nullptr);
+
+        goto end;
+    }
+
+    result_ptr.reset(
+        new Anvil::QueryRing(in_device_ptr,
+                             in_queue_ptr,
+                             in_n_queries_per_frame,
+                             in_n_frame_slots,
+                             1) /* in_n_values_per_query */
+    );
+
+    if (!result_ptr->init(std::move(query_pool_ptr) ))
+    {
+        result_ptr.reset();
+    }
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+Anvil::QueryRingUniquePtr Anvil::QueryRing::create_ps_query_ring(Anvil::BaseDevice*                 in_device_ptr,
+                                                                 Anvil::Queue*                      in_queue_ptr,
+                                                                 Anvil::QueryPipelineStatisticFlags in_pipeline_statistics,
+                                                                 uint32_t                           in_n_queries_per_frame,
+                                                                 uint32_t                           in_n_frame_slots)
+{
+    uint32_t                  n_values_per_query(0);
+    Anvil::QueryPoolUniquePtr query_pool_ptr;
+    Anvil::QueryRingUniquePtr result_ptr        (nullptr,
+                                                 std::default_delete<Anvil::QueryRing>() );
+
+    anvil_assert(in_device_ptr          != nullptr);
+    anvil_assert(in_queue_ptr           != nullptr);
+    anvil_assert(in_pipeline_statistics != 0);
+    anvil_assert(in_n_queries_per_frame >  0);
+    anvil_assert(in_n_frame_slots       >  0);
+
+    /* One value is returned per enabled statistic */
+    for (VkQueryPipelineStatisticFlags statistics = in_pipeline_statistics.get_vk();
+                                       statistics != 0;
+                                       statistics &= statistics - 1)
+    {
+        ++n_values_per_query;
+    }
+
+    query_pool_ptr = Anvil::QueryPool::create_ps_query_pool(in_device_ptr,
+                                                            in_pipeline_statistics,
+                                                            in_n_queries_per_frame * in_n_frame_slots);
+
+    if (query_pool_ptr == nullptr)
+    {
+        anvil_assert(query_pool_ptr != nullptr);
+
+        goto end;
+    }
+
+    result_ptr.reset(
+        new Anvil::QueryRing(in_device_ptr,
+                             in_queue_ptr,
+                             in_n_queries_per_frame,
+                             in_n_frame_slots,
+                             n_values_per_query)
+    );
+
+    if (!result_ptr->init(std::move(query_pool_ptr) ))
+    {
+        result_ptr.reset();
+    }
+
+end:
+    return result_ptr;
+}
+
+/** Invokes callbacks of all allocations made in frame slot @param in_n_frame_slot with results read directly from
+ *  the mapped readback buffer, and marks the slot as idle.
+ *
+ *  The GPU must have finished executing the slot's commands at the time of the call.
+ **/
+void Anvil::QueryRing::deliver_frame_slot_results(uint32_t in_n_frame_slot)
+{
+    auto&           frame_slot  (m_frame_slots.at(in_n_frame_slot) );
+    const uint64_t* results_ptr (reinterpret_cast<const uint64_t*>(m_mapped_data_ptr) + static_cast<size_t>(in_n_frame_slot) * m_n_queries_per_frame * m_n_values_per_query);
+
+    anvil_assert(frame_slot.state == FrameSlotState::SUBMITTED);
+
+    for (const auto& current_allocation : frame_slot.allocations)
+    {
+        if (current_allocation.callback_function != nullptr)
+        {
+            current_allocation.callback_function(results_ptr + static_cast<size_t>(current_allocation.n_first_query) * m_n_values_per_query,
+                                                 current_allocation.n_queries,
+                                                 m_n_values_per_query);
+        }
+    }
+
+    frame_slot.allocations.clear();
+
+    frame_slot.n_allocated_queries = 0;
+    frame_slot.state               = FrameSlotState::IDLE;
+}
+
+/* Please see header for specification */
+bool Anvil::QueryRing::end_frame(Anvil::CommandBufferBase* in_cmd_buffer_ptr)
+{
+    auto& frame_slot(m_frame_slots.at(m_n_current_frame_slot) );
+    bool  result    (false);
+
+    anvil_assert(m_is_frame_active);
+    anvil_assert(in_cmd_buffer_ptr != nullptr);
+
+    if (frame_slot.n_allocated_queries > 0)
+    {
+        const VkDeviceSize stride(sizeof(uint64_t) * m_n_values_per_query);
+        const VkDeviceSize offset(stride * m_n_current_frame_slot * m_n_queries_per_frame);
+        const VkDeviceSize size  (stride * frame_slot.n_allocated_queries);
+
+        /* Let the GPU wait for the results, so that the CPU never has to. */
+        if (!in_cmd_buffer_ptr->record_copy_query_pool_results(m_query_pool_ptr.get(),
+                                                               m_n_current_frame_slot * m_n_queries_per_frame,
+                                                               frame_slot.n_allocated_queries,
+                                                               m_buffer_ptr.get(),
+                                                               offset,
+                                                               stride,
+                                                               VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        {
+            const Anvil::BufferBarrier barrier(Anvil::AccessFlagBits::TRANSFER_WRITE_BIT,
+                                               Anvil::AccessFlagBits::HOST_READ_BIT,
+                                               VK_QUEUE_FAMILY_IGNORED,
+                                               VK_QUEUE_FAMILY_IGNORED,
+                                               m_buffer_ptr.get(),
+                                               offset,
+                                               size);
+
+            if (!in_cmd_buffer_ptr->record_pipeline_barrier(Anvil::PipelineStageFlagBits::TRANSFER_BIT,
+                                                            Anvil::PipelineStageFlagBits::HOST_BIT,
+                                                            Anvil::DependencyFlagBits::NONE,
+                                                            0,        /* in_memory_barrier_count        */
+                                                            nullptr,  /* in_memory_barriers_ptr         */
+                                                            1,        /* in_buffer_memory_barrier_count */
+                                                           &barrier,
+                                                            0,        /* in_image_memory_barrier_count  */
+                                                            nullptr)) /* in_image_memory_barriers_ptr   */
+            {
+                anvil_assert_fail();
+
+                goto end;
+            }
+        }
+
+        frame_slot.state = FrameSlotState::RECORDED;
+    }
+    else
+    {
+        frame_slot.state = FrameSlotState::IDLE;
+    }
+
+    m_is_frame_active = false;
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::QueryRing::harvest()
+{
+    uint64_t completed_value(0);
+    bool     result         (false);
+
+    tag_recorded_frame_slots();
+
+    if (!m_queue_ptr->get_completed_submission_tracking_value(&completed_value) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    /* Walk the slots from the oldest to the newest one, so that callbacks are invoked in frame order */
+    for (uint32_t n_slot = 1;
+                  n_slot <= static_cast<uint32_t>(m_frame_slots.size() );
+                ++n_slot)
+    {
+        const uint32_t n_frame_slot((m_n_current_frame_slot + n_slot) % static_cast<uint32_t>(m_frame_slots.size() ));
+        const auto&    frame_slot  (m_frame_slots.at(n_frame_slot) );
+
+        if (frame_slot.state != FrameSlotState::SUBMITTED)
+        {
+            continue;
+        }
+
+        if (frame_slot.submission_tracking_value > completed_value)
+        {
+            break;
+        }
+
+        deliver_frame_slot_results(n_frame_slot);
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/** Creates the readback buffer, backed by host-coherent memory, and maps its storage persistently.
+ *
+ *  @param in_query_pool_ptr Query pool to take ownership of. Must not be nullptr.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::QueryRing::init(Anvil::QueryPoolUniquePtr in_query_pool_ptr)
+{
+    Anvil::BufferCreateInfoUniquePtr create_info_ptr;
+    Anvil::MemoryBlock*              memory_block_ptr  (nullptr);
+    void*                            mapped_data_ptr   (nullptr);
+    const uint32_t                   queue_family_index(m_queue_ptr->get_queue_family_index() );
+    bool                             result            (false);
+    const VkDeviceSize               size              (sizeof(uint64_t) * m_n_values_per_query * m_n_queries_per_frame * m_frame_slots.size() );
+
+    m_query_pool_ptr = std::move(in_query_pool_ptr);
+
+    create_info_ptr = Anvil::BufferCreateInfo::create_alloc(m_device_ptr,
+                                                            size,
+                                                            Anvil::Utils::get_queue_family_flags_from_queue_family_type(m_device_ptr->get_queue_family_type(queue_family_index) ),
+                                                            Anvil::SharingMode::EXCLUSIVE,
+                                                            Anvil::BufferCreateFlagBits::NONE,
+                                                            Anvil::BufferUsageFlagBits::TRANSFER_DST_BIT,
+                                                            Anvil::MemoryFeatureFlagBits::MAPPABLE_BIT | Anvil::MemoryFeatureFlagBits::HOST_COHERENT_BIT);
+
+    m_buffer_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
+
+    if (m_buffer_ptr == nullptr)
+    {
+        anvil_assert(m_buffer_ptr != nullptr);
+
+        goto end;
+    }
+
+    memory_block_ptr = m_buffer_ptr->get_memory_block(0 /* in_n_memory_block */);
+
+    if (memory_block_ptr == nullptr)
+    {
+        anvil_assert(memory_block_ptr != nullptr);
+
+        goto end;
+    }
+
+    /* Keep the storage mapped for the lifetime of the ring, so that results can be handed to callbacks in place. */
+    if (!memory_block_ptr->set_persistently_mapped(true) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (!memory_block_ptr->map(0, /* in_start_offset */
+                               size,
+                              &mapped_data_ptr) )
+    {
+        anvil_assert_fail();
+
+        memory_block_ptr->set_persistently_mapped(false);
+
+        goto end;
+    }
+
+    m_mapped_data_ptr = static_cast<const char*>(mapped_data_ptr);
+
+    result = true;
+end:
+    return result;
+}
+
+/** Tags all frame slots, whose commands have been recorded since the last call, with a submission tracking value
+ *  covering all work submitted to the queue so far.
+ **/
+void Anvil::QueryRing::tag_recorded_frame_slots()
+{
+    const uint64_t tracking_value = m_queue_ptr->get_submission_tracking_value();
+
+    for (auto& current_frame_slot : m_frame_slots)
+    {
+        if (current_frame_slot.state != FrameSlotState::RECORDED)
+        {
+            continue;
+        }
+
+        current_frame_slot.state                     = FrameSlotState::SUBMITTED;
+        current_frame_slot.submission_tracking_value = tracking_value;
+    }
+}
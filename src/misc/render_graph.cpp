@@ -0,0 +1,1892 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include "misc/buffer_create_info.h"
+#include "misc/debug.h"
+#include "misc/formats.h"
+#include "misc/image_create_info.h"
+#include "misc/memory_block_create_info.h"
+#include "misc/render_graph.h"
+#include "misc/semaphore_create_info.h"
+#include "wrappers/buffer.h"
+#include "wrappers/command_buffer.h"
+#include "wrappers/command_pool.h"
+#include "wrappers/device.h"
+#include "wrappers/image.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/queue.h"
+#include "wrappers/semaphore.h"
+#include <algorithm>
+
+#define N_QUEUES (static_cast<uint32_t>(Anvil::RenderGraphQueue::COUNT) )
+
+
+/* Please see header for specification */
+Anvil::RenderGraph::Batch::Batch()
+    :queue(Anvil::RenderGraphQueue::GRAPHICS)
+{
+    for (uint32_t n_queue = 0;
+                  n_queue < N_QUEUES;
+                ++n_queue)
+    {
+        wait_producer_batches[n_queue] = UINT32_MAX;
+    }
+}
+
+/* Please see header for specification */
+Anvil::RenderGraph::ExecutionContext::ExecutionContext()
+{
+    for (uint32_t n_queue = 0;
+                  n_queue < N_QUEUES;
+                ++n_queue)
+    {
+        command_pool_ptrs         [n_queue] = nullptr;
+        submission_tracking_values[n_queue] = 0;
+    }
+}
+
+/* Please see header for specification */
+Anvil::RenderGraph::Resource::Resource()
+    :first_live_pass      (UINT32_MAX),
+     is_imported          (false),
+     last_live_pass       (0),
+     memory_alignment     (1),
+     memory_heap_index    (UINT32_MAX),
+     memory_offset        (0),
+     memory_size          (0),
+     memory_type_bits     (0),
+     type                 (ResourceType::BUFFER),
+     buffer_ptr           (nullptr),
+     size                 (0),
+     final_layout         (Anvil::ImageLayout::UNKNOWN),
+     format               (Anvil::Format::UNKNOWN),
+     image_ptr            (nullptr),
+     image_type           (Anvil::ImageType::UNKNOWN),
+     initial_layout       (Anvil::ImageLayout::UNDEFINED),
+     n_layers             (0),
+     sample_count         (Anvil::SampleCountFlagBits::_1_BIT),
+     use_full_mipmap_chain(false)
+{
+    extent.depth  = 0;
+    extent.height = 0;
+    extent.width  = 0;
+}
+
+/* Please see header for specification */
+Anvil::RenderGraph::ResourceState::ResourceState()
+    :has_been_accessed(false),
+     last_write_queue (Anvil::RenderGraphQueue::GRAPHICS),
+     layout           (Anvil::ImageLayout::UNDEFINED)
+{
+    for (uint32_t n_queue = 0;
+                  n_queue < N_QUEUES;
+                ++n_queue)
+    {
+        last_access_batches[n_queue] = UINT32_MAX;
+    }
+}
+
+/* Please see header for specification */
+Anvil::RenderGraph::RenderGraph(Anvil::BaseDevice* in_device_ptr,
+                                bool               in_enable_async_compute,
+                                bool               in_enable_aliasing,
+                                uint32_t           in_n_executions_in_flight)
+    :m_device_ptr                            (in_device_ptr),
+     m_enable_aliasing                       (in_enable_aliasing),
+     m_execution_contexts                    (in_n_executions_in_flight),
+     m_is_baked                              (false),
+     m_n_culled_passes                       (0),
+     m_n_next_execution_context              (0),
+     m_n_pipeline_barriers                   (0),
+     m_n_previous_execution_context          (UINT32_MAX),
+     m_transient_memory_size                 (0),
+     m_transient_memory_size_without_aliasing(0)
+{
+    const uint32_t n_async_compute_queue = static_cast<uint32_t>(Anvil::RenderGraphQueue::ASYNC_COMPUTE);
+    const uint32_t n_graphics_queue      = static_cast<uint32_t>(Anvil::RenderGraphQueue::GRAPHICS);
+
+    m_queue_ptrs[n_graphics_queue]      = in_device_ptr->get_universal_queue(0);
+    m_queue_ptrs[n_async_compute_queue] = (in_enable_async_compute && in_device_ptr->get_n_compute_queues() > 0) ? in_device_ptr->get_compute_queue  (0)
+                                                                                                                 : m_queue_ptrs[n_graphics_queue];
+}
+
+/* Please see header for specification */
+Anvil::RenderGraph::~RenderGraph()
+{
+    /* Executions which are still in flight use the command buffers, semaphores and transient resources */
+    for (const auto& current_context : m_execution_contexts)
+    {
+        for (uint32_t n_queue = 0;
+                      n_queue < N_QUEUES;
+                    ++n_queue)
+        {
+            if (current_context.submission_tracking_values[n_queue] != 0)
+            {
+                m_queue_ptrs[n_queue]->wait_for_submission_tracking_value(current_context.submission_tracking_values[n_queue]);
+            }
+        }
+    }
+
+    /* Command buffers must be released before their pools, and resources before the memory they are bound to. */
+    for (auto& current_context : m_execution_contexts)
+    {
+        current_context.command_buffer_ptrs.clear();
+    }
+
+    m_execution_contexts.clear();
+    m_batches.clear           ();
+    m_resources.clear         ();
+    m_memory_heaps.clear      ();
+    m_semaphores.clear        ();
+}
+
+/** Makes batch @param in_consumer_n_batch wait for batch @param in_producer_n_batch, if the batches are executed
+ *  on different queues. Batches executed on the same queue are synchronized with pipeline barriers instead.
+ *
+ *  Only the most recent producer batch is waited on per queue, since semaphore signal operations also cover all
+ *  work submitted earlier to the same queue.
+ *
+ *  @param in_producer_n_batch Index of the batch to wait for. Must be smaller than @param in_consumer_n_batch.
+ *  @param in_consumer_n_batch Index of the batch to perform the wait.
+ *  @param in_wait_stage_mask  Stages of the consumer batch which should wait.
+ **/
+void Anvil::RenderGraph::add_batch_dependency(uint32_t                  in_producer_n_batch,
+                                              uint32_t                  in_consumer_n_batch,
+                                              Anvil::PipelineStageFlags in_wait_stage_mask)
+{
+    auto&          consumer_batch   = m_batches.at(in_consumer_n_batch);
+    const auto&    producer_batch   = m_batches.at(in_producer_n_batch);
+    const uint32_t n_producer_queue = static_cast<uint32_t>(producer_batch.queue);
+
+    anvil_assert(in_producer_n_batch < in_consumer_n_batch);
+
+    if (producer_batch.queue == consumer_batch.queue)
+    {
+        return;
+    }
+
+    if (consumer_batch.wait_producer_batches[n_producer_queue] == UINT32_MAX                ||
+        consumer_batch.wait_producer_batches[n_producer_queue] <  in_producer_n_batch)
+    {
+        consumer_batch.wait_producer_batches[n_producer_queue] = in_producer_n_batch;
+    }
+
+    consumer_batch.wait_producer_stage_masks[n_producer_queue] |= in_wait_stage_mask;
+}
+
+/* Please see header for specification */
+Anvil::RenderGraphPassID Anvil::RenderGraph::add_pass(const std::string&        in_name,
+                                                      RenderGraphQueue          in_queue,
+                                                      RenderGraphRecordFunction in_record_function,
+                                                      bool                      in_has_side_effects)
+{
+    Pass new_pass;
+
+    anvil_assert(!m_is_baked);
+    anvil_assert(in_queue           != RenderGraphQueue::COUNT);
+    anvil_assert(in_record_function != nullptr);
+
+    new_pass.has_side_effects = in_has_side_effects;
+    new_pass.is_live          = false;
+    new_pass.n_batch          = UINT32_MAX;
+    new_pass.name             = in_name;
+    new_pass.queue            = in_queue;
+    new_pass.record_function  = std::move(in_record_function);
+
+    m_passes.push_back(std::move(new_pass) );
+
+    return static_cast<RenderGraphPassID>(m_passes.size() - 1);
+}
+
+/* Please see header for specification */
+void Anvil::RenderGraph::add_resource_access(RenderGraphPassID     in_pass_id,
+                                             RenderGraphResourceID in_resource_id,
+                                             RenderGraphAccess     in_access)
+{
+    AccessProperties access_props;
+    PassAccess       new_access;
+
+    anvil_assert(!m_is_baked);
+    anvil_assert(in_pass_id     < m_passes.size   () );
+    anvil_assert(in_resource_id < m_resources.size() );
+
+    auto&       pass     = m_passes.at   (in_pass_id);
+    const auto& resource = m_resources.at(in_resource_id);
+
+    for (const auto& current_access : pass.accesses)
+    {
+        if (current_access.resource_id == in_resource_id)
+        {
+            /* Only one access can be declared per resource per pass */
+            anvil_assert(current_access.resource_id != in_resource_id);
+
+            return;
+        }
+    }
+
+    access_props = get_access_properties(in_access,
+                                         pass.queue);
+
+    if ((resource.type == ResourceType::BUFFER && access_props.buffer_usage == 0) ||
+        (resource.type == ResourceType::IMAGE  && access_props.image_usage  == 0) )
+    {
+        /* The access is not applicable to the resource type */
+        anvil_assert_fail();
+
+        return;
+    }
+
+    if (pass.queue == RenderGraphQueue::ASYNC_COMPUTE)
+    {
+        const Anvil::PipelineStageFlags compute_stages = Anvil::PipelineStageFlagBits::COMPUTE_SHADER_BIT |
+                                                         Anvil::PipelineStageFlagBits::DRAW_INDIRECT_BIT  |
+                                                         Anvil::PipelineStageFlagBits::TRANSFER_BIT;
+
+        if ((access_props.stage_mask & ~compute_stages) != 0)
+        {
+            /* The access is not supported by compute queues */
+            anvil_assert_fail();
+
+            return;
+        }
+    }
+
+    new_access.access      = in_access;
+    new_access.layout      = access_props.layout;
+    new_access.resource_id = in_resource_id;
+
+    if ( resource.type == ResourceType::IMAGE                                                               &&
+        (in_access     == RenderGraphAccess::INPUT_ATTACHMENT_READ || in_access == RenderGraphAccess::SAMPLED_READ) &&
+        (Anvil::Formats::has_depth_aspect(resource.format) || Anvil::Formats::has_stencil_aspect(resource.format) ))
+    {
+        new_access.layout = Anvil::ImageLayout::DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    }
+
+    pass.accesses.push_back(new_access);
+}
+
+/* Please see header for specification */
+Anvil::RenderGraphResourceID Anvil::RenderGraph::add_transient_buffer(VkDeviceSize in_size)
+{
+    Resource new_resource;
+
+    anvil_assert(!m_is_baked);
+    anvil_assert(in_size > 0);
+
+    new_resource.size = in_size;
+    new_resource.type = ResourceType::BUFFER;
+
+    m_resources.push_back(std::move(new_resource) );
+
+    return static_cast<RenderGraphResourceID>(m_resources.size() - 1);
+}
+
+/* Please see header for specification */
+Anvil::RenderGraphResourceID Anvil::RenderGraph::add_transient_image(Anvil::ImageType           in_type,
+                                                                     Anvil::Format              in_format,
+                                                                     uint32_t                   in_width,
+                                                                     uint32_t                   in_height,
+                                                                     uint32_t                   in_depth,
+                                                                     uint32_t                   in_n_layers,
+                                                                     Anvil::SampleCountFlagBits in_sample_count,
+                                                                     bool                       in_use_full_mipmap_chain)
+{
+    Resource new_resource;
+
+    anvil_assert(!m_is_baked);
+    anvil_assert(in_width    > 0);
+    anvil_assert(in_height   > 0);
+    anvil_assert(in_depth    > 0);
+    anvil_assert(in_n_layers > 0);
+
+    new_resource.extent.depth          = in_depth;
+    new_resource.extent.height         = in_height;
+    new_resource.extent.width          = in_width;
+    new_resource.format                = in_format;
+    new_resource.image_type            = in_type;
+    new_resource.n_layers              = in_n_layers;
+    new_resource.sample_count          = in_sample_count;
+    new_resource.type                  = ResourceType::IMAGE;
+    new_resource.use_full_mipmap_chain = in_use_full_mipmap_chain;
+
+    m_resources.push_back(std::move(new_resource) );
+
+    return static_cast<RenderGraphResourceID>(m_resources.size() - 1);
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::bake()
+{
+    bool result = false;
+
+    anvil_assert(!m_is_baked);
+
+    cull_passes ();
+    form_batches();
+
+    if (!create_transient_resources() )
+    {
+        goto end;
+    }
+
+    compute_barriers();
+
+    if (!create_semaphores() )
+    {
+        goto end;
+    }
+
+    for (auto& current_context : m_execution_contexts)
+    {
+        for (const auto& current_batch : m_batches)
+        {
+            auto new_command_buffer_ptr = current_context.command_pool_ptrs[static_cast<uint32_t>(current_batch.queue)]->alloc_primary_level_command_buffer();
+
+            if (new_command_buffer_ptr == nullptr)
+            {
+                anvil_assert(new_command_buffer_ptr != nullptr);
+
+                goto end;
+            }
+
+            current_context.command_buffer_ptrs.push_back(std::move(new_command_buffer_ptr) );
+        }
+    }
+
+    m_is_baked = true;
+    result     = true;
+
+end:
+    return result;
+}
+
+/** Walks live passes in execution order, tracks the state of each resource, and derives pipeline barriers and
+ *  cross-queue batch dependencies from the hazards found. Also schedules final layout transitions of imported
+ *  images, and makes the last batch wait for all other queues.
+ **/
+void Anvil::RenderGraph::compute_barriers()
+{
+    std::vector<ResourceState> states(m_resources.size() );
+
+    m_n_pipeline_barriers = 0;
+
+    for (uint32_t n_batch = 0;
+                  n_batch < static_cast<uint32_t>(m_batches.size() );
+                ++n_batch)
+    {
+        const RenderGraphQueue batch_queue = m_batches.at(n_batch).queue;
+        const uint32_t         n_queue     = static_cast<uint32_t>(batch_queue);
+
+        for (const auto current_pass_id : m_batches.at(n_batch).pass_ids)
+        {
+            auto& pass = m_passes.at(current_pass_id);
+
+            for (const auto& current_access : pass.accesses)
+            {
+                const AccessProperties    access_props                 = get_access_properties(current_access.access,
+                                                                                               pass.queue);
+                bool                      has_cross_queue_dependencies = false;
+                bool                      is_barrier_needed            = false;
+                bool                      is_tracked_as_write          = access_props.is_write;
+                auto&                     resource                     = m_resources.at(current_access.resource_id);
+                auto&                     state                        = states.at     (current_access.resource_id);
+                const bool                is_image                     = (resource.type == ResourceType::IMAGE);
+                Anvil::ImageLayout        old_layout                   = state.layout;
+                Anvil::AccessFlags        src_access_mask;
+                Anvil::PipelineStageFlags src_stage_mask;
+
+                if (!state.has_been_accessed)
+                {
+                    if (resource.is_imported)
+                    {
+                        /* Nothing is known about prior accesses, so synchronize against all prior work. Batches
+                         * executed on the other queue must also wait for the external wait semaphores. */
+                        if (m_batches.at(0).queue != batch_queue)
+                        {
+                            add_batch_dependency(0, /* in_producer_n_batch */
+                                                 n_batch,
+                                                 access_props.stage_mask);
+
+                            has_cross_queue_dependencies = true;
+                        }
+
+                        is_barrier_needed = true;
+                        old_layout        = resource.initial_layout;
+                        src_access_mask   = Anvil::AccessFlagBits::MEMORY_WRITE_BIT;
+                        src_stage_mask    = Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT;
+                    }
+                    else
+                    {
+                        /* The memory may have been used by other transient resources earlier on. Synchronize
+                         * against their last accesses. */
+                        for (const auto current_predecessor_id : resource.alias_predecessor_ids)
+                        {
+                            const auto& predecessor_state = states.at(current_predecessor_id);
+
+                            for (uint32_t n_predecessor_queue = 0;
+                                          n_predecessor_queue < N_QUEUES;
+                                        ++n_predecessor_queue)
+                            {
+                                if (predecessor_state.last_access_batches[n_predecessor_queue] == UINT32_MAX)
+                                {
+                                    continue;
+                                }
+
+                                if (n_predecessor_queue == n_queue)
+                                {
+                                    src_stage_mask |= predecessor_state.last_access_stage_masks[n_predecessor_queue];
+                                }
+                                else
+                                {
+                                    add_batch_dependency(predecessor_state.last_access_batches[n_predecessor_queue],
+                                                         n_batch,
+                                                         access_props.stage_mask);
+
+                                    has_cross_queue_dependencies = true;
+                                }
+                            }
+
+                            if (predecessor_state.has_been_accessed           &&
+                                predecessor_state.last_write_queue == batch_queue)
+                            {
+                                src_access_mask |= predecessor_state.last_write_access_mask;
+                            }
+                        }
+
+                        /* The previous execution of the graph may still be accessing the memory on the GPU. The
+                         * first batch of this execution is ordered after it, so synchronize against all prior work
+                         * and, on the other queue, against the first batch. */
+                        if (m_execution_contexts.size() > 1)
+                        {
+                            if (m_batches.at(0).queue != batch_queue)
+                            {
+                                add_batch_dependency(0, /* in_producer_n_batch */
+                                                     n_batch,
+                                                     access_props.stage_mask);
+
+                                has_cross_queue_dependencies = true;
+                            }
+
+                            src_access_mask |= Anvil::AccessFlagBits::MEMORY_WRITE_BIT;
+                            src_stage_mask  |= Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT;
+                        }
+
+                        is_barrier_needed = is_image || (src_stage_mask != 0);
+                        old_layout        = Anvil::ImageLayout::UNDEFINED;
+                    }
+
+                    /* Later accesses need to synchronize against the initial barrier */
+                    is_tracked_as_write = true;
+                }
+                else
+                {
+                    const bool needs_layout_transition = is_image && (state.layout != current_access.layout);
+
+                    if (needs_layout_transition || access_props.is_write)
+                    {
+                        /* WAR, WAW, or a layout transition: wait for all accesses since the last write */
+                        for (uint32_t n_prior_queue = 0;
+                                      n_prior_queue < N_QUEUES;
+                                    ++n_prior_queue)
+                        {
+                            if (state.last_access_batches[n_prior_queue] == UINT32_MAX)
+                            {
+                                continue;
+                            }
+
+                            if (n_prior_queue == n_queue)
+                            {
+                                src_stage_mask |= state.last_access_stage_masks[n_prior_queue];
+                            }
+                            else
+                            {
+                                add_batch_dependency(state.last_access_batches[n_prior_queue],
+                                                     n_batch,
+                                                     access_props.stage_mask);
+
+                                has_cross_queue_dependencies = true;
+                            }
+                        }
+
+                        if (state.last_write_queue == batch_queue)
+                        {
+                            src_access_mask = state.last_write_access_mask;
+                        }
+
+                        is_barrier_needed   = needs_layout_transition || (src_stage_mask != 0);
+                        is_tracked_as_write = true;
+                    }
+                    else
+                    if (state.last_write_queue == batch_queue)
+                    {
+                        /* RAW on the same queue. Skip the barrier if the write has already been made visible. */
+                        if ((access_props.stage_mask  & ~state.visible_stage_mask)  != 0 ||
+                            (access_props.access_mask & ~state.visible_access_mask) != 0)
+                        {
+                            is_barrier_needed = true;
+                            src_access_mask   = state.last_write_access_mask;
+                            src_stage_mask    = state.last_write_stage_mask;
+                        }
+                    }
+                    else
+                    {
+                        /* RAW across queues. The semaphore wait makes the write visible. */
+                        add_batch_dependency(state.last_access_batches[static_cast<uint32_t>(state.last_write_queue)],
+                                             n_batch,
+                                             access_props.stage_mask);
+                    }
+                }
+
+                if (is_barrier_needed)
+                {
+                    /* Chain the barrier with any semaphore waits added above */
+                    if (has_cross_queue_dependencies)
+                    {
+                        src_stage_mask |= access_props.stage_mask;
+                    }
+
+                    if (src_stage_mask == 0)
+                    {
+                        src_stage_mask = Anvil::PipelineStageFlagBits::TOP_OF_PIPE_BIT;
+                    }
+
+                    pass.pre_barriers.dst_stage_mask |= access_props.stage_mask;
+                    pass.pre_barriers.src_stage_mask |= src_stage_mask;
+
+                    if ((is_image && old_layout != current_access.layout) ||
+                        src_access_mask != 0)
+                    {
+                        BarrierInfo new_barrier;
+
+                        new_barrier.dst_access_mask = access_props.access_mask;
+                        new_barrier.new_layout      = (is_image) ? current_access.layout : Anvil::ImageLayout::UNKNOWN;
+                        new_barrier.old_layout      = (is_image) ? old_layout            : Anvil::ImageLayout::UNKNOWN;
+                        new_barrier.resource_id     = current_access.resource_id;
+                        new_barrier.src_access_mask = src_access_mask;
+
+                        pass.pre_barriers.barriers.push_back(new_barrier);
+                    }
+                }
+
+                /* Update the resource state */
+                if (is_tracked_as_write)
+                {
+                    for (uint32_t n_prior_queue = 0;
+                                  n_prior_queue < N_QUEUES;
+                                ++n_prior_queue)
+                    {
+                        state.last_access_batches    [n_prior_queue] = UINT32_MAX;
+                        state.last_access_stage_masks[n_prior_queue] = Anvil::PipelineStageFlags();
+                    }
+
+                    state.last_write_access_mask = (access_props.is_write) ? access_props.access_mask : Anvil::AccessFlags();
+                    state.last_write_queue       = batch_queue;
+                    state.last_write_stage_mask  = access_props.stage_mask;
+                    state.visible_access_mask    = (access_props.is_write) ? Anvil::AccessFlags()        : access_props.access_mask;
+                    state.visible_stage_mask     = (access_props.is_write) ? Anvil::PipelineStageFlags() : access_props.stage_mask;
+                }
+                else
+                if (is_barrier_needed)
+                {
+                    state.visible_access_mask |= access_props.access_mask;
+                    state.visible_stage_mask  |= access_props.stage_mask;
+                }
+
+                state.has_been_accessed                 = true;
+                state.last_access_batches    [n_queue]  = n_batch;
+                state.last_access_stage_masks[n_queue] |= access_props.stage_mask;
+
+                if (is_image)
+                {
+                    state.layout = current_access.layout;
+                }
+            }
+
+            if (pass.pre_barriers.dst_stage_mask != 0)
+            {
+                ++m_n_pipeline_barriers;
+            }
+        }
+    }
+
+    if (!m_batches.empty() )
+    {
+        const uint32_t n_last_batch       = static_cast<uint32_t>(m_batches.size() - 1);
+        auto&          last_batch         = m_batches.back();
+        const uint32_t n_last_batch_queue = static_cast<uint32_t>(last_batch.queue);
+
+        /* The last batch signals the fence & semaphores, so it must not complete before other queues do */
+        for (uint32_t n_queue = 0;
+                      n_queue < N_QUEUES;
+                    ++n_queue)
+        {
+            if (n_queue == n_last_batch_queue)
+            {
+                continue;
+            }
+
+            for (uint32_t n_batch = n_last_batch;
+                          n_batch > 0;
+                        --n_batch)
+            {
+                if (static_cast<uint32_t>(m_batches.at(n_batch - 1).queue) == n_queue)
+                {
+                    add_batch_dependency(n_batch - 1,
+                                         n_last_batch,
+                                         Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT);
+
+                    break;
+                }
+            }
+        }
+
+        /* Transition imported images to their final layouts */
+        for (uint32_t n_resource = 0;
+                      n_resource < static_cast<uint32_t>(m_resources.size() );
+                    ++n_resource)
+        {
+            const auto&               resource = m_resources.at(n_resource);
+            const auto&               state    = states.at     (n_resource);
+            BarrierInfo               new_barrier;
+            Anvil::PipelineStageFlags src_stage_mask;
+
+            if (!resource.is_imported                                    ||
+                 resource.type         != ResourceType::IMAGE            ||
+                 resource.final_layout == Anvil::ImageLayout::UNKNOWN    ||
+                !state.has_been_accessed                                 ||
+                 state.layout          == resource.final_layout)
+            {
+                continue;
+            }
+
+            for (uint32_t n_queue = 0;
+                          n_queue < N_QUEUES;
+                        ++n_queue)
+            {
+                if (state.last_access_batches[n_queue] == UINT32_MAX)
+                {
+                    continue;
+                }
+
+                /* Accesses made on other queues are covered by the dependencies added above */
+                src_stage_mask |= (n_queue == n_last_batch_queue) ? state.last_access_stage_masks[n_queue]
+                                                                  : Anvil::PipelineStageFlags(Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT);
+            }
+
+            new_barrier.dst_access_mask = Anvil::AccessFlags();
+            new_barrier.new_layout      = resource.final_layout;
+            new_barrier.old_layout      = state.layout;
+            new_barrier.resource_id     = n_resource;
+            new_barrier.src_access_mask = (static_cast<uint32_t>(state.last_write_queue) == n_last_batch_queue) ? state.last_write_access_mask
+                                                                                                                : Anvil::AccessFlags();
+
+            last_batch.post_barriers.barriers.push_back(new_barrier);
+
+            last_batch.post_barriers.dst_stage_mask |= Anvil::PipelineStageFlagBits::BOTTOM_OF_PIPE_BIT;
+            last_batch.post_barriers.src_stage_mask |= src_stage_mask;
+        }
+
+        if (last_batch.post_barriers.dst_stage_mask != 0)
+        {
+            ++m_n_pipeline_barriers;
+        }
+    }
+}
+
+/* Please see header for specification */
+Anvil::RenderGraphUniquePtr Anvil::RenderGraph::create(Anvil::BaseDevice* in_device_ptr,
+                                                       bool               in_enable_async_compute,
+                                                       bool               in_enable_aliasing,
+                                                       uint32_t           in_n_executions_in_flight)
+{
+    Anvil::RenderGraphUniquePtr result_ptr(nullptr,
+                                           std::default_delete<Anvil::RenderGraph>() );
+
+    anvil_assert(in_device_ptr != nullptr);
+
+    if (in_device_ptr->get_type() != Anvil::DeviceType::SINGLE_GPU)
+    {
+        anvil_assert(in_device_ptr->get_type() == Anvil::DeviceType::SINGLE_GPU);
+
+        goto end;
+    }
+
+    if (in_n_executions_in_flight == 0)
+    {
+        anvil_assert(in_n_executions_in_flight != 0);
+
+        goto end;
+    }
+
+    result_ptr.reset(
+        new Anvil::RenderGraph(in_device_ptr,
+                               in_enable_async_compute,
+                               in_enable_aliasing,
+                               in_n_executions_in_flight)
+    );
+
+    /* Create one command pool per queue family for each execution context, so that command buffers of an execution
+     * can be reset while other executions are in flight. */
+    for (auto& current_context : result_ptr->m_execution_contexts)
+    {
+        for (uint32_t n_queue = 0;
+                      n_queue < N_QUEUES;
+                    ++n_queue)
+        {
+            const uint32_t queue_family_index = result_ptr->m_queue_ptrs[n_queue]->get_queue_family_index();
+
+            for (uint32_t n_prior_queue = 0;
+                          n_prior_queue < n_queue;
+                        ++n_prior_queue)
+            {
+                if (result_ptr->m_queue_ptrs[n_prior_queue]->get_queue_family_index() == queue_family_index)
+                {
+                    current_context.command_pool_ptrs[n_queue] = current_context.command_pool_ptrs[n_prior_queue];
+
+                    break;
+                }
+            }
+
+            if (current_context.command_pool_ptrs[n_queue] == nullptr)
+            {
+                auto new_command_pool_ptr = Anvil::CommandPool::create(in_device_ptr,
+                                                                       Anvil::CommandPoolCreateFlagBits::NONE,
+                                                                       queue_family_index);
+
+                if (new_command_pool_ptr == nullptr)
+                {
+                    anvil_assert(new_command_pool_ptr != nullptr);
+
+                    result_ptr.reset();
+
+                    goto end;
+                }
+
+                current_context.command_pool_ptrs[n_queue] = new_command_pool_ptr.get();
+
+                current_context.command_pools.push_back(std::move(new_command_pool_ptr) );
+            }
+        }
+    }
+
+end:
+    return result_ptr;
+}
+
+/** Creates semaphores for all cross-queue batch dependencies, one set per execution context.
+ *
+ *  If more than one execution can be in flight and the first and the last batch are executed on different queues,
+ *  also creates semaphores used to order the first batch of an execution after the last batch of the preceding one.
+ **/
+bool Anvil::RenderGraph::create_semaphores()
+{
+    const bool is_chained = (m_execution_contexts.size() > 1                  &&
+                             !m_batches.empty()                               &&
+                             m_batches.front().queue != m_batches.back().queue);
+    bool       result     = false;
+
+    for (uint32_t n_consumer_batch = 0;
+                  n_consumer_batch < static_cast<uint32_t>(m_batches.size() );
+                ++n_consumer_batch)
+    {
+        auto& consumer_batch = m_batches.at(n_consumer_batch);
+
+        for (uint32_t n_producer_queue = 0;
+                      n_producer_queue < N_QUEUES;
+                    ++n_producer_queue)
+        {
+            if (consumer_batch.wait_producer_batches[n_producer_queue] != UINT32_MAX)
+            {
+                consumer_batch.wait_stage_masks.push_back(consumer_batch.wait_producer_stage_masks[n_producer_queue]);
+            }
+        }
+    }
+
+    for (auto& current_context : m_execution_contexts)
+    {
+        current_context.signal_semaphore_ptrs.resize(m_batches.size() );
+        current_context.wait_semaphore_ptrs.resize  (m_batches.size() );
+
+        for (uint32_t n_consumer_batch = 0;
+                      n_consumer_batch < static_cast<uint32_t>(m_batches.size() );
+                    ++n_consumer_batch)
+        {
+            const auto& consumer_batch = m_batches.at(n_consumer_batch);
+
+            for (uint32_t n_producer_queue = 0;
+                          n_producer_queue < N_QUEUES;
+                        ++n_producer_queue)
+            {
+                const uint32_t n_producer_batch = consumer_batch.wait_producer_batches[n_producer_queue];
+
+                if (n_producer_batch == UINT32_MAX)
+                {
+                    continue;
+                }
+
+                auto new_semaphore_ptr = Anvil::Semaphore::create(Anvil::SemaphoreCreateInfo::create(m_device_ptr) );
+
+                if (new_semaphore_ptr == nullptr)
+                {
+                    anvil_assert(new_semaphore_ptr != nullptr);
+
+                    goto end;
+                }
+
+                current_context.signal_semaphore_ptrs.at(n_producer_batch).push_back(new_semaphore_ptr.get() );
+                current_context.wait_semaphore_ptrs.at  (n_consumer_batch).push_back(new_semaphore_ptr.get() );
+
+                m_semaphores.push_back(std::move(new_semaphore_ptr) );
+            }
+        }
+
+        if (is_chained)
+        {
+            current_context.execution_semaphore_ptr = Anvil::Semaphore::create(Anvil::SemaphoreCreateInfo::create(m_device_ptr) );
+
+            if (current_context.execution_semaphore_ptr == nullptr)
+            {
+                anvil_assert(current_context.execution_semaphore_ptr != nullptr);
+
+                goto end;
+            }
+        }
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/** Infers usage flags of transient resources, creates them, places them in memory heaps and binds memory.
+ *
+ *  Resources are placed largest-first. Each resource is assigned the lowest offset in its heap, which does not
+ *  overlap with any resource already placed whose lifetime overlaps with the resource's lifetime. Resources whose
+ *  memory ranges overlap become alias predecessors of resources used later on.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::RenderGraph::create_transient_resources()
+{
+    typedef struct
+    {
+        std::vector<RenderGraphResourceID> resource_ids;
+        uint32_t                           memory_type_bits;
+        VkDeviceSize                       size;
+        ResourceType                       type;
+    } HeapInfo;
+
+    std::vector<HeapInfo>         heaps;
+    const bool                    is_async_compute_used = (m_queue_ptrs[static_cast<uint32_t>(RenderGraphQueue::ASYNC_COMPUTE)] != m_queue_ptrs[static_cast<uint32_t>(RenderGraphQueue::GRAPHICS)]);
+    const Anvil::QueueFamilyFlags queue_families        = (is_async_compute_used) ? Anvil::QueueFamilyFlags(Anvil::QueueFamilyFlagBits::COMPUTE_BIT | Anvil::QueueFamilyFlagBits::GRAPHICS_BIT)
+                                                                                  : Anvil::QueueFamilyFlags(Anvil::QueueFamilyFlagBits::GRAPHICS_BIT);
+    bool                          result                = false;
+    const Anvil::SharingMode      sharing_mode          = (is_async_compute_used) ? Anvil::SharingMode::CONCURRENT
+                                                                                  : Anvil::SharingMode::EXCLUSIVE;
+
+    m_transient_memory_size                  = 0;
+    m_transient_memory_size_without_aliasing = 0;
+
+    for (const auto& current_pass : m_passes)
+    {
+        if (!current_pass.is_live)
+        {
+            continue;
+        }
+
+        for (const auto& current_access : current_pass.accesses)
+        {
+            const AccessProperties access_props = get_access_properties(current_access.access,
+                                                                        current_pass.queue);
+            auto&                  resource     = m_resources.at(current_access.resource_id);
+
+            resource.buffer_usage |= access_props.buffer_usage;
+            resource.image_usage  |= access_props.image_usage;
+        }
+    }
+
+    /* Create the resources and sort them into heaps */
+    for (uint32_t n_resource = 0;
+                  n_resource < static_cast<uint32_t>(m_resources.size() );
+                ++n_resource)
+    {
+        auto& resource = m_resources.at(n_resource);
+
+        if (resource.is_imported                    ||
+            resource.first_live_pass == UINT32_MAX)
+        {
+            continue;
+        }
+
+        if (resource.type == ResourceType::BUFFER)
+        {
+            auto create_info_ptr = Anvil::BufferCreateInfo::create_no_alloc(m_device_ptr,
+                                                                            resource.size,
+                                                                            queue_families,
+                                                                            sharing_mode,
+                                                                            Anvil::BufferCreateFlagBits::NONE,
+                                                                            resource.buffer_usage);
+
+            resource.owned_buffer_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
+
+            if (resource.owned_buffer_ptr == nullptr)
+            {
+                anvil_assert(resource.owned_buffer_ptr != nullptr);
+
+                goto end;
+            }
+
+            const VkMemoryRequirements memory_reqs = resource.owned_buffer_ptr->get_memory_requirements();
+
+            resource.buffer_ptr       = resource.owned_buffer_ptr.get();
+            resource.memory_alignment = memory_reqs.alignment;
+            resource.memory_size      = memory_reqs.size;
+            resource.memory_type_bits = memory_reqs.memoryTypeBits;
+        }
+        else
+        {
+            auto create_info_ptr = Anvil::ImageCreateInfo::create_no_alloc(m_device_ptr,
+                                                                           resource.image_type,
+                                                                           resource.format,
+                                                                           Anvil::ImageTiling::OPTIMAL,
+                                                                           resource.image_usage,
+                                                                           resource.extent.width,
+                                                                           resource.extent.height,
+                                                                           resource.extent.depth,
+                                                                           resource.n_layers,
+                                                                           resource.sample_count,
+                                                                           queue_families,
+                                                                           sharing_mode,
+                                                                           resource.use_full_mipmap_chain,
+                                                                           Anvil::ImageCreateFlagBits::NONE);
+
+            resource.owned_image_ptr = Anvil::Image::create(std::move(create_info_ptr) );
+
+            if (resource.owned_image_ptr == nullptr)
+            {
+                anvil_assert(resource.owned_image_ptr != nullptr);
+
+                goto end;
+            }
+
+            resource.image_ptr        = resource.owned_image_ptr.get();
+            resource.memory_alignment = resource.image_ptr->get_image_alignment   (0);
+            resource.memory_size      = resource.image_ptr->get_image_storage_size(0);
+            resource.memory_type_bits = resource.image_ptr->get_image_memory_types(0);
+        }
+
+        m_transient_memory_size_without_aliasing += resource.memory_size;
+
+        for (uint32_t n_heap = 0;
+                      n_heap < static_cast<uint32_t>(heaps.size() );
+                    ++n_heap)
+        {
+            if (heaps.at(n_heap).memory_type_bits == resource.memory_type_bits &&
+                heaps.at(n_heap).type             == resource.type)
+            {
+                resource.memory_heap_index = n_heap;
+
+                break;
+            }
+        }
+
+        if (resource.memory_heap_index == UINT32_MAX)
+        {
+            HeapInfo new_heap;
+
+            new_heap.memory_type_bits = resource.memory_type_bits;
+            new_heap.size             = 0;
+            new_heap.type             = resource.type;
+
+            resource.memory_heap_index = static_cast<uint32_t>(heaps.size() );
+
+            heaps.push_back(new_heap);
+        }
+
+        heaps.at(resource.memory_heap_index).resource_ids.push_back(n_resource);
+    }
+
+    for (auto& current_heap : heaps)
+    {
+        std::vector<RenderGraphResourceID>                  placed_resource_ids;
+        std::vector<std::pair<VkDeviceSize, VkDeviceSize> > occupied_ranges;
+        std::vector<RenderGraphResourceID>                  sorted_resource_ids(current_heap.resource_ids);
+
+        std::stable_sort(sorted_resource_ids.begin(),
+                         sorted_resource_ids.end  (),
+                         [this](RenderGraphResourceID in_resource_id1,
+                                RenderGraphResourceID in_resource_id2)
+                         {
+                             return m_resources.at(in_resource_id1).memory_size > m_resources.at(in_resource_id2).memory_size;
+                         });
+
+        for (const auto current_resource_id : sorted_resource_ids)
+        {
+            auto&        resource = m_resources.at(current_resource_id);
+            VkDeviceSize offset   = 0;
+
+            occupied_ranges.clear();
+
+            for (const auto current_placed_resource_id : placed_resource_ids)
+            {
+                const auto& placed_resource   = m_resources.at(current_placed_resource_id);
+                const bool  lifetimes_overlap = !m_enable_aliasing                                          ||
+                                                !(placed_resource.last_live_pass < resource.first_live_pass ||
+                                                  resource.last_live_pass        < placed_resource.first_live_pass);
+
+                if (lifetimes_overlap)
+                {
+                    occupied_ranges.push_back(std::make_pair(placed_resource.memory_offset,
+                                                             placed_resource.memory_offset + placed_resource.memory_size) );
+                }
+            }
+
+            std::sort(occupied_ranges.begin(),
+                      occupied_ranges.end  () );
+
+            for (const auto& current_range : occupied_ranges)
+            {
+                if (offset + resource.memory_size <= current_range.first)
+                {
+                    break;
+                }
+
+                offset = std::max(offset,
+                                  Anvil::Utils::round_up(current_range.second,
+                                                         resource.memory_alignment) );
+            }
+
+            resource.memory_offset = offset;
+            current_heap.size      = std::max(current_heap.size,
+                                              offset + resource.memory_size);
+
+            placed_resource_ids.push_back(current_resource_id);
+        }
+
+        /* Resources whose memory ranges overlap have disjoint lifetimes. The one used later needs to synchronize
+         * against the one used earlier. */
+        for (uint32_t n_resource1 = 0;
+                      n_resource1 < static_cast<uint32_t>(current_heap.resource_ids.size() );
+                    ++n_resource1)
+        {
+            for (uint32_t n_resource2 = n_resource1 + 1;
+                          n_resource2 < static_cast<uint32_t>(current_heap.resource_ids.size() );
+                        ++n_resource2)
+            {
+                const RenderGraphResourceID resource_id1 = current_heap.resource_ids.at(n_resource1);
+                const RenderGraphResourceID resource_id2 = current_heap.resource_ids.at(n_resource2);
+                auto&                       resource1    = m_resources.at(resource_id1);
+                auto&                       resource2    = m_resources.at(resource_id2);
+
+                if (resource1.memory_offset >= resource2.memory_offset + resource2.memory_size ||
+                    resource2.memory_offset >= resource1.memory_offset + resource1.memory_size)
+                {
+                    continue;
+                }
+
+                anvil_assert(resource1.last_live_pass < resource2.first_live_pass ||
+                             resource2.last_live_pass < resource1.first_live_pass);
+
+                if (resource1.last_live_pass < resource2.first_live_pass)
+                {
+                    resource2.alias_predecessor_ids.push_back(resource_id1);
+                }
+                else
+                {
+                    resource1.alias_predecessor_ids.push_back(resource_id2);
+                }
+            }
+        }
+    }
+
+    /* Allocate the heaps and bind resources to their regions */
+    for (const auto& current_heap : heaps)
+    {
+        auto heap_memory_block_ptr = Anvil::MemoryBlock::create(
+            Anvil::MemoryBlockCreateInfo::create_regular(m_device_ptr,
+                                                         current_heap.memory_type_bits,
+                                                         current_heap.size,
+                                                         Anvil::MemoryFeatureFlagBits::DEVICE_LOCAL_BIT)
+        );
+
+        if (heap_memory_block_ptr == nullptr)
+        {
+            anvil_assert(heap_memory_block_ptr != nullptr);
+
+            goto end;
+        }
+
+        for (const auto current_resource_id : current_heap.resource_ids)
+        {
+            auto& resource               = m_resources.at(current_resource_id);
+            auto  derived_memory_block_ptr = Anvil::MemoryBlock::create(
+                Anvil::MemoryBlockCreateInfo::create_derived(heap_memory_block_ptr.get(),
+                                                             resource.memory_offset,
+                                                             resource.memory_size)
+            );
+            bool  is_bound;
+
+            if (derived_memory_block_ptr == nullptr)
+            {
+                anvil_assert(derived_memory_block_ptr != nullptr);
+
+                goto end;
+            }
+
+            is_bound = (resource.type == ResourceType::BUFFER) ? resource.buffer_ptr->set_nonsparse_memory(std::move(derived_memory_block_ptr) )
+                                                               : resource.image_ptr->set_memory          (std::move(derived_memory_block_ptr) );
+
+            if (!is_bound)
+            {
+                anvil_assert(is_bound);
+
+                goto end;
+            }
+        }
+
+        m_transient_memory_size += current_heap.size;
+
+        m_memory_heaps.push_back(std::move(heap_memory_block_ptr) );
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/** Marks passes which contribute to the graph's results as live. Passes are walked in reverse order, tracking
+ *  which resources hold contents consumed later on. Contents of imported resources are consumed at the end of
+ *  the execution.
+ **/
+void Anvil::RenderGraph::cull_passes()
+{
+    std::vector<bool> is_resource_needed(m_resources.size() );
+
+    for (uint32_t n_resource = 0;
+                  n_resource < static_cast<uint32_t>(m_resources.size() );
+                ++n_resource)
+    {
+        is_resource_needed.at(n_resource) = m_resources.at(n_resource).is_imported;
+    }
+
+    m_n_culled_passes = 0;
+
+    for (uint32_t n_pass = static_cast<uint32_t>(m_passes.size() );
+                  n_pass > 0;
+                --n_pass)
+    {
+        auto& pass = m_passes.at(n_pass - 1);
+
+        pass.is_live = pass.has_side_effects;
+
+        for (const auto& current_access : pass.accesses)
+        {
+            if (get_access_properties(current_access.access, pass.queue).is_write &&
+                is_resource_needed.at(current_access.resource_id) )
+            {
+                pass.is_live = true;
+            }
+        }
+
+        if (!pass.is_live)
+        {
+            ++m_n_culled_passes;
+
+            continue;
+        }
+
+        /* Write-only accesses overwrite the contents, so earlier contents are no longer needed.. */
+        for (const auto& current_access : pass.accesses)
+        {
+            const AccessProperties access_props = get_access_properties(current_access.access,
+                                                                        pass.queue);
+
+            if (access_props.is_write && !access_props.is_read)
+            {
+                is_resource_needed.at(current_access.resource_id) = false;
+            }
+        }
+
+        /* ..unless they are read by the pass. */
+        for (const auto& current_access : pass.accesses)
+        {
+            if (get_access_properties(current_access.access, pass.queue).is_read)
+            {
+                is_resource_needed.at(current_access.resource_id) = true;
+            }
+        }
+    }
+}
+
+/* Please see header for specification */
+bool Anvil::RenderGraph::execute(uint32_t                         in_n_wait_semaphores,
+                                 Anvil::Semaphore* const*         in_opt_wait_semaphore_ptrs,
+                                 const Anvil::PipelineStageFlags* in_opt_wait_stage_masks_ptr,
+                                 uint32_t                         in_n_signal_semaphores,
+                                 Anvil::Semaphore* const*         in_opt_signal_semaphore_ptrs,
+                                 Anvil::Fence*                    in_opt_fence_ptr)
+{
+    uint32_t n_context = 0;
+    bool     result    = false;
+
+    anvil_assert(m_is_baked);
+    anvil_assert(in_n_wait_semaphores   == 0 || (in_opt_wait_semaphore_ptrs != nullptr && in_opt_wait_stage_masks_ptr != nullptr) );
+    anvil_assert(in_n_signal_semaphores == 0 ||  in_opt_signal_semaphore_ptrs != nullptr);
+
+    if (m_batches.empty() )
+    {
+        /* All passes have been culled. There is nothing to wait on or signal with. */
+        anvil_assert(in_n_wait_semaphores   == 0       &&
+                     in_n_signal_semaphores == 0       &&
+                     in_opt_fence_ptr       == nullptr);
+
+        result = true;
+        goto end;
+    }
+
+    n_context = m_n_next_execution_context;
+
+    /* The context may still be in use by the execution made N calls earlier. Wait until it completes, so that its
+     * command buffers can be reset at once. Other executions may remain in flight. */
+    for (uint32_t n_queue = 0;
+                  n_queue < N_QUEUES;
+                ++n_queue)
+    {
+        auto& context = m_execution_contexts.at(n_context);
+
+        if (context.submission_tracking_values[n_queue] == 0)
+        {
+            continue;
+        }
+
+        if (!m_queue_ptrs[n_queue]->wait_for_submission_tracking_value(context.submission_tracking_values[n_queue]) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        context.submission_tracking_values[n_queue] = 0;
+    }
+
+    for (auto& current_command_pool_ptr : m_execution_contexts.at(n_context).command_pools)
+    {
+        if (!current_command_pool_ptr->reset(false /* in_release_resources */) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+    }
+
+    m_n_next_execution_context = (n_context + 1) % static_cast<uint32_t>(m_execution_contexts.size() );
+
+    for (uint32_t n_batch = 0;
+                  n_batch < static_cast<uint32_t>(m_batches.size() );
+                ++n_batch)
+    {
+        auto&          batch          = m_batches.at(n_batch);
+        auto&          context        = m_execution_contexts.at(n_context);
+        auto           cmd_buffer_ptr = context.command_buffer_ptrs.at(n_batch).get();
+        Anvil::Fence*  fence_ptr      = nullptr;
+        const bool     is_last_batch  = (n_batch == static_cast<uint32_t>(m_batches.size() - 1) );
+        Anvil::Queue*  queue_ptr      = m_queue_ptrs[static_cast<uint32_t>(batch.queue)];
+        bool           submit_result  = false;
+
+        if (!cmd_buffer_ptr->start_recording(true,   /* in_one_time_submit          */
+                                             false)) /* in_simultaneous_use_allowed */
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        for (const auto current_pass_id : batch.pass_ids)
+        {
+            const auto& pass = m_passes.at(current_pass_id);
+
+            if (!record_barrier_batch(pass.pre_barriers,
+                                      cmd_buffer_ptr) )
+            {
+                goto end;
+            }
+
+            pass.record_function(cmd_buffer_ptr);
+        }
+
+        if (!record_barrier_batch(batch.post_barriers,
+                                  cmd_buffer_ptr) )
+        {
+            goto end;
+        }
+
+        if (!cmd_buffer_ptr->stop_recording() )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        m_signal_semaphores_scratch = context.signal_semaphore_ptrs.at(n_batch);
+        m_wait_semaphores_scratch   = context.wait_semaphore_ptrs.at  (n_batch);
+        m_wait_stage_masks_scratch  = batch.wait_stage_masks;
+
+        if (n_batch == 0)
+        {
+            /* Transient resources are shared with the preceding execution, whose last batch waits for the other
+             * queue. Its semaphore only exists if the first and the last batch are executed on different queues. */
+            if (m_n_previous_execution_context                                                  != UINT32_MAX &&
+                m_execution_contexts.at(m_n_previous_execution_context).execution_semaphore_ptr != nullptr)
+            {
+                m_wait_semaphores_scratch.push_back (m_execution_contexts.at(m_n_previous_execution_context).execution_semaphore_ptr.get() );
+                m_wait_stage_masks_scratch.push_back(Anvil::PipelineStageFlagBits::ALL_COMMANDS_BIT);
+            }
+
+            m_wait_semaphores_scratch.insert (m_wait_semaphores_scratch.end(),
+                                              in_opt_wait_semaphore_ptrs,
+                                              in_opt_wait_semaphore_ptrs  + in_n_wait_semaphores);
+            m_wait_stage_masks_scratch.insert(m_wait_stage_masks_scratch.end(),
+                                              in_opt_wait_stage_masks_ptr,
+                                              in_opt_wait_stage_masks_ptr + in_n_wait_semaphores);
+        }
+
+        if (is_last_batch)
+        {
+            fence_ptr = in_opt_fence_ptr;
+
+            if (context.execution_semaphore_ptr != nullptr)
+            {
+                m_signal_semaphores_scratch.push_back(context.execution_semaphore_ptr.get() );
+            }
+
+            m_signal_semaphores_scratch.insert(m_signal_semaphores_scratch.end(),
+                                               in_opt_signal_semaphore_ptrs,
+                                               in_opt_signal_semaphore_ptrs + in_n_signal_semaphores);
+        }
+
+        if (m_signal_semaphores_scratch.empty() )
+        {
+            if (m_wait_semaphores_scratch.empty() )
+            {
+                submit_result = queue_ptr->submit(
+                    Anvil::SubmitInfo::create_execute(cmd_buffer_ptr,
+                                                      false, /* in_should_block */
+                                                      fence_ptr)
+                );
+            }
+            else
+            {
+                submit_result = queue_ptr->submit(
+                    Anvil::SubmitInfo::create_wait_execute(cmd_buffer_ptr,
+                                                           static_cast<uint32_t>(m_wait_semaphores_scratch.size() ),
+                                                           m_wait_semaphores_scratch.data(),
+                                                           m_wait_stage_masks_scratch.data(),
+                                                           false, /* in_should_block */
+                                                           fence_ptr)
+                );
+            }
+        }
+        else
+        {
+            if (m_wait_semaphores_scratch.empty() )
+            {
+                submit_result = queue_ptr->submit(
+                    Anvil::SubmitInfo::create_execute_signal(cmd_buffer_ptr,
+                                                             static_cast<uint32_t>(m_signal_semaphores_scratch.size() ),
+                                                             m_signal_semaphores_scratch.data(),
+                                                             false, /* in_should_block */
+                                                             fence_ptr)
+                );
+            }
+            else
+            {
+                submit_result = queue_ptr->submit(
+                    Anvil::SubmitInfo::create_wait_execute_signal(cmd_buffer_ptr,
+                                                                  static_cast<uint32_t>(m_signal_semaphores_scratch.size() ),
+                                                                  m_signal_semaphores_scratch.data(),
+                                                                  static_cast<uint32_t>(m_wait_semaphores_scratch.size() ),
+                                                                  m_wait_semaphores_scratch.data(),
+                                                                  m_wait_stage_masks_scratch.data(),
+                                                                  false, /* in_should_block */
+                                                                  fence_ptr)
+                );
+            }
+        }
+
+        if (!submit_result)
+        {
+            anvil_assert(submit_result);
+
+            goto end;
+        }
+
+        context.submission_tracking_values[static_cast<uint32_t>(batch.queue)] = queue_ptr->get_submission_tracking_value();
+
+        /* The preceding execution's semaphore has been waited on and must not be waited on again */
+        if (n_batch == 0)
+        {
+            m_n_previous_execution_context = UINT32_MAX;
+        }
+
+        if (is_last_batch)
+        {
+            m_n_previous_execution_context = n_context;
+        }
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/** Splits live passes, in declaration order, into batches of consecutive passes executed on the same queue, and
+ *  determines lifetimes of resources.
+ **/
+void Anvil::RenderGraph::form_batches()
+{
+    m_batches.clear();
+
+    for (uint32_t n_pass = 0;
+                  n_pass < static_cast<uint32_t>(m_passes.size() );
+                ++n_pass)
+    {
+        auto&                  pass  = m_passes.at(n_pass);
+        const RenderGraphQueue queue = get_effective_queue(pass.queue);
+
+        if (!pass.is_live)
+        {
+            continue;
+        }
+
+        if (m_batches.empty()             ||
+            m_batches.back().queue != queue)
+        {
+            m_batches.push_back(Batch() );
+
+            m_batches.back().queue = queue;
+        }
+
+        m_batches.back().pass_ids.push_back(n_pass);
+
+        pass.n_batch = static_cast<uint32_t>(m_batches.size() - 1);
+
+        for (const auto& current_access : pass.accesses)
+        {
+            auto& resource = m_resources.at(current_access.resource_id);
+
+            if (resource.first_live_pass == UINT32_MAX)
+            {
+                resource.first_live_pass = n_pass;
+            }
+
+            resource.last_live_pass = n_pass;
+        }
+    }
+}
+
+/** Returns stages, access mask, layout & usage flags corresponding to @param in_access, as performed by a pass
+ *  declared for @param in_queue.
+ **/
+Anvil::RenderGraph::AccessProperties Anvil::RenderGraph::get_access_properties(RenderGraphAccess in_access,
+                                                                               RenderGraphQueue  in_queue) const
+{
+    AccessProperties                result;
+    const Anvil::PipelineStageFlags shader_stages = (in_queue == RenderGraphQueue::ASYNC_COMPUTE) ? Anvil::PipelineStageFlags(Anvil::PipelineStageFlagBits::COMPUTE_SHADER_BIT)
+                                                                                                  : Anvil::PipelineStageFlags(Anvil::PipelineStageFlagBits::VERTEX_SHADER_BIT   |
+                                                                                                                              Anvil::PipelineStageFlagBits::FRAGMENT_SHADER_BIT |
+                                                                                                                              Anvil::PipelineStageFlagBits::COMPUTE_SHADER_BIT);
+
+    result.is_read  = false;
+    result.is_write = false;
+    result.layout   = Anvil::ImageLayout::UNKNOWN;
+
+    switch (in_access)
+    {
+        case RenderGraphAccess::COLOR_ATTACHMENT_READ_WRITE:
+        {
+            result.access_mask = Anvil::AccessFlagBits::COLOR_ATTACHMENT_READ_BIT | Anvil::AccessFlagBits::COLOR_ATTACHMENT_WRITE_BIT;
+            result.image_usage = Anvil::ImageUsageFlagBits::COLOR_ATTACHMENT_BIT;
+            result.is_read     = true;
+            result.is_write    = true;
+            result.layout      = Anvil::ImageLayout::COLOR_ATTACHMENT_OPTIMAL;
+            result.stage_mask  = Anvil::PipelineStageFlagBits::COLOR_ATTACHMENT_OUTPUT_BIT;
+
+            break;
+        }
+
+        case RenderGraphAccess::COLOR_ATTACHMENT_WRITE:
+        {
+            result.access_mask = Anvil::AccessFlagBits::COLOR_ATTACHMENT_WRITE_BIT;
+            result.image_usage = Anvil::ImageUsageFlagBits::COLOR_ATTACHMENT_BIT;
+            result.is_write    = true;
+            result.layout      = Anvil::ImageLayout::COLOR_ATTACHMENT_OPTIMAL;
+            result.stage_mask  = Anvil::PipelineStageFlagBits::COLOR_ATTACHMENT_OUTPUT_BIT;
+
+            break;
+        }
+
+        case RenderGraphAccess::DEPTH_STENCIL_ATTACHMENT_READ:
+        {
+            result.access_mask = Anvil::AccessFlagBits::DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+            result.image_usage = Anvil::ImageUsageFlagBits::DEPTH_STENCIL_ATTACHMENT_BIT;
+            result.is_read     = true;
+            result.layout      = Anvil::ImageLayout::DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            result.stage_mask  = Anvil::PipelineStageFlagBits::EARLY_FRAGMENT_TESTS_BIT | Anvil::PipelineStageFlagBits::LATE_FRAGMENT_TESTS_BIT;
+
+            break;
+        }
+
+        case RenderGraphAccess::DEPTH_STENCIL_ATTACHMENT_READ_WRITE:
+        case RenderGraphAccess::DEPTH_STENCIL_ATTACHMENT_WRITE:
+        {
+            /* Depth tests read values written by the same pass, even if the previous contents are discarded */
+            result.access_mask = Anvil::AccessFlagBits::DEPTH_STENCIL_ATTACHMENT_READ_BIT | Anvil::AccessFlagBits::DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            result.image_usage = Anvil::ImageUsageFlagBits::DEPTH_STENCIL_ATTACHMENT_BIT;
+            result.is_read     = (in_access == RenderGraphAccess::DEPTH_STENCIL_ATTACHMENT_READ_WRITE);
+            result.is_write    = true;
+            result.layout      = Anvil::ImageLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            result.stage_mask  = Anvil::PipelineStageFlagBits::EARLY_FRAGMENT_TESTS_BIT | Anvil::PipelineStageFlagBits::LATE_FRAGMENT_TESTS_BIT;
+
+            break;
+        }
+
+        case RenderGraphAccess::INPUT_ATTACHMENT_READ:
+        {
+            result.access_mask = Anvil::AccessFlagBits::INPUT_ATTACHMENT_READ_BIT;
+            result.image_usage = Anvil::ImageUsageFlagBits::INPUT_ATTACHMENT_BIT;
+            result.is_read     = true;
+            result.layout      = Anvil::ImageLayout::SHADER_READ_ONLY_OPTIMAL;
+            result.stage_mask  = Anvil::PipelineStageFlagBits::FRAGMENT_SHADER_BIT;
+
+            break;
+        }
+
+        case RenderGraphAccess::SAMPLED_READ:
+        {
+            result.access_mask = Anvil::AccessFlagBits::SHADER_READ_BIT;
+            result.image_usage = Anvil::ImageUsageFlagBits::SAMPLED_BIT;
+            result.is_read     = true;
+            result.layout      = Anvil::ImageLayout::SHADER_READ_ONLY_OPTIMAL;
+            result.stage_mask  = shader_stages;
+
+            break;
+        }
+
+        case RenderGraphAccess::INDEX_READ:
+        {
+            result.access_mask  = Anvil::AccessFlagBits::INDEX_READ_BIT;
+            result.buffer_usage = Anvil::BufferUsageFlagBits::INDEX_BUFFER_BIT;
+            result.is_read      = true;
+            result.stage_mask   = Anvil::PipelineStageFlagBits::VERTEX_INPUT_BIT;
+
+            break;
+        }
+
+        case RenderGraphAccess::INDIRECT_READ:
+        {
+            result.access_mask  = Anvil::AccessFlagBits::INDIRECT_COMMAND_READ_BIT;
+            result.buffer_usage = Anvil::BufferUsageFlagBits::INDIRECT_BUFFER_BIT;
+            result.is_read      = true;
+            result.stage_mask   = Anvil::PipelineStageFlagBits::DRAW_INDIRECT_BIT;
+
+            break;
+        }
+
+        case RenderGraphAccess::UNIFORM_READ:
+        {
+            result.access_mask  = Anvil::AccessFlagBits::UNIFORM_READ_BIT;
+            result.buffer_usage = Anvil::BufferUsageFlagBits::UNIFORM_BUFFER_BIT;
+            result.is_read      = true;
+            result.stage_mask   = shader_stages;
+
+            break;
+        }
+
+        case RenderGraphAccess::VERTEX_READ:
+        {
+            result.access_mask  = Anvil::AccessFlagBits::VERTEX_ATTRIBUTE_READ_BIT;
+            result.buffer_usage = Anvil::BufferUsageFlagBits::VERTEX_BUFFER_BIT;
+            result.is_read      = true;
+            result.stage_mask   = Anvil::PipelineStageFlagBits::VERTEX_INPUT_BIT;
+
+            break;
+        }
+
+        case RenderGraphAccess::STORAGE_READ:
+        case RenderGraphAccess::STORAGE_READ_WRITE:
+        case RenderGraphAccess::STORAGE_WRITE:
+        {
+            result.is_read      = (in_access != RenderGraphAccess::STORAGE_WRITE);
+            result.is_write     = (in_access != RenderGraphAccess::STORAGE_READ);
+            result.access_mask  = (result.is_read)  ? Anvil::AccessFlags(Anvil::AccessFlagBits::SHADER_READ_BIT)  : Anvil::AccessFlags();
+            result.access_mask |= (result.is_write) ? Anvil::AccessFlags(Anvil::AccessFlagBits::SHADER_WRITE_BIT) : Anvil::AccessFlags();
+            result.buffer_usage = Anvil::BufferUsageFlagBits::STORAGE_BUFFER_BIT;
+            result.image_usage  = Anvil::ImageUsageFlagBits::STORAGE_BIT;
+            result.layout       = Anvil::ImageLayout::GENERAL;
+            result.stage_mask   = shader_stages;
+
+            break;
+        }
+
+        case RenderGraphAccess::TRANSFER_READ:
+        {
+            result.access_mask  = Anvil::AccessFlagBits::TRANSFER_READ_BIT;
+            result.buffer_usage = Anvil::BufferUsageFlagBits::TRANSFER_SRC_BIT;
+            result.image_usage  = Anvil::ImageUsageFlagBits::TRANSFER_SRC_BIT;
+            result.is_read      = true;
+            result.layout       = Anvil::ImageLayout::TRANSFER_SRC_OPTIMAL;
+            result.stage_mask   = Anvil::PipelineStageFlagBits::TRANSFER_BIT;
+
+            break;
+        }
+
+        case RenderGraphAccess::TRANSFER_WRITE:
+        {
+            result.access_mask  = Anvil::AccessFlagBits::TRANSFER_WRITE_BIT;
+            result.buffer_usage = Anvil::BufferUsageFlagBits::TRANSFER_DST_BIT;
+            result.image_usage  = Anvil::ImageUsageFlagBits::TRANSFER_DST_BIT;
+            result.is_write     = true;
+            result.layout       = Anvil::ImageLayout::TRANSFER_DST_OPTIMAL;
+            result.stage_mask   = Anvil::PipelineStageFlagBits::TRANSFER_BIT;
+
+            break;
+        }
+
+        default:
+        {
+            anvil_assert_fail();
+        }
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::Buffer* Anvil::RenderGraph::get_buffer(RenderGraphResourceID in_resource_id) const
+{
+    anvil_assert(m_resources.at(in_resource_id).type == ResourceType::BUFFER);
+
+    return m_resources.at(in_resource_id).buffer_ptr;
+}
+
+/** Returns the queue passes declared for @param in_queue are executed on, ie. GRAPHICS for ASYNC_COMPUTE if async
+ *  compute is not in use.
+ **/
+Anvil::RenderGraphQueue Anvil::RenderGraph::get_effective_queue(RenderGraphQueue in_queue) const
+{
+    const bool is_async_compute_used = (m_queue_ptrs[static_cast<uint32_t>(RenderGraphQueue::ASYNC_COMPUTE)] != m_queue_ptrs[static_cast<uint32_t>(RenderGraphQueue::GRAPHICS)]);
+
+    return (in_queue == RenderGraphQueue::ASYNC_COMPUTE && !is_async_compute_used) ? RenderGraphQueue::GRAPHICS
+                                                                                   : in_queue;
+}
+
+/* Please see header for specification */
+Anvil::Image* Anvil::RenderGraph::get_image(RenderGraphResourceID in_resource_id) const
+{
+    anvil_assert(m_resources.at(in_resource_id).type == ResourceType::IMAGE);
+
+    return m_resources.at(in_resource_id).image_ptr;
+}
+
+/* Please see header for specification */
+Anvil::ImageLayout Anvil::RenderGraph::get_image_layout(RenderGraphPassID     in_pass_id,
+                                                        RenderGraphResourceID in_resource_id) const
+{
+    Anvil::ImageLayout result = Anvil::ImageLayout::UNKNOWN;
+
+    anvil_assert(m_is_baked);
+
+    for (const auto& current_access : m_passes.at(in_pass_id).accesses)
+    {
+        if (current_access.resource_id == in_resource_id)
+        {
+            result = current_access.layout;
+
+            break;
+        }
+    }
+
+    return result;
+}
+
+/** Returns a subresource range covering all aspects, mips & layers of image resource @param in_resource. */
+Anvil::ImageSubresourceRange Anvil::RenderGraph::get_subresource_range(const Resource& in_resource) const
+{
+    const Anvil::Format          format = in_resource.image_ptr->get_create_info_ptr()->get_format();
+    Anvil::ImageSubresourceRange result;
+
+    if (Anvil::Formats::has_depth_aspect  (format) ||
+        Anvil::Formats::has_stencil_aspect(format) )
+    {
+        result.aspect_mask = Anvil::ImageAspectFlags();
+
+        if (Anvil::Formats::has_depth_aspect(format) )
+        {
+            result.aspect_mask |= Anvil::ImageAspectFlagBits::DEPTH_BIT;
+        }
+
+        if (Anvil::Formats::has_stencil_aspect(format) )
+        {
+            result.aspect_mask |= Anvil::ImageAspectFlagBits::STENCIL_BIT;
+        }
+    }
+    else
+    {
+        result.aspect_mask = Anvil::ImageAspectFlagBits::COLOR_BIT;
+    }
+
+    result.base_array_layer = 0;
+    result.base_mip_level   = 0;
+    result.layer_count      = in_resource.image_ptr->get_create_info_ptr()->get_n_layers();
+    result.level_count      = in_resource.image_ptr->get_n_mipmaps();
+
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::RenderGraphResourceID Anvil::RenderGraph::import_buffer(Anvil::Buffer* in_buffer_ptr)
+{
+    Resource new_resource;
+
+    anvil_assert(!m_is_baked);
+    anvil_assert(in_buffer_ptr != nullptr);
+
+    new_resource.buffer_ptr  = in_buffer_ptr;
+    new_resource.is_imported = true;
+    new_resource.type        = ResourceType::BUFFER;
+
+    m_resources.push_back(std::move(new_resource) );
+
+    return static_cast<RenderGraphResourceID>(m_resources.size() - 1);
+}
+
+/* Please see header for specification */
+Anvil::RenderGraphResourceID Anvil::RenderGraph::import_image(Anvil::Image*      in_image_ptr,
+                                                              Anvil::ImageLayout in_initial_layout,
+                                                              Anvil::ImageLayout in_final_layout)
+{
+    Resource new_resource;
+
+    anvil_assert(!m_is_baked);
+    anvil_assert(in_image_ptr != nullptr);
+
+    new_resource.final_layout   = in_final_layout;
+    new_resource.format         = in_image_ptr->get_create_info_ptr()->get_format();
+    new_resource.image_ptr      = in_image_ptr;
+    new_resource.initial_layout = in_initial_layout;
+    new_resource.is_imported    = true;
+    new_resource.type           = ResourceType::IMAGE;
+
+    m_resources.push_back(std::move(new_resource) );
+
+    return static_cast<RenderGraphResourceID>(m_resources.size() - 1);
+}
+
+/** Records barriers described by @param in_barrier_batch into @param in_cmd_buffer_ptr with a single
+ *  vkCmdPipelineBarrier() call. Does nothing if the batch is empty.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::RenderGraph::record_barrier_batch(const BarrierBatch&          in_barrier_batch,
+                                              Anvil::PrimaryCommandBuffer* in_cmd_buffer_ptr)
+{
+    bool result = true;
+
+    if (in_barrier_batch.dst_stage_mask == 0)
+    {
+        goto end;
+    }
+
+    m_buffer_barriers_scratch.clear();
+    m_image_barriers_scratch.clear ();
+
+    for (const auto& current_barrier : in_barrier_batch.barriers)
+    {
+        const auto& resource = m_resources.at(current_barrier.resource_id);
+
+        if (resource.type == ResourceType::IMAGE)
+        {
+            m_image_barriers_scratch.push_back(
+                Anvil::ImageBarrier(current_barrier.src_access_mask,
+                                    current_barrier.dst_access_mask,
+                                    current_barrier.old_layout,
+                                    current_barrier.new_layout,
+                                    VK_QUEUE_FAMILY_IGNORED,
+                                    VK_QUEUE_FAMILY_IGNORED,
+                                    resource.image_ptr,
+                                    get_subresource_range(resource) )
+            );
+        }
+        else
+        {
+            m_buffer_barriers_scratch.push_back(
+                Anvil::BufferBarrier(current_barrier.src_access_mask,
+                                     current_barrier.dst_access_mask,
+                                     VK_QUEUE_FAMILY_IGNORED,
+                                     VK_QUEUE_FAMILY_IGNORED,
+                                     resource.buffer_ptr,
+                                     0, /* in_offset */
+                                     VK_WHOLE_SIZE)
+            );
+        }
+    }
+
+    result = in_cmd_buffer_ptr->record_pipeline_barrier(in_barrier_batch.src_stage_mask,
+                                                        in_barrier_batch.dst_stage_mask,
+                                                        Anvil::DependencyFlagBits::NONE,
+                                                        0,       /* in_memory_barrier_count */
+                                                        nullptr, /* in_memory_barriers_ptr  */
+                                                        static_cast<uint32_t>(m_buffer_barriers_scratch.size() ),
+                                                        (m_buffer_barriers_scratch.size() > 0) ? m_buffer_barriers_scratch.data() : nullptr,
+                                                        static_cast<uint32_t>(m_image_barriers_scratch.size() ),
+                                                        (m_image_barriers_scratch.size()  > 0) ? m_image_barriers_scratch.data()  : nullptr);
+
+    anvil_assert(result);
+end:
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::RenderGraph::set_imported_buffer(RenderGraphResourceID in_resource_id,
+                                             Anvil::Buffer*        in_buffer_ptr)
+{
+    auto& resource = m_resources.at(in_resource_id);
+
+    anvil_assert(in_buffer_ptr        != nullptr);
+    anvil_assert(resource.is_imported);
+    anvil_assert(resource.type        == ResourceType::BUFFER);
+
+    resource.buffer_ptr = in_buffer_ptr;
+}
+
+/* Please see header for specification */
+void Anvil::RenderGraph::set_imported_image(RenderGraphResourceID in_resource_id,
+                                            Anvil::Image*         in_image_ptr)
+{
+    auto& resource = m_resources.at(in_resource_id);
+
+    anvil_assert(in_image_ptr         != nullptr);
+    anvil_assert(resource.is_imported);
+    anvil_assert(resource.type        == ResourceType::IMAGE);
+    anvil_assert(resource.format      == in_image_ptr->get_create_info_ptr()->get_format() );
+
+    resource.image_ptr = in_image_ptr;
+}
@@ -0,0 +1,264 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/resource_release_queue.h"
+#include "wrappers/buffer.h"
+#include "wrappers/descriptor_set_group.h"
+#include "wrappers/device.h"
+#include "wrappers/image.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/queue.h"
+
+/* Please see header for specification */
+Anvil::ResourceReleaseQueue::ResourceReleaseQueue(const std::vector<Anvil::Queue*>& in_queue_ptrs)
+    :m_n_pending_releases(0),
+     m_queue_ptrs        (in_queue_ptrs)
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::ResourceReleaseQueue::~ResourceReleaseQueue()
+{
+    while (m_batches.size() > 0)
+    {
+        destroy_batch(std::move(m_batches.front() ));
+
+        m_batches.pop_front();
+    }
+}
+
+/* Please see header for specification */
+Anvil::ResourceReleaseQueueUniquePtr Anvil::ResourceReleaseQueue::create(const Anvil::BaseDevice*          in_device_ptr,
+                                                                         const std::vector<Anvil::Queue*>& in_queue_ptrs)
+{
+    Anvil::ResourceReleaseQueueUniquePtr result_ptr(nullptr,
+                                                    std::default_delete<Anvil::ResourceReleaseQueue>() );
+
+    anvil_assert(in_device_ptr != nullptr);
+    ANVIL_REDUNDANT_ARGUMENT_CONST(in_device_ptr);
+
+    result_ptr.reset(
+        new Anvil::ResourceReleaseQueue(in_queue_ptrs)
+    );
+
+    return result_ptr;
+}
+
+/** Destroys all objects held by the specified batch, in an order which guarantees that no object
+ *  is destroyed before the objects which may refer to it.
+ *
+ *  @param in_batch_ptr Batch to destroy. Must not be nullptr.
+ **/
+void Anvil::ResourceReleaseQueue::destroy_batch(std::unique_ptr<Batch> in_batch_ptr)
+{
+    anvil_assert(in_batch_ptr != nullptr);
+
+    in_batch_ptr->dsg_ptrs.clear         ();
+    in_batch_ptr->buffer_ptrs.clear      ();
+    in_batch_ptr->image_ptrs.clear       ();
+    in_batch_ptr->memory_block_ptrs.clear();
+}
+
+/* Please see header for specification */
+uint32_t Anvil::ResourceReleaseQueue::get_n_pending_releases() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    return m_n_pending_releases;
+}
+
+/** Returns a batch, which new releases should be added to. The batch is tagged with the latest submissions
+ *  made to all device queues.
+ *
+ *  The caller must hold m_mutex.
+ *
+ *  @return As per description. Never nullptr.
+ **/
+Anvil::ResourceReleaseQueue::Batch* Anvil::ResourceReleaseQueue::get_open_batch()
+{
+    const uint32_t        n_queues                  (static_cast<uint32_t>(m_queue_ptrs.size() ) );
+    std::vector<uint64_t> submission_tracking_values(n_queues);
+
+    for (uint32_t n_queue = 0;
+                  n_queue < n_queues;
+                ++n_queue)
+    {
+        submission_tracking_values.at(n_queue) = m_queue_ptrs.at(n_queue)->get_submission_tracking_value();
+    }
+
+    /* Reuse the most recent batch if no submissions have been made in the meantime */
+    if (m_batches.size()                           >  0                          &&
+        m_batches.back()->submission_tracking_values == submission_tracking_values)
+    {
+        return m_batches.back().get();
+    }
+
+    {
+        std::unique_ptr<Batch> new_batch_ptr(new Batch() );
+
+        new_batch_ptr->submission_tracking_values = std::move(submission_tracking_values);
+
+        m_batches.push_back(std::move(new_batch_ptr) );
+    }
+
+    return m_batches.back().get();
+}
+
+/* Please see header for specification */
+void Anvil::ResourceReleaseQueue::release(Anvil::BufferUniquePtr in_buffer_ptr)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (in_buffer_ptr != nullptr)
+    {
+        get_open_batch()->buffer_ptrs.push_back(std::move(in_buffer_ptr) );
+
+        ++m_n_pending_releases;
+    }
+}
+
+/* Please see header for specification */
+void Anvil::ResourceReleaseQueue::release(Anvil::DescriptorSetGroupUniquePtr in_dsg_ptr)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (in_dsg_ptr != nullptr)
+    {
+        get_open_batch()->dsg_ptrs.push_back(std::move(in_dsg_ptr) );
+
+        ++m_n_pending_releases;
+    }
+}
+
+/* Please see header for specification */
+void Anvil::ResourceReleaseQueue::release(Anvil::ImageUniquePtr in_image_ptr)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (in_image_ptr != nullptr)
+    {
+        get_open_batch()->image_ptrs.push_back(std::move(in_image_ptr) );
+
+        ++m_n_pending_releases;
+    }
+}
+
+/* Please see header for specification */
+void Anvil::ResourceReleaseQueue::release(Anvil::MemoryBlockUniquePtr in_memory_block_ptr)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (in_memory_block_ptr != nullptr)
+    {
+        get_open_batch()->memory_block_ptrs.push_back(std::move(in_memory_block_ptr) );
+
+        ++m_n_pending_releases;
+    }
+}
+
+/* Please see header for specification */
+uint32_t Anvil::ResourceReleaseQueue::retire(bool in_should_block)
+{
+    std::vector<std::unique_ptr<Batch> > batches_to_destroy;
+    const uint32_t                       n_queues          (static_cast<uint32_t>(m_queue_ptrs.size() ) );
+    std::vector<uint64_t>                completed_values  (n_queues);
+    uint32_t                             result            (0);
+
+    if (in_should_block)
+    {
+        std::vector<uint64_t> values_to_wait_for;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            if (m_batches.size() > 0)
+            {
+                values_to_wait_for = m_batches.back()->submission_tracking_values;
+            }
+        }
+
+        for (uint32_t n_queue = 0;
+                      n_queue < static_cast<uint32_t>(values_to_wait_for.size() );
+                    ++n_queue)
+        {
+            const bool wait_result = m_queue_ptrs.at(n_queue)->wait_for_submission_tracking_value(values_to_wait_for.at(n_queue) );
+
+            anvil_assert(wait_result);
+            ANVIL_REDUNDANT_VARIABLE_CONST(wait_result);
+        }
+    }
+
+    for (uint32_t n_queue = 0;
+                  n_queue < n_queues;
+                ++n_queue)
+    {
+        if (!m_queue_ptrs.at(n_queue)->get_completed_submission_tracking_value(&completed_values.at(n_queue) ))
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+    }
+
+    /* Tracking values are monotonic, so batches are retired in the order they were created. */
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (m_batches.size() > 0)
+        {
+            const auto& batch_ptr   = m_batches.front();
+            bool        is_complete = true;
+
+            for (uint32_t n_queue = 0;
+                          n_queue < n_queues && is_complete;
+                        ++n_queue)
+            {
+                is_complete = (batch_ptr->submission_tracking_values.at(n_queue) <= completed_values.at(n_queue) );
+            }
+
+            if (!is_complete)
+            {
+                break;
+            }
+
+            result += batch_ptr->get_n_objects();
+
+            batches_to_destroy.push_back(std::move(m_batches.front() ));
+            m_batches.pop_front         ();
+        }
+
+        anvil_assert(m_n_pending_releases >= result);
+
+        m_n_pending_releases -= result;
+    }
+
+    /* Objects are destroyed outside the critical section, so that other threads can keep queueing releases. */
+    for (auto& current_batch_ptr : batches_to_destroy)
+    {
+        destroy_batch(std::move(current_batch_ptr) );
+    }
+
+end:
+    return result;
+}
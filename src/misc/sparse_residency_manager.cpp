@@ -0,0 +1,454 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include "misc/debug.h"
+#include "misc/image_create_info.h"
+#include "misc/memory_block_create_info.h"
+#include "misc/sparse_residency_manager.h"
+#include "wrappers/device.h"
+#include "wrappers/image.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/queue.h"
+#include <algorithm>
+
+
+/* Please see header for specification */
+Anvil::SparseResidencyManager::SparseResidencyManager(Anvil::Image*             in_image_ptr,
+                                                      uint32_t                  in_n_max_resident_tiles,
+                                                      uint32_t                  in_n_tiles_per_heap_block,
+                                                      Anvil::MemoryFeatureFlags in_memory_features)
+    :m_current_frame         (0),
+     m_image_ptr             (in_image_ptr),
+     m_memory_features       (in_memory_features),
+     m_n_allocated_slots     (0),
+     m_n_evictions           (0),
+     m_n_max_resident_tiles  (in_n_max_resident_tiles),
+     m_n_tiles_per_heap_block(in_n_tiles_per_heap_block),
+     m_tile_size             (in_image_ptr->get_image_alignment(0) )
+{
+    m_free_slots.reserve(in_n_max_resident_tiles);
+}
+
+/* Please see header for specification */
+Anvil::SparseResidencyManager::~SparseResidencyManager()
+{
+    /* Stub */
+}
+
+/** Pops a free tile slot. If none are available and the residency budget allows, a new heap memory block is
+ *  allocated first.
+ *
+ *  @param out_n_slot_ptr Deref will be set to the index of the slot. Must not be nullptr.
+ *
+ *  @return true if successful, false if all slots are in use or the allocation failed.
+ **/
+bool Anvil::SparseResidencyManager::acquire_slot(uint32_t* out_n_slot_ptr)
+{
+    bool result = false;
+
+    if (m_free_slots.size() == 0)
+    {
+        Anvil::MemoryBlockUniquePtr new_memory_block_ptr;
+        uint32_t                    n_new_slots;
+
+        if (m_n_allocated_slots >= m_n_max_resident_tiles)
+        {
+            goto end;
+        }
+
+        /* The last heap block is clamped, so that no memory is allocated above the residency budget */
+        n_new_slots          = std::min(m_n_tiles_per_heap_block,
+                                        m_n_max_resident_tiles - m_n_allocated_slots);
+        new_memory_block_ptr = Anvil::MemoryBlock::create(
+            Anvil::MemoryBlockCreateInfo::create_regular(m_image_ptr->get_create_info_ptr()->get_device(),
+                                                         m_image_ptr->get_image_memory_types(0),
+                                                         m_tile_size * n_new_slots,
+                                                         m_memory_features)
+        );
+
+        if (new_memory_block_ptr == nullptr)
+        {
+            anvil_assert(new_memory_block_ptr != nullptr);
+
+            goto end;
+        }
+
+        m_heap_memory_blocks.push_back(std::move(new_memory_block_ptr) );
+
+        /* Slots are handed out in ascending order */
+        for (uint32_t n_new_slot = n_new_slots; n_new_slot > 0; --n_new_slot)
+        {
+            m_free_slots.push_back(m_n_allocated_slots + n_new_slot - 1);
+        }
+
+        m_n_allocated_slots += n_new_slots;
+    }
+
+    *out_n_slot_ptr = m_free_slots.back();
+    result          = true;
+
+    m_free_slots.pop_back();
+
+end:
+    return result;
+}
+
+/** Appends a bind or an unbind operation for a single tile to the specified bind info.
+ *
+ *  @param in_update_ptr      Update info to append the operation to. Must not be nullptr.
+ *  @param in_bind_info_id    ID of the bind info to use.
+ *  @param in_location        Location of the tile.
+ *  @param in_opt_n_slot_ptr  Slot to bind to the tile. If nullptr, the tile is unbound.
+ **/
+void Anvil::SparseResidencyManager::append_tile_update(Anvil::SparseMemoryBindingUpdateInfo* in_update_ptr,
+                                                       SparseMemoryBindInfoID                in_bind_info_id,
+                                                       const TileLocation&                   in_location,
+                                                       const uint32_t*                       in_opt_n_slot_ptr)
+{
+    Anvil::MemoryBlock*     memory_block_ptr         (nullptr);
+    VkDeviceSize            memory_block_start_offset(0);
+    Anvil::ImageSubresource subresource;
+    VkExtent3D              tile_extent;
+    VkOffset3D              tile_offset;
+
+    get_tile_region(in_location,
+                   &tile_offset,
+                   &tile_extent);
+
+    if (in_opt_n_slot_ptr != nullptr)
+    {
+        memory_block_ptr          = m_heap_memory_blocks.at(*in_opt_n_slot_ptr / m_n_tiles_per_heap_block).get();
+        memory_block_start_offset = static_cast<VkDeviceSize>(*in_opt_n_slot_ptr % m_n_tiles_per_heap_block) * m_tile_size;
+    }
+
+    subresource.array_layer = in_location.n_layer;
+    subresource.aspect_mask = in_location.aspect;
+    subresource.mip_level   = in_location.n_mip;
+
+    in_update_ptr->append_image_memory_update(in_bind_info_id,
+                                              m_image_ptr,
+                                              subresource,
+                                              tile_offset,
+                                              tile_extent,
+                                              Anvil::SparseMemoryBindFlagBits::NONE,
+                                              memory_block_ptr,
+                                              memory_block_start_offset,
+                                              false); /* in_opt_memory_block_owned_by_image */
+}
+
+/* Please see header for specification */
+Anvil::SparseResidencyManagerUniquePtr Anvil::SparseResidencyManager::create(Anvil::Image*             in_image_ptr,
+                                                                             uint32_t                  in_n_max_resident_tiles,
+                                                                             uint32_t                  in_n_tiles_per_heap_block,
+                                                                             Anvil::MemoryFeatureFlags in_memory_features)
+{
+    Anvil::SparseResidencyManagerUniquePtr result_ptr(nullptr,
+                                                      std::default_delete<Anvil::SparseResidencyManager>() );
+
+    anvil_assert(in_image_ptr              != nullptr);
+    anvil_assert(in_n_max_resident_tiles   >  0);
+    anvil_assert(in_n_tiles_per_heap_block >  0);
+
+    if ((in_image_ptr->get_create_info_ptr()->get_create_flags() & Anvil::ImageCreateFlagBits::SPARSE_RESIDENCY_BIT) == 0)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    result_ptr.reset(
+        new Anvil::SparseResidencyManager(in_image_ptr,
+                                          in_n_max_resident_tiles,
+                                          in_n_tiles_per_heap_block,
+                                          in_memory_features)
+    );
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+bool Anvil::SparseResidencyManager::flush(Anvil::Queue*            in_opt_queue_ptr,
+                                          uint32_t                 in_n_wait_semaphores,
+                                          Anvil::Semaphore* const* in_opt_wait_semaphore_ptrs,
+                                          uint32_t                 in_n_signal_semaphores,
+                                          Anvil::Semaphore* const* in_opt_signal_semaphore_ptrs,
+                                          Anvil::Fence*            in_opt_fence_ptr)
+{
+    std::vector<uint32_t>                           acquired_slots;
+    Anvil::SparseMemoryBindInfoID                   bind_info_id;
+    std::vector<std::pair<TileLocation, uint32_t> > bound_tiles;
+    LRUList::iterator                               lru_eviction_iterator = m_lru_tiles.begin();
+    uint32_t                                        n_evicted_tiles       = 0;
+    Anvil::Queue*                                   queue_ptr             = in_opt_queue_ptr;
+    bool                                            result                = true;
+    Anvil::SparseMemoryBindingUpdateInfo            update;
+
+    if (m_pending_tiles.size() == 0)
+    {
+        goto end;
+    }
+
+    if (queue_ptr == nullptr)
+    {
+        queue_ptr = m_image_ptr->get_create_info_ptr()->get_device()->get_sparse_binding_queue(0);
+
+        if (queue_ptr == nullptr)
+        {
+            anvil_assert(queue_ptr != nullptr);
+
+            result = false;
+            goto end;
+        }
+    }
+
+    bind_info_id = update.add_bind_info(in_n_signal_semaphores,
+                                        in_opt_signal_semaphore_ptrs,
+                                        in_n_wait_semaphores,
+                                        in_opt_wait_semaphore_ptrs);
+
+    /* Build the update first. Residency state is only modified once the bind operation has been submitted. */
+    for (const auto& current_location : m_pending_tiles)
+    {
+        uint32_t n_slot = UINT32_MAX;
+
+        if (acquire_slot(&n_slot) )
+        {
+            acquired_slots.push_back(n_slot);
+        }
+        else
+        {
+            /* Budget exhausted. Evict the least recently requested tile, unless it has been requested this frame,
+             * in which case so have all other resident tiles. The unbind precedes the bind within the batch. */
+            if (lru_eviction_iterator == m_lru_tiles.end() )
+            {
+                break;
+            }
+
+            const auto evicted_tile_iterator = m_resident_tiles.find(*lru_eviction_iterator);
+
+            anvil_assert(evicted_tile_iterator != m_resident_tiles.end() );
+
+            if (evicted_tile_iterator->second.last_request_frame >= m_current_frame)
+            {
+                break;
+            }
+
+            n_slot = evicted_tile_iterator->second.n_slot;
+
+            append_tile_update(&update,
+                               bind_info_id,
+                               *lru_eviction_iterator,
+                               nullptr); /* in_opt_n_slot_ptr */
+
+            ++lru_eviction_iterator;
+            ++n_evicted_tiles;
+        }
+
+        append_tile_update(&update,
+                           bind_info_id,
+                           current_location,
+                          &n_slot);
+
+        bound_tiles.push_back(
+            std::make_pair(current_location,
+                           n_slot)
+        );
+    }
+
+    if (bound_tiles.size() == 0)
+    {
+        goto end;
+    }
+
+    update.set_fence(in_opt_fence_ptr);
+
+    if (!queue_ptr->bind_sparse_memory(update) )
+    {
+        anvil_assert_fail();
+
+        /* Roll back. Tiles stay pending and are retried during subsequent flushes. */
+        for (auto slot_iterator  = acquired_slots.rbegin();
+                  slot_iterator != acquired_slots.rend();
+                ++slot_iterator)
+        {
+            m_free_slots.push_back(*slot_iterator);
+        }
+
+        result = false;
+        goto end;
+    }
+
+    /* The bind operation has been submitted. Commit the evictions & binds. */
+    for (auto lru_iterator  = m_lru_tiles.begin();
+              lru_iterator != lru_eviction_iterator;
+            ++lru_iterator)
+    {
+        m_resident_tiles.erase(*lru_iterator);
+    }
+
+    m_lru_tiles.erase(m_lru_tiles.begin(),
+                      lru_eviction_iterator);
+
+    m_n_evictions += n_evicted_tiles;
+
+    for (const auto& current_bound_tile : bound_tiles)
+    {
+        ResidentTile new_tile;
+
+        new_tile.last_request_frame = m_current_frame;
+        new_tile.lru_iterator       = m_lru_tiles.insert(m_lru_tiles.end(),
+                                                         current_bound_tile.first);
+        new_tile.n_slot             = current_bound_tile.second;
+
+        m_resident_tiles.insert(std::make_pair(current_bound_tile.first,
+                                               new_tile) );
+        m_pending_tiles_set.erase(current_bound_tile.first);
+    }
+
+    /* Requests which could not be satisfied are retried during subsequent flushes */
+    m_pending_tiles.erase(m_pending_tiles.begin(),
+                          m_pending_tiles.begin() + bound_tiles.size() );
+
+end:
+    ++m_current_frame;
+
+    return result;
+}
+
+/** Computes the texel-space region covered by a tile. Tiles at the right, bottom and back edges of a mip are
+ *  clamped to the mip's extent.
+ *
+ *  @param in_location    Location of the tile.
+ *  @param out_offset_ptr Deref will be set to the region's offset. Must not be nullptr.
+ *  @param out_extent_ptr Deref will be set to the region's extent. Must not be nullptr.
+ **/
+void Anvil::SparseResidencyManager::get_tile_region(const TileLocation& in_location,
+                                                    VkOffset3D*         out_offset_ptr,
+                                                    VkExtent3D*         out_extent_ptr) const
+{
+    const Anvil::SparseImageAspectProperties* aspect_props_ptr = nullptr;
+    const VkExtent3D                          mip_extent       = m_image_ptr->get_image_extent_3D(in_location.n_mip);
+
+    m_image_ptr->get_sparse_image_aspect_properties(in_location.aspect,
+                                                   &aspect_props_ptr);
+
+    anvil_assert(aspect_props_ptr != nullptr);
+
+    const VkExtent3D& granularity = aspect_props_ptr->granularity;
+
+    out_offset_ptr->x = static_cast<int32_t>(in_location.tile_x * granularity.width);
+    out_offset_ptr->y = static_cast<int32_t>(in_location.tile_y * granularity.height);
+    out_offset_ptr->z = static_cast<int32_t>(in_location.tile_z * granularity.depth);
+
+    out_extent_ptr->width  = std::min(granularity.width,  mip_extent.width  - in_location.tile_x * granularity.width);
+    out_extent_ptr->height = std::min(granularity.height, mip_extent.height - in_location.tile_y * granularity.height);
+    out_extent_ptr->depth  = std::min(granularity.depth,  mip_extent.depth  - in_location.tile_z * granularity.depth);
+}
+
+/* Please see header for specification */
+bool Anvil::SparseResidencyManager::is_tile_resident(Anvil::ImageAspectFlagBits in_aspect,
+                                                     uint32_t                   in_n_layer,
+                                                     uint32_t                   in_n_mip,
+                                                     uint32_t                   in_tile_x,
+                                                     uint32_t                   in_tile_y,
+                                                     uint32_t                   in_tile_z) const
+{
+    const TileLocation location(in_aspect,
+                                in_n_layer,
+                                in_n_mip,
+                                in_tile_x,
+                                in_tile_y,
+                                in_tile_z);
+
+    return (m_resident_tiles.find(location) != m_resident_tiles.end() );
+}
+
+/* Please see header for specification */
+bool Anvil::SparseResidencyManager::request_tile(Anvil::ImageAspectFlagBits in_aspect,
+                                                 uint32_t                   in_n_layer,
+                                                 uint32_t                   in_n_mip,
+                                                 uint32_t                   in_tile_x,
+                                                 uint32_t                   in_tile_y,
+                                                 uint32_t                   in_tile_z)
+{
+    const Anvil::SparseImageAspectProperties* aspect_props_ptr       = nullptr;
+    const TileLocation                        location               (in_aspect,
+                                                                      in_n_layer,
+                                                                      in_n_mip,
+                                                                      in_tile_x,
+                                                                      in_tile_y,
+                                                                      in_tile_z);
+    VkExtent3D                                mip_extent;
+    bool                                      result                 = false;
+    auto                                      resident_tile_iterator = m_resident_tiles.find(location);
+
+    if (resident_tile_iterator != m_resident_tiles.end() )
+    {
+        /* Move the tile to the back of the LRU list */
+        resident_tile_iterator->second.last_request_frame = m_current_frame;
+
+        m_lru_tiles.splice(m_lru_tiles.end(),
+                           m_lru_tiles,
+                           resident_tile_iterator->second.lru_iterator);
+
+        result = true;
+        goto end;
+    }
+
+    if (!m_image_ptr->get_sparse_image_aspect_properties(in_aspect,
+                                                        &aspect_props_ptr) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (in_n_layer >= m_image_ptr->get_create_info_ptr()->get_n_layers() ||
+        in_n_mip   >= aspect_props_ptr->mip_tail_first_lod               ||
+        in_n_mip   >= m_image_ptr->get_n_mipmaps() )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    mip_extent = m_image_ptr->get_image_extent_3D(in_n_mip);
+
+    if (in_tile_x >= Anvil::Utils::round_up(mip_extent.width,  aspect_props_ptr->granularity.width)  / aspect_props_ptr->granularity.width  ||
+        in_tile_y >= Anvil::Utils::round_up(mip_extent.height, aspect_props_ptr->granularity.height) / aspect_props_ptr->granularity.height ||
+        in_tile_z >= Anvil::Utils::round_up(mip_extent.depth,  aspect_props_ptr->granularity.depth)  / aspect_props_ptr->granularity.depth)
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (m_pending_tiles_set.insert(location).second)
+    {
+        m_pending_tiles.push_back(location);
+    }
+
+    result = true;
+
+end:
+    return result;
+}
@@ -32,6 +32,7 @@ INJECT_BITFIELD_HELPER_FUNC_IMPLEMENTATION(Anvil::DebugMessageTypeFlags,
 INJECT_BITFIELD_HELPER_FUNC_IMPLEMENTATION(Anvil::DependencyFlags,                  VkDependencyFlags,                     Anvil::DependencyFlagBits);
 INJECT_BITFIELD_HELPER_FUNC_IMPLEMENTATION(Anvil::DescriptorBindingFlags,           VkDescriptorBindingFlagsEXT,           Anvil::DescriptorBindingFlagBits);
 INJECT_BITFIELD_HELPER_FUNC_IMPLEMENTATION(Anvil::DescriptorPoolCreateFlags,        VkDescriptorPoolCreateFlags,           Anvil::DescriptorPoolCreateFlagBits);
+INJECT_BITFIELD_HELPER_FUNC_IMPLEMENTATION(Anvil::DescriptorSetLayoutCreateFlags,   VkDescriptorSetLayoutCreateFlags,      Anvil::DescriptorSetLayoutCreateFlagBits);
 INJECT_BITFIELD_HELPER_FUNC_IMPLEMENTATION(Anvil::DeviceGroupPresentModeFlags,      VkDeviceGroupPresentModeFlagsKHR,      Anvil::DeviceGroupPresentModeFlagBits);
 INJECT_BITFIELD_HELPER_FUNC_IMPLEMENTATION(Anvil::ExternalFenceHandleTypeFlags,     VkExternalFenceHandleTypeFlagsKHR,     Anvil::ExternalFenceHandleTypeFlagBits);
 INJECT_BITFIELD_HELPER_FUNC_IMPLEMENTATION(Anvil::ExternalMemoryHandleTypeFlags,    VkExternalMemoryHandleTypeFlagsKHR,    Anvil::ExternalMemoryHandleTypeFlagBits);
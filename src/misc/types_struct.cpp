@@ -141,9 +141,10 @@ VkBufferMemoryBarrier Anvil::BufferBarrier::get_barrier_vk() const
     result.buffer              = buffer_ptr->get_buffer();
     result.dstAccessMask       = dst_access_mask.get_vk();
     result.dstQueueFamilyIndex = dst_queue_family_index;
-    result.offset              = offset;
+    result.offset              = buffer_ptr->get_buffer_offset_vk(offset);
     result.pNext               = nullptr;
-    result.size                = size;
+    result.size                = buffer_ptr->get_buffer_size_vk(offset,
+                                                                size);
     result.srcAccessMask       = src_access_mask.get_vk(),
     result.srcQueueFamilyIndex = src_queue_family_index;
     result.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
@@ -507,6 +508,12 @@ Anvil::ExtensionKHRMaintenance3Entrypoints::ExtensionKHRMaintenance3Entrypoints(
     vkGetDescriptorSetLayoutSupportKHR = nullptr;
 }
 
+Anvil::ExtensionKHRPushDescriptorEntrypoints::ExtensionKHRPushDescriptorEntrypoints()
+{
+    vkCmdPushDescriptorSetKHR             = nullptr;
+    vkCmdPushDescriptorSetWithTemplateKHR = nullptr;
+}
+
 Anvil::ExtensionKHRSamplerYCbCrConversionEntrypoints::ExtensionKHRSamplerYCbCrConversionEntrypoints()
 {
     vkCreateSamplerYcbcrConversionKHR  = nullptr;
@@ -531,6 +538,13 @@ Anvil::ExtensionKHRSwapchainEntrypoints::ExtensionKHRSwapchainEntrypoints()
     vkQueuePresentKHR       = nullptr;
 }
 
+Anvil::ExtensionKHRTimelineSemaphoreEntrypoints::ExtensionKHRTimelineSemaphoreEntrypoints()
+{
+    vkGetSemaphoreCounterValueKHR = nullptr;
+    vkSignalSemaphoreKHR          = nullptr;
+    vkWaitSemaphoresKHR           = nullptr;
+}
+
 #ifdef _WIN32
     #if defined(ANVIL_INCLUDE_WIN3264_WINDOW_SYSTEM_SUPPORT)
         Anvil::ExtensionKHRWin32SurfaceEntrypoints::ExtensionKHRWin32SurfaceEntrypoints()
@@ -1785,6 +1799,32 @@ bool Anvil::KHRShaderFloatControlsProperties::operator==(const KHRShaderFloatCon
         (shader_signed_zero_inf_nan_preserve_float64 == in_properties.shader_signed_zero_inf_nan_preserve_float64);
 }
 
+Anvil::KHRTimelineSemaphoreFeatures::KHRTimelineSemaphoreFeatures()
+{
+    timeline_semaphore = false;
+}
+
+Anvil::KHRTimelineSemaphoreFeatures::KHRTimelineSemaphoreFeatures(const VkPhysicalDeviceTimelineSemaphoreFeaturesKHR& in_features)
+{
+    timeline_semaphore = VK_BOOL32_TO_BOOL(in_features.timelineSemaphore);
+}
+
+VkPhysicalDeviceTimelineSemaphoreFeaturesKHR Anvil::KHRTimelineSemaphoreFeatures::get_vk_physical_device_timeline_semaphore_features() const
+{
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR result;
+
+    result.pNext             = nullptr;
+    result.sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    result.timelineSemaphore = BOOL_TO_VK_BOOL32(timeline_semaphore);
+
+    return result;
+}
+
+bool Anvil::KHRTimelineSemaphoreFeatures::operator==(const KHRTimelineSemaphoreFeatures& in_features) const
+{
+    return (in_features.timeline_semaphore == timeline_semaphore);
+}
+
 Anvil::KHRVariablePointerFeatures::KHRVariablePointerFeatures()
 {
     variable_pointers                = false;
@@ -2839,6 +2879,7 @@ Anvil::PhysicalDeviceFeatures::PhysicalDeviceFeatures()
     khr_multiview_features_ptr                = nullptr;
     khr_sampler_ycbcr_conversion_features_ptr = nullptr;
     khr_shader_atomic_int64_features_ptr      = nullptr;
+    khr_timeline_semaphore_features_ptr       = nullptr;
     khr_variable_pointer_features_ptr         = nullptr;
     khr_vulkan_memory_model_features_ptr      = nullptr;
 }
@@ -2857,6 +2898,7 @@ Anvil::PhysicalDeviceFeatures::PhysicalDeviceFeatures(const PhysicalDeviceFeatur
                                                       const KHRMultiviewFeatures*              in_khr_multiview_features_ptr,
                                                       const KHRSamplerYCbCrConversionFeatures* in_khr_sampler_ycbcr_conversion_features_ptr,
                                                       const KHRShaderAtomicInt64Features*      in_khr_shader_atomic_int64_features_ptr,
+                                                      const KHRTimelineSemaphoreFeatures*      in_khr_timeline_semaphore_features_ptr,
                                                       const KHRVariablePointerFeatures*        in_khr_variable_pointer_features_ptr,
                                                       const KHRVulkanMemoryModelFeatures*      in_khr_vulkan_memory_model_features_ptr)
 {
@@ -2874,6 +2916,7 @@ Anvil::PhysicalDeviceFeatures::PhysicalDeviceFeatures(const PhysicalDeviceFeatur
     khr_multiview_features_ptr                = in_khr_multiview_features_ptr;
     khr_sampler_ycbcr_conversion_features_ptr = in_khr_sampler_ycbcr_conversion_features_ptr;
     khr_shader_atomic_int64_features_ptr      = in_khr_shader_atomic_int64_features_ptr;
+    khr_timeline_semaphore_features_ptr       = in_khr_timeline_semaphore_features_ptr;
     khr_variable_pointer_features_ptr         = in_khr_variable_pointer_features_ptr;
     khr_vulkan_memory_model_features_ptr      = in_khr_vulkan_memory_model_features_ptr;
 }
@@ -2895,6 +2938,7 @@ bool Anvil::PhysicalDeviceFeatures::operator==(const PhysicalDeviceFeatures& in_
     bool       khr_multiview_features_match                = false;
     bool       khr_sampler_ycbcr_conversion_features_match = false;
     bool       khr_shader_atomic_int64_features_match      = false;
+    bool       khr_timeline_semaphore_features_match       = false;
     bool       khr_variable_pointer_features_match         = false;
     bool       khr_vulkan_memory_features_match            = false;
 
@@ -3036,6 +3080,17 @@ bool Anvil::PhysicalDeviceFeatures::operator==(const PhysicalDeviceFeatures& in_
                                                in_physical_device_features.khr_variable_pointer_features_ptr == nullptr);
     }
 
+    if (khr_timeline_semaphore_features_ptr                             != nullptr &&
+        in_physical_device_features.khr_timeline_semaphore_features_ptr != nullptr)
+    {
+        khr_timeline_semaphore_features_match = (*khr_timeline_semaphore_features_ptr == *in_physical_device_features.khr_timeline_semaphore_features_ptr);
+    }
+    else
+    {
+        khr_timeline_semaphore_features_match = (khr_timeline_semaphore_features_ptr                             == nullptr &&
+                                                 in_physical_device_features.khr_timeline_semaphore_features_ptr == nullptr);
+    }
+
     if (khr_vulkan_memory_model_features_ptr                             != nullptr &&
         in_physical_device_features.khr_vulkan_memory_model_features_ptr != nullptr)
     {
@@ -3061,6 +3116,7 @@ bool Anvil::PhysicalDeviceFeatures::operator==(const PhysicalDeviceFeatures& in_
            khr_multiview_features_match                &&
            khr_sampler_ycbcr_conversion_features_match &&
            khr_shader_atomic_int64_features_match      &&
+           khr_timeline_semaphore_features_match       &&
            khr_variable_pointer_features_match         &&
            khr_vulkan_memory_features_match;
 }
@@ -4122,6 +4178,14 @@ Anvil::SubmitInfo::SubmitInfo(uint32_t                         in_n_command_buff
      wait_semaphores_mgpu_ptr                      (nullptr),
      wait_semaphores_sgpu_ptr                      (in_opt_semaphore_to_wait_on_ptrs_ptr)
 {
+    n_timeline_signal_semaphores                = 0;
+    n_timeline_wait_semaphores                  = 0;
+    timeline_signal_semaphore_ptrs_ptr          = nullptr;
+    timeline_signal_semaphore_values_ptr        = nullptr;
+    timeline_wait_semaphore_dst_stage_masks_ptr = nullptr;
+    timeline_wait_semaphore_ptrs_ptr            = nullptr;
+    timeline_wait_semaphore_values_ptr          = nullptr;
+
     for (uint32_t n_wait_mask = 0;
                   n_wait_mask < in_n_semaphores_to_wait_on;
                 ++n_wait_mask)
@@ -4187,6 +4251,14 @@ Anvil::SubmitInfo::SubmitInfo(uint32_t                           in_n_command_bu
      wait_semaphores_mgpu_ptr                      (in_opt_wait_semaphore_submissions_ptr),
      wait_semaphores_sgpu_ptr                      (nullptr)
 {
+    n_timeline_signal_semaphores                = 0;
+    n_timeline_wait_semaphores                  = 0;
+    timeline_signal_semaphore_ptrs_ptr          = nullptr;
+    timeline_signal_semaphore_values_ptr        = nullptr;
+    timeline_wait_semaphore_dst_stage_masks_ptr = nullptr;
+    timeline_wait_semaphore_ptrs_ptr            = nullptr;
+    timeline_wait_semaphore_values_ptr          = nullptr;
+
     for (uint32_t n_wait_mask = 0;
                   n_wait_mask < in_n_wait_semaphore_submissions;
                 ++n_wait_mask)
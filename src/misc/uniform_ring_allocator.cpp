@@ -0,0 +1,335 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/buffer_create_info.h"
+#include "misc/debug.h"
+#include "misc/uniform_ring_allocator.h"
+#include "wrappers/buffer.h"
+#include "wrappers/device.h"
+#include "wrappers/memory_block.h"
+#include "wrappers/physical_device.h"
+#include "wrappers/queue.h"
+#include <algorithm>
+#include <cstring>
+
+/* Please see header for specification */
+Anvil::UniformRingAllocator::UniformRingAllocator(const std::vector<Anvil::Queue*>& in_queue_ptrs,
+                                                  VkDeviceSize                      in_alignment,
+                                                  VkDeviceSize                      in_frame_slot_size,
+                                                  uint32_t                          in_n_frame_slots)
+    :m_alignment                   (in_alignment),
+     m_current_frame_slot_used_size(0),
+     m_frame_slot_size             (in_frame_slot_size),
+     m_frame_slots                 (in_n_frame_slots),
+     m_is_frame_active             (false),
+     m_mapped_data_ptr             (nullptr),
+     m_n_current_frame_slot        (in_n_frame_slots - 1),
+     m_queue_ptrs                  (in_queue_ptrs)
+{
+    /* Stub */
+}
+
+/* Please see header for specification */
+Anvil::UniformRingAllocator::~UniformRingAllocator()
+{
+    anvil_assert(!m_is_frame_active);
+
+    if (m_mapped_data_ptr != nullptr)
+    {
+        auto memory_block_ptr = m_buffer_ptr->get_memory_block(0 /* in_n_memory_block */);
+
+        memory_block_ptr->unmap                  ();
+        memory_block_ptr->set_persistently_mapped(false);
+
+        m_mapped_data_ptr = nullptr;
+    }
+}
+
+/* Please see header for specification */
+bool Anvil::UniformRingAllocator::allocate(VkDeviceSize in_size,
+                                           void**       out_data_ptr,
+                                           uint32_t*    out_dynamic_offset_ptr)
+{
+    const VkDeviceSize aligned_size    (Anvil::Utils::round_up(in_size,
+                                                               m_alignment) );
+    VkDeviceSize       offset          (0);
+    bool               result          (false);
+    VkDeviceSize       slot_offset     (0);
+
+    anvil_assert(in_size                != 0);
+    anvil_assert(m_is_frame_active);
+    anvil_assert(out_data_ptr           != nullptr);
+    anvil_assert(out_dynamic_offset_ptr != nullptr);
+
+    slot_offset = m_current_frame_slot_used_size.fetch_add(aligned_size);
+
+    if (slot_offset                     > m_frame_slot_size ||
+        m_frame_slot_size - slot_offset < aligned_size)
+    {
+        /* The frame slot has run out of space. */
+        goto end;
+    }
+
+    offset = static_cast<VkDeviceSize>(m_n_current_frame_slot) * m_frame_slot_size + slot_offset;
+
+    *out_data_ptr           = m_mapped_data_ptr + offset;
+    *out_dynamic_offset_ptr = static_cast<uint32_t>(offset);
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::UniformRingAllocator::allocate_and_write(const void*  in_data_ptr,
+                                                     VkDeviceSize in_size,
+                                                     uint32_t*    out_dynamic_offset_ptr)
+{
+    void* data_ptr = nullptr;
+    bool  result   = false;
+
+    anvil_assert(in_data_ptr != nullptr);
+
+    if (!allocate(in_size,
+                 &data_ptr,
+                  out_dynamic_offset_ptr) )
+    {
+        goto end;
+    }
+
+    memcpy(data_ptr,
+           in_data_ptr,
+           static_cast<size_t>(in_size) );
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::UniformRingAllocator::begin_frame(uint64_t in_timeout)
+{
+    const uint32_t n_frame_slot   ((m_n_current_frame_slot + 1) % static_cast<uint32_t>(m_frame_slots.size() ));
+    auto&          frame_slot     (m_frame_slots.at(n_frame_slot) );
+    bool           result         (false);
+
+    anvil_assert(!m_is_frame_active);
+
+    /* Make sure the GPU is no longer reading from the slot before letting the app overwrite its contents. */
+    if (frame_slot.submission_tracking_values.size() > 0)
+    {
+        anvil_assert(frame_slot.submission_tracking_values.size() == m_queue_ptrs.size() );
+
+        for (uint32_t n_queue = 0;
+                      n_queue < static_cast<uint32_t>(m_queue_ptrs.size() );
+                    ++n_queue)
+        {
+            if (!m_queue_ptrs.at(n_queue)->wait_for_submission_tracking_value(frame_slot.submission_tracking_values.at(n_queue),
+                                                                              in_timeout) )
+            {
+                goto end;
+            }
+        }
+
+        frame_slot.submission_tracking_values.clear();
+    }
+
+    m_current_frame_slot_used_size = 0;
+    m_is_frame_active              = true;
+    m_n_current_frame_slot         = n_frame_slot;
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::UniformRingAllocatorUniquePtr Anvil::UniformRingAllocator::create(const Anvil::BaseDevice*          in_device_ptr,
+                                                                         const std::vector<Anvil::Queue*>& in_queue_ptrs,
+                                                                         VkDeviceSize                      in_frame_slot_size,
+                                                                         uint32_t                          in_n_frame_slots,
+                                                                         Anvil::BufferUsageFlags           in_usage_flags)
+{
+    VkDeviceSize                         alignment      (1);
+    VkDeviceSize                         frame_slot_size(0);
+    Anvil::UniformRingAllocatorUniquePtr result_ptr     (nullptr,
+                                                         std::default_delete<Anvil::UniformRingAllocator>() );
+
+    anvil_assert(in_device_ptr        != nullptr);
+    anvil_assert(in_queue_ptrs.size() >  0);
+    anvil_assert(in_frame_slot_size   >  0);
+    anvil_assert(in_n_frame_slots     >  0);
+
+    {
+        const auto& limits(in_device_ptr->get_physical_device_properties().core_vk1_0_properties_ptr->limits);
+
+        if ((in_usage_flags & Anvil::BufferUsageFlagBits::UNIFORM_BUFFER_BIT) != 0)
+        {
+            alignment = std::max(alignment,
+                                 limits.min_uniform_buffer_offset_alignment);
+        }
+
+        if ((in_usage_flags & Anvil::BufferUsageFlagBits::STORAGE_BUFFER_BIT) != 0)
+        {
+            alignment = std::max(alignment,
+                                 limits.min_storage_buffer_offset_alignment);
+        }
+    }
+
+    frame_slot_size = Anvil::Utils::round_up(in_frame_slot_size,
+                                             alignment);
+
+    /* Dynamic offsets are 32-bit */
+    if (frame_slot_size * in_n_frame_slots > static_cast<VkDeviceSize>(UINT32_MAX) + 1)
+    {
+        anvil_assert(frame_slot_size * in_n_frame_slots <= static_cast<VkDeviceSize>(UINT32_MAX) + 1);
+
+        goto end;
+    }
+
+    result_ptr.reset(
+        new Anvil::UniformRingAllocator(in_queue_ptrs,
+                                        alignment,
+                                        frame_slot_size,
+                                        in_n_frame_slots)
+    );
+
+    if (!result_ptr->init(in_device_ptr,
+                          in_usage_flags) )
+    {
+        result_ptr.reset();
+    }
+
+end:
+    return result_ptr;
+}
+
+/* Please see header for specification */
+void Anvil::UniformRingAllocator::end_frame()
+{
+    auto& frame_slot(m_frame_slots.at(m_n_current_frame_slot) );
+
+    anvil_assert(m_is_frame_active);
+
+    frame_slot.submission_tracking_values.resize(m_queue_ptrs.size() );
+
+    for (uint32_t n_queue = 0;
+                  n_queue < static_cast<uint32_t>(m_queue_ptrs.size() );
+                ++n_queue)
+    {
+        frame_slot.submission_tracking_values.at(n_queue) = m_queue_ptrs.at(n_queue)->get_submission_tracking_value();
+    }
+
+    m_is_frame_active = false;
+}
+
+/* Please see header for specification */
+VkDeviceSize Anvil::UniformRingAllocator::get_used_size() const
+{
+    return std::min(m_current_frame_slot_used_size.load(),
+                    m_frame_slot_size);
+}
+
+/** Creates the ring buffer, backed by host-coherent memory, and maps its storage persistently.
+ *
+ *  @param in_device_ptr  Device to use. Must not be nullptr.
+ *  @param in_usage_flags Usage flags to create the buffer with.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::UniformRingAllocator::init(const Anvil::BaseDevice* in_device_ptr,
+                                       Anvil::BufferUsageFlags  in_usage_flags)
+{
+    Anvil::BufferCreateInfoUniquePtr create_info_ptr;
+    Anvil::MemoryBlock*              memory_block_ptr   (nullptr);
+    void*                            mapped_data_ptr    (nullptr);
+    std::vector<uint32_t>            queue_family_indices;
+    Anvil::QueueFamilyFlags          queue_families;
+    bool                             result             (false);
+    const VkDeviceSize               size               (m_frame_slot_size * m_frame_slots.size() );
+
+    for (const auto& current_queue_ptr : m_queue_ptrs)
+    {
+        const uint32_t queue_family_index(current_queue_ptr->get_queue_family_index() );
+
+        queue_families |= Anvil::Utils::get_queue_family_flags_from_queue_family_type(in_device_ptr->get_queue_family_type(queue_family_index) );
+
+        if (std::find(queue_family_indices.begin(),
+                      queue_family_indices.end  (),
+                      queue_family_index) == queue_family_indices.end() )
+        {
+            queue_family_indices.push_back(queue_family_index);
+        }
+    }
+
+    create_info_ptr = Anvil::BufferCreateInfo::create_alloc(in_device_ptr,
+                                                            size,
+                                                            queue_families,
+                                                            (queue_family_indices.size() > 1) ? Anvil::SharingMode::CONCURRENT
+                                                                                              : Anvil::SharingMode::EXCLUSIVE,
+                                                            Anvil::BufferCreateFlagBits::NONE,
+                                                            in_usage_flags,
+                                                            Anvil::MemoryFeatureFlagBits::MAPPABLE_BIT | Anvil::MemoryFeatureFlagBits::HOST_COHERENT_BIT);
+
+    m_buffer_ptr = Anvil::Buffer::create(std::move(create_info_ptr) );
+
+    if (m_buffer_ptr == nullptr)
+    {
+        anvil_assert(m_buffer_ptr != nullptr);
+
+        goto end;
+    }
+
+    memory_block_ptr = m_buffer_ptr->get_memory_block(0 /* in_n_memory_block */);
+
+    if (memory_block_ptr == nullptr)
+    {
+        anvil_assert(memory_block_ptr != nullptr);
+
+        goto end;
+    }
+
+    /* Keep the storage mapped for the lifetime of the allocator, so that allocations boil down to a pointer bump. */
+    if (!memory_block_ptr->set_persistently_mapped(true) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (!memory_block_ptr->map(0, /* in_start_offset */
+                               size,
+                              &mapped_data_ptr) )
+    {
+        anvil_assert_fail();
+
+        memory_block_ptr->set_persistently_mapped(false);
+
+        goto end;
+    }
+
+    m_mapped_data_ptr = static_cast<char*>(mapped_data_ptr);
+
+    result = true;
+end:
+    return result;
+}
@@ -40,6 +40,7 @@ Anvil::Buffer::Buffer(Anvil::BufferCreateInfoUniquePtr in_create_info_ptr)
      MTSafetySupportProvider           (Anvil::Utils::convert_mt_safety_enum_to_boolean(in_create_info_ptr->get_mt_safety(),
                                                                                         in_create_info_ptr->get_device   () )),
      m_buffer                          (VK_NULL_HANDLE),
+     m_buffer_start_offset             (0),
      m_memory_block_ptr                (nullptr),
      m_prefers_dedicated_allocation    (false),
      m_requires_dedicated_allocation   (false),
@@ -146,6 +147,25 @@ VkBuffer Anvil::Buffer::get_buffer(const bool& in_bake_memory_if_necessary)
     return m_buffer;
 }
 
+/* Please see header for specification */
+VkDeviceSize Anvil::Buffer::get_buffer_size_vk(VkDeviceSize in_offset,
+                                               VkDeviceSize in_size) const
+{
+    const VkDeviceSize buffer_size = m_create_info_ptr->get_size();
+    VkDeviceSize       result      = in_size;
+
+    if (in_size                      == VK_WHOLE_SIZE                        &&
+        m_create_info_ptr->get_type() == Anvil::BufferType::NO_ALLOC_CHILD)
+    {
+        anvil_assert(in_offset <= buffer_size);
+
+        result = (in_offset <= buffer_size) ? (buffer_size - in_offset)
+                                            : 0;
+    }
+
+    return result;
+}
+
 /* Please see header for specification */
 Anvil::MemoryBlock* Anvil::Buffer::get_memory_block(uint32_t in_n_memory_block)
 {
@@ -361,7 +381,8 @@ bool Anvil::Buffer::init()
     }
     else
     {
-        m_buffer = m_create_info_ptr->get_parent_buffer_ptr()->m_buffer;
+        m_buffer              = m_create_info_ptr->get_parent_buffer_ptr()->m_buffer;
+        m_buffer_start_offset = m_create_info_ptr->get_parent_buffer_ptr()->m_buffer_start_offset + m_create_info_ptr->get_start_offset();
 
         anvil_assert(m_buffer != VK_NULL_HANDLE);
         if (m_buffer != VK_NULL_HANDLE)
@@ -1109,6 +1130,40 @@ bool Anvil::Buffer::write(VkDeviceSize  in_start_offset,
                           const void*   in_data,
                           uint32_t      in_device_mask,
                           Anvil::Queue* in_opt_queue_ptr)
+{
+    anvil_assert(in_data != nullptr);
+
+    return write_with_producer(in_start_offset,
+                               in_size,
+                               [in_data](void* out_data_ptr, VkDeviceSize in_data_size)
+                               {
+                                   memcpy(out_data_ptr,
+                                          in_data,
+                                          static_cast<size_t>(in_data_size) );
+                               },
+                               in_device_mask,
+                               in_opt_queue_ptr);
+}
+
+/* Please see header for specification */
+bool Anvil::Buffer::write_with_producer(VkDeviceSize                       in_start_offset,
+                                        VkDeviceSize                       in_size,
+                                        const MemoryWriteProducerFunction& in_producer_function,
+                                        Anvil::Queue*                      in_opt_queue_ptr)
+{
+    return write_with_producer(in_start_offset,
+                               in_size,
+                               in_producer_function,
+                               UINT32_MAX, /* in_device_mask */
+                               in_opt_queue_ptr);
+}
+
+/* Please see header for specification */
+bool Anvil::Buffer::write_with_producer(VkDeviceSize                       in_start_offset,
+                                        VkDeviceSize                       in_size,
+                                        const MemoryWriteProducerFunction& in_producer_function,
+                                        uint32_t                           in_device_mask,
+                                        Anvil::Queue*                      in_opt_queue_ptr)
 {
     const Anvil::DeviceType device_type(m_device_ptr->get_type() );
     bool                    result     (false);
@@ -1129,9 +1184,9 @@ bool Anvil::Buffer::write(VkDeviceSize  in_start_offset,
     {
         anvil_assert((memory_block_ptr->get_create_info_ptr()->get_memory_features() & Anvil::MemoryFeatureFlagBits::MULTI_INSTANCE_BIT) == 0);
 
-        result = memory_block_ptr->write(in_start_offset,
-                                         in_size,
-                                         in_data);
+        result = memory_block_ptr->write_with_producer(in_start_offset,
+                                                       in_size,
+                                                       in_producer_function);
     }
     else
     {
@@ -1153,9 +1208,9 @@ bool Anvil::Buffer::write(VkDeviceSize  in_start_offset,
             anvil_assert(m_staging_buffer_ptr != nullptr);
         }
 
-        m_staging_buffer_ptr->write(0, /* in_start_offset */
-                                    in_size,
-                                    in_data);
+        m_staging_buffer_ptr->write_with_producer(0, /* in_start_offset */
+                                                  in_size,
+                                                  in_producer_function);
 
         copy_cmdbuf_ptr = m_device_ptr->get_command_pool_for_queue_family_index(m_staging_buffer_queue_ptr->get_queue_family_index() )->alloc_primary_level_command_buffer();
 
@@ -93,7 +93,7 @@ bool Anvil::BufferView::init()
     buffer_view_create_info.buffer = m_create_info_ptr->get_parent_buffer()->get_buffer();
     buffer_view_create_info.flags  = 0;
     buffer_view_create_info.format = static_cast<VkFormat>(m_create_info_ptr->get_format() );
-    buffer_view_create_info.offset = m_create_info_ptr->get_start_offset();
+    buffer_view_create_info.offset = m_create_info_ptr->get_parent_buffer()->get_buffer_offset_vk(m_create_info_ptr->get_start_offset() );
     buffer_view_create_info.pNext  = nullptr;
     buffer_view_create_info.range  = m_create_info_ptr->get_size();
     buffer_view_create_info.sType  = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO;
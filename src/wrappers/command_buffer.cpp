@@ -24,6 +24,7 @@
 #include "misc/debug.h"
 #include "misc/descriptor_set_create_info.h"
 #include "misc/memory_block_create_info.h"
+#include "misc/push_descriptor_set_info.h"
 #include "misc/struct_chainer.h"
 #include "wrappers/buffer.h"
 #include "wrappers/buffer_view.h"
@@ -32,6 +33,7 @@
 #include "wrappers/compute_pipeline_manager.h"
 #include "wrappers/descriptor_set.h"
 #include "wrappers/descriptor_set_layout.h"
+#include "wrappers/descriptor_update_template.h"
 #include "wrappers/device.h"
 #include "wrappers/event.h"
 #include "wrappers/framebuffer.h"
@@ -44,12 +46,58 @@
 #include "wrappers/pipeline_layout.h"
 #include "wrappers/query_pool.h"
 #include "wrappers/render_pass.h"
+#include <cstring>
 
 
 /* Command stashing should be enabled by default for builds that care. */
 bool Anvil::CommandBufferBase::m_command_stashing_disabled = false;
 
 
+/* Number of copy regions whose offsets can be rebased without a heap allocation */
+#define N_PREALLOCATED_COPY_REGIONS (16)
+
+
+/** Returns storage for @param in_n_regions copy regions: @param in_preallocated_regions_ptr, which must be able to hold
+ *  N_PREALLOCATED_COPY_REGIONS items, if the regions fit in it, or @param in_heap_regions_ptr resized to hold them
+ *  otherwise.
+ **/
+template<typename RegionType>
+static RegionType* get_copy_region_storage(uint32_t                 in_n_regions,
+                                           RegionType*              in_preallocated_regions_ptr,
+                                           std::vector<RegionType>* in_heap_regions_ptr)
+{
+    if (in_n_regions <= N_PREALLOCATED_COPY_REGIONS)
+    {
+        return in_preallocated_regions_ptr;
+    }
+
+    in_heap_regions_ptr->resize(in_n_regions);
+
+    return in_heap_regions_ptr->data();
+}
+
+/** Tells whether a region of @param in_size bytes, starting at @param in_offset, lies within storage exposed by
+ *  @param in_buffer_ptr. VK_WHOLE_SIZE is accepted for @param in_size.
+ *
+ *  Copy, fill and update commands use this to catch accesses which would spill over the storage of a NO_ALLOC_CHILD
+ *  buffer (eg. one handed out by BufferSubAllocator) into whatever follows it in the parent buffer.
+ **/
+static bool is_buffer_region_valid(const Anvil::Buffer* in_buffer_ptr,
+                                   VkDeviceSize         in_offset,
+                                   VkDeviceSize         in_size)
+{
+    const VkDeviceSize buffer_size = in_buffer_ptr->get_create_info_ptr()->get_size();
+
+    if (in_size == VK_WHOLE_SIZE)
+    {
+        return (in_offset < buffer_size);
+    }
+
+    return (in_offset <= buffer_size           &&
+            in_size   <= buffer_size - in_offset);
+}
+
+
 /** Please see header for specification */
 Anvil::CommandBufferBase::BeginQueryCommand::BeginQueryCommand(Anvil::QueryPool*        in_query_pool_ptr,
                                                                Anvil::QueryIndex        in_entry,
@@ -812,6 +860,28 @@ Anvil::CommandBufferBase::PushConstantsCommand::PushConstantsCommand(Anvil::Pipe
     values      = in_values;
 }
 
+/** Please see header for specification */
+Anvil::CommandBufferBase::PushDescriptorSetKHRCommand::PushDescriptorSetKHRCommand(Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                                                                   Anvil::PipelineLayout*   in_layout_ptr,
+                                                                                   uint32_t                 in_n_set,
+                                                                                   uint32_t                 in_n_writes)
+    :Command(COMMAND_TYPE_PUSH_DESCRIPTOR_SET_KHR)
+{
+    layout_ptr          = in_layout_ptr;
+    n_set               = in_n_set;
+    n_writes            = in_n_writes;
+    pipeline_bind_point = in_pipeline_bind_point;
+}
+
+/** Please see header for specification */
+Anvil::CommandBufferBase::PushDescriptorSetWithTemplateKHRCommand::PushDescriptorSetWithTemplateKHRCommand(const Anvil::DescriptorUpdateTemplate* in_template_ptr,
+                                                                                                           const void*                            in_data_ptr)
+    :Command(COMMAND_TYPE_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE_KHR)
+{
+    data_ptr     = in_data_ptr;
+    template_ptr = in_template_ptr;
+}
+
 /** Please see header for specification */
 Anvil::CommandBufferBase::ResetEventCommand::ResetEventCommand(Anvil::Event*             in_event_ptr,
                                                                Anvil::PipelineStageFlags in_stage_mask)
@@ -1071,19 +1141,20 @@ Anvil::CommandBufferBase::CommandBufferBase(const Anvil::BaseDevice* in_device_p
                                             Anvil::CommandPool*      in_parent_command_pool_ptr,
                                             Anvil::CommandBufferType in_type,
                                             bool                     in_mt_safe)
-    :MTSafetySupportProvider        (in_mt_safe),
-     DebugMarkerSupportProvider     (in_device_ptr,
-                                     Anvil::ObjectType::COMMAND_BUFFER),
-     CallbacksSupportProvider       (COMMAND_BUFFER_CALLBACK_ID_COUNT),
-     m_command_buffer               (VK_NULL_HANDLE),
-     m_device_mask                  (0),
-     m_device_ptr                   (in_device_ptr),
-     m_is_renderpass_active         (false),
-     m_n_debug_label_regions_started(0),
-     m_parent_command_pool_ptr      (in_parent_command_pool_ptr),
-     m_recording_in_progress        (false),
-     m_renderpass_device_mask       (0),
-     m_type                         (in_type)
+    :MTSafetySupportProvider               (in_mt_safe),
+     DebugMarkerSupportProvider            (in_device_ptr,
+                                            Anvil::ObjectType::COMMAND_BUFFER),
+     CallbacksSupportProvider              (COMMAND_BUFFER_CALLBACK_ID_COUNT),
+     m_command_buffer                      (VK_NULL_HANDLE),
+     m_device_mask                         (0),
+     m_device_ptr                          (in_device_ptr),
+     m_is_redundant_state_filtering_enabled(false),
+     m_is_renderpass_active                (false),
+     m_n_debug_label_regions_started       (0),
+     m_parent_command_pool_ptr             (in_parent_command_pool_ptr),
+     m_recording_in_progress               (false),
+     m_renderpass_device_mask              (0),
+     m_type                                (in_type)
 {
     anvil_assert(in_parent_command_pool_ptr != nullptr);
 }
@@ -1310,9 +1381,10 @@ bool Anvil::CommandBufferBase::record_begin_transform_feedback_EXT(const uint32_
                                                                    Anvil::Buffer**     in_opt_counter_buffer_ptrs,
                                                                    const VkDeviceSize* in_opt_counter_buffer_offsets)
 {
-    auto        counter_buffer_ptrs = std::vector<VkBuffer>(in_n_counter_buffers);
-    const auto& entrypoints         = m_device_ptr->get_extension_ext_transform_feedback_entrypoints();
-    bool        result              = false;
+    auto        counter_buffer_offsets = std::vector<VkDeviceSize>(in_n_counter_buffers, 0);
+    auto        counter_buffer_ptrs    = std::vector<VkBuffer>    (in_n_counter_buffers);
+    const auto& entrypoints            = m_device_ptr->get_extension_ext_transform_feedback_entrypoints();
+    bool        result                 = false;
 
     if (!m_is_renderpass_active)
     {
@@ -1334,6 +1406,14 @@ bool Anvil::CommandBufferBase::record_begin_transform_feedback_EXT(const uint32_
     {
         counter_buffer_ptrs.at(n_counter_buffer) = (in_opt_counter_buffer_ptrs != nullptr && in_opt_counter_buffer_ptrs[n_counter_buffer] != nullptr) ? in_opt_counter_buffer_ptrs[n_counter_buffer]->get_buffer()
                                                                                                                                                       : VK_NULL_HANDLE;
+
+        if (counter_buffer_ptrs.at(n_counter_buffer) != VK_NULL_HANDLE)
+        {
+            const VkDeviceSize offset = (in_opt_counter_buffer_offsets != nullptr) ? in_opt_counter_buffer_offsets[n_counter_buffer]
+                                                                                   : 0;
+
+            counter_buffer_offsets.at(n_counter_buffer) = in_opt_counter_buffer_ptrs[n_counter_buffer]->get_buffer_offset_vk(offset);
+        }
     }
 
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
@@ -1373,8 +1453,8 @@ bool Anvil::CommandBufferBase::record_begin_transform_feedback_EXT(const uint32_
         entrypoints.vkCmdBeginTransformFeedbackEXT(m_command_buffer,
                                                    in_first_counter_buffer,
                                                    in_n_counter_buffers,
-                                                   (counter_buffer_ptrs.size() > 0) ? &counter_buffer_ptrs.at(0) : nullptr,
-                                                   in_opt_counter_buffer_offsets);
+                                                   (in_n_counter_buffers > 0) ? &counter_buffer_ptrs.at   (0) : nullptr,
+                                                   (in_n_counter_buffers > 0) ? &counter_buffer_offsets.at(0) : nullptr);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1411,6 +1491,21 @@ bool Anvil::CommandBufferBase::record_bind_descriptor_sets(Anvil::PipelineBindPo
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_bind_descriptor_sets(in_pipeline_bind_point,
+                                          in_layout_ptr,
+                                          in_first_set,
+                                          in_set_count,
+                                          (in_set_count > 0) ? &dss_vk.at(0) : nullptr,
+                                          in_dynamic_offset_count,
+                                          in_dynamic_offset_ptrs) )
+    {
+        m_elided_call_counters.n_bind_descriptor_sets_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -1461,6 +1556,17 @@ bool Anvil::CommandBufferBase::record_bind_index_buffer(Anvil::Buffer*   in_buff
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_bind_index_buffer(in_buffer_ptr->get_buffer(),
+                                       in_buffer_ptr->get_buffer_offset_vk(in_offset),
+                                       in_index_type) )
+    {
+        m_elided_call_counters.n_bind_index_buffer_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -1477,7 +1583,7 @@ bool Anvil::CommandBufferBase::record_bind_index_buffer(Anvil::Buffer*   in_buff
     {
         Anvil::Vulkan::vkCmdBindIndexBuffer(m_command_buffer,
                                             in_buffer_ptr->get_buffer(),
-                                            in_offset,
+                                            in_buffer_ptr->get_buffer_offset_vk(in_offset),
                                             static_cast<VkIndexType>(in_index_type) );
     }
     unlock();
@@ -1509,6 +1615,16 @@ bool Anvil::CommandBufferBase::record_bind_pipeline(Anvil::PipelineBindPoint in_
     pipeline_vk = (in_pipeline_bind_point == Anvil::PipelineBindPoint::COMPUTE) ? m_device_ptr->get_compute_pipeline_manager ()->get_pipeline(in_pipeline_id)
                                                                                 : m_device_ptr->get_graphics_pipeline_manager()->get_pipeline(in_pipeline_id);
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_bind_pipeline(in_pipeline_bind_point,
+                                   pipeline_vk) )
+    {
+        m_elided_call_counters.n_bind_pipeline_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -1547,6 +1663,16 @@ bool Anvil::CommandBufferBase::record_bind_vk_pipeline(Anvil::PipelineBindPoint
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_bind_pipeline(in_pipeline_bind_point,
+                                   in_pipeline_vk) )
+    {
+        m_elided_call_counters.n_bind_pipeline_calls++;
+
+        result = true;
+        goto end;
+    }
+
 #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -1580,9 +1706,11 @@ bool Anvil::CommandBufferBase::record_bind_transform_feedback_buffers_EXT(const
                                                                           const VkDeviceSize* in_sizes_ptr)
 {
     /* Note: Command supported inside and outside the renderpass. */
-    auto        buffers     = std::vector<VkBuffer>(in_n_bindings);
+    auto        buffers     = std::vector<VkBuffer>    (in_n_bindings);
     const auto& entrypoints = m_device_ptr->get_extension_ext_transform_feedback_entrypoints ();
+    auto        offsets     = std::vector<VkDeviceSize>(in_n_bindings);
     bool        result      = false;
+    auto        sizes       = std::vector<VkDeviceSize>(in_n_bindings);
 
     if (!m_recording_in_progress)
     {
@@ -1621,7 +1749,11 @@ bool Anvil::CommandBufferBase::record_bind_transform_feedback_buffers_EXT(const
                   n_binding < in_n_bindings;
                 ++n_binding)
     {
-        buffers.at(n_binding) = in_buffer_ptrs[n_binding]->get_buffer();
+        buffers.at(n_binding) = in_buffer_ptrs[n_binding]->get_buffer         ();
+        offsets.at(n_binding) = in_buffer_ptrs[n_binding]->get_buffer_offset_vk(in_offsets_ptr[n_binding]);
+        sizes.at  (n_binding) = in_buffer_ptrs[n_binding]->get_buffer_size_vk  (in_offsets_ptr[n_binding],
+                                                                                (in_sizes_ptr != nullptr) ? in_sizes_ptr[n_binding]
+                                                                                                          : VK_WHOLE_SIZE);
     }
 
     m_parent_command_pool_ptr->lock();
@@ -1631,8 +1763,8 @@ bool Anvil::CommandBufferBase::record_bind_transform_feedback_buffers_EXT(const
                                                          in_first_binding,
                                                          in_n_bindings,
                                                          (in_n_bindings > 0) ? &buffers.at(0) : nullptr,
-                                                         in_offsets_ptr,
-                                                         in_sizes_ptr);
+                                                         (in_n_bindings > 0) ? &offsets.at(0) : nullptr,
+                                                         (in_n_bindings > 0) ? &sizes.at  (0) : nullptr);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1649,7 +1781,8 @@ bool Anvil::CommandBufferBase::record_bind_vertex_buffers(uint32_t            in
                                                           const VkDeviceSize* in_offset_ptrs)
 {
     /* Note: Command supported inside and outside the renderpass. */
-    auto buffers = std::vector<VkBuffer>(in_binding_count);
+    auto buffers = std::vector<VkBuffer>    (in_binding_count);
+    auto offsets = std::vector<VkDeviceSize>(in_binding_count);
     bool result  = false;
 
     if (!m_recording_in_progress)
@@ -1659,6 +1792,26 @@ bool Anvil::CommandBufferBase::record_bind_vertex_buffers(uint32_t            in
         goto end;
     }
 
+    for (uint32_t n_binding = 0;
+                  n_binding < in_binding_count;
+                ++n_binding)
+    {
+        buffers.at(n_binding) = in_buffer_ptrs[n_binding]->get_buffer();
+        offsets.at(n_binding) = in_buffer_ptrs[n_binding]->get_buffer_offset_vk(in_offset_ptrs[n_binding]);
+    }
+
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_bind_vertex_buffers(in_start_binding,
+                                         in_binding_count,
+                                         (in_binding_count > 0) ? &buffers.at(0) : nullptr,
+                                         (in_binding_count > 0) ? &offsets.at(0) : nullptr) )
+    {
+        m_elided_call_counters.n_bind_vertex_buffers_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -1671,13 +1824,6 @@ bool Anvil::CommandBufferBase::record_bind_vertex_buffers(uint32_t            in
     }
     #endif
 
-    for (uint32_t n_binding = 0;
-                  n_binding < in_binding_count;
-                ++n_binding)
-    {
-        buffers.at(n_binding) = in_buffer_ptrs[n_binding]->get_buffer();
-    }
-
     m_parent_command_pool_ptr->lock();
     lock();
     {
@@ -1685,7 +1831,7 @@ bool Anvil::CommandBufferBase::record_bind_vertex_buffers(uint32_t            in
                                               in_start_binding,
                                               in_binding_count,
                                               (in_binding_count > 0) ? &buffers.at(0) : nullptr,
-                                              in_offset_ptrs);
+                                              (in_binding_count > 0) ? &offsets.at(0) : nullptr);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1920,7 +2066,10 @@ bool Anvil::CommandBufferBase::record_copy_buffer(Anvil::Buffer*           in_sr
                                                   uint32_t                 in_region_count,
                                                   const Anvil::BufferCopy* in_region_ptrs)
 {
-    bool result = false;
+    std::vector<VkBufferCopy> heap_regions_vk;
+    VkBufferCopy              preallocated_regions_vk[N_PREALLOCATED_COPY_REGIONS];
+    const VkBufferCopy*       regions_vk_ptr          = reinterpret_cast<const VkBufferCopy*>(in_region_ptrs);
+    bool                      result                  = false;
 
     if (m_is_renderpass_active)
     {
@@ -1936,6 +2085,47 @@ bool Anvil::CommandBufferBase::record_copy_buffer(Anvil::Buffer*           in_sr
         goto end;
     }
 
+    for (uint32_t n_region = 0;
+                  n_region < in_region_count;
+                ++n_region)
+    {
+        const auto& current_region = in_region_ptrs[n_region];
+
+        if (!is_buffer_region_valid(in_src_buffer_ptr,
+                                    current_region.src_offset,
+                                    current_region.size)     ||
+            !is_buffer_region_valid(in_dst_buffer_ptr,
+                                    current_region.dst_offset,
+                                    current_region.size) )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+    }
+
+    /* Offsets only need to be rebased if any of the buffers is a NO_ALLOC_CHILD buffer */
+    if (in_src_buffer_ptr->get_buffer_start_offset() != 0 ||
+        in_dst_buffer_ptr->get_buffer_start_offset() != 0)
+    {
+        VkBufferCopy* rebased_regions_vk_ptr = get_copy_region_storage(in_region_count,
+                                                                       preallocated_regions_vk,
+                                                                      &heap_regions_vk);
+
+        for (uint32_t n_region = 0;
+                      n_region < in_region_count;
+                    ++n_region)
+        {
+            const auto& current_region = in_region_ptrs[n_region];
+
+            rebased_regions_vk_ptr[n_region].dstOffset = in_dst_buffer_ptr->get_buffer_offset_vk(current_region.dst_offset);
+            rebased_regions_vk_ptr[n_region].size      = current_region.size;
+            rebased_regions_vk_ptr[n_region].srcOffset = in_src_buffer_ptr->get_buffer_offset_vk(current_region.src_offset);
+        }
+
+        regions_vk_ptr = rebased_regions_vk_ptr;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -1955,7 +2145,7 @@ bool Anvil::CommandBufferBase::record_copy_buffer(Anvil::Buffer*           in_sr
                                        in_src_buffer_ptr->get_buffer(),
                                        in_dst_buffer_ptr->get_buffer(),
                                        in_region_count,
-                                       reinterpret_cast<const VkBufferCopy*>(in_region_ptrs) );
+                                       regions_vk_ptr);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -1972,7 +2162,10 @@ bool Anvil::CommandBufferBase::record_copy_buffer_to_image(Anvil::Buffer*
                                                            uint32_t                      in_region_count,
                                                            const Anvil::BufferImageCopy* in_region_ptrs)
 {
-    bool result = false;
+    std::vector<Anvil::BufferImageCopy> heap_regions;
+    Anvil::BufferImageCopy              preallocated_regions[N_PREALLOCATED_COPY_REGIONS];
+    const Anvil::BufferImageCopy*       regions_ptr          = in_region_ptrs;
+    bool                                result               = false;
 
     if (m_is_renderpass_active)
     {
@@ -1988,6 +2181,24 @@ bool Anvil::CommandBufferBase::record_copy_buffer_to_image(Anvil::Buffer*
         goto end;
     }
 
+    /* Offsets only need to be rebased if the buffer is a NO_ALLOC_CHILD buffer */
+    if (in_src_buffer_ptr->get_buffer_start_offset() != 0)
+    {
+        Anvil::BufferImageCopy* rebased_regions_ptr = get_copy_region_storage(in_region_count,
+                                                                              preallocated_regions,
+                                                                             &heap_regions);
+
+        for (uint32_t n_region = 0;
+                      n_region < in_region_count;
+                    ++n_region)
+        {
+            rebased_regions_ptr[n_region]               = in_region_ptrs[n_region];
+            rebased_regions_ptr[n_region].buffer_offset = in_src_buffer_ptr->get_buffer_offset_vk(in_region_ptrs[n_region].buffer_offset);
+        }
+
+        regions_ptr = rebased_regions_ptr;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -2009,7 +2220,7 @@ bool Anvil::CommandBufferBase::record_copy_buffer_to_image(Anvil::Buffer*
                                               in_dst_image_ptr->get_image(),
                                               static_cast<VkImageLayout>(in_dst_image_layout),
                                               in_region_count,
-                                              reinterpret_cast<const VkBufferImageCopy*>(in_region_ptrs) );
+                                              reinterpret_cast<const VkBufferImageCopy*>(regions_ptr) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2083,7 +2294,10 @@ bool Anvil::CommandBufferBase::record_copy_image_to_buffer(Anvil::Image*
                                                            uint32_t                      in_region_count,
                                                            const Anvil::BufferImageCopy* in_region_ptrs)
 {
-    bool result = false;
+    std::vector<Anvil::BufferImageCopy> heap_regions;
+    Anvil::BufferImageCopy              preallocated_regions[N_PREALLOCATED_COPY_REGIONS];
+    const Anvil::BufferImageCopy*       regions_ptr          = in_region_ptrs;
+    bool                                result               = false;
 
     if (m_is_renderpass_active)
     {
@@ -2099,6 +2313,24 @@ bool Anvil::CommandBufferBase::record_copy_image_to_buffer(Anvil::Image*
         goto end;
     }
 
+    /* Offsets only need to be rebased if the buffer is a NO_ALLOC_CHILD buffer */
+    if (in_dst_buffer_ptr->get_buffer_start_offset() != 0)
+    {
+        Anvil::BufferImageCopy* rebased_regions_ptr = get_copy_region_storage(in_region_count,
+                                                                              preallocated_regions,
+                                                                             &heap_regions);
+
+        for (uint32_t n_region = 0;
+                      n_region < in_region_count;
+                    ++n_region)
+        {
+            rebased_regions_ptr[n_region]               = in_region_ptrs[n_region];
+            rebased_regions_ptr[n_region].buffer_offset = in_dst_buffer_ptr->get_buffer_offset_vk(in_region_ptrs[n_region].buffer_offset);
+        }
+
+        regions_ptr = rebased_regions_ptr;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -2120,7 +2352,7 @@ bool Anvil::CommandBufferBase::record_copy_image_to_buffer(Anvil::Image*
                                               static_cast<VkImageLayout>(in_src_image_layout),
                                               in_dst_buffer_ptr->get_buffer(),
                                               in_region_count,
-                                              reinterpret_cast<const VkBufferImageCopy*>(in_region_ptrs) );
+                                              reinterpret_cast<const VkBufferImageCopy*>(regions_ptr) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2178,7 +2410,7 @@ bool Anvil::CommandBufferBase::record_copy_query_pool_results(Anvil::QueryPool*
                                                  in_start_query,
                                                  in_query_count,
                                                  in_dst_buffer_ptr->get_buffer(),
-                                                 in_dst_offset,
+                                                 in_dst_buffer_ptr->get_buffer_offset_vk(in_dst_offset),
                                                  in_dst_stride,
                                                  in_flags);
     }
@@ -2485,7 +2717,7 @@ bool Anvil::CommandBufferBase::record_dispatch_indirect(Anvil::Buffer* in_buffer
     {
         Anvil::Vulkan::vkCmdDispatchIndirect(m_command_buffer,
                                              in_buffer_ptr->get_buffer(),
-                                             in_offset);
+                                             in_buffer_ptr->get_buffer_offset_vk(in_offset) );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -2639,7 +2871,7 @@ bool Anvil::CommandBufferBase::record_draw_indexed_indirect(Anvil::Buffer* in_bu
     {
         Anvil::Vulkan::vkCmdDrawIndexedIndirect(m_command_buffer,
                                                 in_buffer_ptr->get_buffer(),
-                                                in_offset,
+                                                in_buffer_ptr->get_buffer_offset_vk(in_offset),
                                                 in_count,
                                                 in_stride);
     }
@@ -2697,7 +2929,7 @@ bool Anvil::CommandBufferBase::record_draw_indirect_byte_count_EXT(const uint32_
                                                   in_instance_count,
                                                   in_first_instance,
                                                   in_counter_buffer_ptr->get_buffer(),
-                                                  in_counter_buffer_offset,
+                                                  in_counter_buffer_ptr->get_buffer_offset_vk(in_counter_buffer_offset),
                                                   in_counter_offset,
                                                   in_vertex_stride);
     }
@@ -2758,9 +2990,9 @@ bool Anvil::CommandBufferBase::record_draw_indexed_indirect_count_AMD(Anvil::Buf
     {
         entrypoints.vkCmdDrawIndexedIndirectCountAMD(m_command_buffer,
                                                      in_buffer_ptr->get_buffer(),
-                                                     in_offset,
+                                                     in_buffer_ptr->get_buffer_offset_vk(in_offset),
                                                      in_count_buffer_ptr->get_buffer(),
-                                                     in_count_offset,
+                                                     in_count_buffer_ptr->get_buffer_offset_vk(in_count_offset),
                                                      in_max_draw_count,
                                                      in_stride);
     }
@@ -2821,9 +3053,9 @@ bool Anvil::CommandBufferBase::record_draw_indexed_indirect_count_KHR(Anvil::Buf
     {
         entrypoints.vkCmdDrawIndexedIndirectCountKHR(m_command_buffer,
                                                      in_buffer_ptr->get_buffer(),
-                                                     in_offset,
+                                                     in_buffer_ptr->get_buffer_offset_vk(in_offset),
                                                      in_count_buffer_ptr->get_buffer(),
-                                                     in_count_offset,
+                                                     in_count_buffer_ptr->get_buffer_offset_vk(in_count_offset),
                                                      in_max_draw_count,
                                                      in_stride);
     }
@@ -2874,7 +3106,7 @@ bool Anvil::CommandBufferBase::record_draw_indirect(Anvil::Buffer* in_buffer_ptr
     {
         Anvil::Vulkan::vkCmdDrawIndirect(m_command_buffer,
                                          in_buffer_ptr->get_buffer(),
-                                         in_offset,
+                                         in_buffer_ptr->get_buffer_offset_vk(in_offset),
                                          in_count,
                                          in_stride);
     }
@@ -2935,9 +3167,9 @@ bool Anvil::CommandBufferBase::record_draw_indirect_count_AMD(Anvil::Buffer* in_
     {
         entrypoints.vkCmdDrawIndirectCountAMD(m_command_buffer,
                                               in_buffer_ptr->get_buffer(),
-                                              in_offset,
+                                              in_buffer_ptr->get_buffer_offset_vk(in_offset),
                                               in_count_buffer_ptr->get_buffer(),
-                                              in_count_offset,
+                                              in_count_buffer_ptr->get_buffer_offset_vk(in_count_offset),
                                               in_max_draw_count,
                                               in_stride);
     }
@@ -2998,9 +3230,9 @@ bool Anvil::CommandBufferBase::record_draw_indirect_count_KHR(Anvil::Buffer* in_
     {
         entrypoints.vkCmdDrawIndirectCountKHR(m_command_buffer,
                                               in_buffer_ptr->get_buffer(),
-                                              in_offset,
+                                              in_buffer_ptr->get_buffer_offset_vk(in_offset),
                                               in_count_buffer_ptr->get_buffer(),
-                                              in_count_offset,
+                                              in_count_buffer_ptr->get_buffer_offset_vk(in_count_offset),
                                               in_max_draw_count,
                                               in_stride);
     }
@@ -3100,9 +3332,10 @@ bool Anvil::CommandBufferBase::record_end_transform_feedback_EXT(const uint32_t&
                                                                  Anvil::Buffer**     in_opt_counter_buffer_ptrs,
                                                                  const VkDeviceSize* in_opt_counter_buffer_offsets)
 {
-    auto        counter_buffer_ptrs = std::vector<VkBuffer>(in_n_counter_buffers);
-    const auto& entrypoints         = m_device_ptr->get_extension_ext_transform_feedback_entrypoints();
-    bool        result              = false;
+    auto        counter_buffer_offsets = std::vector<VkDeviceSize>(in_n_counter_buffers, 0);
+    auto        counter_buffer_ptrs    = std::vector<VkBuffer>    (in_n_counter_buffers);
+    const auto& entrypoints            = m_device_ptr->get_extension_ext_transform_feedback_entrypoints();
+    bool        result                 = false;
 
     if (!m_is_renderpass_active)
     {
@@ -3124,6 +3357,14 @@ bool Anvil::CommandBufferBase::record_end_transform_feedback_EXT(const uint32_t&
     {
         counter_buffer_ptrs.at(n_counter_buffer) = (in_opt_counter_buffer_ptrs != nullptr && in_opt_counter_buffer_ptrs[n_counter_buffer] != nullptr) ? in_opt_counter_buffer_ptrs[n_counter_buffer]->get_buffer()
                                                                                                                                                       : VK_NULL_HANDLE;
+
+        if (counter_buffer_ptrs.at(n_counter_buffer) != VK_NULL_HANDLE)
+        {
+            const VkDeviceSize offset = (in_opt_counter_buffer_offsets != nullptr) ? in_opt_counter_buffer_offsets[n_counter_buffer]
+                                                                                   : 0;
+
+            counter_buffer_offsets.at(n_counter_buffer) = in_opt_counter_buffer_ptrs[n_counter_buffer]->get_buffer_offset_vk(offset);
+        }
     }
 
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
@@ -3162,8 +3403,8 @@ bool Anvil::CommandBufferBase::record_end_transform_feedback_EXT(const uint32_t&
         entrypoints.vkCmdEndTransformFeedbackEXT(m_command_buffer,
                                                  in_first_counter_buffer,
                                                  in_n_counter_buffers,
-                                                 (in_n_counter_buffers > 0) ? &counter_buffer_ptrs.at(0) : nullptr,
-                                                 in_opt_counter_buffer_offsets);
+                                                 (in_n_counter_buffers > 0) ? &counter_buffer_ptrs.at   (0) : nullptr,
+                                                 (in_n_counter_buffers > 0) ? &counter_buffer_offsets.at(0) : nullptr);
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -3179,7 +3420,8 @@ bool Anvil::CommandBufferBase::record_fill_buffer(Anvil::Buffer* in_dst_buffer_p
                                                   VkDeviceSize   in_size,
                                                   uint32_t       in_data)
 {
-    bool result = false;
+    bool         result  = false;
+    VkDeviceSize size_vk = in_size;
 
     if (m_is_renderpass_active)
     {
@@ -3195,6 +3437,27 @@ bool Anvil::CommandBufferBase::record_fill_buffer(Anvil::Buffer* in_dst_buffer_p
         goto end;
     }
 
+    if (!is_buffer_region_valid(in_dst_buffer_ptr,
+                                in_dst_offset,
+                                in_size) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
+    if (in_size == VK_WHOLE_SIZE)
+    {
+        size_vk = in_dst_buffer_ptr->get_buffer_size_vk(in_dst_offset,
+                                                        in_size);
+
+        if (size_vk != VK_WHOLE_SIZE)
+        {
+            /* Follow vkCmdFillBuffer() which, for VK_WHOLE_SIZE, fills the largest multiple of 4 bytes that fits. */
+            size_vk &= ~static_cast<VkDeviceSize>(3);
+        }
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -3212,8 +3475,8 @@ bool Anvil::CommandBufferBase::record_fill_buffer(Anvil::Buffer* in_dst_buffer_p
     {
         Anvil::Vulkan::vkCmdFillBuffer(m_command_buffer,
                                        in_dst_buffer_ptr->get_buffer(),
-                                       in_dst_offset,
-                                       in_size,
+                                       in_dst_buffer_ptr->get_buffer_offset_vk(in_dst_offset),
+                                       size_vk,
                                        in_data);
     }
     unlock();
@@ -3377,6 +3640,163 @@ end:
     return result;
 }
 
+/* Please see header for specification */
+bool Anvil::CommandBufferBase::record_push_descriptor_set(Anvil::PipelineBindPoint            in_pipeline_bind_point,
+                                                          Anvil::PipelineLayout*              in_layout_ptr,
+                                                          uint32_t                            in_n_set,
+                                                          const Anvil::PushDescriptorSetInfo* in_info_ptr)
+{
+    /* NOTE: The command can be executed both inside and outside a renderpass */
+    const Anvil::ExtensionKHRPushDescriptorEntrypoints* entrypoints_ptr = nullptr;
+    uint32_t                                            n_writes        = 0;
+    bool                                                result          = false;
+    const VkWriteDescriptorSet*                         writes_vk_ptr   = nullptr;
+
+    if (!m_recording_in_progress)
+    {
+        anvil_assert(m_recording_in_progress);
+
+        goto end;
+    }
+
+    if (!m_device_ptr->get_extension_info()->khr_push_descriptor() )
+    {
+        anvil_assert(m_device_ptr->get_extension_info()->khr_push_descriptor() );
+
+        goto end;
+    }
+
+    if (in_layout_ptr == nullptr ||
+        in_info_ptr   == nullptr)
+    {
+        anvil_assert(in_layout_ptr != nullptr);
+        anvil_assert(in_info_ptr   != nullptr);
+
+        goto end;
+    }
+
+    n_writes      = in_info_ptr->get_n_writes();
+    writes_vk_ptr = in_info_ptr->get_write_descriptor_sets_vk();
+
+    if (n_writes == 0)
+    {
+        anvil_assert(n_writes != 0);
+
+        goto end;
+    }
+
+    if (m_is_redundant_state_filtering_enabled)
+    {
+        invalidate_shadow_descriptor_set_bindings(in_pipeline_bind_point);
+    }
+
+    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    {
+        if (!m_command_stashing_disabled)
+        {
+            m_commands.push_back(PushDescriptorSetKHRCommand(in_pipeline_bind_point,
+                                                             in_layout_ptr,
+                                                             in_n_set,
+                                                             n_writes) );
+        }
+    }
+    #endif
+
+    entrypoints_ptr = &m_device_ptr->get_extension_khr_push_descriptor_entrypoints();
+
+    m_parent_command_pool_ptr->lock();
+    lock();
+    {
+        entrypoints_ptr->vkCmdPushDescriptorSetKHR(m_command_buffer,
+                                                   static_cast<VkPipelineBindPoint>(in_pipeline_bind_point),
+                                                   in_layout_ptr->get_pipeline_layout(),
+                                                   in_n_set,
+                                                   n_writes,
+                                                   writes_vk_ptr);
+    }
+    unlock();
+    m_parent_command_pool_ptr->unlock();
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::CommandBufferBase::record_push_descriptor_set_with_template(const Anvil::DescriptorUpdateTemplate* in_template_ptr,
+                                                                        const void*                            in_data_ptr)
+{
+    /* NOTE: The command can be executed both inside and outside a renderpass */
+    const Anvil::ExtensionKHRPushDescriptorEntrypoints* entrypoints_ptr = nullptr;
+    bool                                                result          = false;
+
+    if (!m_recording_in_progress)
+    {
+        anvil_assert(m_recording_in_progress);
+
+        goto end;
+    }
+
+    if (!m_device_ptr->get_extension_info()->khr_push_descriptor() )
+    {
+        anvil_assert(m_device_ptr->get_extension_info()->khr_push_descriptor() );
+
+        goto end;
+    }
+
+    if (in_template_ptr == nullptr                       ||
+        in_data_ptr     == nullptr                       ||
+       !in_template_ptr->is_push_descriptor_template() )
+    {
+        anvil_assert(in_template_ptr != nullptr);
+        anvil_assert(in_data_ptr     != nullptr);
+        anvil_assert(in_template_ptr == nullptr || in_template_ptr->is_push_descriptor_template() );
+
+        goto end;
+    }
+
+    entrypoints_ptr = &m_device_ptr->get_extension_khr_push_descriptor_entrypoints();
+
+    if (entrypoints_ptr->vkCmdPushDescriptorSetWithTemplateKHR == nullptr)
+    {
+        /* Only available if VK_KHR_descriptor_update_template is also supported */
+        anvil_assert(entrypoints_ptr->vkCmdPushDescriptorSetWithTemplateKHR != nullptr);
+
+        goto end;
+    }
+
+    if (m_is_redundant_state_filtering_enabled)
+    {
+        invalidate_shadow_descriptor_set_bindings(in_template_ptr->get_pipeline_bind_point() );
+    }
+
+    #ifdef STORE_COMMAND_BUFFER_COMMANDS
+    {
+        if (!m_command_stashing_disabled)
+        {
+            m_commands.push_back(PushDescriptorSetWithTemplateKHRCommand(in_template_ptr,
+                                                                         in_data_ptr) );
+        }
+    }
+    #endif
+
+    m_parent_command_pool_ptr->lock();
+    lock();
+    {
+        entrypoints_ptr->vkCmdPushDescriptorSetWithTemplateKHR(m_command_buffer,
+                                                               in_template_ptr->get_update_template_vk(),
+                                                               in_template_ptr->get_pipeline_layout()->get_pipeline_layout(),
+                                                               in_template_ptr->get_n_set(),
+                                                               in_data_ptr);
+    }
+    unlock();
+    m_parent_command_pool_ptr->unlock();
+
+    result = true;
+end:
+    return result;
+}
+
 /* Please see header for specification */
 bool Anvil::CommandBufferBase::record_reset_event(Anvil::Event*             in_event_ptr,
                                                   Anvil::PipelineStageFlags in_stage_mask)
@@ -3540,6 +3960,18 @@ bool Anvil::CommandBufferBase::record_set_blend_constants(const float in_blend_c
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_set_float_state(4, /* in_n_values */
+                                     in_blend_constants,
+                                    &m_shadow_state.is_blend_constants_set,
+                                     m_shadow_state.blend_constants) )
+    {
+        m_elided_call_counters.n_set_dynamic_state_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -3569,7 +4001,13 @@ bool Anvil::CommandBufferBase::record_set_depth_bias(float in_depth_bias_constan
                                                      float in_slope_scaled_depth_bias)
 {
     /* Note: Command supported inside and outside the renderpass. */
-    bool result = false;
+    const float depth_bias[] =
+    {
+        in_depth_bias_constant_factor,
+        in_depth_bias_clamp,
+        in_slope_scaled_depth_bias
+    };
+    bool        result       = false;
 
     if (!m_recording_in_progress)
     {
@@ -3578,6 +4016,18 @@ bool Anvil::CommandBufferBase::record_set_depth_bias(float in_depth_bias_constan
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_set_float_state(3, /* in_n_values */
+                                     depth_bias,
+                                    &m_shadow_state.is_depth_bias_set,
+                                     m_shadow_state.depth_bias) )
+    {
+        m_elided_call_counters.n_set_dynamic_state_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -3610,7 +4060,12 @@ bool Anvil::CommandBufferBase::record_set_depth_bounds(float in_min_depth_bounds
                                                        float in_max_depth_bounds)
 {
     /* Note: Command supported inside and outside the renderpass. */
-    bool result = false;
+    const float depth_bounds[] =
+    {
+        in_min_depth_bounds,
+        in_max_depth_bounds
+    };
+    bool        result         = false;
 
     if (!m_recording_in_progress)
     {
@@ -3619,6 +4074,18 @@ bool Anvil::CommandBufferBase::record_set_depth_bounds(float in_min_depth_bounds
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_set_float_state(2, /* in_n_values */
+                                     depth_bounds,
+                                    &m_shadow_state.is_depth_bounds_set,
+                                     m_shadow_state.depth_bounds) )
+    {
+        m_elided_call_counters.n_set_dynamic_state_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -3766,6 +4233,18 @@ bool Anvil::CommandBufferBase::record_set_line_width(float in_line_width)
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_set_float_state(1, /* in_n_values */
+                                    &in_line_width,
+                                    &m_shadow_state.is_line_width_set,
+                                    &m_shadow_state.line_width) )
+    {
+        m_elided_call_counters.n_set_dynamic_state_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -3844,6 +4323,17 @@ bool Anvil::CommandBufferBase::record_set_scissor(uint32_t        in_first_sciss
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_set_scissor(in_first_scissor,
+                                 in_scissor_count,
+                                 in_scissor_ptrs) )
+    {
+        m_elided_call_counters.n_set_dynamic_state_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -3885,6 +4375,18 @@ bool Anvil::CommandBufferBase::record_set_stencil_compare_mask(Anvil::StencilFac
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_set_stencil_state(in_face_mask,
+                                       in_stencil_compare_mask,
+                                       m_shadow_state.is_stencil_compare_mask_set,
+                                       m_shadow_state.stencil_compare_masks) )
+    {
+        m_elided_call_counters.n_set_dynamic_state_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -3924,6 +4426,18 @@ bool Anvil::CommandBufferBase::record_set_stencil_reference(Anvil::StencilFaceFl
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_set_stencil_state(in_face_mask,
+                                       in_stencil_reference,
+                                       m_shadow_state.is_stencil_reference_set,
+                                       m_shadow_state.stencil_references) )
+    {
+        m_elided_call_counters.n_set_dynamic_state_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -3963,6 +4477,18 @@ bool Anvil::CommandBufferBase::record_set_stencil_write_mask(Anvil::StencilFaceF
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_set_stencil_state(in_face_mask,
+                                       in_stencil_write_mask,
+                                       m_shadow_state.is_stencil_write_mask_set,
+                                       m_shadow_state.stencil_write_masks) )
+    {
+        m_elided_call_counters.n_set_dynamic_state_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -4003,6 +4529,17 @@ bool Anvil::CommandBufferBase::record_set_viewport(uint32_t          in_first_vi
         goto end;
     }
 
+    if (m_is_redundant_state_filtering_enabled &&
+        should_elide_set_viewport(in_first_viewport,
+                                  in_viewport_count,
+                                  in_viewport_ptrs) )
+    {
+        m_elided_call_counters.n_set_dynamic_state_calls++;
+
+        result = true;
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -4052,6 +4589,15 @@ bool Anvil::CommandBufferBase::record_update_buffer(Anvil::Buffer* in_dst_buffer
         goto end;
     }
 
+    if (!is_buffer_region_valid(in_dst_buffer_ptr,
+                                in_dst_offset,
+                                in_data_size) )
+    {
+        anvil_assert_fail();
+
+        goto end;
+    }
+
     #ifdef STORE_COMMAND_BUFFER_COMMANDS
     {
         if (!m_command_stashing_disabled)
@@ -4070,7 +4616,7 @@ bool Anvil::CommandBufferBase::record_update_buffer(Anvil::Buffer* in_dst_buffer
     {
         Anvil::Vulkan::vkCmdUpdateBuffer(m_command_buffer,
                                          in_dst_buffer_ptr->get_buffer(),
-                                         in_dst_offset,
+                                         in_dst_buffer_ptr->get_buffer_offset_vk(in_dst_offset),
                                          in_data_size,
                                          in_data_ptr);
     }
@@ -4216,7 +4762,7 @@ bool Anvil::CommandBufferBase::record_write_buffer_marker_AMD(const Anvil::Pipel
         entrypoints.vkCmdWriteBufferMarkerAMD(m_command_buffer,
                                               static_cast<VkPipelineStageFlagBits>(in_pipeline_stage),
                                               in_dst_buffer_ptr->get_buffer(),
-                                              in_dst_offset,
+                                              in_dst_buffer_ptr->get_buffer_offset_vk(in_dst_offset),
                                               in_marker);
     }
     unlock();
@@ -4309,6 +4855,443 @@ end:
     return result;
 }
 
+/* Please see header for specification */
+void Anvil::CommandBufferBase::reset_shadow_state()
+{
+    m_shadow_state.reset();
+}
+
+/* Please see header for specification */
+void Anvil::CommandBufferBase::set_redundant_state_filtering_enabled(bool in_enabled)
+{
+    m_is_redundant_state_filtering_enabled = in_enabled;
+
+    /* Any state recorded while the filter was disabled has not been tracked. */
+    m_shadow_state.reset();
+}
+
+/** Drops all cached vkCmdBindDescriptorSets() calls recorded for the specified bind point. Needs to be called
+ *  whenever descriptors get pushed, since pushing a set overwrites the set bound at the same index.
+ *
+ *  @param in_pipeline_bind_point Bind point to drop the cached calls for.
+ **/
+void Anvil::CommandBufferBase::invalidate_shadow_descriptor_set_bindings(Anvil::PipelineBindPoint in_pipeline_bind_point)
+{
+    const uint32_t n_bind_point(in_pipeline_bind_point == Anvil::PipelineBindPoint::GRAPHICS ? 0 : 1);
+
+    anvil_assert(in_pipeline_bind_point == Anvil::PipelineBindPoint::COMPUTE  ||
+                 in_pipeline_bind_point == Anvil::PipelineBindPoint::GRAPHICS);
+
+    m_shadow_state.descriptor_set_bindings[n_bind_point].clear();
+}
+
+/** Discards the whole shadow state. */
+void Anvil::CommandBufferBase::ShadowState::reset()
+{
+    for (uint32_t n_bind_point = 0;
+                  n_bind_point < N_SHADOW_BIND_POINTS;
+                ++n_bind_point)
+    {
+        descriptor_set_bindings[n_bind_point].clear();
+        pipelines              [n_bind_point] = VK_NULL_HANDLE;
+    }
+
+    index_buffer        = VK_NULL_HANDLE;
+    index_buffer_offset = 0;
+    index_type          = Anvil::IndexType::UNKNOWN;
+
+    vertex_buffers.clear       ();
+    vertex_buffer_offsets.clear();
+
+    reset_dynamic_state();
+}
+
+/** Discards the shadow copy of all dynamic state. */
+void Anvil::CommandBufferBase::ShadowState::reset_dynamic_state()
+{
+    is_blend_constants_set = false;
+    is_depth_bias_set      = false;
+    is_depth_bounds_set    = false;
+    is_line_width_set      = false;
+
+    for (uint32_t n_face = 0;
+                  n_face < N_SHADOW_STENCIL_FACES;
+                ++n_face)
+    {
+        is_stencil_compare_mask_set[n_face] = false;
+        is_stencil_reference_set   [n_face] = false;
+        is_stencil_write_mask_set  [n_face] = false;
+    }
+
+    is_scissor_set.clear ();
+    is_viewport_set.clear();
+    scissors.clear       ();
+    viewports.clear      ();
+}
+
+/** Tells whether a vkCmdBindDescriptorSets() call with the specified arguments would repeat the most recent
+ *  call made for the same bind point and first set index, with no other call overwriting the sets in-between.
+ *  If not, the shadow state is updated to reflect the new bindings.
+ *
+ *  Cached calls are discarded if they used a different pipeline layout, since binding sets with an incompatible
+ *  layout may disturb them.
+ *
+ *  @return true if the call should be elided, false otherwise.
+ **/
+bool Anvil::CommandBufferBase::should_elide_bind_descriptor_sets(Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                                                 Anvil::PipelineLayout*   in_layout_ptr,
+                                                                 uint32_t                 in_first_set,
+                                                                 uint32_t                 in_set_count,
+                                                                 const VkDescriptorSet*   in_descriptor_sets_vk_ptr,
+                                                                 uint32_t                 in_dynamic_offset_count,
+                                                                 const uint32_t*          in_dynamic_offset_ptrs)
+{
+    const uint32_t n_bind_point(in_pipeline_bind_point == Anvil::PipelineBindPoint::GRAPHICS ? 0 : 1);
+    auto&          bindings    (m_shadow_state.descriptor_set_bindings[n_bind_point]);
+    bool           result      (false);
+
+    anvil_assert(in_pipeline_bind_point == Anvil::PipelineBindPoint::COMPUTE  ||
+                 in_pipeline_bind_point == Anvil::PipelineBindPoint::GRAPHICS);
+
+    if (in_first_set < static_cast<uint32_t>(bindings.size() ))
+    {
+        const auto& cached_binding(bindings.at(in_first_set) );
+
+        if (cached_binding.layout_ptr             != nullptr                                                                                       &&
+            cached_binding.layout_ptr             == in_layout_ptr                                                                                 &&
+            cached_binding.sets.size           () == in_set_count                                                                                  &&
+            cached_binding.dynamic_offsets.size() == in_dynamic_offset_count                                                                       &&
+            (in_set_count            == 0 || memcmp(&cached_binding.sets.at(0),            in_descriptor_sets_vk_ptr, sizeof(VkDescriptorSet) * in_set_count)            == 0) &&
+            (in_dynamic_offset_count == 0 || memcmp(&cached_binding.dynamic_offsets.at(0), in_dynamic_offset_ptrs,    sizeof(uint32_t)        * in_dynamic_offset_count) == 0) )
+        {
+            result = true;
+
+            goto end;
+        }
+    }
+
+    /* Drop cached calls, whose sets are going to be overwritten, or which could be disturbed by the new layout. */
+    for (uint32_t n_cached_binding = 0;
+                  n_cached_binding < static_cast<uint32_t>(bindings.size() );
+                ++n_cached_binding)
+    {
+        auto&          cached_binding(bindings.at(n_cached_binding) );
+        const uint32_t n_cached_sets (static_cast<uint32_t>(cached_binding.sets.size() ));
+
+        if (cached_binding.layout_ptr == nullptr)
+        {
+            continue;
+        }
+
+        if ( cached_binding.layout_ptr != in_layout_ptr                         ||
+            (n_cached_binding          <  in_first_set     + in_set_count &&
+             in_first_set              <  n_cached_binding + n_cached_sets) )
+        {
+            cached_binding = ShadowDescriptorSetBinding();
+        }
+    }
+
+    if (bindings.size() <= in_first_set)
+    {
+        bindings.resize(in_first_set + 1);
+    }
+
+    bindings.at(in_first_set).layout_ptr = in_layout_ptr;
+
+    bindings.at(in_first_set).dynamic_offsets.assign(in_dynamic_offset_ptrs,
+                                                     in_dynamic_offset_ptrs    + in_dynamic_offset_count);
+    bindings.at(in_first_set).sets.assign           (in_descriptor_sets_vk_ptr,
+                                                     in_descriptor_sets_vk_ptr + in_set_count);
+
+end:
+    return result;
+}
+
+/** Tells whether a vkCmdBindIndexBuffer() call with the specified arguments would not change the index buffer
+ *  binding. If it would, the shadow state is updated to reflect the new binding.
+ *
+ *  @return true if the call should be elided, false otherwise.
+ **/
+bool Anvil::CommandBufferBase::should_elide_bind_index_buffer(VkBuffer         in_buffer_vk,
+                                                              VkDeviceSize     in_offset,
+                                                              Anvil::IndexType in_index_type)
+{
+    bool result = false;
+
+    if (m_shadow_state.index_buffer        != VK_NULL_HANDLE &&
+        m_shadow_state.index_buffer        == in_buffer_vk   &&
+        m_shadow_state.index_buffer_offset == in_offset      &&
+        m_shadow_state.index_type          == in_index_type)
+    {
+        result = true;
+    }
+    else
+    {
+        m_shadow_state.index_buffer        = in_buffer_vk;
+        m_shadow_state.index_buffer_offset = in_offset;
+        m_shadow_state.index_type          = in_index_type;
+    }
+
+    return result;
+}
+
+/** Tells whether a vkCmdBindPipeline() call with the specified arguments would not change the pipeline bound
+ *  to the bind point. If it would, the shadow state is updated to reflect the new binding.
+ *
+ *  Binding a different graphics pipeline discards the shadow copy of dynamic state, as static state of
+ *  the new pipeline overwrites it.
+ *
+ *  @return true if the call should be elided, false otherwise.
+ **/
+bool Anvil::CommandBufferBase::should_elide_bind_pipeline(Anvil::PipelineBindPoint in_pipeline_bind_point,
+                                                          VkPipeline               in_pipeline_vk)
+{
+    const uint32_t n_bind_point(in_pipeline_bind_point == Anvil::PipelineBindPoint::GRAPHICS ? 0 : 1);
+    bool           result      (false);
+
+    anvil_assert(in_pipeline_bind_point == Anvil::PipelineBindPoint::COMPUTE  ||
+                 in_pipeline_bind_point == Anvil::PipelineBindPoint::GRAPHICS);
+
+    if (m_shadow_state.pipelines[n_bind_point] != VK_NULL_HANDLE &&
+        m_shadow_state.pipelines[n_bind_point] == in_pipeline_vk)
+    {
+        result = true;
+    }
+    else
+    {
+        if (in_pipeline_bind_point == Anvil::PipelineBindPoint::GRAPHICS)
+        {
+            m_shadow_state.reset_dynamic_state();
+        }
+
+        m_shadow_state.pipelines[n_bind_point] = in_pipeline_vk;
+    }
+
+    return result;
+}
+
+/** Tells whether a vkCmdBindVertexBuffers() call with the specified arguments would not change any of the
+ *  vertex buffer bindings. If it would, the shadow state is updated to reflect the new bindings.
+ *
+ *  @param in_offsets_ptr Offsets relative to the start of the VkBuffer instances.
+ *
+ *  @return true if the call should be elided, false otherwise.
+ **/
+bool Anvil::CommandBufferBase::should_elide_bind_vertex_buffers(uint32_t            in_start_binding,
+                                                                uint32_t            in_binding_count,
+                                                                const VkBuffer*     in_buffers_vk_ptr,
+                                                                const VkDeviceSize* in_offsets_ptr)
+{
+    auto& buffers(m_shadow_state.vertex_buffers);
+    auto& offsets(m_shadow_state.vertex_buffer_offsets);
+    bool  result (in_binding_count                   >  0 &&
+                  in_start_binding + in_binding_count <= static_cast<uint32_t>(buffers.size() ));
+
+    for (uint32_t n_binding = 0;
+                  n_binding < in_binding_count && result;
+                ++n_binding)
+    {
+        if (buffers.at(in_start_binding + n_binding) == VK_NULL_HANDLE                ||
+            buffers.at(in_start_binding + n_binding) != in_buffers_vk_ptr[n_binding] ||
+            offsets.at(in_start_binding + n_binding) != in_offsets_ptr   [n_binding])
+        {
+            result = false;
+        }
+    }
+
+    if (!result)
+    {
+        if (buffers.size() < in_start_binding + in_binding_count)
+        {
+            buffers.resize(in_start_binding + in_binding_count,
+                           VK_NULL_HANDLE);
+            offsets.resize(in_start_binding + in_binding_count,
+                           0);
+        }
+
+        for (uint32_t n_binding = 0;
+                      n_binding < in_binding_count;
+                    ++n_binding)
+        {
+            buffers.at(in_start_binding + n_binding) = in_buffers_vk_ptr[n_binding];
+            offsets.at(in_start_binding + n_binding) = in_offsets_ptr   [n_binding];
+        }
+    }
+
+    return result;
+}
+
+/** Tells whether a dynamic state setter taking @param in_n_values floats would not change the state.
+ *  If it would, the shadow copy of the state is updated.
+ *
+ *  @param in_n_values      Number of floats making up the state.
+ *  @param in_values_ptr    Values to set.
+ *  @param inout_is_set_ptr Deref tells whether the shadow copy is known. Set to true when updating the copy.
+ *  @param inout_values_ptr Shadow copy of the state.
+ *
+ *  @return true if the call should be elided, false otherwise.
+ **/
+bool Anvil::CommandBufferBase::should_elide_set_float_state(uint32_t     in_n_values,
+                                                            const float* in_values_ptr,
+                                                            bool*        inout_is_set_ptr,
+                                                            float*       inout_values_ptr)
+{
+    bool result = false;
+
+    if (*inout_is_set_ptr                                                         &&
+        memcmp(inout_values_ptr, in_values_ptr, sizeof(float) * in_n_values) == 0)
+    {
+        result = true;
+    }
+    else
+    {
+        memcpy(inout_values_ptr,
+               in_values_ptr,
+               sizeof(float) * in_n_values);
+
+        *inout_is_set_ptr = true;
+    }
+
+    return result;
+}
+
+/** Tells whether a vkCmdSetScissor() call with the specified arguments would not change any of the scissor
+ *  rectangles. If it would, the shadow state is updated to reflect the new rectangles.
+ *
+ *  @return true if the call should be elided, false otherwise.
+ **/
+bool Anvil::CommandBufferBase::should_elide_set_scissor(uint32_t        in_first_scissor,
+                                                        uint32_t        in_scissor_count,
+                                                        const VkRect2D* in_scissor_ptrs)
+{
+    auto& is_set  (m_shadow_state.is_scissor_set);
+    auto& scissors(m_shadow_state.scissors);
+    bool  result  (in_scissor_count                    >  0 &&
+                   in_first_scissor + in_scissor_count <= static_cast<uint32_t>(scissors.size() ));
+
+    for (uint32_t n_scissor = 0;
+                  n_scissor < in_scissor_count && result;
+                ++n_scissor)
+    {
+        if (!is_set.at(in_first_scissor + n_scissor)                                                       ||
+            memcmp(&scissors.at(in_first_scissor + n_scissor), in_scissor_ptrs + n_scissor, sizeof(VkRect2D)) != 0)
+        {
+            result = false;
+        }
+    }
+
+    if (!result)
+    {
+        if (scissors.size() < in_first_scissor + in_scissor_count)
+        {
+            is_set.resize  (in_first_scissor + in_scissor_count,
+                            false);
+            scissors.resize(in_first_scissor + in_scissor_count);
+        }
+
+        for (uint32_t n_scissor = 0;
+                      n_scissor < in_scissor_count;
+                    ++n_scissor)
+        {
+            is_set.at  (in_first_scissor + n_scissor) = true;
+            scissors.at(in_first_scissor + n_scissor) = in_scissor_ptrs[n_scissor];
+        }
+    }
+
+    return result;
+}
+
+/** Tells whether a stencil state setter would not change the state of any of the faces specified by
+ *  @param in_face_mask. If it would, the shadow copy of the state is updated.
+ *
+ *  @param in_face_mask     Faces to set the state for.
+ *  @param in_value         Value to set.
+ *  @param inout_is_set_ptr Array of N_SHADOW_STENCIL_FACES items (front, back), telling whether the shadow copy
+ *                          of each face's state is known.
+ *  @param inout_values_ptr Array of N_SHADOW_STENCIL_FACES items (front, back), holding the shadow copy of the state.
+ *
+ *  @return true if the call should be elided, false otherwise.
+ **/
+bool Anvil::CommandBufferBase::should_elide_set_stencil_state(Anvil::StencilFaceFlags in_face_mask,
+                                                              uint32_t                in_value,
+                                                              bool*                   inout_is_set_ptr,
+                                                              uint32_t*               inout_values_ptr)
+{
+    static const Anvil::StencilFaceFlagBits faces[N_SHADOW_STENCIL_FACES] =
+    {
+        Anvil::StencilFaceFlagBits::FRONT_BIT,
+        Anvil::StencilFaceFlagBits::BACK_BIT
+    };
+    bool result = true;
+
+    for (uint32_t n_face = 0;
+                  n_face < N_SHADOW_STENCIL_FACES;
+                ++n_face)
+    {
+        if ((in_face_mask & faces[n_face]) == 0)
+        {
+            continue;
+        }
+
+        if (!inout_is_set_ptr[n_face]            ||
+             inout_values_ptr[n_face] != in_value)
+        {
+            result = false;
+        }
+
+        inout_is_set_ptr[n_face] = true;
+        inout_values_ptr[n_face] = in_value;
+    }
+
+    return result;
+}
+
+/** Tells whether a vkCmdSetViewport() call with the specified arguments would not change any of the viewports.
+ *  If it would, the shadow state is updated to reflect the new viewports.
+ *
+ *  @return true if the call should be elided, false otherwise.
+ **/
+bool Anvil::CommandBufferBase::should_elide_set_viewport(uint32_t          in_first_viewport,
+                                                         uint32_t          in_viewport_count,
+                                                         const VkViewport* in_viewport_ptrs)
+{
+    auto& is_set   (m_shadow_state.is_viewport_set);
+    auto& viewports(m_shadow_state.viewports);
+    bool  result   (in_viewport_count                     >  0 &&
+                    in_first_viewport + in_viewport_count <= static_cast<uint32_t>(viewports.size() ));
+
+    for (uint32_t n_viewport = 0;
+                  n_viewport < in_viewport_count && result;
+                ++n_viewport)
+    {
+        if (!is_set.at(in_first_viewport + n_viewport)                                                            ||
+            memcmp(&viewports.at(in_first_viewport + n_viewport), in_viewport_ptrs + n_viewport, sizeof(VkViewport)) != 0)
+        {
+            result = false;
+        }
+    }
+
+    if (!result)
+    {
+        if (viewports.size() < in_first_viewport + in_viewport_count)
+        {
+            is_set.resize   (in_first_viewport + in_viewport_count,
+                             false);
+            viewports.resize(in_first_viewport + in_viewport_count);
+        }
+
+        for (uint32_t n_viewport = 0;
+                      n_viewport < in_viewport_count;
+                    ++n_viewport)
+        {
+            is_set.at   (in_first_viewport + n_viewport) = true;
+            viewports.at(in_first_viewport + n_viewport) = in_viewport_ptrs[n_viewport];
+        }
+    }
+
+    return result;
+}
+
 /* Please see header for specification */
 bool Anvil::CommandBufferBase::stop_recording()
 {
@@ -4504,7 +5487,7 @@ bool Anvil::PrimaryCommandBuffer::record_begin_render_pass_internal(const bool&
     const Anvil::DeviceType device_type = m_device_ptr->get_type();
     bool                    result      = false;
 
-    Anvil::StructChainer<VkRenderPassBeginInfo> render_pass_begin_info_chain;
+    Anvil::FixedStructChainer<VkRenderPassBeginInfo> render_pass_begin_info_chain;
 
     if (m_is_renderpass_active)
     {
@@ -4627,12 +5610,10 @@ bool Anvil::PrimaryCommandBuffer::record_begin_render_pass_internal(const bool&
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        auto chain_ptr = render_pass_begin_info_chain.create_chain();
-
         if (!in_use_khr_create_rp2_extension)
         {
             Anvil::Vulkan::vkCmdBeginRenderPass(m_command_buffer,
-                                                chain_ptr->get_root_struct(),
+                                                render_pass_begin_info_chain.get_root_struct(),
                                                 static_cast<VkSubpassContents>(in_contents) );
         }
         else
@@ -4645,13 +5626,15 @@ bool Anvil::PrimaryCommandBuffer::record_begin_render_pass_internal(const bool&
             subpass_begin_info.sType    = VK_STRUCTURE_TYPE_SUBPASS_BEGIN_INFO_KHR;
 
             crp2_entrypoints.vkCmdBeginRenderPass2KHR(m_command_buffer,
-                                                      chain_ptr->get_root_struct(),
+                                                      render_pass_begin_info_chain.get_root_struct(),
                                                      &subpass_begin_info);
         }
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
 
+    reset_shadow_state();
+
     m_is_renderpass_active = true;
     result                 = true;
 end:
@@ -4729,6 +5712,8 @@ bool Anvil::PrimaryCommandBuffer::record_end_render_pass_internal(const bool& in
     unlock();
     m_parent_command_pool_ptr->unlock();
 
+    reset_shadow_state();
+
     m_is_renderpass_active = false;
     result                 = true;
 end:
@@ -4777,6 +5762,9 @@ bool Anvil::PrimaryCommandBuffer::record_execute_commands(uint32_t
     unlock();
     m_parent_command_pool_ptr->unlock();
 
+    /* State of the primary command buffer is undefined after secondary command buffers execute. */
+    reset_shadow_state();
+
     result = true;
 end:
     return result;
@@ -4863,6 +5851,8 @@ bool Anvil::PrimaryCommandBuffer::record_next_subpass_internal(const bool&
     unlock();
     m_parent_command_pool_ptr->unlock();
 
+    reset_shadow_state();
+
     result = true;
 end:
     return result;
@@ -4873,10 +5863,10 @@ bool Anvil::PrimaryCommandBuffer::start_recording(bool
                                                   bool                                in_simultaneous_use_allowed,
                                                   uint32_t                            in_opt_device_mask)
 {
-    const Anvil::DeviceType                        device_type    (m_device_ptr->get_type() );
-    bool                                           result         (false);
-    VkResult                                       result_vk;
-    Anvil::StructChainer<VkCommandBufferBeginInfo> struct_chainer;
+    const Anvil::DeviceType                             device_type    (m_device_ptr->get_type() );
+    bool                                                result         (false);
+    VkResult                                            result_vk;
+    Anvil::FixedStructChainer<VkCommandBufferBeginInfo> struct_chainer;
 
     if (m_recording_in_progress)
     {
@@ -4923,10 +5913,8 @@ bool Anvil::PrimaryCommandBuffer::start_recording(bool
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        auto chain_ptr = struct_chainer.create_chain();
-
         result_vk = Anvil::Vulkan::vkBeginCommandBuffer(m_command_buffer,
-                                                        chain_ptr->get_root_struct() );
+                                                        struct_chainer.get_root_struct() );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -4946,6 +5934,9 @@ bool Anvil::PrimaryCommandBuffer::start_recording(bool
     #endif
 
     m_device_mask           = in_opt_device_mask;
+    reset_shadow_state();
+
+    m_elided_call_counters  = ElidedCallCounters();
     m_recording_in_progress = true;
     result                  = true;
 
@@ -4997,11 +5988,11 @@ bool Anvil::SecondaryCommandBuffer::start_recording(bool
                                                     Anvil::QueryPipelineStatisticFlags in_required_pipeline_statistics_scope,
                                                     uint32_t                           in_opt_device_mask)
 {
-    VkCommandBufferInheritanceInfo                 command_buffer_inheritance_info;
-    const Anvil::DeviceType                        device_type                    (m_device_ptr->get_type() );
-    bool                                           result                         (false);
-    VkResult                                       result_vk;
-    Anvil::StructChainer<VkCommandBufferBeginInfo> struct_chainer;
+    VkCommandBufferInheritanceInfo                      command_buffer_inheritance_info;
+    const Anvil::DeviceType                             device_type                    (m_device_ptr->get_type() );
+    bool                                                result                         (false);
+    VkResult                                            result_vk;
+    Anvil::FixedStructChainer<VkCommandBufferBeginInfo> struct_chainer;
 
     if (m_recording_in_progress)
     {
@@ -5059,10 +6050,8 @@ bool Anvil::SecondaryCommandBuffer::start_recording(bool
     m_parent_command_pool_ptr->lock();
     lock();
     {
-        auto chain_ptr = struct_chainer.create_chain();
-
         result_vk = Anvil::Vulkan::vkBeginCommandBuffer(m_command_buffer,
-                                                        chain_ptr->get_root_struct() );
+                                                        struct_chainer.get_root_struct() );
     }
     unlock();
     m_parent_command_pool_ptr->unlock();
@@ -5082,6 +6071,9 @@ bool Anvil::SecondaryCommandBuffer::start_recording(bool
     #endif
 
     m_is_renderpass_active  = in_renderpass_usage_only;
+    reset_shadow_state();
+
+    m_elided_call_counters  = ElidedCallCounters();
     m_recording_in_progress = true;
     result                  = true;
 
@@ -132,6 +132,20 @@ bool Anvil::DescriptorPool::alloc_descriptor_sets(uint32_t
     Anvil::StructChainer<VkDescriptorSetAllocateInfo> struct_chainer;
     std::vector<uint32_t>                             variable_descriptor_counts;
 
+    /* Push descriptor layouts cannot be used for descriptor set allocations */
+    for (uint32_t n_set = 0;
+                  n_set < in_n_sets;
+                ++n_set)
+    {
+        if (in_ds_allocations_ptr[n_set].ds_layout_ptr                                                 != nullptr &&
+            in_ds_allocations_ptr[n_set].ds_layout_ptr->get_create_info()->is_push_descriptor_layout() )
+        {
+            anvil_assert(!in_ds_allocations_ptr[n_set].ds_layout_ptr->get_create_info()->is_push_descriptor_layout() );
+
+            goto end;
+        }
+    }
+
     lock();
     {
         m_ds_layout_cache.resize(in_n_sets);
@@ -23,6 +23,7 @@
 #include "misc/buffer_create_info.h"
 #include "misc/debug.h"
 #include "misc/descriptor_set_create_info.h"
+#include "misc/descriptor_update_template_cache.h"
 #include "misc/object_tracker.h"
 #include "wrappers/buffer.h"
 #include "wrappers/buffer_view.h"
@@ -377,13 +378,14 @@ void Anvil::DescriptorSet::fill_buffer_info_vk_descriptor(const Anvil::Descripto
 
     if (in_binding_item.start_offset != UINT64_MAX)
     {
-        out_descriptor_ptr->offset = in_binding_item.start_offset;
-        out_descriptor_ptr->range  = in_binding_item.size;
+        out_descriptor_ptr->offset = in_binding_item.buffer_ptr->get_buffer_offset_vk(in_binding_item.start_offset);
+        out_descriptor_ptr->range  = in_binding_item.buffer_ptr->get_buffer_size_vk(in_binding_item.start_offset,
+                                                                                    in_binding_item.size);
     }
     else
     {
-        out_descriptor_ptr->offset = in_binding_item.buffer_ptr->get_create_info_ptr()->get_start_offset();
-        out_descriptor_ptr->range  = in_binding_item.buffer_ptr->get_create_info_ptr()->get_size        ();
+        out_descriptor_ptr->offset = in_binding_item.buffer_ptr->get_buffer_offset_vk(0);
+        out_descriptor_ptr->range  = in_binding_item.buffer_ptr->get_create_info_ptr()->get_size();
     }
 }
 
@@ -981,9 +983,9 @@ end:
 
 bool Anvil::DescriptorSet::update_using_template_method() const
 {
-    std::vector<uint8_t> data_vector;
-    const auto           layout_info_ptr = m_layout_ptr->get_create_info();
-    bool                 result          = false;
+    const auto                             layout_info_ptr = m_layout_ptr->get_create_info();
+    bool                                   result          = false;
+    const Anvil::DescriptorUpdateTemplate* template_ptr    = nullptr;
 
     if (!m_device_ptr->get_extension_info()->khr_descriptor_update_template() )
     {
@@ -999,8 +1001,7 @@ bool Anvil::DescriptorSet::update_using_template_method() const
         /* First build up a vector of template entries we need the template to encapsulate. While on it,
          * also construct an array of descriptors we're going to pass along the template.
          */
-        const uint32_t                                  n_bindings               = static_cast<uint32_t>(m_binding_ptrs.size() );
-        decltype(m_template_object_map)::const_iterator template_object_iterator;
+        const uint32_t n_bindings = static_cast<uint32_t>(m_binding_ptrs.size() );
 
         m_template_entries.clear ();
         m_template_raw_data.clear();
@@ -1107,29 +1108,19 @@ bool Anvil::DescriptorSet::update_using_template_method() const
             anvil_assert(m_template_raw_data.size() > 0);
         }
 
-        /* Has a template object matching our needs already been created in the past? */
-        template_object_iterator = m_template_object_map.find(m_template_entries);
+        /* Retrieve a template object matching our needs. Templates are shared by all descriptor sets using the same
+         * layout, so this only creates a new one the first time a given entry list is encountered device-wide.
+         */
+        template_ptr = m_device_ptr->get_descriptor_update_template_cache()->get_template(m_layout_ptr,
+                                                                                          &m_template_entries.at(0),
+                                                                                          static_cast<uint32_t>(m_template_entries.size() ));
 
-        if (template_object_iterator == m_template_object_map.end() )
+        if (template_ptr == nullptr)
         {
-            /* Need to create a new template object.. */
-            m_template_object_map[m_template_entries] = std::move(
-                Anvil::DescriptorUpdateTemplate::create_for_descriptor_set_updates(m_device_ptr,
-                                                                                   m_layout_ptr,
-                                                                                   m_template_entries,
-                                                                                   Anvil::MTSafety::DISABLED) );
-
-            /* Update the iterator */
-            template_object_iterator = m_template_object_map.find(m_template_entries);
-            anvil_assert(template_object_iterator != m_template_object_map.end() );
-
-            if (template_object_iterator->second == nullptr)
-            {
-                anvil_assert(template_object_iterator->second != nullptr);
+            anvil_assert(template_ptr != nullptr);
 
-                result = false;
-                goto end;
-            }
+            result = false;
+            goto end;
         }
 
         /* Issue the Vulkan call.
@@ -1139,8 +1130,8 @@ bool Anvil::DescriptorSet::update_using_template_method() const
          */
         m_dirty = false;
 
-        template_object_iterator->second->update_descriptor_set(this,
-                                                               &m_template_raw_data.at(0) );
+        template_ptr->update_descriptor_set(this,
+                                           &m_template_raw_data.at(0) );
     }
 
     result = true;
@@ -28,6 +28,7 @@
 #include "wrappers/descriptor_update_template.h"
 #include "wrappers/device.h"
 #include "wrappers/physical_device.h"
+#include "wrappers/pipeline_layout.h"
 
 Anvil::DescriptorUpdateTemplate::DescriptorUpdateTemplate(const Anvil::BaseDevice* in_device_ptr,
                                                           bool                     in_mt_safe)
@@ -35,6 +36,9 @@ Anvil::DescriptorUpdateTemplate::DescriptorUpdateTemplate(const Anvil::BaseDevic
                                 Anvil::ObjectType::DESCRIPTOR_UPDATE_TEMPLATE),
      MTSafetySupportProvider   (in_mt_safe),
      m_device_ptr              (in_device_ptr),
+     m_n_set                   (UINT32_MAX),
+     m_pipeline_bind_point     (Anvil::PipelineBindPoint::UNKNOWN),
+     m_pipeline_layout_ptr     (nullptr),
      m_vk_object               (VK_NULL_HANDLE)
 {
     /* Register this instance */
@@ -80,6 +84,9 @@ Anvil::DescriptorUpdateTemplateUniquePtr Anvil::DescriptorUpdateTemplate::create
     if (result_ptr != nullptr)
     {
         if (!result_ptr->init(in_descriptor_set_layout_ptr,
+                              Anvil::PipelineBindPoint::UNKNOWN,
+                              nullptr, /* in_opt_pipeline_layout_ptr */
+                              UINT32_MAX,
                               in_update_entries_ptr,
                               in_n_update_entries) )
         {
@@ -90,12 +97,50 @@ Anvil::DescriptorUpdateTemplateUniquePtr Anvil::DescriptorUpdateTemplate::create
     return result_ptr;
 }
 
-bool Anvil::DescriptorUpdateTemplate::init(const Anvil::DescriptorSetLayout*           in_descriptor_set_layout_ptr,
+Anvil::DescriptorUpdateTemplateUniquePtr Anvil::DescriptorUpdateTemplate::create_for_push_descriptor_set_updates(const Anvil::BaseDevice*                    in_device_ptr,
+                                                                                                                 Anvil::PipelineBindPoint                    in_pipeline_bind_point,
+                                                                                                                 const Anvil::PipelineLayout*                in_pipeline_layout_ptr,
+                                                                                                                 uint32_t                                    in_n_set,
+                                                                                                                 const Anvil::DescriptorUpdateTemplateEntry* in_update_entries_ptr,
+                                                                                                                 const uint32_t&                             in_n_update_entries,
+                                                                                                                 MTSafety                                    in_mt_safety)
+{
+    DescriptorUpdateTemplateUniquePtr result_ptr(nullptr,
+                                                 std::default_delete<Anvil::DescriptorUpdateTemplate>() );
+
+    result_ptr.reset(
+        new DescriptorUpdateTemplate(in_device_ptr,
+                                     Anvil::Utils::convert_mt_safety_enum_to_boolean(in_mt_safety,
+                                                                                     in_device_ptr) )
+    );
+
+    if (result_ptr != nullptr)
+    {
+        if (!result_ptr->init(nullptr, /* in_opt_descriptor_set_layout_ptr */
+                              in_pipeline_bind_point,
+                              in_pipeline_layout_ptr,
+                              in_n_set,
+                              in_update_entries_ptr,
+                              in_n_update_entries) )
+        {
+            result_ptr.reset();
+        }
+    }
+
+    return result_ptr;
+}
+
+bool Anvil::DescriptorUpdateTemplate::init(const Anvil::DescriptorSetLayout*           in_opt_descriptor_set_layout_ptr,
+                                           Anvil::PipelineBindPoint                    in_pipeline_bind_point,
+                                           const Anvil::PipelineLayout*                in_opt_pipeline_layout_ptr,
+                                           uint32_t                                    in_n_set,
                                            const Anvil::DescriptorUpdateTemplateEntry* in_update_entries_ptr,
                                            const uint32_t&                             in_n_update_entries)
 {
-    const Anvil::ExtensionKHRDescriptorUpdateTemplateEntrypoints* entrypoints_ptr = nullptr;
-    bool                                                          result          = true;
+    const Anvil::DescriptorSetCreateInfo*                         ds_create_info_ptr = nullptr;
+    const Anvil::ExtensionKHRDescriptorUpdateTemplateEntrypoints* entrypoints_ptr    = nullptr;
+    const bool                                                    is_push_template   = (in_opt_pipeline_layout_ptr != nullptr);
+    bool                                                          result             = true;
 
     if (!m_device_ptr->get_extension_info()->khr_descriptor_update_template() )
     {
@@ -105,12 +150,43 @@ bool Anvil::DescriptorUpdateTemplate::init(const Anvil::DescriptorSetLayout*
         goto end;
     }
 
-    if (in_descriptor_set_layout_ptr == nullptr)
+    if (is_push_template)
     {
-        anvil_assert(in_descriptor_set_layout_ptr != nullptr);
+        const auto ds_create_info_ptrs_ptr = in_opt_pipeline_layout_ptr->get_ds_create_info_ptrs();
 
-        result = false;
-        goto end;
+        if (!m_device_ptr->get_extension_info()->khr_push_descriptor() )
+        {
+            anvil_assert(m_device_ptr->get_extension_info()->khr_push_descriptor() );
+
+            result = false;
+            goto end;
+        }
+
+        if (ds_create_info_ptrs_ptr                          == nullptr  ||
+            ds_create_info_ptrs_ptr->size()                  <= in_n_set ||
+            ds_create_info_ptrs_ptr->at(in_n_set)            == nullptr  ||
+           !ds_create_info_ptrs_ptr->at(in_n_set)->is_push_descriptor_layout() )
+        {
+            /* The specified set must use a push descriptor layout */
+            anvil_assert_fail();
+
+            result = false;
+            goto end;
+        }
+
+        ds_create_info_ptr = ds_create_info_ptrs_ptr->at(in_n_set).get();
+    }
+    else
+    {
+        if (in_opt_descriptor_set_layout_ptr == nullptr)
+        {
+            anvil_assert(in_opt_descriptor_set_layout_ptr != nullptr);
+
+            result = false;
+            goto end;
+        }
+
+        ds_create_info_ptr = in_opt_descriptor_set_layout_ptr->get_create_info();
     }
 
     if (in_n_update_entries == 0)
@@ -150,25 +226,43 @@ bool Anvil::DescriptorUpdateTemplate::init(const Anvil::DescriptorSetLayout*
             update_entries.at(n_update_entry) = in_update_entries_ptr[n_update_entry].get_vk_descriptor_update_template_entry_khr();
         }
 
-        create_info.descriptorSetLayout        = in_descriptor_set_layout_ptr->get_layout();
         create_info.descriptorUpdateEntryCount = in_n_update_entries;
         create_info.flags                      = 0;
         create_info.pDescriptorUpdateEntries   = &update_entries.at(0);
-        create_info.pipelineBindPoint          = VK_PIPELINE_BIND_POINT_MAX_ENUM;
-        create_info.pipelineLayout             = VK_NULL_HANDLE;
         create_info.pNext                      = nullptr;
-        create_info.set                        = VK_NULL_HANDLE;
         create_info.sType                      = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR;
-        create_info.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
 
-        in_descriptor_set_layout_ptr->lock();
+        if (is_push_template)
         {
+            /* NOTE: descriptorSetLayout is ignored for push descriptor templates. */
+            create_info.descriptorSetLayout = VK_NULL_HANDLE;
+            create_info.pipelineBindPoint   = static_cast<VkPipelineBindPoint>(in_pipeline_bind_point);
+            create_info.pipelineLayout      = in_opt_pipeline_layout_ptr->get_pipeline_layout();
+            create_info.set                 = in_n_set;
+            create_info.templateType        = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR;
+
             result = is_vk_call_successful(entrypoints_ptr->vkCreateDescriptorUpdateTemplateKHR(m_device_ptr->get_device_vk(),
                                                                                                &create_info,
                                                                                                 nullptr, /* pAllocator */
                                                                                                &m_vk_object) );
         }
-        in_descriptor_set_layout_ptr->unlock();
+        else
+        {
+            create_info.descriptorSetLayout = in_opt_descriptor_set_layout_ptr->get_layout();
+            create_info.pipelineBindPoint   = VK_PIPELINE_BIND_POINT_MAX_ENUM;
+            create_info.pipelineLayout      = VK_NULL_HANDLE;
+            create_info.set                 = 0;
+            create_info.templateType        = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+
+            in_opt_descriptor_set_layout_ptr->lock();
+            {
+                result = is_vk_call_successful(entrypoints_ptr->vkCreateDescriptorUpdateTemplateKHR(m_device_ptr->get_device_vk(),
+                                                                                                   &create_info,
+                                                                                                    nullptr, /* pAllocator */
+                                                                                                   &m_vk_object) );
+            }
+            in_opt_descriptor_set_layout_ptr->unlock();
+        }
     }
 
     if (!result                        ||
@@ -183,9 +277,16 @@ bool Anvil::DescriptorUpdateTemplate::init(const Anvil::DescriptorSetLayout*
 
     set_vk_handle(m_vk_object);
 
+    if (is_push_template)
+    {
+        m_n_set               = in_n_set;
+        m_pipeline_bind_point = in_pipeline_bind_point;
+        m_pipeline_layout_ptr = in_opt_pipeline_layout_ptr;
+    }
+
     /* Finally, also cache descriptor set create info using the user-specified DS layout */
     m_ds_create_info_ptr.reset(
-        new Anvil::DescriptorSetCreateInfo(*in_descriptor_set_layout_ptr->get_create_info() )
+        new Anvil::DescriptorSetCreateInfo(*ds_create_info_ptr)
     );
 
     if (m_ds_create_info_ptr == nullptr)
@@ -212,6 +313,14 @@ void Anvil::DescriptorUpdateTemplate::update_descriptor_set(const Anvil::Descrip
         goto end;
     }
 
+    if (is_push_descriptor_template() )
+    {
+        /* Push descriptor templates can only be used with CommandBufferBase::record_push_descriptor_set_with_template() */
+        anvil_assert(!is_push_descriptor_template() );
+
+        goto end;
+    }
+
     #ifdef _DEBUG
     {
         if (!(*inout_ds_ptr->get_descriptor_set_layout()->get_create_info() == *m_ds_create_info_ptr) )
@@ -21,7 +21,9 @@
 //
 
 #include "misc/debug.h"
+#include "misc/descriptor_update_template_cache.h"
 #include "misc/object_tracker.h"
+#include "misc/resource_release_queue.h"
 #include "misc/shader_module_cache.h"
 #include "misc/struct_chainer.h"
 #include "misc/swapchain_create_info.h"
@@ -71,14 +73,17 @@ Anvil::BaseDevice::~BaseDevice()
         wait_idle();
     }
 
-    m_command_pool_ptr_per_vk_queue_fam.clear();
-    m_compute_pipeline_manager_ptr.reset     ();
-    m_dummy_dsg_ptr.reset                    ();
-    m_graphics_pipeline_manager_ptr.reset    ();
-    m_descriptor_set_layout_manager_ptr.reset();
-    m_pipeline_cache_ptr.reset               ();
-    m_pipeline_layout_manager_ptr.reset      ();
-    m_owned_queues.clear                     ();
+    /* Objects queued for release may depend on any of the objects below, so get rid of them first. */
+    m_resource_release_queue_ptr.reset          ();
+    m_command_pool_ptr_per_vk_queue_fam.clear   ();
+    m_compute_pipeline_manager_ptr.reset        ();
+    m_dummy_dsg_ptr.reset                       ();
+    m_graphics_pipeline_manager_ptr.reset       ();
+    m_descriptor_update_template_cache_ptr.reset();
+    m_descriptor_set_layout_manager_ptr.reset   ();
+    m_pipeline_cache_ptr.reset                  ();
+    m_pipeline_layout_manager_ptr.reset         ();
+    m_owned_queues.clear                        ();
 
     if (m_device != VK_NULL_HANDLE)
     {
@@ -566,6 +571,11 @@ void Anvil::BaseDevice::add_physical_device_features_to_chainer(Anvil::StructCha
         in_struct_chainer_ptr->append_struct(features.khr_float16_int8_features_ptr->get_vk_physical_device_float16_int8_features() );
     }
 
+    if (m_extension_enabled_info_ptr->get_device_extension_info()->khr_timeline_semaphore() )
+    {
+        in_struct_chainer_ptr->append_struct(features.khr_timeline_semaphore_features_ptr->get_vk_physical_device_timeline_semaphore_features() );
+    }
+
     if (m_extension_enabled_info_ptr->get_device_extension_info()->khr_variable_pointers() )
     {
         in_struct_chainer_ptr->append_struct(features.khr_variable_pointer_features_ptr->get_vk_physical_device_variable_pointer_features() );
@@ -1190,6 +1200,9 @@ bool Anvil::BaseDevice::init()
         m_shader_module_cache_ptr = Anvil::ShaderModuleCache::create();
     }
 
+    /* Set up the descriptor update template cache. Templates are created lazily, so this is cheap. */
+    m_descriptor_update_template_cache_ptr = Anvil::DescriptorUpdateTemplateCache::create(this);
+
     /* Set up the pipeline cache */
     m_pipeline_cache_ptr = Anvil::PipelineCache::create(this,
                                                         is_mt_safe() );
@@ -1212,6 +1225,19 @@ bool Anvil::BaseDevice::init()
                                                                              true /* use_pipeline_cache */,
                                                                              m_pipeline_cache_ptr.get() );
 
+    /* Set up the resource release queue */
+    {
+        std::vector<Anvil::Queue*> queue_ptrs;
+
+        for (const auto& current_queue_ptr : m_owned_queues)
+        {
+            queue_ptrs.push_back(current_queue_ptr.get() );
+        }
+
+        m_resource_release_queue_ptr = Anvil::ResourceReleaseQueue::create(this,
+                                                                           queue_ptrs);
+    }
+
     /* Continue with specialized initialization */
     init_device();
 
@@ -1534,6 +1560,22 @@ bool Anvil::BaseDevice::init_extension_func_ptrs()
         anvil_assert(m_khr_maintenance3_extension_entrypoints.vkGetDescriptorSetLayoutSupportKHR != nullptr);
     }
 
+    if (m_extension_enabled_info_ptr->get_device_extension_info()->khr_push_descriptor() )
+    {
+        m_khr_push_descriptor_extension_entrypoints.vkCmdPushDescriptorSetKHR = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(get_proc_address("vkCmdPushDescriptorSetKHR") );
+
+        anvil_assert(m_khr_push_descriptor_extension_entrypoints.vkCmdPushDescriptorSetKHR != nullptr);
+
+        /* vkCmdPushDescriptorSetWithTemplateKHR() is only available if descriptor update templates are also supported. */
+        if (m_extension_enabled_info_ptr->get_device_extension_info()->khr_descriptor_update_template() ||
+            is_core_vk11_device)
+        {
+            m_khr_push_descriptor_extension_entrypoints.vkCmdPushDescriptorSetWithTemplateKHR = reinterpret_cast<PFN_vkCmdPushDescriptorSetWithTemplateKHR>(get_proc_address("vkCmdPushDescriptorSetWithTemplateKHR") );
+
+            anvil_assert(m_khr_push_descriptor_extension_entrypoints.vkCmdPushDescriptorSetWithTemplateKHR != nullptr);
+        }
+    }
+
     if (m_extension_enabled_info_ptr->get_device_extension_info()->khr_sampler_ycbcr_conversion() ||
         is_core_vk11_device)
     {
@@ -1564,6 +1606,17 @@ bool Anvil::BaseDevice::init_extension_func_ptrs()
         anvil_assert(m_khr_swapchain_extension_entrypoints.vkQueuePresentKHR       != nullptr);
     }
 
+    if (m_extension_enabled_info_ptr->get_device_extension_info()->khr_timeline_semaphore() )
+    {
+        m_khr_timeline_semaphore_extension_entrypoints.vkGetSemaphoreCounterValueKHR = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(get_proc_address("vkGetSemaphoreCounterValueKHR") );
+        m_khr_timeline_semaphore_extension_entrypoints.vkSignalSemaphoreKHR          = reinterpret_cast<PFN_vkSignalSemaphoreKHR>         (get_proc_address("vkSignalSemaphoreKHR") );
+        m_khr_timeline_semaphore_extension_entrypoints.vkWaitSemaphoresKHR           = reinterpret_cast<PFN_vkWaitSemaphoresKHR>          (get_proc_address("vkWaitSemaphoresKHR") );
+
+        anvil_assert(m_khr_timeline_semaphore_extension_entrypoints.vkGetSemaphoreCounterValueKHR != nullptr);
+        anvil_assert(m_khr_timeline_semaphore_extension_entrypoints.vkSignalSemaphoreKHR          != nullptr);
+        anvil_assert(m_khr_timeline_semaphore_extension_entrypoints.vkWaitSemaphoresKHR           != nullptr);
+    }
+
     return true;
 }
 
@@ -1814,9 +1814,14 @@ void Anvil::Image::on_memory_backing_update(const Anvil::ImageSubresource& in_su
     anvil_assert((in_offset.x      % aspect_props_iterator->second.granularity.width)  == 0 &&
                  (in_offset.y      % aspect_props_iterator->second.granularity.height) == 0 &&
                  (in_offset.z      % aspect_props_iterator->second.granularity.depth)  == 0);
-    anvil_assert((in_extent.width  % aspect_props_iterator->second.granularity.width)  == 0 &&
-                 (in_extent.height % aspect_props_iterator->second.granularity.height) == 0 &&
-                 (in_extent.depth  % aspect_props_iterator->second.granularity.depth)  == 0);
+    /* Extent must be a multiple of the granularity, unless the region reaches the edge of the mip */
+    const VkExtent3D mip_extent = get_image_extent_3D(in_subresource.mip_level);
+
+    ANVIL_REDUNDANT_VARIABLE_CONST(mip_extent);
+
+    anvil_assert(((in_extent.width  % aspect_props_iterator->second.granularity.width)  == 0 || static_cast<uint32_t>(in_offset.x) + in_extent.width  == mip_extent.width)  &&
+                 ((in_extent.height % aspect_props_iterator->second.granularity.height) == 0 || static_cast<uint32_t>(in_offset.y) + in_extent.height == mip_extent.height) &&
+                 ((in_extent.depth  % aspect_props_iterator->second.granularity.depth)  == 0 || static_cast<uint32_t>(in_offset.z) + in_extent.depth  == mip_extent.depth) );
 
     anvil_assert(aspect_page_occupancy_iterator->second->layers.size() >= in_subresource.array_layer);
     aspect_layer_ptr = &aspect_page_occupancy_iterator->second->layers.at(in_subresource.array_layer);
@@ -1826,9 +1831,9 @@ void Anvil::Image::on_memory_backing_update(const Anvil::ImageSubresource& in_su
 
     const uint32_t extent_tile[] =
     {
-        in_extent.width  / aspect_props_iterator->second.granularity.width,
-        in_extent.height / aspect_props_iterator->second.granularity.height,
-        in_extent.depth  / aspect_props_iterator->second.granularity.depth
+        Anvil::Utils::round_up(in_extent.width,  aspect_props_iterator->second.granularity.width)  / aspect_props_iterator->second.granularity.width,
+        Anvil::Utils::round_up(in_extent.height, aspect_props_iterator->second.granularity.height) / aspect_props_iterator->second.granularity.height,
+        Anvil::Utils::round_up(in_extent.depth,  aspect_props_iterator->second.granularity.depth)  / aspect_props_iterator->second.granularity.depth
     };
     const uint32_t offset_tile[] =
     {
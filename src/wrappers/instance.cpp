@@ -21,6 +21,7 @@
 //
 #include "misc/debug.h"
 #include "misc/debug_messenger_create_info.h"
+#include "misc/null_driver.h"
 #include "misc/object_tracker.h"
 #include "wrappers/instance.h"
 #include "wrappers/physical_device.h"
@@ -28,7 +29,10 @@
 static bool                    g_core_func_ptrs_inited     = false;
 static bool                    g_instance_func_ptrs_inited = false;
 static std::mutex              g_vk_func_ptr_init_mutex;
-static Anvil::LibraryUniquePtr g_vk_library_ptr;
+
+#if !defined(ANVIL_USE_NULL_DRIVER)
+    static Anvil::LibraryUniquePtr g_vk_library_ptr;
+#endif
 
 
 /** Please see header for specification */
@@ -1130,17 +1134,21 @@ bool Anvil::Instance::init_vk_func_ptrs()
 
     #if !defined(ANVIL_LINK_STATICALLY_WITH_VULKAN_LIB)
     {
-        if (g_vk_library_ptr == nullptr)
+        #if !defined(ANVIL_USE_NULL_DRIVER)
         {
-            g_vk_library_ptr = Anvil::Library::create(ANVIL_VULKAN_DYNAMIC_DLL);
-
             if (g_vk_library_ptr == nullptr)
             {
-                anvil_assert(g_vk_library_ptr != nullptr);
+                g_vk_library_ptr = Anvil::Library::create(ANVIL_VULKAN_DYNAMIC_DLL);
 
-                goto end;
+                if (g_vk_library_ptr == nullptr)
+                {
+                    anvil_assert(g_vk_library_ptr != nullptr);
+
+                    goto end;
+                }
             }
         }
+        #endif
 
         /* VK 1.0 func ptrgetters - all entrypoints must be present */
         for (const auto& current_func_data : functions_vk10)
@@ -1148,7 +1156,15 @@ bool Anvil::Instance::init_vk_func_ptrs()
             if (!current_func_data.requires_getter_call &&
                 !g_core_func_ptrs_inited)
             {
-                *current_func_data.result_func_ptr = g_vk_library_ptr->get_proc_address(current_func_data.func_name.c_str() );
+                #if defined(ANVIL_USE_NULL_DRIVER)
+                {
+                    *current_func_data.result_func_ptr = reinterpret_cast<void*>(Anvil::NullDriver::get_proc_address(current_func_data.func_name.c_str() ));
+                }
+                #else
+                {
+                    *current_func_data.result_func_ptr = g_vk_library_ptr->get_proc_address(current_func_data.func_name.c_str() );
+                }
+                #endif
 
                 if (*current_func_data.result_func_ptr == nullptr)
                 {
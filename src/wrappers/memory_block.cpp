@@ -31,6 +31,7 @@
 #include "wrappers/image.h"
 #include "wrappers/memory_block.h"
 #include "wrappers/physical_device.h"
+#include <algorithm>
 
 /* Please see header for specification */
 Anvil::MemoryBlock::MemoryBlock(Anvil::MemoryBlockCreateInfoUniquePtr in_create_info_ptr)
@@ -39,6 +40,8 @@ Anvil::MemoryBlock::MemoryBlock(Anvil::MemoryBlockCreateInfoUniquePtr in_create_
      m_backend_object                     (nullptr),
      m_gpu_data_map_count                 (0),
      m_gpu_data_ptr                       (nullptr),
+     m_n_open_write_batches               (0),
+     m_is_persistently_mapped             (false),
      m_memory                             (VK_NULL_HANDLE),
      m_parent_memory_allocator_backend_ptr(nullptr)
 {
@@ -63,6 +66,11 @@ Anvil::MemoryBlock::~MemoryBlock()
 {
     auto on_release_callback_function = m_create_info_ptr->get_on_release_callback_function();
 
+    if (m_is_persistently_mapped)
+    {
+        set_persistently_mapped(false);
+    }
+
     #ifdef _DEBUG
     {
         auto parent_memory_block_ptr = m_create_info_ptr->get_parent_memory_block();
@@ -70,6 +78,7 @@ Anvil::MemoryBlock::~MemoryBlock()
         if (parent_memory_block_ptr == nullptr)
         {
             anvil_assert(m_gpu_data_map_count.load() == 0);
+            anvil_assert(m_n_open_write_batches      == 0);
         }
     }
     #endif
@@ -100,6 +109,29 @@ Anvil::MemoryBlock::~MemoryBlock()
     }
 }
 
+/* Please see header for specification */
+bool Anvil::MemoryBlock::begin_write_batch()
+{
+    auto root_memory_block_ptr = get_root_memory_block();
+    bool result                = false;
+
+    /* Keep the memory mapped until the batch is closed */
+    if (!root_memory_block_ptr->open_gpu_memory_access() )
+    {
+        goto end;
+    }
+
+    root_memory_block_ptr->lock();
+    {
+        ++root_memory_block_ptr->m_n_open_write_batches;
+    }
+    root_memory_block_ptr->unlock();
+
+    result = true;
+end:
+    return result;
+}
+
 /** Finishes the memory mapping process, opened earlier with a open_gpu_memory_access() call. */
 void Anvil::MemoryBlock::close_gpu_memory_access()
 {
@@ -178,6 +210,51 @@ Anvil::MemoryBlockUniquePtr Anvil::MemoryBlock::create(Anvil::MemoryBlockCreateI
     return result_ptr;
 }
 
+/* Please see header for specification */
+bool Anvil::MemoryBlock::end_write_batch()
+{
+    std::vector<MappedRange> dirty_ranges;
+    bool                     is_batch_open         = false;
+    auto                     root_memory_block_ptr = get_root_memory_block();
+    bool                     result                = false;
+
+    root_memory_block_ptr->lock();
+    {
+        if (root_memory_block_ptr->m_n_open_write_batches > 0)
+        {
+            is_batch_open = true;
+
+            if (--root_memory_block_ptr->m_n_open_write_batches == 0)
+            {
+                dirty_ranges.swap(root_memory_block_ptr->m_write_batch_dirty_ranges);
+            }
+        }
+    }
+    root_memory_block_ptr->unlock();
+
+    if (!is_batch_open)
+    {
+        anvil_assert(is_batch_open);
+
+        goto end;
+    }
+
+    if (dirty_ranges.size() > 0)
+    {
+        result = root_memory_block_ptr->flush_or_invalidate_ranges(true, /* in_should_flush */
+                                                                   static_cast<uint32_t>(dirty_ranges.size() ),
+                                                                  &dirty_ranges.at(0) );
+    }
+    else
+    {
+        result = true;
+    }
+
+    root_memory_block_ptr->close_gpu_memory_access();
+end:
+    return result;
+}
+
 Anvil::ExternalHandleUniquePtr Anvil::MemoryBlock::export_to_external_memory_handle(const Anvil::ExternalMemoryHandleTypeFlagBits& in_memory_handle_type)
 {
     #if defined(_WIN32)
@@ -355,6 +432,126 @@ end:
     return result;
 }
 
+/** Flushes or invalidates the specified regions of a root memory block with a single API call.
+ *
+ *  Ranges are aligned to nonCoherentAtomSize. Overlapping and adjacent ranges are merged.
+ *  The function is a nop for memory blocks backed by coherent memory.
+ *
+ *  @param in_should_flush true to flush the ranges, false to invalidate them.
+ *  @param in_n_ranges     Number of ranges specified under @param in_ranges_ptr.
+ *  @param in_ranges_ptr   Ranges to use, relative to the memory block's start offset. Must not be nullptr
+ *                         if @param in_n_ranges is not 0.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::MemoryBlock::flush_or_invalidate_ranges(bool               in_should_flush,
+                                                    uint32_t           in_n_ranges,
+                                                    const MappedRange* in_ranges_ptr)
+{
+    const auto                       device_vk             (m_create_info_ptr->get_device()->get_device_vk() );
+    const VkDeviceSize               mem_block_end_offset  (m_start_offset + m_create_info_ptr->get_size() );
+    const auto                       non_coherent_atom_size(m_create_info_ptr->get_device()->get_physical_device_properties().core_vk1_0_properties_ptr->limits.non_coherent_atom_size);
+    std::vector<VkMappedMemoryRange> mapped_memory_ranges;
+    std::vector<MappedRange>         sorted_ranges;
+    VkResult                         result_vk             (VK_SUCCESS);
+
+    anvil_assert(m_create_info_ptr->get_parent_memory_block() == nullptr);
+
+    if ((m_create_info_ptr->get_memory_features() & Anvil::MemoryFeatureFlagBits::HOST_COHERENT_BIT) != 0 ||
+        in_n_ranges                                                                                    == 0)
+    {
+        goto end;
+    }
+
+    sorted_ranges.assign(in_ranges_ptr,
+                         in_ranges_ptr + in_n_ranges);
+
+    if (in_n_ranges > 1)
+    {
+        std::sort(sorted_ranges.begin(),
+                  sorted_ranges.end  () );
+    }
+
+    mapped_memory_ranges.reserve(in_n_ranges);
+
+    for (const auto& current_range : sorted_ranges)
+    {
+        const VkDeviceSize start_offset = Anvil::Utils::round_down(m_start_offset + current_range.start_offset,
+                                                                   non_coherent_atom_size);
+        const VkDeviceSize end_offset   = Anvil::Utils::round_up  (m_start_offset + current_range.end_offset,
+                                                                   non_coherent_atom_size);
+
+        if (mapped_memory_ranges.size() > 0)
+        {
+            auto& last_range = mapped_memory_ranges.back();
+
+            if (last_range.size == VK_WHOLE_SIZE)
+            {
+                /* The last range already covers all remaining ranges */
+                break;
+            }
+
+            if (last_range.offset + last_range.size >= start_offset)
+            {
+                last_range.size = std::max(last_range.offset + last_range.size,
+                                           end_offset) - last_range.offset;
+
+                if (last_range.offset + last_range.size > mem_block_end_offset)
+                {
+                    last_range.size = VK_WHOLE_SIZE;
+                }
+
+                continue;
+            }
+        }
+
+        {
+            VkMappedMemoryRange new_range;
+
+            new_range.memory = get_memory();
+            new_range.offset = start_offset;
+            new_range.pNext  = nullptr;
+            new_range.size   = (end_offset > mem_block_end_offset) ? VK_WHOLE_SIZE
+                                                                   : end_offset - start_offset;
+            new_range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+
+            mapped_memory_ranges.push_back(new_range);
+        }
+    }
+
+    if (in_should_flush)
+    {
+        result_vk = Anvil::Vulkan::vkFlushMappedMemoryRanges(device_vk,
+                                                             static_cast<uint32_t>(mapped_memory_ranges.size() ),
+                                                            &mapped_memory_ranges.at(0) );
+    }
+    else
+    {
+        result_vk = Anvil::Vulkan::vkInvalidateMappedMemoryRanges(device_vk,
+                                                                  static_cast<uint32_t>(mapped_memory_ranges.size() ),
+                                                                 &mapped_memory_ranges.at(0) );
+    }
+
+    anvil_assert_vk_call_succeeded(result_vk);
+end:
+    return is_vk_call_successful(result_vk);
+}
+
+/** Returns the memory block which owns the mapping for this memory block. For non-derived memory blocks,
+ *  this is the memory block itself.
+ **/
+Anvil::MemoryBlock* Anvil::MemoryBlock::get_root_memory_block()
+{
+    Anvil::MemoryBlock* result_ptr = this;
+
+    while (result_ptr->m_create_info_ptr->get_parent_memory_block() != nullptr)
+    {
+        result_ptr = result_ptr->m_create_info_ptr->get_parent_memory_block();
+    }
+
+    return result_ptr;
+}
+
 /* Allocates actual memory and caches a number of properties used to spawn the memory block */
 bool Anvil::MemoryBlock::init(VkResult* out_opt_result)
 {
@@ -613,29 +810,12 @@ bool Anvil::MemoryBlock::map(VkDeviceSize in_start_offset,
         if ((memory_features & Anvil::MemoryFeatureFlagBits::HOST_COHERENT_BIT) == 0)
         {
             /* Make sure the mapped region is invalidated before letting the user read from it */
-            VkMappedMemoryRange mapped_memory_range;
-            const auto          non_coherent_atom_size(m_create_info_ptr->get_device()->get_physical_device_properties().core_vk1_0_properties_ptr->limits.non_coherent_atom_size);
-            VkResult            result_vk             (VK_ERROR_INITIALIZATION_FAILED);
-
-            ANVIL_REDUNDANT_VARIABLE(result_vk);
+            const MappedRange range(in_start_offset,
+                                    in_start_offset + in_size);
 
-            mapped_memory_range.memory = get_memory();
-            mapped_memory_range.offset = Anvil::Utils::round_down(in_start_offset,
-                                                                  non_coherent_atom_size);
-            mapped_memory_range.pNext  = nullptr;
-            mapped_memory_range.size   = Anvil::Utils::round_up(in_size,
-                                                                non_coherent_atom_size);
-            mapped_memory_range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-
-            if (mapped_memory_range.size + mapped_memory_range.offset > m_create_info_ptr->get_size() )
-            {
-                mapped_memory_range.size = VK_WHOLE_SIZE;
-            }
-
-            result_vk = Anvil::Vulkan::vkInvalidateMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
-                                                                      1, /* memRangeCount */
-                                                                     &mapped_memory_range);
-            anvil_assert_vk_call_succeeded(result_vk);
+            flush_or_invalidate_ranges(false, /* in_should_flush */
+                                       1,     /* in_n_ranges     */
+                                      &range);
         }
 
         if (out_opt_data_ptr != nullptr)
@@ -742,6 +922,9 @@ bool Anvil::MemoryBlock::read(VkDeviceSize in_start_offset,
     }
     else
     {
+        const MappedRange range(in_start_offset,
+                                in_start_offset + in_size);
+
         if (!open_gpu_memory_access() )
         {
             anvil_assert_fail();
@@ -749,44 +932,124 @@ bool Anvil::MemoryBlock::read(VkDeviceSize in_start_offset,
             goto end;
         }
 
-        if ((m_create_info_ptr->get_memory_features() & Anvil::MemoryFeatureFlagBits::HOST_COHERENT_BIT) == 0)
+        result = flush_or_invalidate_ranges(false, /* in_should_flush */
+                                            1,     /* in_n_ranges     */
+                                           &range);
+
+        memcpy(out_result_ptr,
+               static_cast<char*>(m_gpu_data_ptr) + static_cast<intptr_t>(m_start_offset + in_start_offset),
+               static_cast<size_t>(in_size));
+
+        close_gpu_memory_access();
+    }
+
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::MemoryBlock::read_batch(uint32_t            in_n_regions,
+                                    const VkDeviceSize* in_start_offsets_ptr,
+                                    const VkDeviceSize* in_sizes_ptr,
+                                    void* const*        out_result_ptrs_ptr)
+{
+    bool result(false);
+
+    anvil_assert(in_n_regions         >  0);
+    anvil_assert(in_start_offsets_ptr != nullptr);
+    anvil_assert(in_sizes_ptr         != nullptr);
+    anvil_assert(out_result_ptrs_ptr  != nullptr);
+
+    if (m_create_info_ptr->get_parent_memory_block() != nullptr)
+    {
+        std::vector<VkDeviceSize> parent_start_offsets(in_n_regions);
+
+        for (uint32_t n_region = 0;
+                      n_region < in_n_regions;
+                    ++n_region)
         {
-            VkMappedMemoryRange mapped_memory_range;
-            const auto          mem_block_size         = m_create_info_ptr->get_size();
-            const auto          non_coherent_atom_size = m_create_info_ptr->get_device()->get_physical_device_properties().core_vk1_0_properties_ptr->limits.non_coherent_atom_size;
-            VkResult            result_vk              = VK_ERROR_INITIALIZATION_FAILED;
+            parent_start_offsets.at(n_region) = m_start_offset + in_start_offsets_ptr[n_region];
+        }
 
-            anvil_assert            (m_start_offset == 0);
-            ANVIL_REDUNDANT_VARIABLE(result_vk);
+        result = m_create_info_ptr->get_parent_memory_block()->read_batch(in_n_regions,
+                                                                          &parent_start_offsets.at(0),
+                                                                          in_sizes_ptr,
+                                                                          out_result_ptrs_ptr);
+    }
+    else
+    {
+        std::vector<MappedRange> ranges;
 
-            mapped_memory_range.memory = m_memory;
-            mapped_memory_range.offset = Anvil::Utils::round_down(in_start_offset,
-                                                                  non_coherent_atom_size);
-            mapped_memory_range.pNext  = nullptr;
-            mapped_memory_range.size   = Anvil::Utils::round_up(in_size,
-                                                                non_coherent_atom_size);
-            mapped_memory_range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        ranges.reserve(in_n_regions);
 
-            if (mapped_memory_range.size + mapped_memory_range.offset > mem_block_size)
-            {
-                mapped_memory_range.size = mem_block_size - mapped_memory_range.offset;
-            }
+        for (uint32_t n_region = 0;
+                      n_region < in_n_regions;
+                    ++n_region)
+        {
+            anvil_assert(in_sizes_ptr[n_region]                                  >  0);
+            anvil_assert(in_start_offsets_ptr[n_region] + in_sizes_ptr[n_region] <= m_create_info_ptr->get_size() );
 
-            result_vk = Anvil::Vulkan::vkInvalidateMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
-                                                                      1, /* memRangeCount */
-                                                                     &mapped_memory_range);
-            anvil_assert_vk_call_succeeded(result_vk);
+            ranges.push_back(
+                MappedRange(in_start_offsets_ptr[n_region],
+                            in_start_offsets_ptr[n_region] + in_sizes_ptr[n_region])
+            );
         }
 
-        memcpy(out_result_ptr,
-               static_cast<char*>(m_gpu_data_ptr) + static_cast<intptr_t>(in_start_offset),
-               static_cast<size_t>(in_size));
+        if (!open_gpu_memory_access() )
+        {
+            anvil_assert_fail();
+
+            goto end;
+        }
+
+        result = flush_or_invalidate_ranges(false, /* in_should_flush */
+                                            in_n_regions,
+                                           &ranges.at(0) );
+
+        for (uint32_t n_region = 0;
+                      n_region < in_n_regions;
+                    ++n_region)
+        {
+            memcpy(out_result_ptrs_ptr[n_region],
+                   static_cast<char*>(m_gpu_data_ptr) + static_cast<intptr_t>(m_start_offset + in_start_offsets_ptr[n_region]),
+                   static_cast<size_t>(in_sizes_ptr[n_region]) );
+        }
 
         close_gpu_memory_access();
+    }
+
+end:
+    return result;
+}
 
+/* Please see header for specification */
+bool Anvil::MemoryBlock::set_persistently_mapped(bool in_should_be_persistently_mapped)
+{
+    auto root_memory_block_ptr = get_root_memory_block();
+    bool result                = false;
+
+    if (m_is_persistently_mapped == in_should_be_persistently_mapped)
+    {
         result = true;
+
+        goto end;
     }
 
+    if (in_should_be_persistently_mapped)
+    {
+        /* The map count bumped here keeps the root memory block mapped until persistent mapping is disabled. */
+        if (!root_memory_block_ptr->open_gpu_memory_access() )
+        {
+            goto end;
+        }
+    }
+    else
+    {
+        root_memory_block_ptr->close_gpu_memory_access();
+    }
+
+    m_is_persistently_mapped = in_should_be_persistently_mapped;
+    result                   = true;
 end:
     return result;
 }
@@ -824,61 +1087,71 @@ end:
 bool Anvil::MemoryBlock::write(VkDeviceSize in_start_offset,
                                VkDeviceSize in_size,
                                const void*  in_data)
+{
+    anvil_assert(in_data != nullptr);
+
+    return write_with_producer(in_start_offset,
+                               in_size,
+                               [in_data](void* out_data_ptr, VkDeviceSize in_data_size)
+                               {
+                                   memcpy(out_data_ptr,
+                                          in_data,
+                                          static_cast<size_t>(in_data_size) );
+                               });
+}
+
+/* Please see header for specification */
+bool Anvil::MemoryBlock::write_with_producer(VkDeviceSize                       in_start_offset,
+                                             VkDeviceSize                       in_size,
+                                             const MemoryWriteProducerFunction& in_producer_function)
 {
     bool result(false);
 
     anvil_assert(in_size                   >  0);
     anvil_assert(in_start_offset + in_size <= in_start_offset + m_create_info_ptr->get_size() );
-    anvil_assert(in_data                   != nullptr);
+    anvil_assert(in_producer_function      != nullptr);
 
     if (m_create_info_ptr->get_parent_memory_block() != nullptr)
     {
-        result = m_create_info_ptr->get_parent_memory_block()->write(m_start_offset + in_start_offset,
-                                                                     in_size,
-                                                                     in_data);
+        result = m_create_info_ptr->get_parent_memory_block()->write_with_producer(m_start_offset + in_start_offset,
+                                                                                   in_size,
+                                                                                   in_producer_function);
     }
     else
     {
+        const MappedRange dirty_range(in_start_offset,
+                                      in_start_offset + in_size);
+        bool              is_batched (false);
+
         if (!open_gpu_memory_access() )
         {
             goto end;
         }
 
-        memcpy(static_cast<char*>(m_gpu_data_ptr) + static_cast<intptr_t>(in_start_offset),
-               in_data,
-               static_cast<size_t>(in_size));
+        in_producer_function(static_cast<char*>(m_gpu_data_ptr) + static_cast<intptr_t>(m_start_offset + in_start_offset),
+                             in_size);
 
         if ((m_create_info_ptr->get_memory_features() & Anvil::MemoryFeatureFlagBits::HOST_COHERENT_BIT) == 0)
         {
-            VkMappedMemoryRange mapped_memory_range;
-            const auto          mem_block_size         = m_create_info_ptr->get_size();
-            const auto          non_coherent_atom_size = m_create_info_ptr->get_device()->get_physical_device_properties().core_vk1_0_properties_ptr->limits.non_coherent_atom_size;
-            auto                result_vk              = VkResult(VK_ERROR_INITIALIZATION_FAILED);
-
-            ANVIL_REDUNDANT_VARIABLE(result_vk);
-
-            mapped_memory_range.memory = m_memory;
-            mapped_memory_range.offset = Anvil::Utils::round_down(in_start_offset,
-                                                                  non_coherent_atom_size);
-            mapped_memory_range.pNext  = nullptr;
-            mapped_memory_range.size   = Anvil::Utils::round_up(in_size,
-                                                                non_coherent_atom_size);
-            mapped_memory_range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-
-            if (mapped_memory_range.size + mapped_memory_range.offset > mem_block_size)
+            /* If a write batch is open, defer the flush until the batch is closed */
+            lock();
             {
-                mapped_memory_range.size = mem_block_size - mapped_memory_range.offset;
-            }
+                if (m_n_open_write_batches > 0)
+                {
+                    m_write_batch_dirty_ranges.push_back(dirty_range);
 
-            result_vk = Anvil::Vulkan::vkFlushMappedMemoryRanges(m_create_info_ptr->get_device()->get_device_vk(),
-                                                                 1, /* memRangeCount */
-                                                                &mapped_memory_range);
-            anvil_assert_vk_call_succeeded(result_vk);
+                    is_batched = true;
+                }
+            }
+            unlock();
         }
 
-        close_gpu_memory_access();
+        result = (is_batched) ? true
+                              : flush_or_invalidate_ranges(true, /* in_should_flush */
+                                                           1,    /* in_n_ranges     */
+                                                          &dirty_range);
 
-        result = true;
+        close_gpu_memory_access();
     }
 
 end:
@@ -36,10 +36,36 @@
 #include "wrappers/rendering_surface.h"
 #include "wrappers/semaphore.h"
 #include "wrappers/swapchain.h"
+#include "wrappers/timeline_semaphore.h"
 
 #define MAX_SWAPCHAINS (32)
 
 
+/** Tells whether @param in_submit_info specifies D3D12 fence values for its binary semaphores. If so, no additional
+ *  semaphores can be appended to the batch, since the number of D3D12 fence values must match the number of semaphores.
+ **/
+static bool uses_d3d12_fence_semaphore_values(const Anvil::SubmitInfo& in_submit_info)
+{
+    bool result = false;
+
+    #if defined(_WIN32)
+    {
+        const uint64_t* signal_values_ptr = nullptr;
+        const uint64_t* wait_values_ptr   = nullptr;
+
+        result = in_submit_info.get_d3d12_fence_semaphore_values(&signal_values_ptr,
+                                                                 &wait_values_ptr);
+    }
+    #else
+    {
+        ANVIL_REDUNDANT_ARGUMENT_CONST(in_submit_info);
+    }
+    #endif
+
+    return result;
+}
+
+
 /** Please see header for specification */
 Anvil::Queue::Queue(const Anvil::BaseDevice*          in_device_ptr,
                     uint32_t                          in_queue_family_index,
@@ -56,7 +82,8 @@ Anvil::Queue::Queue(const Anvil::BaseDevice*          in_device_ptr,
      m_queue                        (VK_NULL_HANDLE),
      m_queue_family_index           (in_queue_family_index),
      m_queue_global_priority        (in_global_priority),
-     m_queue_index                  (in_queue_index)
+     m_queue_index                  (in_queue_index),
+     m_submission_tracking_value    (0)
 {
     /* Retrieve the Vulkan handle */
     Anvil::Vulkan::vkGetDeviceQueue(m_device_ptr->get_device_vk(),
@@ -90,6 +117,8 @@ Anvil::Queue::~Queue()
 {
     anvil_assert(m_n_debug_label_regions_started == 0);
 
+    m_submission_tracking_semaphore_ptr.reset();
+
     Anvil::ObjectTracker::get()->unregister_object(Anvil::ObjectType::QUEUE,
                                                     this);
 }
@@ -164,10 +193,31 @@ bool Anvil::Queue::bind_sparse_memory(Anvil::SparseMemoryBindingUpdateInfo& in_u
                                        true); /* in_should_lock */
     }
     {
+        std::unique_lock<std::mutex> tracking_lock     (m_submission_tracking_mutex);
+        Anvil::FenceUniquePtr        tracking_fence_ptr(acquire_submission_tracking_fence(fence_ptr) );
+
         result = Anvil::Vulkan::vkQueueBindSparse(m_queue,
                                                   n_bind_info_items,
                                                   bind_info_items,
-                                                  (fence_ptr != nullptr) ? fence_ptr->get_fence() : VK_NULL_HANDLE);
+                                                  (fence_ptr          != nullptr) ? fence_ptr->get_fence         ()
+                                                : (tracking_fence_ptr != nullptr) ? tracking_fence_ptr->get_fence()
+                                                                                  : VK_NULL_HANDLE);
+
+        /* Bind info structures come from @param in_update as they are, so unless the emulation fence could be used,
+         * the tracking value is signalled with a separate, empty submission. */
+        if (result                              == VK_SUCCESS &&
+            m_submission_tracking_semaphore_ptr != nullptr)
+        {
+            if (signal_submission_tracking_value(m_submission_tracking_value + 1,
+                                                 std::move(tracking_fence_ptr) ))
+            {
+                ++m_submission_tracking_value;
+            }
+            else
+            {
+                anvil_assert_fail();
+            }
+        }
     }
     if (mt_safe)
     {
@@ -498,6 +548,110 @@ end:
     ;
 }
 
+/** Please see header for specification */
+bool Anvil::Queue::get_completed_submission_tracking_value(uint64_t* out_result_ptr) const
+{
+    std::unique_lock<std::mutex> lock (m_submission_tracking_mutex);
+    bool                         result(false);
+
+    anvil_assert(out_result_ptr != nullptr);
+
+    if (m_submission_tracking_semaphore_ptr == nullptr)
+    {
+        /* No submission has been tracked so far */
+        *out_result_ptr = 0;
+        result          = true;
+    }
+    else
+    {
+        result = m_submission_tracking_semaphore_ptr->get_value(out_result_ptr);
+    }
+
+    return result;
+}
+
+/** Please see header for specification */
+uint64_t Anvil::Queue::get_submission_tracking_value()
+{
+    uint64_t result = 0;
+
+    if (init_submission_tracking_semaphore() )
+    {
+        std::unique_lock<std::mutex> lock(m_submission_tracking_mutex);
+
+        result = m_submission_tracking_value;
+    }
+    else
+    {
+        /* Nothing can be tracked, so make sure all work submitted so far has completed instead. */
+        wait_idle();
+    }
+
+    return result;
+}
+
+/** Creates the timeline semaphore, which submissions made to the queue signal with increasing submission tracking
+ *  values, if it has not been created yet. Work submitted before then has not signalled the timeline, so the first
+ *  value is signalled right away to cover it.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::Queue::init_submission_tracking_semaphore()
+{
+    bool result = true;
+
+    if (is_submission_tracking_enabled() )
+    {
+        goto end;
+    }
+
+    lock();
+    {
+        std::unique_lock<std::mutex> tracking_lock(m_submission_tracking_mutex);
+
+        if (m_submission_tracking_semaphore_ptr == nullptr)
+        {
+            m_submission_tracking_semaphore_ptr = Anvil::TimelineSemaphore::create(m_device_ptr,
+                                                                                   0, /* in_initial_value */
+                                                                                   Anvil::MTSafety::ENABLED);
+
+            if (m_submission_tracking_semaphore_ptr == nullptr)
+            {
+                anvil_assert(m_submission_tracking_semaphore_ptr != nullptr);
+
+                result = false;
+            }
+            else
+            if (signal_submission_tracking_value(m_submission_tracking_value + 1,
+                                                 Anvil::FenceUniquePtr() ))
+            {
+                ++m_submission_tracking_value;
+            }
+            else
+            {
+                anvil_assert_fail();
+
+                /* Nobody could have seen the semaphore yet, since the tracking mutex is still locked */
+                m_submission_tracking_semaphore_ptr.reset();
+
+                result = false;
+            }
+        }
+    }
+    unlock();
+
+end:
+    return result;
+}
+
+/** Tells whether submissions made to the queue signal the submission tracking timeline. */
+bool Anvil::Queue::is_submission_tracking_enabled() const
+{
+    std::unique_lock<std::mutex> lock(m_submission_tracking_mutex);
+
+    return (m_submission_tracking_semaphore_ptr != nullptr);
+}
+
 /** Please see header for specification */
 void Anvil::Queue::insert_debug_utils_label(const char*  in_label_name_ptr,
                                             const float* in_color_vec4_ptr)
@@ -826,14 +980,14 @@ bool Anvil::Queue::present_internal(DeviceGroupPresentModeFlagBits      in_prese
                                     Anvil::Semaphore* const*            in_wait_semaphore_ptrs,
                                     Anvil::SwapchainOperationErrorCode* out_present_results_ptr)
 {
-    const Anvil::DeviceType                 device_type              (m_device_ptr->get_type() );
-    VkResult                                presentation_results     [MAX_SWAPCHAINS];
-    bool                                    result                   (false);
-    VkResult                                result_vk;
-    Anvil::StructChainer<VkPresentInfoKHR>  struct_chainer;
-    const ExtensionKHRSwapchainEntrypoints* swapchain_entrypoints_ptr(nullptr);
-    VkSwapchainKHR                          swapchains_vk          [MAX_SWAPCHAINS];
-    std::vector<VkSemaphore>                wait_semaphores_vk     (in_n_wait_semaphores);
+    const Anvil::DeviceType                     device_type              (m_device_ptr->get_type() );
+    VkResult                                    presentation_results     [MAX_SWAPCHAINS];
+    bool                                        result                   (false);
+    VkResult                                    result_vk;
+    Anvil::FixedStructChainer<VkPresentInfoKHR> struct_chainer;
+    const ExtensionKHRSwapchainEntrypoints*     swapchain_entrypoints_ptr(nullptr);
+    VkSwapchainKHR                              swapchains_vk          [MAX_SWAPCHAINS];
+    std::vector<VkSemaphore>                    wait_semaphores_vk     (in_n_wait_semaphores);
 
     /* Sanity checks */
     anvil_assert(in_n_swapchains      <  MAX_SWAPCHAINS);
@@ -940,10 +1094,8 @@ bool Anvil::Queue::present_internal(DeviceGroupPresentModeFlagBits      in_prese
                         in_wait_semaphore_ptrs,
                         true);
     {
-        auto chain_ptr = struct_chainer.create_chain();
-
         result_vk = swapchain_entrypoints_ptr->vkQueuePresentKHR(m_queue,
-                                                                 chain_ptr->get_root_struct() );
+                                                                 struct_chainer.get_root_struct() );
     }
     present_lock_unlock(in_n_swapchains,
                         in_swapchains,
@@ -1016,26 +1168,203 @@ void Anvil::Queue::present_lock_unlock(uint32_t                       in_n_swapc
     }
 }
 
+/** Returns a fence, which a batch should be submitted with so that the emulated submission tracking timeline can be
+ *  signalled without an additional submission. Returns nullptr if submission tracking is disabled, the timeline is not
+ *  emulated or the batch comes with a fence of its own.
+ *
+ *  The submission tracking mutex must be locked by the caller.
+ *
+ *  @param in_opt_batch_fence_ptr Fence the batch is going to be submitted with. May be nullptr.
+ **/
+Anvil::FenceUniquePtr Anvil::Queue::acquire_submission_tracking_fence(const Anvil::Fence* in_opt_batch_fence_ptr)
+{
+    Anvil::FenceUniquePtr result_ptr;
+
+    if (in_opt_batch_fence_ptr              == nullptr &&
+        m_submission_tracking_semaphore_ptr != nullptr &&
+        m_submission_tracking_semaphore_ptr->is_emulated() )
+    {
+        result_ptr = m_submission_tracking_semaphore_ptr->acquire_emulation_fence();
+    }
+
+    return result_ptr;
+}
+
+/** Signals submission tracking value @param in_value once all work submitted to the queue so far finishes executing.
+ *  Used for submissions which cannot carry the timeline semaphore signal operation themselves.
+ *
+ *  The queue and the submission tracking mutex must be locked by the caller.
+ *
+ *  @param in_value                   Value to signal. Must be larger than the last signalled value.
+ *  @param in_opt_submitted_fence_ptr Fence returned by acquire_submission_tracking_fence(), which the last batch has
+ *                                    been submitted with. If not nullptr, no additional submission is made.
+ *
+ *  @return true if successful, false otherwise.
+ **/
+bool Anvil::Queue::signal_submission_tracking_value(uint64_t              in_value,
+                                                    Anvil::FenceUniquePtr in_opt_submitted_fence_ptr)
+{
+    bool result = false;
+
+    anvil_assert(m_submission_tracking_semaphore_ptr != nullptr);
+
+    if (in_opt_submitted_fence_ptr != nullptr)
+    {
+        m_submission_tracking_semaphore_ptr->enqueue_emulated_signal_fence(std::move(in_opt_submitted_fence_ptr),
+                                                                           in_value);
+
+        result = true;
+    }
+    else
+    if (m_submission_tracking_semaphore_ptr->is_emulated() )
+    {
+        result = m_submission_tracking_semaphore_ptr->enqueue_emulated_signal(m_queue,
+                                                                               in_value);
+    }
+    else
+    {
+        VkSubmitInfo                     submit_info;
+        const VkSemaphore                semaphore_vk = m_submission_tracking_semaphore_ptr->get_semaphore();
+        VkTimelineSemaphoreSubmitInfoKHR timeline_info;
+        VkResult                         result_vk;
+
+        timeline_info.pNext                     = nullptr;
+        timeline_info.pSignalSemaphoreValues    = &in_value;
+        timeline_info.pWaitSemaphoreValues      = nullptr;
+        timeline_info.signalSemaphoreValueCount = 1;
+        timeline_info.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        timeline_info.waitSemaphoreValueCount   = 0;
+
+        submit_info.commandBufferCount   = 0;
+        submit_info.pCommandBuffers      = nullptr;
+        submit_info.pNext                = &timeline_info;
+        submit_info.pSignalSemaphores    = &semaphore_vk;
+        submit_info.pWaitDstStageMask    = nullptr;
+        submit_info.pWaitSemaphores      = nullptr;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.waitSemaphoreCount   = 0;
+
+        result_vk = Anvil::Vulkan::vkQueueSubmit(m_queue,
+                                                 1, /* submitCount */
+                                                &submit_info,
+                                                 VK_NULL_HANDLE);
+
+        anvil_assert_vk_call_succeeded(result_vk);
+
+        result = is_vk_call_successful(result_vk);
+    }
+
+    return result;
+}
+
 /** Please see header for specification */
 bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
 {
-    Anvil::Fence*                      fence_ptr        (in_submit_info.get_fence() );
-    bool                               needs_fence_reset(false);
-    VkResult                           result           (VK_ERROR_INITIALIZATION_FAILED);
-    Anvil::StructChainer<VkSubmitInfo> struct_chainer;
-
-    std::vector<VkCommandBuffer> cmd_buffers_vk         (in_submit_info.get_n_command_buffers  () );
-    std::vector<VkDeviceMemory>  device_memory_block_vec(0);
-    std::vector<VkSemaphore>     signal_semaphores_vk   (in_submit_info.get_n_signal_semaphores() );
-    std::vector<VkSemaphore>     wait_semaphores_vk     (in_submit_info.get_n_wait_semaphores  () );
+    Anvil::Fence*                           fence_ptr        (in_submit_info.get_fence() );
+    bool                                    needs_fence_reset(false);
+    VkResult                                result           (VK_ERROR_INITIALIZATION_FAILED);
+    Anvil::FixedStructChainer<VkSubmitInfo> struct_chainer;
+
+    /* Timeline semaphores are appended to binary semaphores, unless they need to be emulated.
+     *
+     * Once submission tracking has been enabled, every submission also signals the queue's submission tracking
+     * timeline. If possible, the signal operation is appended to the batch as the last signal semaphore. Emulated
+     * timelines cannot be signalled from within a batch, so the batch is submitted with an emulation fence instead,
+     * unless it comes with a fence of its own. D3D12 fence values can only be specified for binary semaphores. In
+     * the remaining cases, the tracking value is signalled right after the batch is submitted. */
+    const uint32_t n_timeline_signal_semaphores = in_submit_info.get_n_timeline_signal_semaphores();
+    const uint32_t n_timeline_wait_semaphores   = in_submit_info.get_n_timeline_wait_semaphores  ();
+    const bool     uses_native_timelines        = m_device_ptr->get_extension_info()->khr_timeline_semaphore();
+    const bool     tracking_signal_in_batch     = uses_native_timelines && !uses_d3d12_fence_semaphore_values(in_submit_info) && is_submission_tracking_enabled();
+    const uint32_t n_signal_semaphores_total    = in_submit_info.get_n_signal_semaphores() + ((uses_native_timelines)    ? n_timeline_signal_semaphores : 0)
+                                                                                           + ((tracking_signal_in_batch) ? 1                            : 0);
+    const uint32_t n_wait_semaphores_total      = in_submit_info.get_n_wait_semaphores  () + ((uses_native_timelines) ? n_timeline_wait_semaphores   : 0);
+
+    std::vector<VkCommandBuffer>      cmd_buffers_vk         (in_submit_info.get_n_command_buffers() );
+    std::vector<VkDeviceMemory>       device_memory_block_vec(0);
+    std::vector<VkSemaphore>          signal_semaphores_vk   (n_signal_semaphores_total);
+    std::vector<uint64_t>             signal_semaphore_values(n_signal_semaphores_total, 0);
+    std::vector<VkPipelineStageFlags> wait_dst_stage_masks_vk(n_wait_semaphores_total);
+    std::vector<VkSemaphore>          wait_semaphores_vk     (n_wait_semaphores_total);
+    std::vector<uint64_t>             wait_semaphore_values  (n_wait_semaphores_total, 0);
 
     std::vector<uint32_t> cmd_buffer_device_masks         = std::vector<uint32_t>(in_submit_info.get_n_command_buffers() );
-    std::vector<uint32_t> signal_semaphore_device_indices = std::vector<uint32_t>(in_submit_info.get_n_signal_semaphores() );
-    std::vector<uint32_t> wait_semaphore_device_indices   = std::vector<uint32_t>(in_submit_info.get_n_wait_semaphores  () );
+    std::vector<uint32_t> signal_semaphore_device_indices = std::vector<uint32_t>(n_signal_semaphores_total);
+    std::vector<uint32_t> wait_semaphore_device_indices   = std::vector<uint32_t>(n_wait_semaphores_total);
 
 
     ANVIL_REDUNDANT_VARIABLE(result);
 
+    if (tracking_signal_in_batch)
+    {
+        /* The value is assigned right before the batch is submitted, after the queue has been locked. The semaphore
+         * is never released once created, so it can be accessed without locking the tracking mutex. */
+        signal_semaphores_vk.at(n_signal_semaphores_total - 1) = m_submission_tracking_semaphore_ptr->get_semaphore();
+    }
+
+    /* Prepare timeline semaphore signal & wait operations */
+    for (uint32_t n_wait_semaphore = 0;
+                  n_wait_semaphore < in_submit_info.get_n_wait_semaphores();
+                ++n_wait_semaphore)
+    {
+        wait_dst_stage_masks_vk.at(n_wait_semaphore) = in_submit_info.get_destination_stage_wait_masks()[n_wait_semaphore];
+    }
+
+    if (uses_native_timelines)
+    {
+        for (uint32_t n_timeline_signal_semaphore = 0;
+                      n_timeline_signal_semaphore < n_timeline_signal_semaphores;
+                    ++n_timeline_signal_semaphore)
+        {
+            const uint32_t n_signal_semaphore = in_submit_info.get_n_signal_semaphores() + n_timeline_signal_semaphore;
+
+            signal_semaphore_values.at(n_signal_semaphore) = in_submit_info.get_timeline_signal_semaphore_values()[n_timeline_signal_semaphore];
+            signal_semaphores_vk.at   (n_signal_semaphore) = in_submit_info.get_timeline_signal_semaphores      ()[n_timeline_signal_semaphore]->get_semaphore();
+        }
+
+        for (uint32_t n_timeline_wait_semaphore = 0;
+                      n_timeline_wait_semaphore < n_timeline_wait_semaphores;
+                    ++n_timeline_wait_semaphore)
+        {
+            const uint32_t n_wait_semaphore = in_submit_info.get_n_wait_semaphores() + n_timeline_wait_semaphore;
+
+            wait_dst_stage_masks_vk.at(n_wait_semaphore) = in_submit_info.get_timeline_wait_semaphore_destination_stage_wait_masks()[n_timeline_wait_semaphore].get_vk();
+            wait_semaphore_values.at  (n_wait_semaphore) = in_submit_info.get_timeline_wait_semaphore_values                      ()[n_timeline_wait_semaphore];
+            wait_semaphores_vk.at     (n_wait_semaphore) = in_submit_info.get_timeline_wait_semaphores                            ()[n_timeline_wait_semaphore]->get_semaphore();
+        }
+    }
+    else
+    {
+        /* Emulated timeline semaphores cannot be waited upon GPU-side, so wait operations are performed on the host.
+         *
+         * Wait-before-signal cannot be emulated this way: if no signal operation for the value has been submitted yet,
+         * blocking here would deadlock whenever that signal is going to be submitted by this very thread later on.
+         * Reject such submissions before anything is waited upon or submitted. */
+        for (uint32_t n_timeline_wait_semaphore = 0;
+                      n_timeline_wait_semaphore < n_timeline_wait_semaphores;
+                    ++n_timeline_wait_semaphore)
+        {
+            if (!in_submit_info.get_timeline_wait_semaphores()[n_timeline_wait_semaphore]->is_emulated_value_reachable(in_submit_info.get_timeline_wait_semaphore_values()[n_timeline_wait_semaphore]) )
+            {
+                return false;
+            }
+        }
+
+        /* All awaited values have been signalled or are going to be once already submitted work completes. */
+        for (uint32_t n_timeline_wait_semaphore = 0;
+                      n_timeline_wait_semaphore < n_timeline_wait_semaphores;
+                    ++n_timeline_wait_semaphore)
+        {
+            if (!in_submit_info.get_timeline_wait_semaphores()[n_timeline_wait_semaphore]->wait(in_submit_info.get_timeline_wait_semaphore_values()[n_timeline_wait_semaphore]) )
+            {
+                anvil_assert_fail();
+
+                return false;
+            }
+        }
+    }
+
     /* Prepare for the submission */
     switch (in_submit_info.get_type() )
     {
@@ -1091,14 +1420,14 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
                 VkSubmitInfo submit_info;
 
                 submit_info.commandBufferCount   = in_submit_info.get_n_command_buffers();
-                submit_info.pCommandBuffers      = (submit_info.commandBufferCount           != 0) ? &cmd_buffers_vk.at(0)       : nullptr;
+                submit_info.pCommandBuffers      = (submit_info.commandBufferCount != 0) ? &cmd_buffers_vk.at(0)          : nullptr;
                 submit_info.pNext                = nullptr;
-                submit_info.pSignalSemaphores    = (in_submit_info.get_n_signal_semaphores() != 0) ? &signal_semaphores_vk.at(0) : nullptr;
-                submit_info.pWaitDstStageMask    = in_submit_info.get_destination_stage_wait_masks();
-                submit_info.pWaitSemaphores      = (in_submit_info.get_n_wait_semaphores()   != 0) ? &wait_semaphores_vk.at(0)   : nullptr;
-                submit_info.signalSemaphoreCount = in_submit_info.get_n_signal_semaphores();
+                submit_info.pSignalSemaphores    = (n_signal_semaphores_total      != 0) ? &signal_semaphores_vk.at(0)    : nullptr;
+                submit_info.pWaitDstStageMask    = (n_wait_semaphores_total        != 0) ? &wait_dst_stage_masks_vk.at(0) : nullptr;
+                submit_info.pWaitSemaphores      = (n_wait_semaphores_total        != 0) ? &wait_semaphores_vk.at(0)      : nullptr;
+                submit_info.signalSemaphoreCount = n_signal_semaphores_total;
                 submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-                submit_info.waitSemaphoreCount   = in_submit_info.get_n_wait_semaphores();
+                submit_info.waitSemaphoreCount   = n_wait_semaphores_total;
 
                 struct_chainer.append_struct(submit_info);
             }
@@ -1109,11 +1438,11 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
                 submit_info_device_group.commandBufferCount            = n_cmd_buffers;
                 submit_info_device_group.pCommandBufferDeviceMasks     = (n_cmd_buffers != 0) ? &cmd_buffer_device_masks.at(0) : nullptr;
                 submit_info_device_group.pNext                         = nullptr;
-                submit_info_device_group.pSignalSemaphoreDeviceIndices = (in_submit_info.get_n_signal_semaphores() != 0) ? &signal_semaphore_device_indices.at(0) : nullptr;
-                submit_info_device_group.pWaitSemaphoreDeviceIndices   = (in_submit_info.get_n_wait_semaphores  () != 0) ? &wait_semaphore_device_indices.at  (0) : nullptr;
-                submit_info_device_group.signalSemaphoreCount          = in_submit_info.get_n_signal_semaphores();
+                submit_info_device_group.pSignalSemaphoreDeviceIndices = (n_signal_semaphores_total != 0) ? &signal_semaphore_device_indices.at(0) : nullptr;
+                submit_info_device_group.pWaitSemaphoreDeviceIndices   = (n_wait_semaphores_total   != 0) ? &wait_semaphore_device_indices.at  (0) : nullptr;
+                submit_info_device_group.signalSemaphoreCount          = n_signal_semaphores_total;
                 submit_info_device_group.sType                         = VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR;
-                submit_info_device_group.waitSemaphoreCount            = in_submit_info.get_n_wait_semaphores();
+                submit_info_device_group.waitSemaphoreCount            = n_wait_semaphores_total;
 
                 struct_chainer.append_struct(submit_info_device_group);
             }
@@ -1154,14 +1483,14 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
             }
 
             submit_info.commandBufferCount   = in_submit_info.get_n_command_buffers ();
-            submit_info.pCommandBuffers      = (in_submit_info.get_n_command_buffers()   != 0) ? &cmd_buffers_vk.at(0)       : nullptr;
+            submit_info.pCommandBuffers      = (in_submit_info.get_n_command_buffers() != 0) ? &cmd_buffers_vk.at(0)          : nullptr;
             submit_info.pNext                = nullptr;
-            submit_info.pSignalSemaphores    = (in_submit_info.get_n_signal_semaphores() != 0) ? &signal_semaphores_vk.at(0) : nullptr;
-            submit_info.pWaitDstStageMask    = in_submit_info.get_destination_stage_wait_masks();
-            submit_info.pWaitSemaphores      = (in_submit_info.get_n_wait_semaphores()   != 0) ? &wait_semaphores_vk.at(0)   : nullptr;
-            submit_info.signalSemaphoreCount = in_submit_info.get_n_signal_semaphores();
+            submit_info.pSignalSemaphores    = (n_signal_semaphores_total              != 0) ? &signal_semaphores_vk.at(0)    : nullptr;
+            submit_info.pWaitDstStageMask    = (n_wait_semaphores_total                != 0) ? &wait_dst_stage_masks_vk.at(0) : nullptr;
+            submit_info.pWaitSemaphores      = (n_wait_semaphores_total                != 0) ? &wait_semaphores_vk.at(0)      : nullptr;
+            submit_info.signalSemaphoreCount = n_signal_semaphores_total;
             submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submit_info.waitSemaphoreCount   = in_submit_info.get_n_wait_semaphores();
+            submit_info.waitSemaphoreCount   = n_wait_semaphores_total;
 
             struct_chainer.append_struct(submit_info);
 
@@ -1185,6 +1514,10 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
         {
             VkD3D12FenceSubmitInfoKHR fence_info;
 
+            /* D3D12 fence values are only provided for binary semaphores */
+            anvil_assert(n_signal_semaphores_total == in_submit_info.get_n_signal_semaphores() &&
+                         n_wait_semaphores_total   == in_submit_info.get_n_wait_semaphores  () );
+
             fence_info.pNext                      = nullptr;
             fence_info.pSignalSemaphoreValues     = d3d12_fence_signal_semaphore_values_ptr;
             fence_info.pWaitSemaphoreValues       = d3d12_fence_wait_semaphore_values_ptr;
@@ -1266,6 +1599,23 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
         struct_chainer.append_struct(submit_info);
     }
 
+    if ( uses_native_timelines                                                 &&
+        (n_timeline_signal_semaphores != 0 || n_timeline_wait_semaphores != 0  ||
+         tracking_signal_in_batch) )
+    {
+        VkTimelineSemaphoreSubmitInfoKHR timeline_info;
+
+        /* Values specified for binary semaphores are ignored */
+        timeline_info.pNext                     = nullptr;
+        timeline_info.pSignalSemaphoreValues    = (n_signal_semaphores_total != 0) ? &signal_semaphore_values.at(0) : nullptr;
+        timeline_info.pWaitSemaphoreValues      = (n_wait_semaphores_total   != 0) ? &wait_semaphore_values.at  (0) : nullptr;
+        timeline_info.signalSemaphoreValueCount = n_signal_semaphores_total;
+        timeline_info.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        timeline_info.waitSemaphoreValueCount   = n_wait_semaphores_total;
+
+        struct_chainer.append_struct(timeline_info);
+    }
+
     /* Go for it */
     if (fence_ptr                         == nullptr &&
         in_submit_info.get_should_block() )
@@ -1311,18 +1661,63 @@ bool Anvil::Queue::submit(const Anvil::SubmitInfo& in_submit_info)
      }
 
      {
-        auto chain_ptr = struct_chainer.create_chain();
-
         if (needs_fence_reset)
         {
             m_submit_fence_ptr->reset();
         }
 
-         result = Anvil::Vulkan::vkQueueSubmit(m_queue,
-                                               1, /* submitCount */
-                                               chain_ptr->get_root_struct(),
-                                              (fence_ptr != nullptr) ? fence_ptr->get_fence()
-                                                                     : VK_NULL_HANDLE);
+        {
+            std::unique_lock<std::mutex> tracking_lock     (m_submission_tracking_mutex);
+            Anvil::FenceUniquePtr        tracking_fence_ptr;
+            const uint64_t               tracking_value    (m_submission_tracking_value + 1);
+
+            if (tracking_signal_in_batch)
+            {
+                signal_semaphore_values.at(n_signal_semaphores_total - 1) = tracking_value;
+            }
+            else
+            {
+                tracking_fence_ptr = acquire_submission_tracking_fence(fence_ptr);
+            }
+
+            result = Anvil::Vulkan::vkQueueSubmit(m_queue,
+                                                  1, /* submitCount */
+                                                  struct_chainer.get_root_struct(),
+                                                 (fence_ptr          != nullptr) ? fence_ptr->get_fence         ()
+                                               : (tracking_fence_ptr != nullptr) ? tracking_fence_ptr->get_fence()
+                                                                                 : VK_NULL_HANDLE);
+
+            /* Tracking may have been enabled after the batch was prepared. The timeline is signalled separately then. */
+            if (is_vk_call_successful(result)                  &&
+                m_submission_tracking_semaphore_ptr != nullptr)
+            {
+                if (tracking_signal_in_batch                        ||
+                    signal_submission_tracking_value(tracking_value,
+                                                     std::move(tracking_fence_ptr) ))
+                {
+                    m_submission_tracking_value = tracking_value;
+                }
+                else
+                {
+                    anvil_assert_fail();
+                }
+            }
+        }
+
+        if (!uses_native_timelines        &&
+             is_vk_call_successful(result) )
+        {
+            for (uint32_t n_timeline_signal_semaphore = 0;
+                          n_timeline_signal_semaphore < n_timeline_signal_semaphores;
+                        ++n_timeline_signal_semaphore)
+            {
+                const bool signal_result = in_submit_info.get_timeline_signal_semaphores()[n_timeline_signal_semaphore]->enqueue_emulated_signal(m_queue,
+                                                                                                                                                 in_submit_info.get_timeline_signal_semaphore_values()[n_timeline_signal_semaphore]);
+
+                anvil_assert(signal_result);
+                ANVIL_REDUNDANT_VARIABLE_CONST(signal_result);
+            }
+        }
 
         if (in_submit_info.get_should_block() )
         {
@@ -1525,6 +1920,29 @@ void Anvil::Queue::submit_command_buffers_lock_unlock(uint32_t
     }
 }
 
+/** Please see header for specification */
+bool Anvil::Queue::wait_for_submission_tracking_value(uint64_t in_value,
+                                                      uint64_t in_timeout) const
+{
+    Anvil::TimelineSemaphore* semaphore_ptr = nullptr;
+
+    {
+        std::unique_lock<std::mutex> lock(m_submission_tracking_mutex);
+
+        semaphore_ptr = m_submission_tracking_semaphore_ptr.get();
+    }
+
+    if (semaphore_ptr == nullptr)
+    {
+        anvil_assert(in_value == 0);
+
+        return (in_value == 0);
+    }
+
+    return semaphore_ptr->wait(in_value,
+                               in_timeout);
+}
+
 void Anvil::Queue::wait_idle()
 {
     lock();
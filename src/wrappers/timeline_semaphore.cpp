@@ -0,0 +1,624 @@
+//
+// Copyright (c) 2017-2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "misc/debug.h"
+#include "misc/fence_create_info.h"
+#include "misc/object_tracker.h"
+#include "misc/struct_chainer.h"
+#include "wrappers/device.h"
+#include "wrappers/fence.h"
+#include "wrappers/timeline_semaphore.h"
+#include <chrono>
+#include <thread>
+
+
+/** Converts a Vulkan-style timeout, expressed in nanoseconds, into a deadline.
+ *
+ *  @param in_timeout       Timeout in nanoseconds.
+ *  @param out_deadline_ptr Deref will be set to the deadline, if the function returns true. Must not be null.
+ *
+ *  @return false if the timeout is too large for the deadline to be representable (in which case the wait should be treated
+ *          as an infinite one), true otherwise.
+ **/
+static bool get_deadline_for_timeout(uint64_t                               in_timeout,
+                                     std::chrono::steady_clock::time_point* out_deadline_ptr)
+{
+    /* Anything beyond ~146 years is as good as infinity */
+    const uint64_t max_finite_timeout = static_cast<uint64_t>(INT64_MAX) / 2;
+    bool           result             = false;
+
+    if (in_timeout < max_finite_timeout)
+    {
+        *out_deadline_ptr = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(in_timeout) );
+        result            = true;
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+Anvil::TimelineSemaphore::TimelineSemaphore(const Anvil::BaseDevice* in_device_ptr,
+                                            uint64_t                 in_initial_value,
+                                            MTSafety                 in_mt_safety)
+    :DebugMarkerSupportProvider(in_device_ptr,
+                                Anvil::ObjectType::SEMAPHORE),
+     MTSafetySupportProvider   (Anvil::Utils::convert_mt_safety_enum_to_boolean(in_mt_safety,
+                                                                                in_device_ptr) ),
+     m_semaphore               (VK_NULL_HANDLE),
+     m_emulation_n_waiters     (0),
+     m_emulation_value         (in_initial_value)
+{
+    Anvil::ObjectTracker::get()->register_object(Anvil::ObjectType::SEMAPHORE,
+                                                  this);
+}
+
+/* Please see header for specification */
+Anvil::TimelineSemaphore::~TimelineSemaphore()
+{
+    Anvil::ObjectTracker::get()->unregister_object(Anvil::ObjectType::SEMAPHORE,
+                                                    this);
+
+    if (m_semaphore != VK_NULL_HANDLE)
+    {
+        lock();
+        {
+            Anvil::Vulkan::vkDestroySemaphore(m_device_ptr->get_device_vk(),
+                                              m_semaphore,
+                                              nullptr /* pAllocator */);
+        }
+        unlock();
+
+        m_semaphore = VK_NULL_HANDLE;
+    }
+
+    /* Fences must not be released while they are still in use by the device. */
+    {
+        std::unique_lock<std::mutex> lock(m_emulation_mutex);
+
+        anvil_assert(m_emulation_n_waiters == 0);
+
+        for (auto& current_signal : m_emulation_pending_signals)
+        {
+            Anvil::Vulkan::vkWaitForFences(m_device_ptr->get_device_vk(),
+                                           1, /* fenceCount */
+                                           current_signal.fence_ptr->get_fence_ptr(),
+                                           VK_TRUE, /* waitAll */
+                                           UINT64_MAX);
+        }
+
+        m_emulation_pending_signals.clear();
+        m_emulation_free_fences.clear    ();
+    }
+}
+
+/* Please see header for specification */
+Anvil::TimelineSemaphoreUniquePtr Anvil::TimelineSemaphore::create(const Anvil::BaseDevice* in_device_ptr,
+                                                                   uint64_t                 in_initial_value,
+                                                                   MTSafety                 in_mt_safety)
+{
+    TimelineSemaphoreUniquePtr result_ptr(nullptr,
+                                          std::default_delete<TimelineSemaphore>() );
+
+    result_ptr.reset(
+        new Anvil::TimelineSemaphore(in_device_ptr,
+                                     in_initial_value,
+                                     in_mt_safety)
+    );
+
+    if (result_ptr != nullptr)
+    {
+        if (!result_ptr->init(in_initial_value) )
+        {
+            result_ptr.reset();
+        }
+    }
+
+    return result_ptr;
+}
+
+/* Please see header for specification */
+Anvil::FenceUniquePtr Anvil::TimelineSemaphore::acquire_emulation_fence()
+{
+    Anvil::FenceUniquePtr        result_ptr;
+    std::unique_lock<std::mutex> lock      (m_emulation_mutex);
+
+    anvil_assert(is_emulated() );
+
+    update_emulated_value();
+
+    /* Threads blocked in wait() may hold handles of retired fences, so these can only be recycled if nobody is waiting. */
+    if (m_emulation_free_fences.size() > 0 &&
+        m_emulation_n_waiters          == 0)
+    {
+        result_ptr = std::move(m_emulation_free_fences.back() );
+
+        m_emulation_free_fences.pop_back();
+
+        if (!result_ptr->reset() )
+        {
+            anvil_assert_fail();
+
+            result_ptr.reset();
+        }
+    }
+    else
+    {
+        auto create_info_ptr = Anvil::FenceCreateInfo::create(m_device_ptr,
+                                                              false); /* in_create_signalled */
+
+        create_info_ptr->set_mt_safety(Anvil::MTSafety::DISABLED);
+
+        result_ptr = Anvil::Fence::create(std::move(create_info_ptr) );
+
+        anvil_assert(result_ptr != nullptr);
+    }
+
+    return result_ptr;
+}
+
+/* Please see header for specification */
+bool Anvil::TimelineSemaphore::enqueue_emulated_signal(VkQueue  in_queue_vk,
+                                                       uint64_t in_value)
+{
+    Anvil::FenceUniquePtr fence_ptr(acquire_emulation_fence() );
+    bool                  result   (false);
+    VkResult              result_vk(VK_ERROR_INITIALIZATION_FAILED);
+
+    if (fence_ptr == nullptr)
+    {
+        goto end;
+    }
+
+    /* Fence signal operations cover all work submitted to the queue earlier, so an empty submission does the trick. */
+    result_vk = Anvil::Vulkan::vkQueueSubmit(in_queue_vk,
+                                             0,       /* submitCount */
+                                             nullptr, /* pSubmits    */
+                                             fence_ptr->get_fence() );
+
+    if (!is_vk_call_successful(result_vk) )
+    {
+        anvil_assert_vk_call_succeeded(result_vk);
+
+        goto end;
+    }
+
+    enqueue_emulated_signal_fence(std::move(fence_ptr),
+                                  in_value);
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::TimelineSemaphore::enqueue_emulated_signal_fence(Anvil::FenceUniquePtr in_fence_ptr,
+                                                             uint64_t              in_value)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_emulation_mutex);
+
+        anvil_assert(is_emulated() );
+
+        update_emulated_value();
+
+        anvil_assert(in_value > m_emulation_value);
+        anvil_assert(m_emulation_pending_signals.size() == 0                ||
+                     m_emulation_pending_signals.back().value < in_value);
+
+        m_emulation_pending_signals.push_back(
+            PendingSignal(std::move(in_fence_ptr),
+                          in_value)
+        );
+    }
+
+    m_emulation_cv.notify_all();
+}
+
+/* Please see header for specification */
+bool Anvil::TimelineSemaphore::get_value(uint64_t* out_value_ptr)
+{
+    bool result = false;
+
+    if (is_emulated() )
+    {
+        std::unique_lock<std::mutex> lock(m_emulation_mutex);
+
+        update_emulated_value();
+
+        *out_value_ptr = m_emulation_value;
+        result         = true;
+    }
+    else
+    {
+        const auto& entrypoints = m_device_ptr->get_extension_khr_timeline_semaphore_entrypoints();
+        VkResult    result_vk;
+
+        result_vk = entrypoints.vkGetSemaphoreCounterValueKHR(m_device_ptr->get_device_vk(),
+                                                              m_semaphore,
+                                                              out_value_ptr);
+
+        anvil_assert_vk_call_succeeded(result_vk);
+
+        result = is_vk_call_successful(result_vk);
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::TimelineSemaphore::init(uint64_t in_initial_value)
+{
+    bool result = false;
+
+    if (!m_device_ptr->get_extension_info()->khr_timeline_semaphore() )
+    {
+        /* Fall back to emulation. The initial value has already been stored by the constructor. */
+        result = true;
+
+        goto end;
+    }
+
+    {
+        Anvil::StructChainer<VkSemaphoreCreateInfo>        struct_chainer;
+        Anvil::StructChainUniquePtr<VkSemaphoreCreateInfo> struct_chain_ptr;
+        VkResult                                           result_vk;
+
+        {
+            VkSemaphoreCreateInfo semaphore_create_info;
+
+            semaphore_create_info.flags = 0;
+            semaphore_create_info.pNext = nullptr;
+            semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+            struct_chainer.append_struct(semaphore_create_info);
+        }
+
+        {
+            VkSemaphoreTypeCreateInfoKHR semaphore_type_create_info;
+
+            semaphore_type_create_info.initialValue  = in_initial_value;
+            semaphore_type_create_info.pNext         = nullptr;
+            semaphore_type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+            semaphore_type_create_info.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+
+            struct_chainer.append_struct(semaphore_type_create_info);
+        }
+
+        struct_chain_ptr = struct_chainer.create_chain();
+
+        result_vk = Anvil::Vulkan::vkCreateSemaphore(m_device_ptr->get_device_vk(),
+                                                     struct_chain_ptr->get_root_struct(),
+                                                     nullptr, /* pAllocator */
+                                                    &m_semaphore);
+
+        if (!is_vk_call_successful(result_vk) )
+        {
+            anvil_assert_vk_call_succeeded(result_vk);
+
+            m_semaphore = VK_NULL_HANDLE;
+
+            goto end;
+        }
+
+        set_vk_handle(m_semaphore);
+    }
+
+    result = true;
+end:
+    return result;
+}
+
+/* Please see header for specification */
+bool Anvil::TimelineSemaphore::is_emulated_value_reachable(uint64_t in_value)
+{
+    std::unique_lock<std::mutex> lock(m_emulation_mutex);
+
+    anvil_assert(is_emulated() );
+
+    update_emulated_value();
+
+    /* Pending signal values are strictly increasing, so the last one is the highest value the counter is going to reach. */
+    return ( m_emulation_value >= in_value)                                   ||
+           (!m_emulation_pending_signals.empty()                             &&
+             m_emulation_pending_signals.back().value >= in_value);
+}
+
+/* Please see header for specification */
+bool Anvil::TimelineSemaphore::signal(uint64_t in_value)
+{
+    bool result = false;
+
+    if (is_emulated() )
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_emulation_mutex);
+
+            update_emulated_value();
+
+            anvil_assert(in_value > m_emulation_value);
+            anvil_assert(m_emulation_pending_signals.size() == 0               ||
+                         m_emulation_pending_signals.back().value < in_value);
+
+            m_emulation_value = in_value;
+        }
+
+        m_emulation_cv.notify_all();
+
+        result = true;
+    }
+    else
+    {
+        const auto&              entrypoints = m_device_ptr->get_extension_khr_timeline_semaphore_entrypoints();
+        VkResult                 result_vk;
+        VkSemaphoreSignalInfoKHR signal_info;
+
+        signal_info.pNext     = nullptr;
+        signal_info.semaphore = m_semaphore;
+        signal_info.sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR;
+        signal_info.value     = in_value;
+
+        lock();
+        {
+            result_vk = entrypoints.vkSignalSemaphoreKHR(m_device_ptr->get_device_vk(),
+                                                        &signal_info);
+        }
+        unlock();
+
+        anvil_assert_vk_call_succeeded(result_vk);
+
+        result = is_vk_call_successful(result_vk);
+    }
+
+    return result;
+}
+
+/* Please see header for specification */
+void Anvil::TimelineSemaphore::update_emulated_value()
+{
+    /* Pending signal operations may have been submitted to different queues, so they can complete out of order. */
+    for (auto signal_iterator  = m_emulation_pending_signals.begin();
+              signal_iterator != m_emulation_pending_signals.end();
+             )
+    {
+        if (signal_iterator->fence_ptr->is_set() )
+        {
+            if (signal_iterator->value > m_emulation_value)
+            {
+                m_emulation_value = signal_iterator->value;
+            }
+
+            m_emulation_free_fences.push_back(std::move(signal_iterator->fence_ptr) );
+
+            signal_iterator = m_emulation_pending_signals.erase(signal_iterator);
+        }
+        else
+        {
+            ++signal_iterator;
+        }
+    }
+}
+
+/* Please see header for specification */
+bool Anvil::TimelineSemaphore::wait(uint64_t in_value,
+                                    uint64_t in_timeout)
+{
+    Anvil::TimelineSemaphore* this_ptr = this;
+
+    return wait_multiple(m_device_ptr,
+                         1, /* in_n_semaphores */
+                        &this_ptr,
+                        &in_value,
+                         true, /* in_wait_all */
+                         in_timeout);
+}
+
+/* Please see header for specification */
+bool Anvil::TimelineSemaphore::wait_multiple(const Anvil::BaseDevice*         in_device_ptr,
+                                             uint32_t                         in_n_semaphores,
+                                             Anvil::TimelineSemaphore* const* in_semaphore_ptrs,
+                                             const uint64_t*                  in_values,
+                                             bool                             in_wait_all,
+                                             uint64_t                         in_timeout)
+{
+    std::chrono::steady_clock::time_point deadline;
+    bool                                  has_deadline = false;
+    bool                                  result       = false;
+
+    anvil_assert(in_n_semaphores   >  0);
+    anvil_assert(in_semaphore_ptrs != nullptr);
+    anvil_assert(in_values         != nullptr);
+
+    for (uint32_t n_semaphore = 0;
+                  n_semaphore < in_n_semaphores;
+                ++n_semaphore)
+    {
+        anvil_assert(in_semaphore_ptrs[n_semaphore]->get_device() == in_device_ptr);
+        anvil_assert(in_semaphore_ptrs[n_semaphore]->is_emulated() == in_semaphore_ptrs[0]->is_emulated() );
+    }
+
+    if (!in_semaphore_ptrs[0]->is_emulated() )
+    {
+        const auto&              entrypoints = in_device_ptr->get_extension_khr_timeline_semaphore_entrypoints();
+        VkResult                 result_vk;
+        std::vector<VkSemaphore> semaphores_vk(in_n_semaphores);
+        VkSemaphoreWaitInfoKHR   wait_info;
+
+        for (uint32_t n_semaphore = 0;
+                      n_semaphore < in_n_semaphores;
+                    ++n_semaphore)
+        {
+            semaphores_vk.at(n_semaphore) = in_semaphore_ptrs[n_semaphore]->get_semaphore();
+        }
+
+        wait_info.flags          = (in_wait_all) ? 0 : VK_SEMAPHORE_WAIT_ANY_BIT_KHR;
+        wait_info.pNext          = nullptr;
+        wait_info.pSemaphores    = &semaphores_vk.at(0);
+        wait_info.pValues        = in_values;
+        wait_info.semaphoreCount = in_n_semaphores;
+        wait_info.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+
+        result_vk = entrypoints.vkWaitSemaphoresKHR(in_device_ptr->get_device_vk(),
+                                                   &wait_info,
+                                                    in_timeout);
+
+        if (result_vk != VK_TIMEOUT)
+        {
+            anvil_assert_vk_call_succeeded(result_vk);
+        }
+
+        result = (result_vk == VK_SUCCESS);
+
+        goto end;
+    }
+
+    has_deadline = get_deadline_for_timeout(in_timeout,
+                                           &deadline);
+
+    if (in_wait_all)
+    {
+        result = true;
+
+        for (uint32_t n_semaphore = 0;
+                      n_semaphore < in_n_semaphores && result;
+                    ++n_semaphore)
+        {
+            auto                         semaphore_ptr = in_semaphore_ptrs[n_semaphore];
+            std::unique_lock<std::mutex> lock           (semaphore_ptr->m_emulation_mutex);
+
+            result = false;
+
+            while (true)
+            {
+                VkFence fence_vk = VK_NULL_HANDLE;
+
+                semaphore_ptr->update_emulated_value();
+
+                if (semaphore_ptr->m_emulation_value >= in_values[n_semaphore])
+                {
+                    result = true;
+
+                    break;
+                }
+
+                /* Look for the earliest pending signal operation which is going to satisfy the wait */
+                for (const auto& current_signal : semaphore_ptr->m_emulation_pending_signals)
+                {
+                    if (current_signal.value >= in_values[n_semaphore])
+                    {
+                        fence_vk = current_signal.fence_ptr->get_fence();
+
+                        break;
+                    }
+                }
+
+                if (fence_vk != VK_NULL_HANDLE)
+                {
+                    uint64_t timeout_ns = UINT64_MAX;
+                    VkResult result_vk;
+
+                    if (has_deadline)
+                    {
+                        const auto time_now = std::chrono::steady_clock::now();
+
+                        timeout_ns = (time_now < deadline) ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - time_now).count() )
+                                                           : 0;
+                    }
+
+                    /* The fence is not going to be recycled until all waiters leave, so the handle remains valid with the mutex released. */
+                    ++semaphore_ptr->m_emulation_n_waiters;
+                    lock.unlock();
+                    {
+                        result_vk = Anvil::Vulkan::vkWaitForFences(in_device_ptr->get_device_vk(),
+                                                                   1, /* fenceCount */
+                                                                  &fence_vk,
+                                                                   VK_TRUE, /* waitAll */
+                                                                   timeout_ns);
+                    }
+                    lock.lock();
+                    --semaphore_ptr->m_emulation_n_waiters;
+
+                    if (result_vk == VK_TIMEOUT)
+                    {
+                        break;
+                    }
+
+                    if (!is_vk_call_successful(result_vk) )
+                    {
+                        anvil_assert_vk_call_succeeded(result_vk);
+
+                        break;
+                    }
+                }
+                else
+                {
+                    /* The signal operation has not been submitted yet. Sleep until the semaphore is signalled from the host,
+                     * or until a new signal operation is enqueued. */
+                    if (has_deadline)
+                    {
+                        if (semaphore_ptr->m_emulation_cv.wait_until(lock,
+                                                                     deadline) == std::cv_status::timeout)
+                        {
+                            semaphore_ptr->update_emulated_value();
+
+                            result = (semaphore_ptr->m_emulation_value >= in_values[n_semaphore]);
+
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        semaphore_ptr->m_emulation_cv.wait(lock);
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        /* There is no way to wait on "any" of a set of fences & condition variables at the same time, so poll. */
+        while (!result)
+        {
+            for (uint32_t n_semaphore = 0;
+                          n_semaphore < in_n_semaphores && !result;
+                        ++n_semaphore)
+            {
+                uint64_t current_value = 0;
+
+                if (in_semaphore_ptrs[n_semaphore]->get_value(&current_value) )
+                {
+                    result = (current_value >= in_values[n_semaphore]);
+                }
+            }
+
+            if (result                                                    ||
+                (has_deadline && std::chrono::steady_clock::now() >= deadline) )
+            {
+                break;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+end:
+    return result;
+}